@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tiering_tuner.cpp
+//
+// Identification: src/brain/tiering_tuner.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "brain/tiering_tuner.h"
+
+#include <algorithm>
+
+#include "common/logger.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace brain {
+
+TieringTuner &TieringTuner::GetInstance() {
+  static TieringTuner tiering_tuner;
+  return tiering_tuner;
+}
+
+TieringTuner::TieringTuner() {
+  // Nothing to do here !
+}
+
+TieringTuner::~TieringTuner() {}
+
+void TieringTuner::Start() {
+  // Set signal
+  tiering_tuning_stop = false;
+
+  // Launch thread
+  tiering_tuner_thread = std::thread(&brain::TieringTuner::Tune, this);
+
+  LOG_INFO("Started tiering tuner");
+}
+
+void TieringTuner::TuneTable(storage::DataTable *table) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  eid_t current_eid = epoch_manager.GetCurrentEpochId();
+  eid_t expired_eid = epoch_manager.GetExpiredEpochId();
+
+  // Tile groups last written at or before this epoch are cold
+  eid_t cold_eid = (current_eid > cold_epoch_threshold)
+                       ? current_eid - cold_epoch_threshold
+                       : 0;
+
+  size_t num_frozen = 0, num_thawed = 0, num_reclaimed = 0;
+  auto tile_group_count = table->GetTileGroupCount();
+  for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+
+    bool is_cold =
+        cold_eid > 0 &&
+        tile_group->GetHeader()->GetLastWriteEpochId() <= cold_eid;
+
+    if (!tile_group->IsFrozen()) {
+      if (is_cold && tile_group->Freeze(cold_eid)) {
+        num_frozen++;
+      }
+    } else if (!is_cold) {
+      // Some version was updated or deleted since we froze it
+      if (tile_group->Thaw()) {
+        num_thawed++;
+      }
+    } else {
+      // Uncompressed copies built for raw scans are kept while they are
+      // scanned, and rebuilt on demand otherwise
+      tile_group->ReleaseIdleMaterializedTiles();
+    }
+
+    // When no transaction is running, there is no expired epoch yet
+    if (expired_eid != MAX_EID) {
+      num_reclaimed += tile_group->ReclaimRetiredTiles(expired_eid);
+    }
+  }
+
+  if (num_frozen > 0 || num_thawed > 0) {
+    LOG_DEBUG("Table %u: froze %lu, thawed %lu tile groups, reclaimed %lu tiles",
+              table->GetOid(), num_frozen, num_thawed, num_reclaimed);
+  }
+}
+
+void TieringTuner::Tune() {
+  // Continue till signal is not false
+  while (tiering_tuning_stop == false) {
+    {
+      std::lock_guard<std::mutex> lock(tiering_tuner_mutex);
+      // Go over all tables
+      for (auto table : tables) {
+        TuneTable(table);
+      }
+    }
+
+    // Sleep a bit
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_duration));
+  }
+}
+
+void TieringTuner::Stop() {
+  // Stop tuning
+  tiering_tuning_stop = true;
+
+  // Stop thread
+  tiering_tuner_thread.join();
+
+  LOG_INFO("Stopped tiering tuner");
+}
+
+void TieringTuner::AddTable(storage::DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(tiering_tuner_mutex);
+    LOG_TRACE("Tiering tuner adding table : %p", table);
+
+    tables.push_back(table);
+  }
+}
+
+void TieringTuner::RemoveTable(storage::DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(tiering_tuner_mutex);
+    LOG_TRACE("Tiering tuner removing table : %p", table);
+
+    tables.erase(std::remove(tables.begin(), tables.end(), table),
+                 tables.end());
+  }
+}
+
+void TieringTuner::ClearTables() {
+  {
+    std::lock_guard<std::mutex> lock(tiering_tuner_mutex);
+    tables.clear();
+  }
+}
+
+size_t TieringTuner::GetTableCount() {
+  std::lock_guard<std::mutex> lock(tiering_tuner_mutex);
+  return tables.size();
+}
+
+}  // namespace brain
+}  // namespace peloton
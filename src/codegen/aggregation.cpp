@@ -12,7 +12,16 @@
 
 #include "codegen/aggregation.h"
 
+#include <algorithm>
+
+#include "codegen/function_builder.h"
+#include "codegen/hash.h"
+#include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
+#include "codegen/proxy/hash_partitions_proxy.h"
+#include "codegen/proxy/hll_sketch_proxy.h"
 #include "codegen/proxy/oa_hash_table_proxy.h"
+#include "codegen/proxy/t_digest_proxy.h"
 #include "codegen/type/boolean_type.h"
 #include "codegen/type/bigint_type.h"
 #include "codegen/type/decimal_type.h"
@@ -24,8 +33,29 @@ namespace codegen {
 void Aggregation::Setup(
     CodeGen &codegen,
     const std::vector<planner::AggregatePlan::AggTerm> &aggregates,
-    bool is_global, std::vector<type::Type> &grouping_ai_types) {
+    bool is_global, std::vector<type::Type> &grouping_ai_types,
+    uint64_t distinct_table_size, uint64_t memory_budget) {
   is_global_ = is_global;
+  distinct_table_size_ = distinct_table_size;
+  memory_budget_ = memory_budget;
+
+  // Deferred distinct aggregates start out empty, and so do the other
+  // aggregates of a group that only receives deferred distinct values. All
+  // but MIN, MAX and the approximate aggregates keep their distinct values.
+  bool defers_distinct =
+      distinct_table_size != 0 &&
+      std::any_of(aggregates.begin(), aggregates.end(),
+                  [](const planner::AggregatePlan::AggTerm &agg_term) {
+                    switch (agg_term.aggtype) {
+                      case ExpressionType::AGGREGATE_COUNT:
+                      case ExpressionType::AGGREGATE_COUNT_STAR:
+                      case ExpressionType::AGGREGATE_SUM:
+                      case ExpressionType::AGGREGATE_AVG:
+                        return agg_term.distinct;
+                      default:
+                        return false;
+                    }
+                  });
 
   for (uint32_t source_idx = 0; source_idx < aggregates.size(); source_idx++) {
     const auto &agg_term = aggregates[source_idx];
@@ -41,7 +71,9 @@ void Aggregation::Setup(
                                source_idx,
                                {{storage_pos}},
                                agg_term.distinct,
-                               0};
+                               0,
+                               0,
+                               0.0};
         aggregate_infos_.push_back(agg_info);
         break;
       }
@@ -50,8 +82,9 @@ void Aggregation::Setup(
         auto value_type = agg_term.expression->ResultType();
 
         // If we're doing a global aggregation, the aggregate can potentially be
-        // NULL (i.e., if there are no rows in the source table).
-        if (IsGlobal()) {
+        // NULL (i.e., if there are no rows in the source table). So can empty
+        // aggregates when distinct aggregates are deferred.
+        if (IsGlobal() || defers_distinct) {
           value_type = value_type.AsNullable();
         }
         uint32_t storage_pos = storage_.AddType(value_type);
@@ -61,7 +94,9 @@ void Aggregation::Setup(
                                source_idx,
                                {{storage_pos}},
                                agg_term.distinct,
-                               0};
+                               0,
+                               0,
+                               0.0};
         aggregate_infos_.push_back(agg_info);
         break;
       }
@@ -71,8 +106,9 @@ void Aggregation::Setup(
         auto value_type = agg_term.expression->ResultType();
 
         // If we're doing a global aggregation, the aggregate can potentially be
-        // NULL (i.e., if there are no rows in the source table).
-        if (IsGlobal()) {
+        // NULL (i.e., if there are no rows in the source table). So can empty
+        // aggregates when distinct aggregates are deferred.
+        if (IsGlobal() || defers_distinct) {
           value_type = value_type.AsNullable();
         }
         uint32_t storage_pos = storage_.AddType(value_type);
@@ -82,7 +118,9 @@ void Aggregation::Setup(
                                source_idx,
                                {{storage_pos}},
                                agg_term.distinct,
-                               0};
+                               0,
+                               0,
+                               0.0};
         aggregate_infos_.push_back(agg_info);
         break;
       }
@@ -92,7 +130,7 @@ void Aggregation::Setup(
         // SUM() - the type must match the type of the expression
         PL_ASSERT(agg_term.expression != nullptr);
         auto sum_type = agg_term.expression->ResultType();
-        if (IsGlobal()) {
+        if (IsGlobal() || defers_distinct) {
           sum_type = sum_type.AsNullable();
         }
         uint32_t sum_storage_pos = storage_.AddType(sum_type);
@@ -105,10 +143,34 @@ void Aggregation::Setup(
                                source_idx,
                                {{sum_storage_pos, count_storage_pos}},
                                agg_term.distinct,
-                               0};
+                               0,
+                               0,
+                               0.0};
         aggregate_infos_.push_back(agg_info);
         break;
       }
+      case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT:
+      case ExpressionType::AGGREGATE_APPROX_PERCENTILE: {
+        // The sketches don't fit into the SQL typed storage, they're stored as
+        // raw bytes following it. They're approximate by nature, so DISTINCT
+        // is ignored.
+        uint32_t sketch_size =
+            agg_term.aggtype == ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT
+                ? util::HllSketch::kSize
+                : util::TDigest::kSize;
+
+        // Add metadata for the aggregate
+        AggregateInfo agg_info{agg_term.aggtype,
+                               source_idx,
+                               {{0}},
+                               false,
+                               0,
+                               sketches_size_,
+                               agg_term.percentile};
+        aggregate_infos_.push_back(agg_info);
+        sketches_size_ += sketch_size;
+        break;
+      }
       default: {
         std::string message = StringUtil::Format(
             "Unexpected aggregate type [%s] when preparing aggregator",
@@ -158,10 +220,25 @@ void Aggregation::Setup(
     // Add index to the aggregation_info struct
     agg_info.hast_table_index =
         static_cast<uint32_t>(hash_table_infos_.size() - 1);
+
+    // Deferred distinct values are flushed into partitions
+    if (defers_distinct) {
+      distinct_partitions_ids_.push_back(runtime_state_.RegisterState(
+          "agg_partitions" + std::to_string(agg_info.source_index),
+          HashPartitionsProxy::GetType(codegen)));
+    }
   }
 
-  // Finalize the storage format
-  storage_.Finalize(codegen);
+  // Finalize the storage format, the sketches follow it
+  aggregates_type_ = storage_.Finalize(codegen);
+  if (sketches_size_ > 0) {
+    std::vector<llvm::Type *> elements =
+        llvm::cast<llvm::StructType>(aggregates_type_)->elements();
+    elements.push_back(
+        llvm::ArrayType::get(codegen.ByteType(), sketches_size_));
+    aggregates_type_ =
+        llvm::StructType::get(codegen.GetContext(), elements, true);
+  }
 }
 
 // Setup the aggregation to handle the provided aggregates
@@ -176,6 +253,66 @@ void Aggregation::Setup(
   Setup(codegen, agg_terms, is_global, empty);
 }
 
+//===----------------------------------------------------------------------===//
+// Here, we define the function merging the values of a deferred distinct
+// aggregate flushed into a partition into the hash table of the partition:
+//
+// void mergeDistinct(OAHashTable *table, char *entries, uint64_t n) {
+//   for (entry : entries[0 .. n)) {
+//     insert entry.key into the table, unless it is there already
+//   }
+// }
+//===----------------------------------------------------------------------===//
+void Aggregation::DefineAuxiliaryFunctions(CodeGen &codegen) {
+  if (!DefersDistinct()) {
+    return;
+  }
+
+  distinct_merge_funcs_.clear();
+  for (uint32_t i = 0; i < hash_table_infos_.size(); i++) {
+    const auto &hash_table = hash_table_infos_[i].first;
+
+    std::vector<FunctionDeclaration::ArgumentInfo> args = {
+        {"table", OAHashTableProxy::GetType(codegen)->getPointerTo()},
+        {"entries", codegen.CharPtrType()},
+        {"numEntries", codegen.Int64Type()}};
+    FunctionBuilder merge{codegen.GetCodeContext(),
+                          "mergeDistinct" + std::to_string(i),
+                          codegen.VoidType(), args};
+    {
+      llvm::Value *table = merge.GetArgumentByPosition(0);
+      llvm::Value *entries = merge.GetArgumentByPosition(1);
+      llvm::Value *num_entries = merge.GetArgumentByPosition(2);
+
+      llvm::Value *entry_idx = codegen.Const64(0);
+      lang::Loop entry_loop{codegen,
+                            codegen->CreateICmpULT(entry_idx, num_entries),
+                            {{"entryIdx", entry_idx}}};
+      {
+        entry_idx = entry_loop.GetLoopVar(0);
+
+        llvm::Value *entry_offset = codegen->CreateMul(
+            entry_idx, codegen.Const64(hash_table.HashEntrySize()));
+        llvm::Value *entry_ptr = codegen->CreateInBoundsGEP(
+            codegen.ByteType(), entries, entry_offset);
+        llvm::Value *hash = nullptr;
+        std::vector<codegen::Value> key;
+        hash_table.LoadEntry(codegen, entry_ptr, hash, key);
+
+        // The entries carry no values, finding the key is enough
+        hash_table.ProbeOrInsert(codegen, table, hash, key);
+
+        entry_idx = codegen->CreateAdd(entry_idx, codegen.Const64(1));
+        entry_loop.LoopEnd(codegen->CreateICmpULT(entry_idx, num_entries),
+                           {entry_idx});
+      }
+
+      merge.ReturnAndFinish();
+    }
+    distinct_merge_funcs_.push_back(merge.GetFunction());
+  }
+}
+
 // Codegen any initialization work for the hash tables
 void Aggregation::InitializeState(CodeGen &codegen) {
   for (auto hash_table_info : hash_table_infos_) {
@@ -184,6 +321,12 @@ void Aggregation::InitializeState(CodeGen &codegen) {
     hash_table.Init(codegen,
                     runtime_state_.LoadStatePtr(codegen, hash_table_id));
   }
+  for (uint32_t i = 0; i < distinct_partitions_ids_.size(); i++) {
+    codegen.Call(
+        HashPartitionsProxy::Init,
+        {runtime_state_.LoadStatePtr(codegen, distinct_partitions_ids_[i]),
+         distinct_merge_funcs_[i], codegen.Const64(memory_budget_)});
+  }
 }
 
 // Cleanup by destroying the aggregation hash tables
@@ -194,6 +337,10 @@ void Aggregation::TearDownState(CodeGen &codegen) {
     hash_table.Destroy(codegen,
                        runtime_state_.LoadStatePtr(codegen, hash_table_id));
   }
+  for (auto partitions_id : distinct_partitions_ids_) {
+    codegen.Call(HashPartitionsProxy::Destroy,
+                 {runtime_state_.LoadStatePtr(codegen, partitions_id)});
+  }
 }
 
 void Aggregation::CreateInitialGlobalValues(CodeGen &codegen,
@@ -203,6 +350,18 @@ void Aggregation::CreateInitialGlobalValues(CodeGen &codegen,
       UpdateableStorage::NullBitmap{codegen, GetAggregateStorage(), space};
   null_bitmap.InitAllNull(codegen);
   null_bitmap.WriteBack(codegen);
+
+  // Start out with empty sketches
+  for (const auto &agg_info : aggregate_infos_) {
+    llvm::Value *sketch = GetSketchPtr(codegen, space, agg_info);
+    if (agg_info.aggregate_type ==
+        ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT) {
+      codegen.Call(HllSketchProxy::Init, {sketch});
+    } else if (agg_info.aggregate_type ==
+               ExpressionType::AGGREGATE_APPROX_PERCENTILE) {
+      codegen.Call(TDigestProxy::Init, {sketch});
+    }
+  }
 }
 
 // Create the initial values of all aggregates based on the the provided values
@@ -224,6 +383,17 @@ void Aggregation::CreateInitialValues(
     const auto &agg_info = aggregate_infos_[i];
     const auto &input_val = initial[agg_info.source_index];
 
+    // Deferred distinct values are only added once they were deduplicated
+    if (agg_info.is_distinct && DefersDistinct()) {
+      InitializeEmptyValue(codegen, space, agg_info);
+      null_bitmap.WriteBack(codegen);
+
+      std::vector<codegen::Value> key = grouping_keys;
+      key.push_back(input_val);
+      CollectDistinctValue(codegen, agg_info, key);
+      continue;
+    }
+
     switch (agg_info.aggregate_type) {
       case ExpressionType::AGGREGATE_SUM:
       case ExpressionType::AGGREGATE_MIN:
@@ -243,6 +413,20 @@ void Aggregation::CreateInitialValues(
                           agg_info.storage_indices[1], input_val, null_bitmap);
         break;
       }
+      case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT: {
+        // Start with an empty sketch and add the initial value
+        codegen.Call(HllSketchProxy::Init,
+                     {GetSketchPtr(codegen, space, agg_info)});
+        AdvanceSketch(codegen, space, agg_info, input_val);
+        break;
+      }
+      case ExpressionType::AGGREGATE_APPROX_PERCENTILE: {
+        // Start with an empty digest and add the initial value
+        codegen.Call(TDigestProxy::Init,
+                     {GetSketchPtr(codegen, space, agg_info)});
+        AdvanceSketch(codegen, space, agg_info, input_val);
+        break;
+      }
       default: {
         std::string message = StringUtil::Format(
             "Unexpected aggregate type [%s] when creating initial values",
@@ -487,6 +671,11 @@ void Aggregation::AdvanceValue(
 
       break;
     }
+    case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT:
+    case ExpressionType::AGGREGATE_APPROX_PERCENTILE: {
+      AdvanceSketch(codegen, space, aggregate_info, update);
+      break;
+    }
     default: {
       std::string message = StringUtil::Format(
           "Unexpected aggregate type [%s] when advancing aggregator",
@@ -515,6 +704,20 @@ void Aggregation::AdvanceValues(
       continue;
     }
 
+    // Prepare the hash keys
+    // if not global, start with grouping keys, then add aggregation key
+    std::vector<codegen::Value> key;
+    if (!IsGlobal()) {
+      key = grouping_keys;
+    }
+    key.push_back(update);
+
+    // Deferred distinct values are only added once they were deduplicated
+    if (DefersDistinct()) {
+      CollectDistinctValue(codegen, aggregate_info, key);
+      continue;
+    }
+
     // Check if aggregation is distinct, then add another hash table lookup
     // before advancing the value
     auto &hash_table = hash_table_infos_[aggregate_info.hast_table_index].first;
@@ -528,14 +731,6 @@ void Aggregation::AdvanceValues(
     // expression?
     llvm::Value *hash = nullptr;
 
-    // Prepare the hash keys
-    // if not global, start with grouping keys, then add aggregation key
-    std::vector<codegen::Value> key;
-    if (!IsGlobal()) {
-      key = grouping_keys;
-    }
-    key.push_back(update);
-
     // Perform the lookup in the hash table
     OAHashTable::ProbeResult probe_result =
         hash_table.ProbeOrInsert(codegen, ht_ptr, hash, key);
@@ -580,6 +775,273 @@ void Aggregation::AdvanceValues(CodeGen &codegen, llvm::Value *space,
   AdvanceValues(codegen, space, next, empty);
 }
 
+// Get a pointer to the sketch of the given approximate aggregate. The sketches
+// are stored after the SQL typed values.
+llvm::Value *Aggregation::GetSketchPtr(CodeGen &codegen, llvm::Value *space,
+                                       const AggregateInfo &agg_info) const {
+  llvm::Value *bytes = codegen->CreateBitCast(space, codegen.CharPtrType());
+  return codegen->CreateConstInBoundsGEP1_32(
+      codegen.ByteType(), bytes,
+      storage_.GetStorageSize() + agg_info.sketch_offset);
+}
+
+// Add the value to the sketch of the given approximate aggregate, skipping
+// NULLs. Distinct values are counted by their hash, percentiles are computed
+// over the values cast to DECIMAL.
+void Aggregation::AdvanceSketch(CodeGen &codegen, llvm::Value *space,
+                                const AggregateInfo &agg_info,
+                                const codegen::Value &next) const {
+  const auto add_to_sketch = [&]() {
+    llvm::Value *sketch = GetSketchPtr(codegen, space, agg_info);
+    if (agg_info.aggregate_type ==
+        ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT) {
+      llvm::Value *hash = Hash::HashValues(codegen, {next});
+      codegen.Call(HllSketchProxy::Update, {sketch, hash});
+    } else {
+      codegen::Value val = next.CastTo(codegen, type::Decimal::Instance());
+      codegen.Call(TDigestProxy::Add, {sketch, val.GetValue()});
+    }
+  };
+
+  if (!next.IsNullable()) {
+    add_to_sketch();
+    return;
+  }
+
+  lang::If not_null{codegen, next.IsNotNull(codegen), "Agg.IfSketchUpdate"};
+  { add_to_sketch(); }
+  not_null.EndIf();
+}
+
+// Merge a partial aggregate component into another. Partial counts add up like
+// sums do, so COUNT components are merged as SUMs.
+void Aggregation::MergeValue(
+    CodeGen &codegen, llvm::Value *space, llvm::Value *other_space,
+    ExpressionType type, uint32_t storage_index,
+    UpdateableStorage::NullBitmap &null_bitmap,
+    UpdateableStorage::NullBitmap &other_null_bitmap) const {
+  if (!null_bitmap.IsNullable(storage_index)) {
+    auto other = storage_.GetValueSkipNull(codegen, other_space, storage_index);
+    DoAdvanceValue(codegen, space, type, storage_index, other);
+  } else {
+    auto other = storage_.GetValue(codegen, other_space, storage_index,
+                                   other_null_bitmap);
+    DoNullCheck(codegen, space, type, storage_index, other, null_bitmap);
+  }
+}
+
+// Merge the partial aggregates stored in the other storage space into those
+// stored in the provided storage space
+void Aggregation::MergeValues(CodeGen &codegen, llvm::Value *space,
+                              llvm::Value *other_space) const {
+  PL_ASSERT(IsMergeable());
+
+  // The null bitmap trackers
+  UpdateableStorage::NullBitmap null_bitmap{codegen, storage_, space};
+  UpdateableStorage::NullBitmap other_null_bitmap{codegen, storage_,
+                                                  other_space};
+
+  for (const auto &agg_info : aggregate_infos_) {
+    switch (agg_info.aggregate_type) {
+      case ExpressionType::AGGREGATE_SUM:
+      case ExpressionType::AGGREGATE_MIN:
+      case ExpressionType::AGGREGATE_MAX: {
+        MergeValue(codegen, space, other_space, agg_info.aggregate_type,
+                   agg_info.storage_indices[0], null_bitmap,
+                   other_null_bitmap);
+        break;
+      }
+      case ExpressionType::AGGREGATE_COUNT:
+      case ExpressionType::AGGREGATE_COUNT_STAR: {
+        MergeValue(codegen, space, other_space, ExpressionType::AGGREGATE_SUM,
+                   agg_info.storage_indices[0], null_bitmap,
+                   other_null_bitmap);
+        break;
+      }
+      case ExpressionType::AGGREGATE_AVG: {
+        // Merge both the SUM and the COUNT
+        MergeValue(codegen, space, other_space, ExpressionType::AGGREGATE_SUM,
+                   agg_info.storage_indices[0], null_bitmap,
+                   other_null_bitmap);
+        MergeValue(codegen, space, other_space, ExpressionType::AGGREGATE_SUM,
+                   agg_info.storage_indices[1], null_bitmap,
+                   other_null_bitmap);
+        break;
+      }
+      case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT: {
+        codegen.Call(HllSketchProxy::Merge,
+                     {GetSketchPtr(codegen, space, agg_info),
+                      GetSketchPtr(codegen, other_space, agg_info)});
+        break;
+      }
+      case ExpressionType::AGGREGATE_APPROX_PERCENTILE: {
+        codegen.Call(TDigestProxy::Merge,
+                     {GetSketchPtr(codegen, space, agg_info),
+                      GetSketchPtr(codegen, other_space, agg_info)});
+        break;
+      }
+      default: {
+        std::string message = StringUtil::Format(
+            "Unexpected aggregate type [%s] when merging aggregates",
+            ExpressionTypeToString(agg_info.aggregate_type).c_str());
+        LOG_ERROR("%s", message.c_str());
+        throw Exception{ExceptionType::UNKNOWN_TYPE, message};
+      }
+    }
+  }
+
+  // Write the final contents of the null bitmap
+  null_bitmap.WriteBack(codegen);
+}
+
+// The distinct values seen by a partial aggregate are not kept with it, so
+// partial distinct aggregates can't be merged. Deferred ones are only advanced
+// by deduplicated values, which makes them mergeable like any other aggregate.
+bool Aggregation::IsMergeable() const {
+  return hash_table_infos_.empty() || DefersDistinct();
+}
+
+void Aggregation::InitializeEmptyValue(CodeGen &codegen, llvm::Value *space,
+                                       const AggregateInfo &agg_info) const {
+  codegen::Value zero{type::BigInt::Instance(), codegen.Const64(0)};
+  switch (agg_info.aggregate_type) {
+    case ExpressionType::AGGREGATE_COUNT:
+    case ExpressionType::AGGREGATE_COUNT_STAR: {
+      storage_.SetValueSkipNull(codegen, space, agg_info.storage_indices[0],
+                                zero);
+      break;
+    }
+    case ExpressionType::AGGREGATE_AVG: {
+      // The SUM stays NULL, the COUNT starts at zero
+      storage_.SetValueSkipNull(codegen, space, agg_info.storage_indices[1],
+                                zero);
+      break;
+    }
+    case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT: {
+      codegen.Call(HllSketchProxy::Init,
+                   {GetSketchPtr(codegen, space, agg_info)});
+      break;
+    }
+    case ExpressionType::AGGREGATE_APPROX_PERCENTILE: {
+      codegen.Call(TDigestProxy::Init,
+                   {GetSketchPtr(codegen, space, agg_info)});
+      break;
+    }
+    default: {
+      // SUM, MIN and MAX stay NULL
+      break;
+    }
+  }
+}
+
+void Aggregation::CreateEmptyValues(CodeGen &codegen,
+                                    llvm::Value *space) const {
+  PL_ASSERT(DefersDistinct());
+  UpdateableStorage::NullBitmap null_bitmap{codegen, storage_, space};
+  null_bitmap.InitAllNull(codegen);
+  null_bitmap.WriteBack(codegen);
+
+  for (const auto &agg_info : aggregate_infos_) {
+    InitializeEmptyValue(codegen, space, agg_info);
+  }
+}
+
+void Aggregation::CollectDistinctValue(
+    CodeGen &codegen, const AggregateInfo &agg_info,
+    const std::vector<codegen::Value> &key) const {
+  uint32_t idx = agg_info.hast_table_index;
+  const auto &hash_table = hash_table_infos_[idx].first;
+  llvm::Value *ht_ptr =
+      runtime_state_.LoadStatePtr(codegen, hash_table_infos_[idx].second);
+  hash_table.ProbeOrInsert(codegen, ht_ptr, nullptr, key);
+
+  // The table is kept at most half full
+  uint64_t max_entries = std::max<uint64_t>(
+      1, distinct_table_size_ / (2 * hash_table.HashEntrySize()));
+  llvm::Value *num_entries = hash_table.NumEntries(codegen, ht_ptr);
+  lang::If is_full{
+      codegen,
+      codegen->CreateICmpUGE(num_entries, codegen.Const64(max_entries)),
+      "distinctTableFull"};
+  {
+    codegen.Call(
+        HashPartitionsProxy::Flush,
+        {runtime_state_.LoadStatePtr(codegen, distinct_partitions_ids_[idx]),
+         ht_ptr});
+  }
+  is_full.EndIf();
+}
+
+namespace {
+
+// Hands the entries of the hash table of a distinct aggregate to the callback,
+// splitting their keys into the grouping keys and the value
+class DistinctEntryCallback : public HashTable::IterateCallback {
+ public:
+  DistinctEntryCallback(const Aggregation::DistinctValueCallback &callback,
+                        uint32_t distinct_index)
+      : callback_(callback), distinct_index_(distinct_index) {}
+
+  void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &keys,
+                    UNUSED_ATTRIBUTE llvm::Value *values) const override {
+    std::vector<codegen::Value> grouping_keys{keys.begin(), keys.end() - 1};
+    callback_.ProcessValue(codegen, distinct_index_, grouping_keys,
+                           keys.back());
+  }
+
+ private:
+  const Aggregation::DistinctValueCallback &callback_;
+  uint32_t distinct_index_;
+};
+
+}  // namespace
+
+// Merge the partitions of each distinct aggregate, one after another, and
+// iterate over the tables holding its deduplicated values
+void Aggregation::IterateDistinctValues(
+    CodeGen &codegen, DistinctValueCallback &callback) const {
+  PL_ASSERT(DefersDistinct());
+  for (uint32_t i = 0; i < hash_table_infos_.size(); i++) {
+    const auto &hash_table = hash_table_infos_[i].first;
+    llvm::Value *partitions =
+        runtime_state_.LoadStatePtr(codegen, distinct_partitions_ids_[i]);
+    codegen.Call(HashPartitionsProxy::Finish,
+                 {partitions, runtime_state_.LoadStatePtr(
+                                  codegen, hash_table_infos_[i].second)});
+
+    DistinctEntryCallback entry_callback{callback, i};
+    llvm::Value *table =
+        codegen.Call(HashPartitionsProxy::NextTable, {partitions});
+    lang::Loop table_loop{codegen, codegen->CreateIsNotNull(table),
+                          {{"table", table}}};
+    {
+      table = table_loop.GetLoopVar(0);
+      hash_table.Iterate(codegen, table, entry_callback);
+
+      table = codegen.Call(HashPartitionsProxy::NextTable, {partitions});
+      table_loop.LoopEnd(codegen->CreateIsNotNull(table), {table});
+    }
+  }
+}
+
+void Aggregation::AdvanceDistinctValue(CodeGen &codegen, llvm::Value *space,
+                                       uint32_t distinct_index,
+                                       const codegen::Value &value) const {
+  for (const auto &agg_info : aggregate_infos_) {
+    if (!agg_info.is_distinct || agg_info.hast_table_index != distinct_index) {
+      continue;
+    }
+
+    UpdateableStorage::NullBitmap null_bitmap{codegen, storage_, space};
+    std::vector<codegen::Value> next_vals(agg_info.source_index + 1);
+    next_vals[agg_info.source_index] = value;
+    AdvanceValue(codegen, space, next_vals, agg_info, null_bitmap);
+    null_bitmap.WriteBack(codegen);
+    return;
+  }
+  PL_ASSERT(false);
+}
+
 // This function will compute the final values of all aggregates stored in the
 // provided storage space, populating the provided vector with these values.
 void Aggregation::FinalizeValues(
@@ -646,6 +1108,24 @@ void Aggregation::FinalizeValues(
         final_vals.push_back(final_val);
         break;
       }
+      case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT: {
+        // Like COUNT(...), the estimate is never NULL
+        llvm::Value *estimate = codegen.Call(
+            HllSketchProxy::Estimate, {GetSketchPtr(codegen, space, agg_info)});
+        final_vals.emplace_back(type::BigInt::Instance(), estimate);
+        break;
+      }
+      case ExpressionType::AGGREGATE_APPROX_PERCENTILE: {
+        // The percentile is NULL if there were no non-NULL values
+        llvm::Value *digest = GetSketchPtr(codegen, space, agg_info);
+        llvm::Value *is_empty = codegen.Call(TDigestProxy::IsEmpty, {digest});
+        llvm::Value *quantile =
+            codegen.Call(TDigestProxy::Quantile,
+                         {digest, codegen.ConstDouble(agg_info.percentile)});
+        final_vals.emplace_back(type::Type{type::Decimal::Instance(), true},
+                                quantile, nullptr, is_empty);
+        break;
+      }
       default: {
         std::string message = StringUtil::Format(
             "Unexpected aggregate type [%s] when finalizing aggregator",
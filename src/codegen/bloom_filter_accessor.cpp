@@ -14,6 +14,7 @@
 #include "codegen/lang/if.h"
 #include "codegen/lang/loop.h"
 #include "codegen/proxy/bloom_filter_proxy.h"
+#include "codegen/type/bigint_type.h"
 #include "codegen/util/bloom_filter.h"
 
 #include <cmath>
@@ -125,6 +126,59 @@ llvm::Value *BloomFilterAccessor::Contains(
   return contains;
 }
 
+llvm::Value *BloomFilterAccessor::ShouldProbe(CodeGen &codegen,
+                                              llvm::Value *bloom_filter,
+                                              llvm::Value *num_tuples) const {
+  return codegen.Call(BloomFilterProxy::ShouldProbe,
+                      {bloom_filter, num_tuples});
+}
+
+void BloomFilterAccessor::AddToRange(CodeGen &codegen,
+                                     llvm::Value *bloom_filter,
+                                     const codegen::Value &key) const {
+  llvm::Value *not_null = codegen.ConstBool(true);
+  if (key.IsNullable()) {
+    not_null = codegen->CreateNot(key.IsNull(codegen));
+  }
+  lang::If key_not_null{codegen, not_null, "keyNotNull"};
+  {
+    llvm::Value *val =
+        key.CastTo(codegen, type::BigInt::Instance()).GetValue();
+    llvm::Value *min = GetMinKey(codegen, bloom_filter);
+    llvm::Value *max = GetMaxKey(codegen, bloom_filter);
+    StoreBloomFilterField(
+        codegen, bloom_filter, 5,
+        codegen->CreateSelect(codegen->CreateICmpSLT(val, min), val, min));
+    StoreBloomFilterField(
+        codegen, bloom_filter, 6,
+        codegen->CreateSelect(codegen->CreateICmpSGT(val, max), val, max));
+  }
+  key_not_null.EndIf();
+}
+
+llvm::Value *BloomFilterAccessor::InRange(CodeGen &codegen,
+                                          llvm::Value *bloom_filter,
+                                          const codegen::Value &key) const {
+  llvm::Value *val = key.CastTo(codegen, type::BigInt::Instance()).GetValue();
+  llvm::Value *in_range = codegen->CreateAnd(
+      codegen->CreateICmpSGE(val, GetMinKey(codegen, bloom_filter)),
+      codegen->CreateICmpSLE(val, GetMaxKey(codegen, bloom_filter)));
+  if (key.IsNullable()) {
+    in_range = codegen->CreateOr(key.IsNull(codegen), in_range);
+  }
+  return in_range;
+}
+
+llvm::Value *BloomFilterAccessor::GetMinKey(CodeGen &codegen,
+                                            llvm::Value *bloom_filter) const {
+  return LoadBloomFilterField(codegen, bloom_filter, 5);
+}
+
+llvm::Value *BloomFilterAccessor::GetMaxKey(CodeGen &codegen,
+                                            llvm::Value *bloom_filter) const {
+  return LoadBloomFilterField(codegen, bloom_filter, 6);
+}
+
 llvm::Value *BloomFilterAccessor::CalculateHash(CodeGen &codegen,
                                                 llvm::Value *index,
                                                 llvm::Value *seed_hash1,
@@ -12,19 +12,29 @@
 
 #include "codegen/code_context.h"
 
+#include <cinttypes>
+
+#include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/ExecutionEngine/MCJIT.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_os_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Vectorize.h"
 #if LLVM_VERSION_GE(3, 9)
 #include "llvm/Transforms/Scalar/GVN.h"
 #endif
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/timer.h"
+#include "settings/settings_manager.h"
+#include "util/hash_util.h"
 
 namespace peloton {
 namespace codegen {
@@ -32,6 +42,11 @@ namespace codegen {
 /// Atomic plan ID counter
 static std::atomic<uint64_t> kIdCounter{0};
 
+/// The inlining threshold of the aggressive tier (that of -O3)
+static constexpr uint32_t kAggressiveInlineThreshold = 250;
+
+constexpr uint32_t CodeContext::kNumOptimizationTiers;
+
 namespace {
 class PelotonMM : public llvm::SectionMemoryManager {
  public:
@@ -85,6 +100,38 @@ class PelotonMM : public llvm::SectionMemoryManager {
   // The code context
   const std::unordered_map<std::string, CodeContext::FuncPtr> &symbols_;
 };
+
+//===----------------------------------------------------------------------===//
+// Hands the engine the object code of an earlier compilation of the module (if
+// there is one) and keeps the object code the engine produces
+//===----------------------------------------------------------------------===//
+class PelotonObjectCache : public llvm::ObjectCache {
+ public:
+  PelotonObjectCache(const std::string &cached_object, std::string &object_code)
+      : cached_object_(cached_object), object_code_(object_code) {}
+
+  void notifyObjectCompiled(const llvm::Module *,
+                            llvm::MemoryBufferRef object) override {
+    object_code_.assign(object.getBufferStart(), object.getBufferSize());
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module *module) override {
+    if (cached_object_.empty()) {
+      return nullptr;
+    }
+    object_code_ = cached_object_;
+    return llvm::MemoryBuffer::getMemBufferCopy(cached_object_,
+                                                module->getModuleIdentifier());
+  }
+
+ private:
+  // The object code of an earlier compilation
+  const std::string &cached_object_;
+  // The object code of the module
+  std::string &object_code_;
+};
+
 }  // anonymous namespace
 
 /// Constructor
@@ -96,6 +143,9 @@ CodeContext::CodeContext()
       func_(nullptr),
       udf_func_ptr_(nullptr),
       pass_manager_(nullptr),
+      tier_(OptimizationTier::Standard),
+      compile_ms_(0.0),
+      object_cache_(new PelotonObjectCache(cached_object_, object_code_)),
       engine_(nullptr) {
   // Initialize JIT stuff
   llvm::InitializeNativeTarget();
@@ -124,6 +174,7 @@ CodeContext::CodeContext()
                     .setErrorStr(&err_str_)
                     .create());
   PL_ASSERT(engine_ != nullptr);
+  engine_->setObjectCache(object_cache_.get());
 
   // The set of optimization passes we include
   pass_manager_.reset(new llvm::legacy::FunctionPassManager(module_));
@@ -200,16 +251,33 @@ bool CodeContext::Compile() {
     return false;
   }
 
-  // Run the optimization passes over each function in this module
-  pass_manager_->doInitialization();
-  for (auto &func_iter : functions_) {
-    pass_manager_->run(*func_iter.first);
+  Timer<std::ratio<1, 1000>> timer;
+  timer.Start();
+
+  // Optimize the module. There's no need to if the engine is going to load
+  // the cached object code anyway.
+  if (cached_object_.empty()) {
+    // Large modules spend far more time in the optimizer than they save, so
+    // they only get the minimal tier unless they proved to run long enough
+    auto max_instructions = settings::SettingsManager::GetInt(
+        settings::SettingId::codegen_minimal_optimization_instructions);
+    if (tier_ == OptimizationTier::Standard && max_instructions > 0) {
+      uint64_t num_instructions = GetInstructionCount();
+      if (num_instructions > static_cast<uint64_t>(max_instructions)) {
+        LOG_DEBUG("Compiling module with %" PRIu64 " instructions minimally",
+                  num_instructions);
+        tier_ = OptimizationTier::Minimal;
+      }
+    }
+    Optimize();
   }
-  pass_manager_->doFinalization();
 
   // Functions and module have been optimized, now JIT compile the module
   engine_->finalizeObject();
 
+  timer.Stop();
+  compile_ms_ = timer.GetDuration();
+
   // Pull out the compiled function implementations
   for (auto &func_iter : functions_) {
     func_iter.second = engine_->getPointerToFunction(func_iter.first);
@@ -222,6 +290,65 @@ bool CodeContext::Compile() {
   return true;
 }
 
+void CodeContext::Optimize() {
+  auto *target_machine = engine_->getTargetMachine();
+  switch (tier_) {
+    case OptimizationTier::Minimal: {
+      // Leave the IR as is, and generate code as fast as possible
+      target_machine->setOptLevel(llvm::CodeGenOpt::None);
+      target_machine->setFastISel(true);
+      break;
+    }
+    case OptimizationTier::Standard: {
+      // Run the optimization passes over each function in this module
+      pass_manager_->doInitialization();
+      for (auto &func_iter : functions_) {
+        pass_manager_->run(*func_iter.first);
+      }
+      pass_manager_->doFinalization();
+      target_machine->setOptLevel(llvm::CodeGenOpt::Default);
+      break;
+    }
+    case OptimizationTier::Aggressive: {
+      // Inline the helper functions into their callers, then clean up and
+      // vectorize the loops of the whole module
+      llvm::legacy::PassManager pass_manager;
+      pass_manager.add(llvm::createTargetTransformInfoWrapperPass(
+          target_machine->getTargetIRAnalysis()));
+      pass_manager.add(
+          llvm::createFunctionInliningPass(kAggressiveInlineThreshold));
+      pass_manager.add(llvm::createSROAPass());
+      pass_manager.add(llvm::createEarlyCSEPass());
+      pass_manager.add(llvm::createInstructionCombiningPass());
+      pass_manager.add(llvm::createReassociatePass());
+      pass_manager.add(llvm::createGVNPass());
+      pass_manager.add(llvm::createCFGSimplificationPass());
+      pass_manager.add(llvm::createLoopRotatePass());
+      pass_manager.add(llvm::createLICMPass());
+      pass_manager.add(llvm::createIndVarSimplifyPass());
+      pass_manager.add(llvm::createLoopVectorizePass());
+      pass_manager.add(llvm::createSLPVectorizerPass());
+      pass_manager.add(llvm::createInstructionCombiningPass());
+      pass_manager.add(llvm::createGVNPass());
+      pass_manager.add(llvm::createAggressiveDCEPass());
+      pass_manager.add(llvm::createCFGSimplificationPass());
+      pass_manager.run(*module_);
+      target_machine->setOptLevel(llvm::CodeGenOpt::Aggressive);
+      break;
+    }
+  }
+}
+
+uint64_t CodeContext::GetInstructionCount() const {
+  uint64_t count = 0;
+  for (const auto &func : *module_) {
+    for (const auto &block : func) {
+      count += block.size();
+    }
+  }
+  return count;
+}
+
 /// Get the module's layout
 const llvm::DataLayout &CodeContext::GetDataLayout() const {
   return module_->getDataLayout();
@@ -252,6 +379,21 @@ void CodeContext::DumpContents() const {
   }
 }
 
+hash_t CodeContext::HashIR() const {
+  // The module is named after the ID of this context, leave the name out
+  const std::string module_name = module_->getModuleIdentifier();
+  module_->setModuleIdentifier("");
+#if LLVM_VERSION_GE(3, 9)
+  module_->setSourceFileName("");
+#endif
+  std::string ir = GetIR();
+  module_->setModuleIdentifier(module_name);
+#if LLVM_VERSION_GE(3, 9)
+  module_->setSourceFileName(module_name);
+#endif
+  return HashUtil::HashBytes(ir.data(), ir.length());
+}
+
 // Get the textual form of the IR in this context
 std::string CodeContext::GetIR() const {
   std::string module_str;
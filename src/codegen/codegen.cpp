@@ -153,6 +153,12 @@ llvm::Value *CodeGen::Sqrt(llvm::Value *val) {
   return CallFunc(sqrt_func, {val});
 }
 
+llvm::Value *CodeGen::PopCount(llvm::Value *val) {
+  llvm::Function *ctpop_func = llvm::Intrinsic::getDeclaration(
+      &GetModule(), llvm::Intrinsic::ctpop, val->getType());
+  return CallFunc(ctpop_func, {val});
+}
+
 llvm::Value *CodeGen::CallAddWithOverflow(llvm::Value *left, llvm::Value *right,
                                           llvm::Value *&overflow_bit) {
   PL_ASSERT(left->getType() == right->getType());
@@ -283,5 +289,13 @@ uint64_t CodeGen::SizeOf(llvm::Type *type) const {
   return size != 0 ? size : 1;
 }
 
+// Return the offset of the element with the given index in the struct type
+uint64_t CodeGen::ElementOffset(llvm::Type *type, uint32_t element_idx) const {
+  PL_ASSERT(type->isStructTy());
+  auto *struct_layout = code_context_.GetDataLayout().getStructLayout(
+      llvm::cast<llvm::StructType>(type));
+  return struct_layout->getElementOffset(element_idx);
+}
+
 }  // namespace codegen
 }  // namespace peloton
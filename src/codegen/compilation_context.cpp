@@ -68,13 +68,29 @@ CompilationContext::CompilationContext(Query &query,
 void CompilationContext::Prepare(const planner::AbstractPlan &op,
                                  Pipeline &pipeline) {
   auto translator = translator_factory_.CreateTranslator(op, *this, pipeline);
-  op_translators_.insert(std::make_pair(&op, std::move(translator)));
+  if (op_translators_.insert(std::make_pair(&op, std::move(translator)))
+          .second) {
+    prepared_ops_.push_back(&op);
+  }
 }
 
 // Prepare the translator for the given expression
 void CompilationContext::Prepare(const expression::AbstractExpression &exp) {
   auto translator = translator_factory_.CreateTranslator(exp, *this);
-  exp_translators_.insert(std::make_pair(&exp, std::move(translator)));
+  if (exp_translators_.insert(std::make_pair(&exp, std::move(translator)))
+          .second) {
+    prepared_exps_.push_back(&exp);
+  }
+}
+
+// Install a specialized translator for the given expression
+void CompilationContext::Prepare(
+    const expression::AbstractExpression &exp,
+    std::unique_ptr<ExpressionTranslator> translator) {
+  if (exp_translators_.count(&exp) == 0) {
+    prepared_exps_.push_back(&exp);
+  }
+  exp_translators_[&exp] = std::move(translator);
 }
 
 // Produce tuples for the given operator
@@ -84,6 +100,21 @@ void CompilationContext::Produce(const planner::AbstractPlan &op) {
   translator->Produce();
 }
 
+// Push down the filter into the scan
+void CompilationContext::PushDownScanFilter(const planner::AbstractPlan &scan,
+                                            const ScanFilter &filter) {
+  PL_ASSERT(GetTranslator(scan) == nullptr);
+  scan_filters_[&scan].push_back(filter);
+}
+
+// Get the filters pushed down into the scan
+const std::vector<CompilationContext::ScanFilter> &
+CompilationContext::GetScanFilters(const planner::AbstractPlan &scan) const {
+  static const std::vector<ScanFilter> kNoFilters;
+  auto iter = scan_filters_.find(&scan);
+  return iter != scan_filters_.end() ? iter->second : kNoFilters;
+}
+
 // Generate all plan functions for the given query
 void CompilationContext::GeneratePlan(QueryCompiler::CompileStats *stats) {
   // Start timing
@@ -138,16 +169,15 @@ void CompilationContext::GeneratePlan(QueryCompiler::CompileStats *stats) {
 // Generate any helper functions that the query needs
 void CompilationContext::GenerateHelperFunctions() {
   // Allow each operator to initialize its state
-  for (auto &iter : op_translators_) {
-    auto &translator = iter.second;
-    translator->DefineAuxiliaryFunctions();
+  for (const auto *op : prepared_ops_) {
+    GetTranslator(*op)->DefineAuxiliaryFunctions();
   }
 
   // Define each auxiliary producer function
   auto &cc = query_.GetCodeContext();
-  for (auto &iter : auxiliary_producers_) {
-    const auto &plan = *iter.first;
-    const auto &function_declaration = iter.second;
+  for (const auto *producer : auxiliary_producer_order_) {
+    const auto &plan = *producer;
+    const auto &function_declaration = auxiliary_producers_.at(producer);
     FunctionBuilder func{cc, function_declaration};
     {
       // Don't try to optimize this by moving the cache population outside the
@@ -182,7 +212,9 @@ llvm::Function *CompilationContext::GenerateInitFunction() {
   auto &code_context = query_.GetCodeContext();
   auto &runtime_state = query_.GetRuntimeState();
 
-  std::string name = StringUtil::Format("_%lu_init", code_context.GetID());
+  // The names of the functions don't depend on the ID of the code context so
+  // that the same plan always yields the same code
+  std::string name = "_query_init";
   std::vector<FunctionDeclaration::ArgumentInfo> args = {
       {"runtimeState", runtime_state.FinalizeType(codegen_)->getPointerTo()}};
   FunctionBuilder init_func{code_context, name, codegen_.VoidType(), args};
@@ -191,9 +223,15 @@ llvm::Function *CompilationContext::GenerateInitFunction() {
     result_consumer_.InitializeState(*this);
 
     // Allow each operator to initialize their state
-    for (auto &iter : op_translators_) {
-      auto &translator = iter.second;
-      translator->InitializeState();
+    for (const auto *op : prepared_ops_) {
+      GetTranslator(*op)->InitializeState();
+    }
+
+    // Expressions may build their state from the query parameters
+    InitializeParameterCache(codegen_, parameter_cache_,
+                             GetQueryParametersPtr());
+    for (const auto *exp : prepared_exps_) {
+      GetTranslator(*exp)->InitializeState();
     }
 
     // Finish the function
@@ -211,7 +249,7 @@ llvm::Function *CompilationContext::GeneratePlanFunction(
   auto &code_context = query_.GetCodeContext();
   auto &runtime_state = query_.GetRuntimeState();
 
-  std::string name = StringUtil::Format("_%lu_plan", code_context.GetID());
+  std::string name = "_query_plan";
   std::vector<FunctionDeclaration::ArgumentInfo> args = {
       {"runtimeState", runtime_state.FinalizeType(codegen_)->getPointerTo()}};
   FunctionBuilder plan_func{code_context, name, codegen_.VoidType(), args};
@@ -237,7 +275,7 @@ llvm::Function *CompilationContext::GenerateTearDownFunction() {
   auto &code_context = query_.GetCodeContext();
   auto &runtime_state = query_.GetRuntimeState();
 
-  std::string name = StringUtil::Format("_%lu_tearDown", code_context.GetID());
+  std::string name = "_query_tearDown";
   std::vector<FunctionDeclaration::ArgumentInfo> args = {
       {"runtimeState", runtime_state.FinalizeType(codegen_)->getPointerTo()}};
   FunctionBuilder tear_down_func{code_context, name, codegen_.VoidType(), args};
@@ -246,9 +284,12 @@ llvm::Function *CompilationContext::GenerateTearDownFunction() {
     result_consumer_.TearDownState(*this);
 
     // Allow each operator to clean up their state
-    for (auto &iter : op_translators_) {
-      auto &translator = iter.second;
-      translator->TearDownState();
+    for (const auto *op : prepared_ops_) {
+      GetTranslator(*op)->TearDownState();
+    }
+
+    for (const auto *exp : prepared_exps_) {
+      GetTranslator(*exp)->TearDownState();
     }
 
     // Finish the function
@@ -289,7 +330,7 @@ AuxiliaryProducerFunction CompilationContext::DeclareAuxiliaryProducer(
   if (!provided_name.empty()) {
     fn_name = provided_name;
   } else {
-    fn_name = StringUtil::Format("_%lu_auxPlanFunction", cc.GetID());
+    fn_name = "_query_auxPlanFunction";
   }
 
   std::vector<FunctionDeclaration::ArgumentInfo> fn_args = {
@@ -301,6 +342,7 @@ AuxiliaryProducerFunction CompilationContext::DeclareAuxiliaryProducer(
 
   // Save the function declaration for later definition
   auxiliary_producers_.emplace(&plan, declaration);
+  auxiliary_producer_order_.push_back(&plan);
 
   return AuxiliaryProducerFunction(declaration);
 }
@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// dictionary_comparison_translator.cpp
+//
+// Identification: src/codegen/expression/dictionary_comparison_translator.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/expression/dictionary_comparison_translator.h"
+
+#include <algorithm>
+
+#include "codegen/lang/if.h"
+#include "codegen/type/boolean_type.h"
+#include "expression/comparison_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/attribute_info.h"
+#include "storage/data_table.h"
+#include "storage/string_dictionary.h"
+
+namespace peloton {
+namespace codegen {
+
+// Constructor
+DictionaryComparisonTranslator::DictionaryComparisonTranslator(
+    const expression::ComparisonExpression &comparison,
+    CompilationContext &context, uint32_t column_child,
+    std::vector<uint32_t> codes)
+    : ExpressionTranslator(comparison, context),
+      column_child_(column_child),
+      codes_(std::move(codes)) {
+  PL_ASSERT(column_child < comparison.GetChildrenSize());
+  PL_ASSERT(!codes_.empty());
+  PL_ASSERT(comparison.GetExpressionType() == ExpressionType::COMPARE_IN ||
+            codes_.size() == 1);
+}
+
+bool DictionaryComparisonTranslator::FindCode(
+    const expression::AbstractExpression &constant,
+    const storage::DataTable &table, const planner::AttributeInfo &column,
+    uint32_t &code) {
+  if (constant.GetExpressionType() != ExpressionType::VALUE_CONSTANT) {
+    return false;
+  }
+
+  const auto &value =
+      static_cast<const expression::ConstantValueExpression &>(constant)
+          .GetValue();
+  if (value.IsNull() || value.GetTypeId() != column.type.type_id) {
+    return false;
+  }
+
+  // The constant may not be in the dictionary yet. Since codes are never
+  // reused, we could compile a constant result, but plans are cached.
+  auto *dictionary = table.GetColumnDictionary(column.attribute_id);
+  const char *varlen = dictionary->Find(value.GetData(), value.GetLength());
+  if (varlen == nullptr) {
+    return false;
+  }
+
+  code = storage::StringDictionary::GetCode(varlen);
+  return true;
+}
+
+bool DictionaryComparisonTranslator::CanTranslate(
+    const expression::ComparisonExpression &comparison,
+    const storage::DataTable &table, uint32_t &column_child,
+    std::vector<uint32_t> &codes) {
+  auto get_column = [&table](const expression::AbstractExpression &exp)
+      -> const planner::AttributeInfo * {
+    if (exp.GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+      return nullptr;
+    }
+    const auto *ai =
+        static_cast<const expression::TupleValueExpression &>(exp)
+            .GetAttributeRef();
+    if (table.GetColumnDictionary(ai->attribute_id) == nullptr) {
+      return nullptr;
+    }
+    return ai;
+  };
+
+  codes.clear();
+  switch (comparison.GetExpressionType()) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL: {
+      for (uint32_t i = 0; i < 2; i++) {
+        const auto *column = get_column(*comparison.GetChild(i));
+        uint32_t code;
+        if (column != nullptr &&
+            FindCode(*comparison.GetChild(1 - i), table, *column, code)) {
+          column_child = i;
+          codes.push_back(code);
+          return true;
+        }
+      }
+      return false;
+    }
+    case ExpressionType::COMPARE_IN: {
+      const auto *column = get_column(*comparison.GetChild(0));
+      if (column == nullptr) {
+        return false;
+      }
+      for (uint32_t i = 1; i < comparison.GetChildrenSize(); i++) {
+        uint32_t code;
+        if (!FindCode(*comparison.GetChild(i), table, *column, code)) {
+          codes.clear();
+          return false;
+        }
+        codes.push_back(code);
+      }
+      // Duplicate items are compared once
+      std::sort(codes.begin(), codes.end());
+      codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+      column_child = 0;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+// Produce the result of comparing the codes
+codegen::Value DictionaryComparisonTranslator::DeriveValue(
+    CodeGen &codegen, RowBatch::Row &row) const {
+  const auto &comparison = GetExpressionAs<expression::ComparisonExpression>();
+
+  // The value's data pointer is right after the length of the entry, which
+  // is right after the code
+  codegen::Value column =
+      row.DeriveValue(codegen, *comparison.GetChild(column_child_));
+  auto load_code = [&codegen, &column]() {
+    llvm::Value *code_ptr = codegen->CreateGEP(
+        codegen.ByteType(), column.GetValue(),
+        codegen.Const64(storage::StringDictionary::kCodeOffset));
+    return codegen->CreateLoad(
+        codegen->CreateBitCast(code_ptr, codegen.Int32Type()->getPointerTo()));
+  };
+
+  llvm::Value *code = nullptr;
+  if (column.IsNullable()) {
+    // NULLs have no entry
+    llvm::Value *null_code = nullptr, *entry_code = nullptr;
+    lang::If is_null{codegen, column.IsNull(codegen)};
+    {
+      null_code = codegen.Const32(0);
+    }
+    is_null.ElseBlock();
+    {
+      entry_code = load_code();
+    }
+    is_null.EndIf();
+    code = is_null.BuildPHI(null_code, entry_code);
+  } else {
+    code = load_code();
+  }
+
+  // The items of an IN-list are never NULL, so it is true if any code matches.
+  // Values that didn't fit into the dictionary match none of the codes.
+  llvm::Value *result =
+      codegen->CreateICmpEQ(code, codegen.Const32(codes_[0]));
+  for (uint32_t i = 1; i < codes_.size(); i++) {
+    result = codegen->CreateOr(
+        result, codegen->CreateICmpEQ(code, codegen.Const32(codes_[i])));
+  }
+  if (comparison.GetExpressionType() == ExpressionType::COMPARE_NOTEQUAL) {
+    result = codegen->CreateNot(result);
+  }
+
+  type::Type result_type{type::Boolean::Instance(), column.IsNullable()};
+  return codegen::Value{result_type, result, nullptr,
+                        column.IsNullable() ? column.IsNull(codegen) : nullptr};
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// in_list_translator.cpp
+//
+// Identification: src/codegen/expression/in_list_translator.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/expression/in_list_translator.h"
+
+#include "codegen/lang/if.h"
+#include "codegen/proxy/oa_hash_table_proxy.h"
+#include "codegen/type/boolean_type.h"
+#include "expression/comparison_expression.h"
+
+namespace peloton {
+namespace codegen {
+
+namespace {
+
+// Record that the probed key was found in the hash set
+class FoundCallback : public HashTable::IterateCallback {
+ public:
+  explicit FoundCallback(llvm::Value *found) : found_(found) {}
+
+  void ProcessEntry(CodeGen &codegen,
+                    UNUSED_ATTRIBUTE const std::vector<codegen::Value> &keys,
+                    UNUSED_ATTRIBUTE llvm::Value *values) const override {
+    codegen->CreateStore(codegen.ConstBool(true), found_);
+  }
+
+ private:
+  llvm::Value *found_;
+};
+
+}  // anonymous namespace
+
+constexpr uint32_t InListTranslator::kMaxUnrolledListSize;
+
+// Constructor
+InListTranslator::InListTranslator(
+    const expression::ComparisonExpression &in_list,
+    CompilationContext &context)
+    : ExpressionTranslator(in_list, context),
+      use_hash_set_(in_list.GetChildrenSize() - 1 > kMaxUnrolledListSize &&
+                    CanUseHashSet(in_list)),
+      key_type_(in_list.GetChild(0)->GetValueType(), false) {
+  PL_ASSERT(in_list.GetExpressionType() == ExpressionType::COMPARE_IN);
+  PL_ASSERT(in_list.GetChildrenSize() >= 2);
+  if (!use_hash_set_) {
+    return;
+  }
+
+  auto &codegen = context.GetCodeGen();
+  hash_set_ = OAHashTable{codegen, {key_type_}, 0};
+  hash_set_id_ = context.GetRuntimeState().RegisterState(
+      "inListSet", OAHashTableProxy::GetType(codegen));
+}
+
+// The items are inserted into the set before any row is seen, so they have to
+// be query parameters. They must not be NULL, and must have the type of the
+// value so that equal values have equal hashes.
+bool InListTranslator::CanUseHashSet(
+    const expression::ComparisonExpression &in_list) {
+  auto value_type = in_list.GetChild(0)->GetValueType();
+  for (uint32_t i = 1; i < in_list.GetChildrenSize(); i++) {
+    const auto *item = in_list.GetChild(i);
+    auto item_type = item->GetExpressionType();
+    if ((item_type != ExpressionType::VALUE_CONSTANT &&
+         item_type != ExpressionType::VALUE_PARAMETER) ||
+        item->IsNullable() || item->GetValueType() != value_type) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void InListTranslator::InitializeState() {
+  if (!use_hash_set_) {
+    return;
+  }
+
+  auto &codegen = context_.GetCodeGen();
+  llvm::Value *hash_set =
+      context_.GetRuntimeState().LoadStatePtr(codegen, hash_set_id_);
+  hash_set_.Init(codegen, hash_set);
+
+  // Duplicate items are inserted once
+  const auto &in_list = GetExpressionAs<expression::ComparisonExpression>();
+  for (uint32_t i = 1; i < in_list.GetChildrenSize(); i++) {
+    auto index = context_.GetParameterIdx(in_list.GetChild(i));
+    codegen::Value item = context_.GetParameterCache().GetValue(index);
+    std::vector<codegen::Value> key = {
+        codegen::Value{key_type_, item.GetValue(), item.GetLength()}};
+    HashTable::NoOpProbeCallback probe;
+    HashTable::NoOpInsertCallback insert;
+    hash_set_.ProbeOrInsert(codegen, hash_set, nullptr, key, probe, insert);
+  }
+}
+
+void InListTranslator::TearDownState() {
+  if (!use_hash_set_) {
+    return;
+  }
+
+  auto &codegen = context_.GetCodeGen();
+  hash_set_.Destroy(codegen, context_.GetRuntimeState().LoadStatePtr(
+                                 codegen, hash_set_id_));
+}
+
+codegen::Value InListTranslator::DeriveValue(CodeGen &codegen,
+                                             RowBatch::Row &row) const {
+  if (use_hash_set_) {
+    return DeriveValueHashed(codegen, row);
+  } else {
+    return DeriveValueUnrolled(codegen, row);
+  }
+}
+
+// The comparisons are combined with a logical OR, whose NULL handling gives
+// the SQL semantics of IN
+codegen::Value InListTranslator::DeriveValueUnrolled(
+    CodeGen &codegen, RowBatch::Row &row) const {
+  const auto &in_list = GetExpressionAs<expression::ComparisonExpression>();
+  codegen::Value value = row.DeriveValue(codegen, *in_list.GetChild(0));
+
+  codegen::Value result =
+      value.CompareEq(codegen, row.DeriveValue(codegen, *in_list.GetChild(1)));
+  for (uint32_t i = 2; i < in_list.GetChildrenSize(); i++) {
+    codegen::Value item = row.DeriveValue(codegen, *in_list.GetChild(i));
+    result = result.LogicalOr(codegen, value.CompareEq(codegen, item));
+  }
+  return result;
+}
+
+// The items are never NULL, so the result is NULL only if the value is
+codegen::Value InListTranslator::DeriveValueHashed(CodeGen &codegen,
+                                                   RowBatch::Row &row) const {
+  const auto &in_list = GetExpressionAs<expression::ComparisonExpression>();
+  codegen::Value value = row.DeriveValue(codegen, *in_list.GetChild(0));
+
+  llvm::Value *found = codegen.AllocateVariable(codegen.BoolType(), "inList");
+  codegen->CreateStore(codegen.ConstBool(false), found);
+
+  llvm::Value *hash_set =
+      context_.GetRuntimeState().LoadStatePtr(codegen, hash_set_id_);
+  std::vector<codegen::Value> key = {
+      codegen::Value{key_type_, value.GetValue(), value.GetLength()}};
+  FoundCallback callback{found};
+  if (value.IsNullable()) {
+    lang::If not_null{codegen, codegen->CreateNot(value.IsNull(codegen))};
+    {
+      hash_set_.FindAll(codegen, hash_set, key, callback);
+    }
+    not_null.EndIf();
+  } else {
+    hash_set_.FindAll(codegen, hash_set, key, callback);
+  }
+
+  type::Type result_type{type::Boolean::Instance(), value.IsNullable()};
+  llvm::Value *is_null = value.IsNullable() ? value.IsNull(codegen) : nullptr;
+  return codegen::Value{result_type, codegen->CreateLoad(found), nullptr,
+                        is_null};
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_probe.cpp
+//
+// Identification: src/codegen/index_probe.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/index_probe.h"
+
+#include "catalog/manager.h"
+#include "common/exception.h"
+#include "concurrency/transaction_context.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "index/index.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "type/ephemeral_pool.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace codegen {
+
+void IndexProbe::Init(storage::DataTable *table, uint32_t index_oid,
+                      executor::ExecutorContext *executor_context,
+                      bool is_for_update) {
+  PL_ASSERT(table != nullptr && executor_context != nullptr);
+  // The table owns the index, and outlives the query
+  index_ = table->GetIndexWithOid(index_oid).get();
+  PL_ASSERT(index_ != nullptr);
+  executor_context_ = executor_context;
+  is_for_update_ = is_for_update;
+  key_ = new storage::Tuple(index_->GetKeySchema(), true);
+  key_pool_ = new peloton::type::EphemeralPool();
+  matches_ = new std::vector<ItemPointer>();
+}
+
+uint32_t IndexProbe::Probe(char *key_values) {
+  using peloton::type::Value;
+  auto *vals = reinterpret_cast<Value *>(key_values);
+  const auto *key_schema = index_->GetKeySchema();
+  uint32_t num_keys = key_schema->GetColumnCount();
+
+  // The varlen key values of the previous probe are no longer needed
+  delete key_pool_;
+  key_pool_ = new peloton::type::EphemeralPool();
+
+  // Build the key. NULL never compares equal, and a value that cannot be cast
+  // to the key type (e.g., out of its range) equals no key, so in both cases
+  // there cannot be any match.
+  bool no_match = false;
+  for (uint32_t i = 0; i < num_keys; i++) {
+    if (vals[i].IsNull()) {
+      no_match = true;
+    } else if (!no_match) {
+      try {
+        key_->SetValue(i, vals[i].CastAs(key_schema->GetColumn(i).GetType()),
+                       key_pool_);
+      } catch (Exception &e) {
+        no_match = true;
+      }
+    }
+    // The values were constructed in place by the generated code
+    vals[i].~Value();
+  }
+
+  matches_->clear();
+  if (no_match) {
+    return 0;
+  }
+
+  std::vector<ItemPointer *> locations;
+  index_->ScanKey(key_, locations);
+  for (auto *location : locations) {
+    if (!FindVisibleVersion(*location)) {
+      matches_->clear();
+      break;
+    }
+  }
+  return static_cast<uint32_t>(matches_->size());
+}
+
+storage::TileGroup *IndexProbe::GetTileGroup(uint32_t match_idx) const {
+  PL_ASSERT(match_idx < matches_->size());
+  auto &manager = catalog::Manager::GetInstance();
+  return manager.GetTileGroup((*matches_)[match_idx].block).get();
+}
+
+uint32_t IndexProbe::GetTupleOffset(uint32_t match_idx) const {
+  PL_ASSERT(match_idx < matches_->size());
+  return (*matches_)[match_idx].offset;
+}
+
+void IndexProbe::TearDown() {
+  delete key_;
+  key_ = nullptr;
+  delete key_pool_;
+  key_pool_ = nullptr;
+  delete matches_;
+  matches_ = nullptr;
+}
+
+// This follows the version chain the same way the index scan executor does
+bool IndexProbe::FindVisibleVersion(ItemPointer location) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = executor_context_->GetTransaction();
+  auto &manager = catalog::Manager::GetInstance();
+
+  auto tile_group = manager.GetTileGroup(location.block);
+  auto *tile_group_header = tile_group->GetHeader();
+  size_t chain_length = 0;
+  while (true) {
+    ++chain_length;
+
+    auto visibility =
+        txn_manager.IsVisible(txn, tile_group_header, location.offset);
+    if (visibility == VisibilityType::DELETED) {
+      return true;
+    } else if (visibility == VisibilityType::OK) {
+      if (!txn_manager.PerformRead(txn, location, is_for_update_)) {
+        txn_manager.SetTransactionResult(txn, ResultType::FAILURE);
+        return false;
+      }
+      matches_->push_back(location);
+      return true;
+    }
+
+    PL_ASSERT(visibility == VisibilityType::INVISIBLE);
+    bool is_acquired = (tile_group_header->GetTransactionId(location.offset) ==
+                        INITIAL_TXN_ID);
+    bool is_alive = (tile_group_header->GetEndCommitId(location.offset) <=
+                     txn->GetReadId());
+    if (is_acquired && is_alive) {
+      // The chain was modified concurrently, start over from its head
+      location = *(tile_group_header->GetIndirection(location.offset));
+      chain_length = 0;
+    } else {
+      location = tile_group_header->GetNextItemPointer(location.offset);
+      if (location.IsNull()) {
+        if (chain_length == 1) {
+          return true;
+        }
+        txn_manager.SetTransactionResult(txn, ResultType::FAILURE);
+        return false;
+      }
+    }
+    tile_group = manager.GetTileGroup(location.block);
+    tile_group_header = tile_group->GetHeader();
+  }
+}
+
+}  // namespace codegen
+}  // namespace peloton
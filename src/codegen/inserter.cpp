@@ -53,6 +53,9 @@ void Inserter::Insert() {
   auto *txn = executor_context_->GetTransaction();
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
 
+  // Values of dictionary-encoded columns were written through the pool
+  tile_->InternVarlenValues(location_.offset);
+
   ContainerTuple<storage::TileGroup> tuple(
       table_->GetTileGroupById(location_.block).get(), location_.offset);
   ItemPointer *index_entry_ptr = nullptr;
@@ -704,6 +704,22 @@ void OAHashTable::FindAll(CodeGen &codegen, llvm::Value *ht_ptr,
                    false);
 }
 
+llvm::Value *OAHashTable::NumEntries(CodeGen &codegen,
+                                     llvm::Value *ht_ptr) const {
+  return LoadHashTableField(codegen, ht_ptr, 4);
+}
+
+llvm::Value *OAHashTable::LoadEntry(CodeGen &codegen, llvm::Value *entry_ptr,
+                                    llvm::Value *&hash,
+                                    std::vector<codegen::Value> &key) const {
+  llvm::Type *entry_type = OAHashEntryProxy::GetType(codegen);
+  entry_ptr = codegen->CreateBitCast(entry_ptr, entry_type->getPointerTo());
+  hash = LoadHashEntryField(codegen, entry_ptr, 0, 1);
+  llvm::Value *key_ptr = GetKeyPtr(codegen, entry_ptr);
+  key_storage_.LoadValues(codegen, key_ptr, key);
+  return AdvancePointer(codegen, key_ptr, key_storage_.MaxStorageSize());
+}
+
 void OAHashTable::Destroy(CodeGen &codegen, llvm::Value *ht_ptr) const {
   codegen.Call(OAHashTableProxy::Destroy, {ht_ptr});
 }
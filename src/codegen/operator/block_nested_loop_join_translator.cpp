@@ -13,10 +13,16 @@
 
 #include "codegen/operator/block_nested_loop_join_translator.h"
 
+#include <limits>
+
 #include "codegen/compilation_context.h"
 #include "codegen/function_builder.h"
 #include "codegen/operator/projection_translator.h"
+#include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
 #include "codegen/proxy/sorter_proxy.h"
+#include "codegen/type/boolean_type.h"
+#include "codegen/type/sql_type.h"
 #include "planner/nested_loop_join_plan.h"
 #include "settings/settings_manager.h"
 
@@ -96,6 +102,11 @@ BlockNestedLoopJoinTranslator::BlockNestedLoopJoinTranslator(
     left_input_desc.push_back(ai->type);
   }
 
+  // The match flag follows the attributes
+  if (TracksLeftMatches()) {
+    left_input_desc.push_back(type::Type{type::Boolean::Instance()});
+  }
+
   // Allocate buffer instance in runtime state and configure its accessor
   auto &codegen = GetCodeGen();
   auto &runtime_state = context.GetRuntimeState();
@@ -110,6 +121,12 @@ BlockNestedLoopJoinTranslator::BlockNestedLoopJoinTranslator(
   max_buf_rows_ =
       static_cast<uint32_t>(std::max(1.0, max_buffer_size / row_size));
 
+  // Whether a tuple found a match is only known after it has been joined with
+  // all the tuples of the other side
+  if (nlj_plan.GetJoinType() != JoinType::INNER) {
+    max_buf_rows_ = std::numeric_limits<uint32_t>::max();
+  }
+
   LOG_DEBUG(
       "Buffer size: %.2lf bytes, row size: %u.0 bytes, max buffered rows: %u",
       max_buffer_size, row_size, max_buf_rows_);
@@ -144,17 +161,26 @@ void BlockNestedLoopJoinTranslator::Produce() const {
   // Let the left child produce tuples we'll batch-process in Consume()
   GetCompilationContext().Produce(*GetPlan().GetChild(0));
 
-  // Flush any remaining buffered tuples through the join
   auto &codegen = GetCodeGen();
-  auto *num_tuples =
-      buffer_.GetNumberOfStoredTuples(codegen, LoadStatePtr(buffer_id_));
-  lang::If has_tuples{codegen,
-                      codegen->CreateICmpUGT(num_tuples, codegen.Const32(0))};
-  {
-    // Flush remaining
+  if (ProducesUnmatchedRight()) {
+    // The right tuples are produced even if nothing was buffered
     join_buffer_func_.Call(codegen);
+  } else {
+    // Flush any remaining buffered tuples through the join
+    auto *num_tuples =
+        buffer_.GetNumberOfStoredTuples(codegen, LoadStatePtr(buffer_id_));
+    lang::If has_tuples{codegen,
+                        codegen->CreateICmpUGT(num_tuples, codegen.Const32(0))};
+    {
+      // Flush remaining
+      join_buffer_func_.Call(codegen);
+    }
+    has_tuples.EndIf();
+  }
+
+  if (TracksLeftMatches()) {
+    ProduceBufferedTuples();
   }
-  has_tuples.EndIf();
 }
 
 bool BlockNestedLoopJoinTranslator::IsFromLeftChild(
@@ -171,6 +197,9 @@ void BlockNestedLoopJoinTranslator::ConsumeFromLeft(
   for (const auto &left_ai : unique_left_attributes_) {
     tuple.push_back(row.DeriveValue(codegen, left_ai));
   }
+  if (TracksLeftMatches()) {
+    tuple.emplace_back(type::Boolean::Instance(), codegen.ConstBool(false));
+  }
 
   // Append tuple to buffer
   auto *buffer_ptr = LoadStatePtr(buffer_id_);
@@ -210,87 +239,240 @@ namespace {
 
 // This is the callback called for every tuple in the buffer. There's a bit of
 // ceremony, but it's just a callback function.
-class BufferedTupleCallback : public Sorter::IterateCallback {
+class BufferedTupleCallback : public Sorter::VectorizedIterateCallback {
  public:
   // Constructor
   BufferedTupleCallback(
       const planner::NestedLoopJoinPlan &plan,
       const std::vector<const planner::AttributeInfo *> &left_attributes,
-      ConsumerContext &ctx, RowBatch::Row &right_row);
+      std::function<void(RowBatch::Row &)> project_and_consume,
+      RowBatch::Row &right_row, llvm::Value *right_matched);
 
-  // The callback invoked for each tuple in the sorter/buffer
-  void ProcessEntry(CodeGen &codegen,
-                    const std::vector<codegen::Value> &left_row) const override;
+  // The callback invoked for each range of tuples in the sorter/buffer
+  void ProcessEntries(CodeGen &codegen, llvm::Value *start_index,
+                      llvm::Value *end_index,
+                      Sorter::SorterAccess &access) const override;
 
-  void ProjectAndConsume() const;
+ private:
+  // Record the match of the right row with the buffered row, and produce it
+  void ProcessMatch(CodeGen &codegen,
+                    Sorter::SorterAccess::Row &left_row) const;
 
  private:
   // The plan
   const planner::NestedLoopJoinPlan &plan_;
   // The attributes produced by the left child
   const std::vector<const planner::AttributeInfo *> &left_attributes_;
-  // The consumer context
-  ConsumerContext &ctx_;
+  // Sends the joined row up to the parent
+  std::function<void(RowBatch::Row &)> project_and_consume_;
   // The current "outer" row
   RowBatch::Row &right_row_;
+  // The flag set when the right row finds a match, if it is tracked
+  llvm::Value *right_matched_;
 };
 
 BufferedTupleCallback::BufferedTupleCallback(
     const planner::NestedLoopJoinPlan &plan,
     const std::vector<const planner::AttributeInfo *> &left_attributes,
-    ConsumerContext &ctx, RowBatch::Row &right_row)
+    std::function<void(RowBatch::Row &)> project_and_consume,
+    RowBatch::Row &right_row, llvm::Value *right_matched)
     : plan_(plan),
       left_attributes_(left_attributes),
-      ctx_(ctx),
-      right_row_(right_row) {}
-
-// This function is called for each tuple in the BNLJ buffer.
-void BufferedTupleCallback::ProcessEntry(
-    CodeGen &codegen, const std::vector<codegen::Value> &left_row) const {
-  PL_ASSERT(left_row.size() == left_attributes_.size());
-
-  // Add all the attributes from left tuple (from the sorter) into the row
-  // coming from the right input side. We need to do this in order to evaluate
-  // the predicate.
-  for (size_t i = 0; i < left_attributes_.size(); i++) {
-    right_row_.RegisterAttributeValue(left_attributes_[i], left_row[i]);
+      project_and_consume_(project_and_consume),
+      right_row_(right_row),
+      right_matched_(right_matched) {}
+
+// This function is called for each range of tuples in the BNLJ buffer.
+void BufferedTupleCallback::ProcessEntries(
+    CodeGen &codegen, llvm::Value *start_index, llvm::Value *end_index,
+    Sorter::SorterAccess &access) const {
+  lang::Loop loop{codegen,
+                  codegen->CreateICmpULT(start_index, end_index),
+                  {{"bufferIdx", start_index}}};
+  {
+    llvm::Value *curr_index = loop.GetLoopVar(0);
+    auto &left_row = access.GetRow(curr_index);
+
+    // Add all the attributes from left tuple (from the sorter) into the row
+    // coming from the right input side. We need to do this in order to
+    // evaluate the predicate.
+    for (uint32_t i = 0; i < left_attributes_.size(); i++) {
+      right_row_.RegisterAttributeValue(left_attributes_[i],
+                                        left_row.LoadColumn(codegen, i));
+    }
+
+    auto *predicate = plan_.GetPredicate();
+    if (predicate == nullptr) {
+      // No predicate, every pair matches
+      ProcessMatch(codegen, left_row);
+    } else {
+      // Check predicate before sending to parent
+      const auto &valid = right_row_.DeriveValue(codegen, *predicate);
+      lang::If valid_match{codegen, valid};
+      {
+        // Valid tuple
+        ProcessMatch(codegen, left_row);
+      }
+      valid_match.EndIf();
+    }
+
+    curr_index = codegen->CreateAdd(curr_index, codegen.Const32(1));
+    loop.LoopEnd(codegen->CreateICmpULT(curr_index, end_index), {curr_index});
   }
+}
 
-  auto *predicate = plan_.GetPredicate();
-  if (predicate == nullptr) {
-    // No predicate, just apply projection and finish
-    ProjectAndConsume();
-  } else {
-    // Check predicate before sending to parent
-    const auto &valid = right_row_.DeriveValue(codegen, *predicate);
-    lang::If valid_match{codegen, valid};
+void BufferedTupleCallback::ProcessMatch(
+    CodeGen &codegen, Sorter::SorterAccess::Row &left_row) const {
+  auto join_type = plan_.GetJoinType();
+
+  // The match flag is stored after the attributes
+  if (join_type == JoinType::LEFT || join_type == JoinType::OUTER ||
+      join_type == JoinType::SEMI || join_type == JoinType::ANTI) {
+    left_row.StoreColumn(
+        codegen, static_cast<uint32_t>(left_attributes_.size()),
+        codegen::Value{type::Boolean::Instance(), codegen.ConstBool(true)});
+  }
+  if (right_matched_ != nullptr) {
+    codegen->CreateStore(codegen.ConstBool(true), right_matched_);
+  }
+
+  // Semi and anti joins only produce buffered tuples, once the right side is
+  // exhausted
+  if (join_type != JoinType::SEMI && join_type != JoinType::ANTI) {
+    project_and_consume_(right_row_);
+  }
+}
+
+// This is the callback that produces the buffered tuples the join type asks
+// for once the right side is exhausted
+class ProduceBufferedCallback : public Sorter::IterateCallback {
+ public:
+  // Constructor
+  ProduceBufferedCallback(
+      const planner::NestedLoopJoinPlan &plan,
+      const std::vector<const planner::AttributeInfo *> &left_attributes,
+      std::function<void(const std::vector<const planner::AttributeInfo *> &,
+                         const std::vector<codegen::Value> &)> produce_row)
+      : plan_(plan), left_attributes_(left_attributes),
+        produce_row_(produce_row) {}
+
+  // The callback invoked for each tuple in the sorter/buffer
+  void ProcessEntry(CodeGen &codegen,
+                    const std::vector<codegen::Value> &vals) const override {
+    PL_ASSERT(vals.size() == left_attributes_.size() + 1);
+    auto join_type = plan_.GetJoinType();
+
+    auto *matched = vals.back().GetValue();
+    auto *produce =
+        join_type == JoinType::SEMI ? matched : codegen->CreateNot(matched);
+    lang::If produce_tuple{codegen, produce};
+    {
+      std::vector<const planner::AttributeInfo *> ais = left_attributes_;
+      std::vector<codegen::Value> row_vals{vals.begin(), vals.end() - 1};
+
+      // Outer joins pad the tuple with NULL right attributes
+      if (join_type == JoinType::LEFT || join_type == JoinType::OUTER) {
+        for (const auto *right_ai : plan_.GetRightAttributes()) {
+          ais.push_back(right_ai);
+          row_vals.push_back(right_ai->type.GetSqlType().GetNullValue(codegen));
+        }
+      }
+      produce_row_(ais, row_vals);
+    }
+    produce_tuple.EndIf();
+  }
+
+ private:
+  // The plan
+  const planner::NestedLoopJoinPlan &plan_;
+  // The attributes produced by the left child
+  const std::vector<const planner::AttributeInfo *> &left_attributes_;
+  // Sends a single row up to the parent
+  std::function<void(const std::vector<const planner::AttributeInfo *> &,
+                     const std::vector<codegen::Value> &)> produce_row_;
+};
+
+}  // anonymous namespace
+
+void BlockNestedLoopJoinTranslator::FindMatchesForRow(
+    ConsumerContext &ctx, RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+
+  // Keep the row as it is before the buffered attributes are added to it, to
+  // produce it if there is no match
+  RowBatch::Row unmatched_row = row;
+  llvm::Value *right_matched = nullptr;
+  if (ProducesUnmatchedRight()) {
+    right_matched = codegen.AllocateVariable(codegen.BoolType(), "rightMatch");
+    codegen->CreateStore(codegen.ConstBool(false), right_matched);
+  }
+
+  BufferedTupleCallback callback{
+      GetPlan(), unique_left_attributes_,
+      [this, &ctx](RowBatch::Row &joined_row) {
+        ProjectAndConsume(ctx, joined_row);
+      },
+      row, right_matched};
+  buffer_.VectorizedIterate(codegen, LoadStatePtr(buffer_id_),
+                            Vector::kDefaultVectorSize, callback);
+
+  if (right_matched != nullptr) {
+    lang::If no_match{codegen,
+                      codegen->CreateNot(codegen->CreateLoad(right_matched))};
     {
-      // Valid tuple
-      ProjectAndConsume();
+      // Pad the row with NULL left attributes
+      for (const auto *left_ai : unique_left_attributes_) {
+        unmatched_row.RegisterAttributeValue(
+            left_ai, left_ai->type.GetSqlType().GetNullValue(codegen));
+      }
+
+      // The matches were sent up already, start over from this operator
+      GetPipeline().MoveTo(this);
+      ProjectAndConsume(ctx, unmatched_row);
     }
-    valid_match.EndIf();
+    no_match.EndIf();
   }
 }
 
-void BufferedTupleCallback::ProjectAndConsume() const {
-  const auto *projection_info = plan_.GetProjInfo();
+void BlockNestedLoopJoinTranslator::ProjectAndConsume(
+    ConsumerContext &ctx, RowBatch::Row &row) const {
+  const auto *projection_info = GetPlan().GetProjInfo();
   std::vector<RowBatch::ExpressionAccess> derived_attribute_access;
   if (projection_info != nullptr) {
     ProjectionTranslator::AddNonTrivialAttributes(
-        right_row_.GetBatch(), *projection_info, derived_attribute_access);
+        row.GetBatch(), *projection_info, derived_attribute_access);
   }
 
   // That's it, let the parent process the row
-  ctx_.Consume(right_row_);
+  ctx.Consume(row);
 }
 
-}  // anonymous namespace
-
-void BlockNestedLoopJoinTranslator::FindMatchesForRow(
-    ConsumerContext &ctx, RowBatch::Row &row) const {
-  BufferedTupleCallback callback{GetPlan(), unique_left_attributes_, ctx, row};
+void BlockNestedLoopJoinTranslator::ProduceBufferedTuples() const {
+  ProduceBufferedCallback callback{
+      GetPlan(), unique_left_attributes_,
+      [this](const std::vector<const planner::AttributeInfo *> &ais,
+             const std::vector<codegen::Value> &vals) {
+        ProduceSingleRow(ais, vals, GetPlan().GetProjInfo());
+      }};
   buffer_.Iterate(GetCodeGen(), LoadStatePtr(buffer_id_), callback);
 }
 
+bool BlockNestedLoopJoinTranslator::TracksLeftMatches() const {
+  switch (GetPlan().GetJoinType()) {
+    case JoinType::LEFT:
+    case JoinType::OUTER:
+    case JoinType::SEMI:
+    case JoinType::ANTI:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool BlockNestedLoopJoinTranslator::ProducesUnmatchedRight() const {
+  auto join_type = GetPlan().GetJoinType();
+  return join_type == JoinType::RIGHT || join_type == JoinType::OUTER;
+}
+
 }  // namespace codegen
 }  // namespace peloton
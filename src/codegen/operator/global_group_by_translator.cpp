@@ -16,6 +16,7 @@
 #include "codegen/lang/if.h"
 #include "common/logger.h"
 #include "planner/aggregate_plan.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace codegen {
@@ -44,11 +45,25 @@ GlobalGroupByTranslator::GlobalGroupByTranslator(
     }
   }
 
-  // Setup the aggregation handler with the terms we use for aggregation
-  aggregation_.Setup(codegen, aggregates, true);
+  // Setup the aggregation handler with the terms we use for aggregation.
+  // Distinct aggregates are deferred like those of hash aggregations, so that
+  // their values spill to disk once they outgrow the memory budget.
+  std::vector<type::Type> grouping_ai_types;
+  uint64_t distinct_table_size = 0;
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::aggregation_partitioning)) {
+    distinct_table_size = static_cast<uint64_t>(std::max(
+        1, settings::SettingsManager::GetInt(
+               settings::SettingId::aggregation_pre_aggregation_size)));
+  }
+  uint64_t memory_budget = static_cast<uint64_t>(std::max(
+      0.0, settings::SettingsManager::GetDouble(
+               settings::SettingId::aggregation_memory_budget)));
+  aggregation_.Setup(codegen, aggregates, true, grouping_ai_types,
+                     distinct_table_size, memory_budget);
 
   // Create the materialization buffer where we aggregate things
-  auto *aggregate_storage = aggregation_.GetAggregateStorage().GetStorageType();
+  auto *aggregate_storage = aggregation_.GetAggregatesType();
   PL_ASSERT(aggregate_storage->isStructTy());
 
   auto *mat_buffer_type = llvm::StructType::create(
@@ -68,6 +83,10 @@ void GlobalGroupByTranslator::InitializeState() {
   aggregation_.InitializeState(GetCodeGen());
 }
 
+void GlobalGroupByTranslator::DefineAuxiliaryFunctions() {
+  aggregation_.DefineAuxiliaryFunctions(GetCodeGen());
+}
+
 void GlobalGroupByTranslator::Produce() const {
   auto &codegen = GetCodeGen();
 
@@ -78,6 +97,12 @@ void GlobalGroupByTranslator::Produce() const {
   // Let the child produce tuples that we'll aggregate
   GetCompilationContext().Produce(*plan_.GetChild(0));
 
+  // Add the deduplicated values of deferred distinct aggregates
+  if (aggregation_.DefersDistinct()) {
+    DistinctValueAdder adder{aggregation_, mat_buffer};
+    aggregation_.IterateDistinctValues(codegen, adder);
+  }
+
   // Deserialize the finalized aggregate attribute values from the buffer
   std::vector<codegen::Value> aggregate_vals;
   aggregation_.FinalizeValues(GetCodeGen(), mat_buffer, aggregate_vals);
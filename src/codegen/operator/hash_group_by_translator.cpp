@@ -13,11 +13,15 @@
 #include "codegen/operator/hash_group_by_translator.h"
 
 #include "codegen/compilation_context.h"
+#include "codegen/function_builder.h"
+#include "codegen/proxy/hash_partitions_proxy.h"
 #include "codegen/proxy/oa_hash_table_proxy.h"
 #include "codegen/operator/projection_translator.h"
+#include "codegen/lang/loop.h"
 #include "codegen/lang/vectorized_loop.h"
 #include "codegen/type/integer_type.h"
 #include "common/logger.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace codegen {
@@ -83,18 +87,113 @@ HashGroupByTranslator::HashGroupByTranslator(
     ProjectionTranslator::PrepareProjection(context, *projection_info);
   }
 
+  // Pre-aggregate into a cache-sized hash table whose partial aggregates are
+  // merged later. Distinct aggregates are deferred to make them mergeable,
+  // their values are deduplicated in hash tables of the same size. The
+  // partitions of both spill to disk once they outgrow the memory budget.
+  use_partitioning_ = settings::SettingsManager::GetBool(
+      settings::SettingId::aggregation_partitioning);
+  memory_budget_ = static_cast<uint64_t>(std::max(
+      0.0, settings::SettingsManager::GetDouble(
+               settings::SettingId::aggregation_memory_budget)));
+  uint64_t pre_aggregation_size = static_cast<uint64_t>(
+      std::max(1, settings::SettingsManager::GetInt(
+                      settings::SettingId::aggregation_pre_aggregation_size)));
+
   // Setup the aggregation logic for this group by
-  aggregation_.Setup(codegen, aggregates, false, key_type);
+  aggregation_.Setup(codegen, aggregates, false, key_type,
+                     UsePartitioning() ? pre_aggregation_size : 0,
+                     memory_budget_);
+  PL_ASSERT(!UsePartitioning() || aggregation_.IsMergeable());
 
   // Create the hash table
   hash_table_ =
       OAHashTable{codegen, key_type, aggregation_.GetAggregatesStorageSize()};
+
+  // The pre-aggregation table is kept at most half full
+  max_pre_aggregation_entries_ = std::max<uint64_t>(
+      1, pre_aggregation_size / (2 * hash_table_.HashEntrySize()));
+  merge_func_ = nullptr;
+
+  if (UsePartitioning()) {
+    partitions_id_ = runtime_state.RegisterState(
+        "groupByPartitions", HashPartitionsProxy::GetType(codegen));
+  }
 }
 
 // Initialize the hash table instance
 void HashGroupByTranslator::InitializeState() {
   hash_table_.Init(GetCodeGen(), LoadStatePtr(hash_table_id_));
   aggregation_.InitializeState(GetCodeGen());
+  if (UsePartitioning()) {
+    GetCodeGen().Call(HashPartitionsProxy::Init,
+                      {LoadStatePtr(partitions_id_), merge_func_,
+                       GetCodeGen().Const64(memory_budget_)});
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Here, we define the function merging the partial aggregates flushed into a
+// partition into the hash table of the partition:
+//
+// void mergePartition(OAHashTable *table, char *entries, uint64_t n) {
+//   for (entry : entries[0 .. n)) {
+//     if (table.contains(entry.key)) {
+//       merge entry.value into the table's aggregates
+//     } else {
+//       insert entry.key and entry.value into the table
+//     }
+//   }
+// }
+//===----------------------------------------------------------------------===//
+void HashGroupByTranslator::DefineAuxiliaryFunctions() {
+  auto &codegen = GetCodeGen();
+  aggregation_.DefineAuxiliaryFunctions(codegen);
+  if (!UsePartitioning()) {
+    return;
+  }
+
+  std::vector<FunctionDeclaration::ArgumentInfo> args = {
+      {"table", OAHashTableProxy::GetType(codegen)->getPointerTo()},
+      {"entries", codegen.CharPtrType()},
+      {"numEntries", codegen.Int64Type()}};
+  FunctionBuilder merge{codegen.GetCodeContext(), "mergePartition",
+                        codegen.VoidType(), args};
+  {
+    llvm::Value *table = merge.GetArgumentByPosition(0);
+    llvm::Value *entries = merge.GetArgumentByPosition(1);
+    llvm::Value *num_entries = merge.GetArgumentByPosition(2);
+
+    llvm::Value *entry_idx = codegen.Const64(0);
+    lang::Loop entry_loop{codegen,
+                          codegen->CreateICmpULT(entry_idx, num_entries),
+                          {{"entryIdx", entry_idx}}};
+    {
+      entry_idx = entry_loop.GetLoopVar(0);
+
+      // Load the key and the partial aggregates of the entry
+      llvm::Value *entry_offset = codegen->CreateMul(
+          entry_idx, codegen.Const64(hash_table_.HashEntrySize()));
+      llvm::Value *entry_ptr =
+          codegen->CreateInBoundsGEP(codegen.ByteType(), entries, entry_offset);
+      llvm::Value *hash = nullptr;
+      std::vector<codegen::Value> key;
+      llvm::Value *partial_aggs =
+          hash_table_.LoadEntry(codegen, entry_ptr, hash, key);
+
+      // Merge them into the table
+      MergeProbe probe{aggregation_, partial_aggs};
+      MergeInsert insert{aggregation_, partial_aggs};
+      hash_table_.ProbeOrInsert(codegen, table, hash, key, probe, insert);
+
+      entry_idx = codegen->CreateAdd(entry_idx, codegen.Const64(1));
+      entry_loop.LoopEnd(codegen->CreateICmpULT(entry_idx, num_entries),
+                         {entry_idx});
+    }
+
+    merge.ReturnAndFinish();
+  }
+  merge_func_ = merge.GetFunction();
 }
 
 // Produce!
@@ -114,8 +213,37 @@ void HashGroupByTranslator::Produce() const {
   Vector selection_vec{raw_vec, Vector::kDefaultVectorSize,
                        GetCodeGen().Int32Type()};
   ProduceResults producer{*this};
-  hash_table_.VectorizedIterate(GetCodeGen(), LoadStatePtr(hash_table_id_),
-                                selection_vec, producer);
+
+  if (!UsePartitioning()) {
+    hash_table_.VectorizedIterate(GetCodeGen(), LoadStatePtr(hash_table_id_),
+                                  selection_vec, producer);
+    return;
+  }
+
+  // The deduplicated values of deferred distinct aggregates are added to their
+  // groups like the input before them
+  if (aggregation_.DefersDistinct()) {
+    DistinctValueAdder adder{*this};
+    aggregation_.IterateDistinctValues(codegen, adder);
+  }
+
+  // Merge the partitions, if the pre-aggregation table ever filled up, and
+  // iterate over all the hash tables holding the result
+  llvm::Value *partitions = LoadStatePtr(partitions_id_);
+  codegen.Call(HashPartitionsProxy::Finish,
+               {partitions, LoadStatePtr(hash_table_id_)});
+
+  llvm::Value *table =
+      codegen.Call(HashPartitionsProxy::NextTable, {partitions});
+  lang::Loop table_loop{codegen, codegen->CreateIsNotNull(table),
+                        {{"table", table}}};
+  {
+    table = table_loop.GetLoopVar(0);
+    hash_table_.VectorizedIterate(codegen, table, selection_vec, producer);
+
+    table = codegen.Call(HashPartitionsProxy::NextTable, {partitions});
+    table_loop.LoopEnd(codegen->CreateIsNotNull(table), {table});
+  }
 }
 
 void HashGroupByTranslator::Consume(ConsumerContext &context,
@@ -238,12 +366,47 @@ void HashGroupByTranslator::Consume(ConsumerContext &,
   ConsumerProbe probe{context, aggregation_, vals, key};
   ConsumerInsert insert{aggregation_, vals, key};
   hash_table_.ProbeOrInsert(codegen, hash_table, hash, key, probe, insert);
+
+  // Flush the pre-aggregation table into the partitions once it is full
+  if (UsePartitioning()) {
+    FlushIfFull(hash_table);
+  }
+}
+
+void HashGroupByTranslator::AddDistinctValue(
+    uint32_t distinct_index, const std::vector<codegen::Value> &key,
+    const codegen::Value &value) const {
+  auto &codegen = GetCodeGen();
+  llvm::Value *hash_table = LoadStatePtr(hash_table_id_);
+  DistinctProbe probe{aggregation_, distinct_index, value};
+  DistinctInsert insert{aggregation_, distinct_index, value};
+  hash_table_.ProbeOrInsert(codegen, hash_table, nullptr, key, probe, insert);
+  FlushIfFull(hash_table);
+}
+
+void HashGroupByTranslator::FlushIfFull(llvm::Value *hash_table) const {
+  auto &codegen = GetCodeGen();
+  llvm::Value *num_entries = hash_table_.NumEntries(codegen, hash_table);
+  lang::If is_full{
+      codegen,
+      codegen->CreateICmpUGE(num_entries,
+                             codegen.Const64(max_pre_aggregation_entries_)),
+      "preAggregationFull"};
+  {
+    codegen.Call(HashPartitionsProxy::Flush,
+                 {LoadStatePtr(partitions_id_), hash_table});
+  }
+  is_full.EndIf();
 }
 
 // Cleanup by destroying the aggregation hash-table
 void HashGroupByTranslator::TearDownState() {
   hash_table_.Destroy(GetCodeGen(), LoadStatePtr(hash_table_id_));
   aggregation_.TearDownState(GetCodeGen());
+  if (UsePartitioning()) {
+    GetCodeGen().Call(HashPartitionsProxy::Destroy,
+                      {LoadStatePtr(partitions_id_)});
+  }
 }
 
 // Get the stringified name of this hash-based group-by
@@ -407,6 +570,95 @@ void HashGroupByTranslator::ConsumerProbe::ProcessEntry(
   aggregation_.AdvanceValues(codegen, data_area, next_vals_, grouping_keys_);
 }
 
+//===----------------------------------------------------------------------===//
+// MERGE PROBE
+//===----------------------------------------------------------------------===//
+
+HashGroupByTranslator::MergeProbe::MergeProbe(const Aggregation &aggregation,
+                                              llvm::Value *partial_aggs)
+    : aggregation_(aggregation), partial_aggs_(partial_aggs) {}
+
+// The key already has aggregates in the partition's table, merge the partial
+// aggregates into them
+void HashGroupByTranslator::MergeProbe::ProcessEntry(
+    CodeGen &codegen, llvm::Value *data_area) const {
+  aggregation_.MergeValues(codegen, data_area, partial_aggs_);
+}
+
+//===----------------------------------------------------------------------===//
+// MERGE INSERT
+//===----------------------------------------------------------------------===//
+
+HashGroupByTranslator::MergeInsert::MergeInsert(const Aggregation &aggregation,
+                                                llvm::Value *partial_aggs)
+    : aggregation_(aggregation), partial_aggs_(partial_aggs) {}
+
+// The partial aggregates become the aggregates of the key
+void HashGroupByTranslator::MergeInsert::StoreValue(CodeGen &codegen,
+                                                    llvm::Value *space) const {
+  codegen->CreateMemCpy(space, partial_aggs_,
+                        aggregation_.GetAggregatesStorageSize(), 1);
+}
+
+llvm::Value *HashGroupByTranslator::MergeInsert::GetValueSize(
+    CodeGen &codegen) const {
+  return codegen.Const32(aggregation_.GetAggregatesStorageSize());
+}
+
+//===----------------------------------------------------------------------===//
+// DISTINCT VALUE ADDER
+//===----------------------------------------------------------------------===//
+
+HashGroupByTranslator::DistinctValueAdder::DistinctValueAdder(
+    const HashGroupByTranslator &translator)
+    : translator_(translator) {}
+
+void HashGroupByTranslator::DistinctValueAdder::ProcessValue(
+    UNUSED_ATTRIBUTE CodeGen &codegen, uint32_t distinct_index,
+    const std::vector<codegen::Value> &grouping_keys,
+    const codegen::Value &value) const {
+  translator_.AddDistinctValue(distinct_index, grouping_keys, value);
+}
+
+//===----------------------------------------------------------------------===//
+// DISTINCT PROBE
+//===----------------------------------------------------------------------===//
+
+HashGroupByTranslator::DistinctProbe::DistinctProbe(
+    const Aggregation &aggregation, uint32_t distinct_index,
+    const codegen::Value &value)
+    : aggregation_(aggregation),
+      distinct_index_(distinct_index),
+      value_(value) {}
+
+void HashGroupByTranslator::DistinctProbe::ProcessEntry(
+    CodeGen &codegen, llvm::Value *data_area) const {
+  aggregation_.AdvanceDistinctValue(codegen, data_area, distinct_index_,
+                                    value_);
+}
+
+//===----------------------------------------------------------------------===//
+// DISTINCT INSERT
+//===----------------------------------------------------------------------===//
+
+HashGroupByTranslator::DistinctInsert::DistinctInsert(
+    const Aggregation &aggregation, uint32_t distinct_index,
+    const codegen::Value &value)
+    : aggregation_(aggregation),
+      distinct_index_(distinct_index),
+      value_(value) {}
+
+void HashGroupByTranslator::DistinctInsert::StoreValue(
+    CodeGen &codegen, llvm::Value *space) const {
+  aggregation_.CreateEmptyValues(codegen, space);
+  aggregation_.AdvanceDistinctValue(codegen, space, distinct_index_, value_);
+}
+
+llvm::Value *HashGroupByTranslator::DistinctInsert::GetValueSize(
+    CodeGen &codegen) const {
+  return codegen.Const32(aggregation_.GetAggregatesStorageSize());
+}
+
 //===----------------------------------------------------------------------===//
 // CONSUMER INSERT
 //===----------------------------------------------------------------------===//
@@ -13,17 +13,23 @@
 #include "codegen/operator/hash_join_translator.h"
 
 #include "codegen/expression/tuple_value_translator.h"
+#include "codegen/lang/if.h"
 #include "codegen/lang/vectorized_loop.h"
 #include "codegen/proxy/bloom_filter_proxy.h"
 #include "codegen/proxy/oa_hash_table_proxy.h"
+#include "codegen/type/sql_type.h"
 #include "expression/tuple_value_expression.h"
 #include "planner/hash_join_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
 
 namespace peloton {
 namespace codegen {
 
 std::atomic<bool> HashJoinTranslator::kUsePrefetch{false};
 
+constexpr uint32_t HashJoinTranslator::kMatchFlagSize;
+
 //===----------------------------------------------------------------------===//
 // HASH JOIN TRANSLATOR
 //===----------------------------------------------------------------------===//
@@ -32,7 +38,11 @@ std::atomic<bool> HashJoinTranslator::kUsePrefetch{false};
 HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
                                        CompilationContext &context,
                                        Pipeline &pipeline)
-    : OperatorTranslator(context, pipeline), join_(join), left_pipeline_(this) {
+    : OperatorTranslator(context, pipeline),
+      join_(join),
+      left_pipeline_(this),
+      bloom_filter_pushed_down_(false),
+      bloom_filter_tracks_range_(false) {
   LOG_DEBUG("Constructing HashJoinTranslator ...");
 
   auto &codegen = GetCodeGen();
@@ -52,6 +62,7 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
   if (GetJoinPlan().IsBloomFilterEnabled()) {
     bloom_filter_id_ = runtime_state.RegisterState(
         "bloomfilter", BloomFilterProxy::GetType(codegen));
+    PushDownBloomFilter(context);
   }
 
   // Prepare translators for the left and right input operators
@@ -125,8 +136,11 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
   needs_output_vector_ = false;
 
   // Create the hash table
-  hash_table_ =
-      OAHashTable{codegen, left_key_type, left_value_storage_.MaxStorageSize()};
+  uint64_t value_size = left_value_storage_.MaxStorageSize();
+  if (TracksLeftMatches()) {
+    value_size += kMatchFlagSize;
+  }
+  hash_table_ = OAHashTable{codegen, left_key_type, value_size};
   LOG_DEBUG("Finished constructing HashJoinTranslator ...");
 }
 
@@ -147,6 +161,14 @@ void HashJoinTranslator::Produce() const {
   // Let the right child produce tuples, which we use to probe the hash table
   GetCompilationContext().Produce(*join_.GetChild(1)->GetChild(0));
 
+  // The matches of the build tuples are known now, produce the ones the join
+  // type asks for
+  if (TracksLeftMatches()) {
+    ProduceLeft produce_left{*this};
+    hash_table_.Iterate(GetCodeGen(), LoadStatePtr(hash_table_id_),
+                        produce_left);
+  }
+
   // That's it, we've produced all the tuples
 }
 
@@ -271,52 +293,117 @@ void HashJoinTranslator::ConsumeFromLeft(ConsumerContext &,
   }
 
   // Insert tuples from the left side into the hash table
-  InsertLeft insert_left{left_value_storage_, vals};
+  InsertLeft insert_left{left_value_storage_, vals, TracksLeftMatches()};
   hash_table_.Insert(codegen, LoadStatePtr(hash_table_id_), hash, key,
                      insert_left);
 
   if (GetJoinPlan().IsBloomFilterEnabled()) {
     // Insert tuples into the bloom filter if enabled
     bloom_filter_.Add(codegen, LoadStatePtr(bloom_filter_id_), key);
+    if (bloom_filter_tracks_range_) {
+      bloom_filter_.AddToRange(codegen, LoadStatePtr(bloom_filter_id_),
+                               key[0]);
+    }
   }
 }
 
 // The given row is from the right child. Probe hash-table.
 void HashJoinTranslator::ConsumeFromRight(ConsumerContext &context,
                                           RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+
   // Pull out the values of the keys we probe the hash-table with
   std::vector<codegen::Value> key;
   CollectKeys(row, right_key_exprs_, key);
 
-  if (GetJoinPlan().IsBloomFilterEnabled()) {
-    // Prefilter the tuple using Bloom Filter
-    llvm::Value *contains = bloom_filter_.Contains(
-        GetCodeGen(), LoadStatePtr(bloom_filter_id_), key);
+  // Keep the row as it is before the values of the matches are added to it,
+  // to produce it if there is no match
+  RowBatch::Row unmatched_row = row;
+  llvm::Value *right_matched = nullptr;
+  if (ProducesUnmatchedRight()) {
+    right_matched = codegen.AllocateVariable(codegen.BoolType(), "rightMatch");
+    codegen->CreateStore(codegen.ConstBool(false), right_matched);
+  }
+
+  // A NULL key equals nothing, so rows with one don't probe. Build tuples
+  // with a NULL key are stored, but can thus never be matched.
+  llvm::Value *key_not_null = nullptr;
+  for (const auto &key_val : key) {
+    if (key_val.IsNullable()) {
+      llvm::Value *not_null = key_val.IsNotNull(codegen);
+      key_not_null = key_not_null == nullptr
+                         ? not_null
+                         : codegen->CreateAnd(key_not_null, not_null);
+    }
+  }
+
+  auto probe = [&]() {
+    // A bloom filter that was pushed down has been applied by the scan
+    // already
+    if (GetJoinPlan().IsBloomFilterEnabled() && !bloom_filter_pushed_down_) {
+      // Prefilter the tuple using Bloom Filter
+      llvm::Value *contains = bloom_filter_.Contains(
+          GetCodeGen(), LoadStatePtr(bloom_filter_id_), key);
+
+      lang::If is_valid_row{GetCodeGen(), contains};
+      {
+        // For each tuple that passes the bloom filter, probe the hash table
+        // to eliminate the false positives.
+        CodegenHashProbe(context, row, key, right_matched);
+      }
+      is_valid_row.EndIf();
+    } else {
+      // Bloom filter is not enabled. Directly probe the hash table
+      CodegenHashProbe(context, row, key, right_matched);
+    }
+  };
 
-    lang::If is_valid_row{GetCodeGen(), contains};
+  if (key_not_null != nullptr) {
+    lang::If has_key{codegen, key_not_null};
     {
-      // For each tuple that passes the bloom filter, probe the hash table
-      // to eliminate the false positives.
-      CodegenHashProbe(context, row, key);
+      probe();
     }
-    is_valid_row.EndIf();
+    has_key.EndIf();
   } else {
-    // Bloom filter is not enabled. Directly probe the hash table
-    CodegenHashProbe(context, row, key);
+    probe();
   }
-}
 
-void HashJoinTranslator::CodegenHashProbe(
-    ConsumerContext &context, RowBatch::Row &row,
-    std::vector<codegen::Value> &key) const {
-  if (GetJoinPlan().GetJoinType() == JoinType::INNER) {
-    // For inner joins, find all join partners
-    ProbeRight probe_right{*this, context, row, key};
-    hash_table_.FindAll(GetCodeGen(), LoadStatePtr(hash_table_id_), key,
-                        probe_right);
+  if (right_matched != nullptr) {
+    lang::If no_match{codegen,
+                      codegen->CreateNot(codegen->CreateLoad(right_matched))};
+    {
+      // Pad the row with NULL build-side attributes
+      for (const auto *left_val_ai : left_val_ais_) {
+        unmatched_row.RegisterAttributeValue(
+            left_val_ai, left_val_ai->type.GetSqlType().GetNullValue(codegen));
+      }
+      for (const auto *exp : left_key_exprs_) {
+        if (exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+          auto *ai = static_cast<const expression::TupleValueExpression *>(exp)
+                         ->GetAttributeRef();
+          unmatched_row.RegisterAttributeValue(
+              ai, ai->type.GetSqlType().GetNullValue(codegen));
+        }
+      }
+
+      // The matches were sent up already, start over from this operator
+      GetPipeline().MoveTo(this);
+      context.Consume(unmatched_row);
+    }
+    no_match.EndIf();
   }
 }
 
+void HashJoinTranslator::CodegenHashProbe(ConsumerContext &context,
+                                          RowBatch::Row &row,
+                                          std::vector<codegen::Value> &key,
+                                          llvm::Value *right_matched) const {
+  // Find all join partners
+  ProbeRight probe_right{*this, context, row, key, right_matched};
+  hash_table_.FindAll(GetCodeGen(), LoadStatePtr(hash_table_id_), key,
+                      probe_right);
+}
+
 // Cleanup by destroying the hash-table instance
 void HashJoinTranslator::TearDownState() {
   auto &codegen = GetCodeGen();
@@ -350,6 +437,10 @@ std::string HashJoinTranslator::GetName() const {
       name.append("Semi");
       break;
     }
+    case JoinType::ANTI: {
+      name.append("Anti");
+      break;
+    }
     case JoinType::INVALID:
       throw Exception{"Invalid join type"};
   }
@@ -376,6 +467,92 @@ bool HashJoinTranslator::UsePrefetching() const {
   return kUsePrefetch;
 }
 
+bool HashJoinTranslator::TracksLeftMatches() const {
+  switch (GetJoinPlan().GetJoinType()) {
+    case JoinType::LEFT:
+    case JoinType::OUTER:
+    case JoinType::SEMI:
+    case JoinType::ANTI:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool HashJoinTranslator::ProducesUnmatchedRight() const {
+  auto join_type = GetJoinPlan().GetJoinType();
+  return join_type == JoinType::RIGHT || join_type == JoinType::OUTER;
+}
+
+void HashJoinTranslator::PushDownBloomFilter(CompilationContext &context) {
+  // Dropping probe tuples early is only fine if they aren't produced anyway
+  if (ProducesUnmatchedRight()) {
+    return;
+  }
+
+  // Find the scan feeding the probe side. Joins in between (e.g., in a star
+  // join, the joins of the fact table with the other dimensions) only drop or
+  // extend the scanned tuples, so we look through their probe sides as well.
+  const planner::AbstractPlan *plan = join_.GetChild(1)->GetChild(0);
+  while (plan->GetPlanNodeType() == PlanNodeType::HASHJOIN) {
+    plan = plan->GetChild(1)->GetChild(0);
+  }
+  if (plan->GetPlanNodeType() != PlanNodeType::SEQSCAN) {
+    return;
+  }
+  const auto &scan = static_cast<const planner::SeqScanPlan &>(*plan);
+  std::vector<const planner::AttributeInfo *> scan_ais;
+  scan.GetAttributes(scan_ais);
+
+  // Every probe key must be a column produced by the scan
+  std::vector<const expression::AbstractExpression *> right_keys;
+  join_.GetRightHashKeys(right_keys);
+  CompilationContext::ScanFilter filter{{}, bloom_filter_id_, false};
+  for (const auto *right_key : right_keys) {
+    if (right_key->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+      return;
+    }
+    const auto *ai =
+        static_cast<const expression::TupleValueExpression *>(right_key)
+            ->GetAttributeRef();
+    if (std::find(scan_ais.begin(), scan_ais.end(), ai) == scan_ais.end()) {
+      return;
+    }
+    filter.key_ais.push_back(ai);
+  }
+
+  // A single integral key lets the scan skip tuples, and tile groups, whose
+  // key is outside the range of the build keys
+  if (filter.key_ais.size() == 1) {
+    switch (filter.key_ais[0]->type.type_id) {
+      case peloton::type::TypeId::TINYINT:
+      case peloton::type::TypeId::SMALLINT:
+      case peloton::type::TypeId::INTEGER:
+      case peloton::type::TypeId::BIGINT:
+        filter.has_key_range = true;
+        break;
+      default:
+        break;
+    }
+  }
+
+  LOG_DEBUG("Pushing bloom filter of join down into scan on [%u]",
+            scan.GetTable()->GetOid());
+  context.PushDownScanFilter(scan, filter);
+  bloom_filter_pushed_down_ = true;
+  bloom_filter_tracks_range_ = filter.has_key_range;
+}
+
+llvm::Value *HashJoinTranslator::GetLeftValuesPtr(
+    CodeGen &codegen, llvm::Value *data_area) const {
+  if (!TracksLeftMatches()) {
+    return data_area;
+  }
+  auto *flag_ptr = codegen->CreateBitCast(data_area, codegen.CharPtrType());
+  return codegen->CreateConstInBoundsGEP1_32(codegen.ByteType(), flag_ptr,
+                                             kMatchFlagSize);
+}
+
 void HashJoinTranslator::CollectKeys(
     RowBatch::Row &row,
     const std::vector<const expression::AbstractExpression *> &key,
@@ -399,11 +576,13 @@ void HashJoinTranslator::CollectValues(
 
 HashJoinTranslator::ProbeRight::ProbeRight(
     const HashJoinTranslator &join_translator, ConsumerContext &context,
-    RowBatch::Row &row, const std::vector<codegen::Value> &right_key)
+    RowBatch::Row &row, const std::vector<codegen::Value> &right_key,
+    llvm::Value *right_matched)
     : join_translator_(join_translator),
       context_(context),
       row_(row),
-      right_key_(right_key) {}
+      right_key_(right_key),
+      right_matched_(right_matched) {}
 
 // The callback invoked when iterating the hash table.  The key and value of
 // the current hash table entry are provided as parameters.  We add these to
@@ -419,7 +598,9 @@ void HashJoinTranslator::ProbeRight::ProcessEntry(
   } else {
     // LoadValues all the values from the hash entry
     std::vector<codegen::Value> left_vals;
-    storage.LoadValues(codegen, data_area, left_vals);
+    storage.LoadValues(codegen,
+                       join_translator_.GetLeftValuesPtr(codegen, data_area),
+                       left_vals);
 
     // Put the values directly into the row
     const auto &left_val_ais = join_translator_.left_val_ais_;
@@ -447,33 +628,111 @@ void HashJoinTranslator::ProbeRight::ProcessEntry(
     auto valid_row = row_.DeriveValue(codegen, *predicate);
     lang::If is_valid_row{codegen, valid_row};
     {
-      // Send row up to the parent
-      context_.Consume(row_);
+      ProcessMatch(codegen, data_area);
     }
     is_valid_row.EndIf();
   } else {
+    ProcessMatch(codegen, data_area);
+  }
+}
+
+void HashJoinTranslator::ProbeRight::ProcessMatch(
+    CodeGen &codegen, llvm::Value *data_area) const {
+  if (join_translator_.TracksLeftMatches()) {
+    auto *flag_ptr = codegen->CreateBitCast(data_area, codegen.CharPtrType());
+    codegen->CreateStore(codegen.Const8(1), flag_ptr);
+  }
+  if (right_matched_ != nullptr) {
+    codegen->CreateStore(codegen.ConstBool(true), right_matched_);
+  }
+
+  // Semi and anti joins only produce build tuples, once the probe side is
+  // exhausted
+  auto join_type = join_translator_.GetJoinPlan().GetJoinType();
+  if (join_type != JoinType::SEMI && join_type != JoinType::ANTI) {
     // Send the row up to the parent
     context_.Consume(row_);
   }
 }
 
+//===----------------------------------------------------------------------===//
+// PRODUCE LEFT
+//===----------------------------------------------------------------------===//
+
+HashJoinTranslator::ProduceLeft::ProduceLeft(
+    const HashJoinTranslator &join_translator)
+    : join_translator_(join_translator) {}
+
+void HashJoinTranslator::ProduceLeft::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &key,
+    llvm::Value *data_area) const {
+  const auto &plan = join_translator_.GetJoinPlan();
+  auto join_type = plan.GetJoinType();
+
+  auto *flag_ptr = codegen->CreateBitCast(data_area, codegen.CharPtrType());
+  auto *matched =
+      codegen->CreateICmpNE(codegen->CreateLoad(flag_ptr), codegen.Const8(0));
+  auto *produce =
+      join_type == JoinType::SEMI ? matched : codegen->CreateNot(matched);
+
+  lang::If produce_tuple{codegen, produce};
+  {
+    // The build-side attributes
+    std::vector<const planner::AttributeInfo *> ais =
+        join_translator_.left_val_ais_;
+    std::vector<codegen::Value> vals;
+    join_translator_.left_value_storage_.LoadValues(
+        codegen, join_translator_.GetLeftValuesPtr(codegen, data_area), vals);
+
+    const auto &left_key_exprs = join_translator_.left_key_exprs_;
+    for (uint32_t i = 0; i < left_key_exprs.size(); i++) {
+      const auto *exp = left_key_exprs[i];
+      if (exp->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+        auto *tve = static_cast<const expression::TupleValueExpression *>(exp);
+        ais.push_back(tve->GetAttributeRef());
+        vals.push_back(key[i]);
+      }
+    }
+
+    // Outer joins pad the tuple with NULL probe-side attributes
+    if (join_type == JoinType::LEFT || join_type == JoinType::OUTER) {
+      for (const auto *right_ai : plan.GetRightAttributes()) {
+        ais.push_back(right_ai);
+        vals.push_back(right_ai->type.GetSqlType().GetNullValue(codegen));
+      }
+    }
+
+    join_translator_.ProduceSingleRow(ais, vals);
+  }
+  produce_tuple.EndIf();
+}
+
 //===----------------------------------------------------------------------===//
 // INSERT LEFT
 //===----------------------------------------------------------------------===//
 
 HashJoinTranslator::InsertLeft::InsertLeft(
-    const CompactStorage &storage, const std::vector<codegen::Value> &values)
-    : storage_(storage), values_(values) {}
+    const CompactStorage &storage, const std::vector<codegen::Value> &values,
+    bool track_match)
+    : storage_(storage), values_(values), track_match_(track_match) {}
 
 // Store the attributes from the left-side input into the provided storage space
 void HashJoinTranslator::InsertLeft::StoreValue(CodeGen &codegen,
                                                 llvm::Value *space) const {
+  if (track_match_) {
+    // The tuple has not found a match yet
+    auto *flag_ptr = codegen->CreateBitCast(space, codegen.CharPtrType());
+    codegen->CreateStore(codegen.Const8(0), flag_ptr);
+    space = codegen->CreateConstInBoundsGEP1_32(codegen.ByteType(), flag_ptr,
+                                                kMatchFlagSize);
+  }
   storage_.StoreValues(codegen, space, values_);
 }
 
 llvm::Value *HashJoinTranslator::InsertLeft::GetValueSize(
     CodeGen &codegen) const {
-  return codegen.Const32(storage_.MaxStorageSize());
+  return codegen.Const32(storage_.MaxStorageSize() +
+                         (track_match_ ? kMatchFlagSize : 0));
 }
 
 }  // namespace codegen
@@ -0,0 +1,287 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_translator.cpp
+//
+// Identification: src/codegen/operator/merge_join_translator.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/merge_join_translator.h"
+
+#include "codegen/compilation_context.h"
+#include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
+#include "codegen/operator/projection_translator.h"
+#include "codegen/proxy/sorter_proxy.h"
+#include "codegen/type/integer_type.h"
+#include "planner/merge_join_plan.h"
+
+namespace peloton {
+namespace codegen {
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// The left input is buffered as it is produced. Every right row then skips
+/// the buffered rows with smaller keys, and joins with the run of rows with
+/// equal keys. As the right rows come in order too, the skipped rows are never
+/// visited again:
+///
+/// function main():
+///   for r in R:
+///     b.insert(r)
+///   cursor = 0
+///   for s in S:
+///     while cursor < |b| and b[cursor].key < s.key:
+///       cursor++
+///     for i = cursor; i < |b| and b[i].key == s.key; i++:
+///       if pred(b[i], s):
+///         emit(b[i], s)
+///
+/// Rows with a NULL key never match, and are neither buffered nor probed.
+///
+////////////////////////////////////////////////////////////////////////////////
+
+MergeJoinTranslator::MergeJoinTranslator(const planner::MergeJoinPlan &join,
+                                         CompilationContext &context,
+                                         Pipeline &pipeline)
+    : OperatorTranslator(context, pipeline),
+      join_(join),
+      left_pipeline_(this) {
+  PL_ASSERT(join.GetChildrenSize() == 2 &&
+            "Merge join must have exactly two children");
+
+  // Prepare children
+  context.Prepare(*join.GetChild(0), left_pipeline_);
+  context.Prepare(*join.GetChild(1), pipeline);
+
+  // Prepare the join keys
+  for (const auto &clause : *join.GetJoinClauses()) {
+    left_key_exprs_.push_back(clause.left_.get());
+    right_key_exprs_.push_back(clause.right_.get());
+    context.Prepare(*clause.left_);
+    context.Prepare(*clause.right_);
+  }
+
+  // Prepare join predicate (if one exists)
+  auto *predicate = join.GetPredicate();
+  if (predicate != nullptr) {
+    context.Prepare(*predicate);
+  }
+
+  // Prepare projection (if one exists)
+  auto *projection = join.GetProjInfo();
+  if (projection != nullptr) {
+    ProjectionTranslator::PrepareProjection(context, *projection);
+  }
+
+  // The keys come first in a buffered row
+  std::vector<type::Type> left_input_desc;
+  for (const auto *key_expr : left_key_exprs_) {
+    left_input_desc.push_back(key_expr->ResultType());
+  }
+  for (const auto *ai : join.GetLeftAttributes()) {
+    left_attributes_.push_back(ai);
+    left_input_desc.push_back(ai->type);
+  }
+
+  auto &codegen = GetCodeGen();
+  auto &runtime_state = context.GetRuntimeState();
+  buffer_id_ =
+      runtime_state.RegisterState("mjBuffer", SorterProxy::GetType(codegen));
+  buffer_ = Sorter{codegen, left_input_desc};
+  cursor_id_ = runtime_state.RegisterState("mjCursor", codegen.Int32Type());
+}
+
+void MergeJoinTranslator::InitializeState() {
+  auto &codegen = GetCodeGen();
+  auto *null_func = codegen.Null(
+      proxy::TypeBuilder<util::Sorter::ComparisonFunction>::GetType(codegen));
+  buffer_.Init(codegen, LoadStatePtr(buffer_id_), null_func);
+  codegen->CreateStore(codegen.Const32(0), LoadStatePtr(cursor_id_));
+}
+
+void MergeJoinTranslator::TearDownState() {
+  buffer_.Destroy(GetCodeGen(), LoadStatePtr(buffer_id_));
+}
+
+std::string MergeJoinTranslator::GetName() const {
+  return StringUtil::Format("MergeJoin[# keys: %zu]", left_key_exprs_.size());
+}
+
+void MergeJoinTranslator::Produce() const {
+  // Let the left child produce the tuples we buffer
+  GetCompilationContext().Produce(*GetPlan().GetChild(0));
+
+  // Let the right child produce the tuples we merge with the buffer
+  GetCompilationContext().Produce(*GetPlan().GetChild(1));
+}
+
+void MergeJoinTranslator::Consume(ConsumerContext &context,
+                                  RowBatch::Row &row) const {
+  if (IsFromLeftChild(context)) {
+    ConsumeFromLeft(context, row);
+  } else {
+    ConsumeFromRight(context, row);
+  }
+}
+
+namespace {
+
+// Generate the check whether any of the given values is NULL
+llvm::Value *AnyNull(CodeGen &codegen, const std::vector<codegen::Value> &vals) {
+  llvm::Value *any_null = codegen.ConstBool(false);
+  for (const auto &val : vals) {
+    if (val.IsNullable()) {
+      any_null = codegen->CreateOr(any_null, val.IsNull(codegen));
+    }
+  }
+  return any_null;
+}
+
+}  // anonymous namespace
+
+void MergeJoinTranslator::ConsumeFromLeft(
+    UNUSED_ATTRIBUTE ConsumerContext &context, RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+
+  std::vector<codegen::Value> tuple;
+  for (const auto *key_expr : left_key_exprs_) {
+    tuple.push_back(row.DeriveValue(codegen, *key_expr));
+  }
+  auto *any_null = AnyNull(codegen, tuple);
+  for (const auto *left_ai : left_attributes_) {
+    tuple.push_back(row.DeriveValue(codegen, left_ai));
+  }
+
+  lang::If has_key{codegen, codegen->CreateNot(any_null)};
+  {
+    buffer_.Append(codegen, LoadStatePtr(buffer_id_), tuple);
+  }
+  has_key.EndIf();
+}
+
+void MergeJoinTranslator::ConsumeFromRight(ConsumerContext &context,
+                                           RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+
+  std::vector<codegen::Value> right_key;
+  for (const auto *key_expr : right_key_exprs_) {
+    right_key.push_back(row.DeriveValue(codegen, *key_expr));
+  }
+
+  lang::If has_key{codegen, codegen->CreateNot(AnyNull(codegen, right_key))};
+  {
+    auto *buffer_ptr = LoadStatePtr(buffer_id_);
+    auto *cursor_ptr = LoadStatePtr(cursor_id_);
+    auto *num_rows = buffer_.GetNumberOfStoredTuples(codegen, buffer_ptr);
+    auto *cursor = LoadStateValue(cursor_id_);
+
+    // Skip the buffered rows with smaller keys
+    llvm::Value *start = nullptr;
+    {
+      lang::Loop advance{codegen, codegen->CreateICmpULT(cursor, num_rows),
+                         {{"mjCursor", cursor}}};
+      {
+        auto *row_idx = advance.GetLoopVar(0);
+        auto *cmp = CompareKeys(codegen, buffer_ptr, row_idx, right_key);
+        auto *is_less = codegen->CreateICmpSLT(cmp, codegen.Const32(0));
+        auto *next = codegen->CreateAdd(
+            row_idx, codegen->CreateZExt(is_less, codegen.Int32Type()));
+        advance.LoopEnd(
+            codegen->CreateAnd(is_less, codegen->CreateICmpULT(next, num_rows)),
+            {next});
+      }
+      std::vector<llvm::Value *> final_vals;
+      advance.CollectFinalLoopVariables(final_vals);
+      start = final_vals[0];
+    }
+    codegen->CreateStore(start, cursor_ptr);
+
+    // Join with the run of buffered rows with equal keys
+    lang::Loop match{codegen, codegen->CreateICmpULT(start, num_rows),
+                     {{"mjMatch", start}}};
+    {
+      auto *row_idx = match.GetLoopVar(0);
+      auto *is_equal = codegen->CreateICmpEQ(
+          CompareKeys(codegen, buffer_ptr, row_idx, right_key),
+          codegen.Const32(0));
+      lang::If found{codegen, is_equal};
+      {
+        // Add the left attributes into the right row
+        Sorter::SorterAccess access{
+            buffer_, buffer_.GetStartPosition(codegen, buffer_ptr)};
+        auto &left_row = access.GetRow(row_idx);
+        for (uint32_t i = 0; i < left_attributes_.size(); i++) {
+          row.RegisterAttributeValue(
+              left_attributes_[i],
+              left_row.LoadColumn(codegen, left_key_exprs_.size() + i));
+        }
+
+        auto *predicate = GetPlan().GetPredicate();
+        if (predicate == nullptr) {
+          ProjectAndConsume(context, row);
+        } else {
+          const auto &valid = row.DeriveValue(codegen, *predicate);
+          lang::If valid_match{codegen, valid};
+          {
+            ProjectAndConsume(context, row);
+          }
+          valid_match.EndIf();
+        }
+      }
+      found.EndIf();
+
+      auto *next = codegen->CreateAdd(row_idx, codegen.Const32(1));
+      match.LoopEnd(
+          codegen->CreateAnd(is_equal, codegen->CreateICmpULT(next, num_rows)),
+          {next});
+    }
+  }
+  has_key.EndIf();
+}
+
+void MergeJoinTranslator::ProjectAndConsume(ConsumerContext &context,
+                                            RowBatch::Row &row) const {
+  const auto *projection_info = GetPlan().GetProjInfo();
+  std::vector<RowBatch::ExpressionAccess> derived_attribute_access;
+  if (projection_info != nullptr) {
+    ProjectionTranslator::AddNonTrivialAttributes(
+        row.GetBatch(), *projection_info, derived_attribute_access);
+  }
+
+  // That's it, let the parent process the row
+  context.Consume(row);
+}
+
+llvm::Value *MergeJoinTranslator::CompareKeys(
+    CodeGen &codegen, llvm::Value *buffer_ptr, llvm::Value *row_idx,
+    const std::vector<codegen::Value> &right_key) const {
+  Sorter::SorterAccess access{buffer_,
+                              buffer_.GetStartPosition(codegen, buffer_ptr)};
+  auto &left_row = access.GetRow(row_idx);
+
+  // Lexicographic comparison, as the comparison function of an order by
+  codegen::Value zero{type::Integer::Instance(), codegen.Const32(0)};
+  codegen::Value result;
+  for (uint32_t idx = 0; idx < right_key.size(); idx++) {
+    auto left = left_row.LoadColumn(codegen, idx);
+    auto cmp = left.CompareForSort(codegen, right_key[idx]);
+    if (idx == 0) {
+      result = cmp;
+    } else {
+      auto prev_zero = result.CompareEq(codegen, zero);
+      result = codegen::Value{
+          type::Integer::Instance(),
+          codegen->CreateSelect(prev_zero.GetValue(), cmp.GetValue(),
+                                result.GetValue())};
+    }
+  }
+  return result.GetValue();
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,232 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// nested_loop_index_join_translator.cpp
+//
+// Identification:
+// src/codegen/operator/nested_loop_index_join_translator.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/nested_loop_index_join_translator.h"
+
+#include "codegen/compilation_context.h"
+#include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
+#include "codegen/operator/projection_translator.h"
+#include "codegen/proxy/index_probe_proxy.h"
+#include "codegen/proxy/runtime_functions_proxy.h"
+#include "codegen/proxy/storage_manager_proxy.h"
+#include "codegen/proxy/value_proxy.h"
+#include "codegen/type/sql_type.h"
+#include "index/index.h"
+#include "planner/nested_loop_index_join_plan.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace codegen {
+
+////////////////////////////////////////////////////////////////////////////////
+///
+/// The index nested loop join stays in the pipeline of its left child. For
+/// every left tuple, we write its join key into an array of values and probe
+/// the index of the inner table through a runtime IndexProbe instance, which
+/// also performs the visibility checks. We then load the matching inner
+/// tuples directly from their tile groups. The psuedocode is:
+///
+/// for r in R:
+///   n = probe.Probe(key(r))
+///   for i in [0, n):
+///     s = load(probe.GetTileGroup(i), probe.GetTupleOffset(i))
+///     if inner_pred(s) and pred(r, s):
+///       emit(r, s)
+///
+/// The join has a single child, the inner table is only accessed through the
+/// probe.
+///
+////////////////////////////////////////////////////////////////////////////////
+
+NestedLoopIndexJoinTranslator::NestedLoopIndexJoinTranslator(
+    const planner::NestedLoopIndexJoinPlan &plan, CompilationContext &context,
+    Pipeline &pipeline)
+    : OperatorTranslator(context, pipeline),
+      plan_(plan),
+      inner_tile_group_(*plan.GetInnerTable()->GetSchema()) {
+  PL_ASSERT(plan.GetChildrenSize() == 1 &&
+            "Index NLJ must have exactly one child");
+
+  // Prepare the child producing the outer tuples
+  context.Prepare(*plan.GetChild(0), pipeline);
+
+  // Prepare the predicate on the inner table (if one exists)
+  if (plan.GetInnerPredicate() != nullptr) {
+    context.Prepare(*plan.GetInnerPredicate());
+  }
+
+  // Prepare join predicate (if one exists)
+  auto *predicate = plan.GetPredicate();
+  if (predicate != nullptr) {
+    context.Prepare(*predicate);
+  }
+
+  // Prepare projection (if one exists)
+  auto *projection = plan.GetProjInfo();
+  if (projection != nullptr) {
+    ProjectionTranslator::PrepareProjection(context, *projection);
+  }
+
+  plan.GetInnerAttributes(inner_attributes_);
+
+  // Register the index probe
+  index_probe_id_ = context.GetRuntimeState().RegisterState(
+      "indexProbe", IndexProbeProxy::GetType(GetCodeGen()));
+}
+
+void NestedLoopIndexJoinTranslator::InitializeState() {
+  auto &codegen = GetCodeGen();
+  const auto &plan = GetPlan();
+
+  // Get the table pointer
+  storage::DataTable *table = plan.GetInnerTable();
+  llvm::Value *table_ptr =
+      codegen.Call(StorageManagerProxy::GetTableWithOid,
+                   {GetStorageManagerPtr(),
+                    codegen.Const32(table->GetDatabaseOid()),
+                    codegen.Const32(table->GetOid())});
+
+  llvm::Value *executor_ptr = GetCompilationContext().GetExecutorContextPtr();
+
+  // Call IndexProbe.Init(table, index_oid, executor_context, is_for_update)
+  codegen.Call(IndexProbeProxy::Init,
+               {LoadStatePtr(index_probe_id_), table_ptr,
+                codegen.Const32(plan.GetIndex()->GetOid()), executor_ptr,
+                codegen.ConstBool(plan.IsForUpdate())});
+}
+
+void NestedLoopIndexJoinTranslator::TearDownState() {
+  GetCodeGen().Call(IndexProbeProxy::TearDown, {LoadStatePtr(index_probe_id_)});
+}
+
+std::string NestedLoopIndexJoinTranslator::GetName() const {
+  return StringUtil::Format("NestedLoopIndexJoin[%s]",
+                            GetPlan().GetIndex()->GetName().c_str());
+}
+
+void NestedLoopIndexJoinTranslator::Produce() const {
+  // Let the left child produce the tuples we probe the index with
+  GetCompilationContext().Produce(*GetPlan().GetChild(0));
+}
+
+void NestedLoopIndexJoinTranslator::Consume(ConsumerContext &ctx,
+                                            RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+  const auto &join_ais_left = GetPlan().GetJoinAIsLeft();
+
+  // Write the join key into an array of values
+  auto *key_buffer = codegen.AllocateBuffer(
+      ValueProxy::GetType(codegen),
+      static_cast<uint32_t>(join_ais_left.size()), "probeKey");
+  key_buffer = codegen->CreatePointerCast(key_buffer, codegen.CharPtrType());
+  for (uint32_t i = 0; i < join_ais_left.size(); i++) {
+    Value val = row.DeriveValue(codegen, join_ais_left[i]);
+    const auto &sql_type = val.GetType().GetSqlType();
+
+    // Produce the NULL value of the type if the value is NULL
+    Value null_val;
+    lang::If val_is_null{codegen, val.IsNull(codegen)};
+    { null_val = sql_type.GetNullValue(codegen); }
+    val_is_null.EndIf();
+    val = val_is_null.BuildPHI(null_val, val);
+
+    auto *output_func = sql_type.GetOutputFunction(codegen, val.GetType());
+    std::vector<llvm::Value *> args = {key_buffer, codegen.Const32(i),
+                                       val.GetValue()};
+    if (val.GetLength() != nullptr) {
+      args.push_back(val.GetLength());
+    }
+    if (sql_type.TypeId() == peloton::type::TypeId::BOOLEAN) {
+      args.push_back(val.IsNull(codegen));
+    }
+    codegen.CallFunc(output_func, args);
+  }
+
+  // Probe the index
+  auto *index_probe = LoadStatePtr(index_probe_id_);
+  auto *num_matches =
+      codegen.Call(IndexProbeProxy::Probe, {index_probe, key_buffer});
+
+  // Space for the column layouts of the tile group of a match
+  auto *column_layouts = codegen.AllocateBuffer(
+      ColumnLayoutInfoProxy::GetType(codegen),
+      static_cast<uint32_t>(inner_attributes_.size()), "innerColumnLayout");
+
+  // Join the left tuple with every match
+  auto *start_cond = codegen->CreateICmpULT(codegen.Const32(0), num_matches);
+  lang::Loop match_loop{codegen, start_cond, {{"matchIdx", codegen.Const32(0)}}};
+  {
+    auto *match_idx = match_loop.GetLoopVar(0);
+    auto *tile_group_ptr =
+        codegen.Call(IndexProbeProxy::GetTileGroup, {index_probe, match_idx});
+    auto *tid =
+        codegen.Call(IndexProbeProxy::GetTupleOffset, {index_probe, match_idx});
+
+    // Load the inner tuple, unused columns are optimized away
+    std::vector<oid_t> column_ids;
+    for (const auto *ai : inner_attributes_) {
+      column_ids.push_back(ai->attribute_id);
+    }
+    auto vals = inner_tile_group_.LoadColumns(codegen, tile_group_ptr,
+                                              column_layouts, tid, column_ids);
+    for (uint32_t i = 0; i < inner_attributes_.size(); i++) {
+      row.RegisterAttributeValue(inner_attributes_[i], vals[i]);
+    }
+
+    const auto *inner_predicate = GetPlan().GetInnerPredicate();
+    if (inner_predicate == nullptr) {
+      ConsumeMatch(ctx, row);
+    } else {
+      const auto &valid = row.DeriveValue(codegen, *inner_predicate);
+      lang::If valid_match{codegen, valid};
+      { ConsumeMatch(ctx, row); }
+      valid_match.EndIf();
+    }
+
+    auto *next_idx = codegen->CreateAdd(match_idx, codegen.Const32(1));
+    match_loop.LoopEnd(codegen->CreateICmpULT(next_idx, num_matches),
+                       {next_idx});
+  }
+}
+
+void NestedLoopIndexJoinTranslator::ConsumeMatch(ConsumerContext &ctx,
+                                                 RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+
+  // Check the join predicate, if one exists
+  auto *predicate = GetPlan().GetPredicate();
+  std::unique_ptr<lang::If> valid_match;
+  if (predicate != nullptr) {
+    const auto &valid = row.DeriveValue(codegen, *predicate);
+    valid_match.reset(new lang::If(codegen, valid));
+  }
+
+  // Apply the projection
+  const auto *projection_info = GetPlan().GetProjInfo();
+  std::vector<RowBatch::ExpressionAccess> derived_attribute_access;
+  if (projection_info != nullptr) {
+    ProjectionTranslator::AddNonTrivialAttributes(
+        row.GetBatch(), *projection_info, derived_attribute_access);
+  }
+
+  // That's it, let the parent process the row
+  ctx.Consume(row);
+
+  if (valid_match != nullptr) {
+    valid_match->EndIf();
+  }
+}
+
+}  // namespace codegen
+}  // namespace peloton
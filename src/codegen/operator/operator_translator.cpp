@@ -13,6 +13,9 @@
 #include "codegen/operator/operator_translator.h"
 
 #include "codegen/compilation_context.h"
+#include "codegen/consumer_context.h"
+#include "codegen/operator/projection_translator.h"
+#include "codegen/vector.h"
 
 namespace peloton {
 namespace codegen {
@@ -50,5 +53,53 @@ void OperatorTranslator::Consume(ConsumerContext &context,
   });
 }
 
+namespace {
+
+// Provides the value of an attribute of a row that was materialized before
+class MaterializedAttributeAccess : public RowBatch::AttributeAccess {
+ public:
+  explicit MaterializedAttributeAccess(const codegen::Value &val) : val_(val) {}
+
+  codegen::Value Access(CodeGen &, RowBatch::Row &) override { return val_; }
+
+ private:
+  codegen::Value val_;
+};
+
+}  // anonymous namespace
+
+void OperatorTranslator::ProduceSingleRow(
+    const std::vector<const planner::AttributeInfo *> &ais,
+    const std::vector<codegen::Value> &vals,
+    const planner::ProjectInfo *projection) const {
+  PL_ASSERT(ais.size() == vals.size());
+  auto &codegen = GetCodeGen();
+
+  // Create a row-batch of one row
+  auto *raw_vec = codegen.AllocateBuffer(codegen.Int32Type(), 1, "singleRow");
+  Vector selection_vector{raw_vec, 1, codegen.Int32Type()};
+  selection_vector.SetValue(codegen, codegen.Const32(0), codegen.Const32(0));
+  RowBatch batch{GetCompilationContext(), codegen.Const32(0),
+                 codegen.Const32(1), selection_vector, false};
+
+  std::vector<MaterializedAttributeAccess> accessors;
+  accessors.reserve(vals.size());
+  for (uint32_t i = 0; i < ais.size(); i++) {
+    accessors.emplace_back(vals[i]);
+    batch.AddAttribute(ais[i], &accessors[i]);
+  }
+
+  std::vector<RowBatch::ExpressionAccess> derived_attribute_access;
+  if (projection != nullptr) {
+    ProjectionTranslator::AddNonTrivialAttributes(batch, *projection,
+                                                  derived_attribute_access);
+  }
+
+  // The rows of the input were sent up already, start over from this operator
+  GetPipeline().MoveTo(this);
+  ConsumerContext context{GetCompilationContext(), GetPipeline()};
+  context.Consume(batch);
+}
+
 }  // namespace codegen
 }  // namespace peloton
@@ -12,14 +12,19 @@
 
 #include "codegen/operator/table_scan_translator.h"
 
+#include "codegen/bloom_filter_accessor.h"
+#include "codegen/expression/dictionary_comparison_translator.h"
 #include "codegen/lang/if.h"
+#include "codegen/proxy/conjunct_order_proxy.h"
 #include "codegen/proxy/executor_context_proxy.h"
 #include "codegen/proxy/storage_manager_proxy.h"
 #include "codegen/proxy/transaction_runtime_proxy.h"
 #include "codegen/proxy/runtime_functions_proxy.h"
 #include "codegen/proxy/zone_map_proxy.h"
 #include "codegen/type/boolean_type.h"
+#include "expression/comparison_expression.h"
 #include "planner/seq_scan_plan.h"
+#include "settings/settings_manager.h"
 #include "storage/data_table.h"
 #include "storage/zone_map_manager.h"
 
@@ -36,7 +41,14 @@ TableScanTranslator::TableScanTranslator(const planner::SeqScanPlan &scan,
                                          Pipeline &pipeline)
     : OperatorTranslator(context, pipeline),
       scan_(scan),
-      table_(*scan_.GetTable()) {
+      table_(*scan_.GetTable()),
+      join_filters_(context.GetScanFilters(scan)),
+      vectorized_filter_(settings::SettingsManager::GetBool(
+                             settings::SettingId::codegen_simd_predicates)
+                             ? scan.GetPredicate()
+                             : nullptr),
+      conjunct_order_id_(0),
+      predicate_id_(0) {
   LOG_DEBUG("Constructing TableScanTranslator ...");
 
   // The restriction, if one exists
@@ -44,15 +56,74 @@ TableScanTranslator::TableScanTranslator(const planner::SeqScanPlan &scan,
   if (predicate != nullptr) {
     // If there is a predicate, prepare a translator for it
     context.Prepare(*predicate);
+    predicate_id_ = context.GetRuntimeState().RegisterPointer(
+        "scanPredicate",
+        AbstractExpressionProxy::GetType(GetCodeGen())->getPointerTo(),
+        predicate);
+    PrepareDictionaryComparisons(*predicate, context);
 
     // If the scan's predicate is SIMDable, install a boundary at the output
     if (predicate->IsSIMDable()) {
       pipeline.InstallBoundaryAtOutput(this);
     }
   }
+
+  // The SIMD kernels adapt the order they're evaluated in as the scan goes on
+  if (vectorized_filter_.HasKernels()) {
+    LOG_DEBUG("Evaluating %u conjuncts of scan on [%u] using SIMD kernels",
+              vectorized_filter_.NumKernels(), GetTable().GetOid());
+    conjunct_order_id_ = context.GetRuntimeState().RegisterState(
+        "scanConjunctOrder", ConjunctOrderProxy::GetType(GetCodeGen()));
+  }
   LOG_DEBUG("Finished constructing TableScanTranslator ...");
 }
 
+void TableScanTranslator::InitializeState() {
+  if (vectorized_filter_.HasKernels()) {
+    auto &codegen = GetCodeGen();
+    codegen.Call(ConjunctOrderProxy::Init,
+                 {LoadStatePtr(conjunct_order_id_),
+                  codegen.Const32(vectorized_filter_.NumKernels())});
+  }
+}
+
+void TableScanTranslator::PrepareDictionaryComparisons(
+    const expression::AbstractExpression &expression,
+    CompilationContext &context) const {
+  // Only look through conjunctions, other expressions keep their translators
+  switch (expression.GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND:
+    case ExpressionType::CONJUNCTION_OR:
+    case ExpressionType::OPERATOR_NOT: {
+      for (uint32_t i = 0; i < expression.GetChildrenSize(); i++) {
+        PrepareDictionaryComparisons(*expression.GetChild(i), context);
+      }
+      break;
+    }
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_IN: {
+      const auto &comparison =
+          static_cast<const expression::ComparisonExpression &>(expression);
+      uint32_t column_child;
+      std::vector<uint32_t> codes;
+      if (DictionaryComparisonTranslator::CanTranslate(
+              comparison, GetTable(), column_child, codes)) {
+        LOG_DEBUG("Comparing dictionary codes in predicate of scan on [%u]",
+                  GetTable().GetOid());
+        context.Prepare(comparison,
+                        std::unique_ptr<ExpressionTranslator>{
+                            new DictionaryComparisonTranslator(
+                                comparison, context, column_child,
+                                std::move(codes))});
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
 // Produce!
 void TableScanTranslator::Produce() const {
   auto &codegen = GetCodeGen();
@@ -75,9 +146,11 @@ void TableScanTranslator::Produce() const {
 
   auto predicate = const_cast<expression::AbstractExpression *>(
       GetScanPlan().GetPredicate());
-  llvm::Value *predicate_ptr = codegen->CreateIntToPtr(
-      codegen.Const64((int64_t)predicate),
-      AbstractExpressionProxy::GetType(codegen)->getPointerTo());
+  llvm::Value *predicate_ptr =
+      predicate != nullptr
+          ? LoadStateValue(predicate_id_)
+          : codegen.NullPtr(
+                AbstractExpressionProxy::GetType(codegen)->getPointerTo());
   size_t num_preds = 0;
 
   auto *zone_map_manager = storage::ZoneMapManager::GetInstance();
@@ -126,22 +199,37 @@ void TableScanTranslator::ScanConsumer::ProcessTuples(
   // 1. Filter the rows in the range [tid_start, tid_end) by txn visibility
   FilterRowsByVisibility(codegen, tid_start, tid_end, selection_vector_);
 
-  // 2. Filter rows by the given predicate (if one exists)
+  // 2. Filter rows by the given predicate (if one exists). The comparisons
+  //    on fixed-length columns run as SIMD kernels, the rest row-at-a-time.
   auto *predicate = GetPredicate();
-  if (predicate != nullptr) {
-    // First perform a vectorized filter, putting TIDs into the selection vector
+  const auto &vectorized_filter = translator_.vectorized_filter_;
+  if (predicate != nullptr && vectorized_filter.HasKernels()) {
+    FilterRowsByKernels(codegen, tile_group_access, tid_start, tid_end,
+                        selection_vector_);
+    if (!vectorized_filter.GetResidual().empty()) {
+      FilterRowsByPredicate(codegen, tile_group_access, tid_start, tid_end,
+                            vectorized_filter.GetResidual(),
+                            selection_vector_);
+    }
+  } else if (predicate != nullptr) {
     FilterRowsByPredicate(codegen, tile_group_access, tid_start, tid_end,
-                          selection_vector_);
+                          {predicate}, selection_vector_);
+  }
+
+  // 3. Filter rows by the bloom filters of the joins above (if there are any)
+  if (!translator_.join_filters_.empty()) {
+    FilterRowsByJoinFilters(codegen, tile_group_access, tid_start, tid_end,
+                            selection_vector_);
   }
 
-  // 3. Setup the (filtered) row batch and setup attribute accessors
+  // 4. Setup the (filtered) row batch and setup attribute accessors
   RowBatch batch{translator_.GetCompilationContext(), tile_group_id_, tid_start,
                  tid_end, selection_vector_, true};
 
   std::vector<TableScanTranslator::AttributeAccess> attribute_accesses;
   SetupRowBatch(batch, tile_group_access, attribute_accesses);
 
-  // 4. Push the batch into the pipeline
+  // 5. Push the batch into the pipeline
   ConsumerContext context{translator_.GetCompilationContext(),
                           translator_.GetPipeline()};
   context.Consume(batch);
@@ -195,21 +283,39 @@ TableScanTranslator::ScanConsumer::GetPredicate() const {
   return translator_.GetScanPlan().GetPredicate();
 }
 
+void TableScanTranslator::ScanConsumer::FilterRowsByKernels(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    Vector &selection_vector) const {
+  // The kernels only need a row to derive the (row-independent) values their
+  // columns are compared with
+  auto &compilation_ctx = translator_.GetCompilationContext();
+  RowBatch batch{compilation_ctx, tile_group_id_,   tid_start,
+                 tid_end,         selection_vector, true};
+  RowBatch::Row row = batch.GetRowAt(codegen.Const32(0));
+
+  llvm::Value *conjunct_order_ptr =
+      translator_.LoadStatePtr(translator_.conjunct_order_id_);
+  translator_.vectorized_filter_.Filter(codegen, access, row,
+                                        conjunct_order_ptr, tid_start, tid_end,
+                                        selection_vector);
+}
+
 void TableScanTranslator::ScanConsumer::FilterRowsByPredicate(
     CodeGen &codegen, const TileGroup::TileGroupAccess &access,
     llvm::Value *tid_start, llvm::Value *tid_end,
+    const std::vector<const expression::AbstractExpression *> &conjuncts,
     Vector &selection_vector) const {
   // The batch we're filtering
   auto &compilation_ctx = translator_.GetCompilationContext();
   RowBatch batch{compilation_ctx, tile_group_id_,   tid_start,
                  tid_end,         selection_vector, true};
 
-  // First, check if the predicate is SIMDable
-  const auto *predicate = GetPredicate();
-  LOG_DEBUG("Is Predicate SIMDable : %d", predicate->IsSIMDable());
-  // Determine the attributes the predicate needs
+  // Determine the attributes the conjuncts need
   std::unordered_set<const planner::AttributeInfo *> used_attributes;
-  predicate->GetUsedAttributes(used_attributes);
+  for (const auto *conjunct : conjuncts) {
+    conjunct->GetUsedAttributes(used_attributes);
+  }
 
   // Setup the row batch with attribute accessors for the predicate
   std::vector<AttributeAccess> attribute_accessors;
@@ -223,18 +329,116 @@ void TableScanTranslator::ScanConsumer::FilterRowsByPredicate(
 
   // Iterate over the batch using a scalar loop
   batch.Iterate(codegen, [&](RowBatch::Row &row) {
-    // Evaluate the predicate to determine row validity
-    codegen::Value valid_row = row.DeriveValue(codegen, *predicate);
-
-    // Reify the boolean value since it may be NULL
-    PL_ASSERT(valid_row.GetType().GetSqlType() == type::Boolean::Instance());
-    llvm::Value *bool_val = type::Boolean::Instance().Reify(codegen, valid_row);
+    // Evaluate the conjuncts to determine row validity
+    llvm::Value *valid = codegen.ConstBool(true);
+    for (const auto *conjunct : conjuncts) {
+      codegen::Value valid_row = row.DeriveValue(codegen, *conjunct);
+
+      // Reify the boolean value since it may be NULL
+      PL_ASSERT(valid_row.GetType().GetSqlType() == type::Boolean::Instance());
+      valid = codegen->CreateAnd(
+          valid, type::Boolean::Instance().Reify(codegen, valid_row));
+    }
 
     // Set the validity of the row
-    row.SetValidity(codegen, bool_val);
+    row.SetValidity(codegen, valid);
+  });
+}
+
+void TableScanTranslator::ScanConsumer::FilterRowsByJoinFilters(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    Vector &selection_vector) const {
+  // The batch we're filtering
+  auto &compilation_ctx = translator_.GetCompilationContext();
+  RowBatch batch{compilation_ctx, tile_group_id_,   tid_start,
+                 tid_end,         selection_vector, true};
+
+  // Setup the row batch with attribute accessors for the keys of the filters
+  std::vector<const planner::AttributeInfo *> key_ais;
+  for (const auto &filter : translator_.join_filters_) {
+    for (const auto *ai : filter.key_ais) {
+      if (std::find(key_ais.begin(), key_ais.end(), ai) == key_ais.end()) {
+        key_ais.push_back(ai);
+      }
+    }
+  }
+  std::vector<AttributeAccess> attribute_accessors;
+  for (const auto *ai : key_ais) {
+    attribute_accessors.emplace_back(access, ai);
+  }
+  for (auto &accessor : attribute_accessors) {
+    batch.AddAttribute(accessor.GetAttributeRef(), &accessor);
+  }
+
+  // Ask each filter whether it is worth probing for this batch. The filters
+  // that barely filter anything are skipped for a while.
+  BloomFilterAccessor bloom_filter;
+  std::vector<llvm::Value *> should_probe;
+  for (const auto &filter : translator_.join_filters_) {
+    should_probe.push_back(bloom_filter.ShouldProbe(
+        codegen, translator_.LoadStatePtr(filter.bloom_filter_id),
+        selection_vector.GetNumElements()));
+  }
+
+  batch.Iterate(codegen, [&](RowBatch::Row &row) {
+    llvm::Value *valid = codegen.ConstBool(true);
+    for (uint32_t i = 0; i < translator_.join_filters_.size(); i++) {
+      const auto &filter = translator_.join_filters_[i];
+      llvm::Value *bloom_filter_ptr =
+          translator_.LoadStatePtr(filter.bloom_filter_id);
+
+      std::vector<codegen::Value> key;
+      for (const auto *ai : filter.key_ais) {
+        key.push_back(row.DeriveValue(codegen, ai));
+      }
+
+      // Checking the range of the keys is cheap, do it for every row
+      if (filter.has_key_range) {
+        valid = codegen->CreateAnd(
+            valid, bloom_filter.InRange(codegen, bloom_filter_ptr, key[0]));
+      }
+
+      // Only probe the bloom filter with the rows that are still valid
+      llvm::Value *probe = codegen->CreateAnd(valid, should_probe[i]);
+      lang::If probe_filter{codegen, probe, "probeJoinFilter"};
+      llvm::Value *contains =
+          bloom_filter.Contains(codegen, bloom_filter_ptr, key);
+      probe_filter.EndIf();
+      valid = probe_filter.BuildPHI(contains, valid);
+    }
+    row.SetValidity(codegen, valid);
   });
 }
 
+llvm::Value *TableScanTranslator::ScanConsumer::ShouldScanTileGroup(
+    CodeGen &codegen, llvm::Value *table_ptr, llvm::Value *tile_group_idx) {
+  llvm::Value *should_scan = codegen.ConstBool(true);
+  auto *zone_map_manager = storage::ZoneMapManager::GetInstance();
+  if (!zone_map_manager->ZoneMapTableExists()) {
+    return should_scan;
+  }
+
+  // Skip the tile groups whose zone map says none of their keys can be in the
+  // range of the build keys of a join
+  BloomFilterAccessor bloom_filter;
+  for (const auto &filter : translator_.join_filters_) {
+    if (!filter.has_key_range) {
+      continue;
+    }
+    llvm::Value *bloom_filter_ptr =
+        translator_.LoadStatePtr(filter.bloom_filter_id);
+    llvm::Value *in_range = codegen.Call(
+        ZoneMapManagerProxy::ShouldScanTileGroupInRange,
+        {translator_.table_.GetZoneMapManager(codegen), table_ptr,
+         tile_group_idx, codegen.Const32(filter.key_ais[0]->attribute_id),
+         bloom_filter.GetMinKey(codegen, bloom_filter_ptr),
+         bloom_filter.GetMaxKey(codegen, bloom_filter_ptr)});
+    should_scan = codegen->CreateAnd(should_scan, in_range);
+  }
+  return should_scan;
+}
+
 //===----------------------------------------------------------------------===//
 // ATTRIBUTE ACCESS
 //===----------------------------------------------------------------------===//
@@ -39,6 +39,9 @@ UpdateTranslator::UpdateTranslator(const planner::UpdatePlan &update_plan,
   // Prepare for updater
   updater_state_id_ = context.GetRuntimeState().RegisterState("updater",
       UpdaterProxy::GetType(GetCodeGen()));
+  target_list_state_id_ = context.GetRuntimeState().RegisterPointer(
+      "updateTargets", TargetProxy::GetType(GetCodeGen())->getPointerTo(),
+      project_info->GetTargetList().data());
 }
 
 bool IsTarget(const TargetList &target_list, uint32_t index) {
@@ -65,9 +68,7 @@ void UpdateTranslator::InitializeState() {
   // Get the target list's raw vectors and their sizes
   // : this is required when installing a new version at updater
   const auto *project_info = update_plan_.GetProjectInfo();
-  llvm::Value *target_vector_ptr = codegen->CreateIntToPtr(
-      codegen.Const64((int64_t)project_info->GetTargetList().data()),
-      TargetProxy::GetType(codegen)->getPointerTo());
+  llvm::Value *target_vector_ptr = LoadStateValue(target_list_state_id_);
   llvm::Value *target_vector_size_ptr =
       codegen.Const32((int32_t)project_info->GetTargetList().size());
 
@@ -0,0 +1,333 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// persistent_code_cache.cpp
+//
+// Identification: src/codegen/persistent_code_cache.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/persistent_code_cache.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+
+#include <boost/filesystem.hpp>
+
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Host.h"
+
+#include "common/logger.h"
+#include "expression/parameter.h"
+#include "planner/abstract_scan_plan.h"
+#include "planner/delete_plan.h"
+#include "planner/insert_plan.h"
+#include "planner/nested_loop_index_join_plan.h"
+#include "planner/update_plan.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "util/hash_util.h"
+
+#define PELOTON_STRINGIFY_(x) #x
+#define PELOTON_STRINGIFY(x) PELOTON_STRINGIFY_(x)
+
+namespace peloton {
+namespace codegen {
+
+namespace {
+
+// "PLTNCODE"
+constexpr uint64_t kMagic = 0x45444f434e544c50ull;
+
+// The extension of the files of the entries
+const char *kExtension = ".code";
+
+// Closes the file when going out of scope
+struct FileCloser {
+  void operator()(std::FILE *file) const { std::fclose(file); }
+};
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+}  // namespace
+
+PersistentCodeCache::PersistentCodeCache() : num_hits_(0) {
+  SetDirectory(settings::SettingsManager::GetString(
+      settings::SettingId::codegen_cache_directory));
+}
+
+bool PersistentCodeCache::IsEnabled() const {
+  latch_.ReadLock();
+  bool enabled = !directory_.empty();
+  latch_.Unlock();
+  return enabled;
+}
+
+void PersistentCodeCache::SetDirectory(const std::string &directory) {
+  latch_.WriteLock();
+  directory_ = directory;
+  entries_.clear();
+  if (directory_.empty()) {
+    latch_.Unlock();
+    return;
+  }
+
+  boost::system::error_code error;
+  boost::filesystem::create_directories(directory_, error);
+  if (error) {
+    LOG_WARN("Unable to create code cache directory '%s': %s",
+             directory_.c_str(), error.message().c_str());
+    directory_.clear();
+    latch_.Unlock();
+    return;
+  }
+
+  // Index the entries of this build, remove all other files we left behind
+  for (boost::filesystem::directory_iterator iter{directory_, error}, end;
+       !error && iter != end; iter.increment(error)) {
+    const auto &path = iter->path();
+    if (path.extension() != kExtension) {
+      continue;
+    }
+    Header header;
+    std::vector<oid_t> table_oids;
+    if (ReadHeader(path.string(), header, table_oids) &&
+        path.filename().string() ==
+            boost::filesystem::path{GetPath(header.fingerprint)}
+                .filename()
+                .string()) {
+      entries_[header.fingerprint] = Entry{std::move(table_oids)};
+    } else {
+      boost::filesystem::remove(path, error);
+    }
+  }
+  LOG_INFO("Found %zu entries in code cache directory '%s'", entries_.size(),
+           directory_.c_str());
+  latch_.Unlock();
+}
+
+hash_t PersistentCodeCache::Fingerprint(
+    const planner::AbstractPlan &plan,
+    const std::vector<expression::Parameter> &params,
+    CodeContext::OptimizationTier tier) {
+  // The compiled code depends on the type and nullability of the parameters,
+  // but not their values. Each tier has an entry of its own.
+  hash_t hash = plan.Hash();
+  auto tier_id = static_cast<uint32_t>(tier);
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&tier_id));
+  for (const auto &param : params) {
+    auto type_id = param.GetValueType();
+    bool nullable = param.IsNullable();
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&type_id));
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&nullable));
+  }
+  uint64_t build_id = GetBuildId();
+  return HashUtil::CombineHashes(hash, HashUtil::Hash(&build_id));
+}
+
+bool PersistentCodeCache::Find(hash_t fingerprint, hash_t ir_hash,
+                               hash_t layout_hash, std::string &object) {
+  latch_.ReadLock();
+  if (directory_.empty() || entries_.count(fingerprint) == 0) {
+    latch_.Unlock();
+    return false;
+  }
+  std::string path = GetPath(fingerprint);
+  latch_.Unlock();
+
+  FilePtr file{std::fopen(path.c_str(), "rb")};
+  if (file == nullptr) {
+    return false;
+  }
+  Header header;
+  if (std::fread(&header, sizeof(Header), 1, file.get()) != 1 ||
+      header.magic != kMagic || header.build_id != GetBuildId() ||
+      header.fingerprint != fingerprint) {
+    return false;
+  }
+
+  // The plan may have been compiled into different code since, e.g., because
+  // the code depends on the contents of the tables. Stick with the new code.
+  if (header.ir_hash != ir_hash || header.layout_hash != layout_hash) {
+    LOG_DEBUG("Code cache entry %016" PRIx64 " was compiled from other code",
+              static_cast<uint64_t>(fingerprint));
+    return false;
+  }
+
+  object.resize(header.object_size);
+  if (std::fseek(file.get(), header.num_tables * sizeof(oid_t), SEEK_CUR) !=
+          0 ||
+      std::fread(&object[0], 1, object.size(), file.get()) != object.size()) {
+    LOG_WARN("Unable to read code cache entry '%s'", path.c_str());
+    object.clear();
+    return false;
+  }
+  num_hits_++;
+  return true;
+}
+
+void PersistentCodeCache::Add(hash_t fingerprint,
+                              const planner::AbstractPlan &plan,
+                              hash_t ir_hash, hash_t layout_hash,
+                              const std::string &object) {
+  if (object.empty()) {
+    return;
+  }
+
+  std::vector<oid_t> table_oids;
+  CollectTableOids(plan, table_oids);
+
+  latch_.WriteLock();
+  if (directory_.empty()) {
+    latch_.Unlock();
+    return;
+  }
+
+  // Write the entry into a temporary file first, then move it in place so that
+  // nobody ever reads a partially written entry
+  std::string path = GetPath(fingerprint);
+  std::string tmp_path = path + ".tmp";
+  Header header{kMagic,
+                GetBuildId(),
+                fingerprint,
+                ir_hash,
+                layout_hash,
+                object.size(),
+                static_cast<uint32_t>(table_oids.size()),
+                0};
+  bool written = false;
+  {
+    FilePtr file{std::fopen(tmp_path.c_str(), "wb")};
+    written =
+        file != nullptr &&
+        std::fwrite(&header, sizeof(Header), 1, file.get()) == 1 &&
+        std::fwrite(table_oids.data(), sizeof(oid_t), table_oids.size(),
+                    file.get()) == table_oids.size() &&
+        std::fwrite(object.data(), 1, object.size(), file.get()) ==
+            object.size();
+  }
+  boost::system::error_code error;
+  if (written) {
+    boost::filesystem::rename(tmp_path, path, error);
+  }
+  if (!written || error) {
+    LOG_WARN("Unable to write code cache entry '%s'", path.c_str());
+    boost::filesystem::remove(tmp_path, error);
+  } else {
+    entries_[fingerprint] = Entry{std::move(table_oids)};
+  }
+  latch_.Unlock();
+}
+
+void PersistentCodeCache::Remove(oid_t table_oid) {
+  latch_.WriteLock();
+  for (auto iter = entries_.begin(); iter != entries_.end();) {
+    const auto &table_oids = iter->second.table_oids;
+    if (std::find(table_oids.begin(), table_oids.end(), table_oid) !=
+        table_oids.end()) {
+      RemoveFile(iter->first);
+      iter = entries_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  latch_.Unlock();
+}
+
+void PersistentCodeCache::Clear() {
+  latch_.WriteLock();
+  for (const auto &entry : entries_) {
+    RemoveFile(entry.first);
+  }
+  entries_.clear();
+  latch_.Unlock();
+}
+
+size_t PersistentCodeCache::GetCount() const {
+  latch_.ReadLock();
+  size_t count = entries_.size();
+  latch_.Unlock();
+  return count;
+}
+
+uint64_t PersistentCodeCache::GetBuildId() {
+  // Code compiled by a different version of the engine or of LLVM, or for a
+  // different CPU, is never reused
+  static const uint64_t build_id = [] {
+    std::string build = std::string{PELOTON_STRINGIFY(PELOTON_VERSION)} + " " +
+                        __DATE__ + " " + __TIME__ + " " + LLVM_VERSION_STRING +
+                        " " + llvm::sys::getHostCPUName().str();
+    return static_cast<uint64_t>(
+        HashUtil::HashBytes(build.data(), build.length()));
+  }();
+  return build_id;
+}
+
+void PersistentCodeCache::CollectTableOids(const planner::AbstractPlan &plan,
+                                           std::vector<oid_t> &table_oids) {
+  const storage::DataTable *table = nullptr;
+  switch (plan.GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN:
+    case PlanNodeType::INDEXSCAN: {
+      auto &scan = static_cast<const planner::AbstractScan &>(plan);
+      table = scan.GetTable();
+      break;
+    }
+    case PlanNodeType::DELETE: {
+      table = static_cast<const planner::DeletePlan &>(plan).GetTable();
+      break;
+    }
+    case PlanNodeType::INSERT: {
+      table = static_cast<const planner::InsertPlan &>(plan).GetTable();
+      break;
+    }
+    case PlanNodeType::UPDATE: {
+      table = static_cast<const planner::UpdatePlan &>(plan).GetTable();
+      break;
+    }
+    case PlanNodeType::NESTLOOPINDEX: {
+      table = static_cast<const planner::NestedLoopIndexJoinPlan &>(plan)
+                  .GetInnerTable();
+      break;
+    }
+    default: { break; }
+  }
+  if (table != nullptr) {
+    table_oids.push_back(table->GetOid());
+  }
+  for (const auto &child : plan.GetChildren()) {
+    CollectTableOids(*child, table_oids);
+  }
+}
+
+std::string PersistentCodeCache::GetPath(hash_t fingerprint) const {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016" PRIx64 "%s",
+                static_cast<uint64_t>(fingerprint), kExtension);
+  return (boost::filesystem::path{directory_} / name).string();
+}
+
+bool PersistentCodeCache::ReadHeader(const std::string &path, Header &header,
+                                     std::vector<oid_t> &table_oids) const {
+  FilePtr file{std::fopen(path.c_str(), "rb")};
+  if (file == nullptr ||
+      std::fread(&header, sizeof(Header), 1, file.get()) != 1 ||
+      header.magic != kMagic || header.build_id != GetBuildId()) {
+    return false;
+  }
+  table_oids.resize(header.num_tables);
+  return std::fread(table_oids.data(), sizeof(oid_t), table_oids.size(),
+                    file.get()) == table_oids.size();
+}
+
+void PersistentCodeCache::RemoveFile(hash_t fingerprint) const {
+  boost::system::error_code error;
+  boost::filesystem::remove(GetPath(fingerprint), error);
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -68,6 +68,12 @@ const OperatorTranslator *Pipeline::NextStep() {
   }
 }
 
+void Pipeline::MoveTo(const OperatorTranslator *translator) {
+  auto iter = std::find(pipeline_.begin(), pipeline_.end(), translator);
+  PL_ASSERT(iter != pipeline_.end());
+  pipeline_index_ = static_cast<uint32_t>(iter - pipeline_.begin());
+}
+
 uint32_t Pipeline::GetNumStages() const {
   return static_cast<uint32_t>(stage_boundaries_.size()) + 1;
 }
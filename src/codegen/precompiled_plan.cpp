@@ -0,0 +1,585 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// precompiled_plan.cpp
+//
+// Identification: src/codegen/precompiled_plan.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/precompiled_plan.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "codegen/buffering_consumer.h"
+#include "codegen/inserter.h"
+#include "codegen/query_parameters.h"
+#include "codegen/runtime_functions.h"
+#include "codegen/transaction_runtime.h"
+#include "codegen/updater.h"
+#include "common/exception.h"
+#include "executor/executor_context.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/insert_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "planner/update_plan.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tuple.h"
+#include "type/limits.h"
+#include "type/value_peeker.h"
+
+namespace peloton {
+namespace codegen {
+
+namespace {
+
+// The number of rows the scan processes at a time
+constexpr uint32_t kBatchSize = 1024;
+
+//===----------------------------------------------------------------------===//
+// The kernels
+//===----------------------------------------------------------------------===//
+
+// How a column is compared with a value
+enum class CompareAs { Integer, Timestamp, Decimal, Unsupported };
+
+// The value a kernel compares the column with, in the type it compares as
+struct CompareValue {
+  int64_t integer;
+  uint64_t timestamp;
+  double decimal;
+};
+
+template <typename C>
+C GetCompareValue(const CompareValue &value);
+
+template <>
+int64_t GetCompareValue<int64_t>(const CompareValue &value) {
+  return value.integer;
+}
+
+template <>
+uint64_t GetCompareValue<uint64_t>(const CompareValue &value) {
+  return value.timestamp;
+}
+
+template <>
+double GetCompareValue<double>(const CompareValue &value) {
+  return value.decimal;
+}
+
+// The value representing NULL in a column of the given type
+template <typename T>
+T NullOf();
+
+template <>
+int8_t NullOf<int8_t>() {
+  return peloton::type::PELOTON_INT8_NULL;
+}
+
+template <>
+int16_t NullOf<int16_t>() {
+  return peloton::type::PELOTON_INT16_NULL;
+}
+
+template <>
+int32_t NullOf<int32_t>() {
+  // Also the NULL of dates
+  return peloton::type::PELOTON_INT32_NULL;
+}
+
+template <>
+int64_t NullOf<int64_t>() {
+  return peloton::type::PELOTON_INT64_NULL;
+}
+
+template <>
+uint64_t NullOf<uint64_t>() {
+  return peloton::type::PELOTON_TIMESTAMP_NULL;
+}
+
+template <>
+double NullOf<double>() {
+  return peloton::type::PELOTON_DECIMAL_NULL;
+}
+
+// Removes the rows failing the comparison from the given TIDs, returning the
+// number of remaining rows
+using FilterKernel = uint32_t (*)(const char *column, uint32_t stride,
+                                  const CompareValue &value, uint32_t *tids,
+                                  uint32_t num_tids);
+
+// The kernel for columns of type T, compared as values of type C. NULLs never
+// pass. The TIDs are compacted without branching on the comparison.
+template <typename T, typename C, typename Compare>
+uint32_t Filter(const char *column, uint32_t stride, const CompareValue &value,
+                uint32_t *tids, uint32_t num_tids) {
+  const C compare_value = GetCompareValue<C>(value);
+  const T null_value = NullOf<T>();
+  Compare compare;
+  uint32_t num_passed = 0;
+  for (uint32_t i = 0; i < num_tids; i++) {
+    uint32_t tid = tids[i];
+    T column_value;
+    PL_MEMCPY(&column_value, column + tid * stride, sizeof(T));
+    tids[num_passed] = tid;
+    num_passed += static_cast<uint32_t>(column_value != null_value) &
+                  static_cast<uint32_t>(
+                      compare(static_cast<C>(column_value), compare_value));
+  }
+  return num_passed;
+}
+
+template <typename T, typename C>
+FilterKernel GetKernel(ExpressionType comparison) {
+  switch (comparison) {
+    case ExpressionType::COMPARE_EQUAL:
+      return &Filter<T, C, std::equal_to<C>>;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return &Filter<T, C, std::not_equal_to<C>>;
+    case ExpressionType::COMPARE_LESSTHAN:
+      return &Filter<T, C, std::less<C>>;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return &Filter<T, C, std::less_equal<C>>;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return &Filter<T, C, std::greater<C>>;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return &Filter<T, C, std::greater_equal<C>>;
+    default:
+      return nullptr;
+  }
+}
+
+template <typename T>
+FilterKernel GetNumericKernel(CompareAs compare_as, ExpressionType comparison) {
+  return compare_as == CompareAs::Integer ? GetKernel<T, int64_t>(comparison)
+                                          : GetKernel<T, double>(comparison);
+}
+
+bool IsIntegral(peloton::type::TypeId type_id) {
+  switch (type_id) {
+    case peloton::type::TypeId::TINYINT:
+    case peloton::type::TypeId::SMALLINT:
+    case peloton::type::TypeId::INTEGER:
+    case peloton::type::TypeId::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// How a column of the given type is compared with a value of the given type
+CompareAs GetCompareType(peloton::type::TypeId column_type,
+                         peloton::type::TypeId value_type) {
+  using TypeId = peloton::type::TypeId;
+  bool column_numeric =
+      IsIntegral(column_type) || column_type == TypeId::DECIMAL;
+  bool value_numeric = IsIntegral(value_type) || value_type == TypeId::DECIMAL;
+  if (IsIntegral(column_type) && IsIntegral(value_type)) {
+    return CompareAs::Integer;
+  } else if (column_numeric && value_numeric) {
+    return CompareAs::Decimal;
+  } else if (column_type == TypeId::DATE && value_type == TypeId::DATE) {
+    return CompareAs::Integer;
+  } else if (column_type == TypeId::TIMESTAMP &&
+             value_type == TypeId::TIMESTAMP) {
+    return CompareAs::Timestamp;
+  }
+  return CompareAs::Unsupported;
+}
+
+// Find the kernel comparing a column of the given type with a value
+FilterKernel GetKernel(peloton::type::TypeId column_type, CompareAs compare_as,
+                       ExpressionType comparison) {
+  using TypeId = peloton::type::TypeId;
+  switch (column_type) {
+    case TypeId::TINYINT:
+      return GetNumericKernel<int8_t>(compare_as, comparison);
+    case TypeId::SMALLINT:
+      return GetNumericKernel<int16_t>(compare_as, comparison);
+    case TypeId::INTEGER:
+      return GetNumericKernel<int32_t>(compare_as, comparison);
+    case TypeId::BIGINT:
+      return GetNumericKernel<int64_t>(compare_as, comparison);
+    case TypeId::DECIMAL:
+      return GetKernel<double, double>(comparison);
+    case TypeId::DATE:
+      return GetKernel<int32_t, int64_t>(comparison);
+    case TypeId::TIMESTAMP:
+      return GetKernel<uint64_t, uint64_t>(comparison);
+    default:
+      return nullptr;
+  }
+}
+
+// Convert the (non-NULL) value into the type it is compared as
+CompareValue MakeCompareValue(const peloton::type::Value &value,
+                              CompareAs compare_as) {
+  using TypeId = peloton::type::TypeId;
+  using ValuePeeker = peloton::type::ValuePeeker;
+  CompareValue compare_value{0, 0, 0.0};
+  switch (compare_as) {
+    case CompareAs::Integer: {
+      compare_value.integer =
+          value.GetTypeId() == TypeId::DATE
+              ? ValuePeeker::PeekDate(value)
+              : ValuePeeker::PeekBigInt(value.CastAs(TypeId::BIGINT));
+      break;
+    }
+    case CompareAs::Timestamp: {
+      compare_value.timestamp = ValuePeeker::PeekTimestamp(value);
+      break;
+    }
+    case CompareAs::Decimal: {
+      compare_value.decimal =
+          ValuePeeker::PeekDouble(value.CastAs(TypeId::DECIMAL));
+      break;
+    }
+    case CompareAs::Unsupported: { break; }
+  }
+  return compare_value;
+}
+
+// The comparison with its sides swapped
+ExpressionType FlipComparison(ExpressionType comparison) {
+  switch (comparison) {
+    case ExpressionType::COMPARE_LESSTHAN:
+      return ExpressionType::COMPARE_GREATERTHAN;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return ExpressionType::COMPARE_LESSTHAN;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return ExpressionType::COMPARE_LESSTHANOREQUALTO;
+    default:
+      return comparison;
+  }
+}
+
+// Is the expression a constant or a parameter?
+bool IsConstantOrParameter(const expression::AbstractExpression &exp) {
+  return exp.GetExpressionType() == ExpressionType::VALUE_CONSTANT ||
+         exp.GetExpressionType() == ExpressionType::VALUE_PARAMETER;
+}
+
+// The value of the constant or parameter
+const peloton::type::Value &GetValue(
+    const QueryParameters &parameters,
+    const expression::AbstractExpression &exp) {
+  return parameters.GetParameterValues()[parameters.GetParameterIdx(&exp)];
+}
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+// Matching
+//===----------------------------------------------------------------------===//
+
+std::unique_ptr<PrecompiledPlan> PrecompiledPlan::Match(
+    const planner::AbstractPlan &plan, const QueryParameters &parameters) {
+  std::vector<Term> terms;
+  switch (plan.GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN: {
+      if (!MatchScan(plan, parameters, terms)) {
+        return nullptr;
+      }
+      auto &scan = static_cast<const planner::SeqScanPlan &>(plan);
+      return std::unique_ptr<PrecompiledPlan>{
+          new PrecompiledPlan(plan, &scan, std::move(terms))};
+    }
+    case PlanNodeType::INSERT: {
+      // Only inserts of the constant tuples in the plan, which are the only
+      // parameters of such plans
+      auto &insert = static_cast<const planner::InsertPlan &>(plan);
+      auto num_columns = insert.GetTable()->GetSchema()->GetColumnCount();
+      if (insert.GetChildrenSize() != 0 ||
+          parameters.GetParameterValues().size() !=
+              insert.GetBulkInsertCount() * num_columns) {
+        return nullptr;
+      }
+      return std::unique_ptr<PrecompiledPlan>{
+          new PrecompiledPlan(plan, nullptr, std::move(terms))};
+    }
+    case PlanNodeType::UPDATE: {
+      auto &update = static_cast<const planner::UpdatePlan &>(plan);
+      if (!MatchUpdate(update, parameters, terms)) {
+        return nullptr;
+      }
+      auto &scan = static_cast<const planner::SeqScanPlan &>(*plan.GetChild(0));
+      return std::unique_ptr<PrecompiledPlan>{
+          new PrecompiledPlan(plan, &scan, std::move(terms))};
+    }
+    default: { return nullptr; }
+  }
+}
+
+bool PrecompiledPlan::MatchScan(const planner::AbstractPlan &plan,
+                                const QueryParameters &parameters,
+                                std::vector<Term> &terms) {
+  if (plan.GetPlanNodeType() != PlanNodeType::SEQSCAN ||
+      plan.GetChildrenSize() != 0) {
+    return false;
+  }
+  auto &scan = static_cast<const planner::SeqScanPlan &>(plan);
+  const auto *predicate = scan.GetPredicate();
+  return scan.GetTable() != nullptr &&
+         (predicate == nullptr ||
+          CollectTerms(scan, parameters, *predicate, terms));
+}
+
+bool PrecompiledPlan::CollectTerms(const planner::SeqScanPlan &scan,
+                                   const QueryParameters &parameters,
+                                   const expression::AbstractExpression &exp,
+                                   std::vector<Term> &terms) {
+  if (exp.GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    return CollectTerms(scan, parameters, *exp.GetChild(0), terms) &&
+           CollectTerms(scan, parameters, *exp.GetChild(1), terms);
+  }
+  if (exp.GetChildrenSize() != 2) {
+    return false;
+  }
+
+  // One side must be a column, the other a constant or parameter
+  ExpressionType comparison = exp.GetExpressionType();
+  const auto *column = exp.GetChild(0);
+  const auto *value = exp.GetChild(1);
+  if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    std::swap(column, value);
+    comparison = FlipComparison(comparison);
+  }
+  if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+      !IsConstantOrParameter(*value)) {
+    return false;
+  }
+
+  auto column_id =
+      static_cast<const expression::TupleValueExpression *>(column)
+          ->GetColumnId();
+  auto column_type = scan.GetTable()->GetSchema()->GetType(column_id);
+  auto compare_as =
+      GetCompareType(column_type, GetValue(parameters, *value).GetTypeId());
+  if (compare_as == CompareAs::Unsupported ||
+      GetKernel(column_type, compare_as, comparison) == nullptr) {
+    return false;
+  }
+  terms.push_back(Term{column_id, column_type, comparison, value});
+  return true;
+}
+
+bool PrecompiledPlan::MatchUpdate(const planner::UpdatePlan &update,
+                                  const QueryParameters &parameters,
+                                  std::vector<Term> &terms) {
+  // The scan must produce all the columns of the table in order
+  if (update.GetChildrenSize() != 1 ||
+      !MatchScan(*update.GetChild(0), parameters, terms)) {
+    return false;
+  }
+  auto &scan = static_cast<const planner::SeqScanPlan &>(*update.GetChild(0));
+  const auto &column_ids = scan.GetColumnIds();
+  if (scan.GetTable() != update.GetTable() ||
+      column_ids.size() != update.GetTable()->GetSchema()->GetColumnCount()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < column_ids.size(); i++) {
+    if (column_ids[i] != i) {
+      return false;
+    }
+  }
+
+  // The columns are set to constants or parameters
+  for (const auto &target : update.GetProjectInfo()->GetTargetList()) {
+    if (!IsConstantOrParameter(*target.second.expr)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Execution
+//===----------------------------------------------------------------------===//
+
+void PrecompiledPlan::Execute(executor::ExecutorContext &executor_context,
+                              const std::vector<oid_t> &output_columns,
+                              BufferingConsumer &consumer) const {
+  switch (plan_.GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN: {
+      ExecuteScan(executor_context, output_columns, consumer);
+      break;
+    }
+    case PlanNodeType::INSERT: {
+      ExecuteInsert(executor_context);
+      break;
+    }
+    case PlanNodeType::UPDATE: {
+      ExecuteUpdate(executor_context);
+      break;
+    }
+    default: {
+      throw Exception{"Plan " + PlanNodeTypeToString(plan_.GetPlanNodeType()) +
+                      " has no precompiled implementation"};
+    }
+  }
+}
+
+void PrecompiledPlan::Scan(executor::ExecutorContext &executor_context,
+                           const RowCallback &callback) const {
+  // Find the kernels of the terms and the values they compare with
+  const auto &parameters = executor_context.GetParams();
+  std::vector<FilterKernel> kernels;
+  std::vector<CompareValue> values;
+  for (const auto &term : terms_) {
+    const auto &value = GetValue(parameters, *term.value);
+    if (value.IsNull()) {
+      // Comparisons with NULL are never true
+      return;
+    }
+    auto compare_as = GetCompareType(term.column_type, value.GetTypeId());
+    kernels.push_back(GetKernel(term.column_type, compare_as, term.comparison));
+    values.push_back(MakeCompareValue(value, compare_as));
+  }
+
+  auto *txn = executor_context.GetTransaction();
+  auto *table = scan_->GetTable();
+  auto num_columns = table->GetSchema()->GetColumnCount();
+  std::vector<RuntimeFunctions::ColumnLayoutInfo> layout(num_columns);
+  uint32_t tids[kBatchSize];
+
+  size_t num_tile_groups = table->GetTileGroupCount();
+  for (size_t i = 0; i < num_tile_groups; i++) {
+    auto tile_group = table->GetTileGroup(i);
+    RuntimeFunctions::GetTileGroupLayout(tile_group.get(), layout.data(),
+                                         num_columns);
+
+    uint32_t num_tuples = tile_group->GetNextTupleSlot();
+    for (uint32_t tid_start = 0; tid_start < num_tuples;
+         tid_start += kBatchSize) {
+      uint32_t tid_end = std::min(tid_start + kBatchSize, num_tuples);
+      uint32_t num_tids = TransactionRuntime::PerformVectorizedRead(
+          *txn, *tile_group, tid_start, tid_end, tids);
+      for (uint32_t k = 0; k < kernels.size() && num_tids > 0; k++) {
+        const auto &column = layout[terms_[k].column_id];
+        num_tids =
+            kernels[k](column.column, column.stride, values[k], tids, num_tids);
+      }
+      if (num_tids > 0) {
+        callback(*tile_group, tids, num_tids);
+      }
+    }
+  }
+}
+
+void PrecompiledPlan::ExecuteScan(executor::ExecutorContext &executor_context,
+                                  const std::vector<oid_t> &output_columns,
+                                  BufferingConsumer &consumer) const {
+  const auto &column_ids = scan_->GetColumnIds();
+  std::vector<peloton::type::Value> tuple(output_columns.size());
+  Scan(executor_context, [&](storage::TileGroup &tile_group,
+                             const uint32_t *tids, uint32_t num_tids) {
+    for (uint32_t i = 0; i < num_tids; i++) {
+      for (uint32_t col = 0; col < output_columns.size(); col++) {
+        tuple[col] =
+            tile_group.GetValue(tids[i], column_ids[output_columns[col]]);
+      }
+      BufferingConsumer::BufferTuple(consumer.GetConsumerState(),
+                                     reinterpret_cast<char *>(tuple.data()),
+                                     static_cast<uint32_t>(tuple.size()));
+    }
+  });
+}
+
+void PrecompiledPlan::ExecuteInsert(
+    executor::ExecutorContext &executor_context) const {
+  auto &insert = static_cast<const planner::InsertPlan &>(plan_);
+  auto *table = insert.GetTable();
+  auto *schema = table->GetSchema();
+  auto num_columns = schema->GetColumnCount();
+  const auto &values = executor_context.GetParams().GetParameterValues();
+
+  Inserter inserter;
+  inserter.Init(table, &executor_context);
+  try {
+    for (uint32_t tuple_idx = 0; tuple_idx < insert.GetBulkInsertCount();
+         tuple_idx++) {
+      storage::Tuple tuple{schema, inserter.AllocateTupleStorage()};
+      for (uint32_t col = 0; col < num_columns; col++) {
+        tuple.SetValue(col, values[col + tuple_idx * num_columns],
+                       inserter.GetPool());
+      }
+      inserter.Insert();
+    }
+  } catch (...) {
+    inserter.TearDown();
+    throw;
+  }
+  inserter.TearDown();
+}
+
+void PrecompiledPlan::ExecuteUpdate(
+    executor::ExecutorContext &executor_context) const {
+  auto &update = static_cast<const planner::UpdatePlan &>(plan_);
+  auto *table = update.GetTable();
+  auto *schema = table->GetSchema();
+  auto num_columns = schema->GetColumnCount();
+  const auto &target_list = update.GetProjectInfo()->GetTargetList();
+  bool update_primary_key = update.GetUpdatePrimaryKey();
+
+  // The new values of the target columns
+  const auto &parameters = executor_context.GetParams();
+  std::vector<std::pair<oid_t, peloton::type::Value>> targets;
+  for (const auto &target : target_list) {
+    targets.emplace_back(target.first,
+                         GetValue(parameters, *target.second.expr));
+  }
+
+  // The updater keeps the target list for installing new versions
+  Updater updater;
+  updater.Init(table, &executor_context,
+               const_cast<Target *>(target_list.data()),
+               static_cast<uint32_t>(target_list.size()));
+  std::vector<peloton::type::Value> values(num_columns);
+  try {
+    Scan(executor_context, [&](storage::TileGroup &tile_group,
+                               const uint32_t *tids, uint32_t num_tids) {
+      uint32_t tile_group_id = tile_group.GetTileGroupId();
+      for (uint32_t i = 0; i < num_tids; i++) {
+        // Collect the values of the new version before it's prepared, which
+        // may happen in place
+        for (uint32_t col = 0; col < num_columns; col++) {
+          values[col] = tile_group.GetValue(tids[i], col);
+        }
+        for (const auto &target : targets) {
+          values[target.first] = target.second;
+        }
+
+        char *data = update_primary_key
+                         ? updater.PreparePK(tile_group_id, tids[i])
+                         : updater.Prepare(tile_group_id, tids[i]);
+        if (data == nullptr) {
+          continue;
+        }
+        storage::Tuple tuple{schema, data};
+        for (uint32_t col = 0; col < num_columns; col++) {
+          tuple.SetValue(col, values[col], updater.GetPool());
+        }
+        if (update_primary_key) {
+          updater.UpdatePK();
+        } else {
+          updater.Update();
+        }
+      }
+    });
+  } catch (...) {
+    updater.TearDown();
+    throw;
+  }
+  updater.TearDown();
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -17,10 +17,13 @@ namespace codegen {
 
 DEFINE_TYPE(BloomFilter, "peloton::BloomFilter", MEMBER(num_hash_funcs),
             MEMBER(bytes), MEMBER(num_bits), MEMBER(num_misses),
-            MEMBER(num_probes));
+            MEMBER(num_probes), MEMBER(min_key), MEMBER(max_key),
+            MEMBER(sample_probes), MEMBER(sample_misses), MEMBER(num_skipped),
+            MEMBER(probing));
 
 DEFINE_METHOD(peloton::codegen::util, BloomFilter, Init);
 DEFINE_METHOD(peloton::codegen::util, BloomFilter, Destroy);
+DEFINE_METHOD(peloton::codegen::util, BloomFilter, ShouldProbe);
 
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
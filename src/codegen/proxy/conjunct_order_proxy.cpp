@@ -0,0 +1,26 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// conjunct_order_proxy.cpp
+//
+// Identification: src/codegen/proxy/conjunct_order_proxy.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/proxy/conjunct_order_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+DEFINE_TYPE(ConjunctOrder, "peloton::ConjunctOrder", MEMBER(order),
+            MEMBER(num_in), MEMBER(num_passed), MEMBER(num_conjuncts),
+            MEMBER(num_batches));
+
+DEFINE_METHOD(peloton::codegen::util, ConjunctOrder, Init);
+DEFINE_METHOD(peloton::codegen::util, ConjunctOrder, Update);
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,32 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_partitions_proxy.cpp
+//
+// Identification: src/codegen/proxy/hash_partitions_proxy.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/proxy/hash_partitions_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+DEFINE_TYPE(HashPartitions, "peloton::HashPartitions", MEMBER(merge_func),
+            MEMBER(partitions), MEMBER(tables), MEMBER(pre_aggregation_table),
+            MEMBER(key_size), MEMBER(value_size), MEMBER(entry_size),
+            MEMBER(num_flushed), MEMBER(memory_budget),
+            MEMBER(partition_bytes), MEMBER(pending_runs), MEMBER(run_table),
+            MEMBER(num_tables), MEMBER(next_table));
+
+DEFINE_METHOD(peloton::codegen::util, HashPartitions, Init);
+DEFINE_METHOD(peloton::codegen::util, HashPartitions, Flush);
+DEFINE_METHOD(peloton::codegen::util, HashPartitions, Finish);
+DEFINE_METHOD(peloton::codegen::util, HashPartitions, NextTable);
+DEFINE_METHOD(peloton::codegen::util, HashPartitions, Destroy);
+
+}  // namespace codegen
+}  // namespace peloton
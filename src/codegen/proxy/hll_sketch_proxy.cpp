@@ -0,0 +1,24 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hll_sketch_proxy.cpp
+//
+// Identification: src/codegen/proxy/hll_sketch_proxy.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/proxy/hll_sketch_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+DEFINE_METHOD(peloton::codegen::util, HllSketch, Init);
+DEFINE_METHOD(peloton::codegen::util, HllSketch, Update);
+DEFINE_METHOD(peloton::codegen::util, HllSketch, Merge);
+DEFINE_METHOD(peloton::codegen::util, HllSketch, Estimate);
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,31 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_probe_proxy.cpp
+//
+// Identification: src/codegen/proxy/index_probe_proxy.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/proxy/index_probe_proxy.h"
+
+#include "codegen/proxy/data_table_proxy.h"
+#include "codegen/proxy/executor_context_proxy.h"
+#include "codegen/proxy/tile_group_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+DEFINE_TYPE(IndexProbe, "codegen::IndexProbe", MEMBER(opaque));
+
+DEFINE_METHOD(peloton::codegen, IndexProbe, Init);
+DEFINE_METHOD(peloton::codegen, IndexProbe, Probe);
+DEFINE_METHOD(peloton::codegen, IndexProbe, GetTileGroup);
+DEFINE_METHOD(peloton::codegen, IndexProbe, GetTupleOffset);
+DEFINE_METHOD(peloton::codegen, IndexProbe, TearDown);
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,25 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// t_digest_proxy.cpp
+//
+// Identification: src/codegen/proxy/t_digest_proxy.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/proxy/t_digest_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+DEFINE_METHOD(peloton::codegen::util, TDigest, Init);
+DEFINE_METHOD(peloton::codegen::util, TDigest, Add);
+DEFINE_METHOD(peloton::codegen::util, TDigest, Merge);
+DEFINE_METHOD(peloton::codegen::util, TDigest, IsEmpty);
+DEFINE_METHOD(peloton::codegen::util, TDigest, Quantile);
+
+}  // namespace codegen
+}  // namespace peloton
@@ -33,6 +33,7 @@ DEFINE_TYPE(PredicateInfo, "peloton::storage::PredicateInfo", MEMBER(col_id),
 DEFINE_TYPE(ZoneMapManager, "peloton::storage::ZoneMapManager", MEMBER(opaque));
 
 DEFINE_METHOD(peloton::storage, ZoneMapManager, ShouldScanTileGroup);
+DEFINE_METHOD(peloton::storage, ZoneMapManager, ShouldScanTileGroupInRange);
 DEFINE_METHOD(peloton::storage, ZoneMapManager, GetInstance);
 
 }  // namespace codegen
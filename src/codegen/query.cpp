@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "codegen/query.h"
+#include "codegen/persistent_code_cache.h"
 #include "codegen/query_result_consumer.h"
 #include "common/timer.h"
 #include "executor/plan_executor.h"
@@ -20,8 +21,24 @@ namespace peloton {
 namespace codegen {
 
 // Constructor
-Query::Query(const planner::AbstractPlan &query_plan)
-    : query_plan_(query_plan) {}
+Query::Query(const planner::AbstractPlan &query_plan,
+             const QueryParametersMap &parameters_map)
+    : query_plan_(query_plan), parameters_(parameters_map.GetParameters()) {}
+
+bool Query::IsCompatible(const QueryParametersMap &parameters_map) const {
+  const auto &parameters = parameters_map.GetParameters();
+  if (parameters.size() != parameters_.size()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < parameters.size(); i++) {
+    // Constants and parameters are read the same way, ignore the kind
+    if (parameters[i].GetValueType() != parameters_[i].GetValueType() ||
+        parameters[i].IsNullable() != parameters_[i].IsNullable()) {
+      return false;
+    }
+  }
+  return true;
+}
 
 void Query::Execute(std::unique_ptr<executor::ExecutorContext> executor_context,
                     QueryResultConsumer &consumer,
@@ -53,6 +70,7 @@ void Query::Execute(std::unique_ptr<executor::ExecutorContext> executor_context,
   func_args->executor_context = executor_context.get();
   func_args->query_parameters = &executor_context->GetParams();
   func_args->consumer_arg = consumer.GetConsumerState();
+  runtime_state_.InitializePointers(codegen, param);
 
   // Timer
   Timer<std::ratio<1, 1000>> timer;
@@ -113,11 +131,35 @@ void Query::Execute(std::unique_ptr<executor::ExecutorContext> executor_context,
 bool Query::Prepare(const QueryFunctions &query_funcs) {
   LOG_TRACE("Going to JIT the query ...");
 
+  // Check if the code has been compiled before, possibly before a restart
+  auto &code_cache = PersistentCodeCache::Instance();
+  bool use_code_cache = code_cache.IsEnabled();
+  bool cached = false;
+  hash_t fingerprint = 0, ir_hash = 0, layout_hash = 0;
+  if (use_code_cache) {
+    CodeGen codegen{code_context_};
+    fingerprint = PersistentCodeCache::Fingerprint(
+        query_plan_, parameters_, code_context_.GetOptimizationTier());
+    ir_hash = code_context_.HashIR();
+    layout_hash = runtime_state_.HashLayout(codegen);
+    std::string object;
+    cached = code_cache.Find(fingerprint, ir_hash, layout_hash, object);
+    if (cached) {
+      LOG_DEBUG("Loading the code of the query from the code cache");
+      code_context_.UseCachedObject(std::move(object));
+    }
+  }
+
   // Compile the code
   if (!code_context_.Compile()) {
     return false;
   }
 
+  if (use_code_cache && !cached) {
+    code_cache.Add(fingerprint, query_plan_, ir_hash, layout_hash,
+                   code_context_.GetObjectCode());
+  }
+
   LOG_TRACE("Setting up Query ...");
 
   // Get pointers to the JITed functions
@@ -11,34 +11,99 @@
 //===----------------------------------------------------------------------===//
 
 #include "codegen/query_cache.h"
+#include "codegen/persistent_code_cache.h"
 #include "planner/delete_plan.h"
 #include "planner/insert_plan.h"
 #include "planner/seq_scan_plan.h"
 #include "planner/update_plan.h"
+#include "settings/settings_manager.h"
 #include "storage/data_table.h"
 
 namespace peloton {
 namespace codegen {
 
-Query* QueryCache::Find(const std::shared_ptr<planner::AbstractPlan> &key) {
+Query* QueryCache::Find(const std::shared_ptr<planner::AbstractPlan> &key,
+                        const QueryParametersMap *parameters_map) {
+  hash_t plan_hash = key->Hash();
   cache_lock_.ReadLock();
-  auto it = cache_map_.find(key);
-  if (it == cache_map_.end()) {
+  auto range = cache_map_.equal_range(plan_hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    auto &entry = *it->second;
+    if (*entry.plan != *key) {
+      continue;
+    }
+    if (parameters_map != nullptr &&
+        !entry.query->IsCompatible(*parameters_map)) {
+      continue;
+    }
+    query_list_.splice(query_list_.begin(), query_list_, it->second);
+    auto *query = entry.query.get();
     cache_lock_.Unlock();
-    return nullptr;
+    return query;
   }
-  query_list_.splice(query_list_.begin(), query_list_, it->second);
-  auto *query = it->second->second.get();
   cache_lock_.Unlock();
-  return query;
+  return nullptr;
 }
 
 void QueryCache::Add(const std::shared_ptr<planner::AbstractPlan> &key,
                      std::unique_ptr<Query> &&val) {
+  hash_t plan_hash = key->Hash();
+  cache_lock_.WriteLock();
+  RecordCompilation(*val);
+  query_list_.push_front(CacheEntry{key, plan_hash, std::move(val), 0.0,
+                                    false, nullptr, nullptr});
+  cache_map_.insert(std::make_pair(plan_hash, query_list_.begin()));
+  cache_lock_.Unlock();
+}
+
+bool QueryCache::RecordExecution(
+    const std::shared_ptr<planner::AbstractPlan> &key, const Query *query,
+    double execution_ms) {
+  auto threshold_ms = settings::SettingsManager::GetInt(
+      settings::SettingId::codegen_aggressive_optimization_ms);
+  hash_t plan_hash = key->Hash();
+  cache_lock_.WriteLock();
+  const auto &code_context = query->GetCodeContext();
+  auto &stats =
+      tier_stats_[static_cast<uint32_t>(code_context.GetOptimizationTier())];
+  stats.num_executed++;
+  stats.execution_ms += execution_ms;
+
+  bool recompile = false;
+  auto entry = FindEntry(plan_hash, query);
+  if (entry != query_list_.end()) {
+    entry->execution_ms += execution_ms;
+    // The query pays off the recompilation once it ran long enough
+    recompile = threshold_ms > 0 && !entry->recompiled &&
+                code_context.GetOptimizationTier() !=
+                    CodeContext::OptimizationTier::Aggressive &&
+                entry->execution_ms >= threshold_ms;
+    entry->recompiled |= recompile;
+  }
+  cache_lock_.Unlock();
+  return recompile;
+}
+
+void QueryCache::Replace(hash_t plan_hash, const Query *query,
+                         std::shared_ptr<planner::AbstractPlan> plan,
+                         std::unique_ptr<Query> &&recompiled) {
   cache_lock_.WriteLock();
-  query_list_.push_front(make_pair(key, std::move(val)));
-  cache_map_.insert(make_pair(key, query_list_.begin()));
+  RecordCompilation(*recompiled);
+  auto entry = FindEntry(plan_hash, query);
+  if (entry != query_list_.end()) {
+    entry->replaced_query = std::move(entry->query);
+    entry->query_plan = std::move(plan);
+    entry->query = std::move(recompiled);
+  }
+  cache_lock_.Unlock();
+}
+
+QueryCache::TierStats QueryCache::GetTierStats(
+    CodeContext::OptimizationTier tier) {
+  cache_lock_.ReadLock();
+  auto stats = tier_stats_[static_cast<uint32_t>(tier)];
   cache_lock_.Unlock();
+  return stats;
 }
 
 void QueryCache::Clear() {
@@ -52,7 +117,7 @@ void QueryCache::Remove(const oid_t table_oid) {
   cache_lock_.WriteLock();
 
   for (auto it = cache_map_.begin(); it != cache_map_.end(); ) {
-    oid_t oid = GetOidFromPlan(*it->first.get());
+    oid_t oid = GetOidFromPlan(*it->second->plan);
     if (oid == table_oid) {
       query_list_.erase(it->second);
       it = cache_map_.erase(it);
@@ -61,6 +126,9 @@ void QueryCache::Remove(const oid_t table_oid) {
     }
   }
   cache_lock_.Unlock();
+
+  // The code compiled for the table's old schema is invalid on disk, too
+  PersistentCodeCache::Instance().Remove(table_oid);
 }
 
 void QueryCache::Resize(size_t target_size) {
@@ -68,13 +136,42 @@ void QueryCache::Resize(size_t target_size) {
   while (cache_map_.size() > target_size) {
     auto last_it = query_list_.end();
     last_it--;
-    cache_map_.erase(last_it->first);
+    EraseFromMap(last_it);
     query_list_.pop_back();
   }
   capacity_ = target_size;
   cache_lock_.Unlock();
 }
 
+void QueryCache::EraseFromMap(std::list<CacheEntry>::iterator entry) {
+  auto range = cache_map_.equal_range(entry->plan_hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == entry) {
+      cache_map_.erase(it);
+      return;
+    }
+  }
+}
+
+std::list<QueryCache::CacheEntry>::iterator QueryCache::FindEntry(
+    hash_t plan_hash, const Query *query) {
+  auto range = cache_map_.equal_range(plan_hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second->query.get() == query) {
+      return it->second;
+    }
+  }
+  return query_list_.end();
+}
+
+void QueryCache::RecordCompilation(const Query &query) {
+  const auto &code_context = query.GetCodeContext();
+  auto &stats =
+      tier_stats_[static_cast<uint32_t>(code_context.GetOptimizationTier())];
+  stats.num_compiled++;
+  stats.compile_ms += code_context.GetCompileTime();
+}
+
 oid_t QueryCache::GetOidFromPlan(const planner::AbstractPlan &plan) const {
  switch (plan.GetPlanNodeType()) {
     case PlanNodeType::SEQSCAN: {
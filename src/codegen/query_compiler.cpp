@@ -15,6 +15,9 @@
 #include "codegen/compilation_context.h"
 #include "planner/aggregate_plan.h"
 #include "planner/hash_join_plan.h"
+#include "planner/index_scan_plan.h"
+#include "planner/merge_join_plan.h"
+#include "planner/nested_loop_index_join_plan.h"
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
 
@@ -27,9 +30,11 @@ QueryCompiler::QueryCompiler() : next_id_(0) {}
 // Compile the given query statement
 std::unique_ptr<Query> QueryCompiler::Compile(
     const planner::AbstractPlan &root, const QueryParametersMap &parameters_map,
-    QueryResultConsumer &result_consumer, CompileStats *stats) {
+    QueryResultConsumer &result_consumer, CompileStats *stats,
+    CodeContext::OptimizationTier tier) {
   // The query statement we compile
-  std::unique_ptr<Query> query{new Query(root)};
+  std::unique_ptr<Query> query{new Query(root, parameters_map)};
+  query->GetCodeContext().SetOptimizationTier(tier);
 
   // Set up the compilation context
   CompilationContext context{*query, parameters_map, result_consumer};
@@ -71,15 +76,44 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
     }
     case PlanNodeType::NESTLOOP:
     case PlanNodeType::HASHJOIN: {
+      // Inner, outer, semi and anti joins are all supported
       const auto &join = static_cast<const planner::AbstractJoinPlan &>(plan);
-      // Right now, only support inner joins
-      if (join.GetJoinType() == JoinType::INNER) {
-        break;
+      if (join.GetJoinType() == JoinType::INVALID) {
+        return false;
       }
+      break;
     }
     case PlanNodeType::HASH: {
       break;
     }
+    case PlanNodeType::MERGEJOIN: {
+      // Only inner joins on keys sorted in ascending order
+      const auto &join = static_cast<const planner::MergeJoinPlan &>(plan);
+      if (join.GetJoinType() != JoinType::INNER) {
+        return false;
+      }
+      for (const auto &clause : *join.GetJoinClauses()) {
+        if (clause.reversed_ || !IsExpressionSupported(*clause.left_) ||
+            !IsExpressionSupported(*clause.right_)) {
+          return false;
+        }
+      }
+      break;
+    }
+    case PlanNodeType::NESTLOOPINDEX: {
+      // The inner table is probed by the join itself, so check its predicate
+      // here and only the outer child below
+      const auto &join =
+          static_cast<const planner::NestedLoopIndexJoinPlan &>(plan);
+      const auto *inner_pred = join.GetInnerPredicate();
+      if (join.GetJoinType() != JoinType::INNER ||
+          (inner_pred != nullptr && !IsExpressionSupported(*inner_pred)) ||
+          (join.GetPredicate() != nullptr &&
+           !IsExpressionSupported(*join.GetPredicate()))) {
+        return false;
+      }
+      return IsSupported(*join.GetChild(0));
+    }
     default: { return false; }
   }
 
@@ -96,9 +130,15 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
       pred = agg_plan.GetPredicate();
       break;
     }
+    case PlanNodeType::NESTLOOP:
     case PlanNodeType::HASHJOIN: {
-      auto &hj_plan = static_cast<const planner::HashJoinPlan &>(plan);
-      pred = hj_plan.GetPredicate();
+      auto &join_plan = static_cast<const planner::AbstractJoinPlan &>(plan);
+      pred = join_plan.GetPredicate();
+      break;
+    }
+    case PlanNodeType::MERGEJOIN: {
+      auto &mj_plan = static_cast<const planner::MergeJoinPlan &>(plan);
+      pred = mj_plan.GetPredicate();
       break;
     }
     default: { break; }
@@ -123,7 +163,8 @@ bool QueryCompiler::IsExpressionSupported(
     const expression::AbstractExpression &expr) {
   switch (expr.GetExpressionType()) {
     case ExpressionType::STAR:
-    case ExpressionType::VALUE_PARAMETER:
+    case ExpressionType::OPERATOR_NOT:
+    case ExpressionType::ROW_SUBQUERY:
       return false;
     default:
       break;
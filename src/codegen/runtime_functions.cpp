@@ -108,8 +108,9 @@ void RuntimeFunctions::GetTileGroupLayout(const storage::TileGroup *tile_group,
     oid_t tile_offset, tile_column_offset;
     tile_group->LocateTileAndColumn(col_idx, tile_offset, tile_column_offset);
 
-    // Now grab the column information
-    auto *tile = tile_group->GetTile(tile_offset);
+    // Now grab the column information. Frozen tiles are compressed, so we
+    // read from their (lazily built) uncompressed copy instead.
+    auto *tile = tile_group->GetTile(tile_offset)->GetMaterializedTile();
     auto *tile_schema = tile->GetSchema();
     infos[col_idx].column =
         tile->GetTupleLocation(0) + tile_schema->GetOffset(tile_column_offset);
@@ -12,6 +12,7 @@
 
 #include "codegen/runtime_state.h"
 #include "codegen/vector.h"
+#include "util/hash_util.h"
 
 namespace peloton {
 namespace codegen {
@@ -29,10 +30,20 @@ RuntimeState::StateID RuntimeState::RegisterState(std::string name,
   RuntimeState::StateInfo state_info;
   state_info.name = name;
   state_info.type = type;
+  state_info.ptr = nullptr;
   state_slots_.push_back(state_info);
   return state_id;
 }
 
+RuntimeState::StateID RuntimeState::RegisterPointer(std::string name,
+                                                    llvm::Type *type,
+                                                    const void *ptr) {
+  PL_ASSERT(type->isPointerTy());
+  RuntimeState::StateID state_id = RegisterState(name, type);
+  state_slots_[state_id].ptr = ptr;
+  return state_id;
+}
+
 llvm::Value *RuntimeState::LoadStatePtr(CodeGen &codegen,
                                         RuntimeState::StateID state_id) const {
   // At this point, the runtime state type must have been finalized. Otherwise,
@@ -87,5 +98,29 @@ llvm::Type *RuntimeState::FinalizeType(CodeGen &codegen) {
   return constructed_type_;
 }
 
+hash_t RuntimeState::HashLayout(CodeGen &codegen) {
+  uint64_t size = codegen.SizeOf(FinalizeType(codegen));
+  hash_t hash = HashUtil::Hash(&size);
+  for (const auto &state_info : state_slots_) {
+    uint64_t state_size = codegen.SizeOf(state_info.type);
+    hash = HashUtil::CombineHashes(
+        hash, HashUtil::HashBytes(state_info.name.data(),
+                                  state_info.name.length()));
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&state_size));
+  }
+  return hash;
+}
+
+void RuntimeState::InitializePointers(CodeGen &codegen, char *state) const {
+  PL_ASSERT(constructed_type_ != nullptr);
+  for (const auto &state_info : state_slots_) {
+    if (state_info.ptr != nullptr) {
+      uint64_t offset =
+          codegen.ElementOffset(constructed_type_, state_info.index);
+      *reinterpret_cast<const void **>(state + offset) = state_info.ptr;
+    }
+  }
+}
+
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
@@ -174,27 +174,49 @@ Sorter::SorterAccess::Row &Sorter::SorterAccess::GetRow(llvm::Value *row_idx) {
   return iter->second;
 }
 
-codegen::Value Sorter::SorterAccess::LoadRowValue(
-    CodeGen &codegen, Sorter::SorterAccess::Row &row,
-    uint32_t column_index) const {
+llvm::Value *Sorter::SorterAccess::GetRowPosition(
+    CodeGen &codegen, Sorter::SorterAccess::Row &row) const {
   if (row.row_pos_ == nullptr) {
     auto *tuple_size = sorter_.GetTupleSize(codegen);
     auto *skip = codegen->CreateMul(row.row_idx_, tuple_size);
     row.row_pos_ =
         codegen->CreateInBoundsGEP(codegen.ByteType(), start_pos_, skip);
   }
+  return row.row_pos_;
+}
+
+codegen::Value Sorter::SorterAccess::LoadRowValue(
+    CodeGen &codegen, Sorter::SorterAccess::Row &row,
+    uint32_t column_index) const {
+  auto *row_pos = GetRowPosition(codegen, row);
 
   const auto &storage_format = sorter_.GetStorageFormat();
-  UpdateableStorage::NullBitmap null_bitmap{codegen, storage_format,
-                                            row.row_pos_};
+  UpdateableStorage::NullBitmap null_bitmap{codegen, storage_format, row_pos};
   if (!null_bitmap.IsNullable(column_index)) {
-    return storage_format.GetValueSkipNull(codegen, row.row_pos_, column_index);
+    return storage_format.GetValueSkipNull(codegen, row_pos, column_index);
   } else {
-    return storage_format.GetValue(codegen, row.row_pos_, column_index,
+    return storage_format.GetValue(codegen, row_pos, column_index,
                                    null_bitmap);
   }
 }
 
+void Sorter::SorterAccess::StoreRowValue(CodeGen &codegen,
+                                         Sorter::SorterAccess::Row &row,
+                                         uint32_t column_index,
+                                         const codegen::Value &value) const {
+  auto *row_pos = GetRowPosition(codegen, row);
+
+  const auto &storage_format = sorter_.GetStorageFormat();
+  UpdateableStorage::NullBitmap null_bitmap{codegen, storage_format, row_pos};
+  if (!null_bitmap.IsNullable(column_index)) {
+    storage_format.SetValueSkipNull(codegen, row_pos, column_index, value);
+  } else {
+    storage_format.SetValue(codegen, row_pos, column_index, value,
+                            null_bitmap);
+    null_bitmap.WriteBack(codegen);
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // SORTER ACCESS :: ROW
 //===----------------------------------------------------------------------===//
@@ -207,5 +229,11 @@ codegen::Value Sorter::SorterAccess::Row::LoadColumn(CodeGen &codegen,
   return access_.LoadRowValue(codegen, *this, column_index);
 }
 
+void Sorter::SorterAccess::Row::StoreColumn(CodeGen &codegen,
+                                            uint32_t column_index,
+                                            const codegen::Value &value) {
+  access_.StoreRowValue(codegen, *this, column_index, value);
+}
+
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
@@ -57,7 +57,8 @@ llvm::Value *Table::GetZoneMapManager(CodeGen &codegen) const {
 // num_tile_groups = GetTileGroupCount(table_ptr)
 //
 // for (; tile_group_idx < num_tile_groups; ++tile_group_idx) {
-//   if (ShouldScanTileGroup(predicate_array, tile_group_idx)) {
+//   if (ShouldScanTileGroup(predicate_array, tile_group_idx) &&
+//       consumer.ShouldScanTileGroup(table_ptr, tile_group_idx)) {
 //      tile_group_ptr := GetTileGroup(table_ptr, tile_group_idx)
 //      consumer.TileGroupStart(tile_group_ptr);
 //      tile_group.TidScan(tile_group_ptr, column_layouts, vector_size,
@@ -102,11 +103,13 @@ void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
     llvm::Value *tile_group_id =
         tile_group_.GetTileGroupId(codegen, tile_group_ptr);
 
-    // Check zone map
+    // Check zone map, and let the consumer prune the tile group
     llvm::Value *cond = codegen.Call(
         ZoneMapManagerProxy::ShouldScanTileGroup,
         {GetZoneMapManager(codegen), predicate_array,
          codegen.Const32(num_predicates), table_ptr, tile_group_idx});
+    cond = codegen->CreateAnd(
+        cond, consumer.ShouldScanTileGroup(codegen, table_ptr, tile_group_idx));
 
     codegen::lang::If should_scan_tilegroup{codegen, cond};
     {
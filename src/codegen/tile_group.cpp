@@ -77,6 +77,19 @@ llvm::Value *TileGroup::GetTileGroupId(CodeGen &codegen,
   return codegen.Call(TileGroupProxy::GetTileGroupId, {tile_group});
 }
 
+// Load the requested columns of a single tuple
+std::vector<codegen::Value> TileGroup::LoadColumns(
+    CodeGen &codegen, llvm::Value *tile_group_ptr, llvm::Value *column_layouts,
+    llvm::Value *tid, const std::vector<oid_t> &column_ids) const {
+  auto col_layouts = GetColumnLayouts(codegen, tile_group_ptr, column_layouts);
+  std::vector<codegen::Value> vals;
+  for (oid_t col_id : column_ids) {
+    PL_ASSERT(col_id < col_layouts.size());
+    vals.push_back(LoadColumn(codegen, tid, col_layouts[col_id]));
+  }
+  return vals;
+}
+
 //===----------------------------------------------------------------------===//
 // Here, we discover the layout of every column that will be accessed. A
 // column's layout includes three pieces of information:
@@ -178,6 +191,66 @@ codegen::Value TileGroup::LoadColumn(
   return codegen::Value{type, val, length, is_null};
 }
 
+//===----------------------------------------------------------------------===//
+// TILE GROUP COLUMN
+//===----------------------------------------------------------------------===//
+
+TileGroup::ColumnAccess::ColumnAccess(const TileGroup &tile_group,
+                                      const TileGroup::ColumnLayout &layout)
+    : tile_group_(tile_group), layout_(layout) {}
+
+// Load a vector of consecutive values of the column. A column in columnar
+// layout is read with a single vector load. The tile only guarantees the
+// alignment of a single value, not of a vector, so the load assumes just the
+// element alignment. Otherwise we load the values one stride apart and insert
+// them into the vector one by one.
+llvm::Value *TileGroup::ColumnAccess::LoadVector(CodeGen &codegen,
+                                                 llvm::Value *tid,
+                                                 uint32_t vector_size) const {
+  llvm::Type *val_type = GetValueType(codegen);
+  llvm::Type *vector_type = llvm::VectorType::get(val_type, vector_size);
+
+  // col[tid] = col_start + (tid * col_stride)
+  llvm::Value *col_address =
+      codegen->CreateInBoundsGEP(codegen.ByteType(), layout_.col_start_ptr,
+                                 codegen->CreateMul(tid, layout_.col_stride));
+
+  llvm::Value *columnar_vec = nullptr, *strided_vec = nullptr;
+  lang::If is_columnar{codegen, layout_.is_columnar, "isColumnar"};
+  {
+    columnar_vec = codegen->CreateAlignedLoad(
+        codegen->CreateBitCast(col_address, vector_type->getPointerTo()),
+        val_type->getPrimitiveSizeInBits() / 8);
+  }
+  is_columnar.ElseBlock();
+  {
+    strided_vec = llvm::UndefValue::get(vector_type);
+    for (uint32_t i = 0; i < vector_size; i++) {
+      llvm::Value *val_address = codegen->CreateInBoundsGEP(
+          codegen.ByteType(), col_address,
+          codegen->CreateMul(codegen.Const32(i), layout_.col_stride));
+      llvm::Value *val = codegen->CreateLoad(
+          val_type,
+          codegen->CreateBitCast(val_address, val_type->getPointerTo()));
+      strided_vec =
+          codegen->CreateInsertElement(strided_vec, val, codegen.Const32(i));
+    }
+  }
+  is_columnar.EndIf();
+  return is_columnar.BuildPHI(columnar_vec, strided_vec);
+}
+
+llvm::Type *TileGroup::ColumnAccess::GetValueType(CodeGen &codegen) const {
+  const auto &column = tile_group_.schema_.GetColumn(layout_.col_id);
+  const auto &sql_type = type::SqlType::LookupType(column.GetType());
+  PL_ASSERT(!sql_type.IsVariableLength());
+
+  llvm::Type *col_type = nullptr, *col_len_type = nullptr;
+  sql_type.GetTypeForMaterialization(codegen, col_type, col_len_type);
+  PL_ASSERT(col_type != nullptr && col_len_type == nullptr);
+  return col_type;
+}
+
 //===----------------------------------------------------------------------===//
 // TILE GROUP ROW
 //===----------------------------------------------------------------------===//
@@ -207,5 +280,11 @@ TileGroup::TileGroupAccess::Row TileGroup::TileGroupAccess::GetRow(
   return TileGroup::TileGroupAccess::Row{tile_group_, layout_, tid};
 }
 
+TileGroup::ColumnAccess TileGroup::TileGroupAccess::GetColumn(
+    uint32_t col_idx) const {
+  PL_ASSERT(col_idx < layout_.size());
+  return TileGroup::ColumnAccess{tile_group_, layout_[col_idx]};
+}
+
 }  // namespace codegen
 }  // namespace peloton
@@ -34,16 +34,59 @@ uint32_t TransactionRuntime::PerformVectorizedRead(
   // Get the tile group header
   auto tile_group_header = tile_group.GetHeader();
 
-  // Check visibility of tuples in the range [tid_start, tid_end), storing all
-  // visible tuple IDs in the provided selection vector
+  cid_t read_id = txn.GetReadId();
   uint32_t out_idx = 0;
-  for (uint32_t i = tid_start; i < tid_end; i++) {
-    // Perform the visibility check
-    auto visibility = txn_manager.IsVisible(&txn, tile_group_header, i);
 
-    // Update the output position
-    selection_vector[out_idx] = i;
-    out_idx += (visibility == VisibilityType::OK);
+  // If every version in the tile group was committed before the transaction
+  // started and none was modified since, all tuples are visible
+  cid_t all_visible_cid = tile_group_header->GetAllVisibleCommitId();
+  if (all_visible_cid != INVALID_CID && all_visible_cid <= read_id) {
+    for (uint32_t i = tid_start; i < tid_end; i++) {
+      selection_vector[out_idx++] = i;
+    }
+    // Read-only transactions do not track their reads
+    if (txn.GetIsolationLevel() == IsolationLevelType::READ_ONLY) {
+      return out_idx;
+    }
+  } else {
+    // Try to compute the watermark while checking a full tile group
+    cid_t token = INVALID_CID;
+    bool marking =
+        tid_start == 0 && tid_end == tile_group.GetAllocatedTupleCount() &&
+        tile_group_header->BeginAllVisible(token);
+    bool all_visible = true;
+    cid_t max_begin_cid = 0;
+
+    // Check visibility of tuples in the range [tid_start, tid_end), storing all
+    // visible tuple IDs in the provided selection vector. Versions that are
+    // not owned by any transaction are checked inline.
+    for (uint32_t i = tid_start; i < tid_end; i++) {
+      txn_id_t txn_id = tile_group_header->GetTransactionId(i);
+      cid_t begin_cid = tile_group_header->GetBeginCommitId(i);
+      cid_t end_cid = tile_group_header->GetEndCommitId(i);
+
+      bool visible;
+      if (txn_id == INITIAL_TXN_ID) {
+        visible = begin_cid <= read_id && read_id < end_cid;
+      } else {
+        // Perform the visibility check
+        visible = txn_manager.IsVisible(&txn, tile_group_header, i) ==
+                  VisibilityType::OK;
+      }
+
+      all_visible &= (txn_id == INITIAL_TXN_ID && end_cid == MAX_CID &&
+                      begin_cid != MAX_CID);
+      max_begin_cid = std::max(max_begin_cid, begin_cid);
+
+      // Update the output position
+      selection_vector[out_idx] = i;
+      out_idx += visible;
+    }
+
+    if (marking) {
+      tile_group_header->EndAllVisible(
+          token, all_visible ? max_begin_cid : INVALID_CID);
+    }
   }
 
   uint32_t tile_group_idx = tile_group.GetTileGroupId();
@@ -18,6 +18,7 @@
 #include "codegen/expression/conjunction_translator.h"
 #include "codegen/expression/constant_translator.h"
 #include "codegen/expression/function_translator.h"
+#include "codegen/expression/in_list_translator.h"
 #include "codegen/expression/negation_translator.h"
 #include "codegen/expression/null_check_translator.h"
 #include "codegen/expression/parameter_translator.h"
@@ -29,6 +30,8 @@
 #include "codegen/operator/hash_join_translator.h"
 #include "codegen/operator/hash_translator.h"
 #include "codegen/operator/insert_translator.h"
+#include "codegen/operator/merge_join_translator.h"
+#include "codegen/operator/nested_loop_index_join_translator.h"
 #include "codegen/operator/order_by_translator.h"
 #include "codegen/operator/projection_translator.h"
 #include "codegen/operator/table_scan_translator.h"
@@ -45,6 +48,8 @@
 #include "planner/hash_join_plan.h"
 #include "planner/hash_plan.h"
 #include "planner/insert_plan.h"
+#include "planner/merge_join_plan.h"
+#include "planner/nested_loop_index_join_plan.h"
 #include "planner/nested_loop_join_plan.h"
 #include "planner/order_by_plan.h"
 #include "planner/projection_plan.h"
@@ -83,6 +88,17 @@ std::unique_ptr<OperatorTranslator> TranslatorFactory::CreateTranslator(
       translator = new BlockNestedLoopJoinTranslator(join, context, pipeline);
       break;
     }
+    case PlanNodeType::MERGEJOIN: {
+      auto &join = static_cast<const planner::MergeJoinPlan &>(plan_node);
+      translator = new MergeJoinTranslator(join, context, pipeline);
+      break;
+    }
+    case PlanNodeType::NESTLOOPINDEX: {
+      auto &join =
+          static_cast<const planner::NestedLoopIndexJoinPlan &>(plan_node);
+      translator = new NestedLoopIndexJoinTranslator(join, context, pipeline);
+      break;
+    }
     case PlanNodeType::HASH: {
       auto &hash = static_cast<const planner::HashPlan &>(plan_node);
       translator = new HashTranslator(hash, context, pipeline);
@@ -170,6 +186,12 @@ std::unique_ptr<ExpressionTranslator> TranslatorFactory::CreateTranslator(
       translator = new ComparisonTranslator(cmp_exp, context);
       break;
     }
+    case ExpressionType::COMPARE_IN: {
+      const auto &in_list_exp =
+          static_cast<const expression::ComparisonExpression &>(exp);
+      translator = new InListTranslator(in_list_exp, context);
+      break;
+    }
     case ExpressionType::CONJUNCTION_AND:
     case ExpressionType::CONJUNCTION_OR: {
       const auto &conjunction_exp =
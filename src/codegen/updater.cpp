@@ -125,12 +125,14 @@ void Updater::Update() {
 
   // Either update in-place
   if (is_owner_ == true) {
+    tile_->InternVarlenValues(old_location_.offset);
     txn_manager.PerformUpdate(txn, old_location_);
     executor_context_->num_processed++;
     return;
   }
 
   // Or, update with a new version
+  tile_->InternVarlenValues(new_location_.offset);
   ContainerTuple<storage::TileGroup> new_tuple(
     table_->GetTileGroupById(new_location_.block).get(), new_location_.offset);
   ItemPointer *indirection =
@@ -157,6 +159,7 @@ void Updater::UpdatePK() {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
 
   // Insert a new tuple
+  tile_->InternVarlenValues(new_location_.offset);
   ContainerTuple<storage::TileGroup> tuple(tile_group, new_location_.offset);
   ItemPointer *index_entry_ptr = nullptr;
   bool result = table_->InsertTuple(&tuple, new_location_, txn,
@@ -14,7 +14,9 @@
 #include "codegen/lang/if.h"
 #include "codegen/lang/loop.h"
 
+#include <atomic>
 #include <cmath>
+#include <limits>
 #include <vector>
 
 #define OPTIMAL_NUM_HASH_FUNC 0
@@ -34,6 +36,16 @@ const double BloomFilter::kFalsePositiveRate = 0.1;
 // Set it to OPTIMAL_NUM_HASH_FUNC to minimize bloom filter memory footprint
 const uint64_t BloomFilter::kNumHashFuncs = 1;
 
+const double BloomFilter::kMaxPassRate = 0.9;
+
+const uint64_t BloomFilter::kSampleSize = 4096;
+
+const uint64_t BloomFilter::kSkipInterval = 64 * 1024;
+
+// The statistics of all filters destroyed so far
+static std::atomic<uint64_t> total_num_probes{0};
+static std::atomic<uint64_t> total_num_misses{0};
+
 //===----------------------------------------------------------------------===//
 // Member Functions
 //===----------------------------------------------------------------------===//
@@ -66,6 +78,16 @@ void BloomFilter::Init(uint64_t estimated_num_tuples) {
   // Initialize Statistics
   num_misses_ = 0;
   num_probes_ = 0;
+
+  // The key range is empty until keys are added
+  min_key_ = std::numeric_limits<int64_t>::max();
+  max_key_ = std::numeric_limits<int64_t>::min();
+
+  // Start out probing
+  sample_probes_ = 0;
+  sample_misses_ = 0;
+  num_skipped_ = 0;
+  probing_ = true;
 }
 
 void BloomFilter::Destroy() {
@@ -73,9 +95,46 @@ void BloomFilter::Destroy() {
   LOG_DEBUG("Bloom Filter, num_probes: %lu, misses: %lu, Selectivity: %f",
             (unsigned long)num_probes_, (unsigned long)num_misses_,
             (double)(num_probes_ - num_misses_) / num_probes_);
+  total_num_probes += num_probes_;
+  total_num_misses += num_misses_;
   delete[] bytes_;
 }
 
+uint64_t BloomFilter::GetTotalNumProbes() { return total_num_probes.load(); }
+
+uint64_t BloomFilter::GetTotalNumMisses() { return total_num_misses.load(); }
+
+bool BloomFilter::ShouldProbe(uint32_t num_tuples) {
+  if (!probing_) {
+    // Sit out a while before sampling the selectivity again, the data may
+    // have changed by then
+    num_skipped_ += num_tuples;
+    if (num_skipped_ < kSkipInterval) {
+      return false;
+    }
+    probing_ = true;
+    sample_probes_ = num_probes_;
+    sample_misses_ = num_misses_;
+    return true;
+  }
+
+  uint64_t probes = num_probes_ - sample_probes_;
+  if (probes >= kSampleSize) {
+    uint64_t passed = probes - (num_misses_ - sample_misses_);
+    if (passed > kMaxPassRate * probes) {
+      // The filter barely filters anything, probing it is a waste of time
+      LOG_DEBUG("Bloom Filter passed %lu of %lu probes, stop probing",
+                (unsigned long)passed, (unsigned long)probes);
+      probing_ = false;
+      num_skipped_ = 0;
+      return false;
+    }
+    sample_probes_ = num_probes_;
+    sample_misses_ = num_misses_;
+  }
+  return true;
+}
+
 }  // namespace util
 }  // namespace codegen
 }  // namespace peloton
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// conjunct_order.cpp
+//
+// Identification: src/codegen/util/conjunct_order.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/util/conjunct_order.h"
+
+#include <algorithm>
+
+#include "common/logger.h"
+#include "common/macros.h"
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+constexpr uint32_t ConjunctOrder::kMaxConjuncts;
+constexpr uint32_t ConjunctOrder::kReorderInterval;
+
+void ConjunctOrder::Init(uint32_t num_conjuncts) {
+  PL_ASSERT(num_conjuncts <= kMaxConjuncts);
+  for (uint32_t i = 0; i < num_conjuncts; i++) {
+    order_[i] = i;
+    num_in_[i] = 0;
+    num_passed_[i] = 0;
+  }
+  num_conjuncts_ = num_conjuncts;
+  num_batches_ = 0;
+}
+
+void ConjunctOrder::Update() {
+  if (++num_batches_ < kReorderInterval) {
+    return;
+  }
+  num_batches_ = 0;
+
+  // The fraction of rows each conjunct passed. Conjuncts that weren't
+  // evaluated on any row recently keep their place at the end.
+  double pass_rate[kMaxConjuncts];
+  for (uint32_t i = 0; i < num_conjuncts_; i++) {
+    pass_rate[i] = num_in_[i] == 0 ? 1.0
+                                   : static_cast<double>(num_passed_[i]) /
+                                         static_cast<double>(num_in_[i]);
+    num_in_[i] /= 2;
+    num_passed_[i] /= 2;
+  }
+  std::stable_sort(order_, order_ + num_conjuncts_,
+                   [&pass_rate](uint32_t left, uint32_t right) {
+                     return pass_rate[left] < pass_rate[right];
+                   });
+  LOG_TRACE("Most selective conjunct: %u (%.3f)", order_[0],
+            pass_rate[order_[0]]);
+}
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,360 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_partitions.cpp
+//
+// Identification: src/codegen/util/hash_partitions.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/util/hash_partitions.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "codegen/util/oa_hash_table.h"
+#include "common/logger.h"
+#include "common/macros.h"
+#include "common/spill_file.h"
+#include "settings/settings_manager.h"
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+constexpr uint32_t HashPartitions::kNumPartitionBits;
+constexpr uint32_t HashPartitions::kNumPartitions;
+constexpr uint64_t HashPartitions::kMinEntriesPerThread;
+constexpr uint32_t HashPartitions::kMaxLevel;
+
+// The initial number of entries each partition has room for
+static constexpr uint64_t kInitialPartitionCapacity = 256;
+
+// The number of bytes read from a spill file at once
+static constexpr uint64_t kSpillReadSize = 64 * 1024;
+
+// The number of helper threads merging partitions, across all queries
+static std::atomic<uint32_t> num_merge_threads{0};
+
+// The number of helper threads ever started, across all queries
+static std::atomic<uint64_t> num_merge_helpers{0};
+
+// Take up to the given number of helper threads out of the budget shared by
+// all queries, returning how many were granted
+static uint32_t ReserveMergeThreads(uint32_t wanted) {
+  int32_t setting = settings::SettingsManager::GetInt(
+      settings::SettingId::aggregation_merge_threads);
+  uint32_t budget = setting > 0 ? static_cast<uint32_t>(setting)
+                                : std::thread::hardware_concurrency();
+
+  uint32_t in_use = num_merge_threads.load();
+  uint32_t granted;
+  do {
+    granted = in_use < budget ? std::min(wanted, budget - in_use) : 0;
+  } while (granted != 0 &&
+           !num_merge_threads.compare_exchange_weak(in_use, in_use + granted));
+  return granted;
+}
+
+uint64_t HashPartitions::GetNumMergeHelpers() {
+  return num_merge_helpers.load();
+}
+
+void HashPartitions::Init(MergeFunction merge_func, uint64_t memory_budget) {
+  merge_func_ = merge_func;
+  partitions_ =
+      static_cast<Partition *>(malloc(sizeof(Partition) * kNumPartitions));
+  for (uint32_t i = 0; i < kNumPartitions; i++) {
+    partitions_[i] = Partition{nullptr, 0, 0, nullptr, 0};
+  }
+  tables_ = nullptr;
+  pre_aggregation_table_ = nullptr;
+  key_size_ = value_size_ = entry_size_ = 0;
+  num_flushed_ = 0;
+  memory_budget_ = memory_budget;
+  partition_bytes_ = 0;
+  pending_runs_ = nullptr;
+  run_table_ = nullptr;
+  num_tables_ = 0;
+  next_table_ = 0;
+}
+
+void HashPartitions::Append(Partition &partition, const char *entry) {
+  if (partition.num_entries == partition.capacity) {
+    uint64_t new_capacity = partition.capacity == 0
+                                ? kInitialPartitionCapacity
+                                : partition.capacity << 1;
+    partition.entries = static_cast<char *>(
+        realloc(partition.entries, new_capacity * entry_size_));
+    PL_ASSERT(partition.entries != nullptr);
+    partition.capacity = new_capacity;
+  }
+  PL_MEMCPY(partition.entries + partition.num_entries * entry_size_, entry,
+            entry_size_);
+  partition.num_entries++;
+  partition_bytes_ += entry_size_;
+}
+
+void HashPartitions::Flush(OAHashTable &table) {
+  LOG_DEBUG("Flushing %llu hash table entries into partitions",
+            (unsigned long long)table.NumEntries());
+
+  key_size_ = table.key_size_;
+  value_size_ = table.value_size_;
+  entry_size_ = table.entry_size_;
+
+  num_flushed_ += table.NumEntries();
+  Distribute(table, 0);
+}
+
+void HashPartitions::Distribute(OAHashTable &table, uint32_t level) {
+  uint64_t processed_count = 0;
+  char *current_entry_char_p = reinterpret_cast<char *>(table.buckets_);
+  while (processed_count < table.num_valid_buckets_) {
+    auto *entry =
+        reinterpret_cast<const OAHashTable::HashEntry *>(current_entry_char_p);
+    if (!entry->IsFree()) {
+      processed_count++;
+
+      // Aggregations store a single value per key
+      PL_ASSERT(!entry->HasKeyValueList());
+      Append(partitions_[PartitionFor(entry->hash, level)],
+             current_entry_char_p);
+    }
+    current_entry_char_p += entry_size_;
+  }
+  table.Clear();
+
+  // Write the partitions to disk once they outgrow the memory budget
+  if (memory_budget_ != 0 && partition_bytes_ > memory_budget_) {
+    Spill();
+  }
+}
+
+void HashPartitions::Spill() {
+  if (pending_runs_ == nullptr) {
+    LOG_DEBUG("Hash partitions exceed the memory budget of %llu bytes",
+              (unsigned long long)memory_budget_);
+    pending_runs_ = new std::vector<Run>();
+  }
+
+  for (uint32_t i = 0; i < kNumPartitions; i++) {
+    Partition &partition = partitions_[i];
+    if (partition.num_entries == 0) {
+      continue;
+    }
+    if (partition.file == nullptr) {
+      partition.file = new SpillFile();
+    }
+    partition.file->Write(partition.entries,
+                          partition.num_entries * entry_size_);
+    partition.num_spilled += partition.num_entries;
+
+    free(partition.entries);
+    partition.entries = nullptr;
+    partition.num_entries = partition.capacity = 0;
+  }
+  partition_bytes_ = 0;
+}
+
+void HashPartitions::SealRuns(uint32_t level) {
+  Spill();
+
+  // Runs are taken from the back, queue them in reverse partition order
+  for (uint32_t i = kNumPartitions; i-- > 0;) {
+    Partition &partition = partitions_[i];
+    if (partition.file == nullptr) {
+      continue;
+    }
+    pending_runs_->push_back(Run{partition.file, partition.num_spilled, level});
+    partition.file = nullptr;
+    partition.num_spilled = 0;
+  }
+}
+
+void HashPartitions::Finish(OAHashTable &table) {
+  if (num_flushed_ == 0) {
+    // The pre-aggregation table never filled up, it has the final result
+    pre_aggregation_table_ = &table;
+    num_tables_ = 1;
+    return;
+  }
+
+  Flush(table);
+  if (!HasSpilled()) {
+    MergePartitions();
+    num_tables_ = kNumPartitions;
+  } else {
+    // The runs are merged one at a time by NextTable()
+    SealRuns(0);
+  }
+}
+
+void HashPartitions::MergePartitions() {
+  // Every partition gets a table sized for the entries flushed into it. The
+  // number of distinct keys can only be smaller.
+  tables_ =
+      static_cast<OAHashTable *>(malloc(sizeof(OAHashTable) * kNumPartitions));
+  for (uint32_t i = 0; i < kNumPartitions; i++) {
+    uint64_t estimated_size =
+        std::max<uint64_t>(partitions_[i].num_entries, 64);
+    tables_[i].Init(key_size_, value_size_, estimated_size);
+  }
+
+  // The thread of the query merges partitions as well, the helper threads
+  // come out of the budget shared by all queries
+  uint32_t num_threads = static_cast<uint32_t>(std::min<uint64_t>(
+      kNumPartitions, num_flushed_ / kMinEntriesPerThread));
+  uint32_t num_helpers = ReserveMergeThreads(std::max(1u, num_threads) - 1);
+
+  LOG_DEBUG("Merging %llu entries in %u partitions with %u helper threads",
+            (unsigned long long)num_flushed_, kNumPartitions, num_helpers);
+
+  // The threads take the next partition to merge until all are merged
+  std::atomic<uint32_t> next_partition{0};
+  std::exception_ptr exception;
+  std::mutex exception_latch;
+  auto merge = [this, &next_partition, &exception, &exception_latch]() {
+    uint32_t idx;
+    while ((idx = next_partition.fetch_add(1)) < kNumPartitions) {
+      Partition &partition = partitions_[idx];
+      try {
+        merge_func_(&tables_[idx], partition.entries, partition.num_entries);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock{exception_latch};
+        if (exception == nullptr) {
+          exception = std::current_exception();
+        }
+        // Let the other threads run out of partitions
+        next_partition = kNumPartitions;
+        return;
+      }
+      free(partition.entries);
+      partition = Partition{nullptr, 0, 0, nullptr, 0};
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < num_helpers; i++) {
+    threads.emplace_back(merge);
+  }
+  merge();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  num_merge_threads -= num_helpers;
+  num_merge_helpers += num_helpers;
+
+  if (exception != nullptr) {
+    std::rethrow_exception(exception);
+  }
+}
+
+bool HashPartitions::MergeRun(const Run &run) {
+  LOG_DEBUG("Merging %llu spilled entries at level %u",
+            (unsigned long long)run.num_entries, run.level);
+
+  // The table is kept at most half full, size it for the run or the budget
+  uint64_t estimated_size = run.num_entries * 2;
+  if (memory_budget_ != 0) {
+    estimated_size = std::min(estimated_size, memory_budget_ / entry_size_);
+  }
+  run_table_ = static_cast<OAHashTable *>(malloc(sizeof(OAHashTable)));
+  run_table_->Init(key_size_, value_size_,
+                   std::max<uint64_t>(estimated_size, 64));
+
+  bool can_split = memory_budget_ != 0 && run.level < kMaxLevel;
+  bool split = false;
+
+  uint64_t chunk_size = std::max<uint64_t>(1, kSpillReadSize / entry_size_);
+  std::vector<char> chunk(chunk_size * entry_size_);
+
+  run.file->Rewind();
+  for (uint64_t remaining = run.num_entries; remaining > 0;) {
+    uint64_t num_entries = std::min(remaining, chunk_size);
+    run.file->ReadExactly(chunk.data(), num_entries * entry_size_);
+    merge_func_(run_table_, chunk.data(), num_entries);
+    remaining -= num_entries;
+
+    // If the groups of the run do not fit into the budget, split the run on
+    // the next bits of the hash values
+    if (can_split &&
+        run_table_->NumEntries() * 2 * entry_size_ > memory_budget_) {
+      split = true;
+      Distribute(*run_table_, run.level + 1);
+    }
+  }
+
+  if (split) {
+    Distribute(*run_table_, run.level + 1);
+    DestroyRunTable();
+    SealRuns(run.level + 1);
+    return false;
+  }
+  return true;
+}
+
+void HashPartitions::DestroyRunTable() {
+  if (run_table_ != nullptr) {
+    run_table_->Destroy();
+    free(run_table_);
+    run_table_ = nullptr;
+  }
+}
+
+OAHashTable *HashPartitions::NextTable() {
+  if (!HasSpilled()) {
+    if (next_table_ == num_tables_) {
+      return nullptr;
+    }
+    uint32_t idx = next_table_++;
+    return tables_ != nullptr ? &tables_[idx] : pre_aggregation_table_;
+  }
+
+  // Merge the next run that fits into the budget
+  DestroyRunTable();
+  while (!pending_runs_->empty()) {
+    Run run = pending_runs_->back();
+    pending_runs_->pop_back();
+    std::unique_ptr<SpillFile> file{run.file};
+    if (MergeRun(run)) {
+      return run_table_;
+    }
+  }
+  return nullptr;
+}
+
+void HashPartitions::Destroy() {
+  for (uint32_t i = 0; i < kNumPartitions; i++) {
+    free(partitions_[i].entries);
+    delete partitions_[i].file;
+  }
+  free(partitions_);
+
+  DestroyRunTable();
+  if (pending_runs_ != nullptr) {
+    for (auto &run : *pending_runs_) {
+      delete run.file;
+    }
+    delete pending_runs_;
+  }
+
+  if (tables_ != nullptr) {
+    for (uint32_t i = 0; i < kNumPartitions; i++) {
+      tables_[i].Destroy();
+    }
+    free(tables_);
+  }
+}
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
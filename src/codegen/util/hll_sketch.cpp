@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hll_sketch.cpp
+//
+// Identification: src/codegen/util/hll_sketch.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/util/hll_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <libcount/empirical_data.h>
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+constexpr uint32_t HllSketch::kPrecision;
+constexpr uint32_t HllSketch::kNumRegisters;
+constexpr uint32_t HllSketch::kSize;
+
+void HllSketch::Init(char *sketch) { std::memset(sketch, 0, kSize); }
+
+void HllSketch::Update(char *sketch, uint64_t hash) {
+  // The hashes we're given aren't always well mixed in their high bits, which
+  // decide the register. Run them through the MurmurHash3 finalizer first.
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+
+  // The leading bits pick the register, the register keeps the longest run of
+  // leading zeros (plus one) seen in the remaining bits
+  uint32_t index = static_cast<uint32_t>(hash >> (64 - kPrecision));
+  uint64_t rest = hash << kPrecision;
+  uint8_t rank = static_cast<uint8_t>(
+      rest == 0 ? 64 - kPrecision + 1 : __builtin_clzll(rest) + 1);
+
+  auto *registers = reinterpret_cast<uint8_t *>(sketch);
+  if (rank > registers[index]) {
+    registers[index] = rank;
+  }
+}
+
+void HllSketch::Merge(char *sketch, const char *other) {
+  auto *registers = reinterpret_cast<uint8_t *>(sketch);
+  const auto *other_registers = reinterpret_cast<const uint8_t *>(other);
+  for (uint32_t i = 0; i < kNumRegisters; i++) {
+    registers[i] = std::max(registers[i], other_registers[i]);
+  }
+}
+
+// This mirrors libcount::HLL::Estimate()
+uint64_t HllSketch::Estimate(const char *sketch) {
+  const auto *registers = reinterpret_cast<const uint8_t *>(sketch);
+  const double m = static_cast<double>(kNumRegisters);
+
+  // The raw estimate is the scaled harmonic mean of 2^register
+  double sum = 0.0;
+  uint32_t num_zero = 0;
+  for (uint32_t i = 0; i < kNumRegisters; i++) {
+    sum += std::ldexp(1.0, -registers[i]);
+    num_zero += (registers[i] == 0);
+  }
+  const double raw = libcount::EmpiricalAlpha(kPrecision) * m * (m / sum);
+
+  // Small raw estimates are bias corrected
+  const double corrected =
+      raw < 5 * m ? raw - libcount::EmpiricalBias(raw, kPrecision) : raw;
+
+  // Fall back to linear counting while there are empty registers
+  double estimate = corrected;
+  if (num_zero != 0) {
+    estimate = m * std::log(m / num_zero);
+  }
+  if (estimate >= libcount::EmpiricalThreshold(kPrecision)) {
+    estimate = corrected;
+  }
+  return static_cast<uint64_t>(std::max(estimate, 0.0) + 0.5);
+}
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
@@ -358,6 +358,33 @@ void OAHashTable::Resize(HashEntry **entry_p_p) {
   buckets_ = reinterpret_cast<HashEntry *>(new_buckets);
 }
 
+//===----------------------------------------------------------------------===//
+// Remove all entries from the hash table. The overflow kv lists are freed, but
+// the buckets array is kept at its current size for reuse.
+//===----------------------------------------------------------------------===//
+void OAHashTable::Clear() {
+  uint64_t processed_count = 0;
+  char *current_entry_char_p = reinterpret_cast<char *>(buckets_);
+
+  while (processed_count < num_valid_buckets_) {
+    HashEntry *current_entry_p =
+        reinterpret_cast<HashEntry *>(current_entry_char_p);
+
+    if (!current_entry_p->IsFree()) {
+      processed_count++;
+
+      if (current_entry_p->HasKeyValueList()) {
+        free(current_entry_p->kv_list);
+      }
+      current_entry_p->status = HashEntry::StatusCode::FREE;
+    }
+
+    current_entry_char_p += entry_size_;
+  }
+
+  num_entries_ = num_valid_buckets_ = 0;
+}
+
 //===----------------------------------------------------------------------===//
 // Clean up any resources this hash table has
 //
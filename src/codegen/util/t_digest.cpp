@@ -0,0 +1,230 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// t_digest.cpp
+//
+// Identification: src/codegen/util/t_digest.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/util/t_digest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+constexpr double TDigest::kCompression;
+constexpr uint32_t TDigest::kMaxCentroids;
+constexpr uint32_t TDigest::kBufferSize;
+constexpr uint32_t TDigest::kCentroidsOffset;
+constexpr uint32_t TDigest::kBufferOffset;
+constexpr uint32_t TDigest::kSize;
+
+namespace {
+
+// The k1 scale function, k(q) = δ/(2π) * asin(2q - 1), and its inverse
+double ScaleOf(double q) {
+  return TDigest::kCompression / (2 * M_PI) * std::asin(2 * q - 1);
+}
+
+double QuantileOf(double k) {
+  if (k >= TDigest::kCompression / 4) {
+    return 1.0;
+  }
+  return (std::sin(k * 2 * M_PI / TDigest::kCompression) + 1) / 2;
+}
+
+}  // namespace
+
+void TDigest::Init(char *digest) {
+  Header header{0.0, std::numeric_limits<double>::infinity(),
+                -std::numeric_limits<double>::infinity(), 0, 0};
+  std::memcpy(digest, &header, sizeof(Header));
+}
+
+void TDigest::Add(char *digest, double value) {
+  char *num_buffered_ptr = digest + offsetof(Header, num_buffered);
+  uint32_t num_buffered;
+  std::memcpy(&num_buffered, num_buffered_ptr, sizeof(uint32_t));
+  if (num_buffered >= kBufferSize) {
+    Compress(digest);
+    num_buffered = 0;
+  }
+  std::memcpy(digest + kBufferOffset + num_buffered * sizeof(double), &value,
+              sizeof(double));
+  num_buffered++;
+  std::memcpy(num_buffered_ptr, &num_buffered, sizeof(uint32_t));
+
+  if (num_buffered == kBufferSize) {
+    Compress(digest);
+  }
+}
+
+void TDigest::Merge(char *digest, const char *other) {
+  Header header{0.0, std::numeric_limits<double>::infinity(),
+                -std::numeric_limits<double>::infinity(), 0, 0};
+  Centroid centroids[2 * (kMaxCentroids + kBufferSize)];
+  uint32_t num_centroids = Gather(digest, centroids, header);
+  num_centroids += Gather(other, centroids + num_centroids, header);
+  Store(digest, header, centroids, num_centroids);
+}
+
+bool TDigest::IsEmpty(const char *digest) {
+  Header header;
+  std::memcpy(&header, digest, sizeof(Header));
+  return header.num_centroids == 0 && header.num_buffered == 0;
+}
+
+double TDigest::Quantile(char *digest, double quantile) {
+  Compress(digest);
+
+  Header header;
+  std::memcpy(&header, digest, sizeof(Header));
+  header.num_centroids = std::min(header.num_centroids, kMaxCentroids);
+  if (header.num_centroids == 0) {
+    return 0.0;
+  }
+
+  Centroid centroids[kMaxCentroids];
+  std::memcpy(centroids, digest + kCentroidsOffset,
+              header.num_centroids * sizeof(Centroid));
+
+  uint32_t n = header.num_centroids;
+  double index = std::min(std::max(quantile, 0.0), 1.0) * header.weight;
+  if (n == 1 || index <= 0.0) {
+    return n == 1 ? centroids[0].mean : header.min;
+  }
+
+  // Each centroid's weight is centered on its mean. Left of the first mean we
+  // interpolate towards the minimum, right of the last one towards the maximum,
+  // and between two means linearly.
+  double weight_so_far = centroids[0].weight / 2;
+  if (index < weight_so_far) {
+    return header.min +
+           (centroids[0].mean - header.min) * (index / weight_so_far);
+  }
+  for (uint32_t i = 0; i + 1 < n; i++) {
+    double delta = (centroids[i].weight + centroids[i + 1].weight) / 2;
+    if (index < weight_so_far + delta) {
+      double fraction = (index - weight_so_far) / delta;
+      return centroids[i].mean +
+             (centroids[i + 1].mean - centroids[i].mean) * fraction;
+    }
+    weight_so_far += delta;
+  }
+  double half = centroids[n - 1].weight / 2;
+  double fraction = std::min((index - weight_so_far) / half, 1.0);
+  return centroids[n - 1].mean +
+         (header.max - centroids[n - 1].mean) * fraction;
+}
+
+uint32_t TDigest::NumCentroids(const char *digest) {
+  uint32_t num_centroids;
+  std::memcpy(&num_centroids, digest + offsetof(Header, num_centroids),
+              sizeof(uint32_t));
+  return num_centroids;
+}
+
+uint32_t TDigest::Gather(const char *digest, Centroid *centroids,
+                         Header &header) {
+  Header other;
+  std::memcpy(&other, digest, sizeof(Header));
+  other.num_centroids = std::min(other.num_centroids, kMaxCentroids);
+  other.num_buffered = std::min(other.num_buffered, kBufferSize);
+
+  std::memcpy(centroids, digest + kCentroidsOffset,
+              other.num_centroids * sizeof(Centroid));
+  header.weight += other.weight;
+  header.min = std::min(header.min, other.min);
+  header.max = std::max(header.max, other.max);
+
+  uint32_t num_centroids = other.num_centroids;
+  for (uint32_t i = 0; i < other.num_buffered; i++) {
+    double value;
+    std::memcpy(&value, digest + kBufferOffset + i * sizeof(double),
+                sizeof(double));
+    centroids[num_centroids++] = Centroid{value, 1.0};
+    header.weight += 1.0;
+    header.min = std::min(header.min, value);
+    header.max = std::max(header.max, value);
+  }
+  return num_centroids;
+}
+
+void TDigest::Store(char *digest, Header &header, Centroid *centroids,
+                    uint32_t num_centroids) {
+  std::sort(centroids, centroids + num_centroids,
+            [](const Centroid &left, const Centroid &right) {
+              return left.mean < right.mean;
+            });
+
+  // Greedily merge neighbouring centroids as long as the merged centroid spans
+  // at most one unit of the scale function
+  uint32_t num_merged = 0;
+  if (num_centroids > 0) {
+    double weight_so_far = 0.0;
+    double limit = header.weight * QuantileOf(ScaleOf(0.0) + 1);
+    Centroid current = centroids[0];
+    for (uint32_t i = 1; i < num_centroids; i++) {
+      const Centroid &next = centroids[i];
+      if (weight_so_far + current.weight + next.weight <= limit) {
+        current.weight += next.weight;
+        current.mean +=
+            (next.mean - current.mean) * next.weight / current.weight;
+      } else {
+        weight_so_far += current.weight;
+        limit = header.weight *
+                QuantileOf(ScaleOf(weight_so_far / header.weight) + 1);
+        centroids[num_merged++] = current;
+        current = next;
+      }
+    }
+    centroids[num_merged++] = current;
+  }
+
+  // Rounding in the scale function can leave a few centroids more than the
+  // digest has room for. Fold the lightest neighbouring pair until they fit.
+  while (num_merged > kMaxCentroids) {
+    uint32_t lightest = 0;
+    for (uint32_t i = 1; i + 1 < num_merged; i++) {
+      if (centroids[i].weight + centroids[i + 1].weight <
+          centroids[lightest].weight + centroids[lightest + 1].weight) {
+        lightest = i;
+      }
+    }
+    Centroid &left = centroids[lightest];
+    const Centroid &right = centroids[lightest + 1];
+    left.weight += right.weight;
+    left.mean += (right.mean - left.mean) * right.weight / left.weight;
+    std::memmove(centroids + lightest + 1, centroids + lightest + 2,
+                 (num_merged - lightest - 2) * sizeof(Centroid));
+    num_merged--;
+  }
+
+  header.num_centroids = num_merged;
+  header.num_buffered = 0;
+  std::memcpy(digest, &header, sizeof(Header));
+  std::memcpy(digest + kCentroidsOffset, centroids,
+              num_merged * sizeof(Centroid));
+}
+
+void TDigest::Compress(char *digest) {
+  Header header{0.0, std::numeric_limits<double>::infinity(),
+                -std::numeric_limits<double>::infinity(), 0, 0};
+  Centroid centroids[kMaxCentroids + kBufferSize];
+  uint32_t num_centroids = Gather(digest, centroids, header);
+  Store(digest, header, centroids, num_centroids);
+}
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
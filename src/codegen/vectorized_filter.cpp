@@ -0,0 +1,401 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// vectorized_filter.cpp
+//
+// Identification: src/codegen/vectorized_filter.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/vectorized_filter.h"
+
+#include <unordered_set>
+
+#include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
+#include "codegen/proxy/conjunct_order_proxy.h"
+#include "codegen/type/sql_type.h"
+#include "codegen/util/conjunct_order.h"
+#include "common/exception.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/attribute_info.h"
+
+namespace peloton {
+namespace codegen {
+
+namespace {
+
+bool IsIntegral(peloton::type::TypeId type_id) {
+  switch (type_id) {
+    case peloton::type::TypeId::TINYINT:
+    case peloton::type::TypeId::SMALLINT:
+    case peloton::type::TypeId::INTEGER:
+    case peloton::type::TypeId::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The type a column of the given type and a value of the other type can be
+// compared as inside a kernel, INVALID if they can't
+peloton::type::TypeId CompareType(peloton::type::TypeId column_type,
+                                  peloton::type::TypeId value_type) {
+  if (IsIntegral(column_type) && IsIntegral(value_type)) {
+    return column_type == value_type ? column_type
+                                     : peloton::type::TypeId::BIGINT;
+  }
+  switch (column_type) {
+    case peloton::type::TypeId::DATE:
+    case peloton::type::TypeId::TIMESTAMP:
+      return column_type == value_type ? column_type
+                                       : peloton::type::TypeId::INVALID;
+    case peloton::type::TypeId::DECIMAL:
+      return value_type == peloton::type::TypeId::DECIMAL ||
+                     IsIntegral(value_type)
+                 ? peloton::type::TypeId::DECIMAL
+                 : peloton::type::TypeId::INVALID;
+    default:
+      return peloton::type::TypeId::INVALID;
+  }
+}
+
+// The comparison with its sides swapped
+ExpressionType MirrorComparison(ExpressionType type) {
+  switch (type) {
+    case ExpressionType::COMPARE_LESSTHAN:
+      return ExpressionType::COMPARE_GREATERTHAN;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return ExpressionType::COMPARE_LESSTHAN;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return ExpressionType::COMPARE_LESSTHANOREQUALTO;
+    default:
+      return type;
+  }
+}
+
+}  // namespace
+
+constexpr uint32_t VectorizedFilter::kVectorWidth;
+
+VectorizedFilter::VectorizedFilter(
+    const expression::AbstractExpression *predicate) {
+  if (predicate != nullptr) {
+    CollectConjuncts(*predicate);
+  }
+}
+
+void VectorizedFilter::CollectConjuncts(
+    const expression::AbstractExpression &exp) {
+  if (exp.GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    for (uint32_t i = 0; i < exp.GetChildrenSize(); i++) {
+      CollectConjuncts(*exp.GetChild(i));
+    }
+    return;
+  }
+
+  Term term;
+  if (terms_.size() < util::ConjunctOrder::kMaxConjuncts &&
+      MakeTerm(exp, term)) {
+    terms_.push_back(term);
+  } else {
+    residual_.push_back(&exp);
+  }
+}
+
+bool VectorizedFilter::MakeTerm(const expression::AbstractExpression &conjunct,
+                                Term &term) {
+  switch (conjunct.GetExpressionType()) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      return false;
+  }
+
+  for (uint32_t i = 0; i < 2; i++) {
+    const auto *column = conjunct.GetChild(i);
+    const auto *value = conjunct.GetChild(1 - i);
+    if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+      continue;
+    }
+
+    // The value mustn't change from row to row
+    std::unordered_set<const planner::AttributeInfo *> used_attributes;
+    value->GetUsedAttributes(used_attributes);
+    if (!used_attributes.empty()) {
+      continue;
+    }
+
+    const auto *ai =
+        static_cast<const expression::TupleValueExpression *>(column)
+            ->GetAttributeRef();
+    auto compare_type = CompareType(ai->type.type_id, value->GetValueType());
+    if (compare_type == peloton::type::TypeId::INVALID) {
+      continue;
+    }
+
+    term.column = ai;
+    term.comparison = i == 0
+                          ? conjunct.GetExpressionType()
+                          : MirrorComparison(conjunct.GetExpressionType());
+    term.value = value;
+    term.compare_type = compare_type;
+    return true;
+  }
+  return false;
+}
+
+void VectorizedFilter::Filter(CodeGen &codegen,
+                              const TileGroup::TileGroupAccess &access,
+                              RowBatch::Row &row, llvm::Value *conjunct_order,
+                              llvm::Value *tid_start, llvm::Value *tid_end,
+                              Vector &selection_vector) const {
+  PL_ASSERT(HasKernels());
+
+  // The byte map of the rows in [tid_start, tid_end) that are still valid
+  llvm::Value *mask = codegen.AllocateBuffer(
+      codegen.ByteType(), selection_vector.GetCapacity(), "filterMask");
+  codegen->CreateMemSet(mask, codegen.Const8(0),
+                        codegen->CreateSub(tid_end, tid_start), 1);
+
+  // Mark the rows in the selection vector
+  llvm::Value *num_rows = selection_vector.GetNumElements();
+  lang::Loop mark_loop{codegen,
+                       codegen->CreateICmpULT(codegen.Const32(0), num_rows),
+                       {{"markPos", codegen.Const32(0)}}};
+  {
+    llvm::Value *pos = mark_loop.GetLoopVar(0);
+    llvm::Value *tid = selection_vector.GetValue(codegen, pos);
+    llvm::Value *mask_pos = codegen->CreateInBoundsGEP(
+        codegen.ByteType(), mask, codegen->CreateSub(tid, tid_start));
+    codegen->CreateStore(codegen.Const8(1), mask_pos);
+    pos = codegen->CreateAdd(pos, codegen.Const32(1));
+    mark_loop.LoopEnd(codegen->CreateICmpULT(pos, num_rows), {pos});
+  }
+
+  // Derive the values the columns are compared with once for the whole batch
+  std::vector<KernelValue> values;
+  for (const auto &term : terms_) {
+    codegen::Value value = row.DeriveValue(codegen, *term.value);
+    if (value.GetType().type_id != term.compare_type) {
+      value = value.CastTo(
+          codegen, type::Type{type::SqlType::LookupType(term.compare_type),
+                              value.IsNullable()});
+    }
+    values.push_back(KernelValue{
+        value.GetValue(),
+        value.IsNullable() ? value.IsNull(codegen) : nullptr});
+  }
+
+  // Run the kernels in the order the conjunct order currently prescribes
+  auto *order_type = ConjunctOrderProxy::GetType(codegen);
+  lang::Loop kernel_loop{codegen,
+                         codegen.ConstBool(true),
+                         {{"kernelPos", codegen.Const32(0)}}};
+  {
+    llvm::Value *pos = kernel_loop.GetLoopVar(0);
+    llvm::Value *kernel_id = codegen->CreateLoad(codegen->CreateInBoundsGEP(
+        order_type, conjunct_order, {codegen.Const32(0), codegen.Const32(0),
+                                     pos}));
+    for (uint32_t i = 0; i < NumKernels(); i++) {
+      lang::If is_kernel{codegen,
+                         codegen->CreateICmpEQ(kernel_id, codegen.Const32(i))};
+      {
+        // Full vectors first, then the remaining rows one at a time
+        llvm::Value *tid = tid_start;
+        llvm::Value *num_in = codegen.Const64(0);
+        llvm::Value *num_passed = codegen.Const64(0);
+        GenerateKernelLoop(codegen, access, terms_[i], values[i], mask,
+                           tid_start, tid_end, kVectorWidth, tid, num_in,
+                           num_passed);
+        GenerateKernelLoop(codegen, access, terms_[i], values[i], mask,
+                           tid_start, tid_end, 1, tid, num_in, num_passed);
+
+        // Record the selectivity of the conjunct
+        for (const auto &count :
+             {std::make_pair(1u, num_in), std::make_pair(2u, num_passed)}) {
+          llvm::Value *count_ptr = codegen->CreateInBoundsGEP(
+              order_type, conjunct_order,
+              {codegen.Const32(0), codegen.Const32(count.first),
+               codegen.Const32(i)});
+          codegen->CreateStore(
+              codegen->CreateAdd(codegen->CreateLoad(count_ptr), count.second),
+              count_ptr);
+        }
+      }
+      is_kernel.EndIf();
+    }
+    pos = codegen->CreateAdd(pos, codegen.Const32(1));
+    kernel_loop.LoopEnd(
+        codegen->CreateICmpULT(pos, codegen.Const32(NumKernels())), {pos});
+  }
+  codegen.Call(ConjunctOrderProxy::Update, {conjunct_order});
+
+  // Compact the selection vector without branching on the validity
+  lang::Loop compact_loop{
+      codegen,
+      codegen->CreateICmpULT(codegen.Const32(0), num_rows),
+      {{"readPos", codegen.Const32(0)}, {"writePos", codegen.Const32(0)}}};
+  {
+    llvm::Value *read_pos = compact_loop.GetLoopVar(0);
+    llvm::Value *write_pos = compact_loop.GetLoopVar(1);
+    llvm::Value *tid = selection_vector.GetValue(codegen, read_pos);
+    selection_vector.SetValue(codegen, write_pos, tid);
+    llvm::Value *valid = codegen->CreateLoad(codegen->CreateInBoundsGEP(
+        codegen.ByteType(), mask, codegen->CreateSub(tid, tid_start)));
+    write_pos = codegen->CreateAdd(
+        write_pos, codegen->CreateZExt(valid, codegen.Int32Type()));
+    read_pos = codegen->CreateAdd(read_pos, codegen.Const32(1));
+    compact_loop.LoopEnd(codegen->CreateICmpULT(read_pos, num_rows),
+                         {read_pos, write_pos});
+  }
+
+  std::vector<llvm::Value *> final_vals;
+  compact_loop.CollectFinalLoopVariables(final_vals);
+  selection_vector.SetNumElements(final_vals[1]);
+}
+
+void VectorizedFilter::GenerateKernelLoop(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    const Term &term, const KernelValue &value, llvm::Value *mask,
+    llvm::Value *tid_start, llvm::Value *tid_end, uint32_t width,
+    llvm::Value *&tid, llvm::Value *&num_in, llvm::Value *&num_passed) const {
+  llvm::Type *mask_type = llvm::VectorType::get(codegen.ByteType(), width);
+  llvm::Type *bits_type = codegen.ByteType();
+  if (width > 1) {
+    bits_type = llvm::Type::getIntNTy(codegen.GetContext(), 8 * width);
+  }
+  llvm::Value *zero_bits = llvm::ConstantInt::get(bits_type, 0);
+
+  llvm::Value *vector_end = codegen->CreateAdd(tid, codegen.Const32(width));
+  lang::Loop loop{codegen,
+                  codegen->CreateICmpULE(vector_end, tid_end),
+                  {{"tid", tid}, {"numIn", num_in}, {"numPassed", num_passed}}};
+  {
+    llvm::Value *curr_tid = loop.GetLoopVar(0);
+    llvm::Value *curr_in = loop.GetLoopVar(1);
+    llvm::Value *curr_passed = loop.GetLoopVar(2);
+
+    // The validity of the rows in the vector so far
+    llvm::Value *mask_ptr = codegen->CreateBitCast(
+        codegen->CreateInBoundsGEP(codegen.ByteType(), mask,
+                                   codegen->CreateSub(curr_tid, tid_start)),
+        mask_type->getPointerTo());
+    llvm::Value *valid = codegen->CreateAlignedLoad(mask_ptr, 1);
+    llvm::Value *valid_bits = codegen->CreateBitCast(valid, bits_type);
+
+    // Only run the kernel if some rows in the vector are still valid
+    llvm::Value *in = nullptr, *passed = nullptr;
+    lang::If any_valid{codegen, codegen->CreateICmpNE(valid_bits, zero_bits)};
+    {
+      llvm::Value *result =
+          GenerateKernel(codegen, access, term, value, curr_tid, width);
+      llvm::Value *new_valid =
+          codegen->CreateAnd(valid, codegen->CreateZExt(result, mask_type));
+      codegen->CreateAlignedStore(new_valid, mask_ptr, 1);
+      in = codegen.PopCount(valid_bits);
+      passed = codegen.PopCount(codegen->CreateBitCast(new_valid, bits_type));
+    }
+    any_valid.EndIf();
+    in = any_valid.BuildPHI(in, zero_bits);
+    passed = any_valid.BuildPHI(passed, zero_bits);
+
+    curr_in = codegen->CreateAdd(
+        curr_in, codegen->CreateZExt(in, codegen.Int64Type()));
+    curr_passed = codegen->CreateAdd(
+        curr_passed, codegen->CreateZExt(passed, codegen.Int64Type()));
+    curr_tid = codegen->CreateAdd(curr_tid, codegen.Const32(width));
+    loop.LoopEnd(
+        codegen->CreateICmpULE(
+            codegen->CreateAdd(curr_tid, codegen.Const32(width)), tid_end),
+        {curr_tid, curr_in, curr_passed});
+  }
+
+  std::vector<llvm::Value *> final_vals;
+  loop.CollectFinalLoopVariables(final_vals);
+  tid = final_vals[0];
+  num_in = final_vals[1];
+  num_passed = final_vals[2];
+}
+
+llvm::Value *VectorizedFilter::GenerateKernel(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    const Term &term, const KernelValue &value, llvm::Value *tid,
+    uint32_t width) const {
+  const auto *ai = term.column;
+  bool is_decimal = term.compare_type == peloton::type::TypeId::DECIMAL;
+
+  llvm::Value *vals =
+      access.GetColumn(ai->attribute_id).LoadVector(codegen, tid, width);
+
+  // NULLs are stored as the type's sentinel and never pass the comparison
+  llvm::Value *not_null = nullptr;
+  if (ai->type.nullable) {
+    const auto &sql_type = type::SqlType::LookupType(ai->type.type_id);
+    llvm::Value *nulls = codegen->CreateVectorSplat(
+        width, sql_type.GetNullValue(codegen).GetValue());
+    not_null = is_decimal ? codegen->CreateFCmpONE(vals, nulls)
+                          : codegen->CreateICmpNE(vals, nulls);
+  }
+
+  // Integers of different widths are compared as BIGINTs
+  if (term.compare_type != ai->type.type_id) {
+    vals = codegen->CreateSExt(
+        vals, llvm::VectorType::get(codegen.Int64Type(), width));
+  }
+
+  llvm::Value *others = codegen->CreateVectorSplat(width, value.value);
+  llvm::Value *result = nullptr;
+  switch (term.comparison) {
+    case ExpressionType::COMPARE_EQUAL:
+      result = is_decimal ? codegen->CreateFCmpOEQ(vals, others)
+                          : codegen->CreateICmpEQ(vals, others);
+      break;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      result = is_decimal ? codegen->CreateFCmpONE(vals, others)
+                          : codegen->CreateICmpNE(vals, others);
+      break;
+    case ExpressionType::COMPARE_LESSTHAN:
+      result = is_decimal ? codegen->CreateFCmpOLT(vals, others)
+                          : codegen->CreateICmpSLT(vals, others);
+      break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      result = is_decimal ? codegen->CreateFCmpOLE(vals, others)
+                          : codegen->CreateICmpSLE(vals, others);
+      break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      result = is_decimal ? codegen->CreateFCmpOGT(vals, others)
+                          : codegen->CreateICmpSGT(vals, others);
+      break;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      result = is_decimal ? codegen->CreateFCmpOGE(vals, others)
+                          : codegen->CreateICmpSGE(vals, others);
+      break;
+    default:
+      throw Exception{"Unexpected comparison in vectorized filter: " +
+                      ExpressionTypeToString(term.comparison)};
+  }
+
+  if (not_null != nullptr) {
+    result = codegen->CreateAnd(result, not_null);
+  }
+  if (value.is_null != nullptr) {
+    result = codegen->CreateAnd(
+        result,
+        codegen->CreateVectorSplat(width, codegen->CreateNot(value.is_null)));
+  }
+  return result;
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -17,6 +17,7 @@
 
 #include "brain/index_tuner.h"
 #include "brain/layout_tuner.h"
+#include "brain/tiering_tuner.h"
 #include "catalog/catalog.h"
 #include "common/statement_cache_manager.h"
 #include "common/thread_pool.h"
@@ -72,6 +73,12 @@ void PelotonInit::Initialize() {
     layout_tuner.Start();
   }
 
+  // start tiering tuner
+  if (settings::SettingsManager::GetBool(settings::SettingId::tiering_tuner)) {
+    auto &tiering_tuner = brain::TieringTuner::GetInstance();
+    tiering_tuner.Start();
+  }
+
   // Initialize catalog
   auto pg_catalog = catalog::Catalog::GetInstance();
   pg_catalog->Bootstrap();  // Additional catalogs
@@ -104,6 +111,12 @@ void PelotonInit::Shutdown() {
     layout_tuner.Stop();
   }
 
+  // shut down tiering tuner
+  if (settings::SettingsManager::GetBool(settings::SettingId::tiering_tuner)) {
+    auto &tiering_tuner = brain::TieringTuner::GetInstance();
+    tiering_tuner.Stop();
+  }
+
   // shut down GC.
   gc::GCManagerFactory::GetInstance().StopGC();
 
@@ -113,10 +126,12 @@ void PelotonInit::Shutdown() {
   // stop worker pool
   threadpool::MonoQueuePool::GetInstance().Shutdown();
 
-  // stop brain thread pool
-  if (settings::SettingsManager::GetBool(settings::SettingId::brain)) {
-    threadpool::MonoQueuePool::GetBrainInstance().Shutdown();
-  }
+  // stop brain thread pool. It also runs the background recompilations of hot
+  // queries, so it may be running even without the brain.
+  threadpool::MonoQueuePool::GetBrainInstance().Shutdown();
+
+  // stop optimizer thread pool, which is started by the first large join
+  threadpool::MonoQueuePool::GetOptimizerInstance().Shutdown();
 
   thread_pool.Shutdown();
 
@@ -943,6 +943,12 @@ std::string ExpressionTypeToString(ExpressionType type, bool short_str) {
     case ExpressionType::AGGREGATE_AVG: {
       return ("AGGREGATE_AVG");
     }
+    case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT: {
+      return ("AGGREGATE_APPROX_COUNT_DISTINCT");
+    }
+    case ExpressionType::AGGREGATE_APPROX_PERCENTILE: {
+      return ("AGGREGATE_APPROX_PERCENTILE");
+    }
     case ExpressionType::FUNCTION: {
       return ("FUNCTION");
     }
@@ -1002,6 +1008,10 @@ ExpressionType ParserExpressionNameToExpressionType(const std::string &str) {
     return ExpressionType::AGGREGATE_MAX;
   } else if (str == "min") {
     return ExpressionType::AGGREGATE_MIN;
+  } else if (str == "approx_count_distinct") {
+    return ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT;
+  } else if (str == "approx_percentile") {
+    return ExpressionType::AGGREGATE_APPROX_PERCENTILE;
   }
   return ExpressionType::INVALID;
 }
@@ -1083,6 +1093,10 @@ ExpressionType StringToExpressionType(const std::string &str) {
     return ExpressionType::AGGREGATE_MAX;
   } else if (upper_str == "AGGREGATE_AVG") {
     return ExpressionType::AGGREGATE_AVG;
+  } else if (upper_str == "AGGREGATE_APPROX_COUNT_DISTINCT") {
+    return ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT;
+  } else if (upper_str == "AGGREGATE_APPROX_PERCENTILE") {
+    return ExpressionType::AGGREGATE_APPROX_PERCENTILE;
   } else if (upper_str == "FUNCTION") {
     return ExpressionType::FUNCTION;
   } else if (upper_str == "HASH_RANGE") {
@@ -1576,6 +1590,9 @@ std::string JoinTypeToString(JoinType type) {
     case JoinType::SEMI: {
       return "SEMI";
     }
+    case JoinType::ANTI: {
+      return "ANTI";
+    }
     default: {
       throw ConversionException(
           StringUtil::Format("No string conversion for JoinType value '%d'",
@@ -1599,6 +1616,8 @@ JoinType StringToJoinType(const std::string &str) {
     return JoinType::OUTER;
   } else if (upper_str == "SEMI") {
     return JoinType::SEMI;
+  } else if (upper_str == "ANTI") {
+    return JoinType::ANTI;
   } else {
     throw ConversionException(StringUtil::Format(
         "No JoinType conversion from string '%s'", upper_str.c_str()));
@@ -2694,6 +2713,34 @@ std::ostream &operator<<(std::ostream &os, const LayoutType &type) {
   return os;
 }
 
+std::string ColumnEncodingTypeToString(ColumnEncodingType type) {
+  switch (type) {
+    case ColumnEncodingType::INVALID: {
+      return "INVALID";
+    }
+    case ColumnEncodingType::DICTIONARY: {
+      return "DICTIONARY";
+    }
+    case ColumnEncodingType::RUN_LENGTH: {
+      return "RUN_LENGTH";
+    }
+    case ColumnEncodingType::FRAME_OF_REFERENCE: {
+      return "FRAME_OF_REFERENCE";
+    }
+    default: {
+      throw ConversionException(StringUtil::Format(
+          "No string conversion for ColumnEncodingType value '%d'",
+          static_cast<int>(type)));
+    }
+  }
+  return "INVALID";
+}
+
+std::ostream &operator<<(std::ostream &os, const ColumnEncodingType &type) {
+  os << ColumnEncodingTypeToString(type);
+  return os;
+}
+
 type::TypeId PostgresValueTypeToPelotonValueType(PostgresValueType type) {
   switch (type) {
     case PostgresValueType::BOOLEAN:
@@ -0,0 +1,361 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache.cpp
+//
+// Identification: src/common/plan_cache.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/plan_cache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+#include "type/value_factory.h"
+
+namespace peloton {
+
+namespace {
+
+inline bool IsIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Does the normalized text so far end with a comparison operator?
+bool FollowsComparison(const std::string &normalized_query) {
+  auto last = normalized_query.find_last_not_of(' ');
+  if (last == std::string::npos) {
+    return false;
+  }
+  char c = normalized_query[last];
+  return c == '=' || c == '<' || c == '>';
+}
+
+// Is the literal ending at the given position cast to another type?
+bool IsCast(const std::string &query, size_t pos) {
+  while (pos < query.size() &&
+         std::isspace(static_cast<unsigned char>(query[pos]))) {
+    pos++;
+  }
+  return query.compare(pos, 2, "::") == 0;
+}
+
+// The value the parser creates for the numeric literal
+type::Value GetNumericValue(const std::string &literal, bool is_integral) {
+  // Integers that do not fit into 32 bits are parsed as decimals
+  if (is_integral && literal.size() < 11) {
+    int64_t value = std::stoll(literal);
+    if (value <= std::numeric_limits<int32_t>::max()) {
+      return type::ValueFactory::GetIntegerValue(static_cast<int32_t>(value));
+    }
+  }
+  return type::ValueFactory::GetDecimalValue(std::stod(literal));
+}
+
+// Could the quoted literal be a date, a timestamp or a number? The planner
+// casts those to the type of the column they are compared with, while a
+// parameter would keep the VARCHAR type.
+bool MayBeCast(const std::string &value) {
+  auto first = value.find_first_not_of(' ');
+  if (first == std::string::npos) {
+    return false;
+  }
+  char c = value[first];
+  return std::isdigit(static_cast<unsigned char>(c)) || c == '-' ||
+         c == '+' || c == '.';
+}
+
+void AppendParameter(std::string &normalized_query,
+                     std::vector<type::Value> &params, type::Value &&value) {
+  params.push_back(std::move(value));
+  normalized_query += '$';
+  normalized_query += std::to_string(params.size());
+}
+
+}  // namespace
+
+PlanCache &PlanCache::GetInstance() {
+  static PlanCache plan_cache;
+  return plan_cache;
+}
+
+bool PlanCache::NormalizeQuery(const std::string &query,
+                               std::string &normalized_query,
+                               std::vector<type::Value> &params) {
+  normalized_query.clear();
+  normalized_query.reserve(query.size());
+  params.clear();
+
+  size_t pos = 0;
+  bool pending_space = false;
+  // Only literals of predicates are lifted; the others (e.g. SET values) may
+  // be coerced to a column type by the planner
+  bool in_where = false;
+  while (pos < query.size()) {
+    char c = query[pos];
+
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      pending_space = true;
+      pos++;
+      continue;
+    }
+    if (pending_space) {
+      if (!normalized_query.empty()) {
+        normalized_query += ' ';
+      }
+      pending_space = false;
+    }
+
+    // Comments, existing parameters and dollar quoting are left to the
+    // regular path
+    if ((c == '-' && query.compare(pos, 2, "--") == 0) ||
+        (c == '/' && query.compare(pos, 2, "/*") == 0) || c == '$') {
+      return false;
+    }
+
+    // Only a single statement, optionally terminated by a semicolon
+    if (c == ';') {
+      if (query.find_first_not_of(" \t\r\n;", pos) != std::string::npos) {
+        return false;
+      }
+      break;
+    }
+
+    // Quoted identifiers are case sensitive
+    if (c == '"') {
+      auto end = query.find('"', pos + 1);
+      if (end == std::string::npos) {
+        return false;
+      }
+      normalized_query.append(query, pos, end + 1 - pos);
+      pos = end + 1;
+      continue;
+    }
+
+    if (c == '\'') {
+      // Escape, bit and hex strings are left to the parser
+      if (!normalized_query.empty() &&
+          IsIdentifierChar(normalized_query.back())) {
+        return false;
+      }
+      std::string value;
+      size_t end = pos + 1;
+      while (true) {
+        if (end >= query.size()) {
+          return false;
+        }
+        if (query[end] == '\'') {
+          if (end + 1 < query.size() && query[end + 1] == '\'') {
+            value += '\'';
+            end += 2;
+            continue;
+          }
+          break;
+        }
+        value += query[end++];
+      }
+      end++;
+
+      if (in_where && FollowsComparison(normalized_query) &&
+          !IsCast(query, end) && !MayBeCast(value)) {
+        AppendParameter(normalized_query, params,
+                        type::ValueFactory::GetVarcharValue(value));
+      } else {
+        normalized_query.append(query, pos, end - pos);
+      }
+      pos = end;
+      continue;
+    }
+
+    if (std::isdigit(static_cast<unsigned char>(c))) {
+      size_t end = pos;
+      bool is_integral = true;
+      while (end < query.size() &&
+             std::isdigit(static_cast<unsigned char>(query[end]))) {
+        end++;
+      }
+      if (end < query.size() && query[end] == '.') {
+        is_integral = false;
+        end++;
+        while (end < query.size() &&
+               std::isdigit(static_cast<unsigned char>(query[end]))) {
+          end++;
+        }
+      }
+      if (end < query.size() && (query[end] == 'e' || query[end] == 'E')) {
+        is_integral = false;
+        end++;
+        if (end < query.size() && (query[end] == '+' || query[end] == '-')) {
+          end++;
+        }
+        while (end < query.size() &&
+               std::isdigit(static_cast<unsigned char>(query[end]))) {
+          end++;
+        }
+      }
+      if (end < query.size() && IsIdentifierChar(query[end])) {
+        return false;
+      }
+
+      std::string literal = query.substr(pos, end - pos);
+      if (in_where && FollowsComparison(normalized_query) &&
+          !IsCast(query, end)) {
+        AppendParameter(normalized_query, params,
+                        GetNumericValue(literal, is_integral));
+      } else {
+        normalized_query += literal;
+      }
+      pos = end;
+      continue;
+    }
+
+    // Identifiers and keywords are case insensitive, and digits inside them
+    // are not literals
+    if (IsIdentifierChar(c)) {
+      auto start = normalized_query.size();
+      while (pos < query.size() && IsIdentifierChar(query[pos])) {
+        normalized_query +=
+            std::tolower(static_cast<unsigned char>(query[pos]));
+        pos++;
+      }
+      if (normalized_query.compare(start, std::string::npos, "where") == 0) {
+        in_where = true;
+      }
+      continue;
+    }
+
+    normalized_query += c;
+    pos++;
+  }
+
+  // Only DML statements whose plans bind parameters are cached
+  for (auto prefix : {"select ", "update ", "delete "}) {
+    if (normalized_query.compare(0, 7, prefix) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<Statement> PlanCache::Acquire(
+    const std::string &database_name, const std::string &normalized_query) {
+  std::shared_ptr<Statement> statement;
+  auto key = GetKey(database_name, normalized_query);
+
+  latch_.Lock();
+  auto entry = entry_map_.find(key);
+  if (entry != entry_map_.end() && !entry->second->idle_statements.empty()) {
+    statement = std::move(entry->second->idle_statements.back());
+    entry->second->idle_statements.pop_back();
+    entry_list_.splice(entry_list_.begin(), entry_list_, entry->second);
+  }
+  latch_.Unlock();
+
+  return statement;
+}
+
+void PlanCache::Release(const std::string &database_name,
+                        const std::shared_ptr<Statement> &statement) {
+  latch_.Lock();
+
+  // The statement was not planned, or the plan went stale while the
+  // statement was checked out
+  if (statement->GetPlanTree().get() == nullptr ||
+      statement->GetNeedsReplan()) {
+    latch_.Unlock();
+    return;
+  }
+
+  auto key = GetKey(database_name, statement->GetQueryString());
+  auto entry_itr = entry_map_.find(key);
+  if (entry_itr == entry_map_.end()) {
+    entry_list_.push_front(CacheEntry{key, {statement}, {}});
+    entry_map_.emplace(key, entry_list_.begin());
+    entry_itr = entry_map_.find(key);
+    Evict();
+    if (entry_map_.find(key) == entry_map_.end()) {
+      latch_.Unlock();
+      return;
+    }
+  }
+
+  auto &entry = *entry_itr->second;
+  auto known = std::find(entry.statements.begin(), entry.statements.end(),
+                         statement) != entry.statements.end();
+  if (!known && entry.statements.size() < kMaxStatementsPerQuery) {
+    entry.statements.push_back(statement);
+    known = true;
+  }
+  if (known) {
+    entry.idle_statements.push_back(statement);
+  }
+
+  latch_.Unlock();
+}
+
+void PlanCache::InvalidateTableOid(oid_t table_id) {
+  latch_.Lock();
+  for (auto entry = entry_list_.begin(); entry != entry_list_.end();) {
+    auto current = entry++;
+    // All the statements of a query reference the same tables
+    const auto table_ids = current->statements.front()->GetReferencedTables();
+    if (table_ids.find(table_id) != table_ids.end()) {
+      Erase(current);
+    }
+  }
+  latch_.Unlock();
+}
+
+void PlanCache::Clear() {
+  latch_.Lock();
+  while (!entry_list_.empty()) {
+    Erase(entry_list_.begin());
+  }
+  latch_.Unlock();
+}
+
+size_t PlanCache::GetCount() {
+  latch_.Lock();
+  size_t count = entry_map_.size();
+  latch_.Unlock();
+  return count;
+}
+
+void PlanCache::SetCapacity(size_t capacity) {
+  latch_.Lock();
+  capacity_ = capacity;
+  Evict();
+  latch_.Unlock();
+}
+
+std::string PlanCache::GetKey(const std::string &database_name,
+                              const std::string &normalized_query) {
+  // Database names can't contain a NUL character
+  std::string key = database_name;
+  key += '\0';
+  key += normalized_query;
+  return key;
+}
+
+void PlanCache::Evict() {
+  while (entry_map_.size() > capacity_) {
+    auto last = entry_list_.end();
+    last--;
+    Erase(last);
+  }
+}
+
+void PlanCache::Erase(std::list<CacheEntry>::iterator entry) {
+  for (auto &statement : entry->statements) {
+    statement->SetNeedsReplan(true);
+  }
+  entry_map_.erase(entry->key);
+  entry_list_.erase(entry);
+}
+
+}  // namespace peloton
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.cpp
+//
+// Identification: src/common/spill_file.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/spill_file.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace peloton {
+
+SpillFile::SpillFile() : file_(std::tmpfile()), size_(0) {
+  if (file_ == nullptr) {
+    throw ExecutorException("Unable to create spill file: " +
+                            std::string(std::strerror(errno)));
+  }
+  LOG_TRACE("Created spill file");
+}
+
+SpillFile::~SpillFile() { std::fclose(file_); }
+
+void SpillFile::Write(const void *data, size_t len) {
+  if (len == 0) {
+    return;
+  }
+  if (std::fwrite(data, 1, len, file_) != len) {
+    throw ExecutorException("Unable to write to spill file: " +
+                            std::string(std::strerror(errno)));
+  }
+  size_ += len;
+}
+
+void SpillFile::Rewind() {
+  if (std::fflush(file_) != 0 || std::fseek(file_, 0, SEEK_SET) != 0) {
+    throw ExecutorException("Unable to rewind spill file: " +
+                            std::string(std::strerror(errno)));
+  }
+}
+
+size_t SpillFile::Read(void *buffer, size_t len) {
+  size_t read = std::fread(buffer, 1, len, file_);
+  if (read < len && std::ferror(file_)) {
+    throw ExecutorException("Unable to read from spill file: " +
+                            std::string(std::strerror(errno)));
+  }
+  return read;
+}
+
+void SpillFile::ReadExactly(void *buffer, size_t len) {
+  if (Read(buffer, len) != len) {
+    throw ExecutorException("Unexpected end of spill file");
+  }
+}
+
+}  // namespace peloton
@@ -12,8 +12,13 @@
 
 #include "common/statement_cache_manager.h"
 
+#include "common/plan_cache.h"
+
 namespace peloton {
 
+std::shared_ptr<StatementCacheManager>
+    StatementCacheManager::statement_cache_manager_;
+
 void StatementCacheManager::RegisterStatementCache(StatementCache *stmt_cache) {
   statement_caches_.Insert(stmt_cache, stmt_cache);
 }
@@ -23,6 +28,8 @@ void StatementCacheManager::UnRegisterStatementCache(StatementCache *stmt_cache)
 }
 
 void StatementCacheManager::InvalidateTableOid(oid_t table_id) {
+  PlanCache::GetInstance().InvalidateTableOid(table_id);
+
   if (statement_caches_.IsEmpty()) 
     return;
 
@@ -38,6 +45,9 @@ void StatementCacheManager::InvalidateTableOid(oid_t table_id) {
 }
 
 void StatementCacheManager::InvalidateTableOids(std::set<oid_t> &table_ids) {
+  for (auto &table_id : table_ids)
+    PlanCache::GetInstance().InvalidateTableOid(table_id);
+
   if (table_ids.empty() || statement_caches_.IsEmpty())
     return;
 
@@ -16,6 +16,30 @@
 namespace peloton {
 namespace concurrency {
 
+  // the block of transaction ids reserved by the current thread.
+  struct TransactionIdBlock {
+    uint64_t generation_ = 0;
+    uint32_t next_txn_id_ = 0;
+    uint32_t end_txn_id_ = 0;
+  };
+
+  static thread_local TransactionIdBlock txn_id_block;
+
+  uint32_t DecentralizedEpochManager::GetNextTransactionId() {
+    uint64_t generation = txn_id_generation_.load(std::memory_order_acquire);
+
+    if (txn_id_block.next_txn_id_ == txn_id_block.end_txn_id_ ||
+        txn_id_block.generation_ != generation) {
+      // the block size divides 2^32, so blocks never straddle a wrap-around.
+      uint32_t first_txn_id =
+          next_txn_id_.fetch_add(TXN_ID_BATCH_SIZE, std::memory_order_relaxed);
+      txn_id_block.next_txn_id_ = first_txn_id;
+      txn_id_block.end_txn_id_ = first_txn_id + TXN_ID_BATCH_SIZE;
+      txn_id_block.generation_ = generation;
+    }
+
+    return txn_id_block.next_txn_id_++;
+  }
 
   // enter epoch with thread id
   cid_t DecentralizedEpochManager::EnterEpoch(const size_t thread_id, const TimestampType ts_type) {
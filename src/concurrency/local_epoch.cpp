@@ -19,96 +19,122 @@ namespace concurrency {
 
   bool LocalEpoch::EnterEpoch(const eid_t epoch_id, const TimestampType ts_type) {
 
-    epoch_lock_.Lock();
-
-    // if this thread is never used or has been GC'd
-    if (epoch_id_lower_bound_ == UINT64_MAX) {
-
-      epoch_id_lower_bound_ = epoch_id - 1;
-    
-    } else if (epoch_id_lower_bound_ >= epoch_id) {
-    
-      if (ts_type == TimestampType::SNAPSHOT_READ) {
-    
-        epoch_id_lower_bound_ = epoch_id - 1;
-    
-      } else {
-        // epoch_id_lower_bound_ has already been updated by the GC.
-        // have to grab a newer epoch_id.
-        epoch_lock_.Unlock();
+    if (ts_type == TimestampType::SNAPSHOT_READ) {
+      // a read-only transaction can always succeed.
+      // it holds back the expired epoch once it is registered.
+      Register(epoch_id);
+      return true;
+    }
 
-        return false;
-      }
+    if (ts_type == TimestampType::COMMIT) {
+      // commit timestamps are not tracked, 
+      // but must not fall into an expired epoch.
+      return epoch_id_lower_bound_.load() < epoch_id;
     }
 
-    if (ts_type != TimestampType::COMMIT) {
+    Register(epoch_id);
 
-      auto epoch_map_itr = epoch_map_.find(epoch_id);
-      // check whether the corresponding epoch exists.
-      if (epoch_map_itr == epoch_map_.end()) {
+    // the GC may have expired this epoch before we registered.
+    // have to grab a newer epoch_id.
+    if (epoch_id_lower_bound_.load() >= epoch_id) {
+      Deregister(epoch_id);
+      return false;
+    }
 
-        std::shared_ptr<Epoch> epoch_ptr(new Epoch(epoch_id, 1));
+    return true;
+  }
 
-        epoch_queue_.push(epoch_ptr);
-        epoch_map_[epoch_id] = epoch_ptr;
+  void LocalEpoch::ExitEpoch(const eid_t epoch_id) {
+    Deregister(epoch_id);
+  }
 
-      } else {
-        epoch_map_itr->second->txn_count_++;
-      }
-      
-    }
+  uint64_t LocalEpoch::GetExpiredEpochId(const uint64_t epoch_id) {
+    // fence off transactions that have not registered yet.
+    // they will observe the new lower bound and retry.
+    epoch_id_lower_bound_.store(epoch_id - 1);
 
-    epoch_lock_.Unlock();
+    eid_t min_active_eid = GetMinActiveEpochId();
 
-    return true;
+    // there's no epoch in this thread.
+    // which indicates that this thread is never used or has been GC'd for some time.
+    if (min_active_eid == MAX_EID || min_active_eid >= epoch_id) {
+      return epoch_id - 1;
+    }
+
+    return min_active_eid - 1;
   }
 
-  void LocalEpoch::ExitEpoch(const eid_t epoch_id) {
-    epoch_lock_.Lock();
+  void LocalEpoch::Register(const eid_t epoch_id) {
+    PL_ASSERT(epoch_id <= 0xFFFFFFFF);
 
-    PL_ASSERT(epoch_map_.find(epoch_id) != epoch_map_.end());
-    epoch_map_.at(epoch_id)->txn_count_--;
+    auto &slot = GetSlot(epoch_id);
+    uint64_t current = slot.load();
 
-    while (epoch_queue_.size() != 0) {
-      auto &epoch_ptr = epoch_queue_.top();
-      if (epoch_ptr->txn_count_ == 0) {
-        epoch_map_.erase(epoch_ptr->epoch_id_);
-        epoch_queue_.pop();
+    while (true) {
+      uint64_t desired;
+      if (CountOf(current) == 0) {
+        // the slot is free
+        desired = (epoch_id << 32) | 1;
+      } else if (EpochOf(current) == epoch_id) {
+        desired = current + 1;
       } else {
-        PL_ASSERT(epoch_ptr->epoch_id_ > epoch_id_lower_bound_);
-        epoch_id_lower_bound_ = epoch_ptr->epoch_id_ - 1;
+        // the slot is still held by an older epoch
         break;
       }
+      if (slot.compare_exchange_weak(current, desired)) {
+        return;
+      }
     }
 
-    epoch_lock_.Unlock();
+    overflow_lock_.Lock();
+    overflow_epochs_[epoch_id]++;
+    overflow_count_.fetch_add(1);
+    overflow_lock_.Unlock();
   }
 
-  uint64_t LocalEpoch::GetExpiredEpochId(const uint64_t epoch_id) {
-    epoch_lock_.Lock();
-    // there's no epoch in this thread.
-    // which indicates that this thread is never used or has been GC'd for some time.
-    if (epoch_queue_.size() == 0) {
-      epoch_id_lower_bound_ = epoch_id - 1;
-    } else {
-      while (epoch_queue_.size() != 0) {
-        // get the smallest epoch.
-        auto &epoch_ptr = epoch_queue_.top();
-        // if there's no transaction in the epoch
-        if (epoch_ptr->txn_count_ == 0) {
-          epoch_map_.erase(epoch_ptr->epoch_id_);
-          epoch_queue_.pop();
-        } else {
-          PL_ASSERT(epoch_ptr->epoch_id_ > epoch_id_lower_bound_);
-          epoch_id_lower_bound_ = epoch_ptr->epoch_id_ - 1;
-          break;
+  void LocalEpoch::Deregister(const eid_t epoch_id) {
+    // transactions of the same epoch are interchangeable,
+    // so it does not matter where this one was counted.
+    auto &slot = GetSlot(epoch_id);
+    uint64_t current = slot.load();
+
+    while (EpochOf(current) == epoch_id && CountOf(current) != 0) {
+      if (slot.compare_exchange_weak(current, current - 1)) {
+        return;
+      }
+    }
+
+    overflow_lock_.Lock();
+    auto epoch_itr = overflow_epochs_.find(epoch_id);
+    PL_ASSERT(epoch_itr != overflow_epochs_.end());
+    if (--epoch_itr->second == 0) {
+      overflow_epochs_.erase(epoch_itr);
+    }
+    overflow_count_.fetch_sub(1);
+    overflow_lock_.Unlock();
+  }
+
+  eid_t LocalEpoch::GetMinActiveEpochId() {
+    eid_t min_eid = MAX_EID;
+
+    for (auto &slot : epoch_slots_) {
+      uint64_t current = slot.load();
+      if (CountOf(current) != 0 && EpochOf(current) < min_eid) {
+        min_eid = EpochOf(current);
+      }
+    }
+
+    if (overflow_count_.load() != 0) {
+      overflow_lock_.Lock();
+      for (auto &epoch_itr : overflow_epochs_) {
+        if (epoch_itr.first < min_eid) {
+          min_eid = epoch_itr.first;
         }
       }
+      overflow_lock_.Unlock();
     }
-    uint64_t ret = epoch_id_lower_bound_;
-    
-    epoch_lock_.Unlock();
-    return ret;
+
+    return min_eid;
   }
 
 }
@@ -499,6 +499,46 @@ void TimestampOrderingTransactionManager::PerformInsert(
   }
 }
 
+void TimestampOrderingTransactionManager::PerformInserts(
+    TransactionContext *const current_txn,
+    const std::vector<ItemPointer> &locations,
+    const std::vector<ItemPointer *> &index_entry_ptrs) {
+  PL_ASSERT(current_txn->GetIsolationLevel() != IsolationLevelType::READ_ONLY);
+  PL_ASSERT(locations.size() == index_entry_ptrs.size());
+
+  auto &manager = catalog::Manager::GetInstance();
+  auto transaction_id = current_txn->GetTransactionId();
+  bool record_stats =
+      static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID;
+
+  // Batches are mostly runs of consecutive slots of the same tile group
+  oid_t tile_group_id = INVALID_OID;
+  storage::TileGroupHeader *tile_group_header = nullptr;
+  for (size_t i = 0; i < locations.size(); i++) {
+    if (locations[i].block != tile_group_id) {
+      tile_group_id = locations[i].block;
+      tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+    }
+    oid_t tuple_id = locations[i].offset;
+
+    // the tuple slot must be empty.
+    PL_ASSERT(tile_group_header->GetTransactionId(tuple_id) == INVALID_TXN_ID);
+    PL_ASSERT(tile_group_header->GetBeginCommitId(tuple_id) == MAX_CID);
+    PL_ASSERT(tile_group_header->GetEndCommitId(tuple_id) == MAX_CID);
+
+    tile_group_header->SetTransactionId(tuple_id, transaction_id);
+    current_txn->RecordInsert(locations[i]);
+    InitTupleReserved(tile_group_header, tuple_id);
+    tile_group_header->SetIndirection(tuple_id, index_entry_ptrs[i]);
+
+    if (record_stats) {
+      stats::BackendStatsContext::GetInstance()->IncrementTableInserts(
+          tile_group_id);
+    }
+  }
+}
+
 void TimestampOrderingTransactionManager::PerformUpdate(
     TransactionContext *const current_txn, const ItemPointer &location,
     const ItemPointer &new_location) {
@@ -540,6 +580,9 @@ void TimestampOrderingTransactionManager::PerformUpdate(
   // Set double linked list
   tile_group_header->SetPrevItemPointer(old_location.offset, new_location);
 
+  // the old version's tile group is no longer cold
+  tile_group_header->SetLastWriteEpochId(current_txn->GetEpochId());
+
   new_tile_group_header->SetNextItemPointer(new_location.offset, old_location);
 
   new_tile_group_header->SetTransactionId(new_location.offset, transaction_id);
@@ -659,6 +702,9 @@ void TimestampOrderingTransactionManager::PerformDelete(
   // Set up double linked list
   tile_group_header->SetPrevItemPointer(old_location.offset, new_location);
 
+  // the old version's tile group is no longer cold
+  tile_group_header->SetLastWriteEpochId(current_txn->GetEpochId());
+
   new_tile_group_header->SetNextItemPointer(new_location.offset, old_location);
 
   new_tile_group_header->SetTransactionId(new_location.offset, transaction_id);
@@ -173,6 +173,17 @@ bool TransactionManager::IsOccupied(TransactionContext *const current_txn,
   }
 }
 
+// register a batch of inserted tuples, one at a time.
+void TransactionManager::PerformInserts(
+    TransactionContext *const current_txn,
+    const std::vector<ItemPointer> &locations,
+    const std::vector<ItemPointer *> &index_entry_ptrs) {
+  PL_ASSERT(locations.size() == index_entry_ptrs.size());
+  for (size_t i = 0; i < locations.size(); i++) {
+    PerformInsert(current_txn, locations[i], index_entry_ptrs[i]);
+  }
+}
+
 // this function checks whether a version is visible to current transaction.
 VisibilityType TransactionManager::IsVisible(
     TransactionContext *const current_txn,
@@ -41,12 +41,15 @@ AbstractJoinExecutor::AbstractJoinExecutor(const planner::AbstractPlan *node,
  * @return true on success, false otherwise.
  */
 bool AbstractJoinExecutor::DInit() {
-  PL_ASSERT(children_.size() == 2);
-
   // Grab data from plan node.
   const planner::AbstractJoinPlan &node =
       GetPlanNode<planner::AbstractJoinPlan>();
 
+  // The index nested loop join reads its inner table through an index
+  PL_ASSERT(children_.size() == 2 ||
+            (children_.size() == 1 &&
+             node.GetPlanNodeType() == PlanNodeType::NESTLOOPINDEX));
+
   // NOTE: predicate can be null for cartesian product
   predicate_ = node.GetPredicate();
   proj_info_ = node.GetProjInfo();
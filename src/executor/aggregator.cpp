@@ -14,8 +14,10 @@
 
 #include "catalog/manager.h"
 #include "common/logger.h"
+#include "common/spill_file.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/executor_context.h"
+#include "settings/settings_manager.h"
 #include "storage/abstract_table.h"
 
 namespace peloton {
@@ -26,9 +28,11 @@ namespace executor {
  * type, column type, and result type. The object is constructed in
  * memory from the provided memrory pool.
  */
-AbstractAttributeAggregator *GetAttributeAggregatorInstance(ExpressionType agg_type) {
+AbstractAttributeAggregator *GetAttributeAggregatorInstance(
+    const planner::AggregatePlan::AggTerm &agg_term) {
   AbstractAttributeAggregator *aggregator;
 
+  ExpressionType agg_type = agg_term.aggtype;
   switch (agg_type) {
     case ExpressionType::AGGREGATE_COUNT:
       aggregator = new CountAggregator();
@@ -48,6 +52,12 @@ AbstractAttributeAggregator *GetAttributeAggregatorInstance(ExpressionType agg_t
     case ExpressionType::AGGREGATE_MAX:
       aggregator = new MaxAggregator();
       break;
+    case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT:
+      aggregator = new ApproxCountDistinctAggregator();
+      break;
+    case ExpressionType::AGGREGATE_APPROX_PERCENTILE:
+      aggregator = new ApproxPercentileAggregator(agg_term.percentile);
+      break;
     default: {
       std::string message =
           "Unknown aggregate type " + ExpressionTypeToString(agg_type);
@@ -58,17 +68,108 @@ AbstractAttributeAggregator *GetAttributeAggregatorInstance(ExpressionType agg_t
   return aggregator;
 }
 
+/*
+ * The number of bytes taken by the state of an aggregator for the specified
+ * aggregate type, not counting distinct values
+ */
+static size_t GetAttributeAggregatorSize(ExpressionType agg_type) {
+  switch (agg_type) {
+    case ExpressionType::AGGREGATE_COUNT:
+      return sizeof(CountAggregator);
+    case ExpressionType::AGGREGATE_COUNT_STAR:
+      return sizeof(CountStarAggregator);
+    case ExpressionType::AGGREGATE_SUM:
+      return sizeof(SumAggregator);
+    case ExpressionType::AGGREGATE_AVG:
+      return sizeof(AvgAggregator);
+    case ExpressionType::AGGREGATE_MIN:
+      return sizeof(MinAggregator);
+    case ExpressionType::AGGREGATE_MAX:
+      return sizeof(MaxAggregator);
+    case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT:
+      return sizeof(ApproxCountDistinctAggregator);
+    case ExpressionType::AGGREGATE_APPROX_PERCENTILE:
+      return sizeof(ApproxPercentileAggregator);
+    default:
+      return sizeof(AvgAggregator);
+  }
+}
+
+/*
+ * The number of bytes taken by a value, used to estimate the memory taken by
+ * the groups of an aggregation
+ */
+static size_t GetValueSize(const type::Value &val) {
+  size_t size = sizeof(type::Value);
+  if ((val.GetTypeId() == type::TypeId::VARCHAR ||
+       val.GetTypeId() == type::TypeId::VARBINARY) &&
+      !val.IsNull()) {
+    size += val.GetLength();
+  }
+  return size;
+}
+
+/*
+ * The bytes a hash set takes for an element besides the element itself: the
+ * pointer to the next node, the cached hash and a bucket
+ */
+static constexpr size_t kHashSetEntryOverhead = 3 * sizeof(void *);
+
+/*
+ * Spilled data is split into 2^kSpillPartitionBits partitions. Partitions of
+ * kMaxSpillLevel are processed regardless of the memory budget.
+ */
+static constexpr uint32_t kSpillPartitionBits = 4;
+static constexpr uint32_t kNumSpillPartitions = 1u << kSpillPartitionBits;
+static constexpr uint32_t kMaxSpillLevel = 64 / kSpillPartitionBits - 1;
+
+/*
+ * Find the spill partition of the given hash at the given level of recursive
+ * partitioning
+ */
+static uint32_t SpillPartitionFor(size_t hash, uint32_t level) {
+  return static_cast<uint32_t>(
+      ((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull)
+       << (level * kSpillPartitionBits)) >>
+      (64 - kSpillPartitionBits));
+}
+
+/* Serialize a value along with its type */
+static void WriteValue(const type::Value &value, CopySerializeOutput &output) {
+  output.WriteByte(static_cast<int8_t>(value.GetTypeId()));
+  value.SerializeTo(output);
+}
+
+/* Deserialize a value written by WriteValue() */
+static type::Value ReadValue(SerializeInput &input) {
+  auto type_id = static_cast<type::TypeId>(input.ReadByte());
+  type::Value value = type::Value::DeserializeFrom(input, type_id);
+  // A deserialized varlen value points into the buffer, copy it
+  if (type_id == type::TypeId::VARCHAR && !value.IsNull()) {
+    value = type::ValueFactory::GetVarcharValue(value.GetData(),
+                                                value.GetLength(), true);
+  } else if (type_id == type::TypeId::VARBINARY && !value.IsNull()) {
+    value = type::ValueFactory::GetVarbinaryValue(
+        reinterpret_cast<const unsigned char *>(value.GetData()),
+        value.GetLength(), true);
+  }
+  return value;
+}
+
 /* Handle distinct */
 AbstractAttributeAggregator::~AbstractAttributeAggregator() {}
 
-void AbstractAttributeAggregator::Advance(const type::Value val) {
+size_t AbstractAttributeAggregator::Advance(const type::Value val) {
   if (is_distinct_) {
     // Insert a deep copy
     type::Value val_copy = (val.Copy());
-    distinct_set_.insert(val_copy);
+    if (distinct_set_.insert(val_copy).second) {
+      return GetValueSize(val_copy) + kHashSetEntryOverhead;
+    }
   } else {
     DAdvance(val);
   }
+  return 0;
 }
 
 type::Value AbstractAttributeAggregator::Finalize() {
@@ -146,20 +247,135 @@ bool Helper(const planner::AggregatePlan *node, AbstractAttributeAggregator **ag
   return true;
 }
 
+//===--------------------------------------------------------------------===//
+// Distinct Spill
+//===--------------------------------------------------------------------===//
+DistinctSpill::DistinctSpill(size_t num_key_values, size_t memory_budget,
+                             uint32_t level)
+    : num_key_values_(num_key_values),
+      memory_budget_(memory_budget),
+      level_(level),
+      spill_files_(kNumSpillPartitions) {}
+
+DistinctSpill::~DistinctSpill() {}
+
+void DistinctSpill::Spill(const std::vector<type::Value> &key, oid_t aggno,
+                          const type::Value &value) {
+  // A value is stored as the aggregate, the group-by key and the value. Equal
+  // values of a group serialize to the same bytes.
+  PL_ASSERT(key.size() == num_key_values_);
+  spill_output_.Reset();
+  spill_output_.WriteInt(static_cast<int32_t>(aggno));
+  for (const auto &key_value : key) {
+    WriteValue(key_value, spill_output_);
+  }
+  WriteValue(value, spill_output_);
+  Write(std::string(spill_output_.Data(), spill_output_.Size()));
+}
+
+void DistinctSpill::Write(const std::string &record) {
+  auto hash = std::hash<std::string>()(record);
+  auto &file = spill_files_[SpillPartitionFor(hash, level_)];
+  if (file == nullptr) {
+    file.reset(new SpillFile());
+  }
+  uint32_t size = static_cast<uint32_t>(record.size());
+  file->Write(&size, sizeof(size));
+  file->Write(record.data(), size);
+}
+
+/* Read the next value written by DistinctSpill::Write() */
+static bool ReadRecord(SpillFile &file, std::string &record) {
+  uint32_t size;
+  if (file.Read(&size, sizeof(size)) != sizeof(size)) {
+    return false;
+  }
+  record.resize(size);
+  file.ReadExactly(&record[0], size);
+  return true;
+}
+
+void DistinctSpill::Replay(const Callback &callback) {
+  std::unordered_set<std::string> records;
+  std::string record;
+  std::vector<type::Value> key;
+
+  for (auto &file : spill_files_) {
+    if (file == nullptr) {
+      continue;
+    }
+
+    // Deduplicate the partition, unless it turns out not to fit
+    bool fits = true;
+    size_t memory_used = 0;
+    records.clear();
+    file->Rewind();
+    while (ReadRecord(*file, record)) {
+      if (!records.insert(record).second) {
+        continue;
+      }
+      memory_used +=
+          sizeof(std::string) + record.size() + kHashSetEntryOverhead;
+      if (memory_budget_ != 0 && memory_used > memory_budget_ &&
+          records.size() > 1 && level_ < kMaxSpillLevel) {
+        fits = false;
+        break;
+      }
+    }
+
+    if (!fits) {
+      LOG_DEBUG("Splitting %llu bytes of spilled distinct values at level %u",
+                (unsigned long long)file->Size(), level_ + 1);
+      records.clear();
+      DistinctSpill partition(num_key_values_, memory_budget_, level_ + 1);
+      file->Rewind();
+      while (ReadRecord(*file, record)) {
+        partition.Write(record);
+      }
+      file.reset();
+      partition.Replay(callback);
+      continue;
+    }
+    file.reset();
+
+    for (const auto &distinct_record : records) {
+      ReferenceSerializeInput input(distinct_record.data(),
+                                    distinct_record.size());
+      auto aggno = static_cast<oid_t>(input.ReadInt());
+      key.clear();
+      for (size_t i = 0; i < num_key_values_; i++) {
+        key.push_back(ReadValue(input));
+      }
+      callback(key, aggno, ReadValue(input));
+    }
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // Hash Aggregator
 //===--------------------------------------------------------------------===//
 HashAggregator::HashAggregator(const planner::AggregatePlan *node,
                                storage::AbstractTable *output_table,
                                executor::ExecutorContext *econtext,
-                               size_t num_input_columns)
+                               size_t num_input_columns, uint32_t level)
     : AbstractAggregator(node, output_table, econtext),
-      num_input_columns(num_input_columns) {}
+      num_input_columns(num_input_columns),
+      level_(level) {
+  memory_budget_ = static_cast<size_t>(
+      std::max(0.0, settings::SettingsManager::GetDouble(
+                        settings::SettingId::aggregation_memory_budget)));
+  for (const auto &agg_term : node->GetUniqueAggTerms()) {
+    aggregates_size_ += sizeof(AbstractAttributeAggregator *) +
+                        GetAttributeAggregatorSize(agg_term.aggtype);
+  }
+}
 //  group_by_key_values.resize(node->GetGroupbyColIds().size(),
 //      type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER));
 //}
 
-HashAggregator::~HashAggregator() {
+HashAggregator::~HashAggregator() { ClearGroups(); }
+
+void HashAggregator::ClearGroups() {
   for (auto entry : aggregates_map) {
     // Clean up allocated storage
     for (size_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
@@ -168,6 +384,8 @@ HashAggregator::~HashAggregator() {
     delete[] entry.second->aggregates;
     delete entry.second;
   }
+  aggregates_map.clear();
+  memory_used_ = 0;
 }
 
 bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
@@ -186,6 +404,12 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
 
   // Group not found. Make a new entry in the hash for this new group.
   if (map_itr == aggregates_map.end()) {
+    // Out of memory, the new group is aggregated after the groups in memory
+    if (!spill_files_.empty()) {
+      Spill(cur_tuple, aggregates_map.hash_function()(group_by_key_values));
+      return true;
+    }
+
     LOG_TRACE("Group-by key not found. Start a new group.");
     // Allocate new aggregate list
     aggregate_list = new AggregateList();
@@ -194,11 +418,12 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
     for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
       // first_tuple_values has the ownership
       aggregate_list->first_tuple_values.push_back(cur_tuple->GetValue(col_id));
+      memory_used_ += GetValueSize(aggregate_list->first_tuple_values.back());
     };
 
     for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
       aggregate_list->aggregates[aggno] =
-          GetAttributeAggregatorInstance(node->GetUniqueAggTerms()[aggno].aggtype);
+          GetAttributeAggregatorInstance(node->GetUniqueAggTerms()[aggno]);
 
       bool distinct = node->GetUniqueAggTerms()[aggno].distinct;
       aggregate_list->aggregates[aggno]->SetDistinct(distinct);
@@ -206,6 +431,13 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
 
     aggregates_map.insert(
         HashAggregateMapType::value_type(group_by_key_values, aggregate_list));
+
+    // The key, the aggregates and their state, and the entry of the hash table
+    for (auto &key_value : group_by_key_values) {
+      memory_used_ += GetValueSize(key_value);
+    }
+    memory_used_ +=
+        sizeof(AggregateList) + aggregates_size_ + 4 * sizeof(void *);
   }
   // Otherwise, the list is the second item of the pair.
   else {
@@ -221,13 +453,63 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
           cur_tuple, nullptr, this->executor_context);
     }
 
-    aggregate_list->aggregates[aggno]->Advance(value);
+    // Out of memory, new distinct values of the group are spilled
+    auto *aggregate = aggregate_list->aggregates[aggno];
+    if (distinct_spill_ != nullptr && aggregate->IsDistinct() &&
+        !aggregate->HasDistinct(value)) {
+      distinct_spill_->Spill(group_by_key_values, aggno, value);
+    } else {
+      memory_used_ += aggregate->Advance(value);
+    }
+  }
+
+  // Start spilling the input of new groups once the groups take too much
+  // memory. Groups already in memory keep being aggregated in memory, but
+  // their new distinct values are spilled.
+  if (memory_budget_ != 0 && memory_used_ > memory_budget_ &&
+      distinct_spill_ == nullptr) {
+    LOG_DEBUG("Hash aggregation at level %u exceeds the memory budget of %zu "
+              "bytes with %zu groups",
+              level_, memory_budget_, aggregates_map.size());
+    if (level_ < kMaxSpillLevel) {
+      spill_files_.resize(kNumSpillPartitions);
+    }
+    distinct_spill_.reset(new DistinctSpill(node->GetGroupbyColIds().size(),
+                                            memory_budget_));
   }
 
   return true;
 }
 
+void HashAggregator::Spill(AbstractTuple *tuple, size_t hash) {
+  // Every tuple is stored as its size followed by the type and the
+  // serialized value of all of its columns
+  spill_output_.Reset();
+  for (oid_t col_id = 0; col_id < num_input_columns; col_id++) {
+    WriteValue(tuple->GetValue(col_id), spill_output_);
+  }
+
+  uint32_t size = static_cast<uint32_t>(spill_output_.Size());
+  auto &file = spill_files_[SpillPartitionFor(hash, level_)];
+  if (file == nullptr) {
+    file.reset(new SpillFile());
+  }
+  file->Write(&size, sizeof(size));
+  file->Write(spill_output_.Data(), size);
+}
+
 bool HashAggregator::Finalize() {
+  // Add the spilled distinct values to the groups in memory
+  if (distinct_spill_ != nullptr) {
+    distinct_spill_->Replay([this](const std::vector<type::Value> &key,
+                                   oid_t aggno, const type::Value &value) {
+      auto map_itr = aggregates_map.find(key);
+      PL_ASSERT(map_itr != aggregates_map.end());
+      map_itr->second->aggregates[aggno]->DAdvance(value);
+    });
+    distinct_spill_.reset();
+  }
+
   for (auto entry : aggregates_map) {
     // Construct a container for the first tuple
     ContainerTuple<std::vector<type::Value>> first_tuple(
@@ -237,6 +519,56 @@ bool HashAggregator::Finalize() {
       return false;
     }
   }
+
+  if (spill_files_.empty()) {
+    return true;
+  }
+
+  // The groups in memory are done, make room for the spilled ones
+  ClearGroups();
+  return FinalizeSpilled();
+}
+
+bool HashAggregator::FinalizeSpilled() {
+  std::vector<char> buffer;
+  std::vector<type::Value> values;
+  ContainerTuple<std::vector<type::Value>> tuple(&values);
+
+  for (auto &file : spill_files_) {
+    if (file == nullptr) {
+      continue;
+    }
+    LOG_DEBUG("Aggregating %llu spilled bytes at level %u",
+              (unsigned long long)file->Size(), level_ + 1);
+
+    // The groups of a partition are aggregated from scratch, splitting the
+    // partition further if they do not fit into the budget either
+    HashAggregator partition_aggregator(node, output_table, executor_context,
+                                        num_input_columns, level_ + 1);
+
+    file->Rewind();
+    uint32_t size;
+    while (file->Read(&size, sizeof(size)) == sizeof(size)) {
+      buffer.resize(size);
+      file->ReadExactly(buffer.data(), size);
+
+      ReferenceSerializeInput input(buffer.data(), size);
+      values.clear();
+      for (oid_t col_id = 0; col_id < num_input_columns; col_id++) {
+        values.push_back(ReadValue(input));
+      }
+
+      if (partition_aggregator.Advance(&tuple) == false) {
+        return false;
+      }
+    }
+
+    if (partition_aggregator.Finalize() == false) {
+      return false;
+    }
+    file.reset();
+  }
+
   return true;
 }
 
@@ -307,7 +639,7 @@ bool SortedAggregator::Advance(AbstractTuple *next_tuple) {
       // Clean up previous aggregate
       delete aggregates[aggno];
       aggregates[aggno] =
-          GetAttributeAggregatorInstance(node->GetUniqueAggTerms()[aggno].aggtype);
+          GetAttributeAggregatorInstance(node->GetUniqueAggTerms()[aggno]);
 
       bool distinct = node->GetUniqueAggTerms()[aggno].distinct;
       aggregates[aggno]->SetDistinct(distinct);
@@ -355,6 +687,10 @@ PlainAggregator::PlainAggregator(const planner::AggregatePlan *node,
                                  storage::AbstractTable *output_table,
                                  executor::ExecutorContext *econtext)
     : AbstractAggregator(node, output_table, econtext) {
+  memory_budget_ = static_cast<size_t>(
+      std::max(0.0, settings::SettingsManager::GetDouble(
+                        settings::SettingId::aggregation_memory_budget)));
+
   // allocate aggregators
   aggregates = new AbstractAttributeAggregator *[node->GetUniqueAggTerms().size()]();
 
@@ -364,7 +700,7 @@ PlainAggregator::PlainAggregator(const planner::AggregatePlan *node,
               ExpressionTypeToString(node->GetUniqueAggTerms()[aggno].aggtype)
                   .c_str());
     aggregates[aggno] =
-        GetAttributeAggregatorInstance(node->GetUniqueAggTerms()[aggno].aggtype);
+        GetAttributeAggregatorInstance(node->GetUniqueAggTerms()[aggno]);
 
     bool distinct = node->GetUniqueAggTerms()[aggno].distinct;
     aggregates[aggno]->SetDistinct(distinct);
@@ -382,12 +718,36 @@ bool PlainAggregator::Advance(AbstractTuple *next_tuple) {
               .expression->Evaluate(next_tuple, nullptr, this->executor_context)
               .Copy();
     }
-    aggregates[aggno]->Advance(value);
+
+    // Out of memory, new distinct values are spilled
+    auto *aggregate = aggregates[aggno];
+    if (distinct_spill_ != nullptr && aggregate->IsDistinct() &&
+        !aggregate->HasDistinct(value)) {
+      distinct_spill_->Spill({}, aggno, value);
+    } else {
+      memory_used_ += aggregate->Advance(value);
+    }
+  }
+
+  if (memory_budget_ != 0 && memory_used_ > memory_budget_ &&
+      distinct_spill_ == nullptr) {
+    LOG_DEBUG("Distinct values exceed the memory budget of %zu bytes",
+              memory_budget_);
+    distinct_spill_.reset(new DistinctSpill(0, memory_budget_));
   }
   return true;
 }
 
 bool PlainAggregator::Finalize() {
+  // Add the spilled distinct values to the aggregates
+  if (distinct_spill_ != nullptr) {
+    distinct_spill_->Replay([this](const std::vector<type::Value> &,
+                                   oid_t aggno, const type::Value &value) {
+      aggregates[aggno]->DAdvance(value);
+    });
+    distinct_spill_.reset();
+  }
+
   if (!Helper(node, aggregates, output_table, nullptr,
               this->executor_context)) {
     return false;
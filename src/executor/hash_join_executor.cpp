@@ -114,7 +114,6 @@ bool HashJoinExecutor::DExecute() {
 
     oid_t prev_tile = INVALID_OID;
     std::unique_ptr<LogicalTile> output_tile;
-    LogicalTile::PositionListsBuilder pos_lists_builder;
 
     // Go over the left tile
     for (auto left_tile_itr : *left_tile) {
@@ -140,10 +139,10 @@ bool HashJoinExecutor::DExecute() {
           // Check if we got a new right tile itr
           if (prev_tile != location.first) {
             // Check if we have any join tuples
-            if (pos_lists_builder.Size() > 0) {
-              LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
+            if (pos_lists_builder_.Size() > 0) {
+              LOG_TRACE("Join tile size : %lu \n", pos_lists_builder_.Size());
               output_tile->SetPositionListsAndVisibility(
-                  pos_lists_builder.Release());
+                  pos_lists_builder_.Release());
               buffered_output_tiles.push_back(output_tile.release());
             }
 
@@ -154,15 +153,14 @@ bool HashJoinExecutor::DExecute() {
             output_tile = BuildOutputLogicalTile(left_tile, right_tile);
 
             // Build position lists
-            pos_lists_builder =
-                LogicalTile::PositionListsBuilder(left_tile, right_tile);
+            pos_lists_builder_.Reset(left_tile, right_tile);
 
-            pos_lists_builder.SetRightSource(
+            pos_lists_builder_.SetRightSource(
                 &right_result_tiles_[location.first]->GetPositionLists());
           }
 
           // Add join tuple
-          pos_lists_builder.AddRow(left_tile_itr, location.second);
+          pos_lists_builder_.AddRow(left_tile_itr, location.second);
 
           RecordMatchedRightRow(location.first, location.second);
 
@@ -173,9 +171,9 @@ bool HashJoinExecutor::DExecute() {
     }
 
     // Check if we have any join tuples
-    if (pos_lists_builder.Size() > 0) {
-      LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
-      output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+    if (pos_lists_builder_.Size() > 0) {
+      LOG_TRACE("Join tile size : %lu \n", pos_lists_builder_.Size());
+      output_tile->SetPositionListsAndVisibility(pos_lists_builder_.Release());
       buffered_output_tiles.push_back(output_tile.release());
     }
 
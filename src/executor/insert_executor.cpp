@@ -102,37 +102,37 @@ bool InsertExecutor::DExecute() {
 
     auto target_table_schema = target_table->GetSchema();
     auto column_count = target_table_schema->GetColumnCount();
+    auto tuple_length = target_table_schema->GetLength();
 
-    std::unique_ptr<storage::Tuple> tuple(
-        new storage::Tuple(target_table_schema, true));
+    // Materialize the whole logical tile into one buffer
+    size_t tuple_count = logical_tile->GetTupleCount();
+    std::unique_ptr<char[]> tuple_data(new char[tuple_count * tuple_length]());
+    std::vector<storage::Tuple> tuples;
+    std::vector<const storage::Tuple *> batch;
+    tuples.reserve(tuple_count);
+    batch.reserve(tuple_count);
 
     // Go over the logical tile
     for (oid_t tuple_id : *logical_tile) {
       ContainerTuple<LogicalTile> cur_tuple(logical_tile.get(), tuple_id);
 
+      tuples.emplace_back(target_table_schema,
+                          tuple_data.get() + tuples.size() * tuple_length);
+      auto &tuple = tuples.back();
+
       // Materialize the logical tile tuple
       for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
         type::Value val = (cur_tuple.GetValue(column_itr));
-        tuple->SetValue(column_itr, val, executor_pool);
+        tuple.SetValue(column_itr, val, executor_pool);
       }
+      batch.push_back(&tuple);
+    }
 
-      // insert tuple into the table.
-      ItemPointer *index_entry_ptr = nullptr;
-      peloton::ItemPointer location =
-          target_table->InsertTuple(tuple.get(), current_txn, &index_entry_ptr);
-
-      // it is possible that some concurrent transactions have inserted the same
-      // tuple.
-      // in this case, abort the transaction.
-      if (location.block == INVALID_OID) {
-        transaction_manager.SetTransactionResult(current_txn,
-                                                 peloton::ResultType::FAILURE);
-        return false;
-      }
-
-      transaction_manager.PerformInsert(current_txn, location, index_entry_ptr);
-
-      executor_context_->num_processed += 1;  // insert one
+    // it is possible that some concurrent transactions have inserted the same
+    // tuple.
+    // in this case, abort the transaction.
+    if (InsertBatch(target_table, batch) == false) {
+      return false;
     }
 
     // execute after-insert-statement triggers and
@@ -182,6 +182,39 @@ bool InsertExecutor::DExecute() {
       tuple = storage_tuple.get();
     }
 
+    // Without per-row triggers, all tuples given by the plan are inserted as
+    // one batch
+    bool has_row_triggers =
+        trigger_list != nullptr &&
+        (trigger_list->HasTriggerType(TriggerType::BEFORE_INSERT_ROW) ||
+         trigger_list->HasTriggerType(TriggerType::AFTER_INSERT_ROW) ||
+         trigger_list->HasTriggerType(TriggerType::ON_COMMIT_INSERT_ROW));
+    if (!project_info && !has_row_triggers && bulk_insert_count > 1) {
+      uint32_t num_columns = schema->GetColumnCount();
+      std::vector<std::unique_ptr<storage::Tuple>> value_tuples;
+      std::vector<const storage::Tuple *> batch;
+      for (oid_t insert_itr = 0; insert_itr < bulk_insert_count;
+           insert_itr++) {
+        tuple = node.GetTuple(insert_itr);
+        if (tuple == nullptr) {
+          // read from values
+          value_tuples.emplace_back(new storage::Tuple(schema, true));
+          for (uint32_t col_id = 0; col_id < num_columns; col_id++) {
+            auto value = node.GetValue(col_id + insert_itr * num_columns);
+            value_tuples.back()->SetValue(col_id, value, executor_pool);
+          }
+          tuple = value_tuples.back().get();
+        }
+        batch.push_back(tuple);
+      }
+
+      if (InsertBatch(target_table, batch) == false) {
+        LOG_TRACE("Failed to Insert. Set txn failure.");
+        return false;
+      }
+      bulk_insert_count = 0;
+    }
+
     // Bulk Insert Mode
     for (oid_t insert_itr = 0; insert_itr < bulk_insert_count; insert_itr++) {
       // if we are doing a bulk insert from values not project_info
@@ -305,5 +338,27 @@ bool InsertExecutor::DExecute() {
   return true;
 }
 
+bool InsertExecutor::InsertBatch(
+    storage::DataTable *target_table,
+    const std::vector<const storage::Tuple *> &tuples) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+
+  // the batch registers its inserts with the transaction itself
+  std::vector<ItemPointer> locations;
+  if (target_table->InsertTuples(tuples, current_txn, locations) == false) {
+    transaction_manager.SetTransactionResult(current_txn,
+                                             peloton::ResultType::FAILURE);
+    return false;
+  }
+
+  LOG_TRACE("Number of tuples in table after insert: %lu",
+            target_table->GetTupleCount());
+
+  executor_context_->num_processed += tuples.size();
+  return true;
+}
+
 }  // namespace executor
 }  // namespace peloton
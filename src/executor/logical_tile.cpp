@@ -357,6 +357,28 @@ LogicalTile::PositionListsBuilder::PositionListsBuilder(LogicalTile *left_tile,
   }
 }
 
+/**
+ * Reinitialize the position lists for the output tile of the given tiles,
+ * keeping the memory of the lists that weren't released
+ */
+void LogicalTile::PositionListsBuilder::Reset(LogicalTile *left_tile,
+                                              LogicalTile *right_tile) {
+  left_source_ = &left_tile->GetPositionLists();
+  right_source_ = &right_tile->GetPositionLists();
+  PL_ASSERT(left_source_->size() > 0);
+  PL_ASSERT(right_source_->size() > 0);
+
+  if (invalid_) {
+    output_lists_ = PositionLists();
+    invalid_ = false;
+  }
+  output_lists_.resize(left_source_->size() + right_source_->size());
+  for (auto &output_list : output_lists_) {
+    output_list.clear();
+    output_list.reserve(capacity_hint_);
+  }
+}
+
 /**
  * @brief Set the schema of the tile.
  * @param ColumnInfo-based schema of the tile.
@@ -574,6 +596,95 @@ void LogicalTile::MaterializeByTiles(
   }
 }
 
+namespace {
+
+/**
+ * @brief How a column of a logical tile is copied into a physical tile,
+ *        looked up once per column.
+ */
+struct ColumnCopy {
+  const LogicalTile::PositionList *position_list;
+  storage::Tile *old_tile;
+  size_t old_column_offset;
+  type::TypeId old_column_type;
+  bool old_is_inlined;
+  size_t new_column_offset;
+  bool new_is_inlined;
+  size_t new_column_length;
+
+  // The width of fixed-length values that are copied as they are stored,
+  // without boxing them into a type::Value, or zero if they can't be
+  size_t raw_length;
+};
+
+ColumnCopy GetColumnCopy(
+    const LogicalTile &source_tile, oid_t old_col_id,
+    const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
+    const storage::Tile &dest_tile) {
+  auto &column_info = source_tile.GetColumnInfo(old_col_id);
+
+  // Get old column information
+  storage::Tile *old_tile = column_info.base_tile.get();
+  auto old_schema = old_tile->GetSchema();
+  oid_t old_column_id = column_info.origin_column_id;
+
+  // Old to new column mapping
+  auto it = old_to_new_cols.find(old_col_id);
+  PL_ASSERT(it != old_to_new_cols.end());
+
+  // Get new column information
+  oid_t new_column_id = it->second;
+  auto new_schema = dest_tile.GetSchema();
+
+  ColumnCopy column{&source_tile.GetPositionList(column_info.position_list_idx),
+                    old_tile,
+                    old_schema->GetOffset(old_column_id),
+                    old_schema->GetType(old_column_id),
+                    old_schema->IsInlined(old_column_id),
+                    new_schema->GetOffset(new_column_id),
+                    new_schema->IsInlined(new_column_id),
+                    new_schema->GetAppropriateLength(new_column_id),
+                    0};
+
+  // Values of fixed-length types are stored the same way in both tiles, unless
+  // the old one is frozen and doesn't have slots to copy them from
+  bool fixed_length = column.old_column_type != type::TypeId::VARCHAR &&
+                      column.old_column_type != type::TypeId::VARBINARY;
+  if (fixed_length && column.old_is_inlined && column.new_is_inlined &&
+      !old_tile->IsFrozen() &&
+      column.old_column_type == new_schema->GetType(new_column_id) &&
+      old_schema->GetLength(old_column_id) == column.new_column_length) {
+    column.raw_length = column.new_column_length;
+  }
+  return column;
+}
+
+inline void CopyValue(const ColumnCopy &column, oid_t old_tuple_id,
+                      storage::Tile *dest_tile, oid_t new_tuple_id) {
+  oid_t base_tuple_id = (*column.position_list)[old_tuple_id];
+  if (base_tuple_id == NULL_OID) {
+    // The tuple was padded by an outer join
+    dest_tile->SetValueFast(
+        type::ValueFactory::GetNullValueByType(column.old_column_type),
+        new_tuple_id, column.new_column_offset, column.new_is_inlined,
+        column.new_column_length);
+  } else if (column.raw_length != 0) {
+    PL_MEMCPY(dest_tile->GetTupleLocation(new_tuple_id) +
+                  column.new_column_offset,
+              column.old_tile->GetTupleLocation(base_tuple_id) +
+                  column.old_column_offset,
+              column.raw_length);
+  } else {
+    type::Value value = column.old_tile->GetValueFast(
+        base_tuple_id, column.old_column_offset, column.old_column_type,
+        column.old_is_inlined);
+    dest_tile->SetValueFast(value, new_tuple_id, column.new_column_offset,
+                            column.new_is_inlined, column.new_column_length);
+  }
+}
+
+}  // namespace
+
 void LogicalTile::MaterializeRowAtAtATime(
     const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
     const std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols,
@@ -585,92 +696,26 @@ void LogicalTile::MaterializeRowAtAtATime(
   for (const auto &kv : tile_to_cols) {
     const std::vector<oid_t> &old_column_ids = kv.second;
 
-    auto &schema = GetSchema();
-    oid_t new_tuple_id = 0;
-
-    auto &column_position_lists = GetPositionLists();
-
-    // Get old column information
-    std::vector<oid_t> old_column_position_idxs;
-    std::vector<size_t> old_column_offsets;
-    std::vector<type::TypeId> old_column_types;
-    std::vector<bool> old_is_inlineds;
-    std::vector<storage::Tile *> old_tiles;
-
-    // Get new column information
-    std::vector<size_t> new_column_offsets;
-    std::vector<bool> new_is_inlineds;
-    std::vector<size_t> new_column_lengths;
-
     // Amortize schema lookups once per column
+    std::vector<ColumnCopy> columns;
+    columns.reserve(old_column_ids.size());
     for (oid_t old_col_id : old_column_ids) {
-      auto &column_info = schema[old_col_id];
-
-      // Get the position list
-      old_column_position_idxs.push_back(column_info.position_list_idx);
-
-      // Get old column information
-      storage::Tile *old_tile = column_info.base_tile.get();
-      old_tiles.push_back(old_tile);
-      auto old_schema = old_tile->GetSchema();
-      oid_t old_column_id = column_info.origin_column_id;
-      const size_t old_column_offset = old_schema->GetOffset(old_column_id);
-      old_column_offsets.push_back(old_column_offset);
-      const type::TypeId old_column_type =
-          old_schema->GetType(old_column_id);
-      old_column_types.push_back(old_column_type);
-      const bool old_is_inlined = old_schema->IsInlined(old_column_id);
-      old_is_inlineds.push_back(old_is_inlined);
-
-      // Old to new column mapping
-      auto it = old_to_new_cols.find(old_col_id);
-      PL_ASSERT(it != old_to_new_cols.end());
-
-      // Get new column information
-      oid_t new_column_id = it->second;
-      auto new_schema = dest_tile->GetSchema();
-      const size_t new_column_offset = new_schema->GetOffset(new_column_id);
-      new_column_offsets.push_back(new_column_offset);
-      const bool new_is_inlined = new_schema->IsInlined(new_column_id);
-      new_is_inlineds.push_back(new_is_inlined);
-      const size_t new_column_length =
-          new_schema->GetAppropriateLength(new_column_id);
-      new_column_lengths.push_back(new_column_length);
+      columns.push_back(
+          GetColumnCopy(*this, old_col_id, old_to_new_cols, *dest_tile));
     }
 
-    PL_ASSERT(new_column_offsets.size() == old_column_ids.size());
-
     ///////////////////////////
     // EACH TUPLE
     ///////////////////////////
     // Copy all values in the tuple to the physical tile
-    // This uses fast getter and setter functions
+    oid_t new_tuple_id = 0;
     for (oid_t old_tuple_id : *this) {
       ///////////////////////////
       // EACH COLUMN
       ///////////////////////////
       // Go over each column in given base physical tile
-      oid_t col_itr = 0;
-
-      for (oid_t old_col_id : old_column_position_idxs) {
-        auto &column_position_list = column_position_lists[old_col_id];
-
-        oid_t base_tuple_id = column_position_list[old_tuple_id];
-
-        auto value = old_tiles[col_itr]->GetValueFast(
-            base_tuple_id, old_column_offsets[col_itr],
-            old_column_types[col_itr], old_is_inlineds[col_itr]);
-
-        LOG_TRACE("Old Tuple : %u Column : %u ", old_tuple_id, old_col_id);
-        LOG_TRACE("New Tuple : %u Column : %lu ", new_tuple_id,
-                  new_column_offsets[col_itr]);
-
-        dest_tile->SetValueFast(
-            value, new_tuple_id, new_column_offsets[col_itr],
-            new_is_inlineds[col_itr], new_column_lengths[col_itr]);
-
-        // Go to next column
-        col_itr++;
+      for (const auto &column : columns) {
+        CopyValue(column, old_tuple_id, dest_tile, new_tuple_id);
       }
 
       // Go to next tuple
@@ -695,51 +740,17 @@ void LogicalTile::MaterializeColumnAtATime(
     ///////////////////////////
     // Go over each column in given base physical tile
     for (oid_t old_col_id : old_column_ids) {
-      auto &column_info = GetColumnInfo(old_col_id);
-
       // Amortize schema lookups once per column
-      storage::Tile *old_tile = column_info.base_tile.get();
-      auto old_schema = old_tile->GetSchema();
-
-      // Get old column information
-      oid_t old_column_id = column_info.origin_column_id;
-      const size_t old_column_offset = old_schema->GetOffset(old_column_id);
-      const type::TypeId old_column_type =
-          old_schema->GetType(old_column_id);
-      const bool old_is_inlined = old_schema->IsInlined(old_column_id);
-
-      // Old to new column mapping
-      auto it = old_to_new_cols.find(old_col_id);
-      PL_ASSERT(it != old_to_new_cols.end());
-
-      // Get new column information
-      oid_t new_column_id = it->second;
-      auto new_schema = dest_tile->GetSchema();
-      const size_t new_column_offset = new_schema->GetOffset(new_column_id);
-      const bool new_is_inlined = new_schema->IsInlined(new_column_id);
-      const size_t new_column_length =
-          new_schema->GetAppropriateLength(new_column_id);
-
-      // Get the position list
-      auto &column_position_list =
-          GetPositionList(column_info.position_list_idx);
-      oid_t new_tuple_id = 0;
+      auto column =
+          GetColumnCopy(*this, old_col_id, old_to_new_cols, *dest_tile);
 
-      // Copy all values in the column to the physical tile
-      // This uses fast getter and setter functions
       ///////////////////////////
       // EACH TUPLE
       ///////////////////////////
+      // Copy all values in the column to the physical tile
+      oid_t new_tuple_id = 0;
       for (oid_t old_tuple_id : *this) {
-        oid_t base_tuple_id = column_position_list[old_tuple_id];
-        type::Value value = (old_tile->GetValueFast(
-            base_tuple_id, old_column_offset, old_column_type, old_is_inlined));
-
-        LOG_TRACE("Old Tuple : %u Column : %u ", old_tuple_id, old_col_id);
-        LOG_TRACE("New Tuple : %u Column : %u ", new_tuple_id, new_column_id);
-
-        dest_tile->SetValueFast(value, new_tuple_id, new_column_offset,
-                                new_is_inlined, new_column_length);
+        CopyValue(column, old_tuple_id, dest_tile, new_tuple_id);
 
         // Go to next tuple
         new_tuple_id++;
@@ -757,9 +768,6 @@ std::unique_ptr<storage::Tile> LogicalTile::Materialize() {
   // Create new schema according underlying physical tile
   std::unique_ptr<catalog::Schema> source_tile_schema(GetPhysicalSchema());
 
-  // Get the number of tuples within this logical tiles
-  const int num_tuples = GetTupleCount();
-
   // const catalog::Schema *output_schema;
   std::unordered_map<oid_t, oid_t> old_to_new_cols;
   oid_t column_count = source_tile_schema->GetColumnCount();
@@ -767,18 +775,33 @@ std::unique_ptr<storage::Tile> LogicalTile::Materialize() {
     old_to_new_cols[col] = col;
   }
 
+  return Materialize(*source_tile_schema, old_to_new_cols);
+}
+
+/**
+ * @brief Create a physical tile of some of the columns
+ * @param output_schema Schema of the physical tile
+ * @param old_to_new_cols Columns of the physical tile for the columns of this
+ *        tile to be materialized
+ * @return Physical tile
+ */
+std::unique_ptr<storage::Tile> LogicalTile::Materialize(
+    const catalog::Schema &output_schema,
+    const std::unordered_map<oid_t, oid_t> &old_to_new_cols) {
+  // Get the number of tuples within this logical tiles
+  const int num_tuples = GetTupleCount();
+
   // Generate mappings.
   std::unordered_map<storage::Tile *, std::vector<oid_t>> tile_to_cols;
   GenerateTileToColMap(old_to_new_cols, tile_to_cols);
 
   // Create new physical tile.
   std::unique_ptr<storage::Tile> dest_tile(
-      storage::TileFactory::GetTempTile(*source_tile_schema, num_tuples));
+      storage::TileFactory::GetTempTile(output_schema, num_tuples));
 
   // Proceed to materialize logical tile by physical tile at a time.
   MaterializeByTiles(old_to_new_cols, tile_to_cols, dest_tile.get());
 
-  // Wrap physical tile in logical tile.
   return dest_tile;
 }
 
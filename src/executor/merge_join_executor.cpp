@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <map>
+
 #include "common/internal_types.h"
 #include "common/logger.h"
 #include "executor/logical_tile_factory.h"
@@ -40,6 +42,10 @@ bool MergeJoinExecutor::DInit() {
 
   if (join_clauses_ == nullptr) return false;
 
+  right_cursor_tile_ = 0;
+  right_cursor_row_ = 0;
+  output_tiles_.clear();
+
   return true;
 }
 
@@ -56,6 +62,10 @@ bool MergeJoinExecutor::DExecute() {
       left_start_row, left_end_row, left_child_done_, right_start_row,
       right_end_row, right_child_done_);
 
+  if (join_type_ == JoinType::INNER) {
+    return DExecuteInner();
+  }
+
   // Build outer join output when done
   if (right_child_done_ && left_child_done_) {
     return BuildOuterJoinOutput();
@@ -232,6 +242,138 @@ bool MergeJoinExecutor::DExecute() {
   return true;
 }
 
+/**
+ * @brief Buffers the right input, then merges it with the left tiles as they
+ * are produced. The output of a left tile is ordered on the join keys.
+ * @return true on success, false otherwise.
+ */
+bool MergeJoinExecutor::DExecuteInner() {
+  if (!right_child_done_) {
+    while (children_[1]->Execute()) {
+      BufferRightTile(children_[1]->GetOutput());
+    }
+    right_child_done_ = true;
+  }
+
+  for (;;) {
+    // Return the output of the last left tile first
+    if (!output_tiles_.empty()) {
+      SetOutput(output_tiles_.front().release());
+      output_tiles_.pop_front();
+      return true;
+    }
+
+    if (children_[0]->Execute() == false) {
+      left_child_done_ = true;
+      return false;
+    }
+
+    std::unique_ptr<LogicalTile> left_tile(children_[0]->GetOutput());
+    MergeLeftTile(left_tile.get());
+  }
+}
+
+void MergeJoinExecutor::MergeLeftTile(LogicalTile *left_tile) {
+  // The matches of the left tuples, grouped by the buffered right tile. As
+  // both inputs are sorted, the output is still sorted when the groups are
+  // emitted in the order of the right tiles.
+  std::map<size_t, std::vector<std::pair<oid_t, oid_t>>> matches;
+
+  for (auto left_row : *left_tile) {
+    ContainerTuple<LogicalTile> left_tuple(left_tile, left_row);
+
+    // A NULL key never matches
+    bool has_null_key = false;
+    for (auto &clause : *join_clauses_) {
+      if (clause.left_->Evaluate(&left_tuple, nullptr, executor_context_)
+              .IsNull()) {
+        has_null_key = true;
+        break;
+      }
+    }
+    if (has_null_key) {
+      continue;
+    }
+
+    // Skip the right tuples less than the left one. As the left tuples come
+    // in order, they are less than all the following left tuples too.
+    while (right_cursor_tile_ < right_result_tiles_.size()) {
+      auto right_tile = right_result_tiles_[right_cursor_tile_].get();
+      if (right_cursor_row_ >= right_tile->GetTupleCount()) {
+        right_cursor_tile_++;
+        right_cursor_row_ = 0;
+        continue;
+      }
+      ContainerTuple<LogicalTile> right_tuple(right_tile, right_cursor_row_);
+      if (CompareJoinKeys(left_tuple, right_tuple) <= 0) {
+        break;
+      }
+      right_cursor_row_++;
+    }
+
+    // Collect the run of right tuples with equal keys
+    size_t tile_idx = right_cursor_tile_;
+    size_t row = right_cursor_row_;
+    while (tile_idx < right_result_tiles_.size()) {
+      auto right_tile = right_result_tiles_[tile_idx].get();
+      if (row >= right_tile->GetTupleCount()) {
+        tile_idx++;
+        row = 0;
+        continue;
+      }
+      ContainerTuple<LogicalTile> right_tuple(right_tile, row);
+      if (CompareJoinKeys(left_tuple, right_tuple) != 0) {
+        break;
+      }
+      matches[tile_idx].emplace_back(left_row, row);
+      row++;
+    }
+  }
+
+  for (auto &tile_matches : matches) {
+    auto right_tile = right_result_tiles_[tile_matches.first].get();
+    auto output_tile = BuildOutputLogicalTile(left_tile, right_tile);
+    LogicalTile::PositionListsBuilder pos_lists_builder(left_tile, right_tile);
+    for (auto &match : tile_matches.second) {
+      if (predicate_ != nullptr) {
+        ContainerTuple<LogicalTile> left_tuple(left_tile, match.first);
+        ContainerTuple<LogicalTile> right_tuple(right_tile, match.second);
+        auto eval =
+            predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_);
+        if (eval.IsFalse()) {
+          continue;
+        }
+      }
+      pos_lists_builder.AddRow(match.first, match.second);
+    }
+
+    if (pos_lists_builder.Size() > 0) {
+      output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+      output_tiles_.push_back(std::move(output_tile));
+    }
+  }
+}
+
+int MergeJoinExecutor::CompareJoinKeys(
+    const AbstractTuple &left_tuple, const AbstractTuple &right_tuple) const {
+  for (auto &clause : *join_clauses_) {
+    auto left_value =
+        clause.left_->Evaluate(&left_tuple, &right_tuple, executor_context_);
+    auto right_value =
+        clause.right_->Evaluate(&left_tuple, &right_tuple, executor_context_);
+    if (right_value.IsNull()) {
+      return 1;
+    }
+    if (left_value.CompareLessThan(right_value) == CmpBool::TRUE) {
+      return -1;
+    }
+    if (left_value.CompareGreaterThan(right_value) == CmpBool::TRUE) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
 /**
  * @brief Advance the row iterator until value changes in terms of the join
  * clauses
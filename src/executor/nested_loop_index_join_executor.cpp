@@ -0,0 +1,276 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// nested_loop_index_join_executor.cpp
+//
+// Identification: src/executor/nested_loop_index_join_executor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/nested_loop_index_join_executor.h"
+
+#include <map>
+
+#include "catalog/manager.h"
+#include "common/container_tuple.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "expression/abstract_expression.h"
+#include "index/index.h"
+#include "planner/nested_loop_index_join_plan.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @brief Constructor for nested loop index join executor.
+ * @param node Nested loop index join node corresponding to this executor.
+ */
+NestedLoopIndexJoinExecutor::NestedLoopIndexJoinExecutor(
+    const planner::AbstractPlan *node, ExecutorContext *executor_context)
+    : AbstractJoinExecutor(node, executor_context) {}
+
+/**
+ * @brief Grab the index of the inner table and allocate the probe key.
+ * @return true on success, false otherwise.
+ */
+bool NestedLoopIndexJoinExecutor::DInit() {
+  auto status = AbstractJoinExecutor::DInit();
+  if (status == false) {
+    return status;
+  }
+
+  const auto &node = GetPlanNode<planner::NestedLoopIndexJoinPlan>();
+
+  inner_table_ = node.GetInnerTable();
+  index_ = node.GetIndex();
+  inner_predicate_ = node.GetInnerPredicate();
+  inner_column_ids_ = node.GetInnerColumnIds();
+  acquire_owner_ = node.IsForUpdate();
+  PL_ASSERT(inner_table_ != nullptr && index_ != nullptr);
+
+  // Only the equality on the whole key is supported
+  PL_ASSERT(node.GetJoinColumnsLeft().size() ==
+            index_->GetKeySchema()->GetColumnCount());
+  probe_key_.reset(new storage::Tuple(index_->GetKeySchema(), true));
+  probe_pool_.reset(new type::EphemeralPool());
+
+  output_tiles_.clear();
+
+  return true;
+}
+
+/**
+ * @brief Creates logical tiles by joining the tiles of the left child with the
+ * inner tuples found through the index.
+ * @return true on success, false otherwise.
+ */
+bool NestedLoopIndexJoinExecutor::DExecute() {
+  LOG_TRACE("********** Nested Loop Index %s Join executor :: 2 children ",
+            GetJoinTypeString());
+
+  for (;;) {
+    // Return the output of the last outer tile first
+    if (!output_tiles_.empty()) {
+      SetOutput(output_tiles_.front().release());
+      output_tiles_.pop_front();
+      return true;
+    }
+
+    // Left child is finished, no more tiles
+    if (children_[0]->Execute() == false) {
+      LOG_TRACE("Left child is exhausted.");
+      return false;
+    }
+
+    std::unique_ptr<LogicalTile> left_tile(children_[0]->GetOutput());
+    if (JoinTile(left_tile.get()) == false) {
+      return false;
+    }
+  }
+}
+
+bool NestedLoopIndexJoinExecutor::JoinTile(LogicalTile *left_tile) {
+  auto &manager = catalog::Manager::GetInstance();
+
+  // The matches of every outer tuple, grouped by the tile group of the inner
+  // tuple. An output tile is built for every inner tile group.
+  std::map<oid_t, std::vector<std::pair<oid_t, oid_t>>> matches;
+
+  std::vector<ItemPointer> locations;
+  for (auto left_row : *left_tile) {
+    ContainerTuple<LogicalTile> left_tuple(left_tile, left_row);
+
+    locations.clear();
+    if (ProbeIndex(left_tuple, locations) == false) {
+      return false;
+    }
+    for (auto &location : locations) {
+      oid_t offset = location.offset;
+      matches[location.block].emplace_back(left_row, offset);
+    }
+  }
+
+  for (auto &tile_group_matches : matches) {
+    auto tile_group = manager.GetTileGroup(tile_group_matches.first);
+    auto &pairs = tile_group_matches.second;
+
+    // The inner tile holds one row per match, in the order of the matches
+    std::unique_ptr<LogicalTile> right_tile(LogicalTileFactory::GetTile());
+    right_tile->AddColumns(tile_group, inner_column_ids_);
+    LogicalTile::PositionList inner_positions;
+    for (auto &pair : pairs) {
+      inner_positions.push_back(pair.second);
+    }
+    right_tile->AddPositionList(std::move(inner_positions));
+
+    auto output_tile = BuildOutputLogicalTile(left_tile, right_tile.get());
+    LogicalTile::PositionListsBuilder pos_lists_builder(left_tile,
+                                                        right_tile.get());
+    for (oid_t right_row = 0; right_row < pairs.size(); right_row++) {
+      auto left_row = pairs[right_row].first;
+      if (predicate_ != nullptr) {
+        ContainerTuple<LogicalTile> left_tuple(left_tile, left_row);
+        ContainerTuple<LogicalTile> right_tuple(right_tile.get(), right_row);
+        auto eval =
+            predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_);
+        if (eval.IsFalse()) {
+          continue;
+        }
+      }
+      pos_lists_builder.AddRow(left_row, right_row);
+    }
+
+    if (pos_lists_builder.Size() > 0) {
+      output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+      output_tiles_.push_back(std::move(output_tile));
+    }
+  }
+
+  return true;
+}
+
+bool NestedLoopIndexJoinExecutor::ProbeIndex(
+    const AbstractTuple &left_tuple, std::vector<ItemPointer> &locations) {
+  const auto &node = GetPlanNode<planner::NestedLoopIndexJoinPlan>();
+  const auto &join_column_ids_left = node.GetJoinColumnsLeft();
+  auto *key_schema = index_->GetKeySchema();
+
+  // The varlen key values of the previous probe are no longer needed
+  probe_pool_.reset(new type::EphemeralPool());
+
+  // Build the probe key. NULL never compares equal, and a value that cannot be
+  // cast to the key type equals no key, so there is no match in both cases.
+  for (oid_t key_col = 0; key_col < join_column_ids_left.size(); key_col++) {
+    auto value = left_tuple.GetValue(join_column_ids_left[key_col]);
+    if (value.IsNull()) {
+      return true;
+    }
+    try {
+      probe_key_->SetValue(
+          key_col, value.CastAs(key_schema->GetColumn(key_col).GetType()),
+          probe_pool_.get());
+    } catch (Exception &e) {
+      return true;
+    }
+  }
+
+  std::vector<ItemPointer *> tuple_location_ptrs;
+  index_->ScanKey(probe_key_.get(), tuple_location_ptrs);
+  if (tuple_location_ptrs.empty()) {
+    return true;
+  }
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+  auto &manager = catalog::Manager::GetInstance();
+
+  // Traverse the version chain of every index entry until the version visible
+  // to the transaction is found, as in IndexScanExecutor
+  for (auto tuple_location_ptr : tuple_location_ptrs) {
+    ItemPointer tuple_location = *tuple_location_ptr;
+    auto tile_group = manager.GetTileGroup(tuple_location.block);
+    auto tile_group_header = tile_group->GetHeader();
+    size_t chain_length = 0;
+
+    while (true) {
+      ++chain_length;
+
+      auto visibility = transaction_manager.IsVisible(
+          current_txn, tile_group_header, tuple_location.offset);
+
+      if (visibility == VisibilityType::DELETED) {
+        break;
+      } else if (visibility == VisibilityType::OK) {
+        bool eval = true;
+        if (inner_predicate_ != nullptr) {
+          ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                   tuple_location.offset);
+          eval = inner_predicate_->Evaluate(&tuple, nullptr, executor_context_)
+                     .IsTrue();
+        }
+        if (eval == true) {
+          auto res = transaction_manager.PerformRead(
+              current_txn, tuple_location, acquire_owner_);
+          if (!res) {
+            transaction_manager.SetTransactionResult(current_txn,
+                                                     ResultType::FAILURE);
+            return res;
+          }
+          locations.push_back(tuple_location);
+        }
+        break;
+      } else {
+        PL_ASSERT(visibility == VisibilityType::INVISIBLE);
+
+        bool is_acquired = (tile_group_header->GetTransactionId(
+                                tuple_location.offset) == INITIAL_TXN_ID);
+        bool is_alive =
+            (tile_group_header->GetEndCommitId(tuple_location.offset) <=
+             current_txn->GetReadId());
+        if (is_acquired && is_alive) {
+          // The version chain was modified by another transaction, start over
+          // from the head of the chain
+          tuple_location =
+              *(tile_group_header->GetIndirection(tuple_location.offset));
+          tile_group = manager.GetTileGroup(tuple_location.block);
+          tile_group_header = tile_group->GetHeader();
+          chain_length = 0;
+          continue;
+        }
+
+        ItemPointer old_item = tuple_location;
+        tuple_location = tile_group_header->GetNextItemPointer(old_item.offset);
+
+        if (tuple_location.IsNull()) {
+          if (chain_length == 1) {
+            break;
+          }
+          transaction_manager.SetTransactionResult(current_txn,
+                                                   ResultType::FAILURE);
+          return false;
+        }
+
+        tile_group = manager.GetTileGroup(tuple_location.block);
+        tile_group_header = tile_group->GetHeader();
+      }
+    }
+  }
+
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -135,8 +135,7 @@ bool NestedLoopJoinExecutor::DExecute() {
             BuildOutputLogicalTile(left_tile_.get(), right_tile.get());
 
         // Build position list
-        LogicalTile::PositionListsBuilder pos_lists_builder(left_tile_.get(),
-                                                            right_tile.get());
+        pos_lists_builder_.Reset(left_tile_.get(), right_tile.get());
 
         // Go over every pair of tuples in left and right logical tiles
         for (auto right_tile_row_itr : *right_tile) {
@@ -158,15 +157,15 @@ bool NestedLoopJoinExecutor::DExecute() {
             }
             LOG_TRACE("Find a tuple with join predicate");
           }
-          pos_lists_builder.AddRow(left_tile_row_itr_, right_tile_row_itr);
+          pos_lists_builder_.AddRow(left_tile_row_itr_, right_tile_row_itr);
         }  // Outer loop of NLJ
 
         // Now current left tile is done
-        LOG_TRACE("pos_lists_builder's size : %ld", pos_lists_builder.Size());
-        if (pos_lists_builder.Size() > 0) {
+        LOG_TRACE("pos_lists_builder_'s size : %ld", pos_lists_builder_.Size());
+        if (pos_lists_builder_.Size() > 0) {
           LOG_TRACE("Set output result");
           output_tile->SetPositionListsAndVisibility(
-              pos_lists_builder.Release());
+              pos_lists_builder_.Release());
           SetOutput(output_tile.release());
           LOG_TRACE("result is : %s", GetOutputInfo()->GetInfo().c_str());
           return true;
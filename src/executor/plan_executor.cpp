@@ -13,6 +13,7 @@
 #include "executor/plan_executor.h"
 
 #include "codegen/buffering_consumer.h"
+#include "codegen/precompiled_plan.h"
 #include "codegen/query.h"
 #include "codegen/query_cache.h"
 #include "codegen/query_compiler.h"
@@ -22,6 +23,7 @@
 #include "executor/executors.h"
 #include "settings/settings_manager.h"
 #include "storage/tuple_iterator.h"
+#include "threadpool/mono_queue_pool.h"
 
 namespace peloton {
 namespace executor {
@@ -32,6 +34,44 @@ executor::AbstractExecutor *BuildExecutorTree(
 
 void CleanExecutorTree(executor::AbstractExecutor *root);
 
+// Recompile the cached query of the plan at the aggressive optimization tier
+// on the brain's worker pool, and replace it once done. Executions keep using
+// the cached query in the meantime. Executions bind the plan itself, so the
+// recompilation binds and compiles a private copy of it.
+static void RecompileInBackground(const planner::AbstractPlan &cached_plan,
+                                  const std::vector<type::Value> &params,
+                                  const codegen::Query *query) {
+  std::shared_ptr<planner::AbstractPlan> plan = cached_plan.CopyTree();
+  if (plan == nullptr) {
+    LOG_DEBUG("Not recompiling query, its plan can't be copied");
+    return;
+  }
+  hash_t plan_hash = cached_plan.Hash();
+
+  auto &pool = threadpool::MonoQueuePool::GetBrainInstance();
+  pool.SubmitTask([plan, plan_hash, params, query] {
+    LOG_DEBUG("Recompiling query at the aggressive optimization tier");
+    try {
+      planner::BindingContext context;
+      plan->PerformBinding(context);
+      std::vector<oid_t> columns;
+      plan->GetOutputColumns(columns);
+      codegen::BufferingConsumer consumer{columns, context};
+
+      codegen::QueryParameters parameters{*plan, params};
+      codegen::QueryCompiler compiler;
+      auto recompiled_query = compiler.Compile(
+          *plan, parameters.GetQueryParametersMap(), consumer, nullptr,
+          codegen::CodeContext::OptimizationTier::Aggressive);
+      codegen::QueryCache::Instance().Replace(plan_hash, query, plan,
+                                              std::move(recompiled_query));
+    } catch (const std::exception &e) {
+      // The query keeps running at its current tier
+      LOG_ERROR("Recompiling query failed: %s", e.what());
+    }
+  });
+}
+
 static void CompileAndExecutePlan(
     std::shared_ptr<planner::AbstractPlan> plan,
     concurrency::TransactionContext *txn,
@@ -53,16 +93,6 @@ static void CompileAndExecutePlan(
       new executor::ExecutorContext(txn,
                                     codegen::QueryParameters(*plan, params)));
 
-  // Compile the query
-  codegen::Query *query = codegen::QueryCache::Instance().Find(plan);
-  if (query == nullptr) {
-    codegen::QueryCompiler compiler;
-    auto compiled_query = compiler.Compile(
-        *plan, executor_context->GetParams().GetQueryParametersMap(), consumer);
-    query = compiled_query.get();
-    codegen::QueryCache::Instance().Add(plan, std::move(compiled_query));
-  }
-
   auto on_query_result =
       [&on_complete, &consumer](executor::ExecutionResult result) {
         std::vector<ResultValue> values;
@@ -77,7 +107,45 @@ static void CompileAndExecutePlan(
         on_complete(result, std::move(values));
       };
 
-  query->Execute(std::move(executor_context), consumer, on_query_result);
+  // Plans of simple shapes run precompiled, without generating any code
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::codegen_precompiled_plans)) {
+    auto precompiled =
+        codegen::PrecompiledPlan::Match(*plan, executor_context->GetParams());
+    if (precompiled != nullptr) {
+      LOG_TRACE("Executing precompiled plan ...");
+      precompiled->Execute(*executor_context, columns, consumer);
+      executor::ExecutionResult result;
+      result.m_result = ResultType::SUCCESS;
+      result.m_processed = executor_context->num_processed;
+      on_query_result(result);
+      return;
+    }
+  }
+
+  // Compile the query
+  // Prepared statements are compiled once per parameter types, later
+  // executions only bind the new values
+  const auto &parameters_map =
+      executor_context->GetParams().GetQueryParametersMap();
+  auto &query_cache = codegen::QueryCache::Instance();
+  codegen::Query *query = query_cache.Find(plan, &parameters_map);
+  if (query == nullptr) {
+    codegen::QueryCompiler compiler;
+    auto compiled_query = compiler.Compile(*plan, parameters_map, consumer);
+    query = compiled_query.get();
+    query_cache.Add(plan, std::move(compiled_query));
+  }
+
+  codegen::Query::RuntimeStats stats;
+  query->Execute(std::move(executor_context), consumer, on_query_result,
+                 &stats);
+
+  // Recompile queries that ran long enough to pay off aggressive optimization
+  double execution_ms = stats.init_ms + stats.plan_ms + stats.tear_down_ms;
+  if (query_cache.RecordExecution(plan, query, execution_ms)) {
+    RecompileInBackground(*plan, params, query);
+  }
 }
 
 static void InterpretPlan(
@@ -279,6 +347,11 @@ executor::AbstractExecutor *BuildExecutorTree(
           new executor::NestedLoopJoinExecutor(plan, executor_context);
       break;
 
+    case PlanNodeType::NESTLOOPINDEX:
+      child_executor =
+          new executor::NestedLoopIndexJoinExecutor(plan, executor_context);
+      break;
+
     case PlanNodeType::MERGEJOIN:
       child_executor = new executor::MergeJoinExecutor(plan, executor_context);
       break;
@@ -20,9 +20,22 @@ ComparisonExpression::ComparisonExpression(ExpressionType type,
                                            AbstractExpression *right)
     : AbstractExpression(type, type::TypeId::BOOLEAN, left, right) {}
 
+ComparisonExpression::ComparisonExpression(
+    AbstractExpression *value, const std::vector<AbstractExpression *> &list)
+    : AbstractExpression(ExpressionType::COMPARE_IN, type::TypeId::BOOLEAN,
+                         value, nullptr) {
+  for (auto *item : list) {
+    children_.emplace_back(item);
+  }
+}
+
 type::Value ComparisonExpression::Evaluate(
     const AbstractTuple *tuple1, const AbstractTuple *tuple2,
     executor::ExecutorContext *context) const {
+  if (exp_type_ == ExpressionType::COMPARE_IN) {
+    return EvaluateInList(tuple1, tuple2, context);
+  }
+
   PL_ASSERT(children_.size() == 2);
   auto vl = children_[0]->Evaluate(tuple1, tuple2, context);
   auto vr = children_[1]->Evaluate(tuple1, tuple2, context);
@@ -53,7 +66,40 @@ type::Value ComparisonExpression::Evaluate(
   }
 }
 
+// NULL if the value is NULL, or if it is in no list item but one of them is
+// NULL. The list is scanned until the first match.
+type::Value ComparisonExpression::EvaluateInList(
+    const AbstractTuple *tuple1, const AbstractTuple *tuple2,
+    executor::ExecutorContext *context) const {
+  PL_ASSERT(children_.size() >= 2);
+  auto value = children_[0]->Evaluate(tuple1, tuple2, context);
+  if (value.IsNull()) {
+    return type::ValueFactory::GetNullValueByType(type::TypeId::BOOLEAN);
+  }
+
+  bool has_null = false;
+  for (size_t i = 1; i < children_.size(); i++) {
+    auto item = children_[i]->Evaluate(tuple1, tuple2, context);
+    if (item.IsNull()) {
+      has_null = true;
+    } else if (value.CompareEquals(item) == CmpBool::TRUE) {
+      return type::ValueFactory::GetBooleanValue(true);
+    }
+  }
+  if (has_null) {
+    return type::ValueFactory::GetNullValueByType(type::TypeId::BOOLEAN);
+  }
+  return type::ValueFactory::GetBooleanValue(false);
+}
+
 AbstractExpression *ComparisonExpression::Copy() const {
+  if (exp_type_ == ExpressionType::COMPARE_IN) {
+    std::vector<AbstractExpression *> list;
+    for (size_t i = 1; i < children_.size(); i++) {
+      list.push_back(children_[i]->Copy());
+    }
+    return new ComparisonExpression(GetChild(0)->Copy(), list);
+  }
   return new ComparisonExpression(GetExpressionType(), GetChild(0)->Copy(),
                                   GetChild(1)->Copy());
 }
@@ -12,6 +12,10 @@
 
 #include "function/string_functions.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "common/macros.h"
 #include "executor/executor_context.h"
 
@@ -24,73 +28,142 @@ uint32_t StringFunctions::Ascii(UNUSED_ATTRIBUTE executor::ExecutorContext &ctx,
   return length <= 1 ? 0 : static_cast<uint32_t>(str[0]);
 }
 
-#define NextByte(p, plen) ((p)++, (plen)--)
-
-bool StringFunctions::Like(UNUSED_ATTRIBUTE executor::ExecutorContext &ctx,
-                           const char *t, uint32_t tlen, const char *p,
-                           uint32_t plen) {
-  PL_ASSERT(t != nullptr);
-  PL_ASSERT(p != nullptr);
-  if (plen == 1 && *p == '%') return true;
-
-  while (tlen > 0 && plen > 0) {
-    if (*p == '\\') {
-      NextByte(p, plen);
-      if (plen <= 0) return false;
-      if (tolower(*p) != tolower(*t)) return false;
-    } else if (*p == '%') {
-      char firstpat;
-      NextByte(p, plen);
-
-      while (plen > 0) {
-        if (*p == '%')
-          NextByte(p, plen);
-        else if (*p == '_') {
-          if (tlen <= 0) return false;
-          NextByte(t, tlen);
-          NextByte(p, plen);
-        } else
-          break;
-      }
-
-      if (plen <= 0) return true;
+namespace {
 
-      if (*p == '\\') {
-        if (plen < 2) return false;
-        firstpat = tolower(p[1]);
-      } else
-        firstpat = tolower(*p);
+// The matching is case insensitive, like it has always been
+inline char Fold(char c) {
+  return static_cast<char>(tolower(static_cast<unsigned char>(c)));
+}
 
-      while (tlen > 0) {
-        if (tolower(*t) == firstpat) {
-          int matched = Like(ctx, t, tlen, p, plen);
+bool EqualsNoCase(const char *a, const char *b, uint32_t len) {
+  for (uint32_t i = 0; i < len; i++) {
+    if (Fold(a[i]) != Fold(b[i])) return false;
+  }
+  return true;
+}
 
-          if (matched != false) return matched;
-        }
+#if defined(__SSE2__)
+// Fold the ASCII upper case letters of the 16 bytes to lower case. Bytes above
+// 0x7F are negative and never fall in the range.
+inline __m128i FoldBlock(__m128i block) {
+  __m128i upper =
+      _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('A' - 1)),
+                    _mm_cmplt_epi8(block, _mm_set1_epi8('Z' + 1)));
+  return _mm_or_si128(block, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+#endif
+
+// Search for the needle in the text. With SSE2, 16 candidate positions are
+// tested at once by comparing the first and the last byte of the needle, and
+// only the positions where both match are compared in full.
+bool ContainsNoCase(const char *t, uint32_t tlen, const char *n,
+                    uint32_t nlen) {
+  if (nlen == 0) return true;
+  if (nlen > tlen) return false;
+
+  char first = Fold(n[0]);
+  uint32_t pos = 0;
+#if defined(__SSE2__)
+  const __m128i first_bytes = _mm_set1_epi8(first);
+  const __m128i last_bytes = _mm_set1_epi8(Fold(n[nlen - 1]));
+  for (; pos + nlen + 15 <= tlen; pos += 16) {
+    __m128i block_first = FoldBlock(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(t + pos)));
+    __m128i block_last = FoldBlock(_mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(t + pos + nlen - 1)));
+    auto mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first_bytes),
+                                        _mm_cmpeq_epi8(block_last, last_bytes))));
+    while (mask != 0) {
+      uint32_t offset = pos + __builtin_ctz(mask);
+      if (EqualsNoCase(t + offset, n, nlen)) return true;
+      mask &= mask - 1;
+    }
+  }
+#endif
+  for (; pos + nlen <= tlen; pos++) {
+    if (Fold(t[pos]) == first && EqualsNoCase(t + pos, n, nlen)) return true;
+  }
+  return false;
+}
 
-        NextByte(t, tlen);
+// Match the text against an arbitrary pattern. The pattern is walked once,
+// remembering the last '%' seen. On a mismatch, the '%' is made to swallow one
+// more byte of the text and the match resumes right after it. The earlier
+// '%'s never have to be revisited, so there is no recursion and the work is
+// bounded by tlen * plen.
+bool MatchGeneral(const char *t, uint32_t tlen, const char *p,
+                  uint32_t plen) {
+  uint32_t tpos = 0, ppos = 0;
+  bool has_wildcard = false;
+  uint32_t wildcard_ppos = 0, wildcard_tpos = 0;
+
+  while (tpos < tlen) {
+    if (ppos < plen) {
+      if (p[ppos] == '%') {
+        has_wildcard = true;
+        wildcard_ppos = ++ppos;
+        wildcard_tpos = tpos;
+        continue;
+      }
+      if (p[ppos] == '_') {
+        tpos++;
+        ppos++;
+        continue;
+      }
+      uint32_t literal_pos = p[ppos] == '\\' ? ppos + 1 : ppos;
+      if (literal_pos < plen && Fold(p[literal_pos]) == Fold(t[tpos])) {
+        tpos++;
+        ppos = literal_pos + 1;
+        continue;
       }
-      return false;
-    } else if (*p == '_') {
-      NextByte(t, tlen);
-      NextByte(p, plen);
-      continue;
-    } else if (tolower(*p) != tolower(*t)) {
-      return false;
     }
-    NextByte(t, tlen);
-    NextByte(p, plen);
+    if (!has_wildcard) return false;
+    ppos = wildcard_ppos;
+    tpos = ++wildcard_tpos;
   }
 
-  if (tlen > 0) return false;
+  while (ppos < plen && p[ppos] == '%') ppos++;
+  return ppos == plen;
+}
 
-  while (plen > 0 && *p == '%') NextByte(p, plen);
-  if (plen <= 0) return true;
+}  // namespace
 
-  return false;
-}
+bool StringFunctions::Like(UNUSED_ATTRIBUTE executor::ExecutorContext &ctx,
+                           const char *t, uint32_t tlen, const char *p,
+                           uint32_t plen) {
+  PL_ASSERT(t != nullptr);
+  PL_ASSERT(p != nullptr);
+
+  // The compiled code passes the lengths including the terminating NUL
+  if (tlen > 0 && t[tlen - 1] == '\0') tlen--;
+  if (plen > 0 && p[plen - 1] == '\0') plen--;
+
+  // Most patterns are a literal with a '%' at either or both ends. Find the
+  // literal and match it directly.
+  uint32_t begin = 0, end = plen;
+  while (begin < end && p[begin] == '%') begin++;
+  while (end > begin && p[end - 1] == '%') end--;
+  for (uint32_t i = begin; i < end; i++) {
+    if (p[i] == '%' || p[i] == '_' || p[i] == '\\') {
+      return MatchGeneral(t, tlen, p, plen);
+    }
+  }
 
-#undef NextByte
+  const char *literal = p + begin;
+  uint32_t literal_len = end - begin;
+  bool any_prefix = begin > 0, any_suffix = end < plen;
+  if (any_prefix && any_suffix) {
+    return ContainsNoCase(t, tlen, literal, literal_len);
+  } else if (any_suffix) {
+    return tlen >= literal_len && EqualsNoCase(t, literal, literal_len);
+  } else if (any_prefix) {
+    return tlen >= literal_len &&
+           EqualsNoCase(t + tlen - literal_len, literal, literal_len);
+  } else {
+    return tlen == literal_len && EqualsNoCase(t, literal, literal_len);
+  }
+}
 
 StringFunctions::StrWithLen StringFunctions::Substr(
     UNUSED_ATTRIBUTE executor::ExecutorContext &ctx, const char *str,
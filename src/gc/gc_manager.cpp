@@ -16,6 +16,7 @@
 #include "concurrency/transaction_context.h"
 #include "type/value.h"
 #include "type/abstract_pool.h"
+#include "storage/string_dictionary.h"
 #include "storage/tile.h"
 #include "storage/tile_group.h"
 
@@ -38,6 +39,10 @@ void GCManager::CheckAndReclaimVarlenColumns(storage::TileGroup *tg, oid_t tuple
 
         storage::Tile *tile = tg->GetTile(tile_itr);
         PL_ASSERT(tile);
+        // Varlen data of frozen tiles is owned by their compressed columns
+        if (tile->IsFrozen()) {
+          continue;
+        }
         for (oid_t tile_col_itr = 0; tile_col_itr < tile_col_count; ++tile_col_itr) {
             type_id = schema.GetType(tile_col_itr);
 
@@ -50,9 +55,23 @@ void GCManager::CheckAndReclaimVarlenColumns(storage::TileGroup *tg, oid_t tuple
               tuple_location = tile->GetTupleLocation(tuple_id);
             field_location = tuple_location + schema.GetOffset(tile_col_itr);
             varlen_ptr = type::Value::GetDataFromStorage(type_id, field_location);
+            // Entries of dictionary-encoded columns are shared by the table,
+            // only values that didn't fit into the dictionary are the tuple's
+            if (tile->GetColumnDictionary(tile_col_itr) != nullptr) {
+              if (varlen_ptr != nullptr &&
+                  storage::StringDictionary::IsUnencoded(varlen_ptr)) {
+                storage::StringDictionary::FreeUnencoded(tile->pool.get(),
+                                                         varlen_ptr);
+                *reinterpret_cast<char **>(field_location) = nullptr;
+              }
+              continue;
+            }
             // Call the corresponding varlen pool free
               if (varlen_ptr != nullptr) {
                 tile->pool->Free(varlen_ptr);
+                // The block may be handed out again right away, so don't
+                // leave the recycled slot pointing at it
+                *reinterpret_cast<char **>(field_location) = nullptr;
               }
           }
       }
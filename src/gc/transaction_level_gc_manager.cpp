@@ -146,6 +146,12 @@ int TransactionLevelGCManager::Unlink(const int &thread_id,
       }
     }
 
+    // Committed writes may have left their tile groups all-visible
+    if (txn_ctx->GetIsolationLevel() != IsolationLevelType::READ_ONLY &&
+        txn_ctx->GetResult() == ResultType::SUCCESS) {
+      MarkAllVisible(txn_ctx);
+    }
+
     // Deallocate the Transaction Context of transactions that don't involve
     // any garbage collection
     if (txn_ctx->GetIsolationLevel() == IsolationLevelType::READ_ONLY || \
@@ -323,6 +329,34 @@ void TransactionLevelGCManager::StopGC() {
   }
 }
 
+void TransactionLevelGCManager::MarkAllVisible(
+    concurrency::TransactionContext *txn_ctx) {
+  auto &manager = catalog::Manager::GetInstance();
+  for (const auto &tile_group_entry : txn_ctx->GetReadWriteSet()) {
+    bool written = false;
+    for (const auto &tuple_entry : tile_group_entry.second) {
+      if (tuple_entry.second != RWType::READ &&
+          tuple_entry.second != RWType::READ_OWN) {
+        written = true;
+        break;
+      }
+    }
+    if (!written) {
+      continue;
+    }
+
+    // The tile group may have been dropped with its table
+    auto tile_group = manager.GetTileGroup(tile_group_entry.first);
+    if (tile_group == nullptr) {
+      continue;
+    }
+    auto tile_group_header = tile_group->GetHeader();
+    if (tile_group_header->GetAllVisibleCommitId() == INVALID_CID) {
+      tile_group_header->ComputeAllVisible();
+    }
+  }
+}
+
 void TransactionLevelGCManager::UnlinkVersions(
     concurrency::TransactionContext *txn_ctx) {
   for (auto entry : *(txn_ctx->GetGCSetPtr().get())) {
@@ -111,6 +111,7 @@ extern double stock_original_ratio;
 extern int stock_min_quantity;
 extern int stock_max_quantity;
 extern int stock_dist_count;
+extern int stock_batch_size;
 
 extern double payment_min_amount;
 extern double payment_max_amount;
@@ -94,6 +94,12 @@ struct Configuration {
   // Do we dictionary encode strings?
   bool dictionary_encode = true;
 
+  // Do we freeze (compress) tile groups once a table is loaded?
+  bool freeze_tables = false;
+
+  // Do scans evaluate comparisons on fixed-length columns using SIMD kernels?
+  bool simd_predicates = true;
+
   // Which queries will the benchmark run?
   bool queries_to_run[22] = {false};
 
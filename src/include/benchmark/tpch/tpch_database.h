@@ -51,6 +51,9 @@ class TPCHDatabase {
 
   void LoadTable(TableId table_id);
 
+  // Freeze all full tile groups of the given table into compressed cold tiles
+  void FreezeTable(TableId table_id);
+
   // Load individual tables
   void LoadCustomerTable();
   void LoadLineitemTable();
@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tiering_tuner.h
+//
+// Identification: src/include/brain/tiering_tuner.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/internal_types.h"
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+}
+
+namespace brain {
+
+//===--------------------------------------------------------------------===//
+// Tiering Tuner
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief      Moves tile groups between the hot (uncompressed, mutable) and
+ *             cold (compressed, immutable) tiers.
+ *
+ * A tile group is cold if none of its versions was written in the last
+ * cold_epoch_threshold epochs. Cold tile groups are frozen, frozen tile groups
+ * that are written again are thawed, and the tiles replaced along the way are
+ * freed once their epoch expires.
+ */
+class TieringTuner {
+ public:
+  TieringTuner(const TieringTuner &) = delete;
+  TieringTuner &operator=(const TieringTuner &) = delete;
+  TieringTuner(TieringTuner &&) = delete;
+  TieringTuner &operator=(TieringTuner &&) = delete;
+
+  TieringTuner();
+
+  ~TieringTuner();
+
+  /**
+   * Singleton
+   *
+   * @return     The instance.
+   */
+  static TieringTuner &GetInstance();
+
+  /**
+   * Start tuning
+   */
+  void Start();
+
+  /**
+   * Tune tiers until stopped
+   */
+  void Tune();
+
+  /**
+   * Stop tuning
+   */
+  void Stop();
+
+  /**
+   * Freeze cold tile groups, thaw warm ones and reclaim retired tiles of the
+   * given table
+   *
+   * @param      table  The table
+   */
+  void TuneTable(storage::DataTable *table);
+
+  /**
+   * Add table to list of tables whose tiers must be tuned
+   *
+   * @param      table  The table
+   */
+  void AddTable(storage::DataTable *table);
+
+  /**
+   * Remove table from list of tables whose tiers must be tuned. Waits for a
+   * tuning pass over the table to finish.
+   *
+   * @param      table  The table
+   */
+  void RemoveTable(storage::DataTable *table);
+
+  /**
+   * Clear list
+   */
+  void ClearTables();
+
+  /**
+   * Get # of tables whose tiers are tuned
+   */
+  size_t GetTableCount();
+
+  /**
+   * Set the number of write-free epochs after which a tile group is cold
+   *
+   * @param[in]  cold_epoch_threshold  The threshold
+   */
+  void SetColdEpochThreshold(eid_t cold_epoch_threshold) {
+    this->cold_epoch_threshold = cold_epoch_threshold;
+  }
+
+ private:
+  /**
+   * Tables whose tiers must be tuned
+   */
+  std::vector<storage::DataTable *> tables;
+
+  std::mutex tiering_tuner_mutex;
+
+  /**
+   * Stop signal
+   */
+  std::atomic<bool> tiering_tuning_stop;
+
+  /**
+   * Tuner thread
+   */
+  std::thread tiering_tuner_thread;
+
+  //===--------------------------------------------------------------------===//
+  // Tuner Parameters
+  //===--------------------------------------------------------------------===//
+
+  /**
+   * Number of epochs without writes after which a tile group is frozen.
+   * With 40 ms epochs, the default is ten seconds.
+   */
+  eid_t cold_epoch_threshold = 250;
+
+  /** Sleeping period (in ms) */
+  oid_t sleep_duration = 1000;
+};
+
+}  // namespace brain
+}  // namespace peloton
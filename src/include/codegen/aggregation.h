@@ -36,22 +36,50 @@ namespace codegen {
 //
 // Note: the ordering of aggregates and values must be consistent with the
 //       ordering provided during Setup().
+//
+// Distinct aggregates keep the values they have seen in hash tables. These are
+// either probed as the values arrive, or the aggregates are deferred: their
+// values are only collected, and the hash tables are flushed into partitions
+// that spill to disk like those of a hash aggregation. Once all input was
+// consumed, IterateDistinctValues() provides every distinct value exactly once
+// and the caller adds it to its group with AdvanceDistinctValue().
 //===----------------------------------------------------------------------===//
 class Aggregation {
  public:
+  //===--------------------------------------------------------------------===//
+  // The callback receiving the deduplicated values of deferred distinct
+  // aggregates, along with the grouping keys of the group they belong to
+  //===--------------------------------------------------------------------===//
+  struct DistinctValueCallback {
+    // Destructor
+    virtual ~DistinctValueCallback() {}
+
+    // The callback, for the distinct aggregate with the given index
+    virtual void ProcessValue(CodeGen &codegen, uint32_t distinct_index,
+                              const std::vector<codegen::Value> &grouping_keys,
+                              const codegen::Value &value) const = 0;
+  };
+
   // Constructor taking the runtime state reference
   Aggregation(RuntimeState &runtime_state) : runtime_state_(runtime_state) {}
 
-  // Setup the aggregation to handle the provided aggregates
+  // Setup the aggregation to handle the provided aggregates. If the distinct
+  // table size is not zero, distinct aggregates are deferred and their hash
+  // tables are flushed into partitions once they take that many bytes. The
+  // partitions spill once they take more than the memory budget.
   void Setup(CodeGen &codegen,
              const std::vector<planner::AggregatePlan::AggTerm> &agg_terms,
-             bool is_global, std::vector<type::Type> &grouping_ai_types);
+             bool is_global, std::vector<type::Type> &grouping_ai_types,
+             uint64_t distinct_table_size = 0, uint64_t memory_budget = 0);
 
   // Setup the aggregation to handle the provided aggregates
   void Setup(CodeGen &codegen,
              const std::vector<planner::AggregatePlan::AggTerm> &agg_terms,
              bool is_global);
 
+  // Define the functions merging the partitions of deferred distinct values
+  void DefineAuxiliaryFunctions(CodeGen &codegen);
+
   // Codegen any initialization work for the hash tables
   void InitializeState(CodeGen &codegen);
 
@@ -78,6 +106,34 @@ class Aggregation {
   void AdvanceValues(CodeGen &codegen, llvm::Value *space,
                      const std::vector<codegen::Value> &next) const;
 
+  // Merge the partial aggregates stored in the other storage space into those
+  // stored in the provided storage space. Distinct aggregates can't be merged.
+  void MergeValues(CodeGen &codegen, llvm::Value *space,
+                   llvm::Value *other_space) const;
+
+  // Can partial aggregates be merged through MergeValues()?
+  bool IsMergeable() const;
+
+  // Are distinct aggregates deferred until IterateDistinctValues()?
+  bool DefersDistinct() const {
+    return distinct_table_size_ != 0 && !hash_table_infos_.empty();
+  }
+
+  // Store empty aggregates into the provided storage space, into which only
+  // deferred distinct values are advanced
+  void CreateEmptyValues(CodeGen &codegen, llvm::Value *space) const;
+
+  // Hand every value collected by the deferred distinct aggregates to the
+  // callback, once. Called after all input was consumed.
+  void IterateDistinctValues(CodeGen &codegen,
+                             DistinctValueCallback &callback) const;
+
+  // Advance the deferred distinct aggregate with the given index, stored in
+  // the provided storage space, by one of its deduplicated values
+  void AdvanceDistinctValue(CodeGen &codegen, llvm::Value *space,
+                            uint32_t distinct_index,
+                            const codegen::Value &value) const;
+
   // Compute the final values of all the aggregates stored in the provided
   // storage space, inserting them into the provided output vector.
   void FinalizeValues(CodeGen &codegen, llvm::Value *space,
@@ -86,12 +142,16 @@ class Aggregation {
   // Get the total number of bytes needed to store all the aggregates this is
   // configured to store
   uint32_t GetAggregatesStorageSize() const {
-    return storage_.GetStorageSize();
+    return storage_.GetStorageSize() + sketches_size_;
   }
 
   // Get the storage format of the aggregates this class is configured to handle
   const UpdateableStorage &GetAggregateStorage() const { return storage_; }
 
+  // Get the LLVM type of the space all aggregates are stored in. This is the
+  // storage format followed by the sketches of the approximate aggregates.
+  llvm::Type *GetAggregatesType() const { return aggregates_type_; }
+
  private:
   bool IsGlobal() const { return is_global_; }
 
@@ -130,6 +190,13 @@ class Aggregation {
 
     // Index for the runtime hash table, only used if is_distinct is true
     uint32_t hast_table_index;
+
+    // Byte offset of the sketch in the aggregate space, only used by the
+    // approximate aggregates
+    uint32_t sketch_offset;
+
+    // The percentile an APPROX_PERCENTILE computes
+    double percentile;
   };
 
  private:
@@ -150,6 +217,24 @@ class Aggregation {
   void DoAdvanceValue(CodeGen &codegen, llvm::Value *space, ExpressionType type,
                       uint32_t storage_index, const codegen::Value &next) const;
 
+  // Merge a partial aggregate component stored in the other storage space into
+  // the one stored in the provided storage space
+  void MergeValue(CodeGen &codegen, llvm::Value *space,
+                  llvm::Value *other_space, ExpressionType type,
+                  uint32_t storage_index,
+                  UpdateableStorage::NullBitmap &null_bitmap,
+                  UpdateableStorage::NullBitmap &other_null_bitmap) const;
+
+  // Store the empty value of an aggregate whose components the null bitmap
+  // already marks as NULL
+  void InitializeEmptyValue(CodeGen &codegen, llvm::Value *space,
+                            const AggregateInfo &agg_info) const;
+
+  // Add the value of a deferred distinct aggregate to its hash table, flushing
+  // the table into its partitions once it is full
+  void CollectDistinctValue(CodeGen &codegen, const AggregateInfo &agg_info,
+                            const std::vector<codegen::Value> &key) const;
+
   // Advancethe value of a specifig aggregate. Performs NULL check if necessary
   // and finally calls DoAdvanceValue()
   void AdvanceValue(CodeGen &codegen, llvm::Value *space,
@@ -157,6 +242,15 @@ class Aggregation {
                     const Aggregation::AggregateInfo &agg,
                     UpdateableStorage::NullBitmap &null_bitmap) const;
 
+  // Get a pointer to the sketch of an approximate aggregate
+  llvm::Value *GetSketchPtr(CodeGen &codegen, llvm::Value *space,
+                            const AggregateInfo &agg_info) const;
+
+  // Add the (non-NULL) value to the sketch of an approximate aggregate
+  void AdvanceSketch(CodeGen &codegen, llvm::Value *space,
+                     const AggregateInfo &agg_info,
+                     const codegen::Value &next) const;
+
  private:
   // Is this a global aggregation?
   bool is_global_;
@@ -167,10 +261,30 @@ class Aggregation {
   // The storage format we use to store values
   UpdateableStorage storage_;
 
+  // The number of bytes taken by the sketches of approximate aggregates, which
+  // are stored after the values
+  uint32_t sketches_size_ = 0;
+
+  // The type of the whole aggregate space
+  llvm::Type *aggregates_type_ = nullptr;
+
   // Hash tables and their runtime IDs for the distinct aggregations, access via
   // index
   std::vector<std::pair<OAHashTable, RuntimeState::StateID>> hash_table_infos_;
 
+  // The bytes a hash table of a deferred distinct aggregate may take before it
+  // is flushed, zero if distinct aggregates are not deferred
+  uint64_t distinct_table_size_ = 0;
+
+  // The bytes the partitions of a distinct aggregate may take before they
+  // spill, zero if unlimited
+  uint64_t memory_budget_ = 0;
+
+  // The runtime IDs of the partitions of the deferred distinct aggregates and
+  // the functions merging them, in the order of their hash tables
+  std::vector<RuntimeState::StateID> distinct_partitions_ids_;
+  std::vector<llvm::Function *> distinct_merge_funcs_;
+
   // Reference to RuntimeState, needed for the hash tables
   RuntimeState &runtime_state_;
 };
@@ -40,6 +40,25 @@ class BloomFilterAccessor {
   llvm::Value *Contains(CodeGen &codegen, llvm::Value *bloom_filter,
                         const std::vector<codegen::Value> &key) const;
 
+  // Codegen the check whether the filter should be probed for the next batch
+  // of the given number of tuples
+  llvm::Value *ShouldProbe(CodeGen &codegen, llvm::Value *bloom_filter,
+                           llvm::Value *num_tuples) const;
+
+  // Codegen widening the range of keys in the filter to include the given
+  // integral key. NULL keys are ignored.
+  void AddToRange(CodeGen &codegen, llvm::Value *bloom_filter,
+                  const codegen::Value &key) const;
+
+  // Codegen the check whether the given integral key lies within the range of
+  // keys in the filter. NULL keys are never ruled out.
+  llvm::Value *InRange(CodeGen &codegen, llvm::Value *bloom_filter,
+                       const codegen::Value &key) const;
+
+  // Codegen loading the smallest and largest key in the filter
+  llvm::Value *GetMinKey(CodeGen &codegen, llvm::Value *bloom_filter) const;
+  llvm::Value *GetMaxKey(CodeGen &codegen, llvm::Value *bloom_filter) const;
+
  private:
   void StoreBloomFilterField(CodeGen &codegen, llvm::Value *bloom_filter,
                              uint32_t field_id,
@@ -17,12 +17,14 @@
 
 #include "llvm/IR/IRBuilder.h"
 
+#include "common/internal_types.h"
 #include "common/macros.h"
 
 namespace llvm {
 class ExecutionEngine;
 class LLVMContext;
 class Module;
+class ObjectCache;
 
 namespace legacy {
 class FunctionPassManager;
@@ -48,6 +50,21 @@ class CodeContext {
  public:
   using FuncPtr = void *;
 
+  /// How much effort Compile() spends on optimizing the code
+  enum class OptimizationTier : uint32_t {
+    // No IR passes and a fast instruction selector, for code that takes
+    // longer to optimize than it runs
+    Minimal = 0,
+    // The default set of function passes
+    Standard = 1,
+    // Inlining, loop optimizations and vectorization, for code that runs long
+    // enough to make up for it
+    Aggressive = 2,
+  };
+
+  /// The number of optimization tiers
+  static constexpr uint32_t kNumOptimizationTiers = 3;
+
   CodeContext();
   ~CodeContext();
 
@@ -73,9 +90,37 @@ class CodeContext {
   // Sets UDF function ptr
   void SetUDF(llvm::Function *func_ptr) { udf_func_ptr_ = func_ptr; }
 
+  /// Provide the object code that an identical module was compiled into
+  /// earlier. Compile() then loads it instead of optimizing and compiling.
+  void UseCachedObject(std::string &&object) {
+    cached_object_ = std::move(object);
+  }
+
+  /// Set the tier the code is optimized at. Compile() compiles code with more
+  /// instructions than the codegen_minimal_optimization_instructions setting
+  /// at the minimal tier, unless the aggressive tier was asked for.
+  void SetOptimizationTier(OptimizationTier tier) { tier_ = tier; }
+
+  /// The tier the code is (or is going to be) optimized at
+  OptimizationTier GetOptimizationTier() const { return tier_; }
+
   /// Compile all the code contained in this context
   bool Compile();
 
+  /// Get the time Compile() took to optimize and compile the code
+  double GetCompileTime() const { return compile_ms_; }
+
+  /// Get the number of instructions in this context
+  uint64_t GetInstructionCount() const;
+
+  /// Get the object code Compile() produced (or loaded)
+  const std::string &GetObjectCode() const { return object_code_; }
+
+  /// Hash the IR in this context. The hash doesn't depend on the ID of the
+  /// context, so the same code always hashes to the same value, even across
+  /// restarts.
+  hash_t HashIR() const;
+
   /// Retrieve the raw function pointer to the provided compiled LLVM function
   FuncPtr GetRawFunctionPointer(llvm::Function *fn) const {
     for (size_t i = 0; i < functions_.size(); i++) {
@@ -106,6 +151,10 @@ class CodeContext {
   // Get the raw IR in text form
   std::string GetIR() const;
 
+  // Run the optimization passes of the current tier over the module, and set
+  // up the engine to generate code for it
+  void Optimize();
+
   // Get the IR Builder
   llvm::IRBuilder<> &GetBuilder() { return *builder_; }
 
@@ -140,6 +189,16 @@ class CodeContext {
   // The optimization pass manager
   std::unique_ptr<llvm::legacy::FunctionPassManager> pass_manager_;
 
+  // The tier the code is optimized at, and the time compiling it took
+  OptimizationTier tier_;
+  double compile_ms_;
+
+  // The object code of an earlier compilation of the same code, and the object
+  // code of this module. The object cache passes them to and from the engine.
+  std::string cached_object_;
+  std::string object_code_;
+  std::unique_ptr<llvm::ObjectCache> object_cache_;
+
   // The JIT compilation engine
   std::string err_str_;
   std::unique_ptr<llvm::ExecutionEngine> engine_;
@@ -102,6 +102,7 @@ class CodeGen {
   llvm::Value *CallPrintf(const std::string &format,
                           const std::vector<llvm::Value *> &args);
   llvm::Value *Sqrt(llvm::Value *val);
+  llvm::Value *PopCount(llvm::Value *val);
 
   //===--------------------------------------------------------------------===//
   // Arithmetic with overflow logic - These methods perform the desired math op,
@@ -134,6 +135,10 @@ class CodeGen {
   /// Return the size of the given type in bytes (returns 1 when size < 1 byte)
   uint64_t SizeOf(llvm::Type *type) const;
 
+  /// Return the offset in bytes of the element with the given index in the
+  /// given struct type
+  uint64_t ElementOffset(llvm::Type *type, uint32_t element_idx) const;
+
   //===--------------------------------------------------------------------===//
   // ACCESSORS
   //===--------------------------------------------------------------------===//
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "codegen/auxiliary_producer_function.h"
 #include "codegen/code_context.h"
@@ -34,6 +35,7 @@ class AbstractExpression;
 
 namespace planner {
 class AbstractPlan;
+struct AttributeInfo;
 }  // namespace planner
 
 namespace codegen {
@@ -49,6 +51,21 @@ class CompilationContext {
   friend class ConsumerContext;
   friend class RowBatch;
 
+ public:
+  // A bloom filter that a hash join builds over its build-side keys and pushes
+  // down into the scan that feeds its probe side. The scan drops the tuples
+  // whose keys are not in the filter before they enter the pipeline.
+  struct ScanFilter {
+    // The attributes of the scan the filter was built on, in key order
+    std::vector<const planner::AttributeInfo *> key_ais;
+
+    // The runtime state of the bloom filter
+    RuntimeState::StateID bloom_filter_id;
+
+    // Does the filter track the range of its (single, integral) key?
+    bool has_key_range;
+  };
+
  public:
   // Constructor
   CompilationContext(Query &query, const QueryParametersMap &parameters_map,
@@ -58,9 +75,23 @@ class CompilationContext {
   void Prepare(const planner::AbstractPlan &op, Pipeline &pipeline);
   void Prepare(const expression::AbstractExpression &expression);
 
+  // Install the given translator for the expression, replacing any translator
+  // that was prepared for it before
+  void Prepare(const expression::AbstractExpression &expression,
+               std::unique_ptr<ExpressionTranslator> translator);
+
   // Produce the tuples for the given operator
   void Produce(const planner::AbstractPlan &op);
 
+  // Push down the given filter into the provided scan. This must be done
+  // before the scan's translator is prepared.
+  void PushDownScanFilter(const planner::AbstractPlan &scan,
+                          const ScanFilter &filter);
+
+  // Get all filters pushed down into the provided scan
+  const std::vector<ScanFilter> &GetScanFilters(
+      const planner::AbstractPlan &scan) const;
+
   // This is the main entry point into the compilation component. Callers
   // construct a compilation context, then invoke this method to compile
   // the plan and prepare the provided query statement.
@@ -155,9 +186,21 @@ class CompilationContext {
                      std::unique_ptr<ExpressionTranslator>>
       exp_translators_;
 
+  // The filters pushed down into scans
+  std::unordered_map<const planner::AbstractPlan *, std::vector<ScanFilter>>
+      scan_filters_;
+
   // Pre-declared producer functions and their root plan nodes
   std::unordered_map<const planner::AbstractPlan *, FunctionDeclaration>
       auxiliary_producers_;
+
+  // The operators, expressions and auxiliary producers in the order they were
+  // prepared/declared in. We generate code in this order rather than in the
+  // (address-dependent) order of the maps above so that the same plan always
+  // yields the same code.
+  std::vector<const planner::AbstractPlan *> prepared_ops_;
+  std::vector<const expression::AbstractExpression *> prepared_exps_;
+  std::vector<const planner::AbstractPlan *> auxiliary_producer_order_;
 };
 
 }  // namespace codegen
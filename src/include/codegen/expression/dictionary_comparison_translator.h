@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// dictionary_comparison_translator.h
+//
+// Identification:
+// src/include/codegen/expression/dictionary_comparison_translator.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "codegen/compilation_context.h"
+#include "codegen/expression/expression_translator.h"
+
+namespace peloton {
+
+namespace expression {
+class ComparisonExpression;
+}  // namespace expression
+
+namespace planner {
+struct AttributeInfo;
+}  // namespace planner
+
+namespace storage {
+class DataTable;
+}  // namespace storage
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// A translator of (in)equality comparisons and IN-lists between a
+// dictionary-encoded column of a scanned table and string constants. Instead
+// of comparing strings, the dictionary code stored in front of each value is
+// compared against the codes of the constants, which are looked up once at
+// compile time.
+//
+// This is only valid where the column's values are read straight from the
+// table's tiles, i.e., in the scan's predicate.
+//===----------------------------------------------------------------------===//
+class DictionaryComparisonTranslator : public ExpressionTranslator {
+ public:
+  // Constructor
+  DictionaryComparisonTranslator(
+      const expression::ComparisonExpression &comparison,
+      CompilationContext &context, uint32_t column_child,
+      std::vector<uint32_t> codes);
+
+  // Produce the result of comparing the codes
+  codegen::Value DeriveValue(CodeGen &codegen,
+                             RowBatch::Row &row) const override;
+
+  // Can the given comparison be evaluated on the dictionary codes of the given
+  // table? If so, returns the child that is the column, and the codes of the
+  // constants.
+  static bool CanTranslate(const expression::ComparisonExpression &comparison,
+                           const storage::DataTable &table,
+                           uint32_t &column_child,
+                           std::vector<uint32_t> &codes);
+
+ private:
+  // Look up the code of the given constant in the column's dictionary
+  static bool FindCode(const expression::AbstractExpression &constant,
+                       const storage::DataTable &table,
+                       const planner::AttributeInfo &column, uint32_t &code);
+
+ private:
+  // The child of the comparison that is the encoded column
+  uint32_t column_child_;
+
+  // The dictionary codes of the constants
+  std::vector<uint32_t> codes_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
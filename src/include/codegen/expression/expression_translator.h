@@ -36,6 +36,13 @@ class ExpressionTranslator {
   // Destructor
   virtual ~ExpressionTranslator() {}
 
+  // Codegen any initialization work for state the expression needs, in the
+  // init() function of the query. Most expressions are stateless.
+  virtual void InitializeState() {}
+
+  // Codegen any cleanup work for the state the expression needs
+  virtual void TearDownState() {}
+
   // Compute this expression
   virtual codegen::Value DeriveValue(CodeGen &codegen,
                                      RowBatch::Row &row) const = 0;
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// in_list_translator.h
+//
+// Identification: src/include/codegen/expression/in_list_translator.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/compilation_context.h"
+#include "codegen/expression/expression_translator.h"
+#include "codegen/oa_hash_table.h"
+#include "codegen/runtime_state.h"
+
+namespace peloton {
+
+namespace expression {
+class ComparisonExpression;
+}  // namespace expression
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// A translator of IN list expressions, i.e., "value IN (item, ...)".
+//
+// Short lists are unrolled into a disjunction of equality comparisons, which
+// is evaluated without branches. Long lists of constants and parameters are
+// loaded into a hash set when the query starts, and every value is looked up
+// in the set.
+//===----------------------------------------------------------------------===//
+class InListTranslator : public ExpressionTranslator {
+ public:
+  // The longest list that is unrolled into comparisons
+  static constexpr uint32_t kMaxUnrolledListSize = 16;
+
+  // Constructor
+  InListTranslator(const expression::ComparisonExpression &in_list,
+                   CompilationContext &context);
+
+  // Build the hash set of the list items, if we use one
+  void InitializeState() override;
+
+  // Free the hash set, if we use one
+  void TearDownState() override;
+
+  // Produce the result of looking the value up in the list
+  codegen::Value DeriveValue(CodeGen &codegen,
+                             RowBatch::Row &row) const override;
+
+ private:
+  // Can the items of the list be put in a hash set?
+  static bool CanUseHashSet(const expression::ComparisonExpression &in_list);
+
+  // Compare the value with every item of the list
+  codegen::Value DeriveValueUnrolled(CodeGen &codegen,
+                                     RowBatch::Row &row) const;
+
+  // Look the value up in the hash set of the list items
+  codegen::Value DeriveValueHashed(CodeGen &codegen, RowBatch::Row &row) const;
+
+ private:
+  // Whether the list items are in a hash set
+  bool use_hash_set_;
+
+  // The type of the keys in the hash set, the type of the value without NULLs
+  type::Type key_type_;
+
+  // The hash set, a hash table without values, and its runtime state
+  OAHashTable hash_set_;
+  RuntimeState::StateID hash_set_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_probe.h
+//
+// Identification: src/include/codegen/index_probe.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/item_pointer.h"
+#include "common/macros.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}  // namespace executor
+
+namespace index {
+class Index;
+}  // namespace index
+
+namespace storage {
+class DataTable;
+class TileGroup;
+class Tuple;
+}  // namespace storage
+
+namespace type {
+class EphemeralPool;
+}  // namespace type
+
+namespace codegen {
+
+// This class probes an index of a table from generated code, for every outer
+// tuple of an index nested-loop join. A probe looks up all the index entries
+// matching a key and keeps the locations of the versions that are visible to
+// the current transaction. The generated code then walks over the matches.
+class IndexProbe {
+ public:
+  // Initialize this instance to probe the index with the given oid
+  void Init(storage::DataTable *table, uint32_t index_oid,
+            executor::ExecutorContext *executor_context, bool is_for_update);
+
+  // Probe the index with a key made of the provided values, one per key
+  // column. The values are consumed. Return the number of visible matches.
+  uint32_t Probe(char *key_values);
+
+  // Return the tile group of the match at the given index
+  storage::TileGroup *GetTileGroup(uint32_t match_idx) const;
+
+  // Return the offset in its tile group of the match at the given index
+  uint32_t GetTupleOffset(uint32_t match_idx) const;
+
+  // Release the probe key and the matches
+  void TearDown();
+
+ private:
+  // No external constructor
+  IndexProbe()
+      : index_(nullptr),
+        executor_context_(nullptr),
+        is_for_update_(false),
+        key_(nullptr),
+        key_pool_(nullptr),
+        matches_(nullptr) {}
+
+  // Collect the location of the version visible to the current transaction,
+  // starting from the head of a version chain. Return false if the
+  // transaction has to abort.
+  bool FindVisibleVersion(ItemPointer location);
+
+ private:
+  // The index we probe
+  index::Index *index_;
+
+  // The executor context with which the current execution happens
+  executor::ExecutorContext *executor_context_;
+
+  // Whether the matches are read for update
+  bool is_for_update_;
+
+  // The probe key, reused across probes
+  storage::Tuple *key_;
+
+  // The varlen values of the probe key, released by the next probe
+  peloton::type::EphemeralPool *key_pool_;
+
+  // The visible matches of the last probe
+  std::vector<ItemPointer> *matches_;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(IndexProbe);
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -60,6 +60,9 @@ class Inserter {
   void TearDown();
 
  private:
+  // Precompiled plans use the instance directly
+  friend class PrecompiledPlan;
+
   // No external constructor
   Inserter(): table_(nullptr), executor_context_(nullptr), tile_(nullptr) {}
 
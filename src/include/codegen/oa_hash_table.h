@@ -99,6 +99,15 @@ class OAHashTable : public HashTable {
                const std::vector<codegen::Value> &key,
                HashTable::IterateCallback &callback) const override;
 
+  // Load the total number of entries in the hash table
+  llvm::Value *NumEntries(CodeGen &codegen, llvm::Value *ht_ptr) const;
+
+  // Load the hash value and the keys of the hash entry at the given address,
+  // returning a pointer to its value. The entry must hold a single value.
+  llvm::Value *LoadEntry(CodeGen &codegen, llvm::Value *entry_ptr,
+                         llvm::Value *&hash,
+                         std::vector<codegen::Value> &key) const;
+
   // An enum class indicating the type of prefetch (i.e., read or write)
   enum class PrefetchType : uint32_t { Read = 0, Write = 0 };
 
@@ -26,7 +26,12 @@ class NestedLoopJoinPlan;
 namespace codegen {
 
 //===----------------------------------------------------------------------===//
-// The translator for a blockwise nested loop join
+// The translator for a blockwise nested loop join.
+//
+// Outer, semi and anti joins buffer the whole left input in a single block.
+// Every buffered tuple then carries a flag telling whether it found a match,
+// and the tuples the join type asks for are produced once the right input is
+// exhausted.
 //===----------------------------------------------------------------------===//
 class BlockNestedLoopJoinTranslator : public OperatorTranslator {
  public:
@@ -54,6 +59,19 @@ class BlockNestedLoopJoinTranslator : public OperatorTranslator {
 
   void FindMatchesForRow(ConsumerContext &ctx, RowBatch::Row &row) const;
 
+  // Apply the projection to the row, and send it to the parent
+  void ProjectAndConsume(ConsumerContext &ctx, RowBatch::Row &row) const;
+
+  // Produce the buffered tuples with (semi join) or without (outer and anti
+  // joins) a match
+  void ProduceBufferedTuples() const;
+
+  // Does the join need to know which buffered tuples found a match?
+  bool TracksLeftMatches() const;
+
+  // Does the join produce the right tuples without a match?
+  bool ProducesUnmatchedRight() const;
+
   const planner::NestedLoopJoinPlan &GetPlan() const { return nlj_plan_; }
 
  private:
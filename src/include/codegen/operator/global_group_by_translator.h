@@ -38,8 +38,8 @@ class GlobalGroupByTranslator : public OperatorTranslator {
   // Nothing to initialize
   void InitializeState() override;
 
-  // No helper functions
-  void DefineAuxiliaryFunctions() override {}
+  // Define the functions merging the values of distinct aggregates
+  void DefineAuxiliaryFunctions() override;
 
   // Produce!
   void Produce() const override;
@@ -75,6 +75,31 @@ class GlobalGroupByTranslator : public OperatorTranslator {
     uint32_t agg_index_;
   };
 
+  //===--------------------------------------------------------------------===//
+  // The callback adding the deduplicated values of deferred distinct
+  // aggregates to the aggregates in the buffer
+  //===--------------------------------------------------------------------===//
+  class DistinctValueAdder : public Aggregation::DistinctValueCallback {
+   public:
+    // Constructor
+    DistinctValueAdder(const Aggregation &aggregation, llvm::Value *mat_buffer)
+        : aggregation_(aggregation), mat_buffer_(mat_buffer) {}
+
+    void ProcessValue(CodeGen &codegen, uint32_t distinct_index,
+                      const std::vector<codegen::Value> &,
+                      const codegen::Value &value) const override {
+      aggregation_.AdvanceDistinctValue(codegen, mat_buffer_, distinct_index,
+                                        value);
+    }
+
+   private:
+    // The aggregation
+    const Aggregation &aggregation_;
+
+    // The buffer holding the aggregates
+    llvm::Value *mat_buffer_;
+  };
+
  private:
   // The aggregation plan
   const planner::AggregatePlan &plan_;
@@ -40,8 +40,8 @@ class HashGroupByTranslator : public OperatorTranslator {
   // Codegen any initialization work for this operator
   void InitializeState() override;
 
-  // Define any helper functions this translator needs
-  void DefineAuxiliaryFunctions() override {}
+  // Define the function merging partitions of partial aggregates
+  void DefineAuxiliaryFunctions() override;
 
   // The method that produces new tuples
   void Produce() const override;
@@ -127,6 +127,110 @@ class HashGroupByTranslator : public OperatorTranslator {
     const std::vector<codegen::Value> grouping_keys_;
   };
 
+  //===--------------------------------------------------------------------===//
+  // The callback used when merging a partial aggregate into a partition's hash
+  // table that already has an entry for its key
+  //===--------------------------------------------------------------------===//
+  class MergeProbe : public HashTable::ProbeCallback {
+   public:
+    // Constructor
+    MergeProbe(const Aggregation &aggregation, llvm::Value *partial_aggs);
+
+    // The callback
+    void ProcessEntry(CodeGen &codegen, llvm::Value *data_area) const override;
+
+   private:
+    // The guy that handles the computation of the aggregates
+    const Aggregation &aggregation_;
+    // The partial aggregates to merge
+    llvm::Value *partial_aggs_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback used when merging a partial aggregate into a partition's hash
+  // table that does not have an entry for its key yet
+  //===--------------------------------------------------------------------===//
+  class MergeInsert : public HashTable::InsertCallback {
+   public:
+    // Constructor
+    MergeInsert(const Aggregation &aggregation, llvm::Value *partial_aggs);
+
+    // Copy the partial aggregates into the provided storage
+    void StoreValue(CodeGen &codegen, llvm::Value *data_space) const override;
+
+    llvm::Value *GetValueSize(CodeGen &codegen) const override;
+
+   private:
+    // The guy that handles the computation of the aggregates
+    const Aggregation &aggregation_;
+    // The partial aggregates to copy
+    llvm::Value *partial_aggs_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback receiving the deduplicated values of deferred distinct
+  // aggregates, which it adds to their groups in the pre-aggregation table
+  //===--------------------------------------------------------------------===//
+  class DistinctValueAdder : public Aggregation::DistinctValueCallback {
+   public:
+    // Constructor
+    DistinctValueAdder(const HashGroupByTranslator &translator);
+
+    // The callback
+    void ProcessValue(CodeGen &codegen, uint32_t distinct_index,
+                      const std::vector<codegen::Value> &grouping_keys,
+                      const codegen::Value &value) const override;
+
+   private:
+    // The plan details
+    const HashGroupByTranslator &translator_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback used when adding a deduplicated distinct value to a group
+  // that is in the pre-aggregation table
+  //===--------------------------------------------------------------------===//
+  class DistinctProbe : public HashTable::ProbeCallback {
+   public:
+    // Constructor
+    DistinctProbe(const Aggregation &aggregation, uint32_t distinct_index,
+                  const codegen::Value &value);
+
+    // The callback
+    void ProcessEntry(CodeGen &codegen, llvm::Value *data_area) const override;
+
+   private:
+    // The guy that handles the computation of the aggregates
+    const Aggregation &aggregation_;
+    // The distinct aggregate and its value
+    uint32_t distinct_index_;
+    const codegen::Value &value_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback used when adding a deduplicated distinct value to a group
+  // that is not in the pre-aggregation table (anymore). The group starts out
+  // with empty aggregates.
+  //===--------------------------------------------------------------------===//
+  class DistinctInsert : public HashTable::InsertCallback {
+   public:
+    // Constructor
+    DistinctInsert(const Aggregation &aggregation, uint32_t distinct_index,
+                   const codegen::Value &value);
+
+    // Store empty aggregates advanced by the value into the provided storage
+    void StoreValue(CodeGen &codegen, llvm::Value *data_space) const override;
+
+    llvm::Value *GetValueSize(CodeGen &codegen) const override;
+
+   private:
+    // The guy that handles the computation of the aggregates
+    const Aggregation &aggregation_;
+    // The distinct aggregate and its value
+    uint32_t distinct_index_;
+    const codegen::Value &value_;
+  };
+
   //===--------------------------------------------------------------------===//
   // An aggregate finalizer allows aggregations to delay the finalization of an
   // aggregate in the hash-table to a later time. This is needed when we do
@@ -170,12 +274,24 @@ class HashGroupByTranslator : public OperatorTranslator {
   void CollectHashKeys(RowBatch::Row &row,
                        std::vector<codegen::Value> &key) const;
 
+  // Add a deduplicated value of a deferred distinct aggregate to the group
+  // with the given key
+  void AddDistinctValue(uint32_t distinct_index,
+                        const std::vector<codegen::Value> &key,
+                        const codegen::Value &value) const;
+
+  // Flush the pre-aggregation table into the partitions if it is full
+  void FlushIfFull(llvm::Value *hash_table) const;
+
   // Estimate the size of the constructed hash table
   uint64_t EstimateHashTableSize() const;
 
   // Should this operator employ prefetching?
   bool UsePrefetching() const;
 
+  // Does this operator pre-aggregate and merge partitions?
+  bool UsePartitioning() const { return use_partitioning_; }
+
   const planner::AggregatePlan &GetAggregatePlan() const { return group_by_; }
 
   const Aggregation &GetAggregation() const { return aggregation_; }
@@ -190,9 +306,24 @@ class HashGroupByTranslator : public OperatorTranslator {
   // The ID of the hash-table in the runtime state
   RuntimeState::StateID hash_table_id_;
 
-  // The hash table
+  // The hash table. When partitioning, this is the pre-aggregation table.
   OAHashTable hash_table_;
 
+  // Whether to pre-aggregate and merge partitions
+  bool use_partitioning_;
+
+  // The number of entries at which the pre-aggregation table is flushed
+  uint64_t max_pre_aggregation_entries_;
+
+  // The ID of the partitions in the runtime state
+  RuntimeState::StateID partitions_id_;
+
+  // The function merging a partition into its hash table
+  llvm::Function *merge_func_;
+
+  // The bytes the partitions may take before they spill, zero if unlimited
+  uint64_t memory_budget_;
+
   // The aggregation handler
   Aggregation aggregation_;
 };
@@ -28,7 +28,13 @@ class HashJoinPlan;
 namespace codegen {
 
 //===----------------------------------------------------------------------===//
-// The translator for a hash-join operator
+// The translator for a hash-join operator. The left child is the build side
+// and the right child the probe side.
+//
+// Outer joins produce the tuples without a match padded with NULLs. The probe
+// tuples are checked after probing, the build tuples once the probe side is
+// exhausted, using a match flag stored with every build tuple. Semi and anti
+// joins produce the build tuples with and without a match, respectively.
 //===----------------------------------------------------------------------===//
 class HashJoinTranslator : public OperatorTranslator {
  public:
@@ -75,7 +81,21 @@ class HashJoinTranslator : public OperatorTranslator {
                      std::vector<codegen::Value> &values) const;
 
   void CodegenHashProbe(ConsumerContext &context, RowBatch::Row &row,
-                        std::vector<codegen::Value> &key) const;
+                        std::vector<codegen::Value> &key,
+                        llvm::Value *right_matched) const;
+
+  // Does the join need to know which build tuples found a match?
+  bool TracksLeftMatches() const;
+
+  // Does the join produce the probe tuples without a match?
+  bool ProducesUnmatchedRight() const;
+
+  // Push the bloom filter down into the scan on the probe side, if the probe
+  // keys are columns of a table scanned there
+  void PushDownBloomFilter(CompilationContext &context);
+
+  // Get the pointer to the build-side values in the data area of an entry
+  llvm::Value *GetLeftValuesPtr(CodeGen &codegen, llvm::Value *data_area) const;
 
   // Estimate the size of the constructed hash table
   uint64_t EstimateHashTableSize() const;
@@ -97,12 +117,17 @@ class HashJoinTranslator : public OperatorTranslator {
     // Constructor
     ProbeRight(const HashJoinTranslator &join_translator,
                ConsumerContext &context, RowBatch::Row &row,
-               const std::vector<codegen::Value> &right_key);
+               const std::vector<codegen::Value> &right_key,
+               llvm::Value *right_matched);
 
     // Process the given key and associated data area
     void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &key,
                       llvm::Value *data_area) const override;
 
+   private:
+    // Record the match of the row with the entry, and produce it
+    void ProcessMatch(CodeGen &codegen, llvm::Value *data_area) const;
+
    private:
     // The translator (we need lots of its state)
     const HashJoinTranslator &join_translator_;
@@ -110,6 +135,26 @@ class HashJoinTranslator : public OperatorTranslator {
     ConsumerContext &context_;
     RowBatch::Row &row_;
     const std::vector<codegen::Value> &right_key_;
+    // The flag set when the probe tuple finds a match, if it is tracked
+    llvm::Value *right_matched_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback used to produce the build tuples with (semi join) or without
+  // (outer and anti joins) a match once the probe side is exhausted
+  //===--------------------------------------------------------------------===//
+  class ProduceLeft : public OAHashTable::IterateCallback {
+   public:
+    // Constructor
+    explicit ProduceLeft(const HashJoinTranslator &join_translator);
+
+    // Process the given key and associated data area
+    void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &key,
+                      llvm::Value *data_area) const override;
+
+   private:
+    // The translator
+    const HashJoinTranslator &join_translator_;
   };
 
   //===--------------------------------------------------------------------===//
@@ -120,7 +165,7 @@ class HashJoinTranslator : public OperatorTranslator {
    public:
     // Constructor
     InsertLeft(const CompactStorage &storage,
-               const std::vector<codegen::Value> &values);
+               const std::vector<codegen::Value> &values, bool track_match);
     // StoreValue the input tuple in the given data space
     void StoreValue(CodeGen &codegen, llvm::Value *data_space) const override;
     llvm::Value *GetValueSize(CodeGen &codegen) const override;
@@ -130,6 +175,8 @@ class HashJoinTranslator : public OperatorTranslator {
     const CompactStorage storage_;
     // The attribute values from the left side
     const std::vector<codegen::Value> &values_;
+    // Whether a match flag is stored before the values
+    bool track_match_;
   };
 
  private:
@@ -151,6 +198,11 @@ class HashJoinTranslator : public OperatorTranslator {
   // Bloom Filter Accessor
   BloomFilterAccessor bloom_filter_;
 
+  // Was the bloom filter pushed down into a scan on the probe side, and does
+  // it track the range of the build keys?
+  bool bloom_filter_pushed_down_;
+  bool bloom_filter_tracks_range_;
+
   // The left and right hash key expressions
   std::vector<const expression::AbstractExpression *> left_key_exprs_;
   std::vector<const expression::AbstractExpression *> right_key_exprs_;
@@ -163,6 +215,10 @@ class HashJoinTranslator : public OperatorTranslator {
 
   // Does this join need an output vector
   bool needs_output_vector_;
+
+  // The space taken by the match flag at the start of an entry's data area.
+  // It keeps the values that follow aligned.
+  static constexpr uint32_t kMatchFlagSize = 8;
 };
 
 }  // namespace codegen
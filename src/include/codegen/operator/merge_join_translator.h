@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_translator.h
+//
+// Identification: src/include/codegen/operator/merge_join_translator.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/consumer_context.h"
+#include "codegen/operator/operator_translator.h"
+#include "codegen/sorter.h"
+
+namespace peloton {
+
+namespace planner {
+class MergeJoinPlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// The translator for an inner merge join. Both inputs must be sorted in
+// ascending order of the join keys.
+//===----------------------------------------------------------------------===//
+class MergeJoinTranslator : public OperatorTranslator {
+ public:
+  MergeJoinTranslator(const planner::MergeJoinPlan &join,
+                      CompilationContext &context, Pipeline &pipeline);
+
+  void InitializeState() override;
+
+  void DefineAuxiliaryFunctions() override {}
+
+  void TearDownState() override;
+
+  std::string GetName() const override;
+
+  void Produce() const override;
+
+  void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
+
+ private:
+  bool IsFromLeftChild(ConsumerContext &context) const {
+    return context.GetPipeline().GetChild() == left_pipeline_.GetChild();
+  }
+
+  void ConsumeFromLeft(ConsumerContext &context, RowBatch::Row &row) const;
+  void ConsumeFromRight(ConsumerContext &context, RowBatch::Row &row) const;
+
+  void ProjectAndConsume(ConsumerContext &context, RowBatch::Row &row) const;
+
+  // Compare the keys of the buffered left row at the given index with the
+  // given right keys. Returns a negative, zero or positive 32-bit integer.
+  llvm::Value *CompareKeys(CodeGen &codegen, llvm::Value *buffer_ptr,
+                           llvm::Value *row_idx,
+                           const std::vector<codegen::Value> &right_key) const;
+
+  const planner::MergeJoinPlan &GetPlan() const { return join_; }
+
+ private:
+  // The plan
+  const planner::MergeJoinPlan &join_;
+
+  // The pipeline for the left subtree of the plan
+  Pipeline left_pipeline_;
+
+  // The join keys of both sides
+  std::vector<const expression::AbstractExpression *> left_key_exprs_;
+  std::vector<const expression::AbstractExpression *> right_key_exprs_;
+
+  // The attributes of the left input that are materialized after its keys
+  std::vector<const planner::AttributeInfo *> left_attributes_;
+
+  // The buffer of the left input, in the order it is produced. It is never
+  // sorted. A row holds the keys and then the left attributes.
+  RuntimeState::StateID buffer_id_;
+  Sorter buffer_;
+
+  // The index of the first buffered row whose keys are not less than the keys
+  // of the last right row
+  RuntimeState::StateID cursor_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// nested_loop_index_join_translator.h
+//
+// Identification:
+// src/include/codegen/operator/nested_loop_index_join_translator.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/operator/operator_translator.h"
+#include "codegen/tile_group.h"
+
+namespace peloton {
+
+namespace planner {
+class AttributeInfo;
+class NestedLoopIndexJoinPlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// The translator for an index nested loop join. Every tuple of the left input
+// probes an index of the inner table, and is joined with all visible matches.
+//===----------------------------------------------------------------------===//
+class NestedLoopIndexJoinTranslator : public OperatorTranslator {
+ public:
+  NestedLoopIndexJoinTranslator(const planner::NestedLoopIndexJoinPlan &plan,
+                                CompilationContext &context,
+                                Pipeline &pipeline);
+
+  void InitializeState() override;
+
+  void DefineAuxiliaryFunctions() override {}
+
+  void TearDownState() override;
+
+  std::string GetName() const override;
+
+  void Produce() const override;
+
+  void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
+
+ private:
+  // Check the predicates on a match, then project and send the row up
+  void ConsumeMatch(ConsumerContext &context, RowBatch::Row &row) const;
+
+  const planner::NestedLoopIndexJoinPlan &GetPlan() const { return plan_; }
+
+ private:
+  // The plan
+  const planner::NestedLoopIndexJoinPlan &plan_;
+
+  // All the attributes of the inner table, indexed by column id
+  std::vector<const planner::AttributeInfo *> inner_attributes_;
+
+  // Access to the tile groups of the inner table
+  TileGroup inner_tile_group_;
+
+  // The IndexProbe instance
+  RuntimeState::StateID index_probe_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
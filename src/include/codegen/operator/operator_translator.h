@@ -18,6 +18,11 @@
 #include "codegen/runtime_state.h"
 
 namespace peloton {
+
+namespace planner {
+class ProjectInfo;
+}  // namespace planner
+
 namespace codegen {
 
 // Forward declare
@@ -81,6 +86,14 @@ class OperatorTranslator {
   llvm::Value *LoadStatePtr(const RuntimeState::StateID &state_id) const;
   llvm::Value *LoadStateValue(const RuntimeState::StateID &state_id) const;
 
+  // Send a single row made of the given attribute values to the parent
+  // operator, applying the projection if one is given. This is for rows that
+  // are produced outside the consumption of the input, e.g. the unmatched rows
+  // of an outer join once its input is exhausted.
+  void ProduceSingleRow(const std::vector<const planner::AttributeInfo *> &ais,
+                        const std::vector<codegen::Value> &vals,
+                        const planner::ProjectInfo *projection = nullptr) const;
+
  private:
   // The compilation state context
   CompilationContext &context_;
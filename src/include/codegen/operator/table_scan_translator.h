@@ -17,6 +17,7 @@
 #include "codegen/operator/operator_translator.h"
 #include "codegen/scan_callback.h"
 #include "codegen/table.h"
+#include "codegen/vectorized_filter.h"
 
 namespace peloton {
 
@@ -39,7 +40,8 @@ class TableScanTranslator : public OperatorTranslator {
   TableScanTranslator(const planner::SeqScanPlan &scan,
                       CompilationContext &context, Pipeline &pipeline);
 
-  void InitializeState() override {}
+  // Initialize the order the SIMD kernels are evaluated in
+  void InitializeState() override;
 
   // Table scans don't rely on any auxiliary functions
   void DefineAuxiliaryFunctions() override {}
@@ -51,7 +53,7 @@ class TableScanTranslator : public OperatorTranslator {
   void Consume(ConsumerContext &, RowBatch &) const override {}
   void Consume(ConsumerContext &, RowBatch::Row &) const override {}
 
-  // Similar to InitializeState(), table scans don't have any state
+  // The conjunct order doesn't need any cleaning up
   void TearDownState() override {}
 
   // Get a stringified version of this translator
@@ -88,6 +90,10 @@ class TableScanTranslator : public OperatorTranslator {
     ScanConsumer(const TableScanTranslator &translator,
                  Vector &selection_vector);
 
+    // Prune tile groups using the key ranges of the pushed-down join filters
+    llvm::Value *ShouldScanTileGroup(CodeGen &codegen, llvm::Value *table_ptr,
+                                     llvm::Value *tile_group_idx) override;
+
     // The callback when starting iteration over a new tile group
     void TileGroupStart(CodeGen &, llvm::Value *tile_group_id,
                         llvm::Value *tile_group_ptr) override {
@@ -115,15 +121,28 @@ class TableScanTranslator : public OperatorTranslator {
                                 llvm::Value *tid_end,
                                 Vector &selection_vector) const;
 
-    // Filter all the rows whose TIDs are in the range [tid_start, tid_end] and
-    // store their TIDs in the output TID selection vector
-    void FilterRowsByPredicate(CodeGen &codegen,
-                               const TileGroup::TileGroupAccess &access,
-                               llvm::Value *tid_start, llvm::Value *tid_end,
-                               Vector &selection_vector) const;
+    // Filter the rows in the selection vector through the SIMD kernels of
+    // the predicate's comparisons on fixed-length columns
+    void FilterRowsByKernels(CodeGen &codegen,
+                             const TileGroup::TileGroupAccess &access,
+                             llvm::Value *tid_start, llvm::Value *tid_end,
+                             Vector &selection_vector) const;
 
-    llvm::Value *SIMDFilterRows(RowBatch &batch,
-                                const TileGroup::TileGroupAccess &access) const;
+    // Filter all the rows whose TIDs are in the range [tid_start, tid_end] and
+    // store their TIDs in the output TID selection vector. A row is valid if
+    // all of the given conjuncts are true.
+    void FilterRowsByPredicate(
+        CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+        llvm::Value *tid_start, llvm::Value *tid_end,
+        const std::vector<const expression::AbstractExpression *> &conjuncts,
+        Vector &selection_vector) const;
+
+    // Filter the rows in the selection vector through the bloom filters that
+    // hash joins pushed down into this scan
+    void FilterRowsByJoinFilters(CodeGen &codegen,
+                                 const TileGroup::TileGroupAccess &access,
+                                 llvm::Value *tid_start, llvm::Value *tid_end,
+                                 Vector &selection_vector) const;
 
    private:
     // The translator instance the consumer is generating code for
@@ -146,11 +165,27 @@ class TableScanTranslator : public OperatorTranslator {
   const storage::DataTable &GetTable() const;
 
  private:
+  // Evaluate comparisons of dictionary-encoded columns with constants in the
+  // given (part of the) predicate on the dictionary codes
+  void PrepareDictionaryComparisons(
+      const expression::AbstractExpression &expression,
+      CompilationContext &context) const;
+
   // The scan
   const planner::SeqScanPlan &scan_;
 
   // The code-generating table instance
   codegen::Table table_;
+
+  // The bloom filters hash joins pushed down into this scan
+  std::vector<CompilationContext::ScanFilter> join_filters_;
+
+  // The SIMD kernels of the predicate and the order they're evaluated in
+  VectorizedFilter vectorized_filter_;
+  RuntimeState::StateID conjunct_order_id_;
+
+  // The runtime state holding the pointer to the predicate, if there is one
+  RuntimeState::StateID predicate_id_;
 };
 
 }  // namespace codegen
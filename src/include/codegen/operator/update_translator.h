@@ -61,6 +61,9 @@ class UpdateTranslator : public OperatorTranslator {
   // Runtime state id for the updater
   RuntimeState::StateID updater_state_id_;
 
+  // Runtime state id for the pointer to the target list
+  RuntimeState::StateID target_list_state_id_;
+
   // Tuple storage area
   codegen::TableStorage table_storage_;
 };
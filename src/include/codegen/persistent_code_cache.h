@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// persistent_code_cache.h
+//
+// Identification: src/include/codegen/persistent_code_cache.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "codegen/code_context.h"
+#include "common/internal_types.h"
+#include "common/singleton.h"
+#include "common/synchronization/readwrite_latch.h"
+
+namespace peloton {
+
+namespace expression {
+class Parameter;
+}  // namespace expression
+
+namespace planner {
+class AbstractPlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// An on-disk cache of the object code of compiled queries, so that the queries
+// don't need to be compiled again after a restart.
+//
+// Every entry is a file in the cache directory, named after the fingerprint of
+// the plan (and the types of the parameters and the optimization tier) it was
+// compiled for, so the code of each tier has an entry of its own. Next to the
+// object code, the file records the build that compiled it, the hash of the IR
+// it was compiled from, the hash of the runtime state layout the code expects
+// and the tables the plan accesses.
+//
+// Queries are still translated into IR. If the entry for their fingerprint was
+// compiled from the very same IR, the JIT loads its object code rather than
+// optimizing and compiling the IR, which is where most of the compilation time
+// goes. Code that embeds process-specific addresses never matches its entry
+// and is simply compiled (and stored) again.
+//
+// The cache indexes the directory the first time it's used, reading only the
+// headers of the entries and dropping those of other builds. The object code
+// is read once a query needs it.
+//===----------------------------------------------------------------------===//
+class PersistentCodeCache : public Singleton<PersistentCodeCache> {
+ public:
+  // Is there a cache directory?
+  bool IsEnabled() const;
+
+  // Switch to the given cache directory and index the entries in it. An empty
+  // directory disables the cache.
+  void SetDirectory(const std::string &directory);
+
+  // The fingerprint of the plan when compiled for the given parameters at the
+  // given optimization tier
+  static hash_t Fingerprint(const planner::AbstractPlan &plan,
+                            const std::vector<expression::Parameter> &params,
+                            CodeContext::OptimizationTier tier);
+
+  // Find the object code compiled from the IR with the given hash for the plan
+  // with the given fingerprint. Returns false if there isn't any.
+  bool Find(hash_t fingerprint, hash_t ir_hash, hash_t layout_hash,
+            std::string &object);
+
+  // Add (or replace) the object code compiled for the plan with the given
+  // fingerprint
+  void Add(hash_t fingerprint, const planner::AbstractPlan &plan,
+           hash_t ir_hash, hash_t layout_hash, const std::string &object);
+
+  // Remove all the entries of plans accessing the table
+  void Remove(oid_t table_oid);
+
+  // Remove all the entries
+  void Clear();
+
+  // Get the number of entries in the cache
+  size_t GetCount() const;
+
+  // Get the number of times the code of an entry was reused
+  uint64_t GetNumHits() const { return num_hits_; }
+
+ private:
+  friend class Singleton<PersistentCodeCache>;
+
+  // Opens the directory configured in the settings, if there is one
+  PersistentCodeCache();
+
+  // The header at the start of every entry's file, followed by the OIDs of the
+  // tables the plan accesses and the object code
+  struct Header {
+    uint64_t magic;
+    uint64_t build_id;
+    uint64_t fingerprint;
+    uint64_t ir_hash;
+    uint64_t layout_hash;
+    uint64_t object_size;
+    uint32_t num_tables;
+    uint32_t unused;
+  };
+
+  struct Entry {
+    std::vector<oid_t> table_oids;
+  };
+
+  // Identifies the build of the engine (and the host) that compiled code
+  static uint64_t GetBuildId();
+
+  // Collect the OIDs of all the tables the plan accesses
+  static void CollectTableOids(const planner::AbstractPlan &plan,
+                               std::vector<oid_t> &table_oids);
+
+  // The path of the file of the entry with the given fingerprint
+  std::string GetPath(hash_t fingerprint) const;
+
+  // Read the header of the entry in the given file, and the table OIDs. Returns
+  // false if the file isn't an entry of this build.
+  bool ReadHeader(const std::string &path, Header &header,
+                  std::vector<oid_t> &table_oids) const;
+
+  // Remove the file of the entry with the given fingerprint
+  void RemoveFile(hash_t fingerprint) const;
+
+ private:
+  std::string directory_;
+
+  std::unordered_map<hash_t, Entry> entries_;
+
+  std::atomic<uint64_t> num_hits_;
+
+  mutable common::synchronization::ReadWriteLatch latch_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -49,6 +49,11 @@ class Pipeline {
   // Move to the next step in this pipeline
   const OperatorTranslator *NextStep();
 
+  // Move back to the given operator in this pipeline, so that the next step is
+  // its parent. Operators that send rows up from more than one place in the
+  // generated code have to move back before each.
+  void MoveTo(const OperatorTranslator *translator);
+
   uint32_t GetNumStages() const;
   uint32_t GetTranslatorStage(const OperatorTranslator *translator) const;
 
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// precompiled_plan.h
+//
+// Identification: src/include/codegen/precompiled_plan.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}  // namespace executor
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace planner {
+class AbstractPlan;
+class InsertPlan;
+class SeqScanPlan;
+class UpdatePlan;
+}  // namespace planner
+
+namespace storage {
+class TileGroup;
+}  // namespace storage
+
+namespace codegen {
+
+class BufferingConsumer;
+class QueryParameters;
+
+//===----------------------------------------------------------------------===//
+// Plans of a few simple shapes, executed by C++ templates that are compiled
+// with the engine rather than by code generated for the plan. These run at
+// native speed without any IR generation or JIT compilation, which would
+// dwarf the execution time of such plans. The shapes are:
+//
+//  - Scans of a single table, filtering on a conjunction of comparisons of
+//    fixed-width columns with constants or parameters, and outputting columns
+//  - Inserts of constant tuples
+//  - Updates of the rows of such a scan, setting columns to constants or
+//    parameters
+//
+// Each comparison runs a kernel specialized for the type of the column and
+// the comparison, over a batch of visible rows at a time.
+//===----------------------------------------------------------------------===//
+class PrecompiledPlan {
+ public:
+  // Match the plan, executed with the given parameters, against the shapes of
+  // the precompiled plans. Returns nullptr if it doesn't have any of them.
+  static std::unique_ptr<PrecompiledPlan> Match(
+      const planner::AbstractPlan &plan, const QueryParameters &parameters);
+
+  // Execute the plan with the parameters in the executor context. The given
+  // output columns of the plan are buffered in the consumer.
+  void Execute(executor::ExecutorContext &executor_context,
+               const std::vector<oid_t> &output_columns,
+               BufferingConsumer &consumer) const;
+
+ private:
+  // A conjunct of the scan's predicate, "column <comparison> value"
+  struct Term {
+    oid_t column_id;
+    peloton::type::TypeId column_type;
+    ExpressionType comparison;
+    const expression::AbstractExpression *value;
+  };
+
+  // The rows of a tile group the scan produces, with the number of them
+  using RowCallback = std::function<void(storage::TileGroup &tile_group,
+                                         const uint32_t *tids, uint32_t num)>;
+
+  // Constructor
+  PrecompiledPlan(const planner::AbstractPlan &plan,
+                  const planner::SeqScanPlan *scan, std::vector<Term> &&terms)
+      : plan_(plan), scan_(scan), terms_(std::move(terms)) {}
+
+  // Match the scan, collecting the terms of its predicate. Returns false if it
+  // isn't of the supported shape.
+  static bool MatchScan(const planner::AbstractPlan &plan,
+                        const QueryParameters &parameters,
+                        std::vector<Term> &terms);
+
+  // Collect the conjuncts of the (part of the) scan's predicate as terms
+  static bool CollectTerms(const planner::SeqScanPlan &scan,
+                           const QueryParameters &parameters,
+                           const expression::AbstractExpression &exp,
+                           std::vector<Term> &terms);
+
+  // Match the update's target list, and its scan
+  static bool MatchUpdate(const planner::UpdatePlan &update,
+                          const QueryParameters &parameters,
+                          std::vector<Term> &terms);
+
+  // Execute the scan, handing the qualifying rows to the callback
+  void Scan(executor::ExecutorContext &executor_context,
+            const RowCallback &callback) const;
+
+  // Execute the different plans
+  void ExecuteScan(executor::ExecutorContext &executor_context,
+                   const std::vector<oid_t> &output_columns,
+                   BufferingConsumer &consumer) const;
+  void ExecuteInsert(executor::ExecutorContext &executor_context) const;
+  void ExecuteUpdate(executor::ExecutorContext &executor_context) const;
+
+ private:
+  // The plan
+  const planner::AbstractPlan &plan_;
+
+  // The scan of the plan, if it has one, and the terms of its predicate
+  const planner::SeqScanPlan *scan_;
+  std::vector<Term> terms_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
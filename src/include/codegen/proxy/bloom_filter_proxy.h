@@ -27,12 +27,19 @@ PROXY(BloomFilter) {
   DECLARE_MEMBER(2, uint64_t, num_bits);
   DECLARE_MEMBER(3, uint64_t, num_misses);
   DECLARE_MEMBER(4, uint64_t, num_probes);
+  DECLARE_MEMBER(5, int64_t, min_key);
+  DECLARE_MEMBER(6, int64_t, max_key);
+  DECLARE_MEMBER(7, uint64_t, sample_probes);
+  DECLARE_MEMBER(8, uint64_t, sample_misses);
+  DECLARE_MEMBER(9, uint64_t, num_skipped);
+  DECLARE_MEMBER(10, bool, probing);
 
   DECLARE_TYPE;
 
   // Methods
   DECLARE_METHOD(Init);
   DECLARE_METHOD(Destroy);
+  DECLARE_METHOD(ShouldProbe);
 };
 
 TYPE_BUILDER(BloomFilter, util::BloomFilter);
@@ -0,0 +1,37 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// conjunct_order_proxy.h
+//
+// Identification: src/include/codegen/proxy/conjunct_order_proxy.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/proxy/proxy.h"
+#include "codegen/proxy/type_builder.h"
+#include "codegen/util/conjunct_order.h"
+
+namespace peloton {
+namespace codegen {
+
+PROXY(ConjunctOrder) {
+  DECLARE_MEMBER(0, uint32_t[util::ConjunctOrder::kMaxConjuncts], order);
+  DECLARE_MEMBER(1, uint64_t[util::ConjunctOrder::kMaxConjuncts], num_in);
+  DECLARE_MEMBER(2, uint64_t[util::ConjunctOrder::kMaxConjuncts], num_passed);
+  DECLARE_MEMBER(3, uint32_t, num_conjuncts);
+  DECLARE_MEMBER(4, uint32_t, num_batches);
+  DECLARE_TYPE;
+
+  DECLARE_METHOD(Init);
+  DECLARE_METHOD(Update);
+};
+
+TYPE_BUILDER(ConjunctOrder, util::ConjunctOrder);
+
+}  // namespace codegen
+}  // namespace peloton
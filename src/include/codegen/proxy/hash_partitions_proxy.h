@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_partitions_proxy.h
+//
+// Identification: src/include/codegen/proxy/hash_partitions_proxy.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/proxy/oa_hash_table_proxy.h"
+#include "codegen/proxy/proxy.h"
+#include "codegen/proxy/type_builder.h"
+#include "codegen/util/hash_partitions.h"
+
+namespace peloton {
+namespace codegen {
+
+PROXY(HashPartitions) {
+  DECLARE_MEMBER(0, char *, merge_func);
+  DECLARE_MEMBER(1, char *, partitions);
+  DECLARE_MEMBER(2, util::OAHashTable *, tables);
+  DECLARE_MEMBER(3, util::OAHashTable *, pre_aggregation_table);
+  DECLARE_MEMBER(4, uint64_t, key_size);
+  DECLARE_MEMBER(5, uint64_t, value_size);
+  DECLARE_MEMBER(6, uint64_t, entry_size);
+  DECLARE_MEMBER(7, uint64_t, num_flushed);
+  DECLARE_MEMBER(8, uint64_t, memory_budget);
+  DECLARE_MEMBER(9, uint64_t, partition_bytes);
+  DECLARE_MEMBER(10, char *, pending_runs);
+  DECLARE_MEMBER(11, util::OAHashTable *, run_table);
+  DECLARE_MEMBER(12, uint32_t, num_tables);
+  DECLARE_MEMBER(13, uint32_t, next_table);
+  DECLARE_TYPE;
+
+  DECLARE_METHOD(Init);
+  DECLARE_METHOD(Flush);
+  DECLARE_METHOD(Finish);
+  DECLARE_METHOD(NextTable);
+  DECLARE_METHOD(Destroy);
+};
+
+TYPE_BUILDER(HashPartitions, util::HashPartitions);
+
+}  // namespace codegen
+}  // namespace peloton
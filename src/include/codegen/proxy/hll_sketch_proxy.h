@@ -0,0 +1,30 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hll_sketch_proxy.h
+//
+// Identification: src/include/codegen/proxy/hll_sketch_proxy.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/proxy/proxy.h"
+#include "codegen/proxy/type_builder.h"
+#include "codegen/util/hll_sketch.h"
+
+namespace peloton {
+namespace codegen {
+
+PROXY(HllSketch) {
+  DECLARE_METHOD(Init);
+  DECLARE_METHOD(Update);
+  DECLARE_METHOD(Merge);
+  DECLARE_METHOD(Estimate);
+};
+
+}  // namespace codegen
+}  // namespace peloton
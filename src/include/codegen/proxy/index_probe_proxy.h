@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_probe_proxy.h
+//
+// Identification: src/include/codegen/proxy/index_probe_proxy.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/proxy/proxy.h"
+#include "codegen/proxy/type_builder.h"
+#include "codegen/index_probe.h"
+
+namespace peloton {
+namespace codegen {
+
+PROXY(IndexProbe) {
+  /// We don't need access to internal fields, so use an opaque byte array
+  DECLARE_MEMBER(0, char[sizeof(IndexProbe)], opaque);
+  DECLARE_TYPE;
+
+  /// Proxy the methods of codegen::IndexProbe
+  DECLARE_METHOD(Init);
+  DECLARE_METHOD(Probe);
+  DECLARE_METHOD(GetTileGroup);
+  DECLARE_METHOD(GetTupleOffset);
+  DECLARE_METHOD(TearDown);
+};
+
+TYPE_BUILDER(IndexProbe, codegen::IndexProbe);
+
+}  // namespace codegen
+}  // namespace peloton
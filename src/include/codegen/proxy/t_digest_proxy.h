@@ -0,0 +1,31 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// t_digest_proxy.h
+//
+// Identification: src/include/codegen/proxy/t_digest_proxy.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/proxy/proxy.h"
+#include "codegen/proxy/type_builder.h"
+#include "codegen/util/t_digest.h"
+
+namespace peloton {
+namespace codegen {
+
+PROXY(TDigest) {
+  DECLARE_METHOD(Init);
+  DECLARE_METHOD(Add);
+  DECLARE_METHOD(Merge);
+  DECLARE_METHOD(IsEmpty);
+  DECLARE_METHOD(Quantile);
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -36,6 +36,7 @@ PROXY(ZoneMapManager) {
   DECLARE_MEMBER(0, char[sizeof(storage::ZoneMapManager)], opaque);
   DECLARE_TYPE;
   DECLARE_METHOD(ShouldScanTileGroup);
+  DECLARE_METHOD(ShouldScanTileGroupInRange);
   DECLARE_METHOD(GetInstance);
 };
 
@@ -79,8 +79,14 @@ class Query {
   // Return the query plan
   const planner::AbstractPlan &GetPlan() const { return query_plan_; }
 
+  // Check if the query can run with the given parameters. The compiled code
+  // reads parameters with accessors specific to the type and nullability they
+  // had at compile time, so these must match. Only the values may differ.
+  bool IsCompatible(const QueryParametersMap &parameters_map) const;
+
   // Get the holder of the code
   CodeContext &GetCodeContext() { return code_context_; }
+  const CodeContext &GetCodeContext() const { return code_context_; }
 
   // The class tracking all the state needed by this query
   RuntimeState &GetRuntimeState() { return runtime_state_; }
@@ -89,12 +95,16 @@ class Query {
   friend class QueryCompiler;
 
   // Constructor
-  Query(const planner::AbstractPlan &query_plan);
+  Query(const planner::AbstractPlan &query_plan,
+        const QueryParametersMap &parameters_map);
 
  private:
   // The query plan
   const planner::AbstractPlan &query_plan_;
 
+  // The parameters the query was compiled for
+  std::vector<expression::Parameter> parameters_;
+
   // The code context where the compiled code for the query goes
   CodeContext code_context_;
 
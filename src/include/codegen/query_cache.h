@@ -24,23 +24,58 @@ namespace codegen {
 
 // Query cache implementation that maps an AbstractPlan with a CodeGen query
 // using LRU eviction policy. The cache is implemented as a singleton.
+// The object code of compiled queries additionally survives restarts in the
+// PersistentCodeCache, if configured. Removing the queries of a table from this
+// cache also drops them from there.
+// The cache tracks how long each query ran. Queries that ran long enough are
+// compiled again in the background at the aggressive optimization tier, which
+// replaces them.
 // Potential enhancements (major):
-//   1) Persistency may increase the performance when rebooted
-//   2) Apply other eviction policies
+//   1) Apply other eviction policies
 //     e.g. Keep some heavy compilation workloads by mixing policies
-//   3) Have a cache per table
+//   2) Have a cache per table
 // Potential enhancements (minor):
 //   1) Manually keep some of the compiled results in the cache
 //   2) Configure the cache size
 class QueryCache : public Singleton<QueryCache> {
  public:
-  // Find the cached query object with the given plan
-  Query *Find(const std::shared_ptr<planner::AbstractPlan> &key);
+  // Statistics on the queries compiled at one optimization tier
+  struct TierStats {
+    // The number of queries compiled at the tier, and the time it took
+    uint64_t num_compiled = 0;
+    double compile_ms = 0.0;
+
+    // The number of executions of the queries, and the time they took
+    uint64_t num_executed = 0;
+    double execution_ms = 0.0;
+  };
+
+  // Find the cached query object with the given plan. If the parameters of
+  // the execution are given, the query must also be compatible with them.
+  Query *Find(const std::shared_ptr<planner::AbstractPlan> &key,
+              const QueryParametersMap *parameters_map = nullptr);
 
   // Add a plan and a query object to the cache
   void Add(const std::shared_ptr<planner::AbstractPlan> &key,
            std::unique_ptr<Query> &&val);
 
+  // Record an execution of the cached query with the given plan. Returns true
+  // if the caller should recompile the query at the aggressive tier, which
+  // happens only once per query.
+  bool RecordExecution(const std::shared_ptr<planner::AbstractPlan> &key,
+                       const Query *query, double execution_ms);
+
+  // Replace the cached query of the plan with the given hash by the query
+  // recompiled at a higher tier. The recompiled query must have been compiled
+  // from the given private copy of the plan, which the cache keeps alive along
+  // with the query.
+  void Replace(hash_t plan_hash, const Query *query,
+               std::shared_ptr<planner::AbstractPlan> plan,
+               std::unique_ptr<Query> &&recompiled);
+
+  // Get the statistics on the queries compiled at the given tier
+  TierStats GetTierStats(CodeContext::OptimizationTier tier);
+
   // Remove all the items in the cache
   void Clear();
 
@@ -67,16 +102,47 @@ class QueryCache : public Singleton<QueryCache> {
   // Get the table Oid from the plan given
   oid_t GetOidFromPlan(const planner::AbstractPlan &plan) const;
 
+  struct CacheEntry {
+    std::shared_ptr<planner::AbstractPlan> plan;
+    // The hash of the plan when it was added. Prepared statements rebind the
+    // parameter types of their plan on every execution, which can change its
+    // hash, so the cache never rehashes a plan once it is added.
+    hash_t plan_hash;
+    std::unique_ptr<Query> query;
+    // The time the query ran so far, and whether it was recompiled
+    double execution_ms;
+    bool recompiled;
+    // The copy of the plan the recompiled query was compiled from, if any
+    std::shared_ptr<planner::AbstractPlan> query_plan;
+    // The query that was replaced by its recompilation. Executions that found
+    // it before may still be running it.
+    std::unique_ptr<Query> replaced_query;
+  };
+
+  // Remove the map entry of the cache entry at the given position
+  void EraseFromMap(std::list<CacheEntry>::iterator entry);
+
+  // Find the entry of the given query of the plan with the given hash. Returns
+  // the end of the list if the query was evicted.
+  std::list<CacheEntry>::iterator FindEntry(hash_t plan_hash,
+                                            const Query *query);
+
+  // Count the compilation of the query towards the statistics of its tier
+  void RecordCompilation(const Query &query);
+
  private:
-  std::list<std::pair<std::shared_ptr<planner::AbstractPlan>,
-                      std::unique_ptr<Query>>> query_list_;
+  std::list<CacheEntry> query_list_;
 
-  std::unordered_map<std::shared_ptr<planner::AbstractPlan>,
-                     decltype(query_list_.begin()), planner::Hash,
-                     planner::Equal> cache_map_;
+  // Plans with the same hash may be cached more than once, compiled for
+  // parameters of different types or nullability
+  std::unordered_multimap<hash_t, decltype(query_list_.begin())> cache_map_;
 
   common::synchronization::ReadWriteLatch cache_lock_;
 
+  // The statistics of all queries compiled at each tier, including the ones
+  // that are no longer cached
+  TierStats tier_stats_[CodeContext::kNumOptimizationTiers];
+
   size_t capacity_ = 0;
 };
 
@@ -53,11 +53,13 @@ class QueryCompiler {
   // Compile the provided query, returning the compiled plan that can be invoked
   // to return results. Callers can also pass in an (optional) CompileStats
   // object pointer if they want to collect statistics on the compilation
-  // process.
-  std::unique_ptr<Query> Compile(const planner::AbstractPlan &query_plan,
-                                 const QueryParametersMap &parameters_map,
-                                 QueryResultConsumer &consumer,
-                                 CompileStats *stats = nullptr);
+  // process, and the tier to optimize the code at.
+  std::unique_ptr<Query> Compile(
+      const planner::AbstractPlan &query_plan,
+      const QueryParametersMap &parameters_map, QueryResultConsumer &consumer,
+      CompileStats *stats = nullptr,
+      CodeContext::OptimizationTier tier =
+          CodeContext::OptimizationTier::Standard);
 
   // Get the next available query plan ID
   uint64_t NextId() { return next_id_++; }
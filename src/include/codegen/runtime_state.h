@@ -56,6 +56,13 @@ class RuntimeState {
   // can specify whether the state is local (i.e., on the stack) or global.
   RuntimeState::StateID RegisterState(std::string name, llvm::Type *type);
 
+  // Register state with the given name holding the given pointer, which is set
+  // before the query runs. Generated code loads pointers to objects of the plan
+  // from such state rather than embedding the address, so the code doesn't
+  // depend on where the objects happen to be allocated.
+  RuntimeState::StateID RegisterPointer(std::string name, llvm::Type *type,
+                                        const void *ptr);
+
   // Get the pointer to the given state information with the given ID
   llvm::Value *LoadStatePtr(CodeGen &codegen,
                             RuntimeState::StateID state_id) const;
@@ -67,6 +74,13 @@ class RuntimeState {
   // Construct the equivalent LLVM type that represents this runtime state
   llvm::Type *FinalizeType(CodeGen &codegen);
 
+  // Hash the names and sizes of all the state, i.e., the layout of the runtime
+  // state that the compiled code expects
+  hash_t HashLayout(CodeGen &codegen);
+
+  // Store the registered pointers into the given (finalized) runtime state
+  void InitializePointers(CodeGen &codegen, char *state) const;
+
  private:
   // Little struct to track information of elements in the runtime state
   struct StateInfo {
@@ -79,6 +93,9 @@ class RuntimeState {
 
     // If the state is local, this is the current value of the state
     llvm::Value *val;
+
+    // If the state is a pointer set before the query runs, the pointer
+    const void *ptr;
   };
 
  private:
@@ -31,6 +31,14 @@ class ScanCallback {
   // Virtual destructor
   virtual ~ScanCallback() {}
 
+  // Callback to decide whether the tile group with the provided index must be
+  // scanned at all. Clients that can prune tile groups override this.
+  virtual llvm::Value *ShouldScanTileGroup(CodeGen &codegen,
+                                           UNUSED_ATTRIBUTE llvm::Value *table,
+                                           UNUSED_ATTRIBUTE llvm::Value *idx) {
+    return codegen.ConstBool(true);
+  }
+
   // Callback for when iteration begins over a new tile group. The second
   // parameter is a pointer to the tile group.
   virtual void TileGroupStart(CodeGen &codegen, llvm::Value *tile_group_id,
@@ -38,6 +38,10 @@ class Sorter {
       // Load a column at the given index in the row
       codegen::Value LoadColumn(CodeGen &codegen, uint32_t column_index);
 
+      // Store the given value into the column at the given index in the row
+      void StoreColumn(CodeGen &codegen, uint32_t column_index,
+                       const codegen::Value &value);
+
      private:
       friend class SorterAccess;
       Row(SorterAccess &access, llvm::Value *row_idx);
@@ -60,6 +64,13 @@ class Sorter {
     codegen::Value LoadRowValue(CodeGen &codegen, Row &row,
                                 uint32_t column_index) const;
 
+    // Store the value into the column with the provided index in the row
+    void StoreRowValue(CodeGen &codegen, Row &row, uint32_t column_index,
+                       const codegen::Value &value) const;
+
+    // Get the pointer to the start of the given row
+    llvm::Value *GetRowPosition(CodeGen &codegen, Row &row) const;
+
    private:
     // The physical data format
     const Sorter &sorter_;
@@ -125,6 +136,10 @@ class Sorter {
   llvm::Value *GetNumberOfStoredTuples(CodeGen &codegen,
                                        llvm::Value *sorter_ptr) const;
 
+  // The position of the first stored tuple, used to build a SorterAccess
+  llvm::Value *GetStartPosition(CodeGen &codegen,
+                                llvm::Value *sorter_ptr) const;
+
  private:
   //===--------------------------------------------------------------------===//
   // ACCESSORS
@@ -132,8 +147,6 @@ class Sorter {
   //       to something like: codegen.LoadMember<SorterProxy::start_pos>(...)
   //===--------------------------------------------------------------------===//
 
-  llvm::Value *GetStartPosition(CodeGen &codegen,
-                                llvm::Value *sorter_ptr) const;
   llvm::Value *GetTupleSize(CodeGen &codegen) const;
 
  private:
@@ -46,6 +46,14 @@ class TileGroup {
 
   llvm::Value *GetTileGroupId(CodeGen &codegen, llvm::Value *tile_group) const;
 
+  // Load the given columns of the single tuple with the provided TID, e.g. a
+  // tuple found through an index. The column layouts are stored in the
+  // provided ColumnLayoutInfo array.
+  std::vector<codegen::Value> LoadColumns(
+      CodeGen &codegen, llvm::Value *tile_group_ptr,
+      llvm::Value *column_layouts, llvm::Value *tid,
+      const std::vector<oid_t> &column_ids) const;
+
  private:
   // A struct to capture enough information to perform strided accesses
   struct ColumnLayout {
@@ -55,36 +63,6 @@ class TileGroup {
     llvm::Value *is_columnar;
   };
 
-  /*
-  //===--------------------------------------------------------------------===//
-  // A convenience class to access to a column
-  //===--------------------------------------------------------------------===//
-  class ColumnAccess {
-   public:
-    ColumnAccess(CodeGen &codegen, llvm::Value *column_layout, oid_t column_id);
-
-    // Load a vector of columns starting at the provided TID
-    llvm::Value *LoadVector(llvm::Value *tid, uint32_t vector_size);
-
-    // Get the pointer to the first value of the column
-    llvm::Value *GetColumnPtr();
-
-    // Get the column's stride in the tile group
-    llvm::Value *GetStride();
-
-    // Is the column stored in columnar form?
-    llvm::Value *IsColumnar();
-
-   private:
-    CodeGen &codegen_;
-    llvm::Value *column_layout_;
-
-    oid_t column_id_;
-    llvm::Value *col_ptr_;
-    llvm::Value *col_stride_;
-    llvm::Value *is_columnar_;
-  };
-  */
 
   std::vector<TileGroup::ColumnLayout> GetColumnLayouts(
       CodeGen &codegen, llvm::Value *tile_group_ptr,
@@ -95,6 +73,31 @@ class TileGroup {
                             const TileGroup::ColumnLayout &layout) const;
 
  public:
+  //===--------------------------------------------------------------------===//
+  // A convenience class to access a fixed-length column of the tile group
+  // vector-at-a-time
+  //===--------------------------------------------------------------------===//
+  class ColumnAccess {
+   public:
+    // Constructor
+    ColumnAccess(const TileGroup &tile_group, const ColumnLayout &layout);
+
+    // Load the values of the given number of consecutive rows, starting at the
+    // row with the provided TID, into an LLVM vector. The load only assumes
+    // the alignment of a single value. NULLs are not checked.
+    llvm::Value *LoadVector(CodeGen &codegen, llvm::Value *tid,
+                            uint32_t vector_size) const;
+
+    // Get the LLVM type of a single value of the column
+    llvm::Type *GetValueType(CodeGen &codegen) const;
+
+   private:
+    // The tile group the column belongs to
+    const TileGroup &tile_group_;
+    // The layout of the column
+    const ColumnLayout &layout_;
+  };
+
   //===--------------------------------------------------------------------===//
   // A convenience class that allows generic access (i.e., either row-oriented
   // or column-oriented) to the tile group.
@@ -131,6 +134,9 @@ class TileGroup {
     // Load a specific row from the batch
     Row GetRow(llvm::Value *tid) const;
 
+    // Access the column at the given index vector-at-a-time
+    ColumnAccess GetColumn(uint32_t col_idx) const;
+
     //===------------------------------------------------------------------===//
     // ACCESSORS
     //===------------------------------------------------------------------===//
@@ -61,6 +61,9 @@ class Updater {
   void TearDown();
 
  private:
+  // Precompiled plans use the instance directly
+  friend class PrecompiledPlan;
+
   // No external constructor
   Updater(): table_(nullptr), executor_context_(nullptr), target_list_(nullptr),
              is_owner_(false), acquired_ownership_(false), tile_(nullptr) {}
@@ -36,6 +36,13 @@ class BloomFilter {
   // Number of hash functions to use.
   static const uint64_t kNumHashFuncs;
 
+  // A filter that is pushed down into a scan is switched off when more than
+  // this fraction of the last kSampleSize probed tuples passed it. It is then
+  // skipped for kSkipInterval tuples before its selectivity is sampled again.
+  static const double kMaxPassRate;
+  static const uint64_t kSampleSize;
+  static const uint64_t kSkipInterval;
+
  public:
   // Initialize bloom filter states
   void Init(uint64_t estimated_number_tuples);
@@ -43,6 +50,18 @@ class BloomFilter {
   // Destroy the bloom filter states
   void Destroy();
 
+  // Should the filter be probed for the next batch of the given number of
+  // tuples? This adapts probing to the selectivity observed so far.
+  bool ShouldProbe(uint32_t num_tuples);
+
+  // Statistics of this filter
+  uint64_t GetNumProbes() const { return num_probes_; }
+  uint64_t GetNumMisses() const { return num_misses_; }
+
+  // Statistics of all filters destroyed so far
+  static uint64_t GetTotalNumProbes();
+  static uint64_t GetTotalNumMisses();
+
  private:
   // Number of hash functions to use
   uint64_t num_hash_funcs_;
@@ -58,6 +77,21 @@ class BloomFilter {
 
   // Statistic: number of probes
   uint64_t num_probes_;
+
+  // The smallest and largest (integral) key added to the filter, if the code
+  // building the filter tracks them
+  int64_t min_key_;
+  int64_t max_key_;
+
+  // The number of probes and misses when the current sample started
+  uint64_t sample_probes_;
+  uint64_t sample_misses_;
+
+  // The number of tuples that went by since probing was switched off
+  uint64_t num_skipped_;
+
+  // Is the filter currently being probed?
+  bool probing_;
 };
 
 }  // namespace util
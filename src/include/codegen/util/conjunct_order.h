@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// conjunct_order.h
+//
+// Identification: src/include/codegen/util/conjunct_order.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+//===----------------------------------------------------------------------===//
+// The order in which a scan evaluates the conjuncts of its predicate.
+//
+// The generated code evaluates the conjuncts in the order given by the array
+// of conjunct IDs, skipping the rows that failed an earlier one, and counts
+// the rows each conjunct was evaluated on and how many of them passed. Every
+// kReorderInterval batches, the conjuncts are sorted by the fraction of rows
+// they passed, most selective first, and the counts are halved so that the
+// order follows changes in the data.
+//===----------------------------------------------------------------------===//
+class ConjunctOrder {
+ public:
+  static constexpr uint32_t kMaxConjuncts = 16;
+  static constexpr uint32_t kReorderInterval = 32;
+
+  // Start out evaluating the given number of conjuncts in predicate order
+  void Init(uint32_t num_conjuncts);
+
+  // Called after every batch, reorders the conjuncts from time to time
+  void Update();
+
+ private:
+  // The IDs of the conjuncts in the order they're evaluated in
+  uint32_t order_[kMaxConjuncts];
+
+  // The number of rows each conjunct was evaluated on and how many passed
+  uint64_t num_in_[kMaxConjuncts];
+  uint64_t num_passed_[kMaxConjuncts];
+
+  uint32_t num_conjuncts_;
+
+  // The number of batches since the last reordering
+  uint32_t num_batches_;
+};
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
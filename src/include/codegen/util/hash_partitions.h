@@ -0,0 +1,192 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_partitions.h
+//
+// Identification: src/include/codegen/util/hash_partitions.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace peloton {
+
+class SpillFile;
+
+namespace codegen {
+namespace util {
+
+class OAHashTable;
+
+//===----------------------------------------------------------------------===//
+// Radix partitions of the entries of an OAHashTable, used by two-phase hash
+// aggregations over inputs with many groups.
+//
+// The query pre-aggregates its input into a small, cache-resident hash table.
+// Whenever that table fills up, its entries are flushed into the partition
+// chosen by their hash value and the table starts over. After the input
+// is exhausted, the entries of each partition are merged into a hash table of
+// their own using a merge function the query provides. A key is always flushed
+// to the same partition, so the partitions are merged independently and in
+// parallel. The helper threads merging them come out of a budget shared by all
+// queries (the aggregation_merge_threads setting).
+//
+// If the pre-aggregation table never filled up, it holds the final result and
+// is used as is.
+//
+// The partitions are kept in memory as long as they fit into the memory budget
+// of the aggregation. Once they outgrow it, all partitions are written to
+// temporary files and the partitions are merged one after another while the
+// result is read. A partition whose merged table outgrows the budget again is
+// split into partitions on the next bits of the hash values, recursively.
+//===----------------------------------------------------------------------===//
+class HashPartitions {
+ public:
+  // The entries are split into 2^kNumPartitionBits partitions
+  static constexpr uint32_t kNumPartitionBits = 6;
+  static constexpr uint32_t kNumPartitions = 1u << kNumPartitionBits;
+
+  // The minimum number of entries merged by each thread
+  static constexpr uint64_t kMinEntriesPerThread = 16 * 1024;
+
+  // The deepest level of recursive partitioning. At this level, all bits of
+  // the hash values were used and partitions are merged regardless of the
+  // memory budget.
+  static constexpr uint32_t kMaxLevel = 64 / kNumPartitionBits - 1;
+
+  // The function merging the given number of contiguous hash entries (in the
+  // format of the flushed hash table) into the given hash table
+  typedef void (*MergeFunction)(OAHashTable *table, const char *entries,
+                                uint64_t num_entries);
+
+  // An opaque block of memory is allocated for instances of this class by the
+  // query, as for OAHashTable
+  HashPartitions() = delete;
+  ~HashPartitions() = delete;
+
+  // Initialize the partitions, which will be merged with the given function.
+  // The partitions spill to disk once they take more than the given number of
+  // bytes. A budget of zero never spills.
+  void Init(MergeFunction merge_func, uint64_t memory_budget);
+
+  // Move all entries of the given (pre-aggregation) hash table into the
+  // partitions, leaving it empty
+  void Flush(OAHashTable &table);
+
+  // Called after all input has been aggregated into the given table. If
+  // anything was flushed, the rest of the table is flushed and the partitions
+  // are merged. Otherwise, the table is the only result table.
+  void Finish(OAHashTable &table);
+
+  // The next hash table holding a part of the result after Finish(), or NULL
+  // once all of them were returned. A table is only valid until the next call.
+  OAHashTable *NextTable();
+
+  // Did the partitions have to be written to disk?
+  bool HasSpilled() const { return pending_runs_ != nullptr; }
+
+  // The number of helper threads that merged partitions so far, across all
+  // queries
+  static uint64_t GetNumMergeHelpers();
+
+  // Clean up all resources
+  void Destroy();
+
+ private:
+  // The entries of one partition. The first entries were written to the spill
+  // file, if any, the rest are stored contiguously in memory.
+  struct Partition {
+    char *entries;
+    uint64_t num_entries;
+    uint64_t capacity;
+    SpillFile *file;
+    uint64_t num_spilled;
+  };
+
+  // A spilled partition waiting to be merged
+  struct Run {
+    SpillFile *file;
+    uint64_t num_entries;
+    uint32_t level;
+  };
+
+  // Find the partition of the given hash value at the given level of
+  // partitioning. The hash is mixed first, since its low bits also decide the
+  // bucket in the table of the partition.
+  static uint32_t PartitionFor(uint64_t hash, uint32_t level) {
+    return static_cast<uint32_t>(
+        ((hash * 0x9E3779B97F4A7C15ull) << (level * kNumPartitionBits)) >>
+        (64 - kNumPartitionBits));
+  }
+
+  // Move all entries of the table into the partitions of the given level
+  void Distribute(OAHashTable &table, uint32_t level);
+
+  // Append an entry to the given partition
+  void Append(Partition &partition, const char *entry);
+
+  // Write the in-memory entries of all partitions to their spill files
+  void Spill();
+
+  // Spill all partitions and queue them as runs of the given level
+  void SealRuns(uint32_t level);
+
+  // Merge all in-memory partitions into their own hash tables
+  void MergePartitions();
+
+  // Merge the given spilled run into the current table. Returns false if the
+  // run outgrew the memory budget and was split into runs of the next level.
+  bool MergeRun(const Run &run);
+
+  // Free the table the last spilled run was merged into
+  void DestroyRunTable();
+
+ private:
+  // The function merging the entries of a partition into a table
+  MergeFunction merge_func_;
+
+  // The array of kNumPartitions partitions
+  Partition *partitions_;
+
+  // The array of kNumPartitions merged tables, allocated by Finish()
+  OAHashTable *tables_;
+
+  // The pre-aggregation table, if it holds the result
+  OAHashTable *pre_aggregation_table_;
+
+  // The layout of the flushed entries
+  uint64_t key_size_;
+  uint64_t value_size_;
+  uint64_t entry_size_;
+
+  // The total number of entries flushed into the partitions
+  uint64_t num_flushed_;
+
+  // The number of bytes the partitions and tables may take, zero if unlimited
+  uint64_t memory_budget_;
+
+  // The number of bytes taken by the in-memory entries of the partitions
+  uint64_t partition_bytes_;
+
+  // The spilled runs still to be merged, allocated once the partitions spill
+  std::vector<Run> *pending_runs_;
+
+  // The table the last spilled run was merged into
+  OAHashTable *run_table_;
+
+  // The number of tables holding the result
+  uint32_t num_tables_;
+
+  // The index of the next table returned by NextTable()
+  uint32_t next_table_;
+};
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hll_sketch.h
+//
+// Identification: src/include/codegen/util/hll_sketch.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+//===----------------------------------------------------------------------===//
+// A fixed-size HyperLogLog sketch used by APPROX_COUNT_DISTINCT.
+//
+// Unlike libcount::HLL, which allocates its registers on the heap, the sketch
+// lives entirely in the (unaligned) aggregate storage space it is handed. The
+// registers are plain bytes, so the state survives being copied around by the
+// hash table, flushed into partitions and spilled to disk. Two sketches are
+// merged by taking the maximum of each register. The final estimate uses the
+// same empirical bias correction as libcount.
+//===----------------------------------------------------------------------===//
+class HllSketch {
+ public:
+  // 2^10 registers give a standard error of about 3.25%
+  static constexpr uint32_t kPrecision = 10;
+  static constexpr uint32_t kNumRegisters = 1u << kPrecision;
+
+  // The number of bytes the sketch occupies
+  static constexpr uint32_t kSize = kNumRegisters;
+
+  // Clear all registers of the sketch
+  static void Init(char *sketch);
+
+  // Add the value with the provided hash to the sketch
+  static void Update(char *sketch, uint64_t hash);
+
+  // Merge the other sketch into the first one
+  static void Merge(char *sketch, const char *other);
+
+  // Estimate the number of distinct values added to the sketch
+  static uint64_t Estimate(const char *sketch);
+};
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
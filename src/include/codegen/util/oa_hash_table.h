@@ -32,6 +32,8 @@ namespace util {
 // structure, also in the form of key-value pair.
 //===----------------------------------------------------------------------===//
 class OAHashTable {
+  friend class HashPartitions;
+
  public:
   static uint32_t kDefaultInitialSize;
   static uint32_t kInitialKVListCapacity;
@@ -120,6 +122,9 @@ class OAHashTable {
   // with the same key as that which is to be inserted.
   char *StoreTuple(HashEntry *entry, uint64_t hash);
 
+  // Remove all entries, keeping the current number of buckets
+  void Clear();
+
   // Clean up any resources this hash-table has.
   void Destroy();
 
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// t_digest.h
+//
+// Identification: src/include/codegen/util/t_digest.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+//===----------------------------------------------------------------------===//
+// A fixed-size merging t-digest used by APPROX_PERCENTILE.
+//
+// The digest keeps a bounded number of weighted centroids, small ones near the
+// tails and large ones in the middle (the k1 scale function), plus a buffer of
+// raw values that is folded into the centroids whenever it fills up. Like
+// HllSketch, the digest lives in the unaligned aggregate storage space it is
+// handed, never points outside of it and can therefore be copied, merged and
+// spilled freely. All fields are accessed through memcpy().
+//===----------------------------------------------------------------------===//
+class TDigest {
+ public:
+  // The compression bounds the number of centroids to kCompression + 1
+  static constexpr double kCompression = 60.0;
+  static constexpr uint32_t kMaxCentroids = 64;
+  static constexpr uint32_t kBufferSize = 64;
+
+ private:
+  struct Header {
+    // The total weight of the centroids
+    double weight;
+    // The smallest and largest value in the centroids
+    double min;
+    double max;
+    uint32_t num_centroids;
+    uint32_t num_buffered;
+  };
+
+  struct Centroid {
+    double mean;
+    double weight;
+  };
+
+  static constexpr uint32_t kCentroidsOffset = sizeof(Header);
+  static constexpr uint32_t kBufferOffset =
+      kCentroidsOffset + kMaxCentroids * sizeof(Centroid);
+
+ public:
+  // The number of bytes the digest occupies
+  static constexpr uint32_t kSize =
+      kBufferOffset + kBufferSize * sizeof(double);
+
+  // Initialize an empty digest
+  static void Init(char *digest);
+
+  // Add the value to the digest
+  static void Add(char *digest, double value);
+
+  // Merge the other digest into the first one
+  static void Merge(char *digest, const char *other);
+
+  // Has nothing been added to the digest?
+  static bool IsEmpty(const char *digest);
+
+  // Estimate the value at the given quantile (between 0 and 1) of all values
+  // added to the digest, zero if it is empty. This compresses the digest.
+  static double Quantile(char *digest, double quantile);
+
+  // The number of centroids of the digest, never more than kMaxCentroids
+  static uint32_t NumCentroids(const char *digest);
+
+ private:
+  // Append the centroids and buffered values of the digest to the list of
+  // centroids, accumulating its weight, min and max into the provided header
+  static uint32_t Gather(const char *digest, Centroid *centroids,
+                         Header &header);
+
+  // Compress the list of centroids and store them into the digest
+  static void Store(char *digest, Header &header, Centroid *centroids,
+                    uint32_t num_centroids);
+
+  // Fold the buffered values of the digest into its centroids
+  static void Compress(char *digest);
+};
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
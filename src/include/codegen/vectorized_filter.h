@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// vectorized_filter.h
+//
+// Identification: src/include/codegen/vectorized_filter.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "codegen/codegen.h"
+#include "codegen/row_batch.h"
+#include "codegen/tile_group.h"
+#include "codegen/vector.h"
+#include "common/internal_types.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace planner {
+struct AttributeInfo;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// A filter that evaluates the conjuncts of a scan predicate that compare a
+// fixed-length column with a value that doesn't change during the scan (i.e.,
+// constants, parameters and expressions over them) using SIMD kernels.
+//
+// Each kernel loads kVectorWidth consecutive values of its column, compares
+// them with the value into a mask and ANDs the mask into a byte map of the
+// rows of the batch that are still valid. Vectors of rows that all failed an
+// earlier kernel are skipped. In the end, the selection vector is compacted
+// using the byte map without any branches. The kernels run in the order kept
+// in a util::ConjunctOrder, which adapts it to the observed selectivities.
+//
+// All other conjuncts of the predicate are left to be evaluated row-at-a-time
+// on the rows that pass the kernels.
+//===----------------------------------------------------------------------===//
+class VectorizedFilter {
+ public:
+  // The number of rows a kernel processes at a time
+  static constexpr uint32_t kVectorWidth = 8;
+
+  // Constructor
+  explicit VectorizedFilter(const expression::AbstractExpression *predicate);
+
+  // Are any conjuncts of the predicate evaluated using SIMD kernels?
+  bool HasKernels() const { return !terms_.empty(); }
+
+  // The number of conjuncts evaluated using SIMD kernels
+  uint32_t NumKernels() const { return static_cast<uint32_t>(terms_.size()); }
+
+  // The conjuncts that must be evaluated row-at-a-time
+  const std::vector<const expression::AbstractExpression *> &GetResidual()
+      const {
+    return residual_;
+  }
+
+  // Generate the code that removes the rows failing any kernel's conjunct
+  // from the selection vector. All rows in the selection vector lie in the
+  // range [tid_start, tid_end). The provided row is only used to derive the
+  // values the columns are compared with.
+  void Filter(CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+              RowBatch::Row &row, llvm::Value *conjunct_order,
+              llvm::Value *tid_start, llvm::Value *tid_end,
+              Vector &selection_vector) const;
+
+ private:
+  // A conjunct of the form "column <comparison> value"
+  struct Term {
+    // The column
+    const planner::AttributeInfo *column;
+
+    // The comparison, with the column as its left side
+    ExpressionType comparison;
+
+    // The value the column is compared with
+    const expression::AbstractExpression *value;
+
+    // The type both sides are compared as
+    peloton::type::TypeId compare_type;
+  };
+
+  // The value a kernel compares its column with, derived once per batch
+  struct KernelValue {
+    llvm::Value *value;
+    llvm::Value *is_null;
+  };
+
+  // Collect the conjuncts of the given (part of the) predicate
+  void CollectConjuncts(const expression::AbstractExpression &exp);
+
+  // Check if the conjunct can be evaluated using a kernel, and if so, fill
+  // out the provided term
+  static bool MakeTerm(const expression::AbstractExpression &conjunct,
+                       Term &term);
+
+  // Generate the loop that applies the kernel of the given term to the rows
+  // in vectors of the given width, starting at the given TID for as long as
+  // full vectors remain. The TID to continue at and the counts of the rows
+  // that went into the kernel and passed it are updated.
+  void GenerateKernelLoop(CodeGen &codegen,
+                          const TileGroup::TileGroupAccess &access,
+                          const Term &term, const KernelValue &value,
+                          llvm::Value *mask, llvm::Value *tid_start,
+                          llvm::Value *tid_end, uint32_t width,
+                          llvm::Value *&tid, llvm::Value *&num_in,
+                          llvm::Value *&num_passed) const;
+
+  // Generate the comparison of the column values of the given number of rows,
+  // starting at the provided TID, returning a vector of booleans
+  llvm::Value *GenerateKernel(CodeGen &codegen,
+                              const TileGroup::TileGroupAccess &access,
+                              const Term &term, const KernelValue &value,
+                              llvm::Value *tid, uint32_t width) const;
+
+ private:
+  // The conjuncts evaluated using kernels
+  std::vector<Term> terms_;
+
+  // The conjuncts evaluated row-at-a-time
+  std::vector<const expression::AbstractExpression *> residual_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
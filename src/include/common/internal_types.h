@@ -200,6 +200,8 @@ enum class ExpressionType {
   AGGREGATE_MIN = 53,
   AGGREGATE_MAX = 54,
   AGGREGATE_AVG = 55,
+  AGGREGATE_APPROX_COUNT_DISTINCT = 56,
+  AGGREGATE_APPROX_PERCENTILE = 57,
 
   // -----------------------------
   // Functions
@@ -723,7 +725,8 @@ enum class JoinType {
   RIGHT = 2,                  // right
   INNER = 3,                  // inner
   OUTER = 4,                  // outer
-  SEMI = 5                    // IN+Subquery is SEMI
+  SEMI = 5,                   // IN+Subquery is SEMI
+  ANTI = 6                    // NOT EXISTS+Subquery is ANTI
 };
 std::string JoinTypeToString(JoinType type);
 JoinType StringToJoinType(const std::string &str);
@@ -956,6 +959,16 @@ enum class LayoutType {
 std::string LayoutTypeToString(LayoutType type);
 std::ostream &operator<<(std::ostream &os, const LayoutType &type);
 
+/* Encoding of a column of a frozen (cold) tile */
+enum class ColumnEncodingType {
+  INVALID = INVALID_TYPE_ID,
+  DICTIONARY = 1,         /* Dictionary of distinct values + bit-packed codes */
+  RUN_LENGTH = 2,         /* (value, run end) pairs */
+  FRAME_OF_REFERENCE = 3  /* Base value + bit-packed deltas */
+};
+std::string ColumnEncodingTypeToString(ColumnEncodingType type);
+std::ostream &operator<<(std::ostream &os, const ColumnEncodingType &type);
+
 //===--------------------------------------------------------------------===//
 // Trigger Types
 //===--------------------------------------------------------------------===//
@@ -1155,6 +1168,9 @@ static const cid_t MAX_EID = std::numeric_limits<eid_t>::max();
 // For epoch
 static const size_t EPOCH_LENGTH = 40;
 
+// Transaction ids each thread reserves at a time. Must be a power of two.
+static const uint32_t TXN_ID_BATCH_SIZE = 32;
+
 // For threads
 extern size_t CONNECTION_THREAD_COUNT;
 extern size_t LOGGING_THREAD_COUNT;
@@ -1305,6 +1321,7 @@ std::ostream &operator<<(std::ostream &os, const PropertyType &type);
 enum class RuleType : uint32_t {
   // Transformation rules (logical -> logical)
   INNER_JOIN_COMMUTE = 0,
+  INNER_JOIN_ASSOCIATE,
 
   // Don't move this one
   LogicalPhysicalDelimiter,
@@ -1322,6 +1339,8 @@ enum class RuleType : uint32_t {
   AGGREGATE_TO_PLAIN_AGGREGATE,
   INNER_JOIN_TO_NL_JOIN,
   INNER_JOIN_TO_HASH_JOIN,
+  INNER_JOIN_TO_INDEX_NL_JOIN,
+  INNER_JOIN_TO_MERGE_JOIN,
   IMPLEMENT_DISTINCT,
   IMPLEMENT_LIMIT,
 
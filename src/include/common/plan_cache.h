@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache.h
+//
+// Identification: src/include/common/plan_cache.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/statement.h"
+#include "common/synchronization/spin_latch.h"
+#include "type/value.h"
+
+namespace peloton {
+
+/**
+ * A plan cache shared by all connections for queries sent through the simple
+ * query protocol.
+ *
+ * Queries are keyed on the database they run in and their normalized text:
+ * whitespace is collapsed, unquoted text is lower-cased and the literal
+ * operands of comparisons in the WHERE clause are lifted to $n parameters.
+ * Quoted literals that may be dates, timestamps or numbers are kept, as the
+ * planner casts them to the type of the column. Queries that only differ in
+ * the lifted literals share one entry, and run the same parameterized plan
+ * (and compiled code from codegen::QueryCache) without being parsed or
+ * optimized again.
+ *
+ * Executing a plan binds parameter values into it, so a statement is checked
+ * out by one connection at a time. An entry keeps a few idle statements of
+ * its query; a connection that finds none prepares a new one and returns it
+ * to the cache when done.
+ */
+class PlanCache {
+ public:
+  PlanCache(const PlanCache &) = delete;
+  PlanCache &operator=(const PlanCache &) = delete;
+
+  static PlanCache &GetInstance();
+
+  /**
+   * @brief Normalize the text of a query.
+   *
+   * @param query the query text
+   * @param normalized_query the normalized text, with $n placeholders
+   * @param params the values of the lifted literals, in placeholder order
+   * @return false if the query must not go through the plan cache
+   */
+  static bool NormalizeQuery(const std::string &query,
+                             std::string &normalized_query,
+                             std::vector<type::Value> &params);
+
+  /**
+   * @brief Check out an idle statement prepared for the normalized query in
+   * the given database
+   *
+   * @return the statement, or nullptr if none is available
+   */
+  std::shared_ptr<Statement> Acquire(const std::string &database_name,
+                                     const std::string &normalized_query);
+
+  /**
+   * @brief Return a statement prepared in the given database to the cache
+   * once it is executed. Statements prepared after a miss are added the same
+   * way. The query string of the statement must be its normalized query.
+   */
+  void Release(const std::string &database_name,
+               const std::shared_ptr<Statement> &statement);
+
+  /**
+   * @brief Drop all the cached statements that reference the table. Checked
+   * out statements are replanned by their connection and not returned.
+   */
+  void InvalidateTableOid(oid_t table_id);
+
+  // Remove all the cached statements
+  void Clear();
+
+  // Get the number of queries currently cached
+  size_t GetCount();
+
+  // Get the max. number of queries to be cached
+  size_t GetCapacity() const { return capacity_; }
+
+  // Set the max. number of queries to be cached
+  void SetCapacity(size_t capacity);
+
+ private:
+  PlanCache() : capacity_(DEFAULT_PLAN_CACHE_SIZE) {}
+
+  struct CacheEntry {
+    // The database name and the normalized query
+    std::string key;
+    // Every statement of the query, checked out or not
+    std::vector<std::shared_ptr<Statement>> statements;
+    // The statements ready to be checked out
+    std::vector<std::shared_ptr<Statement>> idle_statements;
+  };
+
+  // The key of the normalized query in the given database
+  static std::string GetKey(const std::string &database_name,
+                            const std::string &normalized_query);
+
+  // Evict the least recently used entries down to the capacity. Must hold
+  // the latch.
+  void Evict();
+
+  // Remove the entry and mark its statements for replanning. Must hold the
+  // latch.
+  void Erase(std::list<CacheEntry>::iterator entry);
+
+ private:
+  // The max. number of statements kept for a single query
+  static constexpr size_t kMaxStatementsPerQuery = 16;
+
+  static constexpr size_t DEFAULT_PLAN_CACHE_SIZE = 1024;
+
+  // Entries in the LRU order, most recent first
+  std::list<CacheEntry> entry_list_;
+
+  std::unordered_map<std::string, std::list<CacheEntry>::iterator> entry_map_;
+
+  common::synchronization::SpinLatch latch_;
+
+  size_t capacity_;
+};
+
+}  // namespace peloton
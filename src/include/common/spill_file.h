@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.h
+//
+// Identification: src/include/common/spill_file.h
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+#include "common/macros.h"
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// An anonymous temporary file that operators exceeding their memory budget
+// write intermediate data to. The data is first appended and then read back
+// sequentially after a call to Rewind(). The file is removed once closed.
+//===--------------------------------------------------------------------===//
+class SpillFile {
+ public:
+  SpillFile();
+
+  ~SpillFile();
+
+  // Append the given bytes to the end of the file
+  void Write(const void *data, size_t len);
+
+  // Start reading from the beginning of the file
+  void Rewind();
+
+  // Read up to len bytes into the buffer, returning the number of bytes read.
+  // Zero means the end of the file was reached.
+  size_t Read(void *buffer, size_t len);
+
+  // Read exactly len bytes into the buffer
+  void ReadExactly(void *buffer, size_t len);
+
+  // The number of bytes written to the file
+  uint64_t Size() const { return size_; }
+
+ private:
+  std::FILE *file_;
+
+  uint64_t size_;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(SpillFile);
+};
+
+}  // namespace peloton
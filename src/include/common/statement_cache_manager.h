@@ -17,11 +17,6 @@
 
 namespace peloton {
 
-// TODO(Tianyi) remove this singleton
-class StatementCacheManager;
-// Singleton statement_cache_manager
-static std::shared_ptr<StatementCacheManager> statement_cache_manager;
-
 /**
  * The manager that stores all the registered statement caches.
  * Those registered statement caches would be notify when some
@@ -56,7 +51,7 @@ class StatementCacheManager {
 
   /**
    * @brief Notify the manager that the statements with table id is no longer
-   * valid now
+   * valid now. The shared plan cache is notified as well.
    * 
    * @param table_id The table that is no longer valid
    */
@@ -75,7 +70,7 @@ class StatementCacheManager {
    *  Initialize an statement cache manager instance
    */
   inline static void Init() {
-    statement_cache_manager = std::make_shared<StatementCacheManager>();
+    statement_cache_manager_ = std::make_shared<StatementCacheManager>();
   }
 
   // TODO (Tianyi) : move this singleton to peloton instance
@@ -84,10 +79,13 @@ class StatementCacheManager {
    * @return the statement cache manager instance
    */
   inline static std::shared_ptr<StatementCacheManager> GetStmtCacheManager() {
-    return statement_cache_manager;
+    return statement_cache_manager_;
   }
 
  private:
+  // TODO(Tianyi) remove this singleton
+  static std::shared_ptr<StatementCacheManager> statement_cache_manager_;
+
   /**
    * The registered statement caches
    */
@@ -35,6 +35,7 @@ public:
   DecentralizedEpochManager() : 
     current_global_epoch_id_(1), 
     next_txn_id_(0),
+    txn_id_generation_(1),
     snapshot_global_epoch_id_(1),
     is_running_(false) {
       // register a default thread for handling catalog stuffs.
@@ -55,6 +56,7 @@ public:
     PL_ASSERT(current_epoch_id != 0);
     current_global_epoch_id_ = current_epoch_id;
     next_txn_id_ = 0;
+    txn_id_generation_++;
     snapshot_global_epoch_id_ = 1;
     local_epochs_.clear();
     
@@ -64,6 +66,7 @@ public:
   virtual void SetCurrentEpochId(const uint64_t current_epoch_id) override {
     current_global_epoch_id_ = current_epoch_id;
     next_txn_id_ = 0;
+    txn_id_generation_++;
   }
 
   virtual void StartEpoch(std::unique_ptr<std::thread> &epoch_thread) override {
@@ -124,9 +127,12 @@ public:
 private:
 
 
-  inline uint32_t GetNextTransactionId() {
-    return next_txn_id_.fetch_add(1, std::memory_order_relaxed);
-  }
+  // Transaction ids are handed out from blocks that each OS thread reserves
+  // from next_txn_id_, so the shared counter is touched once per
+  // TXN_ID_BATCH_SIZE transactions. Ids are unique within an epoch and
+  // increasing for each thread; across threads they are only ordered by
+  // epoch, as the commit ids are (epoch_id << 32 | txn_id).
+  uint32_t GetNextTransactionId();
 
 
   void Running() {
@@ -149,7 +155,13 @@ private:
   
   // the global epoch reflects the true time of the system.
   std::atomic<eid_t> current_global_epoch_id_;
-  std::atomic<uint32_t> next_txn_id_;
+
+  // the shared txn id counter lives on its own cache line,
+  // so reserving a block does not invalidate the global epoch.
+  std::atomic<uint32_t> next_txn_id_ CACHE_ALIGNED;
+
+  // bumped whenever next_txn_id_ is reset, invalidating reserved blocks.
+  std::atomic<uint64_t> txn_id_generation_ CACHE_ALIGNED;
   
   // snapshot epoch is an epoch where the corresponding tuples may be still
   // visible to on-the-fly transactions
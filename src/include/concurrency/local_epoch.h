@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <thread>
 #include <queue>
 #include <vector>
@@ -46,12 +47,32 @@ struct EpochCompare {
   }
 };
 
+/**
+ * The epoch state of a worker thread.
+ *
+ * Running transactions are counted in a small ring of slots indexed by
+ * epoch id. Each slot packs (epoch id << 32 | txn count) into a single word,
+ * so entering and exiting an epoch is a CAS on the slot and never takes a
+ * latch. An epoch whose slot is still held by an older epoch (e.g. behind a
+ * long-running transaction) is counted in an overflow map instead, which is
+ * the only latched path.
+ *
+ * The GC publishes the epoch it is about to expire in epoch_id_lower_bound_
+ * before scanning the slots, and a transaction checks it after registering
+ * itself. One of the two always sees the other, so a transaction either
+ * retries with a newer epoch or holds back the expired epoch.
+ */
 class LocalEpoch {
 
 public:
   LocalEpoch(const size_t thread_id) : 
-    epoch_id_lower_bound_(UINT64_MAX), 
-    thread_id_(thread_id) {}
+    epoch_id_lower_bound_(0), 
+    thread_id_(thread_id),
+    overflow_count_(0) {
+    for (auto &slot : epoch_slots_) {
+      slot.store(0, std::memory_order_relaxed);
+    }
+  }
 
   bool EnterEpoch(const eid_t epoch_id, const TimestampType ts_type);
 
@@ -60,14 +81,37 @@ public:
   uint64_t GetExpiredEpochId(const uint64_t current_epoch_id);
 
 private:
-  common::synchronization::SpinLatch epoch_lock_;
-  
-  uint64_t epoch_id_lower_bound_;
+  static inline uint64_t EpochOf(const uint64_t slot) { return slot >> 32; }
+
+  static inline uint64_t CountOf(const uint64_t slot) {
+    return slot & 0xFFFFFFFF;
+  }
+
+  inline std::atomic<uint64_t> &GetSlot(const eid_t epoch_id) {
+    return epoch_slots_[epoch_id % kEpochSlotCount];
+  }
+
+  void Register(const eid_t epoch_id);
+
+  void Deregister(const eid_t epoch_id);
+
+  // the smallest epoch with running transactions, or MAX_EID.
+  eid_t GetMinActiveEpochId();
+
+private:
+  // the number of consecutive epochs tracked without the overflow map.
+  static constexpr size_t kEpochSlotCount = 64;
+
+  std::atomic<uint64_t> epoch_id_lower_bound_;
 
   size_t thread_id_;
-  
-  std::priority_queue<std::shared_ptr<Epoch>, std::vector<std::shared_ptr<Epoch>>, EpochCompare> epoch_queue_;
-  std::unordered_map<uint64_t, std::shared_ptr<Epoch>> epoch_map_;
+
+  std::atomic<uint64_t> epoch_slots_[kEpochSlotCount];
+
+  // number of transactions counted in the overflow map.
+  std::atomic<size_t> overflow_count_;
+  common::synchronization::SpinLatch overflow_lock_;
+  std::unordered_map<uint64_t, size_t> overflow_epochs_;
 };
 
 }
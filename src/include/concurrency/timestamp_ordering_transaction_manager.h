@@ -79,6 +79,11 @@ class TimestampOrderingTransactionManager : public TransactionManager {
                              const ItemPointer &location,
                              ItemPointer *index_entry_ptr = nullptr);
 
+  virtual void PerformInserts(
+      TransactionContext *const current_txn,
+      const std::vector<ItemPointer> &locations,
+      const std::vector<ItemPointer *> &index_entry_ptrs);
+
   virtual bool PerformRead(TransactionContext *const current_txn,
                            const ItemPointer &location,
                            bool acquire_ownership = false);
@@ -108,6 +108,13 @@ class TransactionManager {
                              const ItemPointer &location, 
                              ItemPointer *index_entry_ptr = nullptr) = 0;
 
+  // Register a batch of inserted tuples. index_entry_ptrs holds the index
+  // entry of each location.
+  virtual void PerformInserts(
+      TransactionContext *const current_txn,
+      const std::vector<ItemPointer> &locations,
+      const std::vector<ItemPointer *> &index_entry_ptrs);
+
   virtual bool PerformRead(TransactionContext *const current_txn,
                            const ItemPointer &location,
                            bool acquire_ownership = false) = 0;
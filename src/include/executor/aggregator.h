@@ -12,12 +12,17 @@
 
 #pragma once
 
+#include <functional>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 
+#include "codegen/util/hll_sketch.h"
+#include "codegen/util/t_digest.h"
 #include "common/container_tuple.h"
 #include "executor/abstract_executor.h"
 #include "planner/aggregate_plan.h"
+#include "type/serializeio.h"
 #include "type/value_factory.h"
 #include "type/value_peeker.h"
 
@@ -27,6 +32,8 @@
 
 namespace peloton {
 
+class SpillFile;
+
 namespace storage {
 class AbstractTable;
 }
@@ -43,7 +50,15 @@ class AbstractAttributeAggregator {
 
   void SetDistinct(bool distinct) { is_distinct_ = distinct; }
 
-  void Advance(const type::Value val);
+  bool IsDistinct() const { return is_distinct_; }
+
+  // Was the given value added to the distinct values already?
+  bool HasDistinct(const type::Value &val) const {
+    return distinct_set_.count(val) != 0;
+  }
+
+  // Returns the number of bytes the state of the aggregate grew by
+  size_t Advance(const type::Value val);
   type::Value Finalize();
 
   virtual void DAdvance(const type::Value &val) = 0;
@@ -226,9 +241,102 @@ class MinAggregator : public AbstractAttributeAggregator {
   bool have_advanced;
 };
 
+// Approximates the number of distinct values with a HyperLogLog sketch
+class ApproxCountDistinctAggregator : public AbstractAttributeAggregator {
+ public:
+  ApproxCountDistinctAggregator() { codegen::util::HllSketch::Init(sketch); }
+
+  void DAdvance(const type::Value &val) {
+    if (val.IsNull()) {
+      return;
+    }
+    codegen::util::HllSketch::Update(sketch, val.Hash());
+  }
+
+  type::Value DFinalize() {
+    return type::ValueFactory::GetBigIntValue(
+        codegen::util::HllSketch::Estimate(sketch));
+  }
+
+ private:
+  char sketch[codegen::util::HllSketch::kSize];
+};
+
+// Approximates a percentile of the values with a t-digest
+class ApproxPercentileAggregator : public AbstractAttributeAggregator {
+ public:
+  ApproxPercentileAggregator(double percentile) : percentile(percentile) {
+    codegen::util::TDigest::Init(digest);
+  }
+
+  void DAdvance(const type::Value &val) {
+    if (val.IsNull()) {
+      return;
+    }
+    codegen::util::TDigest::Add(
+        digest, type::ValuePeeker::PeekDouble(
+                    val.CastAs(type::TypeId::DECIMAL)));
+  }
+
+  type::Value DFinalize() {
+    if (codegen::util::TDigest::IsEmpty(digest)) {
+      return type::ValueFactory::GetNullValueByType(type::TypeId::DECIMAL);
+    }
+    return type::ValueFactory::GetDecimalValue(
+        codegen::util::TDigest::Quantile(digest, percentile));
+  }
+
+ private:
+  double percentile;
+
+  char digest[codegen::util::TDigest::kSize];
+};
+
 /** brief Create an instance of an aggregator for the specified aggregate */
 AbstractAttributeAggregator *GetAttributeAggregatorInstance(
-    ExpressionType agg_type);
+    const planner::AggregatePlan::AggTerm &agg_term);
+
+/**
+ * @brief The values of DISTINCT aggregates that arrive after an aggregation
+ * exceeded its memory budget. Rather than growing the distinct sets of their
+ * groups, they are partitioned by hash to temporary files. Replay()
+ * deduplicates one partition at a time, splitting partitions that do not fit
+ * into the budget on the next bits of the hash.
+ */
+class DistinctSpill {
+ public:
+  /** Receives the group-by key, the aggregate and one of its values */
+  typedef std::function<void(const std::vector<type::Value> &, oid_t,
+                             const type::Value &)> Callback;
+
+  DistinctSpill(size_t num_key_values, size_t memory_budget,
+                uint32_t level = 0);
+
+  ~DistinctSpill();
+
+  /** Add a value of the given aggregate of the group with the given key */
+  void Spill(const std::vector<type::Value> &key, oid_t aggno,
+             const type::Value &value);
+
+  /** Pass every spilled value to the callback once, then drop them */
+  void Replay(const Callback &callback);
+
+ private:
+  /** Append a serialized value to the partition of its hash */
+  void Write(const std::string &record);
+
+  const size_t num_key_values_;
+
+  const size_t memory_budget_;
+
+  const uint32_t level_;
+
+  /** The file of a partition is created when its first value is spilled */
+  std::vector<std::unique_ptr<SpillFile>> spill_files_;
+
+  /** Buffer for serializing spilled values */
+  CopySerializeOutput spill_output_;
+};
 
 /*
  * Interface for an aggregator (not an an individual attribute aggregate)
@@ -263,12 +371,18 @@ class AbstractAggregator {
 /**
  * @brief Used when input is NOT sorted.
  * Will maintain an internal hash table.
+ *
+ * Once the groups outgrow the memory budget of the aggregation, the input
+ * tuples of groups that are not in the hash table yet are partitioned by hash
+ * to temporary files. These partitions are aggregated one after another by
+ * Finalize(), splitting them further on the next bits of the hash if needed.
  */
 class HashAggregator : public AbstractAggregator {
  public:
   HashAggregator(const planner::AggregatePlan *node,
                  storage::AbstractTable *output_table,
-                 executor::ExecutorContext *econtext, size_t num_input_columns);
+                 executor::ExecutorContext *econtext, size_t num_input_columns,
+                 uint32_t level = 0);
 
   bool Advance(AbstractTuple *next_tuple) override;
 
@@ -277,6 +391,15 @@ class HashAggregator : public AbstractAggregator {
   ~HashAggregator();
 
  private:
+  /** Write the tuple to the spill partition of its group */
+  void Spill(AbstractTuple *tuple, size_t hash);
+
+  /** Aggregate the spilled partitions one at a time */
+  bool FinalizeSpilled();
+
+  /** Free all groups in the hash table */
+  void ClearGroups();
+
   const size_t num_input_columns;
 
   /** List of aggregates for a specific group. */
@@ -322,6 +445,29 @@ class HashAggregator : public AbstractAggregator {
 
   /** @brief Hash table */
   HashAggregateMapType aggregates_map;
+
+  /** @brief Bytes the groups may take before spilling, zero if unlimited */
+  size_t memory_budget_;
+
+  /** @brief Estimated number of bytes taken by the groups */
+  size_t memory_used_ = 0;
+
+  /** @brief Estimated number of bytes taken by the aggregates of a group */
+  size_t aggregates_size_ = 0;
+
+  /** @brief The level of recursive partitioning of this aggregator */
+  uint32_t level_;
+
+  /** @brief The spill partitions, allocated once the budget is exceeded.
+   * The file of a partition is created when the first tuple is spilled. */
+  std::vector<std::unique_ptr<SpillFile>> spill_files_;
+
+  /** @brief Buffer for serializing spilled tuples */
+  CopySerializeOutput spill_output_;
+
+  /** @brief New distinct values of the groups in memory, allocated once the
+   * budget is exceeded */
+  std::unique_ptr<DistinctSpill> distinct_spill_;
 };
 
 /**
@@ -365,6 +511,16 @@ class PlainAggregator : public AbstractAggregator {
 
  private:
   AbstractAttributeAggregator **aggregates;
+
+  /** @brief Bytes the distinct values may take before spilling, zero if
+   * unlimited */
+  size_t memory_budget_;
+
+  /** @brief Estimated number of bytes taken by the distinct values */
+  size_t memory_used_ = 0;
+
+  /** @brief New distinct values, allocated once the budget is exceeded */
+  std::unique_ptr<DistinctSpill> distinct_spill_;
 };
 }
 // namespace executor
@@ -32,6 +32,7 @@
 #include "executor/limit_executor.h"
 #include "executor/materialization_executor.h"
 #include "executor/merge_join_executor.h"
+#include "executor/nested_loop_index_join_executor.h"
 #include "executor/nested_loop_join_executor.h"
 #include "executor/order_by_executor.h"
 #include "executor/populate_index_executor.h"
@@ -47,6 +47,9 @@ class HashJoinExecutor : public AbstractJoinExecutor {
   std::deque<LogicalTile *> buffered_output_tiles;
   std::vector<std::unique_ptr<LogicalTile>> right_tiles_;
 
+  // Builds the position lists of the output tiles, across calls
+  LogicalTile::PositionListsBuilder pos_lists_builder_;
+
   // logical tile iterators
   size_t left_logical_tile_itr_ = 0;
   size_t right_logical_tile_itr_ = 0;
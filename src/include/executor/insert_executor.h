@@ -12,9 +12,17 @@
 
 #pragma once
 
+#include <vector>
+
 #include "executor/abstract_executor.h"
 
 namespace peloton {
+
+namespace storage {
+class DataTable;
+class Tuple;
+}  // namespace storage
+
 namespace executor {
 
 /**
@@ -37,6 +45,12 @@ class InsertExecutor : public AbstractExecutor {
 
   bool DExecute();
 
+ private:
+  // Insert the tuples as one batch. Returns false and fails the transaction
+  // if any of them could not be inserted.
+  bool InsertBatch(storage::DataTable *target_table,
+                   const std::vector<const storage::Tuple *> &tuples);
+
  private:
   bool done_ = false;
 };
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <iterator>
 #include <unordered_map>
 #include <vector>
@@ -114,6 +115,12 @@ class LogicalTile : public Printable {
   // Materialize and return a physical tile.
   std::unique_ptr<storage::Tile> Materialize();
 
+  // Materialize only the given columns into a physical tile with the given
+  // schema, column old_to_new_cols[i] of which holds column i of this tile.
+  std::unique_ptr<storage::Tile> Materialize(
+      const catalog::Schema &output_schema,
+      const std::unordered_map<oid_t, oid_t> &old_to_new_cols);
+
   //===--------------------------------------------------------------------===//
   // Logical Tile Iterator
   //===--------------------------------------------------------------------===//
@@ -186,6 +193,11 @@ class LogicalTile : public Printable {
     PositionListsBuilder(const PositionLists *left_pos_list,
                          const PositionLists *right_pos_list);
 
+    // Start over with the position lists of the output tile of the given
+    // tiles. The lists that weren't released are reused, and all of them are
+    // reserved for as many rows as the largest output released so far.
+    void Reset(LogicalTile *left_tile, LogicalTile *right_tile);
+
     inline void SetLeftSource(const PositionLists *left_source) {
       left_source_ = left_source;
     }
@@ -267,12 +279,14 @@ class LogicalTile : public Printable {
     }
 
     inline PositionLists &&Release() {
+      capacity_hint_ = std::max(capacity_hint_, Size());
       invalid_ = true;
       return std::move(output_lists_);
     }
 
     inline size_t Size() const {
-      if (output_lists_.size() >= 1) return output_lists_[0].size();
+      if (!invalid_ && output_lists_.size() >= 1)
+        return output_lists_[0].size();
       return 0;
     }
 
@@ -281,6 +295,7 @@ class LogicalTile : public Printable {
     const PositionLists *right_source_ = nullptr;
     PositionLists output_lists_;
     bool invalid_ = false;
+    size_t capacity_hint_ = 0;
   };
 
  private:
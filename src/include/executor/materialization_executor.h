@@ -54,19 +54,6 @@ class MaterializationExecutor : public AbstractExecutor {
   bool DExecute();
 
  private:
-  void GenerateTileToColMap(
-      const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-      LogicalTile *source_tile,
-      std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols);
-
-  void MaterializeByTiles(
-      LogicalTile *source_tile,
-      const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
-      const std::unordered_map<storage::Tile *, std::vector<oid_t>> &
-          tile_to_cols,
-      storage::Tile *dest_tile,
-      const peloton::LayoutType peloton_layout_mode = peloton::LayoutType::ROW);
-
   LogicalTile *Physify(LogicalTile *source_tile);
   std::unordered_map<oid_t, oid_t> BuildIdentityMapping(
       const catalog::Schema *schema);
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "executor/abstract_join_executor.h"
 #include "planner/merge_join_plan.h"
 
@@ -39,6 +41,18 @@ class MergeJoinExecutor : public AbstractJoinExecutor {
  private:
   size_t Advance(LogicalTile *tile, size_t start_row, bool is_left);
 
+  // Inner joins merge every left tile with the whole buffered right input, so
+  // that runs of equal keys may span tiles
+  bool DExecuteInner();
+
+  void MergeLeftTile(LogicalTile *left_tile);
+
+  // Compare the join keys of a left and a right tuple. Returns a negative
+  // value if the left keys come first, a positive value if the right ones
+  // do, and 0 if they are equal. A right tuple with a NULL key comes first.
+  int CompareJoinKeys(const AbstractTuple &left_tuple,
+                      const AbstractTuple &right_tuple) const;
+
   /** @brief a vector of join clauses
    * Get this from plan node during initialization */
   const std::vector<planner::MergeJoinPlan::JoinClause> *join_clauses_;
@@ -48,6 +62,13 @@ class MergeJoinExecutor : public AbstractJoinExecutor {
 
   size_t left_end_row = 0;
   size_t right_end_row = 0;
+
+  // The first buffered right tuple that is not less than the last left tuple
+  size_t right_cursor_tile_ = 0;
+  size_t right_cursor_row_ = 0;
+
+  // The joined tiles of the current left tile that are yet to be returned
+  std::deque<std::unique_ptr<LogicalTile>> output_tiles_;
 };
 
 }  // namespace executor
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// nested_loop_index_join_executor.h
+//
+// Identification: src/include/executor/nested_loop_index_join_executor.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+
+#include "executor/abstract_join_executor.h"
+#include "type/ephemeral_pool.h"
+
+namespace peloton {
+
+namespace index {
+class Index;
+}  // namespace index
+
+namespace storage {
+class DataTable;
+class Tuple;
+}  // namespace storage
+
+namespace executor {
+
+/**
+ * Joins every outer (left) tuple with the inner tuples found by probing an
+ * index of the inner table with the join key of the outer tuple. The only
+ * child produces the outer tuples.
+ *
+ * 2018-01-07: This is <b>deprecated</b>. Do not modify these classes.
+ * The old interpreted engine will be removed.
+ * @deprecated
+ */
+class NestedLoopIndexJoinExecutor : public AbstractJoinExecutor {
+  NestedLoopIndexJoinExecutor(const NestedLoopIndexJoinExecutor &) = delete;
+  NestedLoopIndexJoinExecutor &operator=(const NestedLoopIndexJoinExecutor &) =
+      delete;
+
+ public:
+  explicit NestedLoopIndexJoinExecutor(const planner::AbstractPlan *node,
+                                       ExecutorContext *executor_context);
+
+ protected:
+  bool DInit();
+  bool DExecute();
+
+ private:
+  // Join all the tuples of the outer tile, buffering the output tiles
+  bool JoinTile(LogicalTile *left_tile);
+
+  // Probe the index with the join key of the outer tuple, and collect the
+  // locations of the visible inner tuples satisfying the inner predicate
+  bool ProbeIndex(const AbstractTuple &left_tuple,
+                  std::vector<ItemPointer> &locations);
+
+  //===--------------------------------------------------------------------===//
+  // Plan Info
+  //===--------------------------------------------------------------------===//
+
+  // The inner table and the index we probe
+  storage::DataTable *inner_table_ = nullptr;
+  std::shared_ptr<index::Index> index_;
+
+  // The predicate on the inner table, if any
+  const expression::AbstractExpression *inner_predicate_ = nullptr;
+
+  // The inner columns that are output to the join
+  std::vector<oid_t> inner_column_ids_;
+
+  // Whether the inner tuples are read for update
+  bool acquire_owner_ = false;
+
+  //===--------------------------------------------------------------------===//
+  // Executor State
+  //===--------------------------------------------------------------------===//
+
+  // The probe key, reused across the outer tuples
+  std::unique_ptr<storage::Tuple> probe_key_;
+
+  // The varlen values of the probe key, released by the next probe
+  std::unique_ptr<type::EphemeralPool> probe_pool_;
+
+  // The joined tiles of the current outer tile that are yet to be returned
+  std::deque<std::unique_ptr<LogicalTile>> output_tiles_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -54,6 +54,9 @@ class NestedLoopJoinExecutor : public AbstractJoinExecutor {
   // return the combine result when there is a matched right tile. So next time,
   // we will begin from the point of last time, if left_tile_done is false
   bool left_tile_done_ = true;
+
+  // Builds the position lists of the output tiles, across calls
+  LogicalTile::PositionListsBuilder pos_lists_builder_;
 };
 
 }  // namespace executor
@@ -58,6 +58,12 @@ class AggregateExpression : public AbstractExpression {
       case ExpressionType::AGGREGATE_AVG:
         expr_name_ = "avg";
         break;
+      case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT:
+        expr_name_ = "approx_count_distinct";
+        break;
+      case ExpressionType::AGGREGATE_APPROX_PERCENTILE:
+        expr_name_ = "approx_percentile";
+        break;
       default:
         throw Exception("Aggregate type not supported");
     }
@@ -101,6 +107,7 @@ class AggregateExpression : public AbstractExpression {
       // if count return an integer
       case ExpressionType::AGGREGATE_COUNT:
       case ExpressionType::AGGREGATE_COUNT_STAR:
+      case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT:
         return_value_type_ = type::TypeId::INTEGER;
         break;
       // return the type of the base
@@ -111,6 +118,7 @@ class AggregateExpression : public AbstractExpression {
         return_value_type_ = children_[0]->GetValueType();
         break;
       case ExpressionType::AGGREGATE_AVG:
+      case ExpressionType::AGGREGATE_APPROX_PERCENTILE:
         return_value_type_ = type::TypeId::DECIMAL;
         break;
       default:
@@ -33,6 +33,16 @@ class ComparisonExpression : public AbstractExpression {
   ComparisonExpression(ExpressionType type, AbstractExpression *left,
                        AbstractExpression *right);
 
+  /**
+   * IN list constructor. The value is the first child and the items of the
+   * list are the remaining children.
+   *
+   * @param value The value looked up in the list
+   * @param list The items of the list
+   */
+  ComparisonExpression(AbstractExpression *value,
+                       const std::vector<AbstractExpression *> &list);
+
   /**
    * Perform the comparison of the first and second provided input tuples.
    *
@@ -58,6 +68,12 @@ class ComparisonExpression : public AbstractExpression {
   const std::string GetInfo(int num_indent) const override;
 
   const std::string GetInfo() const override;
+
+ private:
+  // Look the first child up in the list made of the other children
+  type::Value EvaluateInList(const AbstractTuple *tuple1,
+                             const AbstractTuple *tuple2,
+                             executor::ExecutorContext *context) const;
 };
 
 }  // namespace expression
@@ -261,6 +261,8 @@ class ExpressionUtil {
       case ExpressionType::AGGREGATE_MIN:
       case ExpressionType::AGGREGATE_MAX:
       case ExpressionType::AGGREGATE_AVG:
+      case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT:
+      case ExpressionType::AGGREGATE_APPROX_PERCENTILE:
         return true;
       default:
         return false;
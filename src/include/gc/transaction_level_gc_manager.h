@@ -156,6 +156,10 @@ class TransactionLevelGCManager : public GCManager {
   // this function unlinks a specified version from the index.
   void UnlinkVersion(const ItemPointer location, const GCVersionType type);
 
+  // this function computes the all-visible watermark of the full tile groups
+  // the committed transaction wrote into, off the commit path.
+  void MarkAllVisible(concurrency::TransactionContext *txn_ctx);
+
  private:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -152,6 +152,11 @@ class PostgresProtocolHandler : public ProtocolHandler {
 
   void ExecQueryMessageGetResult(ResultType status);
 
+  /* Execute a simple query through the shared plan cache */
+  ProcessResult ExecCachedQueryMessage(const std::string &normalized_query,
+                                       std::vector<type::Value> &param_values,
+                                       const size_t thread_id);
+
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
@@ -174,6 +179,9 @@ class PostgresProtocolHandler : public ProtocolHandler {
   // Statement cache
   StatementCache statement_cache_;
 
+  // The statement checked out of the shared plan cache by the running query
+  std::shared_ptr<Statement> plan_cache_statement_;
+
   //  Portals
   std::unordered_map<std::string, std::shared_ptr<Portal>> portals_;
 
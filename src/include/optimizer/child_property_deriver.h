@@ -50,6 +50,8 @@ class ChildPropertyDeriver : public OperatorVisitor {
   void Visit(const PhysicalLeftHashJoin *) override;
   void Visit(const PhysicalRightHashJoin *) override;
   void Visit(const PhysicalOuterHashJoin *) override;
+  void Visit(const PhysicalInnerIndexNLJoin *) override;
+  void Visit(const PhysicalInnerMergeJoin *) override;
   void Visit(const PhysicalInsert *) override;
   void Visit(const PhysicalInsertSelect *) override;
   void Visit(const PhysicalDelete *) override;
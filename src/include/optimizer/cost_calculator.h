@@ -37,6 +37,8 @@ class CostCalculator : public OperatorVisitor {
   void Visit(const PhysicalLeftHashJoin *) override;
   void Visit(const PhysicalRightHashJoin *) override;
   void Visit(const PhysicalOuterHashJoin *) override;
+  void Visit(const PhysicalInnerIndexNLJoin *) override;
+  void Visit(const PhysicalInnerMergeJoin *) override;
   void Visit(const PhysicalInsert *) override;
   void Visit(const PhysicalInsertSelect *) override;
   void Visit(const PhysicalDelete *) override;
@@ -50,6 +52,7 @@ class CostCalculator : public OperatorVisitor {
   double HashCost();
   double SortCost();
   double GroupByCost();
+  double OutputCost();
 
   GroupExpression *gexpr_;
   Memo *memo_;
@@ -12,9 +12,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <unordered_map>
 #include <vector>
 
+#include "common/synchronization/spin_latch.h"
 #include "optimizer/group_expression.h"
 #include "optimizer/operator_node.h"
 #include "optimizer/property.h"
@@ -31,6 +33,10 @@ class ColumnStats;
 
 //===--------------------------------------------------------------------===//
 // Group
+//
+// Groups may be explored by several optimizer threads at once (see
+// ParallelExplorer), so the expressions and stats of a group are latched.
+// Costing and the rewrite phase remain single-threaded.
 //===--------------------------------------------------------------------===//
 class Group {
  public:
@@ -42,7 +48,9 @@ class Group {
   void AddExpression(std::shared_ptr<GroupExpression> expr, bool enforced);
 
   void RemoveLogicalExpression(size_t idx) {
+    latch_.Lock();
     logical_expressions_.erase(logical_expressions_.begin() + idx);
+    latch_.Unlock();
   }
 
   bool SetExpressionCost(GroupExpression *expr, double cost,
@@ -54,22 +62,33 @@ class Group {
     return table_aliases_;
   }
 
-  // TODO: thread safety?
+  // Returns a snapshot, expressions may be added concurrently
   const std::vector<std::shared_ptr<GroupExpression>> GetLogicalExpressions()
-      const {
-    return logical_expressions_;
-  }
+      const;
 
-  // TODO: thread safety?
   const std::vector<std::shared_ptr<GroupExpression>> GetPhysicalExpressions()
-      const {
-    return physical_expressions_;
-  }
+      const;
 
   inline double GetCostLB() { return cost_lower_bound_; }
 
-  inline void SetExplorationFlag() { has_explored_ = true; }
-  inline bool HasExplored() { return has_explored_; }
+  // Claim the exploration of the group. Returns false if the group is already
+  // explored or being explored, possibly by another thread.
+  inline bool StartExploration() {
+    auto state = ExplorationState::UNEXPLORED;
+    return exploration_state_.compare_exchange_strong(
+        state, ExplorationState::EXPLORING);
+  }
+  inline void SetExplorationFlag() {
+    exploration_state_ = ExplorationState::EXPLORED;
+  }
+  // Whether the exploration of the group is started
+  inline bool HasExplored() {
+    return exploration_state_ != ExplorationState::UNEXPLORED;
+  }
+  // Whether all the tasks exploring the group are done
+  inline bool IsExplorationDone() {
+    return exploration_state_ == ExplorationState::EXPLORED;
+  }
 
   std::shared_ptr<ColumnStats> GetStats(std::string column_name);
 
@@ -77,6 +96,7 @@ class Group {
 
   bool HasColumnStats(std::string column_name);  
 
+  // Stats are derived once, concurrent derivations compute the same values
   void SetNumRows(size_t num_rows) { num_rows_ = num_rows; }
 
   int GetNumRows() { return num_rows_; }
@@ -108,8 +128,13 @@ class Group {
                      std::tuple<double, GroupExpression *>, PropSetPtrHash,
                      PropSetPtrEq> lowest_cost_expressions_;
 
+  enum class ExplorationState : uint8_t { UNEXPLORED, EXPLORING, EXPLORED };
+
   // Whether equivalent logical expressions have been explored for this group
-  bool has_explored_;
+  std::atomic<ExplorationState> exploration_state_;
+
+  // Protects the expressions and the stats
+  mutable common::synchronization::SpinLatch latch_;
 
   std::vector<std::shared_ptr<GroupExpression>> logical_expressions_;
   std::vector<std::shared_ptr<GroupExpression>> physical_expressions_;
@@ -120,7 +145,7 @@ class Group {
   // 1. use table alias id + column offset to identify the column
   // 2. Support stats for arbitary expressions
   std::unordered_map<std::string, std::shared_ptr<ColumnStats>> stats_;
-  int num_rows_ = -1;
+  std::atomic<int> num_rows_{-1};
   double cost_lower_bound_ = -1;
 };
 
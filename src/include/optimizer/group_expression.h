@@ -18,6 +18,7 @@
 #include "optimizer/property_set.h"
 #include "common/internal_types.h"
 
+#include <atomic>
 #include <map>
 #include <tuple>
 #include <vector>
@@ -78,7 +79,7 @@ class GroupExpression {
   Operator op;
   std::vector<GroupID> child_groups;
   std::bitset<static_cast<uint32_t>(RuleType::NUM_RULES)> rule_mask_;
-  bool stats_derived_;
+  std::atomic<bool> stats_derived_;
 
   // Mapping from output properties to the corresponding best cost, statistics,
   // and child properties
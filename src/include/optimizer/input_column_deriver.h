@@ -75,6 +75,9 @@ class InputColumnDeriver : public OperatorVisitor {
 
   void Visit(const PhysicalOuterHashJoin *) override;
 
+  void Visit(const PhysicalInnerIndexNLJoin *) override;
+  void Visit(const PhysicalInnerMergeJoin *) override;
+
   void Visit(const PhysicalInsert *) override;
 
   void Visit(const PhysicalInsertSelect *) override;
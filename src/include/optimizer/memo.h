@@ -16,6 +16,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "common/synchronization/readwrite_latch.h"
 #include "operator_expression.h"
 #include "optimizer/group.h"
 
@@ -35,11 +36,18 @@ struct GExprPtrEq {
 
 //===--------------------------------------------------------------------===//
 // Memo
+//
+// Expressions may be inserted by several optimizer threads exploring the memo
+// in parallel, so the groups and the expression table are latched. The
+// rewrite phase helpers below are single-threaded.
 //===--------------------------------------------------------------------===//
 class Memo {
  public:
   Memo();
 
+  // Moves the groups and expressions, the latch stays with the memo
+  Memo& operator=(Memo&& other);
+
   /* InsertExpression - adds a group expression into the proper group in the
    * memo, checking for duplicates
    *
@@ -62,6 +70,17 @@ class Memo {
     rule_set_size_ = rule_set_size;
   }
 
+  /**
+   * @brief Index the inner join groups of the tree under the root group, so
+   *  that the joins found by join reordering go to the group of the same
+   *  inputs. Called once the rewrite phase is done, as rewriting moves
+   *  predicates across joins.
+   */
+  void IndexJoinGroups(GroupID root_group_id);
+
+  // Get the number of inner join groups indexed
+  size_t GetNumJoinGroups() const { return join_groups_.size(); }
+
   //===--------------------------------------------------------------------===//
   // For rewrite phase: remove and add expression directly for the set
   //===--------------------------------------------------------------------===//
@@ -83,11 +102,26 @@ class Memo {
  private:
   GroupID AddNewGroup(std::shared_ptr<GroupExpression> gexpr);
 
+  // GetGroupByID() without latching, for callers holding the latch
+  inline Group* GetGroup(GroupID id) { return groups_[id].get(); }
+
+  // Get the (sorted) groups joined by an inner join expression, looking
+  // through the inner joins below it
+  std::vector<GroupID> GetJoinInputs(GroupExpression* gexpr);
+
   // The group owns the group expressions, not the memo
   std::unordered_set<GroupExpression*, GExprPtrHash, GExprPtrEq>
       group_expressions_;
   std::vector<std::unique_ptr<Group>> groups_;
+
+  // The inner join groups, keyed on the groups they join. Join reordering
+  // produces the same join in many ways; they all go to the same group.
+  std::map<std::vector<GroupID>, GroupID> join_groups_;
+  bool index_join_groups_;
   size_t rule_set_size_;
+
+  // Protects the groups vector, the expression table and the join groups
+  common::synchronization::ReadWriteLatch latch_;
 };
 
 }  // namespace optimizer
@@ -63,6 +63,8 @@ enum class OpType {
   LeftHashJoin,
   RightHashJoin,
   OuterHashJoin,
+  InnerIndexNLJoin,
+  InnerMergeJoin,
   Insert,
   InsertSelect,
   Delete,
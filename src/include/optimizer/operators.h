@@ -474,6 +474,57 @@ class PhysicalInnerHashJoin : public OperatorNode<PhysicalInnerHashJoin> {
   std::vector<AnnotatedExpression> join_predicates;
 };
 
+//===--------------------------------------------------------------------===//
+// InnerIndexNLJoin
+//===--------------------------------------------------------------------===//
+class PhysicalInnerIndexNLJoin : public OperatorNode<PhysicalInnerIndexNLJoin> {
+ public:
+  static Operator make(
+      std::vector<AnnotatedExpression> conditions,
+      std::vector<std::unique_ptr<expression::AbstractExpression>> &left_keys,
+      oid_t get_id, std::shared_ptr<catalog::TableCatalogObject> table,
+      std::string alias, std::vector<AnnotatedExpression> predicates,
+      bool update, oid_t index_id);
+
+  bool operator==(const BaseOperatorNode &r) override;
+
+  hash_t Hash() const override;
+
+  // The outer columns probing the index, in the order of the index key
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+
+  std::vector<AnnotatedExpression> join_predicates;
+
+  // The inner table, which is accessed through the index instead of a child
+  oid_t get_id;
+  std::vector<AnnotatedExpression> predicates;
+  std::string table_alias;
+  bool is_for_update;
+  std::shared_ptr<catalog::TableCatalogObject> table_;
+  oid_t index_id = -1;
+};
+
+//===--------------------------------------------------------------------===//
+// InnerMergeJoin
+//===--------------------------------------------------------------------===//
+class PhysicalInnerMergeJoin : public OperatorNode<PhysicalInnerMergeJoin> {
+ public:
+  static Operator make(
+      std::vector<AnnotatedExpression> conditions,
+      std::vector<std::unique_ptr<expression::AbstractExpression>> &left_keys,
+      std::vector<std::unique_ptr<expression::AbstractExpression>> &right_keys);
+
+  bool operator==(const BaseOperatorNode &r) override;
+
+  hash_t Hash() const override;
+
+  // Both children are required to be sorted ascending on their keys
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+
+  std::vector<AnnotatedExpression> join_predicates;
+};
+
 //===--------------------------------------------------------------------===//
 // LeftHashJoin
 //===--------------------------------------------------------------------===//
@@ -20,6 +20,7 @@ namespace peloton {
 namespace optimizer {
 
 class OptimizerMetadata;
+class ParallelExplorer;
 
 class OptimizeContext {
  public:
@@ -28,11 +29,20 @@ class OptimizeContext {
                   double cost_upper_bound = std::numeric_limits<double>::max())
       : metadata(metadata),
         required_prop(required_prop),
-        cost_upper_bound(cost_upper_bound) {}
+        cost_upper_bound(cost_upper_bound),
+        task_pool(nullptr),
+        explorer(nullptr) {}
 
   OptimizerMetadata *metadata;
   std::shared_ptr<PropertySet> required_prop;
   double cost_upper_bound;
+
+  // The pool the tasks are pushed to when they should not go to the pool of
+  // the metadata, i.e. the stack of an optimizer thread
+  OptimizerTaskPool *task_pool;
+
+  // Set when the memo is explored by several threads
+  ParallelExplorer *explorer;
 };
 
 }  // namespace optimizer
@@ -116,6 +116,9 @@ class Optimizer : public AbstractOptimizer {
       GroupID id, std::shared_ptr<PropertySet> required_props,
       std::vector<expression::AbstractExpression *> required_cols);
 
+  // The min. number of tables joined by a query to explore it in parallel
+  static constexpr size_t kMinParallelExploreTables = 4;
+
   //////////////////////////////////////////////////////////////////////////////
   /// Metadata
   OptimizerMetadata metadata_;
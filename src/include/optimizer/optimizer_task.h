@@ -128,17 +128,27 @@ class OptimizeExpression : public OptimizerTask {
 
 /**
  * @brief Generate all logical transformation rules by applying logical
- * transformation rules to logical operators in the group until saturated
+ * transformation rules to logical operators in the group until saturated. The
+ * task is pushed again below the exploration tasks to mark the group explored
+ * once they are done.
  */
 class ExploreGroup : public OptimizerTask {
  public:
   ExploreGroup(Group *group, std::shared_ptr<OptimizeContext> context)
       : OptimizerTask(context, OptimizerTaskType::EXPLORE_GROUP),
-        group_(group) {}
+        group_(group),
+        finish_(false) {}
+
+  ExploreGroup(ExploreGroup *task)
+      : OptimizerTask(task->context_, OptimizerTaskType::EXPLORE_GROUP),
+        group_(task->group_),
+        finish_(true) {}
+
   virtual void execute() override;
 
  private:
   Group *group_;
+  bool finish_;
 };
 
 /**
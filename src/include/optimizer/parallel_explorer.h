@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parallel_explorer.h
+//
+// Identification: src/include/optimizer/parallel_explorer.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace peloton {
+namespace optimizer {
+
+class Group;
+class OptimizerMetadata;
+class PropertySet;
+
+/**
+ * @brief Explores the memo with several threads before it is optimized.
+ *
+ * Exploring a group only needs its child groups to be explored, so the
+ * groups of independent subtrees (e.g. the many join groups produced by join
+ * reordering) can be explored in parallel. Every thread runs the tasks of the
+ * group it takes on its own OptimizerTaskStack, keeping the order the tasks of
+ * a group rely on, and offers the child groups it meets to the idle threads.
+ * A thread that needs a group being explored by another thread waits for it;
+ * as there is no cycle in the memo this can not deadlock.
+ *
+ * The helper threads come from the optimizer worker pool, which is shared by
+ * all the queries, so the number of exploring threads is bounded globally
+ * rather than per query. The calling thread explores as well, so a query
+ * still makes progress when all the workers help other queries.
+ *
+ * Costing is left to the single-threaded optimization that follows, which
+ * finds the transformation rules already applied.
+ */
+class ParallelExplorer {
+ public:
+  ParallelExplorer(OptimizerMetadata *metadata,
+                   std::shared_ptr<PropertySet> required_prop,
+                   size_t num_threads)
+      : metadata_(metadata),
+        required_prop_(required_prop),
+        num_threads_(num_threads),
+        num_busy_threads_(0),
+        failed_(false) {}
+
+  /**
+   * @brief Explore the group and all the groups below it using up to
+   *  num_threads threads, the calling thread included. The first exception
+   *  thrown by a task is rethrown once all the helper threads are done.
+   */
+  void Explore(Group *root_group);
+
+  // Queue a group for an idle thread, unless its exploration is started
+  void Offer(Group *group);
+
+  // Wait until another thread is done exploring the group
+  void WaitForExploration(Group *group);
+
+  // Wake up the threads waiting for a group, whose exploration is done
+  void NotifyExplored();
+
+ private:
+  // Explore the offered groups until none is left and no thread is busy
+  void Run();
+
+  // Take an offered group to explore, or nullptr once all the work is done
+  Group *Take();
+
+  OptimizerMetadata *metadata_;
+  std::shared_ptr<PropertySet> required_prop_;
+  size_t num_threads_;
+
+  std::mutex latch_;
+  // Signaled when a group is offered or the work is done
+  std::condition_variable work_cv_;
+  // Signaled when the exploration of a group is done
+  std::condition_variable explored_cv_;
+  // Offered groups, the most recent (i.e. deepest) first
+  std::vector<Group *> groups_;
+  // The threads exploring a group, which may offer more groups
+  size_t num_busy_threads_;
+
+  bool failed_;
+  std::exception_ptr exception_;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -76,6 +76,9 @@ class PlanGenerator : public OperatorVisitor {
 
   void Visit(const PhysicalOuterHashJoin *) override;
 
+  void Visit(const PhysicalInnerIndexNLJoin *) override;
+  void Visit(const PhysicalInnerMergeJoin *) override;
+
   void Visit(const PhysicalInsert *) override;
 
   void Visit(const PhysicalInsertSelect *) override;
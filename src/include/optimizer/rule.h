@@ -89,6 +89,16 @@ class Rule {
       std::vector<std::shared_ptr<OperatorExpression>> &transformed,
       OptimizeContext *context) const = 0;
 
+  /**
+   * @brief Whether the transformation depends on the properties required by
+   *  the context, e.g. an index scan is only generated for an index providing
+   *  the required sort order. Such a rule is applied again when the group is
+   *  optimized for other properties.
+   *
+   * @return If the rule depends on the required properties, return true
+   */
+  virtual bool DependsOnRequiredProperties() const { return false; }
+
   inline RuleType GetType() { return type_; }
 
   inline uint32_t GetRuleIdx() { return static_cast<uint32_t>(type_); }
@@ -38,6 +38,25 @@ class InnerJoinCommutativity : public Rule {
                  OptimizeContext *context) const override;
 };
 
+/**
+ * @brief (A join B) join C -> A join (B join C)
+ *
+ * Together with commutativity this enumerates all the join orders. To keep
+ * the search space bounded, the rule never introduces a cross product and
+ * does not apply to joins of more than join_reorder_max_tables tables.
+ */
+class InnerJoinAssociativity : public Rule {
+ public:
+  InnerJoinAssociativity();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
+
 //===--------------------------------------------------------------------===//
 // Implementation rules
 //===--------------------------------------------------------------------===//
@@ -86,6 +105,10 @@ class GetToIndexScan : public Rule {
   void Transform(std::shared_ptr<OperatorExpression> input,
                  std::vector<std::shared_ptr<OperatorExpression>> &transformed,
                  OptimizeContext *context) const override;
+
+  // A scan of an index providing the required sort order is only generated
+  // when the sort is required, e.g. by a merge join
+  bool DependsOnRequiredProperties() const override { return true; }
 };
 
 /**
@@ -223,6 +246,43 @@ class InnerJoinToInnerHashJoin : public Rule {
                  OptimizeContext *context) const override;
 };
 
+/**
+ * @brief (Logical Inner Join -> Inner Index Nested-Loop Join)
+ *
+ * Applies when the right child is a base table with an index whose key
+ * columns are all equi-joined with the left child. The right child is then
+ * not scanned; its index is probed with the join key of every left tuple.
+ */
+class InnerJoinToInnerIndexNLJoin : public Rule {
+ public:
+  InnerJoinToInnerIndexNLJoin();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
+
+/**
+ * @brief (Logical Inner Join -> Inner Merge Join)
+ *
+ * Both children are required to be sorted on the join keys, which an index
+ * scan may provide for free. Otherwise the sort is enforced on the child.
+ */
+class InnerJoinToInnerMergeJoin : public Rule {
+ public:
+  InnerJoinToInnerMergeJoin();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+};
+
 /**
  * @brief (Logical Distinct -> Physical Distinct)
  */
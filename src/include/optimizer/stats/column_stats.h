@@ -12,7 +12,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <sstream>
+#include <vector>
 
 #include "common/macros.h"
 #include "common/internal_types.h"
@@ -90,6 +92,20 @@ class ColumnStats {
     return os.str();
   }
 
+  // Rescale the stats to an estimated number of output rows, e.g. after a
+  // filter or a join. The most common value counts shrink with the input,
+  // and there can not be more distinct values than rows.
+  void ScaleToNumRows(size_t new_num_rows) {
+    if (num_rows != 0 && num_rows != new_num_rows) {
+      double ratio = new_num_rows / (double)num_rows;
+      for (auto &freq : most_common_freqs) {
+        freq *= ratio;
+      }
+    }
+    num_rows = new_num_rows;
+    cardinality = std::min(cardinality, (double)num_rows);
+  }
+
   void UpdateJoinStats(size_t table_num_rows, size_t sample_size,
                        size_t sample_card) {
     num_rows = table_num_rows;
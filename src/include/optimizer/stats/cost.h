@@ -36,6 +36,14 @@ static constexpr double DEFAULT_INDEX_TUPLE_COST = 0.005;
 // query.
 static constexpr double DEFAULT_OPERATOR_COST = 0.0025;
 
+// Estimate the cost of materializing each row in memory, e.g. inserting it
+// into a hash table or buffering the inner side of a nested loop join.
+static constexpr double DEFAULT_MEMORY_TUPLE_COST = 0.005;
+
+// Estimate the cost of fetching each row through a pointer instead of
+// scanning it sequentially, e.g. following an index entry to its tuple.
+static constexpr double DEFAULT_RANDOM_ACCESS_COST = 0.02;
+
 //===----------------------------------------------------------------------===//
 // Cost
 //===----------------------------------------------------------------------===//
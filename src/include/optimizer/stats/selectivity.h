@@ -71,6 +71,13 @@ class Selectivity {
     return 1 - Equal(table_stats, condition);
   }
 
+  // Selectivity of the equi-join predicate "left = right" with respect to the
+  // cross product of its inputs. The most common values of both sides are
+  // matched to account for skew, the remaining rows are assumed to be spread
+  // uniformly over the remaining distinct values.
+  static double EqualJoin(const std::shared_ptr<ColumnStats>& left_stats,
+                          const std::shared_ptr<ColumnStats>& right_stats);
+
   // Selectivity for 'LIKE' operator. The column type must be VARCHAR.
   // Complete implementation once we support LIKE operator.
   static double Like(const std::shared_ptr<TableStats>& table_stats,
@@ -89,7 +89,8 @@ class PostgresParser {
 
   static bool IsAggregateFunction(std::string &fun_name) {
     if (fun_name == "min" || fun_name == "max" || fun_name == "count" ||
-        fun_name == "avg" || fun_name == "sum")
+        fun_name == "avg" || fun_name == "sum" ||
+        fun_name == "approx_count_distinct" || fun_name == "approx_percentile")
       return true;
     return false;
   }
@@ -127,6 +128,10 @@ class PostgresParser {
   // transform helper for A_Expr nodes
   static expression::AbstractExpression *AExprTransform(A_Expr *root);
 
+  // transform helper for [NOT] IN lists
+  static expression::AbstractExpression *InListTransform(A_Expr *root,
+                                                         const char *name);
+
   // transform helper for BoolExpr nodes
   static expression::AbstractExpression *BoolExprTransform(BoolExpr *root);
 
@@ -151,6 +156,9 @@ class PostgresParser {
   // transform helper for function calls
   static expression::AbstractExpression *FuncCallTransform(FuncCall *root);
 
+  // transform helper for the percentile of approx_percentile()
+  static expression::AbstractExpression *PercentileTransform(Node *node);
+
   // transform helper for parameter refs
   static expression::AbstractExpression *ParamRefTransform(ParamRef *root);
 
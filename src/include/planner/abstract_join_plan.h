@@ -87,6 +87,11 @@ class AbstractJoinPlan : public AbstractPlan {
   virtual void HandleSubplanBinding(bool from_left,
                                     const BindingContext &input) = 0;
 
+  // Bind the projection, the attributes and the predicate of the join to the
+  // given contexts of its left and right inputs
+  void BindInputs(BindingContext &context, BindingContext &left_context,
+                  BindingContext &right_context);
+
  private:
   /** @brief The type of join that we're going to perform */
   JoinType join_type_;
@@ -108,6 +108,10 @@ class AbstractPlan : public Printable {
 
   virtual std::unique_ptr<AbstractPlan> Copy() const = 0;
 
+  // Copy the plan along with all of its children. Returns nullptr if one of
+  // them doesn't support copying.
+  std::unique_ptr<AbstractPlan> CopyTree() const;
+
   // A plan will be sent to anther node via serialization
   // So serialization should be implemented by the derived classes
 
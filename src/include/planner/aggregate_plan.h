@@ -34,11 +34,13 @@ class AggregatePlan : public AbstractPlan {
     ExpressionType aggtype;
     const expression::AbstractExpression *expression;
     bool distinct;
+    // The percentile (between 0 and 1) an APPROX_PERCENTILE aggregate computes
+    double percentile;
     // The attribute information and ID for this aggregate
     AttributeInfo agg_ai;
 
     AggTerm(ExpressionType et, expression::AbstractExpression *expr,
-            bool distinct = false);
+            bool distinct = false, double percentile = 0.5);
 
     // Bindings
     void PerformBinding(BindingContext &binding_context);
@@ -123,8 +125,11 @@ class AggregatePlan : public AbstractPlan {
 
     std::shared_ptr<const catalog::Schema> output_schema_copy(
         catalog::Schema::CopySchema(GetOutputSchema()));
+    std::unique_ptr<const expression::AbstractExpression> predicate_copy(
+        predicate_ != nullptr ? predicate_->Copy() : nullptr);
     AggregatePlan *new_plan = new AggregatePlan(
-        project_info_->Copy(), std::unique_ptr<const expression::AbstractExpression>(predicate_->Copy()),
+        project_info_ != nullptr ? project_info_->Copy() : nullptr,
+        std::move(predicate_copy),
         std::move(copied_agg_terms), std::move(copied_groupby_col_ids),
         output_schema_copy, agg_strategy_);
     return std::unique_ptr<AbstractPlan>(new_plan);
@@ -82,9 +82,18 @@ class HashJoinPlan : public AbstractJoinPlan {
                                                 : nullptr);
     std::shared_ptr<const catalog::Schema> schema_copy(
         catalog::Schema::CopySchema(GetSchema()));
+    std::vector<ExpressionPtr> left_hash_keys;
+    for (const auto &left_key : left_hash_keys_) {
+      left_hash_keys.emplace_back(left_key->Copy());
+    }
+    std::vector<ExpressionPtr> right_hash_keys;
+    for (const auto &right_key : right_hash_keys_) {
+      right_hash_keys.emplace_back(right_key->Copy());
+    }
     HashJoinPlan *new_plan = new HashJoinPlan(
         GetJoinType(), std::move(predicate_copy), GetProjInfo()->Copy(),
-        schema_copy, outer_column_ids_, build_bloomfilter_);
+        schema_copy, left_hash_keys, right_hash_keys, build_bloomfilter_);
+    new_plan->outer_column_ids_ = outer_column_ids_;
     return std::unique_ptr<AbstractPlan>(new_plan);
   }
 
@@ -57,6 +57,15 @@ class InsertPlan : public AbstractPlan {
     tuples_.push_back(std::move(tuple));
   }
 
+  // Construct with a batch of tuples, which are inserted together
+  // This can only be handled by the interpreted exeuctor
+  InsertPlan(storage::DataTable *table,
+             std::vector<std::unique_ptr<storage::Tuple>> &&tuples)
+    : target_table_(table), tuples_(std::move(tuples)),
+      bulk_insert_count_(tuples_.size()) {
+    LOG_TRACE("Creating an Insert Plan for %lu tuples", tuples_.size());
+  }
+
   // Construct with specific values
   InsertPlan(storage::DataTable *table, const std::vector<std::string> *columns,
              const std::vector<std::vector<std::unique_ptr<
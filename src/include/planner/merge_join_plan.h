@@ -56,13 +56,11 @@ class MergeJoinPlan : public AbstractJoinPlan {
   }
 
   void HandleSubplanBinding(bool from_left,
-                            const BindingContext &input) override {
-    for (auto &join_clause : *GetJoinClauses()) {
-      auto &exp = from_left ? join_clause.left_ : join_clause.right_;
-      const_cast<expression::AbstractExpression *>(exp.get())
-          ->PerformBinding({&input});
-    }
-  }
+                            const BindingContext &input) override;
+
+  hash_t Hash() const override;
+
+  bool operator==(const AbstractPlan &rhs) const override;
 
   inline PlanNodeType GetPlanNodeType() const override {
     return PlanNodeType::MERGEJOIN;
@@ -83,7 +81,7 @@ class MergeJoinPlan : public AbstractJoinPlan {
     }
 
     std::unique_ptr<const expression::AbstractExpression> predicate_copy(
-        GetPredicate()->Copy());
+        GetPredicate() != nullptr ? GetPredicate()->Copy() : nullptr);
     std::shared_ptr<const catalog::Schema> schema_copy(
         catalog::Schema::CopySchema(GetSchema()));
     MergeJoinPlan *new_plan = new MergeJoinPlan(
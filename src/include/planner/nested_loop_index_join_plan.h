@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// nested_loop_index_join_plan.h
+//
+// Identification: src/include/planner/nested_loop_index_join_plan.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "planner/abstract_join_plan.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace index {
+class Index;
+}  // namespace index
+
+namespace storage {
+class DataTable;
+}  // namespace storage
+
+namespace planner {
+
+class ProjectInfo;
+
+/**
+ * A nested loop join that probes an index of the inner table with the join key
+ * of every outer tuple, instead of scanning the inner table.
+ *
+ * The only child produces the outer tuples. The inner table is described by
+ * the plan itself: the index to probe, the inner columns the join produces
+ * (its right input) and the predicate on the inner table. The index is probed
+ * with an equality on all of its key columns, whose values are the join
+ * columns of the outer tuple.
+ */
+class NestedLoopIndexJoinPlan : public AbstractJoinPlan {
+ public:
+  NestedLoopIndexJoinPlan(
+      JoinType join_type,
+      std::unique_ptr<const expression::AbstractExpression> &&predicate,
+      std::unique_ptr<const ProjectInfo> &&proj_info,
+      std::shared_ptr<const catalog::Schema> &proj_schema,
+      const std::vector<oid_t> &join_column_ids_left,
+      storage::DataTable *inner_table, std::shared_ptr<index::Index> index,
+      const std::vector<oid_t> &inner_column_ids,
+      std::unique_ptr<const expression::AbstractExpression> &&inner_predicate,
+      bool is_for_update);
+
+  void PerformBinding(BindingContext &binding_context) override;
+
+  void HandleSubplanBinding(bool from_left, const BindingContext &ctx) override;
+
+  hash_t Hash() const override;
+
+  bool operator==(const AbstractPlan &rhs) const override;
+
+  void VisitParameters(
+      codegen::QueryParametersMap &map,
+      std::vector<peloton::type::Value> &values,
+      const std::vector<peloton::type::Value> &values_from_user) override;
+
+  PlanNodeType GetPlanNodeType() const override {
+    return PlanNodeType::NESTLOOPINDEX;
+  }
+
+  const std::string GetInfo() const override { return "NestedLoopIndexJoin"; }
+
+  std::unique_ptr<AbstractPlan> Copy() const override;
+
+  const std::vector<oid_t> &GetJoinColumnsLeft() const {
+    return join_column_ids_left_;
+  }
+
+  const std::vector<const planner::AttributeInfo *> GetJoinAIsLeft() const {
+    return join_ais_left_;
+  }
+
+  storage::DataTable *GetInnerTable() const { return inner_table_; }
+
+  const std::shared_ptr<index::Index> &GetIndex() const { return index_; }
+
+  const std::vector<oid_t> &GetInnerColumnIds() const {
+    return inner_column_ids_;
+  }
+
+  const expression::AbstractExpression *GetInnerPredicate() const {
+    return inner_predicate_.get();
+  }
+
+  bool IsForUpdate() const { return is_for_update_; }
+
+  // The attributes of all the columns of the inner table, by column id
+  void GetInnerAttributes(std::vector<const AttributeInfo *> &ais) const {
+    for (const auto &ai : inner_attributes_) {
+      ais.push_back(&ai);
+    }
+  }
+
+ private:
+  // The columns of the left child's output that make up the probe key. The
+  // i-th column is compared with the i-th key column of the index.
+  std::vector<oid_t> join_column_ids_left_;
+  std::vector<const planner::AttributeInfo *> join_ais_left_;
+
+  // The inner table and its index we probe
+  storage::DataTable *inner_table_;
+  std::shared_ptr<index::Index> index_;
+
+  // The inner columns that are the right input of the join
+  std::vector<oid_t> inner_column_ids_;
+
+  // The predicate on the inner table, if any
+  std::unique_ptr<const expression::AbstractExpression> inner_predicate_;
+
+  // Whether the inner tuples are read for update
+  bool is_for_update_;
+
+  // The attributes of all the columns of the inner table
+  std::vector<AttributeInfo> inner_attributes_;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(NestedLoopIndexJoinPlan);
+};
+
+}  // namespace planner
+}  // namespace peloton
@@ -71,6 +71,38 @@ SETTING_double(bnlj_buffer_size,
              1.0 * 1024.0 * 1024.0,
              true, true)
 
+SETTING_double(aggregation_memory_budget,
+             "The memory a hash aggregation may use before it spills to disk, "
+             "0 never spills (default: 1 GB)",
+             1024.0 * 1024.0 * 1024.0,
+             true, true)
+
+SETTING_bool(aggregation_partitioning,
+             "Pre-aggregate hash aggregations into a cache-sized table whose "
+             "partitions are merged in parallel (default: true)",
+             true,
+             true, true)
+
+SETTING_int(aggregation_pre_aggregation_size,
+            "The bytes the pre-aggregation table of a hash aggregation may "
+            "fill before it is flushed into the partitions (default: 256 KB)",
+            256 * 1024,
+            true, true)
+
+SETTING_int(aggregation_merge_threads,
+            "Max. number of helper threads merging the partitions of hash "
+            "aggregations, shared by all queries, 0 uses the number of cores "
+            "(default: 0)",
+            0,
+            true, true)
+
+SETTING_int(dictionary_max_size,
+            "Max. number of distinct values kept in the dictionary of a "
+            "dictionary-encoded column, later values are stored unencoded "
+            "(default: 1048576)",
+            1048576,
+            true, true)
+
 // Size of the MonoQueue task queue
 SETTING_int(monoqueue_task_queue_size,
             "MonoQueue Task Queue Size (default: 32)",
@@ -127,6 +159,12 @@ SETTING_bool(layout_tuner,
             false,
             true, true)
 
+// Enable or disable hot/cold tile group tiering
+SETTING_bool(tiering_tuner,
+            "Enable tiering tuner (default: false)",
+            false,
+            true, true)
+
 //===----------------------------------------------------------------------===//
 // BRAIN
 //===----------------------------------------------------------------------===//
@@ -158,6 +196,36 @@ SETTING_bool(codegen,
             true,
             true, true)
 
+SETTING_string(codegen_cache_directory,
+               "Directory keeping the code of compiled queries across "
+               "restarts, disabled if empty (default: empty)",
+               "",
+               false, false)
+
+SETTING_bool(codegen_precompiled_plans,
+             "Execute simple scans, inserts and updates with precompiled "
+             "templates instead of compiling them (default: true)",
+             true,
+             true, true)
+
+SETTING_bool(codegen_simd_predicates,
+             "Evaluate the comparisons of scan predicates on fixed-length "
+             "columns using SIMD kernels (default: true)",
+             true,
+             true, true)
+
+SETTING_int(codegen_minimal_optimization_instructions,
+            "Compile queries with more IR instructions than this without "
+            "optimizing them, 0 always optimizes (default: 50000)",
+            50000,
+            true, true)
+
+SETTING_int(codegen_aggressive_optimization_ms,
+            "Recompile cached queries with aggressive optimization once they "
+            "ran for this many milliseconds, 0 never does (default: 1000)",
+            1000,
+            true, true)
+
 
 //===----------------------------------------------------------------------===//
 // Optimizer
@@ -172,6 +240,37 @@ SETTING_bool(hash_join_bloom_filter,
              true,
              true, true)
 
+SETTING_int(join_reorder_max_tables,
+            "Max. number of tables in a join whose order is enumerated "
+            "(default: 12)",
+            12,
+            true, true)
+
+SETTING_int(optimizer_threads,
+            "Max. number of threads exploring the plan space of a large join "
+            "query (default: 4)",
+            4,
+            true, true)
+
+// Size of the optimizer task queue
+SETTING_int(optimizer_task_queue_size,
+            "Optimizer Task Queue Size (default: 32)",
+            32,
+            false, false)
+
+// Size of the optimizer worker pool, the threads helping to explore the plan
+// space of large join queries shared by all queries
+SETTING_int(optimizer_worker_pool_size,
+            "Optimizer Worker Pool Size (default: 4)",
+            4,
+            false, false)
+
+SETTING_bool(plan_cache,
+             "Share plans of simple queries across connections (default: "
+             "false)",
+             false,
+             true, true)
+
 //===----------------------------------------------------------------------===//
 // GENERAL
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_column.h
+//
+// Identification: src/include/storage/compressed_column.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace storage {
+
+class Tile;
+
+//===--------------------------------------------------------------------===//
+// Bit-packed array
+//===--------------------------------------------------------------------===//
+
+/**
+ * A fixed-size array of unsigned integers, each stored using exactly
+ * bit_width bits. A bit width of zero is legal and means every element is 0.
+ */
+class BitPackedArray {
+ public:
+  BitPackedArray() : bit_width_(0), num_elements_(0) {}
+
+  BitPackedArray(uint32_t bit_width, oid_t num_elements);
+
+  inline uint64_t Get(oid_t idx) const {
+    PL_ASSERT(idx < num_elements_);
+    if (bit_width_ == 0) {
+      return 0;
+    }
+    uint64_t bit_pos = static_cast<uint64_t>(idx) * bit_width_;
+    uint64_t word_idx = bit_pos >> 6;
+    uint32_t shift = bit_pos & 63;
+    uint64_t val = words_[word_idx] >> shift;
+    if (shift + bit_width_ > 64) {
+      val |= words_[word_idx + 1] << (64 - shift);
+    }
+    return val & mask_;
+  }
+
+  void Set(oid_t idx, uint64_t val);
+
+  uint32_t GetBitWidth() const { return bit_width_; }
+
+  size_t GetSize() const { return words_.size() * sizeof(uint64_t); }
+
+  // The number of bits needed to represent the given value
+  static uint32_t BitsRequired(uint64_t max_value);
+
+ private:
+  uint32_t bit_width_;
+  oid_t num_elements_;
+  uint64_t mask_;
+  // One extra word of padding so reads never straddle the end of the buffer
+  std::vector<uint64_t> words_;
+};
+
+//===--------------------------------------------------------------------===//
+// Compressed Column
+//===--------------------------------------------------------------------===//
+
+/**
+ * An immutable, compressed image of a single column of a tile.
+ *
+ * Every tuple slot of a tile column is first viewed as a 64-bit "slot word":
+ * the sign-extended integer for integral types, the raw bits for DECIMAL, and
+ * the varlen pointer for uninlined types. The column then picks the smallest
+ * of the following encodings over those words:
+ *
+ *  DICTIONARY         : sorted distinct words + bit-packed codes. Varlen
+ *                       columns are deduplicated on content and own their
+ *                       blobs, so decoded pointers stay valid for the
+ *                       lifetime of the column.
+ *  RUN_LENGTH         : (word, run end) pairs, for sorted or clustered data.
+ *  FRAME_OF_REFERENCE : minimum word + bit-packed deltas (integral only).
+ *
+ * NULLs are stored as the type's NULL sentinel, so they round-trip without a
+ * separate bitmap. Slots of dictionary-encoded columns already point to
+ * unique, table-owned entries, so their pointers are encoded as plain words.
+ */
+class CompressedColumn {
+ public:
+  CompressedColumn(const CompressedColumn &) = delete;
+  CompressedColumn &operator=(const CompressedColumn &) = delete;
+
+  // Compress the first tuple_count slots of the given column of the tile
+  static std::unique_ptr<CompressedColumn> Compress(const Tile &tile,
+                                                    oid_t column_id,
+                                                    oid_t tuple_count);
+
+  // Write the uncompressed fixed-length slot of the given tuple to storage
+  void Decode(oid_t tuple_offset, char *storage) const;
+
+  // Get the value of the given tuple
+  type::Value GetValue(oid_t tuple_offset) const;
+
+  /**
+   * Evaluate "column <comparison> constant" directly on the compressed
+   * representation. Positions in the (sorted) list that do not satisfy the
+   * predicate are removed. Dictionary and run-length columns evaluate the
+   * predicate once per distinct value / run; frame-of-reference columns
+   * compare unpacked deltas as integers.
+   */
+  void Filter(ExpressionType comparison, const type::Value &constant,
+              std::vector<oid_t> &positions) const;
+
+  ColumnEncodingType GetEncodingType() const { return encoding_type_; }
+
+  type::TypeId GetValueType() const { return value_type_; }
+
+  oid_t GetTupleCount() const { return tuple_count_; }
+
+  // Bytes held by the compressed representation
+  size_t GetCompressedSize() const;
+
+  // Bytes the column occupied before compression (inlined + varlen data)
+  size_t GetUncompressedSize() const { return uncompressed_size_; }
+
+ private:
+  CompressedColumn(type::TypeId value_type, bool is_inlined,
+                   size_t fixed_length, oid_t tuple_count);
+
+  // Get the slot word of the given tuple
+  uint64_t GetWord(oid_t tuple_offset) const;
+
+  // Interpret a slot word as a value of this column's type
+  type::Value WordToValue(uint64_t word) const;
+
+  // Does the predicate hold on the given slot word?
+  bool Evaluate(ExpressionType comparison, const type::Value &constant,
+                uint64_t word) const;
+
+  bool IsIntegral() const;
+
+  void EncodeDictionary(const std::vector<uint64_t> &words);
+  void EncodeRunLength(const std::vector<uint64_t> &words);
+  void EncodeFrameOfReference(const std::vector<uint64_t> &words);
+
+ private:
+  type::TypeId value_type_;
+  bool is_inlined_;
+  // Do varlen slots point into a table's StringDictionary?
+  bool interned_;
+  size_t fixed_length_;
+  oid_t tuple_count_;
+  size_t uncompressed_size_;
+
+  ColumnEncodingType encoding_type_;
+
+  // DICTIONARY: distinct words indexed by code, and the per-tuple codes.
+  // For varlen columns the dictionary words point into varlen_data_.
+  std::vector<uint64_t> dictionary_;
+  std::vector<char> varlen_data_;
+  BitPackedArray codes_;
+
+  // RUN_LENGTH: the word of each run and its exclusive end position
+  std::vector<uint64_t> run_words_;
+  std::vector<oid_t> run_ends_;
+
+  // FRAME_OF_REFERENCE: minimum word and per-tuple deltas
+  int64_t base_;
+  BitPackedArray deltas_;
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -58,6 +58,7 @@ namespace storage {
 class Tuple;
 class TileGroup;
 class IndirectionArray;
+class StringDictionary;
 
 //===--------------------------------------------------------------------===//
 // DataTable
@@ -128,6 +129,16 @@ class DataTable : public AbstractTable {
       concurrency::TransactionContext *transaction, ItemPointer **index_entry_ptr,
       bool check_fk = true);
 
+  // insert a batch of tuples in table. slots are claimed as ranges of
+  // consecutive slots, the tuples are copied column by column and every index
+  // receives its keys in sorted order. unlike InsertTuple(), the inserts are
+  // registered with the transaction here, so the caller must not call
+  // PerformInsert() for them. returns false if any tuple violates a
+  // constraint, in which case the transaction has to be aborted.
+  bool InsertTuples(const std::vector<const Tuple *> &tuples,
+                    concurrency::TransactionContext *transaction,
+                    std::vector<ItemPointer> &locations, bool check_fk = true);
+
   //===--------------------------------------------------------------------===//
   // TILE GROUP
   //===--------------------------------------------------------------------===//
@@ -150,6 +161,17 @@ class DataTable : public AbstractTable {
   // Get a tile group with given layout
   TileGroup *GetTileGroupWithLayout(const column_map_type &partitioning);
 
+  //===--------------------------------------------------------------------===//
+  // DICTIONARY ENCODING
+  //===--------------------------------------------------------------------===//
+
+  // Store the values of the given uninlined VARCHAR/VARBINARY column once,
+  // in a table-wide dictionary. Must be called while the table is empty.
+  void EnableDictionaryEncoding(const oid_t &column_id);
+
+  // Returns nullptr if the column is not dictionary-encoded
+  StringDictionary *GetColumnDictionary(const oid_t &column_id) const;
+
   //===--------------------------------------------------------------------===//
   // TRIGGER
   //===--------------------------------------------------------------------===//
@@ -298,6 +320,10 @@ class DataTable : public AbstractTable {
   // Claim a tuple slot in a tile group
   ItemPointer GetEmptyTupleSlot(const storage::Tuple *tuple);
 
+  // Claim slots for the given tuples and copy them in
+  void GetEmptyTupleSlots(const std::vector<const Tuple *> &tuples,
+                          std::vector<ItemPointer> &locations);
+
   hash_t Hash() const;
 
   bool Equals(const storage::DataTable &other) const;
@@ -332,10 +358,21 @@ class DataTable : public AbstractTable {
   // Drop all tile groups of the table. Used by recovery
   void DropTileGroups();
 
+  // Attach the column dictionaries to a newly created tile group
+  void SetColumnDictionaries(TileGroup *tile_group) const;
+
   //===--------------------------------------------------------------------===//
   // INDEX HELPERS
   //===--------------------------------------------------------------------===//
 
+  // allocate the index entry that will point to the given location
+  ItemPointer *AllocateIndexEntry(const ItemPointer &location);
+
+  // insert the keys of a batch of tuples into all indexes, in key order
+  bool InsertInIndexes(const std::vector<const Tuple *> &tuples,
+                       const std::vector<ItemPointer *> &index_entry_ptrs,
+                       concurrency::TransactionContext *transaction);
+
   bool InsertInSecondaryIndexes(const AbstractTuple *tuple,
                                 const TargetList *targets_ptr,
                                 concurrency::TransactionContext *transaction,
@@ -407,6 +444,9 @@ class DataTable : public AbstractTable {
   // dirty flag. for detecting whether the tile group has been used.
   bool dirty_ = false;
 
+  // dictionaries of the dictionary-encoded columns, indexed by column id
+  std::vector<std::shared_ptr<StringDictionary>> column_dictionaries_;
+
   //===--------------------------------------------------------------------===//
   // TUNING MEMBERS
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// string_dictionary.h
+//
+// Identification: src/include/storage/string_dictionary.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "common/synchronization/readwrite_latch.h"
+
+namespace peloton {
+
+namespace type {
+class AbstractPool;
+}  // namespace type
+
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// String Dictionary
+//===--------------------------------------------------------------------===//
+
+/**
+ * An append-only dictionary of the distinct values of a dictionary-encoded
+ * VARCHAR/VARBINARY column.
+ *
+ * Every distinct value is stored exactly once, in the regular varlen format
+ * ([uint32 length][bytes]), and is preceded by its 32-bit code:
+ *
+ *      [uint32 code][uint32 length][bytes ...]
+ *                   ^
+ *                   varlen pointer stored in the tuple slot
+ *
+ * Tuple slots of an encoded column hold the varlen pointer of the entry, so
+ * every reader of uninlined data keeps working unchanged, while code that
+ * knows the column is encoded can read the code right before the varlen. Two
+ * values of the same column are equal iff their codes are equal. Entries are
+ * never removed, so varlen pointers and codes stay valid for the lifetime of
+ * the dictionary.
+ */
+class StringDictionary {
+ public:
+  StringDictionary(const StringDictionary &) = delete;
+  StringDictionary &operator=(const StringDictionary &) = delete;
+
+  explicit StringDictionary(uint32_t max_size = kUnencodedCode);
+
+  // Get the varlen of the entry of the given value, adding it if needed.
+  // Returns nullptr if the value is absent and the dictionary is full.
+  const char *Intern(const char *data, uint32_t length);
+
+  // Get the varlen of the entry of the given value, or nullptr if absent
+  const char *Find(const char *data, uint32_t length) const;
+
+  // Get the varlen of the entry with the given code
+  const char *GetVarlen(uint32_t code) const;
+
+  // Get the code of the entry with the given varlen
+  static inline uint32_t GetCode(const char *varlen) {
+    PL_ASSERT(varlen != nullptr);
+    return *reinterpret_cast<const uint32_t *>(varlen - sizeof(uint32_t));
+  }
+
+  // Store the given value in the pool, in the layout of an entry whose code
+  // is kUnencodedCode. Returns the varlen.
+  static const char *CopyUnencoded(type::AbstractPool *pool, const char *data,
+                                   uint32_t length);
+
+  // Free a varlen returned by CopyUnencoded()
+  static void FreeUnencoded(type::AbstractPool *pool, const char *varlen);
+
+  // Was the given varlen returned by CopyUnencoded()?
+  static inline bool IsUnencoded(const char *varlen) {
+    return GetCode(varlen) == kUnencodedCode;
+  }
+
+  // The number of distinct values
+  uint32_t GetSize() const;
+
+  // The max. number of distinct values
+  uint32_t GetMaxSize() const { return max_size_; }
+
+  // Bytes held by the entries
+  size_t GetMemorySize() const;
+
+  // The byte offset from a varlen's data to its code
+  static constexpr int32_t kCodeOffset =
+      -static_cast<int32_t>(2 * sizeof(uint32_t));
+
+  // The code of values that are not in the dictionary
+  static constexpr uint32_t kUnencodedCode =
+      std::numeric_limits<uint32_t>::max();
+
+ private:
+  struct Key {
+    const char *data;
+    uint32_t length;
+    bool operator==(const Key &other) const;
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key &key) const;
+  };
+
+  // Find the code of the given key. Must hold the latch.
+  const char *FindLocked(const Key &key) const;
+
+  // Allocate room for an entry of the given size
+  char *AllocateEntry(size_t size);
+
+ private:
+  // Entries are carved out of blocks of this size
+  static constexpr size_t kBlockSize = 64 * 1024;
+
+  const uint32_t max_size_;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char *current_block_;
+  size_t block_offset_;
+  size_t memory_size_;
+
+  // The varlen of each entry, indexed by code
+  std::vector<const char *> entries_;
+
+  // Maps a value (pointing into the entry) to the entry's varlen
+  std::unordered_map<Key, const char *, KeyHasher> index_;
+
+  common::synchronization::ReadWriteLatch latch_;
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -18,6 +18,8 @@
 #include "catalog/schema.h"
 #include "common/item_pointer.h"
 #include "common/printable.h"
+#include "storage/compressed_column.h"
+#include "storage/string_dictionary.h"
 #include "type/abstract_pool.h"
 #include "type/serializeio.h"
 #include "type/serializer.h"
@@ -56,10 +58,12 @@ class Tile : public Printable {
   Tile(Tile const &) = delete;
 
  public:
-  // Tile creator
+  // Tile creator. Varlen data is allocated from the given pool, which may be
+  // shared with the other tiles of the tile group, or from a new pool.
   Tile(BackendType backend_type, TileGroupHeader *tile_header,
        const catalog::Schema &tuple_schema, TileGroup *tile_group,
-       int tuple_count);
+       int tuple_count,
+       const std::shared_ptr<type::AbstractPool> &pool = nullptr);
 
   virtual ~Tile();
 
@@ -117,6 +121,68 @@ class Tile : public Printable {
   // Copy current tile in given backend and return new tile
   Tile *CopyTile(BackendType backend_type);
 
+  //===--------------------------------------------------------------------===//
+  // Cold Storage
+  //===--------------------------------------------------------------------===//
+
+  /**
+   * A frozen tile holds one CompressedColumn per column instead of the
+   * fixed-length slot array. Values are still served by GetValue() and
+   * GetValueFast(); code that needs raw slots must go through
+   * GetMaterializedTile().
+   */
+  inline bool IsFrozen() const { return frozen; }
+
+  // Build a frozen copy of this tile. Returns nullptr if some column cannot
+  // be compressed.
+  Tile *Freeze() const;
+
+  // Build an uncompressed, independent copy of this frozen tile
+  Tile *Thaw() const;
+
+  // Returns this tile if it is not frozen, otherwise a lazily built
+  // uncompressed copy that lives as long as this tile (or until released)
+  Tile *GetMaterializedTile();
+
+  // Detach the cached uncompressed copy if it wasn't asked for since the last
+  // call, so that it can be reclaimed once no reader can hold a pointer into
+  // it anymore
+  std::shared_ptr<Tile> ReleaseIdleMaterializedTile();
+
+  inline const CompressedColumn *GetCompressedColumn(
+      const oid_t column_id) const {
+    PL_ASSERT(frozen && column_id < compressed_columns.size());
+    return compressed_columns[column_id].get();
+  }
+
+  // Bytes held by the compressed columns (0 if not frozen)
+  size_t GetCompressedSize() const;
+
+  //===--------------------------------------------------------------------===//
+  // Dictionary Encoding
+  //===--------------------------------------------------------------------===//
+
+  /**
+   * The uninlined slots of a dictionary-encoded column point into a
+   * StringDictionary shared by the whole table instead of into the pool.
+   */
+  void SetColumnDictionary(const oid_t column_id,
+                           const std::shared_ptr<StringDictionary> &dictionary);
+
+  // Returns nullptr if the column is not dictionary-encoded
+  inline StringDictionary *GetColumnDictionary(const oid_t column_id) const {
+    return GetDictionaryAtOffset(schema.GetOffset(column_id));
+  }
+
+  inline bool HasColumnDictionaries() const {
+    return !column_dictionaries.empty();
+  }
+
+  // Re-point the slots of the dictionary-encoded columns of the given tuple,
+  // written through the pool, to their dictionary entries (or to unencoded
+  // copies, once the dictionary is full)
+  void InternVarlenValues(const oid_t tuple_offset);
+
   //===--------------------------------------------------------------------===//
   // Size Stats
   //===--------------------------------------------------------------------===//
@@ -170,7 +236,11 @@ class Tile : public Printable {
   void DeserializeTuplesFromWithoutHeader(SerializeInput &input,
                                           type::AbstractPool *pool = nullptr);
 
-  type::AbstractPool *GetPool() { return (pool); }
+  type::AbstractPool *GetPool() { return (pool.get()); }
+
+  // Return the varlen data of all slots to the pool. Only call this once the
+  // tile is no longer reachable by any transaction.
+  void FreeVarlenValues();
 
   char *GetTupleLocation(const oid_t tuple_offset) const;
 
@@ -178,6 +248,26 @@ class Tile : public Printable {
   void Sync();
 
  protected:
+  // Frozen tile constructor
+  Tile(const Tile &source,
+       std::vector<std::unique_ptr<CompressedColumn>> &&columns);
+
+  inline StringDictionary *GetDictionaryAtOffset(
+      const size_t column_offset) const {
+    return column_dictionaries.empty()
+               ? nullptr
+               : column_dictionaries[column_offset].get();
+  }
+
+  // Store the entry of the given value in the slot, or a copy in the pool if
+  // the dictionary is full
+  void SetDictionaryValue(const type::Value &value, char *field_location,
+                          StringDictionary *dictionary);
+
+  // Decode all slots into a new uncompressed tile. If copy_varlen is false,
+  // varlen slots keep pointing into this tile's compressed dictionaries.
+  Tile *Decompress(bool copy_varlen) const;
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -201,7 +291,7 @@ class Tile : public Printable {
   TileGroup *tile_group;
 
   // storage pool for uninlined data
-  type::AbstractPool *pool;
+  std::shared_ptr<type::AbstractPool> pool;
 
   // number of tuple slots allocated
   oid_t num_tuple_slots;
@@ -228,6 +318,27 @@ class Tile : public Printable {
    * This is maintained by shared Tile Header.
    */
   TileGroupHeader *tile_group_header;
+
+  // Is this a frozen tile ?
+  bool frozen = false;
+
+  // Compressed columns of a frozen tile, indexed by column id
+  std::vector<std::unique_ptr<CompressedColumn>> compressed_columns;
+
+  // Maps a column's byte offset to its id, for GetValueFast on frozen tiles
+  std::vector<oid_t> offset_to_column;
+
+  // Uncompressed copy of a frozen tile, built on demand for raw access
+  std::shared_ptr<Tile> materialized_tile;
+
+  // Was the uncompressed copy asked for since the last release attempt?
+  bool materialized_tile_used = false;
+
+  std::mutex materialized_tile_mutex;
+
+  // Dictionaries of the dictionary-encoded columns, indexed by the column's
+  // byte offset. Empty if no column is encoded.
+  std::vector<std::shared_ptr<StringDictionary>> column_dictionaries;
 };
 
 // Returns a pointer to the tuple requested. No checks are done that the index
@@ -282,9 +393,11 @@ class TileFactory {
                        oid_t table_id, oid_t tile_group_id, oid_t tile_id,
                        TileGroupHeader *tile_header,
                        const catalog::Schema &schema, TileGroup *tile_group,
-                       int tuple_count) {
-    Tile *tile =
-        new Tile(backend_type, tile_header, schema, tile_group, tuple_count);
+                       int tuple_count,
+                       const std::shared_ptr<type::AbstractPool> &pool =
+                           nullptr) {
+    Tile *tile = new Tile(backend_type, tile_header, schema, tile_group,
+                          tuple_count, pool);
 
     TileFactory::InitCommon(tile, database_id, table_id, tile_group_id, tile_id,
                             schema);
@@ -48,6 +48,7 @@ namespace storage {
 
 class Tuple;
 class Tile;
+class StringDictionary;
 class TileGroupHeader;
 class AbstractTable;
 class TileGroupIterator;
@@ -87,9 +88,21 @@ class TileGroup : public Printable {
   // copy tuple in place.
   void CopyTuple(const Tuple *tuple, const oid_t &tuple_slot_id);
 
+  // copy count tuples, starting at tuples[first_tuple], column by column
+  // into the consecutive slots starting at first_slot_id
+  void CopyTuples(const std::vector<const Tuple *> &tuples,
+                  const size_t first_tuple, const oid_t first_slot_id,
+                  const oid_t count);
+
   // insert tuple at next available slot in tile if a slot exists
   oid_t InsertTuple(const Tuple *tuple);
 
+  // claim up to count consecutive slots for tuples[first_tuple, ...] and copy
+  // the tuples into them. returns the first slot and sets count to the number
+  // of tuples inserted, or returns INVALID_OID if the tile group is full.
+  oid_t InsertTuples(const std::vector<const Tuple *> &tuples,
+                     const size_t first_tuple, oid_t &count);
+
   // insert tuple at specific tuple slot
   // used by recovery mode
   oid_t InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
@@ -129,16 +142,71 @@ class TileGroup : public Printable {
 
   unsigned int NumTiles() const { return tiles.size(); }
 
-  // Get the tile at given offset in the tile group
+  // Get the tile at given offset in the tile group. A tile replaced by
+  // Freeze() / Thaw() is retired until its epoch expires, so the pointer
+  // stays valid for the current transaction.
   inline Tile *GetTile(const oid_t tile_offset) const {
     PL_ASSERT(tile_offset < tile_count);
-    Tile *tile = tiles[tile_offset].get();
+    Tile *tile = std::atomic_load(&tiles[tile_offset]).get();
     return tile;
   }
 
   // Get a reference to the tile at the given offset in the tile group
   std::shared_ptr<Tile> GetTileReference(const oid_t tile_offset) const;
 
+  // Store the given column's uninlined values in the given dictionary
+  void SetColumnDictionary(const oid_t column_id,
+                           const std::shared_ptr<StringDictionary> &dictionary);
+
+  // Move the varlen values of the given tuple's dictionary-encoded columns,
+  // written through the tile pools, into their dictionaries
+  void InternVarlenValues(const oid_t tuple_slot_id);
+
+  //===--------------------------------------------------------------------===//
+  // Cold Storage
+  //===--------------------------------------------------------------------===//
+
+  /**
+   * Replace every tile with a frozen (compressed, immutable) copy and mark the
+   * header immutable. Only full tile groups can be frozen. The replaced tiles
+   * are retired and freed by ReclaimRetiredTiles() once no transaction that
+   * could still hold a pointer into them is active.
+   *
+   * Returns false if the tile group is not full, already frozen, was written
+   * since the given epoch or by a transaction that is still running, or some
+   * column cannot be compressed.
+   */
+  bool Freeze(eid_t cold_epoch_id);
+
+  // Replace every frozen tile with an uncompressed copy
+  bool Thaw();
+
+  // Record a write to this tile group and make sure its tiles are writable.
+  // Must be called before tuple data is written into one of its slots.
+  void PrepareForWrite();
+
+  inline bool IsFrozen() const { return frozen; }
+
+  // Remove from positions the tuples for which "column <comparison> constant"
+  // does not hold, evaluating the predicate on the compressed column.
+  // Returns false (and leaves positions untouched) if the column's tile is
+  // not frozen anymore.
+  bool FilterFrozen(oid_t column_id, ExpressionType comparison,
+                    const type::Value &constant,
+                    std::vector<oid_t> &positions) const;
+
+  // Retire the uncompressed copies built for raw access to frozen tiles that
+  // were not used since the last call
+  void ReleaseIdleMaterializedTiles();
+
+  // Free retired tiles that were replaced in an epoch before expired_eid.
+  // Returns the number of tiles freed.
+  size_t ReclaimRetiredTiles(eid_t expired_eid);
+
+  // Compressed and uncompressed footprint of the frozen tiles
+  size_t GetCompressedSize() const;
+  size_t GetUncompressedSize() const;
+
   oid_t GetTileId(const oid_t tile_id) const;
 
   peloton::type::AbstractPool *GetTilePool(const oid_t tile_id) const;
@@ -218,6 +286,16 @@ class TileGroup : public Printable {
 
   std::mutex tile_group_mutex;
 
+  // Are the tiles frozen ?
+  std::atomic<bool> frozen;
+
+  // Tiles replaced by Freeze() / Thaw(), tagged with the epoch they were
+  // replaced in
+  std::vector<std::pair<eid_t, std::shared_ptr<Tile>>> retired_tiles;
+
+  // Pool for the varlen data of all tiles, released with the last tile
+  std::shared_ptr<type::AbstractPool> varlen_pool;
+
   // column to tile mapping :
   // <column offset> to <tile offset, tile column offset>
   column_map_type column_map;
@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
+#include <limits>
 
 #include "common/item_pointer.h"
 #include "common/macros.h"
@@ -83,6 +85,7 @@ class TileGroupHeader : public Printable {
     num_tuple_slots = other.num_tuple_slots;
     oid_t val = other.next_tuple_slot;
     next_tuple_slot = val;
+    all_visible_cid = INVALID_CID;
 
     return *this;
   }
@@ -105,6 +108,26 @@ class TileGroupHeader : public Printable {
     }
   }
 
+  /**
+   * Claim up to count consecutive empty slots with a single atomic operation.
+   * Returns the first claimed slot and sets count to the number of slots
+   * claimed, or returns INVALID_OID if the tile group is full.
+   */
+  oid_t GetNextEmptyTupleSlots(oid_t &count) {
+    if (next_tuple_slot >= num_tuple_slots) {
+      return INVALID_OID;
+    }
+
+    oid_t tuple_slot_id =
+        next_tuple_slot.fetch_add(count, std::memory_order_relaxed);
+
+    if (tuple_slot_id >= num_tuple_slots) {
+      return INVALID_OID;
+    }
+    count = std::min(count, num_tuple_slots - tuple_slot_id);
+    return tuple_slot_id;
+  }
+
   /**
    * Used by logging
    */
@@ -217,22 +240,73 @@ class TileGroupHeader : public Printable {
                                          const txn_id_t &old_txn_id,
                                          const txn_id_t &new_txn_id) const {
     txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_HEADER_LOCATION);
-    return __sync_val_compare_and_swap(txn_id_ptr, old_txn_id, new_txn_id);
+    txn_id_t txn_id =
+        __sync_val_compare_and_swap(txn_id_ptr, old_txn_id, new_txn_id);
+    if (txn_id == old_txn_id) {
+      ResetAllVisible();
+    }
+    return txn_id;
   }
 
   inline bool SetAtomicTransactionId(const oid_t &tuple_slot_id,
                                      const txn_id_t &transaction_id) const {
     txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_HEADER_LOCATION);
-    return __sync_bool_compare_and_swap(txn_id_ptr, INITIAL_TXN_ID,
-                                        transaction_id);
+    bool acquired = __sync_bool_compare_and_swap(txn_id_ptr, INITIAL_TXN_ID,
+                                                 transaction_id);
+    if (acquired) {
+      ResetAllVisible();
+    }
+    return acquired;
+  }
+
+  /*
+  * @brief All-visible watermark. When it is a commit id below
+  * ALL_VISIBLE_TOKEN_BASE other than INVALID_CID, every version of this full
+  * tile group was committed at or before that commit id, and none of them has
+  * been updated or deleted since. Transactions reading at or after the
+  * watermark may then skip the visibility checks of the tile group.
+  *
+  * A version only leaves that state after a transaction took its ownership
+  * through SetAtomicTransactionId(), which resets the watermark.
+  */
+  inline cid_t GetAllVisibleCommitId() const { return all_visible_cid; }
+
+  /*
+  * @brief Start computing the all-visible watermark. While the versions are
+  * checked, the watermark is a token unique to this computation, which no
+  * reader is at or after. Returns false if the watermark is already set or
+  * another thread is computing it.
+  */
+  inline bool BeginAllVisible(cid_t &token) {
+    token = ALL_VISIBLE_TOKEN_BASE + all_visible_computations.fetch_add(1);
+    cid_t expected = INVALID_CID;
+    return all_visible_cid.compare_exchange_strong(expected, token);
   }
 
+  /*
+  * @brief Publish the watermark computed since BeginAllVisible() returned the
+  * token, or INVALID_CID if some version is not visible to everyone. Nothing
+  * is published if a version was written in the meantime, even if another
+  * computation started since.
+  */
+  inline void EndAllVisible(const cid_t token, const cid_t cid) {
+    cid_t expected = token;
+    all_visible_cid.compare_exchange_strong(expected, cid);
+  }
+
+  /*
+  * @brief Compute the all-visible watermark of a full tile group by checking
+  * all its versions. Returns true if the watermark was published.
+  */
+  bool ComputeAllVisible();
+
   /*
   * @brief The following method use Compare and Swap to set the tilegroup's
   immutable flag to be true. 
   */
   inline bool SetImmutability() {
-    return __sync_bool_compare_and_swap(&immutable, false, true);
+    bool expected = false;
+    return immutable.compare_exchange_strong(expected, true);
   }
   
   /*
@@ -240,10 +314,27 @@ class TileGroupHeader : public Printable {
   immutable flag to be false. 
   */
   inline bool ResetImmutability() {
-    return __sync_bool_compare_and_swap(&immutable, true, false);
+    bool expected = true;
+    return immutable.compare_exchange_strong(expected, false);
   }
 
-  inline bool GetImmutability() const { return immutable; }
+  // Sequentially consistent, see TileGroup::PrepareForWrite()
+  inline bool GetImmutability() const { return immutable.load(); }
+
+  /*
+  * @brief Record that a version in this tile group was written in the given
+  * epoch. Used by the tiering tuner to detect cold tile groups. The store is
+  * skipped if a later epoch is already recorded to keep the line clean.
+  */
+  inline void SetLastWriteEpochId(const eid_t epoch_id) {
+    if (last_write_epoch_id.load(std::memory_order_relaxed) < epoch_id) {
+      last_write_epoch_id.store(epoch_id);
+    }
+  }
+
+  inline eid_t GetLastWriteEpochId() const {
+    return last_write_epoch_id.load();
+  }
 
   void PrintVisibility(txn_id_t txn_id, cid_t at_cid);
 
@@ -306,7 +397,27 @@ class TileGroupHeader : public Printable {
 
   // Immmutable Flag. Should be set by the brain to be true.
   // By default it will be set to false.
-  bool immutable;
+  std::atomic<bool> immutable;
+
+  // Epoch of the most recent write to a version in this tile group
+  std::atomic<eid_t> last_write_epoch_id;
+
+  // The all-visible watermark, see GetAllVisibleCommitId()
+  mutable std::atomic<cid_t> all_visible_cid;
+
+  // Number of watermark computations started, to tell their tokens apart
+  std::atomic<uint32_t> all_visible_computations;
+
+  // Watermarks at or above this value are computations in progress
+  static constexpr cid_t ALL_VISIBLE_TOKEN_BASE =
+      MAX_CID - std::numeric_limits<uint32_t>::max();
+
+  // Skip the store when there is no watermark to keep the line clean
+  inline void ResetAllVisible() const {
+    if (all_visible_cid.load() != INVALID_CID) {
+      all_visible_cid.store(INVALID_CID);
+    }
+  }
 };
 
 }  // namespace storage
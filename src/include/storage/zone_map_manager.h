@@ -67,6 +67,11 @@ class ZoneMapManager {
                                       storage::DataTable *table,
                                       int64_t tile_group_id);
 
+  // Can the given column of the tile group hold values in the range [min, max]?
+  bool ShouldScanTileGroupInRange(storage::DataTable *table,
+                                  int64_t tile_group_idx, int32_t col_id,
+                                  int64_t min, int64_t max);
+
   bool ZoneMapTableExists();
 
  private:
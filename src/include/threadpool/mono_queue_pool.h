@@ -70,6 +70,16 @@ class MonoQueuePool {
     return brain_queue_pool;
   }
 
+  static MonoQueuePool &GetOptimizerInstance() {
+    uint32_t task_queue_size = settings::SettingsManager::GetInt(
+        settings::SettingId::optimizer_task_queue_size);
+    uint32_t worker_pool_size = settings::SettingsManager::GetInt(
+        settings::SettingId::optimizer_worker_pool_size);
+    static MonoQueuePool optimizer_queue_pool(task_queue_size,
+                                              worker_pool_size);
+    return optimizer_queue_pool;
+  }
+
  private:
   TaskQueue task_queue_;
   WorkerPool worker_pool_;
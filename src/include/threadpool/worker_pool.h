@@ -35,6 +35,7 @@ class WorkerPool {
         task_queue_(task_queue) {}
 
   void Startup() {
+    should_shutdown_ = false;
     for (size_t i = 0; i < num_workers_; i++) {
       workers_.emplace_back(WorkerFunc, &should_shutdown_, task_queue_);
     }
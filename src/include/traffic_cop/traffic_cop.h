@@ -84,6 +84,12 @@ class TrafficCop {
       std::unique_ptr<parser::SQLStatementList> sql_stmt_list,
       size_t thread_id = 0);
 
+  // Begin a txn for a statement of the given type if none is active. Returns
+  // false if the current multi-statement txn is already aborted, in which
+  // case the statement will not be executed.
+  bool BeginStatement(QueryType query_type, const std::string &query_string,
+                      size_t thread_id = 0);
+
   bool BindParamsForCachePlan(
       const std::vector<std::unique_ptr<expression::AbstractExpression>> &,
       const size_t thread_id = 0);
@@ -145,6 +151,10 @@ class TrafficCop {
     default_database_name_ = std::move(default_database_name);
   }
 
+  const std::string &GetDefaultDatabaseName() const {
+    return default_database_name_;
+  }
+
   // TODO: this member variable should be in statement_ after parser part
   // finished
   std::string query_;
@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// varlen_pool.h
+//
+// Identification: src/include/type/varlen_pool.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/synchronization/spin_latch.h"
+#include "type/abstract_pool.h"
+
+namespace peloton {
+namespace type {
+
+// An arena that hands out varlen blocks from size classes.
+//
+// Blocks of up to kMaxBlockSize bytes (including an 8-byte header recording
+// the owning pool and the size class) are rounded up to a power of two and
+// carved out of large chunks with a lock-free bump pointer. Freed blocks go onto a per-class free
+// list and are handed out again by later allocations of the same class. Since
+// varlen data of tuples is only freed by GC once no transaction can read it,
+// reusing a block right away is safe. Larger blocks are allocated directly.
+// All memory is released at once when the pool is destroyed.
+//
+// Free() checks the header before trusting it. Pointers that were not handed
+// out by this pool, or were freed already, are reported and leaked instead of
+// corrupting the free lists.
+class VarlenPool : public AbstractPool {
+ public:
+  VarlenPool(const VarlenPool &) = delete;
+  VarlenPool &operator=(const VarlenPool &) = delete;
+
+  VarlenPool();
+
+  // Destroy this pool, and all memory it owns.
+  ~VarlenPool();
+
+  // Allocate a contiguous block of memory of the given size
+  void *Allocate(size_t size) override;
+
+  // Returns the provided chunk of memory back into the pool
+  void Free(void *ptr) override;
+
+  // Bytes reserved by the pool (chunks and large blocks)
+  size_t GetMemorySize() const { return memory_size_.load(); }
+
+  // The block size (including the header) used for a request of the given size
+  static size_t GetBlockSize(size_t size);
+
+  // The size of each chunk that small blocks are carved out of
+  static constexpr size_t kChunkSize = 64 * 1024;
+
+  // Blocks larger than this are not pooled
+  static constexpr size_t kMaxBlockSize = 4 * 1024;
+
+ private:
+  struct Chunk {
+    explicit Chunk(size_t size) : data(new char[size]), offset(0) {}
+    std::unique_ptr<char[]> data;
+    std::atomic<size_t> offset;
+  };
+
+  // Precedes every block handed out
+  struct BlockHeader {
+    // owner_tag_ of the pool while the block is in use, 0 once it is freed
+    uint32_t owner_tag;
+    uint32_t size_class;
+  };
+
+  struct FreeList {
+    FreeList() : head(nullptr) {}
+    // Freed blocks, linked through their first word
+    std::atomic<char *> head;
+    common::synchronization::SpinLatch latch;
+  };
+
+  // Set the header of a block that is handed out
+  inline void *InitBlock(char *block, uint32_t size_class) {
+    auto *header = reinterpret_cast<BlockHeader *>(block);
+    header->owner_tag = owner_tag_;
+    header->size_class = size_class;
+    return block + kHeaderSize;
+  }
+
+  // Get the size class of the given block size
+  static uint32_t GetSizeClass(size_t block_size);
+
+  // Try to reuse a freed block of the given size class
+  char *PopFreeBlock(uint32_t size_class);
+
+  // Install a new chunk, unless another thread replaced the given one already
+  void AddChunk(Chunk *full_chunk);
+
+  void *AllocateLarge(size_t size);
+
+ private:
+  static constexpr size_t kHeaderSize = sizeof(BlockHeader);
+  static constexpr size_t kMinBlockSize = 16;
+  static constexpr uint32_t kNumSizeClasses = 9;  // 16B - 4KB
+  static constexpr uint32_t kLargeClass = kNumSizeClasses;
+
+  // The chunk blocks are currently bumped off of
+  std::atomic<Chunk *> current_chunk_;
+
+  // All chunks, guarded by chunk_latch_
+  std::vector<std::unique_ptr<Chunk>> chunks_;
+  common::synchronization::SpinLatch chunk_latch_;
+
+  FreeList free_lists_[kNumSizeClasses];
+
+  // Blocks too large to pool, with their size, guarded by large_latch_
+  std::unordered_map<char *, size_t> large_blocks_;
+  common::synchronization::SpinLatch large_latch_;
+
+  std::atomic<size_t> memory_size_;
+
+  // Tells the blocks of this pool from others
+  const uint32_t owner_tag_;
+};
+
+}  // namespace type
+}  // namespace peloton
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -115,6 +116,9 @@ int stock_min_quantity = 10;
 int stock_max_quantity = 100;
 int stock_dist_count = 10;
 
+// Stock tuples inserted as one batch by the loader
+int stock_batch_size = 1000;
+
 double payment_min_amount = 1.0;
 double payment_max_amount = 5000.0;
 
@@ -1562,12 +1566,14 @@ void LoadItems() {
   std::unique_ptr<executor::ExecutorContext> context(
       new executor::ExecutorContext(txn));
 
+  // All items are inserted as one batch
+  std::vector<std::unique_ptr<storage::Tuple>> item_tuples;
   for (auto item_itr = 0; item_itr < state.item_count; item_itr++) {
-    auto item_tuple = BuildItemTuple(item_itr, pool);
-    planner::InsertPlan node(item_table, std::move(item_tuple));
-    executor::InsertExecutor executor(&node, context.get());
-    executor.Execute();
+    item_tuples.push_back(BuildItemTuple(item_itr, pool));
   }
+  planner::InsertPlan node(item_table, std::move(item_tuples));
+  executor::InsertExecutor executor(&node, context.get());
+  executor.Execute();
 
   txn_manager.CommitTransaction(txn);
 }
@@ -1667,18 +1673,19 @@ void LoadWarehouses(const int &warehouse_from, const int &warehouse_to) {
         }
 
         // ORDER_LINE
+        std::vector<std::unique_ptr<storage::Tuple>> order_line_tuples;
         for (auto order_line_itr = 0; order_line_itr < o_ol_cnt;
              order_line_itr++) {
           int ol_supply_w_id = warehouse_itr;
-          auto order_line_tuple = BuildOrderLineTuple(
+          order_line_tuples.push_back(BuildOrderLineTuple(
               orders_itr, district_itr, warehouse_itr, order_line_itr,
-              ol_supply_w_id, new_order, pool);
-          planner::InsertPlan order_line_node(order_line_table,
-                                              std::move(order_line_tuple));
-          executor::InsertExecutor order_line_executor(&order_line_node,
-                                                       context.get());
-          order_line_executor.Execute();
+              ol_supply_w_id, new_order, pool));
         }
+        planner::InsertPlan order_line_node(order_line_table,
+                                            std::move(order_line_tuples));
+        executor::InsertExecutor order_line_executor(&order_line_node,
+                                                     context.get());
+        order_line_executor.Execute();
 
         txn_manager.CommitTransaction(txn);
       }
@@ -1686,13 +1693,18 @@ void LoadWarehouses(const int &warehouse_from, const int &warehouse_to) {
     }  // END DISTRICTS
 
     // STOCK
-    for (auto stock_itr = 0; stock_itr < state.item_count; stock_itr++) {
+    for (auto stock_from = 0; stock_from < state.item_count;
+         stock_from += stock_batch_size) {
       auto txn = txn_manager.BeginTransaction();
       context.reset(new executor::ExecutorContext(txn));
 
       int s_w_id = warehouse_itr;
-      auto stock_tuple = BuildStockTuple(stock_itr, s_w_id, pool);
-      planner::InsertPlan stock_node(stock_table, std::move(stock_tuple));
+      auto stock_to = std::min(stock_from + stock_batch_size, state.item_count);
+      std::vector<std::unique_ptr<storage::Tuple>> stock_tuples;
+      for (auto stock_itr = stock_from; stock_itr < stock_to; stock_itr++) {
+        stock_tuples.push_back(BuildStockTuple(stock_itr, s_w_id, pool));
+      }
+      planner::InsertPlan stock_node(stock_table, std::move(stock_tuples));
       executor::InsertExecutor stock_executor(&stock_node, context.get());
       stock_executor.Execute();
 
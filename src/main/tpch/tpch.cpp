@@ -31,12 +31,16 @@ void Usage(FILE *out) {
           "   -n --num-runs          :  the number of runs to execute for each query \n"
           "   -s --suffix            :  input file suffix \n"
           "   -d --dict-encode       :  dictionary encode \n"
+          "   -f --freeze            :  compress loaded tile groups into cold storage \n"
+          "   -t --tuple-filters     :  evaluate scan predicates row-at-a-time instead of using SIMD kernels \n"
           "   -q --queries           :  comma-separated list of queries to run (i.g., 1,14 for Q1 and Q14) \n");
 }
 
 static struct option opts[] = {
     {"input-dir", required_argument, NULL, 'i'},
     {"dict-encode", optional_argument, NULL, 'd'},
+    {"freeze", optional_argument, NULL, 'f'},
+    {"tuple-filters", optional_argument, NULL, 't'},
     {"queries", optional_argument, NULL, 'q'},
     {NULL, 0, NULL, 0}};
 
@@ -46,7 +50,7 @@ void ParseArguments(int argc, char **argv, Configuration &config) {
   // Parse args
   while (1) {
     int idx = 0;
-    int c = getopt_long(argc, argv, "hi:n:s:dq:", opts, &idx);
+    int c = getopt_long(argc, argv, "hi:n:s:dftq:", opts, &idx);
 
     if (c == -1) break;
 
@@ -64,6 +68,14 @@ void ParseArguments(int argc, char **argv, Configuration &config) {
         config.dictionary_encode = true;
         break;
       }
+      case 'f': {
+        config.freeze_tables = true;
+        break;
+      }
+      case 't': {
+        config.simd_predicates = false;
+        break;
+      }
       case 'q': {
         char *csv_queries = optarg;
         config.SetRunnableQueries(csv_queries);
@@ -89,6 +101,9 @@ void ParseArguments(int argc, char **argv, Configuration &config) {
   LOG_INFO("Input directory   : '%s'", config.data_dir.c_str());
   LOG_INFO("Dictionary encode : %s",
            config.dictionary_encode ? "true" : "false");
+  LOG_INFO("Freeze tables     : %s", config.freeze_tables ? "true" : "false");
+  LOG_INFO("SIMD predicates   : %s",
+           config.simd_predicates ? "true" : "false");
   for (uint32_t i = 0; i < 22; i++) {
     LOG_INFO("Run query %u : %s", i + 1,
              config.queries_to_run[i] ? "true" : "false");
@@ -14,6 +14,8 @@
 
 #include "benchmark/tpch/tpch_workload.h"
 #include "catalog/catalog.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "storage/tile_group.h"
 
 namespace peloton {
 namespace benchmark {
@@ -373,6 +375,36 @@ void TPCHDatabase::LoadTable(TableId table_id) {
   }
 }
 
+void TPCHDatabase::FreezeTable(TableId table_id) {
+  auto &table = GetTable(table_id);
+
+  Timer<std::ratio<1, 1000>> timer;
+  timer.Start();
+
+  // Everything loaded so far is committed, so it's all cold once we move on
+  // to the next epoch
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  eid_t cold_eid = epoch_manager.GetCurrentEpochId();
+  epoch_manager.SetCurrentEpochId(cold_eid + 1);
+
+  uint32_t num_frozen = 0;
+  size_t uncompressed_size = 0, compressed_size = 0;
+  for (oid_t i = 0; i < table.GetTileGroupCount(); i++) {
+    auto tile_group = table.GetTileGroup(i);
+    if (tile_group->Freeze(cold_eid)) {
+      num_frozen++;
+      uncompressed_size += tile_group->GetUncompressedSize();
+      compressed_size += tile_group->GetCompressedSize();
+    }
+  }
+
+  timer.Stop();
+  LOG_INFO("Froze %u of %lu tile groups of %s: %.2f ms, %.2f MB -> %.2f MB",
+           num_frozen, table.GetTileGroupCount(), table.GetName().c_str(),
+           timer.GetDuration(), uncompressed_size / (1024.0 * 1024.0),
+           compressed_size / (1024.0 * 1024.0));
+}
+
 void TPCHDatabase::LoadPartTable() {
   if (TableIsLoaded(TableId::Part)) {
     return;
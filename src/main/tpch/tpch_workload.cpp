@@ -18,6 +18,7 @@
 #include "planner/abstract_plan.h"
 #include "planner/binding_context.h"
 #include "codegen/counting_consumer.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace benchmark {
@@ -153,6 +154,9 @@ void TPCHBenchmark::RunQuery(const TPCHBenchmark::QueryConfig &query_config) {
   // Load all the necessary tables
   for (auto tid : query_config.required_tables) {
     db_.LoadTable(tid);
+    if (config_.freeze_tables) {
+      db_.FreezeTable(tid);
+    }
   }
 
   // Construct the plan for Q1
@@ -166,6 +170,8 @@ void TPCHBenchmark::RunQuery(const TPCHBenchmark::QueryConfig &query_config) {
   codegen::CountingConsumer counter;
 
   // Compile
+  settings::SettingsManager::SetBool(
+      settings::SettingId::codegen_simd_predicates, config_.simd_predicates);
   codegen::QueryCompiler::CompileStats compile_stats;
   codegen::QueryCompiler compiler;
   auto compiled_query = compiler.Compile(*plan, counter, &compile_stats);
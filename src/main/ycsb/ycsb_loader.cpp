@@ -48,6 +48,9 @@ storage::Database *ycsb_database = nullptr;
 
 storage::DataTable *user_table = nullptr;
 
+// Number of rows inserted as one batch by the loader
+const size_t load_batch_size = 1000;
+
 void CreateYCSBDatabase() {
   const oid_t col_count = state.column_count + 1;
   const bool is_inlined = false;
@@ -142,6 +145,7 @@ void LoadYCSBRows(const int begin_rowid, const int end_rowid) {
   std::unique_ptr<executor::ExecutorContext> context(
       new executor::ExecutorContext(txn));
 
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
   for (int rowid = begin_rowid; rowid < end_rowid; rowid++) {
     std::unique_ptr<storage::Tuple> tuple(
         new storage::Tuple(table_schema, allocate));
@@ -162,9 +166,14 @@ void LoadYCSBRows(const int begin_rowid, const int end_rowid) {
       }
     }
 
-    planner::InsertPlan node(user_table, std::move(tuple));
-    executor::InsertExecutor executor(&node, context.get());
-    executor.Execute();
+    // Insert the rows in batches
+    tuples.push_back(std::move(tuple));
+    if (tuples.size() == load_batch_size || rowid == end_rowid - 1) {
+      planner::InsertPlan node(user_table, std::move(tuples));
+      executor::InsertExecutor executor(&node, context.get());
+      executor.Execute();
+      tuples.clear();
+    }
   }
 
   txn_manager.CommitTransaction(txn);
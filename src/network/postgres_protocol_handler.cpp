@@ -17,6 +17,7 @@
 #include "common/cache.h"
 #include "common/internal_types.h"
 #include "common/macros.h"
+#include "common/plan_cache.h"
 #include "common/portal.h"
 #include "expression/expression_util.h"
 #include "network/marshal.h"
@@ -218,6 +219,16 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(
   std::string error_message;
   PacketGetString(pkt, pkt->len, query);
   LOG_TRACE("Execute query: %s", query.c_str());
+
+  // Queries of a known shape skip parsing and planning
+  if (settings::SettingsManager::GetBool(settings::SettingId::plan_cache)) {
+    std::string normalized_query;
+    std::vector<type::Value> param_values;
+    if (PlanCache::NormalizeQuery(query, normalized_query, param_values)) {
+      return ExecCachedQueryMessage(normalized_query, param_values, thread_id);
+    }
+  }
+
   std::unique_ptr<parser::SQLStatementList> sql_stmt_list;
   try {
     auto &peloton_parser = parser::PostgresParser::GetInstance();
@@ -351,7 +362,73 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(
   }
 }
 
+ProcessResult PostgresProtocolHandler::ExecCachedQueryMessage(
+    const std::string &normalized_query,
+    std::vector<type::Value> &param_values, const size_t thread_id) {
+  protocol_type_ = NetworkProtocolType::POSTGRES_PSQL;
+  auto &plan_cache = PlanCache::GetInstance();
+  auto statement = plan_cache.Acquire(traffic_cop_->GetDefaultDatabaseName(),
+                                      normalized_query);
+
+  if (statement.get() != nullptr) {
+    traffic_cop_->BeginStatement(statement->GetQueryType(), normalized_query,
+                                 thread_id);
+  } else {
+    // Prepare the parameterized query, as for a PARSE message
+    std::unique_ptr<parser::SQLStatementList> sql_stmt_list;
+    try {
+      auto &peloton_parser = parser::PostgresParser::GetInstance();
+      sql_stmt_list = peloton_parser.BuildParseTree(normalized_query);
+      if (sql_stmt_list.get() == nullptr || !sql_stmt_list->is_valid ||
+          sql_stmt_list->GetNumStatements() != 1) {
+        throw ParserException("Error Parsing SQL statement");
+      }
+    } catch (Exception &e) {
+      traffic_cop_->ProcessInvalidStatement();
+      SendErrorResponse({{NetworkMessageType::HUMAN_READABLE_ERROR, e.what()}});
+      SendReadyForQuery(NetworkTransactionStateType::IDLE);
+      return ProcessResult::COMPLETE;
+    }
+
+    statement = traffic_cop_->PrepareStatement("unamed", normalized_query,
+                                               std::move(sql_stmt_list));
+    if (statement.get() == nullptr) {
+      SendErrorResponse({{NetworkMessageType::HUMAN_READABLE_ERROR,
+                          traffic_cop_->GetErrorMessage()}});
+      SendReadyForQuery(NetworkTransactionStateType::IDLE);
+      return ProcessResult::COMPLETE;
+    }
+  }
+
+  // Bind the lifted literals into the plan
+  if (!param_values.empty() && statement->GetPlanTree().get() != nullptr) {
+    statement->GetPlanTree()->SetParameterValues(&param_values);
+  }
+  plan_cache_statement_ = statement;
+  traffic_cop_->SetStatement(statement);
+  traffic_cop_->SetParamVal(param_values);
+
+  bool unnamed = false;
+  result_format_ = std::vector<int>(
+      traffic_cop_->GetStatement()->GetTupleDescriptor().size(), 0);
+  auto status = traffic_cop_->ExecuteStatement(
+      traffic_cop_->GetStatement(), traffic_cop_->GetParamVal(), unnamed,
+      nullptr, result_format_, traffic_cop_->GetResult(), thread_id);
+  if (traffic_cop_->GetQueuing()) {
+    return ProcessResult::PROCESSING;
+  }
+  ExecQueryMessageGetResult(status);
+  return ProcessResult::COMPLETE;
+}
+
 void PostgresProtocolHandler::ExecQueryMessageGetResult(ResultType status) {
+  // The plan is no longer used by this connection
+  if (plan_cache_statement_.get() != nullptr) {
+    PlanCache::GetInstance().Release(traffic_cop_->GetDefaultDatabaseName(),
+                                     plan_cache_statement_);
+    plan_cache_statement_.reset();
+  }
+
   std::vector<FieldInfo> tuple_descriptor;
   if (status == ResultType::SUCCESS) {
     tuple_descriptor = traffic_cop_->GetStatement()->GetTupleDescriptor();
@@ -1251,6 +1328,7 @@ void PostgresProtocolHandler::Reset() {
   skipped_stmt_ = false;
   skipped_query_string_.clear();
   portals_.clear();
+  plan_cache_statement_.reset();
 }
 
 }  // namespace network
@@ -69,8 +69,10 @@ void ChildPropertyDeriver::Visit(const PhysicalIndexScan *op) {
         }
       }
       if (!can_fulfill) break;
-      for (auto &index : target_table->GetIndexObjects()) {
-        auto key_oids = index.second->GetKeyAttrs();
+      // Only the index that is scanned provides its order
+      auto index = target_table->GetIndexObject(op->index_id);
+      if (index != nullptr) {
+        auto key_oids = index->GetKeyAttrs();
         // If the sort column size is larger, then can't be fulfill by the index
         if (sort_col_size > key_oids.size()) {
           break;
@@ -157,6 +159,33 @@ void ChildPropertyDeriver::Visit(const PhysicalInnerHashJoin *) {
 void ChildPropertyDeriver::Visit(const PhysicalLeftHashJoin *) {}
 void ChildPropertyDeriver::Visit(const PhysicalRightHashJoin *) {}
 void ChildPropertyDeriver::Visit(const PhysicalOuterHashJoin *) {}
+void ChildPropertyDeriver::Visit(const PhysicalInnerIndexNLJoin *) {
+  // The output is grouped by the inner tile groups, so the order of the outer
+  // child is not kept
+  output_.push_back(make_pair(
+      make_shared<PropertySet>(),
+      vector<shared_ptr<PropertySet>>(1, make_shared<PropertySet>())));
+}
+void ChildPropertyDeriver::Visit(const PhysicalInnerMergeJoin *op) {
+  // Each child must be sorted ascending on its join keys
+  vector<expression::AbstractExpression *> left_cols;
+  vector<expression::AbstractExpression *> right_cols;
+  for (auto &key : op->left_keys) left_cols.push_back(key.get());
+  for (auto &key : op->right_keys) right_cols.push_back(key.get());
+  shared_ptr<Property> left_sort(
+      new PropertySort(left_cols, vector<bool>(left_cols.size(), true)));
+  shared_ptr<Property> right_sort(
+      new PropertySort(right_cols, vector<bool>(right_cols.size(), true)));
+
+  // The output comes in the order of the keys, which is the order of both the
+  // left and the right keys
+  output_.push_back(make_pair(
+      make_shared<PropertySet>(vector<shared_ptr<Property>>{left_sort,
+                                                            right_sort}),
+      vector<shared_ptr<PropertySet>>{
+          make_shared<PropertySet>(vector<shared_ptr<Property>>{left_sort}),
+          make_shared<PropertySet>(vector<shared_ptr<Property>>{right_sort})}));
+}
 void ChildPropertyDeriver::Visit(const PhysicalInsert *) {
   vector<shared_ptr<PropertySet>> child_input_properties;
 
@@ -48,9 +48,16 @@ void ChildStatsDeriver::Visit(UNUSED_ATTRIBUTE const LogicalLeftJoin *) {}
 void ChildStatsDeriver::Visit(UNUSED_ATTRIBUTE const LogicalRightJoin *) {}
 void ChildStatsDeriver::Visit(UNUSED_ATTRIBUTE const LogicalOuterJoin *) {}
 void ChildStatsDeriver::Visit(const LogicalSemiJoin *) {}
-// TODO(boweic): support stats of aggregation
-void ChildStatsDeriver::Visit(const LogicalAggregateAndGroupBy *) {
+void ChildStatsDeriver::Visit(const LogicalAggregateAndGroupBy *op) {
   PassDownRequiredCols();
+  // The distinct counts of the group by columns bound the number of groups
+  for (auto &column : op->columns) {
+    ExprSet expr_set;
+    expression::ExpressionUtil::GetTupleValueExprs(expr_set, column.get());
+    for (auto &col : expr_set) {
+      PassDownColumn(col);
+    }
+  }
 }
 
 void ChildStatsDeriver::PassDownRequiredCols() {
@@ -67,7 +74,7 @@ void ChildStatsDeriver::PassDownColumn(expression::AbstractExpression *col) {
     auto child_group = memo_->GetGroupByID(gexpr_->GetChildGroupId(idx));
     if (child_group->GetTableAliases().count(tv_expr->GetTableName()) &&
         // If we have not derived the column stats yet
-        child_group->HasColumnStats(tv_expr->GetColFullName())) {
+        !child_group->HasColumnStats(tv_expr->GetColFullName())) {
       output_[idx].insert(col);
       break;
     }
@@ -12,6 +12,7 @@
 
 #include "optimizer/cost_calculator.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "catalog/table_catalog.h"
@@ -52,10 +53,12 @@ void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalIndexScan *op) {
     output_cost_ = 0.f;
     return;
   }
-  // Index search cost + scan cost
+  // Index search cost + scan cost. Unlike a seq scan, every matching tuple is
+  // fetched through its index entry.
   output_cost_ = std::log2(table_stats->num_rows) * DEFAULT_INDEX_TUPLE_COST +
                  memo_->GetGroupByID(gexpr_->GetGroupID())->GetNumRows() *
-                     DEFAULT_TUPLE_COST;
+                     (DEFAULT_INDEX_TUPLE_COST + DEFAULT_RANDOM_ACCESS_COST +
+                      DEFAULT_TUPLE_COST);
 }
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const QueryDerivedScan *op) {
   output_cost_ = 0.f;
@@ -76,7 +79,10 @@ void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInnerNLJoin *op) {
   auto right_child_rows =
       memo_->GetGroupByID(gexpr_->GetChildGroupId(1))->GetNumRows();
 
-  output_cost_ = left_child_rows * right_child_rows * DEFAULT_TUPLE_COST;
+  // The inner (right) side is buffered and compared with every outer row
+  output_cost_ = right_child_rows * DEFAULT_MEMORY_TUPLE_COST +
+                 left_child_rows * right_child_rows * DEFAULT_TUPLE_COST +
+                 OutputCost();
 }
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalLeftNLJoin *op) {}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalRightNLJoin *op) {}
@@ -86,12 +92,48 @@ void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInnerHashJoin *op) {
       memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
   auto right_child_rows =
       memo_->GetGroupByID(gexpr_->GetChildGroupId(1))->GetNumRows();
-  // TODO(boweic): Build (left) table should have different cost to probe table
-  output_cost_ = (left_child_rows + right_child_rows) * DEFAULT_TUPLE_COST;
+  // The hash table is built on the left child and probed by the right one.
+  // Building also materializes the rows, so the smaller input should be on
+  // the left.
+  output_cost_ =
+      left_child_rows * (DEFAULT_TUPLE_COST + DEFAULT_MEMORY_TUPLE_COST) +
+      right_child_rows * (DEFAULT_TUPLE_COST + DEFAULT_OPERATOR_COST) +
+      OutputCost();
 }
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalLeftHashJoin *op) {}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalRightHashJoin *op) {}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalOuterHashJoin *op) {}
+void CostCalculator::Visit(const PhysicalInnerIndexNLJoin *op) {
+  auto left_child_rows =
+      memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
+  auto table_stats = std::dynamic_pointer_cast<TableStats>(
+      StatsStorage::GetInstance()->GetTableStats(op->table_->GetDatabaseOid(),
+                                                 op->table_->GetTableOid()));
+  // Without stats of the inner table, count a single index lookup per probe
+  double search_cost = DEFAULT_INDEX_TUPLE_COST;
+  if (table_stats->GetColumnCount() != 0 && table_stats->num_rows > 1) {
+    search_cost *= std::log2(table_stats->num_rows);
+  }
+  // One index search per outer row, and every match is fetched through its
+  // index entry
+  output_cost_ = left_child_rows * search_cost +
+                 memo_->GetGroupByID(gexpr_->GetGroupID())->GetNumRows() *
+                     (DEFAULT_RANDOM_ACCESS_COST + DEFAULT_TUPLE_COST) +
+                 OutputCost();
+}
+void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInnerMergeJoin *op) {
+  auto left_child_rows =
+      memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
+  auto right_child_rows =
+      memo_->GetGroupByID(gexpr_->GetChildGroupId(1))->GetNumRows();
+  // Both inputs arrive sorted and are merged in a single pass, buffering the
+  // left rows. Unlike a hash join, no row is hashed. The sort of an input
+  // that is not already ordered (e.g. by an index) is costed by the sort
+  // enforced on the child.
+  output_cost_ =
+      left_child_rows * (DEFAULT_TUPLE_COST + DEFAULT_MEMORY_TUPLE_COST) +
+      right_child_rows * DEFAULT_TUPLE_COST + OutputCost();
+}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInsert *op) {}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalInsertSelect *op) {}
 void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalDelete *op) {}
@@ -119,8 +161,10 @@ void CostCalculator::Visit(UNUSED_ATTRIBUTE const PhysicalAggregate *op) {
 double CostCalculator::HashCost() {
   auto child_num_rows =
       memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows();
-  // O(tuple)
-  return child_num_rows * DEFAULT_TUPLE_COST;
+  // O(tuple), plus one hash table entry per output row (i.e. per group)
+  return child_num_rows * DEFAULT_TUPLE_COST +
+         memo_->GetGroupByID(gexpr_->GetGroupID())->GetNumRows() *
+             DEFAULT_MEMORY_TUPLE_COST;
 }
 
 double CostCalculator::SortCost() {
@@ -140,5 +184,10 @@ double CostCalculator::GroupByCost() {
   // O(tuple)
   return child_num_rows * DEFAULT_TUPLE_COST;
 }
+
+double CostCalculator::OutputCost() {
+  auto num_rows = memo_->GetGroupByID(gexpr_->GetGroupID())->GetNumRows();
+  return std::max(num_rows, 0) * DEFAULT_TUPLE_COST;
+}
 }  // namespace optimizer
 }  // namespace peloton
@@ -21,20 +21,38 @@ namespace optimizer {
 // Group
 //===--------------------------------------------------------------------===//
 Group::Group(GroupID id, std::unordered_set<std::string> table_aliases)
-    : id_(id), table_aliases_(std::move(table_aliases)) {
-  has_explored_ = false;
-}
+    : id_(id),
+      table_aliases_(std::move(table_aliases)),
+      exploration_state_(ExplorationState::UNEXPLORED) {}
 
 void Group::AddExpression(std::shared_ptr<GroupExpression> expr,
                           bool enforced) {
   // Do duplicate detection
   expr->SetGroupID(id_);
+  latch_.Lock();
   if (enforced)
     enforced_exprs_.push_back(expr);
   else if (expr->Op().IsPhysical())
     physical_expressions_.push_back(expr);
   else
     logical_expressions_.push_back(expr);
+  latch_.Unlock();
+}
+
+const std::vector<std::shared_ptr<GroupExpression>>
+Group::GetLogicalExpressions() const {
+  latch_.Lock();
+  auto exprs = logical_expressions_;
+  latch_.Unlock();
+  return exprs;
+}
+
+const std::vector<std::shared_ptr<GroupExpression>>
+Group::GetPhysicalExpressions() const {
+  latch_.Lock();
+  auto exprs = physical_expressions_;
+  latch_.Unlock();
+  return exprs;
 }
 
 bool Group::SetExpressionCost(GroupExpression *expr, double cost,
@@ -63,20 +81,29 @@ GroupExpression *Group::GetBestExpression(
 }
 
 std::shared_ptr<ColumnStats> Group::GetStats(std::string column_name) {
-  if (!stats_.count(column_name)) {
-    return nullptr;
+  std::shared_ptr<ColumnStats> stats;
+  latch_.Lock();
+  auto it = stats_.find(column_name);
+  if (it != stats_.end()) {
+    stats = it->second;
   }
-  return stats_[column_name];
+  latch_.Unlock();
+  return stats;
 }
 
 void Group::AddStats(std::string column_name,
                      std::shared_ptr<ColumnStats> stats) {
   PL_ASSERT((size_t)GetNumRows() == stats->num_rows);
+  latch_.Lock();
   stats_[column_name] = stats;
+  latch_.Unlock();
 }
 
 bool Group::HasColumnStats(std::string column_name) {
-  return stats_.count(column_name);
+  latch_.Lock();
+  bool has_stats = stats_.count(column_name);
+  latch_.Unlock();
+  return has_stats;
 }
 
 }  // namespace optimizer
@@ -143,6 +143,51 @@ void InputColumnDeriver::Visit(const PhysicalRightHashJoin *) {}
 
 void InputColumnDeriver::Visit(const PhysicalOuterHashJoin *) {}
 
+void InputColumnDeriver::Visit(const PhysicalInnerMergeJoin *op) {
+  JoinHelper(op);
+}
+
+void InputColumnDeriver::Visit(const PhysicalInnerIndexNLJoin *op) {
+  ExprSet input_cols_set;
+  for (auto &left_key : op->left_keys) {
+    expression::ExpressionUtil::GetTupleValueExprs(input_cols_set,
+                                                   left_key.get());
+  }
+  for (auto &join_cond : op->join_predicates) {
+    expression::ExpressionUtil::GetTupleValueExprs(input_cols_set,
+                                                   join_cond.expr.get());
+  }
+  ExprMap output_cols_map;
+  for (auto expr : required_cols_) {
+    expression::ExpressionUtil::GetTupleValueExprs(output_cols_map, expr);
+  }
+  for (auto &expr_idx_pair : output_cols_map) {
+    input_cols_set.insert(expr_idx_pair.first);
+  }
+
+  // Only the outer columns come from the child, the inner ones are fetched
+  // through the index
+  auto &outer_table_aliases =
+      memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetTableAliases();
+  vector<AbstractExpression *> outer_cols;
+  for (auto &col : input_cols_set) {
+    PL_ASSERT(col->GetExpressionType() == ExpressionType::VALUE_TUPLE);
+    auto tv_expr = reinterpret_cast<expression::TupleValueExpression *>(col);
+    if (outer_table_aliases.count(tv_expr->GetTableName())) {
+      outer_cols.push_back(col);
+    } else {
+      PL_ASSERT(tv_expr->GetTableName() == op->table_alias);
+    }
+  }
+  vector<AbstractExpression *> output_cols(output_cols_map.size(), nullptr);
+  for (auto &expr_idx_pair : output_cols_map) {
+    output_cols[expr_idx_pair.second] = expr_idx_pair.first;
+  }
+  output_input_cols_ =
+      pair<vector<AbstractExpression *>, vector<vector<AbstractExpression *>>>{
+          output_cols, {outer_cols}};
+}
+
 void InputColumnDeriver::Visit(const PhysicalInsert *) {
   output_input_cols_ =
       pair<vector<AbstractExpression *>, vector<vector<AbstractExpression *>>>{
@@ -235,6 +280,11 @@ void InputColumnDeriver::JoinHelper(const BaseOperatorNode *op) {
     join_conds = &(join_op->join_predicates);
     left_keys = &(join_op->left_keys);
     right_keys = &(join_op->right_keys);
+  } else if (op->type() == OpType::InnerMergeJoin) {
+    auto join_op = reinterpret_cast<const PhysicalInnerMergeJoin *>(op);
+    join_conds = &(join_op->join_predicates);
+    left_keys = &(join_op->left_keys);
+    right_keys = &(join_op->right_keys);
   } else if (op->type() == OpType::InnerNLJoin) {
     auto join_op = reinterpret_cast<const PhysicalInnerNLJoin *>(op);
     join_conds = &(join_op->join_predicates);
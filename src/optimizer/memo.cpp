@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "optimizer/group_expression.h"
 #include "optimizer/memo.h"
 #include "optimizer/operators.h"
@@ -21,7 +23,16 @@ namespace optimizer {
 //===--------------------------------------------------------------------===//
 // Memo
 //===--------------------------------------------------------------------===//
-Memo::Memo() {}
+Memo::Memo() : index_join_groups_(false) {}
+
+Memo &Memo::operator=(Memo &&other) {
+  group_expressions_ = std::move(other.group_expressions_);
+  groups_ = std::move(other.groups_);
+  join_groups_ = std::move(other.join_groups_);
+  index_join_groups_ = other.index_join_groups_;
+  rule_set_size_ = other.rule_set_size_;
+  return *this;
+}
 
 GroupExpression *Memo::InsertExpression(std::shared_ptr<GroupExpression> gexpr,
                                         bool enforced) {
@@ -39,6 +50,7 @@ GroupExpression *Memo::InsertExpression(std::shared_ptr<GroupExpression> gexpr,
     return nullptr;
   }
 
+  latch_.WriteLock();
   // Lookup in hash table
   auto it = group_expressions_.find(gexpr.get());
 
@@ -46,19 +58,29 @@ GroupExpression *Memo::InsertExpression(std::shared_ptr<GroupExpression> gexpr,
     assert(target_group == UNDEFINED_GROUP ||
            target_group == (*it)->GetGroupID());
     gexpr->SetGroupID((*it)->GetGroupID());
-    return *it;
+    auto existing_gexpr = *it;
+    latch_.Unlock();
+    return existing_gexpr;
   } else {
     group_expressions_.insert(gexpr.get());
     // New expression, so try to insert into an existing group or
     // create a new group if none specified
-    GroupID group_id;
-    if (target_group == UNDEFINED_GROUP) {
+    GroupID group_id = target_group;
+    if (index_join_groups_ && gexpr->Op().type() == OpType::InnerJoin) {
+      auto join_inputs = GetJoinInputs(gexpr.get());
+      auto join_group = join_groups_.find(join_inputs);
+      if (group_id == UNDEFINED_GROUP && join_group != join_groups_.end()) {
+        group_id = join_group->second;
+      }
+      if (group_id == UNDEFINED_GROUP) {
+        group_id = AddNewGroup(gexpr);
+      }
+      join_groups_.emplace(std::move(join_inputs), group_id);
+    } else if (group_id == UNDEFINED_GROUP) {
       group_id = AddNewGroup(gexpr);
-    } else {
-      group_id = target_group;
     }
-    Group *group = GetGroupByID(group_id);
-    group->AddExpression(gexpr, enforced);
+    GetGroup(group_id)->AddExpression(gexpr, enforced);
+    latch_.Unlock();
     return gexpr.get();
   }
 }
@@ -67,7 +89,12 @@ const std::vector<std::unique_ptr<Group>> &Memo::Groups() const {
   return groups_;
 }
 
-Group *Memo::GetGroupByID(GroupID id) { return groups_[id].get(); }
+Group *Memo::GetGroupByID(GroupID id) {
+  latch_.ReadLock();
+  auto group = GetGroup(id);
+  latch_.Unlock();
+  return group;
+}
 
 GroupID Memo::AddNewGroup(std::shared_ptr<GroupExpression> gexpr) {
   GroupID new_group_id = groups_.size();
@@ -85,7 +112,7 @@ GroupID Memo::AddNewGroup(std::shared_ptr<GroupExpression> gexpr) {
   } else {
     // For other groups, need to aggregate the table alias from children
     for (auto child_group_id : gexpr->GetChildGroupIDs()) {
-      Group *child_group = GetGroupByID(child_group_id);
+      Group *child_group = GetGroup(child_group_id);
       for (auto &table_alias : child_group->GetTableAliases()) {
         table_aliases.insert(table_alias);
       }
@@ -97,5 +124,43 @@ GroupID Memo::AddNewGroup(std::shared_ptr<GroupExpression> gexpr) {
   return new_group_id;
 }
 
+void Memo::IndexJoinGroups(GroupID root_group_id) {
+  join_groups_.clear();
+  std::vector<GroupID> group_ids{root_group_id};
+  while (!group_ids.empty()) {
+    auto group_id = group_ids.back();
+    group_ids.pop_back();
+    auto exprs = GetGroupByID(group_id)->GetLogicalExpressions();
+    if (exprs.empty()) continue;
+    if (exprs[0]->Op().type() == OpType::InnerJoin) {
+      join_groups_.emplace(GetJoinInputs(exprs[0].get()), group_id);
+    }
+    for (auto child_group_id : exprs[0]->GetChildGroupIDs()) {
+      group_ids.push_back(child_group_id);
+    }
+  }
+  index_join_groups_ = true;
+}
+
+std::vector<GroupID> Memo::GetJoinInputs(GroupExpression *gexpr) {
+  std::vector<GroupID> join_inputs;
+  if (gexpr->Op().type() != OpType::InnerJoin) {
+    return join_inputs;
+  }
+  for (auto child_group_id : gexpr->GetChildGroupIDs()) {
+    auto child_exprs = GetGroup(child_group_id)->GetLogicalExpressions();
+    if (!child_exprs.empty() &&
+        child_exprs[0]->Op().type() == OpType::InnerJoin) {
+      auto child_inputs = GetJoinInputs(child_exprs[0].get());
+      join_inputs.insert(join_inputs.end(), child_inputs.begin(),
+                         child_inputs.end());
+    } else {
+      join_inputs.push_back(child_group_id);
+    }
+  }
+  std::sort(join_inputs.begin(), join_inputs.end());
+  return join_inputs;
+}
+
 }  // namespace optimizer
 }  // namespace peloton
@@ -245,18 +245,27 @@ Operator LogicalInnerJoin::make(std::vector<AnnotatedExpression> &conditions) {
 
 hash_t LogicalInnerJoin::Hash() const {
   hash_t hash = BaseOperatorNode::Hash();
-  for (auto &pred : join_predicates)
-    hash = HashUtil::CombineHashes(hash, pred.expr->Hash());
-  return hash;
+  // Join reordering may produce the same predicates in another order, so the
+  // hash does not depend on it
+  hash_t predicates_hash = 0;
+  for (auto &pred : join_predicates) predicates_hash += pred.expr->Hash();
+  return HashUtil::CombineHashes(hash, predicates_hash);
 }
 
 bool LogicalInnerJoin::operator==(const BaseOperatorNode &r) {
   if (r.type() != OpType::InnerJoin) return false;
   const LogicalInnerJoin &node = *static_cast<const LogicalInnerJoin *>(&r);
   if (join_predicates.size() != node.join_predicates.size()) return false;
-  for (size_t i = 0; i < join_predicates.size(); i++) {
-    if (!join_predicates[i].expr->ExactlyEquals(*node.join_predicates[i].expr.get()))
-      return false;
+  // Compare the predicates as sets
+  for (auto &pred : join_predicates) {
+    bool found = false;
+    for (auto &other_pred : node.join_predicates) {
+      if (pred.expr->ExactlyEquals(*other_pred.expr.get())) {
+        found = true;
+        break;
+      }
+    }
+    if (!found) return false;
   }
   return true;
 }
@@ -667,6 +676,53 @@ bool PhysicalInnerHashJoin::operator==(const BaseOperatorNode &r) {
   return true;
 }
 
+//===--------------------------------------------------------------------===//
+// InnerMergeJoin
+//===--------------------------------------------------------------------===//
+Operator PhysicalInnerMergeJoin::make(
+    std::vector<AnnotatedExpression> conditions,
+    std::vector<std::unique_ptr<expression::AbstractExpression>>& left_keys,
+    std::vector<std::unique_ptr<expression::AbstractExpression>>& right_keys) {
+  PhysicalInnerMergeJoin *join = new PhysicalInnerMergeJoin();
+  join->join_predicates = std::move(conditions);
+  join->left_keys = std::move(left_keys);
+  join->right_keys = std::move(right_keys);
+  return Operator(join);
+}
+
+hash_t PhysicalInnerMergeJoin::Hash() const {
+  hash_t hash = BaseOperatorNode::Hash();
+  for (auto &expr : left_keys)
+    hash = HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &expr : right_keys)
+    hash = HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &pred : join_predicates)
+    hash = HashUtil::CombineHashes(hash, pred.expr->Hash());
+  return hash;
+}
+
+bool PhysicalInnerMergeJoin::operator==(const BaseOperatorNode &r) {
+  if (r.type() != OpType::InnerMergeJoin) return false;
+  const PhysicalInnerMergeJoin &node =
+      *static_cast<const PhysicalInnerMergeJoin *>(&r);
+  if (join_predicates.size() != node.join_predicates.size() ||
+      left_keys.size() != node.left_keys.size() ||
+      right_keys.size() != node.right_keys.size())
+    return false;
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    if (!left_keys[i]->ExactlyEquals(*node.left_keys[i].get())) return false;
+  }
+  for (size_t i = 0; i < right_keys.size(); i++) {
+    if (!right_keys[i]->ExactlyEquals(*node.right_keys[i].get())) return false;
+  }
+  for (size_t i = 0; i < join_predicates.size(); i++) {
+    if (!join_predicates[i].expr->
+        ExactlyEquals(*node.join_predicates[i].expr.get()))
+      return false;
+  }
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // LeftHashJoin
 //===--------------------------------------------------------------------===//
@@ -697,6 +753,64 @@ Operator PhysicalOuterHashJoin::make(
   return Operator(join);
 }
 
+//===--------------------------------------------------------------------===//
+// InnerIndexNLJoin
+//===--------------------------------------------------------------------===//
+Operator PhysicalInnerIndexNLJoin::make(
+    std::vector<AnnotatedExpression> conditions,
+    std::vector<std::unique_ptr<expression::AbstractExpression>> &left_keys,
+    oid_t get_id, std::shared_ptr<catalog::TableCatalogObject> table,
+    std::string alias, std::vector<AnnotatedExpression> predicates,
+    bool update, oid_t index_id) {
+  PhysicalInnerIndexNLJoin *join = new PhysicalInnerIndexNLJoin();
+  join->join_predicates = std::move(conditions);
+  join->left_keys = std::move(left_keys);
+  join->get_id = get_id;
+  join->table_ = table;
+  join->table_alias = alias;
+  join->predicates = std::move(predicates);
+  join->is_for_update = update;
+  join->index_id = index_id;
+  return Operator(join);
+}
+
+hash_t PhysicalInnerIndexNLJoin::Hash() const {
+  hash_t hash = BaseOperatorNode::Hash();
+  for (auto &expr : left_keys)
+    hash = HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &pred : join_predicates)
+    hash = HashUtil::CombineHashes(hash, pred.expr->Hash());
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&index_id));
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&get_id));
+  for (auto &pred : predicates)
+    hash = HashUtil::CombineHashes(hash, pred.expr->Hash());
+  return hash;
+}
+
+bool PhysicalInnerIndexNLJoin::operator==(const BaseOperatorNode &r) {
+  if (r.type() != OpType::InnerIndexNLJoin) return false;
+  const PhysicalInnerIndexNLJoin &node =
+      *static_cast<const PhysicalInnerIndexNLJoin *>(&r);
+  if (index_id != node.index_id || get_id != node.get_id ||
+      join_predicates.size() != node.join_predicates.size() ||
+      left_keys.size() != node.left_keys.size() ||
+      predicates.size() != node.predicates.size())
+    return false;
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    if (!left_keys[i]->ExactlyEquals(*node.left_keys[i].get())) return false;
+  }
+  for (size_t i = 0; i < join_predicates.size(); i++) {
+    if (!join_predicates[i].expr->
+        ExactlyEquals(*node.join_predicates[i].expr.get()))
+      return false;
+  }
+  for (size_t i = 0; i < predicates.size(); i++) {
+    if (!predicates[i].expr->ExactlyEquals(*node.predicates[i].expr.get()))
+      return false;
+  }
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // PhysicalInsert
 //===--------------------------------------------------------------------===//
@@ -896,6 +1010,9 @@ template <>
 std::string OperatorNode<PhysicalInnerHashJoin>::name_ =
     "PhysicalInnerHashJoin";
 template <>
+std::string OperatorNode<PhysicalInnerMergeJoin>::name_ =
+    "PhysicalInnerMergeJoin";
+template <>
 std::string OperatorNode<PhysicalLeftHashJoin>::name_ = "PhysicalLeftHashJoin";
 template <>
 std::string OperatorNode<PhysicalRightHashJoin>::name_ =
@@ -904,6 +1021,9 @@ template <>
 std::string OperatorNode<PhysicalOuterHashJoin>::name_ =
     "PhysicalOuterHashJoin";
 template <>
+std::string OperatorNode<PhysicalInnerIndexNLJoin>::name_ =
+    "PhysicalInnerIndexNLJoin";
+template <>
 std::string OperatorNode<PhysicalInsert>::name_ = "PhysicalInsert";
 template <>
 std::string OperatorNode<PhysicalInsertSelect>::name_ = "PhysicalInsertSelect";
@@ -987,12 +1107,17 @@ OpType OperatorNode<PhysicalOuterNLJoin>::type_ = OpType::OuterNLJoin;
 template <>
 OpType OperatorNode<PhysicalInnerHashJoin>::type_ = OpType::InnerHashJoin;
 template <>
+OpType OperatorNode<PhysicalInnerMergeJoin>::type_ = OpType::InnerMergeJoin;
+template <>
 OpType OperatorNode<PhysicalLeftHashJoin>::type_ = OpType::LeftHashJoin;
 template <>
 OpType OperatorNode<PhysicalRightHashJoin>::type_ = OpType::RightHashJoin;
 template <>
 OpType OperatorNode<PhysicalOuterHashJoin>::type_ = OpType::OuterHashJoin;
 template <>
+OpType OperatorNode<PhysicalInnerIndexNLJoin>::type_ =
+    OpType::InnerIndexNLJoin;
+template <>
 OpType OperatorNode<PhysicalInsert>::type_ = OpType::Insert;
 template <>
 OpType OperatorNode<PhysicalInsertSelect>::type_ = OpType::InsertSelect;
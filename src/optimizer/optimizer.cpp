@@ -29,6 +29,7 @@
 #include "optimizer/rule_impls.h"
 #include "optimizer/optimizer_task_pool.h"
 #include "optimizer/optimize_context.h"
+#include "optimizer/parallel_explorer.h"
 #include "parser/create_statement.h"
 
 #include "planner/analyze_plan.h"
@@ -40,6 +41,8 @@
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
 
+#include "settings/settings_manager.h"
+
 #include "storage/data_table.h"
 
 #include "binder/bind_node_visitor.h"
@@ -80,6 +83,18 @@ void Optimizer::OptimizeLoop(int root_group_id,
   }
 
   // Perform optimization after the rewrite
+  metadata_.memo.IndexJoinGroups(root_group_id);
+
+  // Reordering large joins produces many groups, explore them in parallel
+  // first. Smaller queries are explored faster than threads are started.
+  auto num_threads = settings::SettingsManager::GetInt(
+      settings::SettingId::optimizer_threads);
+  if (num_threads > 1 &&
+      metadata_.memo.GetNumJoinGroups() + 1 >= kMinParallelExploreTables) {
+    ParallelExplorer explorer(&metadata_, required_props, num_threads);
+    explorer.Explore(metadata_.memo.GetGroupByID(root_group_id));
+  }
+
   task_stack->Push(new OptimizeGroup(metadata_.memo.GetGroupByID(root_group_id),
                                      root_context));
   // Derive stats for the only one logical expression before optimizing
@@ -12,6 +12,8 @@
 
 #include "optimizer/optimizer_task.h"
 
+#include <algorithm>
+
 #include "optimizer/property_enforcer.h"
 #include "optimizer/optimizer_metadata.h"
 #include "optimizer/binding.h"
@@ -19,6 +21,7 @@
 #include "optimizer/cost_calculator.h"
 #include "optimizer/stats_calculator.h"
 #include "optimizer/child_stats_deriver.h"
+#include "optimizer/parallel_explorer.h"
 
 namespace peloton {
 namespace optimizer {
@@ -36,7 +39,8 @@ void OptimizerTask::ConstructValidRules(
     //           static_cast<int>(rule->GetMatchPattern()->Type()));
     if (group_expr->Op().type() !=
             rule->GetMatchPattern()->Type() ||  // Root pattern type mismatch
-        group_expr->HasRuleExplored(rule.get()) ||  // Rule has been applied
+        (group_expr->HasRuleExplored(rule.get()) &&
+         !rule->DependsOnRequiredProperties()) ||  // Rule has been applied
         group_expr->GetChildrenGroupsSize() !=
             rule->GetMatchPattern()
                 ->GetChildPatternsSize())  // Children size does not math
@@ -48,7 +52,11 @@ void OptimizerTask::ConstructValidRules(
 }
 
 void OptimizerTask::PushTask(OptimizerTask *task) {
-  context_->metadata->task_pool->Push(task);
+  if (context_->task_pool != nullptr) {
+    context_->task_pool->Push(task);
+  } else {
+    context_->metadata->task_pool->Push(task);
+  }
 }
 
 Memo &OptimizerTask::GetMemo() const { return context_->metadata->memo; }
@@ -67,12 +75,11 @@ void OptimizeGroup::execute() {
           nullptr)  // Has optimized given the context
     return;
 
-  // Push explore task first for logical expressions if the group has not been
-  // explored
-  if (!group_->HasExplored()) {
-    for (auto &logical_expr : group_->GetLogicalExpressions())
-      PushTask(new OptimizeExpression(logical_expr.get(), context_));
-  }
+  // Push optimize tasks first for logical expressions. A group explored
+  // before (e.g. as the child of a join being reordered) still needs its
+  // implementation rules; the transformation rules already applied are skipped.
+  for (auto &logical_expr : group_->GetLogicalExpressions())
+    PushTask(new OptimizeExpression(logical_expr.get(), context_));
 
   // Push implement tasks to ensure that they are run first (for early pruning)
   for (auto &physical_expr : group_->GetPhysicalExpressions()) {
@@ -124,16 +131,28 @@ void OptimizeExpression::execute() {
 // ExploreGroup
 //===--------------------------------------------------------------------===//
 void ExploreGroup::execute() {
-  if (group_->HasExplored()) return;
+  if (finish_) {
+    group_->SetExplorationFlag();
+    if (context_->explorer != nullptr) {
+      context_->explorer->NotifyExplored();
+    }
+    return;
+  }
+  if (!group_->StartExploration()) {
+    // Since there is no cycle in the tree, a group being explored by the
+    // current thread is never reached again before it is done. Wait for the
+    // other threads though, the rules of the parent need all the expressions.
+    if (context_->explorer != nullptr) {
+      context_->explorer->WaitForExploration(group_);
+    }
+    return;
+  }
   LOG_DEBUG("ExploreGroup::execute() ");
 
+  PushTask(new ExploreGroup(this));
   for (auto &logical_expr : group_->GetLogicalExpressions()) {
     PushTask(new ExploreExpression(logical_expr.get(), context_));
   }
-
-  // Since there is no cycle in the tree, it is safe to set the flag even before
-  // all expressions are explored
-  group_->SetExplorationFlag();
 }
 
 //===--------------------------------------------------------------------===//
@@ -141,6 +160,13 @@ void ExploreGroup::execute() {
 //===--------------------------------------------------------------------===//
 void ExploreExpression::execute() {
   LOG_DEBUG("ExploreExpression::execute() ");
+  // Let idle threads explore the child groups ahead of this thread
+  if (context_->explorer != nullptr) {
+    for (auto child_group_id : group_expr_->GetChildGroupIDs()) {
+      context_->explorer->Offer(GetMemo().GetGroupByID(child_group_id));
+    }
+  }
+
   std::vector<RuleWithPromise> valid_rules;
 
   // Construct valid transformation rules from rule set
@@ -173,7 +199,9 @@ void ExploreExpression::execute() {
 //===--------------------------------------------------------------------===//
 void ApplyRule::execute() {
   // LOG_DEBUG("ApplyRule::execute() ");
-  if (group_expr_->HasRuleExplored(rule_)) return;
+  if (group_expr_->HasRuleExplored(rule_) &&
+      !rule_->DependsOnRequiredProperties())
+    return;
 
   GroupExprBindingIterator iterator(GetMemo(), group_expr_,
                                     rule_->GetMatchPattern());
@@ -384,9 +412,10 @@ void OptimizeInputs::execute() {
 
       // Can meet the requirement
       if (meet_requirement) {
-        // If the cost is smaller than the winner, update the context upper
-        // bound
-        context_->cost_upper_bound -= cur_total_cost_;
+        // The winner bounds the cost of the remaining alternatives, which
+        // prunes most of the join orders enumerated for the group
+        context_->cost_upper_bound =
+            std::min(context_->cost_upper_bound, cur_total_cost_);
         if (memo_enforced_expr != nullptr) {  // Enforcement takes place
           cur_group->SetExpressionCost(memo_enforced_expr, cur_total_cost_,
                                        context_->required_prop);
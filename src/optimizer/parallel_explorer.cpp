@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parallel_explorer.cpp
+//
+// Identification: src/optimizer/parallel_explorer.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/parallel_explorer.h"
+
+#include "optimizer/group.h"
+#include "optimizer/optimize_context.h"
+#include "optimizer/optimizer_task.h"
+#include "optimizer/optimizer_task_pool.h"
+#include "threadpool/mono_queue_pool.h"
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+// The helper tasks of an exploration. A task may only be picked up by a
+// worker after the exploration is over, so it must not touch the explorer
+// then.
+struct ExplorationHelpers {
+  std::mutex latch;
+  std::condition_variable done_cv;
+  // Cleared once the calling thread is done exploring
+  ParallelExplorer *explorer;
+  // The helper tasks running on the explorer
+  size_t num_running;
+};
+
+}  // namespace
+
+void ParallelExplorer::Explore(Group *root_group) {
+  Offer(root_group);
+
+  auto helpers = std::make_shared<ExplorationHelpers>();
+  helpers->explorer = this;
+  helpers->num_running = 0;
+
+  auto &pool = threadpool::MonoQueuePool::GetOptimizerInstance();
+  for (size_t i = 1; i < num_threads_; i++) {
+    pool.SubmitTask([helpers] {
+      ParallelExplorer *explorer;
+      {
+        std::lock_guard<std::mutex> lock(helpers->latch);
+        if (helpers->explorer == nullptr) {
+          return;
+        }
+        explorer = helpers->explorer;
+        helpers->num_running++;
+      }
+      explorer->Run();
+      {
+        std::lock_guard<std::mutex> lock(helpers->latch);
+        helpers->num_running--;
+      }
+      helpers->done_cv.notify_all();
+    });
+  }
+  Run();
+
+  // The helpers still running have nothing left to take and return shortly
+  {
+    std::unique_lock<std::mutex> lock(helpers->latch);
+    helpers->explorer = nullptr;
+    helpers->done_cv.wait(lock, [&helpers] {
+      return helpers->num_running == 0;
+    });
+  }
+
+  if (exception_ != nullptr) {
+    std::rethrow_exception(exception_);
+  }
+}
+
+void ParallelExplorer::Offer(Group *group) {
+  if (group->HasExplored()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    groups_.push_back(group);
+  }
+  work_cv_.notify_one();
+}
+
+void ParallelExplorer::WaitForExploration(Group *group) {
+  // The group may be left unexplored by a thread that failed
+  std::unique_lock<std::mutex> lock(latch_);
+  explored_cv_.wait(lock, [this, group] {
+    return group->IsExplorationDone() || failed_;
+  });
+}
+
+void ParallelExplorer::NotifyExplored() {
+  // Taking the latch orders the flag before the check of a waiting thread
+  { std::lock_guard<std::mutex> lock(latch_); }
+  explored_cv_.notify_all();
+}
+
+void ParallelExplorer::Run() {
+  OptimizerTaskStack task_stack;
+  auto context = std::make_shared<OptimizeContext>(metadata_, required_prop_);
+  context->task_pool = &task_stack;
+  context->explorer = this;
+
+  Group *group;
+  while ((group = Take()) != nullptr) {
+    try {
+      task_stack.Push(new ExploreGroup(group, context));
+      while (!task_stack.Empty()) {
+        auto task = task_stack.Pop();
+        task->execute();
+      }
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(latch_);
+        if (!failed_) {
+          exception_ = std::current_exception();
+          failed_ = true;
+        }
+      }
+      work_cv_.notify_all();
+      explored_cv_.notify_all();
+      while (!task_stack.Empty()) {
+        task_stack.Pop();
+      }
+    }
+
+    bool idle;
+    {
+      std::lock_guard<std::mutex> lock(latch_);
+      idle = --num_busy_threads_ == 0;
+    }
+    if (idle) {
+      work_cv_.notify_all();
+    }
+  }
+}
+
+Group *ParallelExplorer::Take() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    while (!groups_.empty() && !failed_) {
+      auto group = groups_.back();
+      groups_.pop_back();
+      // Offered more than once, or reached by the thread that offered it
+      if (!group->HasExplored()) {
+        num_busy_threads_++;
+        return group;
+      }
+    }
+    // Only busy threads offer groups
+    if (num_busy_threads_ == 0 || failed_) {
+      return nullptr;
+    }
+    work_cv_.wait(lock);
+  }
+}
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -16,6 +16,7 @@
 #include "catalog/index_catalog.h"
 #include "catalog/table_catalog.h"
 #include "concurrency/transaction_context.h"
+#include "expression/constant_value_expression.h"
 #include "expression/expression_util.h"
 #include "optimizer/operator_expression.h"
 #include "optimizer/properties.h"
@@ -26,6 +27,8 @@
 #include "planner/index_scan_plan.h"
 #include "planner/insert_plan.h"
 #include "planner/limit_plan.h"
+#include "planner/merge_join_plan.h"
+#include "planner/nested_loop_index_join_plan.h"
 #include "planner/nested_loop_join_plan.h"
 #include "planner/order_by_plan.h"
 #include "planner/projection_plan.h"
@@ -34,6 +37,7 @@
 #include "settings/settings_manager.h"
 #include "storage/data_table.h"
 #include "storage/storage_manager.h"
+#include "type/value_peeker.h"
 
 using std::vector;
 using std::make_pair;
@@ -271,6 +275,100 @@ void PlanGenerator::Visit(const PhysicalRightHashJoin *) {}
 
 void PlanGenerator::Visit(const PhysicalOuterHashJoin *) {}
 
+void PlanGenerator::Visit(const PhysicalInnerMergeJoin *op) {
+  std::unique_ptr<const planner::ProjectInfo> proj_info;
+  std::shared_ptr<const catalog::Schema> proj_schema;
+  GenerateProjectionForJoin(proj_info, proj_schema);
+
+  auto join_predicate =
+      expression::ExpressionUtil::JoinAnnotatedExprs(op->join_predicates);
+  expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
+                                                 join_predicate.get());
+
+  // Like the join predicate, the left key refers to the left child and the
+  // right key to the right child
+  vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+  for (size_t i = 0; i < op->left_keys.size(); i++) {
+    auto left_key = op->left_keys[i]->Copy();
+    expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
+                                                   left_key);
+    auto right_key = op->right_keys[i]->Copy();
+    expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
+                                                   right_key);
+    join_clauses.emplace_back(left_key, right_key, false);
+  }
+
+  auto join_plan = unique_ptr<planner::AbstractPlan>(new planner::MergeJoinPlan(
+      JoinType::INNER, move(join_predicate), move(proj_info), proj_schema,
+      join_clauses));
+
+  join_plan->AddChild(move(children_plans_[0]));
+  join_plan->AddChild(move(children_plans_[1]));
+  output_plan_ = move(join_plan);
+}
+
+void PlanGenerator::Visit(const PhysicalInnerIndexNLJoin *op) {
+  PL_ASSERT(children_plans_.size() == 1);
+  PL_ASSERT(children_expr_map_.size() == 1);
+
+  // Collect the inner columns used by the join, which the probe produces in
+  // place of a right child
+  ExprSet inner_cols_set;
+  for (auto expr : output_cols_) {
+    expression::ExpressionUtil::GetTupleValueExprs(inner_cols_set, expr);
+  }
+  for (auto &join_cond : op->join_predicates) {
+    expression::ExpressionUtil::GetTupleValueExprs(inner_cols_set,
+                                                   join_cond.expr.get());
+  }
+  ExprMap inner_expr_map;
+  vector<oid_t> inner_column_ids;
+  for (auto &col : inner_cols_set) {
+    auto tv_expr = reinterpret_cast<expression::TupleValueExpression *>(col);
+    if (tv_expr->GetTableName() != op->table_alias ||
+        children_expr_map_[0].count(col)) {
+      continue;
+    }
+    PL_ASSERT(tv_expr->GetIsBound() == true);
+    inner_expr_map[col] = inner_column_ids.size();
+    inner_column_ids.push_back(std::get<2>(tv_expr->GetBoundOid()));
+  }
+
+  // The probed table and the predicate on it are kept in the join plan
+  auto table = storage::StorageManager::GetInstance()->GetTableWithOid(
+      op->table_->GetDatabaseOid(), op->table_->GetTableOid());
+  auto index = table->GetIndexWithOid(op->index_id);
+  auto predicate = GeneratePredicateForScan(
+      expression::ExpressionUtil::JoinAnnotatedExprs(op->predicates),
+      op->table_alias, op->table_);
+  children_expr_map_.push_back(move(inner_expr_map));
+
+  std::unique_ptr<const planner::ProjectInfo> proj_info;
+  std::shared_ptr<const catalog::Schema> proj_schema;
+  GenerateProjectionForJoin(proj_info, proj_schema);
+
+  auto join_predicate =
+      expression::ExpressionUtil::JoinAnnotatedExprs(op->join_predicates);
+  expression::ExpressionUtil::EvaluateExpression(children_expr_map_,
+                                                 join_predicate.get());
+
+  vector<oid_t> left_keys;
+  for (auto &expr : op->left_keys) {
+    PL_ASSERT(children_expr_map_[0].find(expr.get()) !=
+              children_expr_map_[0].end());
+    left_keys.push_back(children_expr_map_[0][expr.get()]);
+  }
+
+  auto join_plan =
+      unique_ptr<planner::AbstractPlan>(new planner::NestedLoopIndexJoinPlan(
+          JoinType::INNER, move(join_predicate), move(proj_info), proj_schema,
+          left_keys, table, index, inner_column_ids, move(predicate),
+          op->is_for_update));
+
+  join_plan->AddChild(move(children_plans_[0]));
+  output_plan_ = move(join_plan);
+}
+
 void PlanGenerator::Visit(const PhysicalInsert *op) {
   unique_ptr<planner::AbstractPlan> insert_plan(new planner::InsertPlan(
       storage::StorageManager::GetInstance()->GetTableWithOid(
@@ -477,9 +575,19 @@ void PlanGenerator::BuildAggregatePlan(
       // Maps the aggregate value in th right tuple to the output
       // See aggregateor.cpp for more detail
       dml.emplace_back(idx, make_pair(1, agg_id++));
+      // APPROX_PERCENTILE keeps its (constant) percentile as second child
+      double percentile = 0.5;
+      if (agg_expr->GetExpressionType() ==
+          ExpressionType::AGGREGATE_APPROX_PERCENTILE) {
+        auto *percentile_expr =
+            static_cast<const expression::ConstantValueExpression *>(
+                agg_expr->GetChild(1));
+        percentile = type::ValuePeeker::PeekDouble(
+            percentile_expr->GetValue().CastAs(type::TypeId::DECIMAL));
+      }
       aggr_terms.emplace_back(agg_expr->GetExpressionType(),
                               agg_col == nullptr ? nullptr : agg_col->Copy(),
-                              agg_expr->distinct_);
+                              agg_expr->distinct_, percentile);
     } else if (child_expr_map.find(expr) != child_expr_map.end()) {
       dml.emplace_back(idx, make_pair(0, child_expr_map[expr]));
     } else {
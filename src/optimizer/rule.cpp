@@ -29,6 +29,7 @@ int Rule::Promise(GroupExpression *group_expr, OptimizeContext *context) const {
 
 RuleSet::RuleSet() {
   AddTransformationRule(new InnerJoinCommutativity());
+  AddTransformationRule(new InnerJoinAssociativity());
   AddImplementationRule(new LogicalDeleteToPhysical());
   AddImplementationRule(new LogicalUpdateToPhysical());
   AddImplementationRule(new LogicalInsertToPhysical());
@@ -41,6 +42,8 @@ RuleSet::RuleSet() {
   AddImplementationRule(new LogicalQueryDerivedGetToPhysical());
   AddImplementationRule(new InnerJoinToInnerNLJoin());
   AddImplementationRule(new InnerJoinToInnerHashJoin());
+  AddImplementationRule(new InnerJoinToInnerIndexNLJoin());
+  AddImplementationRule(new InnerJoinToInnerMergeJoin());
   AddImplementationRule(new ImplementDistinct());
   AddImplementationRule(new ImplementLimit());
 
@@ -21,6 +21,7 @@
 #include "storage/data_table.h"
 #include "optimizer/properties.h"
 #include "optimizer/optimizer_metadata.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace optimizer {
@@ -68,6 +69,99 @@ void InnerJoinCommutativity::Transform(
   transformed.push_back(result_plan);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// InnerJoinAssociativity
+InnerJoinAssociativity::InnerJoinAssociativity() {
+  type_ = RuleType::INNER_JOIN_ASSOCIATE;
+
+  std::shared_ptr<Pattern> left_child(
+      std::make_shared<Pattern>(OpType::InnerJoin));
+  left_child->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  left_child->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  std::shared_ptr<Pattern> right_child(std::make_shared<Pattern>(OpType::Leaf));
+  match_pattern = std::make_shared<Pattern>(OpType::InnerJoin);
+  match_pattern->AddChild(left_child);
+  match_pattern->AddChild(right_child);
+}
+
+// Split the predicates of (A join B) join C into those of the new join of
+// B and C and those left to the parent join
+static void SplitAssociatedJoinPredicates(
+    std::shared_ptr<OperatorExpression> input, OptimizeContext *context,
+    std::vector<AnnotatedExpression> &parent_predicates,
+    std::vector<AnnotatedExpression> &child_predicates) {
+  auto &memo = context->metadata->memo;
+  auto &left_join_expr = input->Children()[0];
+  auto middle_group_id =
+      left_join_expr->Children()[1]->Op().As<LeafOperator>()->origin_group;
+  auto right_group_id =
+      input->Children()[1]->Op().As<LeafOperator>()->origin_group;
+
+  std::unordered_set<std::string> child_aliases(
+      memo.GetGroupByID(middle_group_id)->GetTableAliases());
+  auto &right_group_aliases =
+      memo.GetGroupByID(right_group_id)->GetTableAliases();
+  child_aliases.insert(right_group_aliases.begin(), right_group_aliases.end());
+
+  for (auto join_op : {input->Op().As<LogicalInnerJoin>(),
+                       left_join_expr->Op().As<LogicalInnerJoin>()}) {
+    for (auto &predicate : join_op->join_predicates) {
+      if (util::IsSubset(child_aliases, predicate.table_alias_set))
+        child_predicates.emplace_back(predicate);
+      else
+        parent_predicates.emplace_back(predicate);
+    }
+  }
+}
+
+bool InnerJoinAssociativity::Check(std::shared_ptr<OperatorExpression> expr,
+                                   OptimizeContext *context) const {
+  auto &memo = context->metadata->memo;
+  auto &left_join_expr = expr->Children()[0];
+  size_t num_tables = 0;
+  for (auto &child : {left_join_expr->Children()[0],
+                      left_join_expr->Children()[1], expr->Children()[1]}) {
+    auto group_id = child->Op().As<LeafOperator>()->origin_group;
+    num_tables += memo.GetGroupByID(group_id)->GetTableAliases().size();
+  }
+  if (num_tables > static_cast<size_t>(settings::SettingsManager::GetInt(
+                       settings::SettingId::join_reorder_max_tables)))
+    return false;
+
+  // B and C must be joined on some predicate, or the new join would be a
+  // cross product
+  std::vector<AnnotatedExpression> parent_predicates;
+  std::vector<AnnotatedExpression> child_predicates;
+  SplitAssociatedJoinPredicates(expr, context, parent_predicates,
+                                child_predicates);
+  return !child_predicates.empty();
+}
+
+void InnerJoinAssociativity::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    OptimizeContext *context) const {
+  std::vector<AnnotatedExpression> parent_predicates;
+  std::vector<AnnotatedExpression> child_predicates;
+  SplitAssociatedJoinPredicates(input, context, parent_predicates,
+                                child_predicates);
+
+  auto &left_join_expr = input->Children()[0];
+  LOG_TRACE("Reassociate inner join of group %d with its left child join",
+            input->Children()[1]->Op().As<LeafOperator>()->origin_group);
+  auto child_join = std::make_shared<OperatorExpression>(
+      LogicalInnerJoin::make(child_predicates));
+  child_join->PushChild(left_join_expr->Children()[1]);
+  child_join->PushChild(input->Children()[1]);
+
+  auto result_plan = std::make_shared<OperatorExpression>(
+      LogicalInnerJoin::make(parent_predicates));
+  result_plan->PushChild(left_join_expr->Children()[0]);
+  result_plan->PushChild(child_join);
+
+  transformed.push_back(result_plan);
+}
+
 //===--------------------------------------------------------------------===//
 // Implementation rules
 //===--------------------------------------------------------------------===//
@@ -217,7 +311,10 @@ void GetToIndexScan::Transform(
     std::vector<type::Value> value_list;
     for (auto &pred : get->predicates) {
       auto expr = pred.expr.get();
-      if (expr->GetChildrenSize() != 2) continue;
+      // IN lists are not turned into index lookups
+      if (expr->GetChildrenSize() != 2 ||
+          expr->GetExpressionType() == ExpressionType::COMPARE_IN)
+        continue;
       auto expr_type = expr->GetExpressionType();
       expression::AbstractExpression *tv_expr = nullptr;
       expression::AbstractExpression *value_expr = nullptr;
@@ -632,6 +729,171 @@ void InnerJoinToInnerHashJoin::Transform(
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// InnerJoinToInnerIndexNLJoin
+InnerJoinToInnerIndexNLJoin::InnerJoinToInnerIndexNLJoin() {
+  type_ = RuleType::INNER_JOIN_TO_INDEX_NL_JOIN;
+
+  std::shared_ptr<Pattern> left_child(std::make_shared<Pattern>(OpType::Leaf));
+  std::shared_ptr<Pattern> right_child(std::make_shared<Pattern>(OpType::Leaf));
+
+  // Initialize a pattern for optimizer to match
+  match_pattern = std::make_shared<Pattern>(OpType::InnerJoin);
+
+  // Add node - we match join relation R and S
+  match_pattern->AddChild(left_child);
+  match_pattern->AddChild(right_child);
+}
+
+bool InnerJoinToInnerIndexNLJoin::Check(
+    std::shared_ptr<OperatorExpression> plan, OptimizeContext *context) const {
+  (void)context;
+  (void)plan;
+  return true;
+}
+
+void InnerJoinToInnerIndexNLJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    OptimizeContext *context) const {
+  const LogicalInnerJoin *inner_join = input->Op().As<LogicalInnerJoin>();
+
+  auto children = input->Children();
+  PL_ASSERT(children.size() == 2);
+  auto left_group_id = children[0]->Op().As<LeafOperator>()->origin_group;
+  auto right_group_id = children[1]->Op().As<LeafOperator>()->origin_group;
+  auto right_group = context->metadata->memo.GetGroupByID(right_group_id);
+  auto &left_group_alias =
+      context->metadata->memo.GetGroupByID(left_group_id)->GetTableAliases();
+  auto &right_group_alias = right_group->GetTableAliases();
+
+  // The right child has to be a base table
+  const LogicalGet *get = nullptr;
+  for (auto &gexpr : right_group->GetLogicalExpressions()) {
+    if (gexpr->Op().type() == OpType::Get) {
+      get = gexpr->Op().As<LogicalGet>();
+      break;
+    }
+  }
+  if (get == nullptr || get->table == nullptr) {
+    return;
+  }
+
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+  util::ExtractEquiJoinKeys(inner_join->join_predicates, left_keys, right_keys,
+                            left_group_alias, right_group_alias);
+  PL_ASSERT(right_keys.size() == left_keys.size());
+  if (left_keys.empty()) {
+    return;
+  }
+
+  // Map the inner columns to the outer expressions they are joined with
+  std::unordered_map<oid_t, size_t> right_col_to_key;
+  for (size_t i = 0; i < right_keys.size(); i++) {
+    if (right_keys[i]->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+      continue;
+    }
+    auto tv_expr =
+        reinterpret_cast<expression::TupleValueExpression *>(right_keys[i].get());
+    right_col_to_key.emplace(std::get<2>(tv_expr->GetBoundOid()), i);
+  }
+
+  // Every index whose key columns are all joined can be probed
+  for (auto &index_id_object_pair : get->table->GetIndexObjects()) {
+    auto &index_id = index_id_object_pair.first;
+    auto &index_col_ids = index_id_object_pair.second->GetKeyAttrs();
+    std::vector<std::unique_ptr<expression::AbstractExpression>> probe_keys;
+    for (auto col_id : index_col_ids) {
+      auto key = right_col_to_key.find(col_id);
+      if (key == right_col_to_key.end()) {
+        break;
+      }
+      probe_keys.emplace_back(left_keys[key->second]->Copy());
+    }
+    if (probe_keys.empty() || probe_keys.size() != index_col_ids.size()) {
+      continue;
+    }
+
+    auto result_plan =
+        std::make_shared<OperatorExpression>(PhysicalInnerIndexNLJoin::make(
+            inner_join->join_predicates, probe_keys, get->get_id, get->table,
+            get->table_alias, get->predicates, get->is_for_update, index_id));
+
+    // Only the outer child is executed
+    result_plan->PushChild(children[0]);
+
+    transformed.push_back(result_plan);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// InnerJoinToInnerMergeJoin
+InnerJoinToInnerMergeJoin::InnerJoinToInnerMergeJoin() {
+  type_ = RuleType::INNER_JOIN_TO_MERGE_JOIN;
+
+  std::shared_ptr<Pattern> left_child(std::make_shared<Pattern>(OpType::Leaf));
+  std::shared_ptr<Pattern> right_child(std::make_shared<Pattern>(OpType::Leaf));
+
+  // Initialize a pattern for optimizer to match
+  match_pattern = std::make_shared<Pattern>(OpType::InnerJoin);
+
+  // Add node - we match join relation R and S
+  match_pattern->AddChild(left_child);
+  match_pattern->AddChild(right_child);
+}
+
+bool InnerJoinToInnerMergeJoin::Check(std::shared_ptr<OperatorExpression> plan,
+                                      OptimizeContext *context) const {
+  (void)context;
+  (void)plan;
+  return true;
+}
+
+void InnerJoinToInnerMergeJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    OptimizeContext *context) const {
+  const LogicalInnerJoin *inner_join = input->Op().As<LogicalInnerJoin>();
+
+  auto children = input->Children();
+  PL_ASSERT(children.size() == 2);
+  auto left_group_id = children[0]->Op().As<LeafOperator>()->origin_group;
+  auto right_group_id = children[1]->Op().As<LeafOperator>()->origin_group;
+  auto &left_group_alias =
+      context->metadata->memo.GetGroupByID(left_group_id)->GetTableAliases();
+  auto &right_group_alias =
+      context->metadata->memo.GetGroupByID(right_group_id)->GetTableAliases();
+  std::vector<std::unique_ptr<expression::AbstractExpression>> left_keys;
+  std::vector<std::unique_ptr<expression::AbstractExpression>> right_keys;
+
+  util::ExtractEquiJoinKeys(inner_join->join_predicates, left_keys, right_keys,
+                            left_group_alias, right_group_alias);
+
+  PL_ASSERT(right_keys.size() == left_keys.size());
+  if (left_keys.empty()) {
+    return;
+  }
+
+  // The children are sorted on the keys, which must be columns they produce
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    if (left_keys[i]->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+        right_keys[i]->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+      return;
+    }
+  }
+
+  auto result_plan =
+      std::make_shared<OperatorExpression>(PhysicalInnerMergeJoin::make(
+          inner_join->join_predicates, left_keys, right_keys));
+
+  // Then push all children into the child list of the new operator
+  result_plan->PushChild(children[0]);
+  result_plan->PushChild(children[1]);
+
+  transformed.push_back(result_plan);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// ImplementDistinct
 ImplementDistinct::ImplementDistinct() {
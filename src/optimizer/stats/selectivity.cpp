@@ -67,12 +67,28 @@ double Selectivity::LessThan(const std::shared_ptr<TableStats> &table_stats,
     return DEFAULT_SELECTIVITY;
   }
   // Use histogram to estimate selectivity
-  std::vector<double> histogram = column_stats->histogram_bounds;
+  const std::vector<double> &histogram = column_stats->histogram_bounds;
   size_t n = histogram.size();
-  PL_ASSERT(n > 0);
+  if (n == 0) {
+    return DEFAULT_SELECTIVITY;
+  }
   // find correspond bin using binary search
   auto it = std::lower_bound(histogram.begin(), histogram.end(), v);
-  double res = (it - histogram.begin()) * 1.0 / n;
+  size_t idx = it - histogram.begin();
+  double res;
+  if (idx == 0) {
+    res = 0;
+  } else if (idx == n) {
+    res = 1;
+  } else {
+    // The n bounds split the column into n + 1 buckets of equal height, the
+    // i-th bound being at the (i + 1) / (n + 1) quantile. Interpolate
+    // linearly within the bucket v falls into.
+    double lower = histogram[idx - 1];
+    double upper = histogram[idx];
+    double frac = (v - lower) / (upper - lower);
+    res = (idx + frac) / (n + 1);
+  }
   PL_ASSERT(res >= 0);
   PL_ASSERT(res <= 1);
   return res;
@@ -135,6 +151,95 @@ double Selectivity::Equal(const std::shared_ptr<TableStats> &table_stats,
   return res;
 }
 
+double Selectivity::EqualJoin(const std::shared_ptr<ColumnStats> &left_stats,
+                              const std::shared_ptr<ColumnStats> &right_stats) {
+  size_t left_rows = left_stats->num_rows;
+  size_t right_rows = right_stats->num_rows;
+  if (left_rows == 0 || right_rows == 0) {
+    return 0;
+  }
+  double left_distinct = left_stats->cardinality;
+  double right_distinct = right_stats->cardinality;
+  if (left_distinct <= 0 || right_distinct <= 0) {
+    // No distinct counts, assume one side is a key
+    return 1.0 / std::max(left_rows, right_rows);
+  }
+
+  // NULLs never join
+  double left_not_null = 1 - left_stats->frac_null;
+  double right_not_null = 1 - right_stats->frac_null;
+
+  auto &left_vals = left_stats->most_common_vals;
+  auto &right_vals = right_stats->most_common_vals;
+  if (left_vals.empty() || right_vals.empty()) {
+    // Every value of the side with fewer distinct values finds a match
+    return left_not_null * right_not_null /
+           std::max(left_distinct, right_distinct);
+  }
+
+  // Match the most common values of both sides. Frequencies are counts, turn
+  // them into fractions of the rows.
+  double match_prod_freq = 0, left_match_freq = 0, right_match_freq = 0;
+  double left_unmatch_freq = 0, right_unmatch_freq = 0;
+  size_t num_matches = 0;
+  std::vector<bool> right_matched(right_vals.size(), false);
+  for (size_t i = 0; i < left_vals.size(); i++) {
+    double left_freq = left_stats->most_common_freqs[i] / left_rows;
+    bool matched = false;
+    for (size_t j = 0; j < right_vals.size(); j++) {
+      if (!right_matched[j] && left_vals[i] == right_vals[j]) {
+        double right_freq = right_stats->most_common_freqs[j] / right_rows;
+        match_prod_freq += left_freq * right_freq;
+        left_match_freq += left_freq;
+        right_match_freq += right_freq;
+        right_matched[j] = true;
+        matched = true;
+        num_matches++;
+        break;
+      }
+    }
+    if (!matched) {
+      left_unmatch_freq += left_freq;
+    }
+  }
+  for (size_t j = 0; j < right_vals.size(); j++) {
+    if (!right_matched[j]) {
+      right_unmatch_freq += right_stats->most_common_freqs[j] / right_rows;
+    }
+  }
+
+  // The rows not covered by the most common values
+  double left_other_freq =
+      std::max(left_not_null - left_match_freq - left_unmatch_freq, 0.0);
+  double right_other_freq =
+      std::max(right_not_null - right_match_freq - right_unmatch_freq, 0.0);
+
+  // Estimate from either side: a most common value without a match can only
+  // join the uncommon values of the other side, and the uncommon values join
+  // everything but the matched values of the other side. Both estimates are
+  // upper bounds, take the tighter one.
+  double left_sel = match_prod_freq;
+  if (right_distinct > right_vals.size()) {
+    left_sel += left_unmatch_freq * right_other_freq /
+                (right_distinct - right_vals.size());
+  }
+  if (right_distinct > num_matches) {
+    left_sel += left_other_freq * (right_other_freq + right_unmatch_freq) /
+                (right_distinct - num_matches);
+  }
+  double right_sel = match_prod_freq;
+  if (left_distinct > left_vals.size()) {
+    right_sel += right_unmatch_freq * left_other_freq /
+                 (left_distinct - left_vals.size());
+  }
+  if (left_distinct > num_matches) {
+    right_sel += right_other_freq * (left_other_freq + left_unmatch_freq) /
+                 (left_distinct - num_matches);
+  }
+  double res = std::min(left_sel, right_sel);
+  return std::max(std::min(res, 1.0), 0.0);
+}
+
 // Selectivity for 'LIKE' operator. The column type must be VARCHAR.
 // Complete implementation once we support LIKE operator.
 double Selectivity::Like(const std::shared_ptr<TableStats> &table_stats,
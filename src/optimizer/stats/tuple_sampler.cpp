@@ -99,7 +99,7 @@ bool TupleSampler::GetTupleInTileGroup(storage::TileGroup *tile_group,
     const catalog::Schema &schema = tile_schemas[tile_itr];
     oid_t tile_column_count = schema.GetColumnCount();
 
-    storage::Tile *tile = tile_group->GetTile(tile_itr);
+    storage::Tile *tile = tile_group->GetTile(tile_itr)->GetMaterializedTile();
 
     char *tile_tuple_location = tile->GetTupleLocation(tuple_offset);
     storage::Tuple tile_tuple(&schema, tile_tuple_location);
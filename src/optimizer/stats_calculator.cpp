@@ -12,6 +12,7 @@
 
 #include "optimizer/stats_calculator.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "catalog/table_catalog.h"
@@ -71,7 +72,7 @@ void StatsCalculator::Visit(const LogicalGet *op) {
   for (auto &column_name_stats_pair : required_stats) {
     auto &column_name = column_name_stats_pair.first;
     auto &column_stats = column_name_stats_pair.second;
-    column_stats->num_rows = root_group->GetNumRows();
+    column_stats->ScaleToNumRows(root_group->GetNumRows());
     memo_->GetGroupByID(gexpr_->GetGroupID())
         ->AddStats(column_name, column_stats);
   }
@@ -102,8 +103,8 @@ void StatsCalculator::Visit(const LogicalInnerJoin *op) {
   auto root_group = memo_->GetGroupByID(gexpr_->GetGroupID());
   // Calculate output num rows first
   if (root_group->GetNumRows() == -1) {
-    size_t curr_rows =
-        left_child_group->GetNumRows() * right_child_group->GetNumRows();
+    double curr_rows = (double)left_child_group->GetNumRows() *
+                       right_child_group->GetNumRows();
     for (auto &annotated_expr : op->join_predicates) {
       // See if there are join conditions
       if (annotated_expr.expr->GetExpressionType() ==
@@ -118,18 +119,20 @@ void StatsCalculator::Visit(const LogicalInnerJoin *op) {
         auto right_child =
             reinterpret_cast<const expression::TupleValueExpression *>(
                 annotated_expr.expr->GetChild(1));
-        if ((left_child_group->HasColumnStats(left_child->GetColFullName()) &&
-             right_child_group->HasColumnStats(
-                 right_child->GetColFullName())) ||
-            (left_child_group->HasColumnStats(right_child->GetColFullName()) &&
-             right_child_group->HasColumnStats(left_child->GetColFullName()))) {
-          curr_rows /= std::max(std::max(left_child_group->GetNumRows(),
-                                         right_child_group->GetNumRows()),
-                                1);
+        auto left_name = left_child->GetColFullName();
+        auto right_name = right_child->GetColFullName();
+        // The predicate may refer to the right child first
+        if (!left_child_group->HasColumnStats(left_name)) {
+          std::swap(left_name, right_name);
+        }
+        auto left_stats = left_child_group->GetStats(left_name);
+        auto right_stats = right_child_group->GetStats(right_name);
+        if (left_stats != nullptr && right_stats != nullptr) {
+          curr_rows *= Selectivity::EqualJoin(left_stats, right_stats);
         }
       }
     }
-    root_group->SetNumRows(curr_rows);
+    root_group->SetNumRows(std::ceil(curr_rows));
   }
   size_t num_rows = root_group->GetNumRows();
   for (auto &col : required_cols_) {
@@ -145,8 +148,7 @@ void StatsCalculator::Visit(const LogicalInnerJoin *op) {
       column_stats = std::make_shared<ColumnStats>(
           *right_child_group->GetStats(tv_expr->GetColFullName()));
     }
-    // Reset num_rows
-    column_stats->num_rows = num_rows;
+    column_stats->ScaleToNumRows(num_rows);
     root_group->AddStats(tv_expr->GetColFullName(), column_stats);
   }
   // TODO(boweic): calculate stats based on predicates other than join
@@ -156,22 +158,40 @@ void StatsCalculator::Visit(UNUSED_ATTRIBUTE const LogicalLeftJoin *op) {}
 void StatsCalculator::Visit(UNUSED_ATTRIBUTE const LogicalRightJoin *op) {}
 void StatsCalculator::Visit(UNUSED_ATTRIBUTE const LogicalOuterJoin *op) {}
 void StatsCalculator::Visit(UNUSED_ATTRIBUTE const LogicalSemiJoin *op) {}
-void StatsCalculator::Visit(const LogicalAggregateAndGroupBy *) {
-  // TODO(boweic): For now we just pass the stats needed without any
-  // computation,
-  // We need to implement stats computation for aggregation
+void StatsCalculator::Visit(const LogicalAggregateAndGroupBy *op) {
   PL_ASSERT(gexpr_->GetChildrenGroupsSize() == 1);
-  // First, set num rows
-  memo_->GetGroupByID(gexpr_->GetGroupID())
-      ->SetNumRows(
-          memo_->GetGroupByID(gexpr_->GetChildGroupId(0))->GetNumRows());
+  auto group = memo_->GetGroupByID(gexpr_->GetGroupID());
+  auto child_group = memo_->GetGroupByID(gexpr_->GetChildGroupId(0));
+  // First, set num rows: one row per group, the number of groups being bounded
+  // by the product of the distinct counts of the group by columns
+  size_t child_rows = child_group->GetNumRows();
+  double num_groups = 1;
+  for (auto &column : op->columns) {
+    std::shared_ptr<ColumnStats> column_stats;
+    if (column->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      column_stats = child_group->GetStats(
+          reinterpret_cast<expression::TupleValueExpression *>(column.get())
+              ->GetColFullName());
+    }
+    if (column_stats == nullptr || column_stats->cardinality <= 0) {
+      // No distinct count, assume every row is its own group
+      num_groups = child_rows;
+      break;
+    }
+    num_groups *= column_stats->cardinality;
+  }
+  if (!op->columns.empty()) {
+    num_groups = std::min(num_groups, (double)child_rows);
+  }
+  group->SetNumRows(std::ceil(num_groups));
   for (auto &col : required_cols_) {
     PL_ASSERT(col->GetExpressionType() == ExpressionType::VALUE_TUPLE);
     auto column_name = reinterpret_cast<expression::TupleValueExpression *>(col)
                            ->GetColFullName();
-    memo_->GetGroupByID(gexpr_->GetGroupID())
-        ->AddStats(column_name, memo_->GetGroupByID(gexpr_->GetChildGroupId(0))
-                                    ->GetStats(column_name));
+    std::shared_ptr<ColumnStats> column_stats =
+        std::make_shared<ColumnStats>(*child_group->GetStats(column_name));
+    column_stats->ScaleToNumRows(group->GetNumRows());
+    group->AddStats(column_name, column_stats);
   }
 }
 
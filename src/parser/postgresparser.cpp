@@ -25,6 +25,7 @@
 #include "parser/pg_list.h"
 #include "parser/pg_query.h"
 #include "parser/pg_trigger.h"
+#include "type/value_peeker.h"
 
 namespace peloton {
 namespace parser {
@@ -532,7 +533,11 @@ expression::AbstractExpression *PostgresParser::FuncCallTransform(
       result =
           new expression::AggregateExpression(agg_fun_type, false, children);
     } else {
-      if (root->args->length < 2) {
+      // approx_percentile() takes the percentile as its second argument, all
+      // other aggregates take a single argument
+      int num_args =
+          agg_fun_type == ExpressionType::AGGREGATE_APPROX_PERCENTILE ? 2 : 1;
+      if (root->args->length == num_args) {
         // auto children_expr_list = TargetTransform(root->args);
         expression::AbstractExpression *child;
         auto expr_node = (Node *)root->args->head->data.ptr_value;
@@ -544,6 +549,13 @@ expression::AbstractExpression *PostgresParser::FuncCallTransform(
         }
         result = new expression::AggregateExpression(agg_fun_type,
                                                      root->agg_distinct, child);
+        if (num_args == 2) {
+          auto fraction_node = (Node *)root->args->tail->data.ptr_value;
+          result->SetChild(1, PercentileTransform(fraction_node));
+        }
+      } else if (num_args == 2) {
+        throw ParserException(
+            "approx_percentile() takes an expression and a percentile");
       } else {
         throw NotImplementedException(
             "Aggregation over multiple columns not supported yet...\n");
@@ -553,6 +565,32 @@ expression::AbstractExpression *PostgresParser::FuncCallTransform(
   return result;
 }
 
+// This function takes in the percentile argument of approx_percentile(),
+// which must be a numeric constant between 0 and 1, and transfers it into a
+// Peloton ConstantValueExpression holding a DECIMAL.
+expression::AbstractExpression *PostgresParser::PercentileTransform(
+    Node *node) {
+  if (node->type == T_A_Const) {
+    std::unique_ptr<expression::AbstractExpression> fraction{
+        ConstTransform(reinterpret_cast<A_Const *>(node))};
+    auto value =
+        static_cast<expression::ConstantValueExpression *>(fraction.get())
+            ->GetValue();
+    if (!value.IsNull() && (value.GetTypeId() == type::TypeId::INTEGER ||
+                            value.GetTypeId() == type::TypeId::DECIMAL)) {
+      double percentile = type::ValuePeeker::PeekDouble(
+          value.CastAs(type::TypeId::DECIMAL));
+      if (percentile >= 0.0 && percentile <= 1.0) {
+        return new expression::ConstantValueExpression(
+            type::ValueFactory::GetDecimalValue(percentile));
+      }
+    }
+  }
+  throw ParserException(
+      "The percentile of approx_percentile() must be a constant between 0 and "
+      "1");
+}
+
 // This function takes in the whereClause part of a Postgres SelectStmt
 // parsenode and transfers it into the select_list of a Peloton SelectStatement.
 // It checks the type of each target and call the corresponding helpers.
@@ -689,6 +727,9 @@ expression::AbstractExpression *PostgresParser::AExprTransform(A_Expr *root) {
   UNUSED_ATTRIBUTE ExpressionType target_type;
   const char *name =
       (reinterpret_cast<value *>(root->name->head->data.ptr_value))->val.str;
+  if (root->kind == AEXPR_IN) {
+    return InListTransform(root, name);
+  }
   if ((root->kind) != AEXPR_DISTINCT) {
     target_type = StringToExpressionType(std::string(name));
   } else {
@@ -732,6 +773,32 @@ expression::AbstractExpression *PostgresParser::AExprTransform(A_Expr *root) {
   return result;
 }
 
+// This function takes in the Postgres A_Expr of "expr [NOT] IN (list)" and
+// transfers it into a COMPARE_IN expression, negated for NOT IN.
+expression::AbstractExpression *PostgresParser::InListTransform(
+    A_Expr *root, const char *name) {
+  std::unique_ptr<expression::AbstractExpression> value{
+      ExprTransform(root->lexpr)};
+  std::vector<std::unique_ptr<expression::AbstractExpression>> list;
+  auto *items = reinterpret_cast<List *>(root->rexpr);
+  for (auto cell = items->head; cell != nullptr; cell = cell->next) {
+    list.emplace_back(
+        ExprTransform(reinterpret_cast<Node *>(cell->data.ptr_value)));
+  }
+
+  std::vector<expression::AbstractExpression *> raw_list;
+  for (auto &item : list) {
+    raw_list.push_back(item.release());
+  }
+  expression::AbstractExpression *result =
+      new expression::ComparisonExpression(value.release(), raw_list);
+  if (std::string(name) == "<>") {
+    result = new expression::OperatorExpression(
+        ExpressionType::OPERATOR_NOT, type::TypeId::BOOLEAN, result, nullptr);
+  }
+  return result;
+}
+
 expression::AbstractExpression* PostgresParser::SubqueryExprTransform(SubLink *node) {
   if (node == nullptr) {
     return nullptr;
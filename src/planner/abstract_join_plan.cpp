@@ -31,6 +31,12 @@ void AbstractJoinPlan::PerformBinding(BindingContext &context) {
   children[0]->PerformBinding(left_context);
   children[1]->PerformBinding(right_context);
 
+  BindInputs(context, left_context, right_context);
+}
+
+void AbstractJoinPlan::BindInputs(BindingContext &context,
+                                  BindingContext &left_context,
+                                  BindingContext &right_context) {
   HandleSubplanBinding(/*is_left*/ true, left_context);
   HandleSubplanBinding(/*is_left*/ false, right_context);
 
@@ -54,6 +54,22 @@ const std::string AbstractPlan::GetInfo() const {
   return os.str();
 }
 
+std::unique_ptr<AbstractPlan> AbstractPlan::CopyTree() const {
+  auto plan = Copy();
+  if (plan == nullptr) {
+    return nullptr;
+  }
+  plan->SetCardinality(GetCardinality());
+  for (const auto &child : GetChildren()) {
+    auto child_copy = child->CopyTree();
+    if (child_copy == nullptr) {
+      return nullptr;
+    }
+    plan->AddChild(std::move(child_copy));
+  }
+  return plan;
+}
+
 void AbstractPlan::SetParameterValues(std::vector<type::Value> *values) {
   LOG_TRACE("Setting parameter values in all child plans of %s",
             GetInfo().c_str());
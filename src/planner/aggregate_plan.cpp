@@ -21,8 +21,11 @@ namespace planner {
 
 AggregatePlan::AggTerm::AggTerm(ExpressionType et,
                                 expression::AbstractExpression *expr,
-                                bool distinct)
-    : aggtype(et), expression(expr), distinct(distinct) {}
+                                bool distinct, double percentile)
+    : aggtype(et),
+      expression(expr),
+      distinct(distinct),
+      percentile(percentile) {}
 
 void AggregatePlan::AggTerm::PerformBinding(BindingContext &binding_context) {
   // If there's an input expression, first perform binding
@@ -34,8 +37,10 @@ void AggregatePlan::AggTerm::PerformBinding(BindingContext &binding_context) {
   // Setup the aggregate's return type
   switch (aggtype) {
     case ExpressionType::AGGREGATE_COUNT:
-    case ExpressionType::AGGREGATE_COUNT_STAR: {
-      // The SQL type of COUNT() or COUNT(*) is always a non-nullable BIGINT
+    case ExpressionType::AGGREGATE_COUNT_STAR:
+    case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT: {
+      // The SQL type of COUNT(), COUNT(*) or APPROX_COUNT_DISTINCT() is always
+      // a non-nullable BIGINT
       agg_ai.type = codegen::type::Type{codegen::type::BigInt::Instance()};
       break;
     }
@@ -50,6 +55,14 @@ void AggregatePlan::AggTerm::PerformBinding(BindingContext &binding_context) {
                                         input_type.nullable};
       break;
     }
+    case ExpressionType::AGGREGATE_APPROX_PERCENTILE: {
+      // The percentile is a SQL DECIMAL that is NULL if there were no non-NULL
+      // input values
+      PL_ASSERT(expression != nullptr);
+      agg_ai.type = codegen::type::Type{codegen::type::Decimal::Instance(),
+                                        true};
+      break;
+    }
     case ExpressionType::AGGREGATE_MAX:
     case ExpressionType::AGGREGATE_MIN:
     case ExpressionType::AGGREGATE_SUM: {
@@ -67,7 +80,9 @@ void AggregatePlan::AggTerm::PerformBinding(BindingContext &binding_context) {
 }
 
 AggregatePlan::AggTerm AggregatePlan::AggTerm::Copy() const {
-  return AggTerm(aggtype, expression->Copy(), distinct);
+  return AggTerm(aggtype,
+                 expression != nullptr ? expression->Copy() : nullptr,
+                 distinct, percentile);
 }
 
 void AggregatePlan::PerformBinding(BindingContext &binding_context) {
@@ -132,6 +147,8 @@ hash_t AggregatePlan::Hash(
       hash = HashUtil::CombineHashes(hash, agg_term.expression->Hash());
 
     hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&agg_term.distinct));
+
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&agg_term.percentile));
   }
   return hash;
 }
@@ -179,6 +196,9 @@ bool AggregatePlan::AreEqual(
 
     if (A[i].distinct != B[i].distinct)
       return false;
+
+    if (A[i].percentile != B[i].percentile)
+      return false;
   }
   return true;
 }
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_plan.cpp
+//
+// Identification: src/planner/merge_join_plan.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "planner/merge_join_plan.h"
+
+namespace peloton {
+namespace planner {
+
+void MergeJoinPlan::HandleSubplanBinding(bool from_left,
+                                         const BindingContext &input) {
+  // Like in the join predicate, the right side of a clause refers to the
+  // right child as the second tuple
+  std::vector<const BindingContext *> contexts = {&input};
+  if (!from_left) {
+    contexts.insert(contexts.begin(), nullptr);
+  }
+  for (auto &join_clause : join_clauses_) {
+    auto &exp = from_left ? join_clause.left_ : join_clause.right_;
+    const_cast<expression::AbstractExpression *>(exp.get())
+        ->PerformBinding(contexts);
+  }
+}
+
+hash_t MergeJoinPlan::Hash() const {
+  hash_t hash = AbstractJoinPlan::Hash();
+
+  for (const auto &join_clause : join_clauses_) {
+    hash = HashUtil::CombineHashes(hash, join_clause.left_->Hash());
+    hash = HashUtil::CombineHashes(hash, join_clause.right_->Hash());
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&join_clause.reversed_));
+  }
+
+  return HashUtil::CombineHashes(hash, AbstractPlan::Hash());
+}
+
+bool MergeJoinPlan::operator==(const AbstractPlan &rhs) const {
+  if (!AbstractJoinPlan::operator==(rhs)) {
+    return false;
+  }
+
+  const auto &other = static_cast<const MergeJoinPlan &>(rhs);
+  const auto &other_clauses = *other.GetJoinClauses();
+  if (join_clauses_.size() != other_clauses.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < join_clauses_.size(); i++) {
+    if (*join_clauses_[i].left_ != *other_clauses[i].left_ ||
+        *join_clauses_[i].right_ != *other_clauses[i].right_ ||
+        join_clauses_[i].reversed_ != other_clauses[i].reversed_) {
+      return false;
+    }
+  }
+
+  return AbstractPlan::operator==(rhs);
+}
+
+}  // namespace planner
+}  // namespace peloton
@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// nested_loop_index_join_plan.cpp
+//
+// Identification: src/planner/nested_loop_index_join_plan.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "planner/nested_loop_index_join_plan.h"
+
+#include "index/index.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace planner {
+
+NestedLoopIndexJoinPlan::NestedLoopIndexJoinPlan(
+    JoinType join_type,
+    std::unique_ptr<const expression::AbstractExpression> &&predicate,
+    std::unique_ptr<const ProjectInfo> &&proj_info,
+    std::shared_ptr<const catalog::Schema> &proj_schema,
+    const std::vector<oid_t> &join_column_ids_left,
+    storage::DataTable *inner_table, std::shared_ptr<index::Index> index,
+    const std::vector<oid_t> &inner_column_ids,
+    std::unique_ptr<const expression::AbstractExpression> &&inner_predicate,
+    bool is_for_update)
+    : AbstractJoinPlan(join_type, std::move(predicate), std::move(proj_info),
+                       proj_schema),
+      join_column_ids_left_(join_column_ids_left),
+      inner_table_(inner_table),
+      index_(index),
+      inner_column_ids_(inner_column_ids),
+      inner_predicate_(std::move(inner_predicate)),
+      is_for_update_(is_for_update) {}
+
+void NestedLoopIndexJoinPlan::PerformBinding(BindingContext &binding_context) {
+  PL_ASSERT(GetChildrenSize() == 1);
+
+  // Let the outer child bind its attributes
+  BindingContext left_context;
+  GetChildren()[0]->PerformBinding(left_context);
+
+  // The inner table is not produced by a child, bind its columns the way a
+  // scan of the table does
+  const auto *schema = inner_table_->GetSchema();
+  inner_attributes_.clear();
+  for (oid_t col_id = 0; col_id < schema->GetColumnCount(); col_id++) {
+    const auto column = schema->GetColumn(col_id);
+    bool nullable = schema->AllowNull(col_id);
+    auto type = codegen::type::Type{column.GetType(), nullable};
+    inner_attributes_.push_back(AttributeInfo{type, col_id, column.GetName()});
+  }
+  BindingContext right_context;
+  for (oid_t col_id = 0; col_id < inner_column_ids_.size(); col_id++) {
+    const auto &ai = inner_attributes_[inner_column_ids_[col_id]];
+    right_context.BindNew(col_id, &ai);
+  }
+
+  // The inner predicate may use any column of the inner table
+  if (inner_predicate_ != nullptr) {
+    BindingContext all_cols_context;
+    for (oid_t col_id = 0; col_id < schema->GetColumnCount(); col_id++) {
+      all_cols_context.BindNew(col_id, &inner_attributes_[col_id]);
+    }
+    const_cast<expression::AbstractExpression *>(inner_predicate_.get())
+        ->PerformBinding({&all_cols_context});
+  }
+
+  BindInputs(binding_context, left_context, right_context);
+}
+
+void NestedLoopIndexJoinPlan::HandleSubplanBinding(bool from_left,
+                                                   const BindingContext &ctx) {
+  // The inner side is accessed through the index, only the key of the outer
+  // side has to be bound
+  if (from_left) {
+    for (const auto left_col_id : join_column_ids_left_) {
+      const auto *ai = ctx.Find(left_col_id);
+      PL_ASSERT(ai != nullptr);
+      join_ais_left_.push_back(ai);
+    }
+  }
+}
+
+std::unique_ptr<AbstractPlan> NestedLoopIndexJoinPlan::Copy() const {
+  std::unique_ptr<const expression::AbstractExpression> predicate_copy(
+      GetPredicate() != nullptr ? GetPredicate()->Copy() : nullptr);
+
+  std::shared_ptr<const catalog::Schema> schema_copy(
+      catalog::Schema::CopySchema(GetSchema()));
+
+  std::unique_ptr<const expression::AbstractExpression> inner_predicate_copy(
+      inner_predicate_ != nullptr ? inner_predicate_->Copy() : nullptr);
+
+  NestedLoopIndexJoinPlan *new_plan = new NestedLoopIndexJoinPlan(
+      GetJoinType(), std::move(predicate_copy), GetProjInfo()->Copy(),
+      schema_copy, join_column_ids_left_, inner_table_, index_,
+      inner_column_ids_, std::move(inner_predicate_copy), is_for_update_);
+
+  return std::unique_ptr<AbstractPlan>(new_plan);
+}
+
+hash_t NestedLoopIndexJoinPlan::Hash() const {
+  hash_t hash = AbstractJoinPlan::Hash();
+
+  for (const auto &left_col_id : GetJoinColumnsLeft()) {
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&left_col_id));
+  }
+
+  hash = HashUtil::CombineHashes(hash, inner_table_->Hash());
+  auto index_oid = index_->GetOid();
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&index_oid));
+  if (inner_predicate_ != nullptr) {
+    hash = HashUtil::CombineHashes(hash, inner_predicate_->Hash());
+  }
+  for (const auto &column_id : inner_column_ids_) {
+    hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&column_id));
+  }
+  hash = HashUtil::CombineHashes(hash, HashUtil::Hash(&is_for_update_));
+
+  return HashUtil::CombineHashes(hash, AbstractPlan::Hash());
+}
+
+bool NestedLoopIndexJoinPlan::operator==(const AbstractPlan &rhs) const {
+  if (!AbstractJoinPlan::operator==(rhs)) {
+    return false;
+  }
+
+  const auto &other = static_cast<const NestedLoopIndexJoinPlan &>(rhs);
+  if (GetJoinColumnsLeft() != other.GetJoinColumnsLeft()) {
+    return false;
+  }
+
+  if (*inner_table_ != *other.inner_table_ ||
+      index_->GetOid() != other.index_->GetOid() ||
+      inner_column_ids_ != other.inner_column_ids_ ||
+      is_for_update_ != other.is_for_update_) {
+    return false;
+  }
+
+  auto *pred = GetInnerPredicate();
+  auto *other_pred = other.GetInnerPredicate();
+  if ((pred == nullptr) != (other_pred == nullptr) ||
+      (pred != nullptr && *pred != *other_pred)) {
+    return false;
+  }
+
+  return AbstractPlan::operator==(rhs);
+}
+
+void NestedLoopIndexJoinPlan::VisitParameters(
+    codegen::QueryParametersMap &map, std::vector<peloton::type::Value> &values,
+    const std::vector<peloton::type::Value> &values_from_user) {
+  AbstractJoinPlan::VisitParameters(map, values, values_from_user);
+
+  // The predicate of the inner table is evaluated by the join
+  auto *inner_predicate =
+      const_cast<expression::AbstractExpression *>(inner_predicate_.get());
+  if (inner_predicate != nullptr) {
+    inner_predicate->VisitParameters(map, values, values_from_user);
+  }
+}
+
+}  // namespace planner
+}  // namespace peloton
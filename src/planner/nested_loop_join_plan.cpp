@@ -50,7 +50,7 @@ void NestedLoopJoinPlan::HandleSubplanBinding(bool from_left,
 
 std::unique_ptr<AbstractPlan> NestedLoopJoinPlan::Copy() const {
   std::unique_ptr<const expression::AbstractExpression> predicate_copy(
-      GetPredicate()->Copy());
+      GetPredicate() != nullptr ? GetPredicate()->Copy() : nullptr);
 
   std::shared_ptr<const catalog::Schema> schema_copy(
       catalog::Schema::CopySchema(GetSchema()));
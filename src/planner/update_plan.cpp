@@ -54,6 +54,8 @@ void UpdatePlan::PerformBinding(BindingContext &binding_context) {
 
   auto *scan = static_cast<planner::AbstractScan *>(children[0].get());
   auto &col_ids = scan->GetColumnIds();
+  // Plans are bound again on every execution
+  ais_.clear();
   for (oid_t col_id = 0; col_id < col_ids.size(); col_id++) {
     ais_.push_back(input_context.Find(col_id));
   }
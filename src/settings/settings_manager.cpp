@@ -50,6 +50,10 @@ void SettingsManager::SetInt(SettingId id, int32_t value) {
   GetInstance().SetValue(id, type::ValueFactory::GetIntegerValue(value));
 }
 
+void SettingsManager::SetDouble(SettingId id, double value) {
+  GetInstance().SetValue(id, type::ValueFactory::GetDecimalValue(value));
+}
+
 void SettingsManager::SetBool(SettingId id, bool value) {
   GetInstance().SetValue(id, type::ValueFactory::GetBooleanValue(value));
 }
@@ -101,6 +105,7 @@ const std::string SettingsManager::GetInfo() const {
   info.append(StringUtil::Format("%28s:   %-28i\n", "Max Connections", GetInt(SettingId::max_connections)));
   info.append(StringUtil::Format("%28s:   %-28s\n", "Index Tuner", GetBool(SettingId::index_tuner) ? "enabled" : "disabled"));
   info.append(StringUtil::Format("%28s:   %-28s\n", "Layout Tuner", GetBool(SettingId::layout_tuner) ? "enabled" : "disabled"));
+  info.append(StringUtil::Format("%28s:   %-28s\n", "Tiering Tuner", GetBool(SettingId::tiering_tuner) ? "enabled" : "disabled"));
   info.append(StringUtil::Format("%28s:   %-28s\n", "Code-generation", GetBool(SettingId::codegen) ? "enabled" : "disabled"));
 
   return StringBoxUtil::Box(info);
@@ -0,0 +1,513 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_column.cpp
+//
+// Identification: src/storage/compressed_column.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/compressed_column.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "storage/tile.h"
+#include "type/limits.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Bit-packed array
+//===--------------------------------------------------------------------===//
+
+BitPackedArray::BitPackedArray(uint32_t bit_width, oid_t num_elements)
+    : bit_width_(bit_width), num_elements_(num_elements) {
+  PL_ASSERT(bit_width <= 64);
+  mask_ = (bit_width_ == 64) ? ~0ull : ((1ull << bit_width_) - 1);
+  uint64_t num_bits = static_cast<uint64_t>(bit_width_) * num_elements_;
+  words_.resize((num_bits + 63) / 64 + 1, 0);
+}
+
+void BitPackedArray::Set(oid_t idx, uint64_t val) {
+  PL_ASSERT(idx < num_elements_);
+  PL_ASSERT((val & ~mask_) == 0);
+  if (bit_width_ == 0) {
+    return;
+  }
+  uint64_t bit_pos = static_cast<uint64_t>(idx) * bit_width_;
+  uint64_t word_idx = bit_pos >> 6;
+  uint32_t shift = bit_pos & 63;
+  words_[word_idx] &= ~(mask_ << shift);
+  words_[word_idx] |= val << shift;
+  if (shift + bit_width_ > 64) {
+    uint32_t spill = 64 - shift;
+    words_[word_idx + 1] &= ~(mask_ >> spill);
+    words_[word_idx + 1] |= val >> spill;
+  }
+}
+
+uint32_t BitPackedArray::BitsRequired(uint64_t max_value) {
+  if (max_value == 0) {
+    return 0;
+  }
+  return 64 - __builtin_clzll(max_value);
+}
+
+//===--------------------------------------------------------------------===//
+// Helpers
+//===--------------------------------------------------------------------===//
+
+namespace {
+
+// Read the fixed-length slot at the given location as a sign-extended word
+uint64_t ReadIntegralWord(const char *location, size_t fixed_length) {
+  switch (fixed_length) {
+    case 1:
+      return static_cast<uint64_t>(
+          static_cast<int64_t>(*reinterpret_cast<const int8_t *>(location)));
+    case 2:
+      return static_cast<uint64_t>(
+          static_cast<int64_t>(*reinterpret_cast<const int16_t *>(location)));
+    case 4:
+      return static_cast<uint64_t>(
+          static_cast<int64_t>(*reinterpret_cast<const int32_t *>(location)));
+    case 8:
+      return *reinterpret_cast<const uint64_t *>(location);
+    default:
+      throw Exception("Unsupported fixed length for integral column: " +
+                      std::to_string(fixed_length));
+  }
+}
+
+// The NULL sentinel word of an integral type
+uint64_t NullWord(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::BOOLEAN:
+      return static_cast<uint64_t>(
+          static_cast<int64_t>(type::PELOTON_BOOLEAN_NULL));
+    case type::TypeId::TINYINT:
+      return static_cast<uint64_t>(
+          static_cast<int64_t>(type::PELOTON_INT8_NULL));
+    case type::TypeId::SMALLINT:
+      return static_cast<uint64_t>(
+          static_cast<int64_t>(type::PELOTON_INT16_NULL));
+    case type::TypeId::INTEGER:
+      return static_cast<uint64_t>(
+          static_cast<int64_t>(type::PELOTON_INT32_NULL));
+    case type::TypeId::DATE:
+      return static_cast<uint64_t>(
+          static_cast<int64_t>(type::PELOTON_DATE_NULL));
+    case type::TypeId::BIGINT:
+      return static_cast<uint64_t>(type::PELOTON_INT64_NULL);
+    case type::TypeId::TIMESTAMP:
+      return type::PELOTON_TIMESTAMP_NULL;
+    default:
+      throw Exception("No NULL word for type " + TypeIdToString(type_id));
+  }
+}
+
+template <typename T>
+bool CompareWith(ExpressionType comparison, T lhs, T rhs) {
+  switch (comparison) {
+    case ExpressionType::COMPARE_EQUAL:
+      return lhs == rhs;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return lhs != rhs;
+    case ExpressionType::COMPARE_LESSTHAN:
+      return lhs < rhs;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return lhs <= rhs;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return lhs > rhs;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return lhs >= rhs;
+    default:
+      throw Exception("Unsupported comparison on compressed column: " +
+                      ExpressionTypeToString(comparison));
+  }
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Compressed Column
+//===--------------------------------------------------------------------===//
+
+CompressedColumn::CompressedColumn(type::TypeId value_type, bool is_inlined,
+                                   size_t fixed_length, oid_t tuple_count)
+    : value_type_(value_type),
+      is_inlined_(is_inlined),
+      interned_(false),
+      fixed_length_(fixed_length),
+      tuple_count_(tuple_count),
+      uncompressed_size_(0),
+      encoding_type_(ColumnEncodingType::INVALID),
+      base_(0) {}
+
+bool CompressedColumn::IsIntegral() const {
+  switch (value_type_) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DATE:
+    case type::TypeId::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::unique_ptr<CompressedColumn> CompressedColumn::Compress(
+    const Tile &tile, oid_t column_id, oid_t tuple_count) {
+  const catalog::Schema *schema = tile.GetSchema();
+  type::TypeId value_type = schema->GetType(column_id);
+  bool is_varlen = (value_type == type::TypeId::VARCHAR ||
+                    value_type == type::TypeId::VARBINARY);
+  size_t fixed_length = is_varlen ? sizeof(char *) : schema->GetLength(column_id);
+
+  // We only know how to handle slots that fit in a word
+  if (fixed_length > sizeof(uint64_t) || value_type == type::TypeId::ARRAY) {
+    LOG_DEBUG("Column %u of type %s cannot be compressed", column_id,
+              TypeIdToString(value_type).c_str());
+    return nullptr;
+  }
+
+  std::unique_ptr<CompressedColumn> column(new CompressedColumn(
+      value_type, schema->IsInlined(column_id), fixed_length, tuple_count));
+  column->interned_ = (tile.GetColumnDictionary(column_id) != nullptr);
+
+  // Collect the slot words of the column
+  size_t column_offset = schema->GetOffset(column_id);
+  std::vector<uint64_t> words(tuple_count);
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    const char *location =
+        tile.GetTupleLocation(tuple_itr) + column_offset;
+    if (column->IsIntegral()) {
+      words[tuple_itr] = ReadIntegralWord(location, fixed_length);
+    } else {
+      uint64_t word = 0;
+      PL_MEMCPY(&word, location, fixed_length);
+      words[tuple_itr] = word;
+    }
+  }
+
+  column->uncompressed_size_ = tuple_count * fixed_length;
+
+  if (is_varlen || !column->IsIntegral()) {
+    column->EncodeDictionary(words);
+    return column;
+  }
+
+  // Pick the smallest encoding for integral columns
+  std::vector<uint64_t> sorted_words(words);
+  std::sort(sorted_words.begin(), sorted_words.end());
+  size_t num_distinct =
+      std::unique(sorted_words.begin(), sorted_words.end()) -
+      sorted_words.begin();
+
+  size_t num_runs = (tuple_count == 0) ? 0 : 1;
+  for (oid_t tuple_itr = 1; tuple_itr < tuple_count; tuple_itr++) {
+    if (words[tuple_itr] != words[tuple_itr - 1]) num_runs++;
+  }
+
+  int64_t min = 0, max = 0;
+  if (tuple_count > 0) {
+    auto bounds = std::minmax_element(
+        words.begin(), words.end(), [](uint64_t a, uint64_t b) {
+          return static_cast<int64_t>(a) < static_cast<int64_t>(b);
+        });
+    min = static_cast<int64_t>(*bounds.first);
+    max = static_cast<int64_t>(*bounds.second);
+  }
+
+  uint64_t for_bits = BitPackedArray::BitsRequired(
+      static_cast<uint64_t>(max) - static_cast<uint64_t>(min));
+  size_t for_size = (for_bits * tuple_count + 7) / 8;
+  size_t rle_size = num_runs * (sizeof(uint64_t) + sizeof(oid_t));
+  size_t dict_bits =
+      BitPackedArray::BitsRequired(num_distinct > 0 ? num_distinct - 1 : 0);
+  size_t dict_size =
+      num_distinct * sizeof(uint64_t) + (dict_bits * tuple_count + 7) / 8;
+
+  if (rle_size <= for_size && rle_size <= dict_size) {
+    column->EncodeRunLength(words);
+  } else if (for_size <= dict_size) {
+    column->EncodeFrameOfReference(words);
+  } else {
+    column->EncodeDictionary(words);
+  }
+  return column;
+}
+
+void CompressedColumn::EncodeDictionary(const std::vector<uint64_t> &words) {
+  encoding_type_ = ColumnEncodingType::DICTIONARY;
+
+  std::vector<uint32_t> codes(words.size());
+
+  if ((value_type_ == type::TypeId::VARCHAR ||
+       value_type_ == type::TypeId::VARBINARY) &&
+      !interned_) {
+    // Deduplicate on content. The NULL pointer gets its own entry.
+    std::map<std::string, uint32_t> distinct;
+    bool has_null = false;
+    for (uint64_t word : words) {
+      const char *blob = reinterpret_cast<const char *>(word);
+      if (blob == nullptr) {
+        has_null = true;
+        continue;
+      }
+      uint32_t len = *reinterpret_cast<const uint32_t *>(blob);
+      uncompressed_size_ += len + sizeof(uint32_t);
+      distinct.emplace(std::string(blob + sizeof(uint32_t), len), 0);
+    }
+
+    // Lay out all blobs contiguously in [length | bytes] format
+    size_t total_size = 0;
+    for (auto &entry : distinct) {
+      total_size += sizeof(uint32_t) + entry.first.size();
+    }
+    varlen_data_.resize(total_size);
+
+    uint32_t code = 0;
+    if (has_null) {
+      dictionary_.push_back(0);
+      code++;
+    }
+    size_t offset = 0;
+    for (auto &entry : distinct) {
+      uint32_t len = entry.first.size();
+      char *blob = varlen_data_.data() + offset;
+      PL_MEMCPY(blob, &len, sizeof(uint32_t));
+      PL_MEMCPY(blob + sizeof(uint32_t), entry.first.data(), len);
+      dictionary_.push_back(reinterpret_cast<uint64_t>(blob));
+      entry.second = code++;
+      offset += sizeof(uint32_t) + len;
+    }
+
+    for (oid_t tuple_itr = 0; tuple_itr < words.size(); tuple_itr++) {
+      const char *blob = reinterpret_cast<const char *>(words[tuple_itr]);
+      if (blob == nullptr) {
+        codes[tuple_itr] = 0;
+      } else {
+        uint32_t len = *reinterpret_cast<const uint32_t *>(blob);
+        codes[tuple_itr] =
+            distinct.at(std::string(blob + sizeof(uint32_t), len));
+      }
+    }
+  } else {
+    dictionary_ = words;
+    std::sort(dictionary_.begin(), dictionary_.end());
+    dictionary_.erase(std::unique(dictionary_.begin(), dictionary_.end()),
+                      dictionary_.end());
+    for (oid_t tuple_itr = 0; tuple_itr < words.size(); tuple_itr++) {
+      codes[tuple_itr] = std::lower_bound(dictionary_.begin(),
+                                          dictionary_.end(),
+                                          words[tuple_itr]) -
+                         dictionary_.begin();
+    }
+  }
+
+  uint32_t bit_width = BitPackedArray::BitsRequired(
+      dictionary_.empty() ? 0 : dictionary_.size() - 1);
+  codes_ = BitPackedArray(bit_width, words.size());
+  for (oid_t tuple_itr = 0; tuple_itr < words.size(); tuple_itr++) {
+    codes_.Set(tuple_itr, codes[tuple_itr]);
+  }
+}
+
+void CompressedColumn::EncodeRunLength(const std::vector<uint64_t> &words) {
+  encoding_type_ = ColumnEncodingType::RUN_LENGTH;
+  for (oid_t tuple_itr = 0; tuple_itr < words.size(); tuple_itr++) {
+    if (run_words_.empty() || run_words_.back() != words[tuple_itr]) {
+      run_words_.push_back(words[tuple_itr]);
+      run_ends_.push_back(tuple_itr + 1);
+    } else {
+      run_ends_.back() = tuple_itr + 1;
+    }
+  }
+}
+
+void CompressedColumn::EncodeFrameOfReference(
+    const std::vector<uint64_t> &words) {
+  encoding_type_ = ColumnEncodingType::FRAME_OF_REFERENCE;
+  base_ = words.empty() ? 0 : static_cast<int64_t>(words[0]);
+  uint64_t max_delta = 0;
+  for (uint64_t word : words) {
+    base_ = std::min(base_, static_cast<int64_t>(word));
+  }
+  for (uint64_t word : words) {
+    max_delta = std::max(max_delta, word - static_cast<uint64_t>(base_));
+  }
+  deltas_ = BitPackedArray(BitPackedArray::BitsRequired(max_delta),
+                           words.size());
+  for (oid_t tuple_itr = 0; tuple_itr < words.size(); tuple_itr++) {
+    deltas_.Set(tuple_itr, words[tuple_itr] - static_cast<uint64_t>(base_));
+  }
+}
+
+uint64_t CompressedColumn::GetWord(oid_t tuple_offset) const {
+  PL_ASSERT(tuple_offset < tuple_count_);
+  switch (encoding_type_) {
+    case ColumnEncodingType::DICTIONARY:
+      return dictionary_[codes_.Get(tuple_offset)];
+    case ColumnEncodingType::RUN_LENGTH: {
+      auto run = std::upper_bound(run_ends_.begin(), run_ends_.end(),
+                                  tuple_offset) -
+                 run_ends_.begin();
+      return run_words_[run];
+    }
+    case ColumnEncodingType::FRAME_OF_REFERENCE:
+      return static_cast<uint64_t>(base_) + deltas_.Get(tuple_offset);
+    default:
+      throw Exception("Invalid column encoding " +
+                      ColumnEncodingTypeToString(encoding_type_));
+  }
+}
+
+void CompressedColumn::Decode(oid_t tuple_offset, char *storage) const {
+  uint64_t word = GetWord(tuple_offset);
+  // Slots are little-endian, so the low bytes of the word are the slot
+  PL_MEMCPY(storage, &word, fixed_length_);
+}
+
+type::Value CompressedColumn::WordToValue(uint64_t word) const {
+  return type::Value::DeserializeFrom(reinterpret_cast<const char *>(&word),
+                                      value_type_, is_inlined_);
+}
+
+type::Value CompressedColumn::GetValue(oid_t tuple_offset) const {
+  return WordToValue(GetWord(tuple_offset));
+}
+
+bool CompressedColumn::Evaluate(ExpressionType comparison,
+                                const type::Value &constant,
+                                uint64_t word) const {
+  type::Value value = WordToValue(word);
+  CmpBool result;
+  switch (comparison) {
+    case ExpressionType::COMPARE_EQUAL:
+      result = value.CompareEquals(constant);
+      break;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      result = value.CompareNotEquals(constant);
+      break;
+    case ExpressionType::COMPARE_LESSTHAN:
+      result = value.CompareLessThan(constant);
+      break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      result = value.CompareLessThanEquals(constant);
+      break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      result = value.CompareGreaterThan(constant);
+      break;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      result = value.CompareGreaterThanEquals(constant);
+      break;
+    default:
+      throw Exception("Unsupported comparison on compressed column: " +
+                      ExpressionTypeToString(comparison));
+  }
+  return result == CmpBool::TRUE;
+}
+
+void CompressedColumn::Filter(ExpressionType comparison,
+                              const type::Value &constant,
+                              std::vector<oid_t> &positions) const {
+  // Nothing compares true against NULL
+  if (constant.IsNull()) {
+    positions.clear();
+    return;
+  }
+
+  size_t num_matched = 0;
+  switch (encoding_type_) {
+    case ColumnEncodingType::DICTIONARY: {
+      // Evaluate the predicate once per dictionary entry
+      std::vector<bool> matches(dictionary_.size());
+      for (size_t code = 0; code < dictionary_.size(); code++) {
+        matches[code] = Evaluate(comparison, constant, dictionary_[code]);
+      }
+      for (oid_t position : positions) {
+        if (matches[codes_.Get(position)]) {
+          positions[num_matched++] = position;
+        }
+      }
+      break;
+    }
+    case ColumnEncodingType::RUN_LENGTH: {
+      // Evaluate the predicate once per run the positions touch
+      size_t run = 0;
+      bool run_matches = false;
+      size_t evaluated_run = run_ends_.size();
+      for (oid_t position : positions) {
+        while (run_ends_[run] <= position) run++;
+        if (run != evaluated_run) {
+          run_matches = Evaluate(comparison, constant, run_words_[run]);
+          evaluated_run = run;
+        }
+        if (run_matches) {
+          positions[num_matched++] = position;
+        }
+      }
+      break;
+    }
+    case ColumnEncodingType::FRAME_OF_REFERENCE: {
+      if (constant.GetTypeId() == value_type_ &&
+          value_type_ != type::TypeId::TIMESTAMP) {
+        // Compare as signed integers without materializing values
+        char storage[sizeof(uint64_t)] = {0};
+        constant.SerializeTo(storage, true, nullptr);
+        int64_t rhs =
+            static_cast<int64_t>(ReadIntegralWord(storage, fixed_length_));
+        uint64_t null_word = NullWord(value_type_);
+        for (oid_t position : positions) {
+          uint64_t word = static_cast<uint64_t>(base_) + deltas_.Get(position);
+          if (word != null_word &&
+              CompareWith(comparison, static_cast<int64_t>(word), rhs)) {
+            positions[num_matched++] = position;
+          }
+        }
+      } else {
+        for (oid_t position : positions) {
+          uint64_t word = static_cast<uint64_t>(base_) + deltas_.Get(position);
+          if (Evaluate(comparison, constant, word)) {
+            positions[num_matched++] = position;
+          }
+        }
+      }
+      break;
+    }
+    default:
+      throw Exception("Invalid column encoding " +
+                      ColumnEncodingTypeToString(encoding_type_));
+  }
+  positions.resize(num_matched);
+}
+
+size_t CompressedColumn::GetCompressedSize() const {
+  switch (encoding_type_) {
+    case ColumnEncodingType::DICTIONARY:
+      return dictionary_.size() * sizeof(uint64_t) + varlen_data_.size() +
+             codes_.GetSize();
+    case ColumnEncodingType::RUN_LENGTH:
+      return run_words_.size() * sizeof(uint64_t) +
+             run_ends_.size() * sizeof(oid_t);
+    case ColumnEncodingType::FRAME_OF_REFERENCE:
+      return sizeof(base_) + deltas_.GetSize();
+    default:
+      return 0;
+  }
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <mutex>
+#include <numeric>
 #include <utility>
 
 #include "brain/clusterer.h"
@@ -28,10 +30,12 @@
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
 #include "logging/log_manager.h"
+#include "settings/settings_manager.h"
 #include "storage/abstract_table.h"
 #include "storage/data_table.h"
 #include "storage/database.h"
 #include "storage/storage_manager.h"
+#include "storage/string_dictionary.h"
 #include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_factory.h"
@@ -237,10 +241,12 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
   auto &gc_manager = gc::GCManagerFactory::GetInstance();
   auto free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
   if (free_item_pointer.IsNull() == false) {
+    auto tile_group =
+        catalog::Manager::GetInstance().GetTileGroup(free_item_pointer.block);
+    // the slot may have been recycled before its tile group was frozen
+    tile_group->PrepareForWrite();
     // when inserting a tuple
     if (tuple != nullptr) {
-      auto tile_group =
-          catalog::Manager::GetInstance().GetTileGroup(free_item_pointer.block);
       tile_group->CopyTuple(tuple, free_item_pointer.offset);
     }
     return free_item_pointer;
@@ -257,6 +263,9 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
     // get the last tile group.
     tile_group = active_tile_groups_[active_tile_group_id];
 
+    // the tile group may fill up and get frozen while we write the tuple
+    tile_group->PrepareForWrite();
+
     tuple_slot = tile_group->InsertTuple(tuple);
 
     // now we have already obtained a new tuple slot.
@@ -282,6 +291,54 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
   return location;
 }
 
+void DataTable::GetEmptyTupleSlots(
+    const std::vector<const storage::Tuple *> &tuples,
+    std::vector<ItemPointer> &locations) {
+  locations.clear();
+  locations.reserve(tuples.size());
+
+  //=============== garbage collection==================
+  // fill recycled tuple slots first, until there are none left
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+  size_t tuple_itr = 0;
+  for (; tuple_itr < tuples.size(); tuple_itr++) {
+    auto free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
+    if (free_item_pointer.IsNull() == true) {
+      break;
+    }
+    auto tile_group =
+        catalog::Manager::GetInstance().GetTileGroup(free_item_pointer.block);
+    tile_group->PrepareForWrite();
+    tile_group->CopyTuple(tuples[tuple_itr], free_item_pointer.offset);
+    locations.push_back(free_item_pointer);
+  }
+  //====================================================
+
+  // claim the remaining slots as ranges of the active tile groups
+  size_t active_tile_group_id = number_of_tuples_ % active_tilegroup_count_;
+  while (tuple_itr < tuples.size()) {
+    auto tile_group = active_tile_groups_[active_tile_group_id];
+    tile_group->PrepareForWrite();
+
+    oid_t count = tuples.size() - tuple_itr;
+    oid_t first_slot = tile_group->InsertTuples(tuples, tuple_itr, count);
+    if (first_slot == INVALID_OID) {
+      continue;
+    }
+
+    // if we got the last tuple slot, then create a new tile group
+    if (first_slot + count == tile_group->GetAllocatedTupleCount()) {
+      AddDefaultTileGroup(active_tile_group_id);
+    }
+
+    oid_t tile_group_id = tile_group->GetTileGroupId();
+    for (oid_t slot_itr = 0; slot_itr < count; slot_itr++) {
+      locations.emplace_back(tile_group_id, first_slot + slot_itr);
+    }
+    tuple_itr += count;
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // INSERT
 //===--------------------------------------------------------------------===//
@@ -395,6 +452,56 @@ bool DataTable::InsertTuple(const AbstractTuple *tuple,
   return true;
 }
 
+bool DataTable::InsertTuples(const std::vector<const storage::Tuple *> &tuples,
+                             concurrency::TransactionContext *transaction,
+                             std::vector<ItemPointer> &locations,
+                             bool check_fk) {
+  locations.clear();
+
+  // Nothing gets claimed for a batch that is going to fail anyway
+  for (auto tuple : tuples) {
+    if (CheckConstraints(tuple) == false) {
+      LOG_TRACE("InsertTuples(): Constraint violated");
+      return false;
+    }
+  }
+
+  GetEmptyTupleSlots(tuples, locations);
+  PL_ASSERT(locations.size() == tuples.size());
+
+  // Register all versions before touching the indexes, so that both other
+  // transactions and the batch itself see them when checking uniqueness
+  auto index_count = GetIndexCount();
+  std::vector<ItemPointer *> index_entry_ptrs(tuples.size(), nullptr);
+  if (index_count > 0) {
+    for (size_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+      index_entry_ptrs[tuple_itr] = AllocateIndexEntry(locations[tuple_itr]);
+    }
+  }
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  transaction_manager.PerformInserts(transaction, locations, index_entry_ptrs);
+
+  if (index_count > 0 &&
+      InsertInIndexes(tuples, index_entry_ptrs, transaction) == false) {
+    LOG_TRACE("Index constraint violated");
+    return false;
+  }
+
+  if (check_fk) {
+    for (auto tuple : tuples) {
+      if (CheckForeignKeyConstraints(tuple, transaction) == false) {
+        LOG_TRACE("ForeignKey constraint violated");
+        return false;
+      }
+    }
+  }
+
+  IncreaseTupleCount(tuples.size());
+  return true;
+}
+
 // insert tuple into a table that is without index.
 ItemPointer DataTable::InsertTuple(const storage::Tuple *tuple) {
   ItemPointer location = GetEmptyTupleSlot(tuple);
@@ -412,25 +519,12 @@ ItemPointer DataTable::InsertTuple(const storage::Tuple *tuple) {
   return location;
 }
 
-/**
- * @brief Insert a tuple into all indexes. If index is primary/unique,
- * check visibility of existing
- * index entries.
- * @warning This still doesn't guarantee serializability.
- *
- * @returns True on success, false if a visible entry exists (in case of
- *primary/unique).
- */
-bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
-                                ItemPointer location,
-                                concurrency::TransactionContext *transaction,
-                                ItemPointer **index_entry_ptr) {
-  int index_count = GetIndexCount();
-
+ItemPointer *DataTable::AllocateIndexEntry(const ItemPointer &location) {
   size_t active_indirection_array_id =
       number_of_tuples_ % active_indirection_array_count_;
 
   size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
+  ItemPointer *index_entry_ptr = nullptr;
 
   while (true) {
     auto active_indirection_array =
@@ -438,18 +532,37 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
     indirection_offset = active_indirection_array->AllocateIndirection();
 
     if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
-      *index_entry_ptr =
+      index_entry_ptr =
           active_indirection_array->GetIndirectionByOffset(indirection_offset);
       break;
     }
   }
 
-  (*index_entry_ptr)->block = location.block;
-  (*index_entry_ptr)->offset = location.offset;
+  index_entry_ptr->block = location.block;
+  index_entry_ptr->offset = location.offset;
 
   if (indirection_offset == INDIRECTION_ARRAY_MAX_SIZE - 1) {
     AddDefaultIndirectionArray(active_indirection_array_id);
   }
+  return index_entry_ptr;
+}
+
+/**
+ * @brief Insert a tuple into all indexes. If index is primary/unique,
+ * check visibility of existing
+ * index entries.
+ * @warning This still doesn't guarantee serializability.
+ *
+ * @returns True on success, false if a visible entry exists (in case of
+ *primary/unique).
+ */
+bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
+                                ItemPointer location,
+                                concurrency::TransactionContext *transaction,
+                                ItemPointer **index_entry_ptr) {
+  int index_count = GetIndexCount();
+
+  *index_entry_ptr = AllocateIndexEntry(location);
 
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
@@ -501,6 +614,66 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
   return true;
 }
 
+bool DataTable::InsertInIndexes(
+    const std::vector<const storage::Tuple *> &tuples,
+    const std::vector<ItemPointer *> &index_entry_ptrs,
+    concurrency::TransactionContext *transaction) {
+  int index_count = GetIndexCount();
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  std::function<bool(const void *)> fn =
+      std::bind(&concurrency::TransactionManager::IsOccupied,
+                &transaction_manager, transaction, std::placeholders::_1);
+
+  std::vector<std::unique_ptr<storage::Tuple>> keys(tuples.size());
+  std::vector<size_t> key_order(tuples.size());
+
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+    if (index == nullptr) continue;
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+
+    for (size_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+      keys[tuple_itr].reset(new storage::Tuple(index_schema, true));
+      keys[tuple_itr]->SetFromTuple(tuples[tuple_itr], indexed_columns,
+                                    index->GetPool());
+    }
+
+    // Inserting in key order keeps consecutive inserts on the same index pages
+    std::iota(key_order.begin(), key_order.end(), 0);
+    std::sort(key_order.begin(), key_order.end(),
+              [&keys](const size_t &lhs, const size_t &rhs) {
+                return keys[lhs]->Compare(*keys[rhs]) < 0;
+              });
+
+    for (auto tuple_itr : key_order) {
+      switch (index->GetIndexType()) {
+        case IndexConstraintType::PRIMARY_KEY:
+        case IndexConstraintType::UNIQUE: {
+          // the versions of the batch are already registered, so duplicates
+          // within the batch are caught here as well
+          if (index->CondInsertEntry(keys[tuple_itr].get(),
+                                     index_entry_ptrs[tuple_itr],
+                                     fn) == false) {
+            return false;
+          }
+        } break;
+
+        case IndexConstraintType::DEFAULT:
+        default:
+          index->InsertEntry(keys[tuple_itr].get(),
+                             index_entry_ptrs[tuple_itr]);
+          break;
+      }
+    }
+    LOG_TRACE("Index constraint check on %s passed.", index->GetName().c_str());
+  }
+  return true;
+}
+
 bool DataTable::InsertInSecondaryIndexes(const AbstractTuple *tuple,
                                          const TargetList *targets_ptr,
                                          concurrency::TransactionContext *transaction,
@@ -877,8 +1050,10 @@ void DataTable::ResetDirty() { dirty_ = false; }
 TileGroup *DataTable::GetTileGroupWithLayout(
     const column_map_type &partitioning) {
   oid_t tile_group_id = catalog::Manager::GetInstance().GetNextTileGroupId();
-  return (AbstractTable::GetTileGroupWithLayout(
-      database_oid, tile_group_id, partitioning, tuples_per_tilegroup_));
+  TileGroup *tile_group = AbstractTable::GetTileGroupWithLayout(
+      database_oid, tile_group_id, partitioning, tuples_per_tilegroup_);
+  SetColumnDictionaries(tile_group);
+  return tile_group;
 }
 
 oid_t DataTable::AddDefaultIndirectionArray(
@@ -952,6 +1127,7 @@ void DataTable::AddTileGroupWithOidForRecovery(const oid_t &tile_group_id) {
   std::shared_ptr<TileGroup> tile_group(TileGroupFactory::GetTileGroup(
       database_oid, table_oid, tile_group_id, this, schemas, column_map,
       tuples_per_tilegroup_));
+  SetColumnDictionaries(tile_group.get());
 
   auto tile_groups_exists = tile_groups_.Contains(tile_group_id);
 
@@ -1306,6 +1482,7 @@ storage::TileGroup *DataTable::TransformTileGroup(
           tile_group->GetTileGroupId(), tile_group->GetAbstractTable(),
           new_schema, default_partition_,
           tile_group->GetAllocatedTupleCount()));
+  SetColumnDictionaries(new_tile_group.get());
 
   // Set the transformed tile group column-at-a-time
   SetTransformedTileGroup(tile_group.get(), new_tile_group.get());
@@ -1317,6 +1494,70 @@ storage::TileGroup *DataTable::TransformTileGroup(
   return new_tile_group.get();
 }
 
+//===--------------------------------------------------------------------===//
+// DICTIONARY ENCODING
+//===--------------------------------------------------------------------===//
+
+void DataTable::EnableDictionaryEncoding(const oid_t &column_id) {
+  PL_ASSERT(column_id < schema->GetColumnCount());
+  auto type_id = schema->GetType(column_id);
+  if ((type_id != type::TypeId::VARCHAR &&
+       type_id != type::TypeId::VARBINARY) ||
+      schema->IsInlined(column_id)) {
+    throw NotImplementedException(
+        "Only uninlined VARCHAR/VARBINARY columns can be dictionary-encoded");
+  }
+
+  std::lock_guard<std::mutex> lock(data_table_mutex_);
+  if (GetTupleCount() > 0) {
+    throw NotImplementedException(
+        "Cannot dictionary-encode a column of non-empty table " + table_name);
+  }
+  if (GetColumnDictionary(column_id) != nullptr) {
+    return;
+  }
+
+  if (column_dictionaries_.empty()) {
+    column_dictionaries_.resize(schema->GetColumnCount());
+  }
+  auto max_size = settings::SettingsManager::GetInt(
+      settings::SettingId::dictionary_max_size);
+  column_dictionaries_[column_id].reset(
+      new StringDictionary(static_cast<uint32_t>(std::max(max_size, 0))));
+
+  // The active tile groups were created before the column got encoded
+  size_t tile_group_count = tile_groups_.GetSize();
+  for (size_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = GetTileGroup(tile_group_itr);
+    if (tile_group != nullptr) {
+      tile_group->SetColumnDictionary(column_id,
+                                      column_dictionaries_[column_id]);
+    }
+  }
+
+  LOG_DEBUG("Dictionary-encoding column %u of table %s", column_id,
+            table_name.c_str());
+}
+
+StringDictionary *DataTable::GetColumnDictionary(
+    const oid_t &column_id) const {
+  if (column_id >= column_dictionaries_.size()) {
+    return nullptr;
+  }
+  return column_dictionaries_[column_id].get();
+}
+
+void DataTable::SetColumnDictionaries(TileGroup *tile_group) const {
+  for (oid_t column_itr = 0; column_itr < column_dictionaries_.size();
+       column_itr++) {
+    if (column_dictionaries_[column_itr] != nullptr) {
+      tile_group->SetColumnDictionary(column_itr,
+                                      column_dictionaries_[column_itr]);
+    }
+  }
+}
+
 void DataTable::RecordLayoutSample(const brain::Sample &sample) {
   // Add layout sample
   {
@@ -12,6 +12,7 @@
 
 #include <sstream>
 
+#include "brain/tiering_tuner.h"
 #include "catalog/foreign_key.h"
 #include "codegen/query_cache.h"
 #include "common/exception.h"
@@ -29,7 +30,9 @@ Database::Database(const oid_t database_oid) : database_oid(database_oid) {}
 Database::~Database() {
   // Clean up all the tables
   LOG_TRACE("Deleting tables from database");
+  auto &tiering_tuner = brain::TieringTuner::GetInstance();
   for (auto table : tables) {
+    tiering_tuner.RemoveTable(table);
     delete table;
   }
 
@@ -50,6 +53,10 @@ void Database::AddTable(storage::DataTable *table, bool is_catalog) {
       auto *gc_manager = &gc::GCManagerFactory::GetInstance();
       assert(gc_manager != nullptr);
       gc_manager->RegisterTable(table->GetOid());
+
+      // Register table to the tiering tuner, which moves its cold tile
+      // groups to the compressed tier
+      brain::TieringTuner::GetInstance().AddTable(table);
     }
   }
 }
@@ -90,6 +97,7 @@ void Database::DropTableWithOid(const oid_t table_oid) {
     oid_t table_offset = 0;
     for (auto table : tables) {
       if (table->GetOid() == table_oid) {
+        brain::TieringTuner::GetInstance().RemoveTable(table);
         delete table;
         break;
       }
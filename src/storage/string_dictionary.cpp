@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// string_dictionary.cpp
+//
+// Identification: src/storage/string_dictionary.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/string_dictionary.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "type/abstract_pool.h"
+#include "util/hash_util.h"
+
+namespace peloton {
+namespace storage {
+
+bool StringDictionary::Key::operator==(const Key &other) const {
+  return length == other.length &&
+         (length == 0 || std::memcmp(data, other.data, length) == 0);
+}
+
+size_t StringDictionary::KeyHasher::operator()(const Key &key) const {
+  return HashUtil::HashBytes(key.data, key.length);
+}
+
+constexpr uint32_t StringDictionary::kUnencodedCode;
+
+StringDictionary::StringDictionary(uint32_t max_size)
+    : max_size_(std::min(max_size, kUnencodedCode)),
+      current_block_(nullptr),
+      block_offset_(0),
+      memory_size_(0) {}
+
+const char *StringDictionary::FindLocked(const Key &key) const {
+  auto iter = index_.find(key);
+  return iter == index_.end() ? nullptr : iter->second;
+}
+
+const char *StringDictionary::Find(const char *data, uint32_t length) const {
+  latch_.ReadLock();
+  const char *varlen = FindLocked(Key{data, length});
+  latch_.Unlock();
+  return varlen;
+}
+
+char *StringDictionary::AllocateEntry(size_t size) {
+  // Keep the code and the length 4-byte aligned
+  size = (size + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+  memory_size_ += size;
+
+  // Large values get a block of their own
+  if (size > kBlockSize / 4) {
+    blocks_.emplace_back(new char[size]);
+    return blocks_.back().get();
+  }
+
+  if (current_block_ == nullptr || block_offset_ + size > kBlockSize) {
+    blocks_.emplace_back(new char[kBlockSize]);
+    current_block_ = blocks_.back().get();
+    block_offset_ = 0;
+  }
+  char *entry = current_block_ + block_offset_;
+  block_offset_ += size;
+  return entry;
+}
+
+const char *StringDictionary::Intern(const char *data, uint32_t length) {
+  Key key{data, length};
+
+  // Common case: the value is already in the dictionary
+  latch_.ReadLock();
+  const char *varlen = FindLocked(key);
+  latch_.Unlock();
+  if (varlen != nullptr) {
+    return varlen;
+  }
+
+  latch_.WriteLock();
+  varlen = FindLocked(key);
+  if (varlen == nullptr) {
+    if (entries_.size() >= max_size_) {
+      latch_.Unlock();
+      return nullptr;
+    }
+
+    uint32_t code = static_cast<uint32_t>(entries_.size());
+    char *entry = AllocateEntry(2 * sizeof(uint32_t) + length);
+    PL_MEMCPY(entry, &code, sizeof(uint32_t));
+    PL_MEMCPY(entry + sizeof(uint32_t), &length, sizeof(uint32_t));
+    PL_MEMCPY(entry + 2 * sizeof(uint32_t), data, length);
+
+    varlen = entry + sizeof(uint32_t);
+    entries_.push_back(varlen);
+    index_.emplace(Key{varlen + sizeof(uint32_t), length}, varlen);
+  }
+  latch_.Unlock();
+
+  return varlen;
+}
+
+const char *StringDictionary::CopyUnencoded(type::AbstractPool *pool,
+                                            const char *data,
+                                            uint32_t length) {
+  char *entry =
+      reinterpret_cast<char *>(pool->Allocate(2 * sizeof(uint32_t) + length));
+  uint32_t code = kUnencodedCode;
+  PL_MEMCPY(entry, &code, sizeof(uint32_t));
+  PL_MEMCPY(entry + sizeof(uint32_t), &length, sizeof(uint32_t));
+  PL_MEMCPY(entry + 2 * sizeof(uint32_t), data, length);
+  return entry + sizeof(uint32_t);
+}
+
+void StringDictionary::FreeUnencoded(type::AbstractPool *pool,
+                                     const char *varlen) {
+  PL_ASSERT(IsUnencoded(varlen));
+  pool->Free(const_cast<char *>(varlen - sizeof(uint32_t)));
+}
+
+const char *StringDictionary::GetVarlen(uint32_t code) const {
+  latch_.ReadLock();
+  PL_ASSERT(code < entries_.size());
+  const char *varlen = entries_[code];
+  latch_.Unlock();
+  return varlen;
+}
+
+uint32_t StringDictionary::GetSize() const {
+  latch_.ReadLock();
+  uint32_t size = static_cast<uint32_t>(entries_.size());
+  latch_.Unlock();
+  return size;
+}
+
+size_t StringDictionary::GetMemorySize() const {
+  latch_.ReadLock();
+  size_t size = memory_size_;
+  latch_.Unlock();
+  return size;
+}
+
+}  // namespace storage
+}  // namespace peloton
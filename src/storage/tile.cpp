@@ -15,10 +15,11 @@
 
 #include "catalog/schema.h"
 #include "common/exception.h"
+#include "common/logger.h"
 #include "common/macros.h"
 #include "type/serializer.h"
 #include "common/internal_types.h"
-#include "type/ephemeral_pool.h"
+#include "type/varlen_pool.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/backend_manager.h"
 #include "storage/tile.h"
@@ -31,7 +32,7 @@ namespace storage {
 
 Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
            const catalog::Schema &tuple_schema, TileGroup *tile_group,
-           int tuple_count)
+           int tuple_count, const std::shared_ptr<type::AbstractPool> &pool)
     : database_id(INVALID_OID),
       table_id(INVALID_OID),
       tile_group_id(INVALID_OID),
@@ -40,7 +41,7 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
       schema(tuple_schema),
       data(NULL),
       tile_group(tile_group),
-      pool(NULL),
+      pool(pool),
       num_tuple_slots(tuple_count),
       column_count(tuple_schema.GetColumnCount()),
       tuple_length(tuple_schema.GetLength()),
@@ -65,10 +66,42 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
 
   // allocate pool for blob storage if schema not inlined
   // if (schema.IsInlined() == false) {
-  pool = new type::EphemeralPool();
+  if (this->pool == nullptr) {
+    this->pool.reset(new type::VarlenPool());
+  }
   //}
 }
 
+Tile::Tile(const Tile &source,
+           std::vector<std::unique_ptr<CompressedColumn>> &&columns)
+    : database_id(source.database_id),
+      table_id(source.table_id),
+      tile_group_id(source.tile_group_id),
+      tile_id(source.tile_id),
+      backend_type(source.backend_type),
+      schema(source.schema),
+      data(NULL),
+      tile_group(source.tile_group),
+      pool(source.pool),
+      num_tuple_slots(source.num_tuple_slots),
+      column_count(source.column_count),
+      tuple_length(source.tuple_length),
+      tile_size(source.tile_size),
+      uninlined_data_size(0),
+      column_header(NULL),
+      column_header_size(INVALID_OID),
+      tile_group_header(source.tile_group_header),
+      frozen(true),
+      compressed_columns(std::move(columns)),
+      column_dictionaries(source.column_dictionaries) {
+  PL_ASSERT(compressed_columns.size() == column_count);
+
+  offset_to_column.resize(tuple_length, INVALID_OID);
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    offset_to_column[schema.GetOffset(column_itr)] = column_itr;
+  }
+}
+
 Tile::~Tile() {
   // reclaim the tile memory (INLINED data)
   // auto &storage_manager = storage::StorageManager::GetInstance();
@@ -77,12 +110,6 @@ Tile::~Tile() {
   delete[] data;
   data = NULL;
 
-  // reclaim the tile memory (UNINLINED data)
-  // if (schema.IsInlined() == false) {
-  delete pool;
-  //}
-  pool = NULL;
-
   // clear any cached column headers
   if (column_header) delete column_header;
   column_header = NULL;
@@ -114,6 +141,10 @@ type::Value Tile::GetValue(const oid_t tuple_offset, const oid_t column_id) {
   PL_ASSERT(tuple_offset < GetAllocatedTupleCount());
   PL_ASSERT(column_id < schema.GetColumnCount());
 
+  if (unlikely_branch(frozen)) {
+    return compressed_columns[column_id]->GetValue(tuple_offset);
+  }
+
   const type::TypeId column_type = schema.GetType(column_id);
 
   const char *tuple_location = GetTupleLocation(tuple_offset);
@@ -135,6 +166,11 @@ type::Value Tile::GetValueFast(const oid_t tuple_offset,
   PL_ASSERT(tuple_offset < GetAllocatedTupleCount());
   PL_ASSERT(column_offset < schema.GetLength());
 
+  if (unlikely_branch(frozen)) {
+    oid_t column_id = offset_to_column[column_offset];
+    return compressed_columns[column_id]->GetValue(tuple_offset);
+  }
+
   const char *tuple_location = GetTupleLocation(tuple_offset);
   const char *field_location = tuple_location + column_offset;
 
@@ -149,6 +185,7 @@ void Tile::SetValue(const type::Value &value, const oid_t tuple_offset,
                     const oid_t column_id) {
   PL_ASSERT(tuple_offset < num_tuple_slots);
   PL_ASSERT(column_id < schema.GetColumnCount());
+  PL_ASSERT(!frozen);
 
   char *tuple_location = GetTupleLocation(tuple_offset);
   char *field_location = tuple_location + schema.GetOffset(column_id);
@@ -159,11 +196,20 @@ void Tile::SetValue(const type::Value &value, const oid_t tuple_offset,
   PL_ASSERT(pool != nullptr);
   // Cast the value if the type is different from column type
   const type::TypeId col_type = schema.GetType(column_id);
+  auto *dictionary = GetDictionaryAtOffset(schema.GetOffset(column_id));
   if (value.GetTypeId() == col_type) {
-    value.SerializeTo(field_location, is_inlined, pool);
+    if (dictionary != nullptr) {
+      SetDictionaryValue(value, field_location, dictionary);
+    } else {
+      value.SerializeTo(field_location, is_inlined, pool.get());
+    }
   } else {
     type::Value casted_value = value.CastAs(col_type);
-    casted_value.SerializeTo(field_location, is_inlined, pool);
+    if (dictionary != nullptr) {
+      SetDictionaryValue(casted_value, field_location, dictionary);
+    } else {
+      casted_value.SerializeTo(field_location, is_inlined, pool.get());
+    }
   }
 }
 
@@ -177,16 +223,23 @@ void Tile::SetValueFast(const type::Value &value, const oid_t tuple_offset,
                         UNUSED_ATTRIBUTE const size_t column_length) {
   PL_ASSERT(tuple_offset < num_tuple_slots);
   PL_ASSERT(column_offset < schema.GetLength());
+  PL_ASSERT(!frozen);
 
   char *tuple_location = GetTupleLocation(tuple_offset);
   char *field_location = tuple_location + column_offset;
 
   // const bool is_in_bytes = false;
   PL_ASSERT(pool != nullptr);
-  value.SerializeTo(field_location, is_inlined, pool);
+  auto *dictionary = GetDictionaryAtOffset(column_offset);
+  if (dictionary != nullptr) {
+    SetDictionaryValue(value, field_location, dictionary);
+  } else {
+    value.SerializeTo(field_location, is_inlined, pool.get());
+  }
 }
 
 Tile *Tile::CopyTile(BackendType backend_type) {
+  PL_ASSERT(!frozen);
   auto schema = GetSchema();
   bool tile_columns_inlined = schema->IsInlined();
   auto allocated_tuple_count = GetAllocatedTupleCount();
@@ -199,6 +252,7 @@ Tile *Tile::CopyTile(BackendType backend_type) {
 
   PL_MEMCPY(static_cast<void *>(new_tile->data), static_cast<void *>(data),
             tile_size);
+  new_tile->column_dictionaries = column_dictionaries;
 
   // Do a deep copy if some column is uninlined, so that
   // the values in that column point to the new pool
@@ -221,6 +275,185 @@ Tile *Tile::CopyTile(BackendType backend_type) {
   return new_tile;
 }
 
+//===--------------------------------------------------------------------===//
+// Cold Storage
+//===--------------------------------------------------------------------===//
+
+Tile *Tile::Freeze() const {
+  PL_ASSERT(!frozen);
+
+  std::vector<std::unique_ptr<CompressedColumn>> columns;
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    auto column =
+        CompressedColumn::Compress(*this, column_itr, num_tuple_slots);
+    if (column == nullptr) {
+      return nullptr;
+    }
+    columns.push_back(std::move(column));
+  }
+
+  return new Tile(*this, std::move(columns));
+}
+
+Tile *Tile::Decompress(bool copy_varlen) const {
+  PL_ASSERT(frozen);
+
+  // Copied varlen data goes into the tile group's pool. Otherwise the slots
+  // point into the compressed columns and the new tile's pool stays empty.
+  Tile *new_tile = TileFactory::GetTile(
+      backend_type, database_id, table_id, tile_group_id, tile_id,
+      tile_group_header, schema, tile_group, num_tuple_slots,
+      copy_varlen ? pool : nullptr);
+  new_tile->column_dictionaries = column_dictionaries;
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    auto *column = compressed_columns[column_itr].get();
+    size_t column_offset = schema.GetOffset(column_itr);
+    bool is_varlen = (schema.GetType(column_itr) == type::TypeId::VARCHAR ||
+                      schema.GetType(column_itr) == type::TypeId::VARBINARY);
+    // Slots of dictionary-encoded columns keep their entries, which outlive
+    // the frozen tile
+    bool copy_column = is_varlen && copy_varlen &&
+                       GetDictionaryAtOffset(column_offset) == nullptr;
+
+    for (oid_t tuple_itr = 0; tuple_itr < num_tuple_slots; tuple_itr++) {
+      if (copy_column) {
+        // Deep copy, so that the slot points into the new tile's pool
+        new_tile->SetValueFast(column->GetValue(tuple_itr), tuple_itr,
+                               column_offset, schema.IsInlined(column_itr),
+                               schema.GetLength(column_itr));
+      } else {
+        column->Decode(tuple_itr,
+                       new_tile->GetTupleLocation(tuple_itr) + column_offset);
+      }
+    }
+  }
+
+  return new_tile;
+}
+
+Tile *Tile::Thaw() const { return Decompress(true); }
+
+Tile *Tile::GetMaterializedTile() {
+  if (!frozen) {
+    return this;
+  }
+
+  std::lock_guard<std::mutex> lock(materialized_tile_mutex);
+  if (materialized_tile == nullptr) {
+    LOG_DEBUG("Materializing frozen tile %u of tile group %u", tile_id,
+              tile_group_id);
+    materialized_tile.reset(Decompress(false));
+  }
+  materialized_tile_used = true;
+  return materialized_tile.get();
+}
+
+std::shared_ptr<Tile> Tile::ReleaseIdleMaterializedTile() {
+  std::lock_guard<std::mutex> lock(materialized_tile_mutex);
+  // Copies that are still scanned get another chance
+  if (materialized_tile_used) {
+    materialized_tile_used = false;
+    return nullptr;
+  }
+  return std::move(materialized_tile);
+}
+
+size_t Tile::GetCompressedSize() const {
+  size_t size = 0;
+  for (auto &column : compressed_columns) {
+    size += column->GetCompressedSize();
+  }
+  return size;
+}
+
+void Tile::FreeVarlenValues() {
+  PL_ASSERT(!frozen);
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    auto type_id = schema.GetType(column_itr);
+    size_t column_offset = schema.GetOffset(column_itr);
+    if ((type_id != type::TypeId::VARCHAR &&
+         type_id != type::TypeId::VARBINARY) ||
+        schema.IsInlined(column_itr) ||
+        GetDictionaryAtOffset(column_offset) != nullptr) {
+      continue;
+    }
+
+    for (oid_t tuple_itr = 0; tuple_itr < num_tuple_slots; tuple_itr++) {
+      char **field_location = reinterpret_cast<char **>(
+          GetTupleLocation(tuple_itr) + column_offset);
+      if (*field_location != nullptr) {
+        pool->Free(*field_location);
+        *field_location = nullptr;
+      }
+    }
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Dictionary Encoding
+//===--------------------------------------------------------------------===//
+
+void Tile::SetColumnDictionary(
+    const oid_t column_id,
+    const std::shared_ptr<StringDictionary> &dictionary) {
+  PL_ASSERT(column_id < column_count);
+  PL_ASSERT(!schema.IsInlined(column_id));
+  if (column_dictionaries.empty()) {
+    column_dictionaries.resize(tuple_length);
+  }
+  column_dictionaries[schema.GetOffset(column_id)] = dictionary;
+}
+
+void Tile::SetDictionaryValue(const type::Value &value, char *field_location,
+                              StringDictionary *dictionary) {
+  const char *varlen = nullptr;
+  if (!value.IsNull()) {
+    varlen = dictionary->Intern(value.GetData(), value.GetLength());
+    if (varlen == nullptr) {
+      varlen = StringDictionary::CopyUnencoded(pool.get(), value.GetData(),
+                                               value.GetLength());
+    }
+  }
+  *reinterpret_cast<const char **>(field_location) = varlen;
+}
+
+void Tile::InternVarlenValues(const oid_t tuple_offset) {
+  PL_ASSERT(tuple_offset < num_tuple_slots);
+  if (column_dictionaries.empty()) {
+    return;
+  }
+
+  char *tuple_location = GetTupleLocation(tuple_offset);
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    size_t column_offset = schema.GetOffset(column_itr);
+    auto *dictionary = GetDictionaryAtOffset(column_offset);
+    if (dictionary == nullptr) {
+      continue;
+    }
+
+    char **field_location =
+        reinterpret_cast<char **>(tuple_location + column_offset);
+    char *varlen = *field_location;
+    if (varlen == nullptr) {
+      continue;
+    }
+
+    uint32_t length = *reinterpret_cast<uint32_t *>(varlen);
+    const char *entry = dictionary->Intern(varlen + sizeof(uint32_t), length);
+    if (entry == nullptr) {
+      entry = StringDictionary::CopyUnencoded(
+          pool.get(), varlen + sizeof(uint32_t), length);
+    }
+    if (entry != varlen) {
+      // The value was written through the pool
+      pool->Free(varlen);
+      *field_location = const_cast<char *>(entry);
+    }
+  }
+}
+
 //===--------------------------------------------------------------------===//
 // Utilities
 //===--------------------------------------------------------------------===//
@@ -236,6 +469,18 @@ const std::string Tile::GetInfo() const {
   // Tuples
   os << GETINFO_SINGLE_LINE << std::endl;
 
+  if (frozen) {
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto *column = compressed_columns[column_itr].get();
+      os << "Column[" << column_itr << "] " << column->GetEncodingType()
+         << " : " << column->GetCompressedSize() << " / "
+         << column->GetUncompressedSize() << " bytes" << std::endl;
+    }
+    std::string info = os.str();
+    StringUtil::RTrim(info);
+    return info;
+  }
+
   TupleIterator tile_itr(this);
   Tuple tuple(&schema);
 
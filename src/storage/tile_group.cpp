@@ -12,6 +12,7 @@
 
 #include "storage/tile_group.h"
 
+#include <algorithm>
 #include <numeric>
 
 #include "catalog/manager.h"
@@ -19,10 +20,12 @@
 #include "common/logger.h"
 #include "common/platform.h"
 #include "common/internal_types.h"
+#include "concurrency/epoch_manager_factory.h"
 #include "storage/abstract_table.h"
 #include "storage/tile.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "type/varlen_pool.h"
 #include "util/stringbox_util.h"
 
 namespace peloton {
@@ -40,6 +43,8 @@ TileGroup::TileGroup(BackendType backend_type,
       tile_group_header(tile_group_header),
       table(table),
       num_tuple_slots(tuple_count),
+      frozen(false),
+      varlen_pool(new type::VarlenPool()),
       column_map(column_map) {
   tile_count = tile_schemas.size();
 
@@ -49,7 +54,8 @@ TileGroup::TileGroup(BackendType backend_type,
 
     std::shared_ptr<Tile> tile(storage::TileFactory::GetTile(
         backend_type, database_id, table_id, tile_group_id, tile_id,
-        tile_group_header, tile_schemas[tile_itr], this, tuple_count));
+        tile_group_header, tile_schemas[tile_itr], this, tuple_count,
+        varlen_pool));
 
     // Add a reference to the tile in the tile group
     tiles.push_back(tile);
@@ -64,8 +70,8 @@ TileGroup::~TileGroup() {
 }
 
 oid_t TileGroup::GetTileId(const oid_t tile_id) const {
-  PL_ASSERT(tiles[tile_id]);
-  return tiles[tile_id]->GetTileId();
+  PL_ASSERT(GetTile(tile_id) != nullptr);
+  return GetTile(tile_id)->GetTileId();
 }
 
 type::AbstractPool *TileGroup::GetTilePool(const oid_t tile_id) const {
@@ -107,6 +113,7 @@ void TileGroup::CopyTuple(const Tuple *tuple, const oid_t &tuple_slot_id) {
 
   oid_t tile_column_count;
   oid_t column_itr = 0;
+  PL_ASSERT(!frozen);
 
   for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
     const catalog::Schema &schema = tile_schemas[tile_itr];
@@ -126,6 +133,49 @@ void TileGroup::CopyTuple(const Tuple *tuple, const oid_t &tuple_slot_id) {
       tile_tuple.SetValue(tile_column_itr, val, tile->GetPool());
       column_itr++;
     }
+    tile->InternVarlenValues(tuple_slot_id);
+  }
+}
+
+/**
+ * Copy a batch of tuples into consecutive slots, one column at a time.
+ * Inlined values are copied as raw bytes, the tuples have the table's schema.
+ */
+void TileGroup::CopyTuples(const std::vector<const Tuple *> &tuples,
+                           const size_t first_tuple, const oid_t first_slot_id,
+                           const oid_t count) {
+  PL_ASSERT(!frozen);
+  PL_ASSERT(first_tuple + count <= tuples.size());
+  PL_ASSERT(first_slot_id + count <= num_tuple_slots);
+
+  oid_t column_itr = 0;
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    const catalog::Schema &schema = tile_schemas[tile_itr];
+    oid_t tile_column_count = schema.GetColumnCount();
+
+    storage::Tile *tile = GetTile(tile_itr);
+    PL_ASSERT(tile);
+
+    for (oid_t tile_column_itr = 0; tile_column_itr < tile_column_count;
+         tile_column_itr++, column_itr++) {
+      size_t tile_column_offset = schema.GetOffset(tile_column_itr);
+      bool is_inlined = schema.IsInlined(tile_column_itr);
+      size_t column_length = schema.GetLength(tile_column_itr);
+
+      for (oid_t tuple_itr = 0; tuple_itr < count; tuple_itr++) {
+        const Tuple *tuple = tuples[first_tuple + tuple_itr];
+        if (is_inlined) {
+          size_t tuple_column_offset = tuple->GetSchema()->GetOffset(column_itr);
+          PL_MEMCPY(tile->GetTupleLocation(first_slot_id + tuple_itr) +
+                        tile_column_offset,
+                    tuple->GetData() + tuple_column_offset, column_length);
+        } else {
+          tile->SetValueFast(tuple->GetValue(column_itr),
+                             first_slot_id + tuple_itr, tile_column_offset,
+                             is_inlined, column_length);
+        }
+      }
+    }
   }
 }
 
@@ -164,6 +214,28 @@ oid_t TileGroup::InsertTuple(const Tuple *tuple) {
   return tuple_slot_id;
 }
 
+/**
+ * Grab a range of consecutive slots (thread-safe) and fill in the tuples
+ *
+ * Returns the first slot where inserted (INVALID_ID if not inserted)
+ */
+oid_t TileGroup::InsertTuples(const std::vector<const Tuple *> &tuples,
+                              const size_t first_tuple, oid_t &count) {
+  oid_t first_slot_id = tile_group_header->GetNextEmptyTupleSlots(count);
+
+  LOG_TRACE("Tile Group Id :: %u status :: %u (+%u) out of %u slots ",
+            tile_group_id, first_slot_id, count, num_tuple_slots);
+
+  // No more slots
+  if (first_slot_id == INVALID_OID) {
+    LOG_TRACE("Failed to get next empty tuple slots within tile group.");
+    return INVALID_OID;
+  }
+
+  CopyTuples(tuples, first_tuple, first_slot_id, count);
+  return first_slot_id;
+}
+
 /**
  * Grab specific slot and fill in the tuple
  * Used by recovery
@@ -189,6 +261,7 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
 
   oid_t tile_column_count;
   oid_t column_itr = 0;
+  PL_ASSERT(!frozen);
 
   for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
     const catalog::Schema &schema = tile_schemas[tile_itr];
@@ -208,6 +281,7 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
       tile_tuple.SetValue(tile_column_itr, val, tile->GetPool());
       column_itr++;
     }
+    tile->InternVarlenValues(tuple_slot_id);
   }
 
   // Set MVCC info
@@ -289,6 +363,7 @@ oid_t TileGroup::InsertTupleFromCheckpoint(oid_t tuple_slot_id,
 
   oid_t tile_column_count;
   oid_t column_itr = 0;
+  PL_ASSERT(!frozen);
 
   for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
     const catalog::Schema &schema = tile_schemas[tile_itr];
@@ -308,6 +383,7 @@ oid_t TileGroup::InsertTupleFromCheckpoint(oid_t tuple_slot_id,
       tile_tuple.SetValue(tile_column_itr, val, tile->GetPool());
       column_itr++;
     }
+    tile->InternVarlenValues(tuple_slot_id);
   }
 
   // Set MVCC info
@@ -347,10 +423,186 @@ void TileGroup::SetValue(type::Value &value, oid_t tuple_id,
 }
 
 
+void TileGroup::SetColumnDictionary(
+    const oid_t column_id,
+    const std::shared_ptr<StringDictionary> &dictionary) {
+  oid_t tile_column_id, tile_offset;
+  LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+  GetTile(tile_offset)->SetColumnDictionary(tile_column_id, dictionary);
+}
+
+void TileGroup::InternVarlenValues(const oid_t tuple_slot_id) {
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    GetTile(tile_itr)->InternVarlenValues(tuple_slot_id);
+  }
+}
+
 std::shared_ptr<Tile> TileGroup::GetTileReference(
     const oid_t tile_offset) const {
   PL_ASSERT(tile_offset < tile_count);
-  return tiles[tile_offset];
+  // Tiles may be swapped concurrently by Freeze() / Thaw()
+  return std::atomic_load(&tiles[tile_offset]);
+}
+
+//===--------------------------------------------------------------------===//
+// Cold Storage
+//===--------------------------------------------------------------------===//
+
+bool TileGroup::Freeze(eid_t cold_epoch_id) {
+  std::lock_guard<std::mutex> lock(tile_group_mutex);
+
+  if (frozen || tile_group_header->GetCurrentNextTupleSlot() < num_tuple_slots) {
+    return false;
+  }
+
+  // Fence off writers before checking for recent writes. The flag and the
+  // write epoch are sequentially consistent on both sides: a writer that
+  // records its write after this point sees the flag and thaws the tile group
+  // (which waits for us on the tile group mutex), and any earlier write is
+  // seen below.
+  bool was_immutable = tile_group_header->GetImmutability();
+  tile_group_header->SetImmutability();
+
+  // A writer records the epoch it writes in, which is no older than that of
+  // its transaction. Transactions still running may not have finished their
+  // writes yet, so their epochs are never cold.
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  eid_t expired_eid = epoch_manager.GetExpiredEpochId();
+  if (tile_group_header->GetLastWriteEpochId() >
+      std::min(cold_epoch_id, expired_eid)) {
+    if (!was_immutable) tile_group_header->ResetImmutability();
+    return false;
+  }
+
+  std::vector<std::shared_ptr<Tile>> frozen_tiles;
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    std::shared_ptr<Tile> frozen_tile(tiles[tile_itr]->Freeze());
+    if (frozen_tile == nullptr) {
+      if (!was_immutable) tile_group_header->ResetImmutability();
+      return false;
+    }
+    frozen_tiles.push_back(frozen_tile);
+  }
+
+  eid_t current_eid = epoch_manager.GetCurrentEpochId();
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    retired_tiles.emplace_back(current_eid, tiles[tile_itr]);
+    std::atomic_store(&tiles[tile_itr], frozen_tiles[tile_itr]);
+  }
+  frozen = true;
+
+  LOG_DEBUG("Froze tile group %u : %lu -> %lu bytes", tile_group_id,
+            GetUncompressedSize(), GetCompressedSize());
+  return true;
+}
+
+bool TileGroup::Thaw() {
+  std::lock_guard<std::mutex> lock(tile_group_mutex);
+
+  if (!frozen) {
+    return false;
+  }
+
+  eid_t current_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    std::shared_ptr<Tile> thawed_tile(tiles[tile_itr]->Thaw());
+    retired_tiles.emplace_back(current_eid, tiles[tile_itr]);
+    std::atomic_store(&tiles[tile_itr], thawed_tile);
+  }
+  frozen = false;
+  tile_group_header->ResetImmutability();
+
+  LOG_DEBUG("Thawed tile group %u", tile_group_id);
+  return true;
+}
+
+void TileGroup::PrepareForWrite() {
+  tile_group_header->SetLastWriteEpochId(
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId());
+
+  // Pairs with the immutable flag set in Freeze(): either the freezer sees
+  // our write epoch and backs off, or we see the flag and thaw. The fence
+  // covers the case where a later epoch was already recorded and the store
+  // above was skipped.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (unlikely_branch(tile_group_header->GetImmutability())) {
+    Thaw();
+  }
+}
+
+bool TileGroup::FilterFrozen(oid_t column_id, ExpressionType comparison,
+                             const type::Value &constant,
+                             std::vector<oid_t> &positions) const {
+  oid_t tile_column_id, tile_offset;
+  LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+  auto tile = GetTileReference(tile_offset);
+  if (!tile->IsFrozen()) {
+    return false;
+  }
+  tile->GetCompressedColumn(tile_column_id)
+      ->Filter(comparison, constant, positions);
+  return true;
+}
+
+void TileGroup::ReleaseIdleMaterializedTiles() {
+  std::lock_guard<std::mutex> lock(tile_group_mutex);
+
+  eid_t current_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    auto materialized_tile = tiles[tile_itr]->ReleaseIdleMaterializedTile();
+    if (materialized_tile != nullptr) {
+      retired_tiles.emplace_back(current_eid, materialized_tile);
+    }
+  }
+}
+
+size_t TileGroup::ReclaimRetiredTiles(eid_t expired_eid) {
+  std::lock_guard<std::mutex> lock(tile_group_mutex);
+
+  // Varlen data of uncompressed tiles went into the shared pool, while frozen
+  // and materialized tiles keep theirs elsewhere
+  for (auto &entry : retired_tiles) {
+    if (entry.first < expired_eid && !entry.second->IsFrozen() &&
+        entry.second->GetPool() == varlen_pool.get()) {
+      entry.second->FreeVarlenValues();
+    }
+  }
+
+  size_t num_retired = retired_tiles.size();
+  retired_tiles.erase(
+      std::remove_if(retired_tiles.begin(), retired_tiles.end(),
+                     [expired_eid](
+                         const std::pair<eid_t, std::shared_ptr<Tile>> &entry) {
+                       return entry.first < expired_eid;
+                     }),
+      retired_tiles.end());
+  return num_retired - retired_tiles.size();
+}
+
+size_t TileGroup::GetCompressedSize() const {
+  size_t size = 0;
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    size += GetTileReference(tile_itr)->GetCompressedSize();
+  }
+  return size;
+}
+
+size_t TileGroup::GetUncompressedSize() const {
+  size_t size = 0;
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    auto tile = GetTileReference(tile_itr);
+    if (!tile->IsFrozen()) {
+      size += tile->GetSize();
+      continue;
+    }
+    for (oid_t column_itr = 0; column_itr < tile->GetColumnCount();
+         column_itr++) {
+      size += tile->GetCompressedColumn(column_itr)->GetUncompressedSize();
+    }
+  }
+  return size;
 }
 
 double TileGroup::GetSchemaDifference(
@@ -37,7 +37,10 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
       data(nullptr),
       num_tuple_slots(tuple_count),
       next_tuple_slot(0),
-      tile_header_lock() {
+      tile_header_lock(),
+      last_write_epoch_id(0),
+      all_visible_cid(INVALID_CID),
+      all_visible_computations(0) {
   header_size = num_tuple_slots * header_entry_size;
 
   // allocate storage space for header
@@ -172,6 +175,31 @@ void TileGroupHeader::Sync() {
   // storage_manager.Sync(backend_type, data, header_size);
 }
 
+bool TileGroupHeader::ComputeAllVisible() {
+  // Only a full tile group gets no new versions
+  if (GetCurrentNextTupleSlot() < num_tuple_slots) {
+    return false;
+  }
+
+  cid_t token;
+  if (!BeginAllVisible(token)) {
+    return false;
+  }
+  cid_t max_begin_cid = 0;
+  for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
+       tuple_slot_id++) {
+    cid_t begin_cid = GetBeginCommitId(tuple_slot_id);
+    if (GetTransactionId(tuple_slot_id) != INITIAL_TXN_ID ||
+        GetEndCommitId(tuple_slot_id) != MAX_CID || begin_cid == MAX_CID) {
+      EndAllVisible(token, INVALID_CID);
+      return false;
+    }
+    max_begin_cid = std::max(max_begin_cid, begin_cid);
+  }
+  EndAllVisible(token, max_begin_cid);
+  return GetAllVisibleCommitId() == max_begin_cid;
+}
+
 void TileGroupHeader::PrintVisibility(txn_id_t txn_id, cid_t at_cid) {
   oid_t active_tuple_slots = GetCurrentNextTupleSlot();
   std::stringstream os;
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <numeric>
 
 #include "catalog/catalog.h"
 #include "catalog/zone_map_catalog.h"
@@ -17,6 +18,7 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/storage_manager.h"
 #include "storage/data_table.h"
+#include "storage/tile_group.h"
 #include "type/ephemeral_pool.h"
 #include "storage/zone_map_manager.h"
 
@@ -199,6 +201,30 @@ ZoneMapManager::GetResultVectorAsZoneMap(
 bool ZoneMapManager::ShouldScanTileGroup(
     storage::PredicateInfo *parsed_predicates, int32_t num_predicates,
     storage::DataTable *table, int64_t tile_group_idx) {
+  // Frozen tile groups are pruned exactly, on their compressed columns
+  if (num_predicates > 0) {
+    auto tile_group = table->GetTileGroup(tile_group_idx);
+    if (tile_group != nullptr && tile_group->IsFrozen()) {
+      std::vector<oid_t> positions(tile_group->GetAllocatedTupleCount());
+      std::iota(positions.begin(), positions.end(), 0);
+      bool all_filtered = true;
+      for (int32_t i = 0; i < num_predicates && !positions.empty(); i++) {
+        all_filtered &= tile_group->FilterFrozen(
+            parsed_predicates[i].col_id,
+            static_cast<ExpressionType>(
+                parsed_predicates[i].comparison_operator),
+            parsed_predicates[i].predicate_value, positions);
+      }
+      if (positions.empty()) {
+        return false;
+      }
+      // Fall back to the zone maps if the group was thawed meanwhile
+      if (all_filtered) {
+        return true;
+      }
+    }
+  }
+
   for (int32_t i = 0; i < num_predicates; i++) {
     // Extract the col_id, operator and predicate_value
     int col_id = parsed_predicates[i].col_id;
@@ -246,6 +272,33 @@ bool ZoneMapManager::ShouldScanTileGroup(
   return true;
 }
 
+/**
+ * @brief   The function compares a range of (integral) values against the
+ *          zone map of the column, e.g. the range of the build-side keys of a
+ *          hash join against the probe-side key column
+ * @param   table_ptr, tile_group_index, column id and the bounds of the range
+ * @return  True if tile group needs to be scanned.
+ *          False if tile group can be skipped.
+ */
+bool ZoneMapManager::ShouldScanTileGroupInRange(storage::DataTable *table,
+                                                int64_t tile_group_idx,
+                                                int32_t col_id, int64_t min,
+                                                int64_t max) {
+  if (min > max) {
+    return false;
+  }
+  std::unique_ptr<ZoneMapManager::ColumnStatistics> stats =
+      GetZoneMapFromCatalog(table->GetDatabaseOid(), table->GetOid(),
+                            tile_group_idx, col_id);
+  if (stats == nullptr) {
+    return true;
+  }
+  return checkLessThanEquals(type::ValueFactory::GetBigIntValue(max),
+                             stats.get()) &&
+         checkGreaterThanEquals(type::ValueFactory::GetBigIntValue(min),
+                                stats.get());
+}
+
 /**
  * @brief   Checks whether a zone map table in catalog was created.
  * @return  True if the zone map table in catalog exists and vice versa
@@ -268,6 +268,53 @@ std::shared_ptr<Statement> TrafficCop::PrepareStatement(
   std::shared_ptr<Statement> statement = std::make_shared<Statement>(
       stmt_name, query_type, query_string, std::move(sql_stmt_list));
 
+  // Do not need to parse or execute this query anymore if the
+  // multi-statement txn has been aborted
+  if (!BeginStatement(query_type, query_string, thread_id)) {
+    return statement;
+  }
+
+  // TODO(Tianyi) Move Statement Planing into Statement's method
+  // to increase coherence
+  try {
+    auto plan = optimizer_->BuildPelotonPlanTree(
+        statement->GetStmtParseTreeList(), default_database_name_,
+        tcop_txn_state_.top().first);
+    statement->SetPlanTree(plan);
+    // Get the tables that our plan references so that we know how to
+    // invalidate it at a later point when the catalog changes
+    const std::set<oid_t> table_oids =
+        planner::PlanUtil::GetTablesReferenced(plan.get());
+    statement->SetReferencedTables(table_oids);
+
+    if (query_type == QueryType::QUERY_SELECT) {
+      auto tuple_descriptor = GenerateTupleDescriptor(
+          statement->GetStmtParseTreeList()->GetStatement(0));
+      statement->SetTupleDescriptor(tuple_descriptor);
+      LOG_TRACE("select query, finish setting");
+    }
+  } catch (Exception &e) {
+    error_message_ = e.what();
+    ProcessInvalidStatement();
+    return nullptr;
+  }
+
+#ifdef LOG_DEBUG_ENABLED
+  if (statement->GetPlanTree().get() != nullptr) {
+    LOG_TRACE("Statement Prepared: %s", statement->GetInfo().c_str());
+    LOG_TRACE("%s", statement->GetPlanTree().get()->GetInfo().c_str());
+  }
+#endif
+  return statement;
+}
+
+/*
+ * Begin a new transaction for the statement if there is no active one.
+ * Returns false if the active multi-statement transaction is aborted.
+ */
+bool TrafficCop::BeginStatement(QueryType query_type,
+                                const std::string &query_string,
+                                const size_t thread_id) {
   // We can learn transaction's states, BEGIN, COMMIT, ABORT, or ROLLBACK from
   // member variables, tcop_txn_state_. We can also get single-statement txn or
   // multi-statement txn from member variable single_statement_txn_
@@ -275,19 +322,18 @@ std::shared_ptr<Statement> TrafficCop::PrepareStatement(
   // --multi-statements except BEGIN in a transaction
   if (!tcop_txn_state_.empty()) {
     single_statement_txn_ = false;
-    // multi-statment txn has been aborted, just skip this query,
-    // and do not need to parse or execute this query anymore.
+    // multi-statment txn has been aborted, just skip this query.
     // Do not return nullptr in case that 'COMMIT' cannot be execute,
     // because nullptr will directly return ResultType::FAILURE to
     // packet_manager
     if (tcop_txn_state_.top().second == ResultType::ABORTED) {
-      return statement;
+      return false;
     }
   } else {
     // Begin new transaction when received single-statement query or "BEGIN"
     // from multi-statement query
-    if (statement->GetQueryType() ==
-        QueryType::QUERY_BEGIN) {  // only begin a new transaction
+    if (query_type == QueryType::QUERY_BEGIN) {
+      // only begin a new transaction
       // note this transaction is not single-statement transaction
       LOG_TRACE("BEGIN");
       single_statement_txn_ = false;
@@ -308,39 +354,7 @@ std::shared_ptr<Statement> TrafficCop::PrepareStatement(
   if (settings::SettingsManager::GetBool(settings::SettingId::brain)) {
     tcop_txn_state_.top().first->AddQueryString(query_string.c_str());
   }
-
-  // TODO(Tianyi) Move Statement Planing into Statement's method
-  // to increase coherence
-  try {
-    auto plan = optimizer_->BuildPelotonPlanTree(
-        statement->GetStmtParseTreeList(), default_database_name_,
-        tcop_txn_state_.top().first);
-    statement->SetPlanTree(plan);
-    // Get the tables that our plan references so that we know how to
-    // invalidate it at a later point when the catalog changes
-    const std::set<oid_t> table_oids =
-        planner::PlanUtil::GetTablesReferenced(plan.get());
-    statement->SetReferencedTables(table_oids);
-
-    if (query_type == QueryType::QUERY_SELECT) {
-      auto tuple_descriptor = GenerateTupleDescriptor(
-          statement->GetStmtParseTreeList()->GetStatement(0));
-      statement->SetTupleDescriptor(tuple_descriptor);
-      LOG_TRACE("select query, finish setting");
-    }
-  } catch (Exception &e) {
-    error_message_ = e.what();
-    ProcessInvalidStatement();
-    return nullptr;
-  }
-
-#ifdef LOG_DEBUG_ENABLED
-  if (statement->GetPlanTree().get() != nullptr) {
-    LOG_TRACE("Statement Prepared: %s", statement->GetInfo().c_str());
-    LOG_TRACE("%s", statement->GetPlanTree().get()->GetInfo().c_str());
-  }
-#endif
-  return statement;
+  return true;
 }
 
 /*
@@ -584,7 +598,12 @@ ResultType TrafficCop::ExecuteStatement(
               statement->GetStmtParseTreeList(), default_database_name_,
               tcop_txn_state_.top().first);
           statement->SetPlanTree(plan);
-          statement->SetNeedsReplan(true);
+          statement->SetNeedsReplan(false);
+          // Bind the parameters into the new plan
+          if (!params.empty()) {
+            std::vector<type::Value> param_values(params);
+            plan->SetParameterValues(&param_values);
+          }
         }
 
         ExecuteHelper(statement->GetPlanTree(), params, result, result_format,
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// varlen_pool.cpp
+//
+// Identification: src/type/varlen_pool.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/varlen_pool.h"
+
+#include "common/logger.h"
+
+namespace peloton {
+namespace type {
+
+constexpr size_t VarlenPool::kChunkSize;
+constexpr size_t VarlenPool::kMaxBlockSize;
+
+namespace {
+
+// Every pool gets its own non-zero tag
+uint32_t NextOwnerTag() {
+  static std::atomic<uint32_t> next_owner_tag(0x9E3779B9);
+  uint32_t owner_tag;
+  do {
+    owner_tag = next_owner_tag.fetch_add(1);
+  } while (owner_tag == 0);
+  return owner_tag;
+}
+
+}  // anonymous namespace
+
+VarlenPool::VarlenPool()
+    : current_chunk_(nullptr), memory_size_(0), owner_tag_(NextOwnerTag()) {}
+
+VarlenPool::~VarlenPool() {
+  // Chunks are released with the vector
+  large_latch_.Lock();
+  for (auto &large_block : large_blocks_) {
+    delete[] large_block.first;
+  }
+  large_blocks_.clear();
+  large_latch_.Unlock();
+}
+
+size_t VarlenPool::GetBlockSize(size_t size) {
+  size_t block_size = kMinBlockSize;
+  while (block_size < size + kHeaderSize) {
+    block_size <<= 1;
+  }
+  return block_size;
+}
+
+uint32_t VarlenPool::GetSizeClass(size_t block_size) {
+  uint32_t size_class = 0;
+  while ((kMinBlockSize << size_class) < block_size) {
+    size_class++;
+  }
+  return size_class;
+}
+
+char *VarlenPool::PopFreeBlock(uint32_t size_class) {
+  auto &free_list = free_lists_[size_class];
+
+  // Don't bother with the latch if there is nothing to reuse
+  if (free_list.head.load(std::memory_order_relaxed) == nullptr) {
+    return nullptr;
+  }
+
+  free_list.latch.Lock();
+  char *block = free_list.head.load(std::memory_order_relaxed);
+  if (block != nullptr) {
+    free_list.head.store(*reinterpret_cast<char **>(block + kHeaderSize),
+                         std::memory_order_relaxed);
+  }
+  free_list.latch.Unlock();
+  return block;
+}
+
+void VarlenPool::AddChunk(Chunk *full_chunk) {
+  chunk_latch_.Lock();
+  if (current_chunk_.load() == full_chunk) {
+    chunks_.emplace_back(new Chunk(kChunkSize));
+    current_chunk_.store(chunks_.back().get());
+    memory_size_ += kChunkSize;
+  }
+  chunk_latch_.Unlock();
+}
+
+void *VarlenPool::AllocateLarge(size_t size) {
+  char *block = new char[size + kHeaderSize];
+
+  large_latch_.Lock();
+  large_blocks_.emplace(block, size + kHeaderSize);
+  large_latch_.Unlock();
+  memory_size_ += size + kHeaderSize;
+
+  return InitBlock(block, kLargeClass);
+}
+
+void *VarlenPool::Allocate(size_t size) {
+  size_t block_size = GetBlockSize(size);
+  if (block_size > kMaxBlockSize) {
+    return AllocateLarge(size);
+  }
+  uint32_t size_class = GetSizeClass(block_size);
+
+  char *block = PopFreeBlock(size_class);
+  while (block == nullptr) {
+    // Bump the offset of the current chunk. Only if it overflows we need to
+    // install a new chunk, the tail of the old one is left unused.
+    Chunk *chunk = current_chunk_.load();
+    if (chunk != nullptr) {
+      size_t offset = chunk->offset.fetch_add(block_size);
+      if (offset + block_size <= kChunkSize) {
+        block = chunk->data.get() + offset;
+        break;
+      }
+    }
+    AddChunk(chunk);
+  }
+
+  return InitBlock(block, size_class);
+}
+
+void VarlenPool::Free(void *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  char *block = reinterpret_cast<char *>(ptr) - kHeaderSize;
+  auto *header = reinterpret_cast<BlockHeader *>(block);
+  uint32_t size_class = header->size_class;
+  if (header->owner_tag != owner_tag_ || size_class > kLargeClass) {
+    LOG_ERROR("Freeing %p, which is not an allocated block of this pool",
+              ptr);
+    PL_ASSERT(false);
+    return;
+  }
+
+  if (size_class == kLargeClass) {
+    large_latch_.Lock();
+    auto iter = large_blocks_.find(block);
+    if (iter == large_blocks_.end()) {
+      large_latch_.Unlock();
+      LOG_ERROR("Freeing %p, which is not a large block of this pool", ptr);
+      PL_ASSERT(false);
+      return;
+    }
+    memory_size_ -= iter->second;
+    large_blocks_.erase(iter);
+    large_latch_.Unlock();
+    delete[] block;
+    return;
+  }
+
+  // A second Free() of the block fails the owner check
+  header->owner_tag = 0;
+
+  auto &free_list = free_lists_[size_class];
+  free_list.latch.Lock();
+  *reinterpret_cast<char **>(ptr) =
+      free_list.head.load(std::memory_order_relaxed);
+  free_list.head.store(block, std::memory_order_relaxed);
+  free_list.latch.Unlock();
+}
+
+}  // namespace type
+}  // namespace peloton
@@ -0,0 +1,231 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tiering_tuner_test.cpp
+//
+// Identification: test/brain/tiering_tuner_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <thread>
+
+#include "common/harness.h"
+
+#include "brain/tiering_tuner.h"
+
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tiering Tuner Tests
+//===--------------------------------------------------------------------===//
+
+class TieringTunerTests : public PelotonTest {};
+
+// Create a table with two full tile groups
+storage::DataTable *CreateTieringTable() {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto data_table = TestingExecutorUtil::CreateTable(tuple_count, false);
+  TestingExecutorUtil::PopulateTable(data_table, 2 * tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+  return data_table;
+}
+
+// Move on to the next epoch, so that the epoch of the writes so far expires
+void AdvanceEpoch() {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+}
+
+size_t CountFrozenTileGroups(storage::DataTable *table) {
+  size_t num_frozen = 0;
+  for (oid_t offset = 0; offset < table->GetTileGroupCount(); offset++) {
+    if (table->GetTileGroup(offset)->IsFrozen()) {
+      num_frozen++;
+    }
+  }
+  return num_frozen;
+}
+
+TEST_F(TieringTunerTests, FreezeThawTest) {
+  std::unique_ptr<storage::DataTable> data_table(CreateTieringTable());
+  auto &tiering_tuner = brain::TieringTuner::GetInstance();
+
+  // Nothing is cold while every write is recent
+  tiering_tuner.SetColdEpochThreshold(MAX_EID);
+  tiering_tuner.TuneTable(data_table.get());
+  EXPECT_EQ(0, CountFrozenTileGroups(data_table.get()));
+
+  // Every full tile group is cold once the threshold drops
+  AdvanceEpoch();
+  tiering_tuner.SetColdEpochThreshold(0);
+  tiering_tuner.TuneTable(data_table.get());
+  EXPECT_EQ(2, CountFrozenTileGroups(data_table.get()));
+
+  // Frozen tile groups still return the same values
+  auto tile_group = data_table->GetTileGroup(0);
+  EXPECT_TRUE(tile_group->GetHeader()->GetImmutability());
+  EXPECT_EQ(CmpBool::TRUE,
+            tile_group->GetValue(3, 0).CompareEquals(
+                type::ValueFactory::GetIntegerValue(
+                    TestingExecutorUtil::PopulatedValue(3, 0))));
+
+  // A write after the freeze thaws the tile group on the next pass
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  tile_group->GetHeader()->SetLastWriteEpochId(
+      epoch_manager.GetCurrentEpochId() + 1);
+  tiering_tuner.TuneTable(data_table.get());
+  EXPECT_FALSE(tile_group->IsFrozen());
+  EXPECT_FALSE(tile_group->GetHeader()->GetImmutability());
+  EXPECT_EQ(1, CountFrozenTileGroups(data_table.get()));
+
+  // Restore the default threshold of the singleton
+  tiering_tuner.SetColdEpochThreshold(250);
+}
+
+TEST_F(TieringTunerTests, MaterializedTileTest) {
+  auto tile_group = TestingExecutorUtil::CreateTileGroup(50);
+  TestingExecutorUtil::PopulateTiles(tile_group, 50);
+  tile_group->GetHeader()->SetLastWriteEpochId(1);
+  AdvanceEpoch();
+  ASSERT_TRUE(tile_group->Freeze(1));
+
+  // Nothing to release before a raw scan builds a copy
+  auto tile = tile_group->GetTile(0);
+  EXPECT_EQ(nullptr, tile->ReleaseIdleMaterializedTile());
+
+  // A copy used since the last pass is kept, and released on the next one
+  auto materialized = tile->GetMaterializedTile();
+  EXPECT_EQ(nullptr, tile->ReleaseIdleMaterializedTile());
+  EXPECT_EQ(materialized, tile->GetMaterializedTile());
+  EXPECT_EQ(nullptr, tile->ReleaseIdleMaterializedTile());
+  EXPECT_EQ(materialized, tile->ReleaseIdleMaterializedTile().get());
+  EXPECT_EQ(nullptr, tile->ReleaseIdleMaterializedTile());
+}
+
+TEST_F(TieringTunerTests, ConcurrentReadTest) {
+  const int tuple_count = 50;
+  auto tile_group = TestingExecutorUtil::CreateTileGroup(tuple_count);
+  TestingExecutorUtil::PopulateTiles(tile_group, tuple_count);
+  tile_group->GetHeader()->SetLastWriteEpochId(1);
+  AdvanceEpoch();
+
+  std::vector<type::Value> expected;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    expected.push_back(tile_group->GetValue(tuple_id, 1));
+  }
+
+  // Readers keep loading the tiles while they are swapped underneath them
+  std::atomic<bool> done(false);
+  std::atomic<size_t> mismatches(0);
+  std::vector<std::thread> readers;
+  for (int thread_id = 0; thread_id < 4; thread_id++) {
+    readers.emplace_back([&] {
+      while (!done) {
+        for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+          auto value = tile_group->GetValue(tuple_id, 1);
+          if (value.CompareEquals(expected[tuple_id]) != CmpBool::TRUE) {
+            mismatches++;
+          }
+        }
+      }
+    });
+  }
+
+  for (int round = 0; round < 100; round++) {
+    EXPECT_TRUE(tile_group->Freeze(1));
+    EXPECT_TRUE(tile_group->Thaw());
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(0, mismatches);
+
+  // No transaction can still see the replaced tiles
+  EXPECT_LT(0, tile_group->ReclaimRetiredTiles(MAX_EID));
+}
+
+TEST_F(TieringTunerTests, ConcurrentWriteTest) {
+  const int tuple_count = 50;
+  const oid_t tuple_id = 7;
+  const size_t writer_thread_id = 1;
+  auto tile_group = TestingExecutorUtil::CreateTileGroup(tuple_count);
+  TestingExecutorUtil::PopulateTiles(tile_group, tuple_count);
+
+  // A writer keeps updating a value in epochs of its own and reading it back,
+  // while the tile group is frozen in every epoch it isn't writing in
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.RegisterThread(writer_thread_id);
+  std::atomic<bool> done(false);
+  std::atomic<size_t> lost_writes(0);
+  std::thread writer([&] {
+    for (int32_t i = 0; !done; i++) {
+      cid_t read_id = epoch_manager.EnterEpoch(writer_thread_id,
+                                               TimestampType::READ);
+      auto value = type::ValueFactory::GetIntegerValue(i);
+      tile_group->PrepareForWrite();
+      tile_group->SetValue(value, tuple_id, 1);
+      if (tile_group->GetValue(tuple_id, 1).CompareEquals(value) !=
+          CmpBool::TRUE) {
+        lost_writes++;
+      }
+      epoch_manager.ExitEpoch(writer_thread_id, read_id >> 32);
+    }
+  });
+
+  size_t num_frozen = 0;
+  for (int round = 0; round < 1000; round++) {
+    AdvanceEpoch();
+    if (tile_group->Freeze(epoch_manager.GetCurrentEpochId())) {
+      num_frozen++;
+    }
+  }
+  done = true;
+  writer.join();
+  epoch_manager.DeregisterThread(writer_thread_id);
+
+  LOG_INFO("Froze the tile group %zu times", num_frozen);
+  EXPECT_EQ(0, lost_writes);
+  tile_group->ReclaimRetiredTiles(MAX_EID);
+}
+
+TEST_F(TieringTunerTests, RegistrationTest) {
+  auto &tiering_tuner = brain::TieringTuner::GetInstance();
+  tiering_tuner.ClearTables();
+
+  // Tables added to a database are tuned until they are dropped
+  storage::Database database(INVALID_OID);
+  auto data_table = CreateTieringTable();
+  database.AddTable(data_table, false);
+  EXPECT_EQ(1, tiering_tuner.GetTableCount());
+
+  database.DropTableWithOid(data_table->GetOid());
+  EXPECT_EQ(0, tiering_tuner.GetTableCount());
+
+  // Catalog tables stay hot
+  auto catalog_table = CreateTieringTable();
+  database.AddTable(catalog_table, true);
+  EXPECT_EQ(0, tiering_tuner.GetTableCount());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -56,6 +56,14 @@ class BlockNestedLoopJoinTranslatorTest : public PelotonCodeGenTest {
                    const std::vector<oid_t> &right_join_cols,
                    std::vector<codegen::WrappedTuple> &results);
 
+  // Join the given tables on equal key_col columns. Semi and anti joins
+  // output the A and B columns of the left table, the other joins output the
+  // A columns of both tables.
+  void PerformJoin(JoinType join_type, oid_t left_table_id,
+                   oid_t right_table_id,
+                   std::vector<codegen::WrappedTuple> &results,
+                   oid_t key_col = 0);
+
   type::Value GetCol(const AbstractTuple &t, JoinOutputColPos p);
 };
 
@@ -104,6 +112,44 @@ void BlockNestedLoopJoinTranslatorTest::PerformTest(
   results = buffer.GetOutputTuples();
 }
 
+void BlockNestedLoopJoinTranslatorTest::PerformJoin(
+    JoinType join_type, oid_t left_table_id, oid_t right_table_id,
+    std::vector<codegen::WrappedTuple> &results, oid_t key_col) {
+  bool left_only = join_type == JoinType::SEMI || join_type == JoinType::ANTI;
+  DirectMapList direct_map_list;
+  if (left_only) {
+    direct_map_list = {{0, std::make_pair(0, 0)}, {1, std::make_pair(0, 1)}};
+  } else {
+    direct_map_list = {{0, std::make_pair(0, 0)}, {1, std::make_pair(1, 0)}};
+  }
+  std::unique_ptr<planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+  auto schema = std::shared_ptr<const catalog::Schema>(new catalog::Schema(
+      {GetTestColumn(0), GetTestColumn(left_only ? 1 : 0)}));
+
+  bool left_side = true;
+  auto predicate =
+      CmpEqExpr(ColRefExpr(type::TypeId::INTEGER, left_side, key_col),
+                ColRefExpr(type::TypeId::INTEGER, !left_side, key_col));
+
+  PlanPtr nlj_plan{new planner::NestedLoopJoinPlan(
+      join_type, std::move(predicate), std::move(projection), schema,
+      {key_col}, {key_col})};
+  PlanPtr left_scan{new planner::SeqScanPlan(&GetTestTable(left_table_id),
+                                             nullptr, {0, 1, 2})};
+  PlanPtr right_scan{new planner::SeqScanPlan(&GetTestTable(right_table_id),
+                                              nullptr, {0, 1, 2})};
+  nlj_plan->AddChild(std::move(left_scan));
+  nlj_plan->AddChild(std::move(right_scan));
+
+  planner::BindingContext context;
+  nlj_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(*nlj_plan, buffer);
+  results = buffer.GetOutputTuples();
+}
+
 type::Value BlockNestedLoopJoinTranslatorTest::GetCol(const AbstractTuple &t,
                                                       JoinOutputColPos p) {
   return t.GetValue(static_cast<oid_t>(p));
@@ -268,5 +314,132 @@ TEST_F(BlockNestedLoopJoinTranslatorTest, NonEqualityJoin) {
   }
 }
 
+// Count the rows whose given column is NULL, and check that the two (A)
+// columns of the others are equal
+static uint32_t CountNulls(const std::vector<codegen::WrappedTuple> &results,
+                           oid_t col) {
+  uint32_t nulls = 0;
+  for (const auto &tuple : results) {
+    if (tuple.GetValue(col).IsNull()) {
+      nulls++;
+    } else {
+      EXPECT_EQ(CmpBool::TRUE,
+                tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+    }
+  }
+  return nulls;
+}
+
+TEST_F(BlockNestedLoopJoinTranslatorTest, OuterSemiAntiJoin) {
+  // The A values of the small (20 rows) table are all in the big (80 rows) one
+  std::vector<codegen::WrappedTuple> results;
+
+  PerformJoin(JoinType::INNER, LeftTableId(), RightTableId(), results);
+  EXPECT_EQ(20, results.size());
+  EXPECT_EQ(0, CountNulls(results, 1));
+
+  // Every left tuple has a match
+  PerformJoin(JoinType::LEFT, LeftTableId(), RightTableId(), results);
+  EXPECT_EQ(20, results.size());
+  EXPECT_EQ(0, CountNulls(results, 1));
+
+  // The right tuples without a match are padded with NULLs
+  PerformJoin(JoinType::RIGHT, LeftTableId(), RightTableId(), results);
+  EXPECT_EQ(80, results.size());
+  EXPECT_EQ(60, CountNulls(results, 0));
+
+  PerformJoin(JoinType::OUTER, LeftTableId(), RightTableId(), results);
+  EXPECT_EQ(80, results.size());
+  EXPECT_EQ(60, CountNulls(results, 0));
+
+  // The left tuples without a match are padded with NULLs
+  PerformJoin(JoinType::LEFT, RightTableId(), LeftTableId(), results);
+  EXPECT_EQ(80, results.size());
+  EXPECT_EQ(60, CountNulls(results, 1));
+
+  PerformJoin(JoinType::RIGHT, RightTableId(), LeftTableId(), results);
+  EXPECT_EQ(20, results.size());
+  EXPECT_EQ(0, CountNulls(results, 0));
+
+  PerformJoin(JoinType::OUTER, RightTableId(), LeftTableId(), results);
+  EXPECT_EQ(80, results.size());
+  EXPECT_EQ(60, CountNulls(results, 1));
+
+  // Semi and anti joins produce every left tuple at most once
+  PerformJoin(JoinType::SEMI, RightTableId(), LeftTableId(), results);
+  EXPECT_EQ(20, results.size());
+  PerformJoin(JoinType::ANTI, RightTableId(), LeftTableId(), results);
+  EXPECT_EQ(60, results.size());
+  PerformJoin(JoinType::SEMI, LeftTableId(), RightTableId(), results);
+  EXPECT_EQ(20, results.size());
+  PerformJoin(JoinType::ANTI, LeftTableId(), RightTableId(), results);
+  EXPECT_EQ(0, results.size());
+}
+
+TEST_F(BlockNestedLoopJoinTranslatorTest, EmptyInputJoin) {
+  // The third test table stays empty
+  oid_t empty_table_id = test_table_oids[2];
+  std::vector<codegen::WrappedTuple> results;
+
+  // Empty left side: only the right tuples of right and outer joins remain
+  PerformJoin(JoinType::INNER, empty_table_id, LeftTableId(), results);
+  EXPECT_EQ(0, results.size());
+  PerformJoin(JoinType::LEFT, empty_table_id, LeftTableId(), results);
+  EXPECT_EQ(0, results.size());
+  PerformJoin(JoinType::RIGHT, empty_table_id, LeftTableId(), results);
+  EXPECT_EQ(20, results.size());
+  EXPECT_EQ(20, CountNulls(results, 0));
+  PerformJoin(JoinType::OUTER, empty_table_id, LeftTableId(), results);
+  EXPECT_EQ(20, results.size());
+  EXPECT_EQ(20, CountNulls(results, 0));
+  PerformJoin(JoinType::SEMI, empty_table_id, LeftTableId(), results);
+  EXPECT_EQ(0, results.size());
+  PerformJoin(JoinType::ANTI, empty_table_id, LeftTableId(), results);
+  EXPECT_EQ(0, results.size());
+
+  // Empty right side: only the left tuples of left, outer and anti joins
+  // remain
+  PerformJoin(JoinType::INNER, LeftTableId(), empty_table_id, results);
+  EXPECT_EQ(0, results.size());
+  PerformJoin(JoinType::LEFT, LeftTableId(), empty_table_id, results);
+  EXPECT_EQ(20, results.size());
+  EXPECT_EQ(20, CountNulls(results, 1));
+  PerformJoin(JoinType::RIGHT, LeftTableId(), empty_table_id, results);
+  EXPECT_EQ(0, results.size());
+  PerformJoin(JoinType::OUTER, LeftTableId(), empty_table_id, results);
+  EXPECT_EQ(20, results.size());
+  EXPECT_EQ(20, CountNulls(results, 1));
+  PerformJoin(JoinType::SEMI, LeftTableId(), empty_table_id, results);
+  EXPECT_EQ(0, results.size());
+  PerformJoin(JoinType::ANTI, LeftTableId(), empty_table_id, results);
+  EXPECT_EQ(20, results.size());
+}
+
+TEST_F(BlockNestedLoopJoinTranslatorTest, NullKeyJoin) {
+  // Two tables whose B columns are all NULL
+  oid_t left_table_id = test_table_oids[2];
+  oid_t right_table_id = test_table_oids[3];
+  LoadTestTable(left_table_id, 10, true);
+  LoadTestTable(right_table_id, 10, true);
+  const oid_t b_col = 1;
+
+  // NULL keys never match, not even each other
+  std::vector<codegen::WrappedTuple> results;
+  PerformJoin(JoinType::INNER, left_table_id, right_table_id, results, b_col);
+  EXPECT_EQ(0, results.size());
+  PerformJoin(JoinType::LEFT, left_table_id, right_table_id, results, b_col);
+  EXPECT_EQ(10, results.size());
+  EXPECT_EQ(10, CountNulls(results, 1));
+  PerformJoin(JoinType::RIGHT, left_table_id, right_table_id, results, b_col);
+  EXPECT_EQ(10, results.size());
+  EXPECT_EQ(10, CountNulls(results, 0));
+  PerformJoin(JoinType::OUTER, left_table_id, right_table_id, results, b_col);
+  EXPECT_EQ(20, results.size());
+  PerformJoin(JoinType::SEMI, left_table_id, right_table_id, results, b_col);
+  EXPECT_EQ(0, results.size());
+  PerformJoin(JoinType::ANTI, left_table_id, right_table_id, results, b_col);
+  EXPECT_EQ(10, results.size());
+}
+
 }  // namespace test
 }  // namespace peloton
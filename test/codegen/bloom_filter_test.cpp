@@ -188,6 +188,94 @@ TEST_F(BloomFilterCodegenTest, FalsePositiveRateTest) {
   bloom_filter.Destroy();
 }
 
+TEST_F(BloomFilterCodegenTest, AdaptiveProbeTest) {
+  codegen::CodeContext code_context;
+  codegen::CodeGen codegen(code_context);
+  codegen::BloomFilterAccessor bloom_filter_accessor;
+  codegen::type::Type key_type(peloton::type::TypeId::INTEGER, false);
+
+  // Functions adding a key to the bloom filter and probing it for a key
+  codegen::FunctionBuilder add_func{
+      code_context,
+      "AddKey",
+      codegen.VoidType(),
+      {{"bloom_filter",
+        codegen::BloomFilterProxy::GetType(codegen)->getPointerTo()},
+       {"key", codegen.Int32Type()}}};
+  {
+    codegen::Value key{key_type, add_func.GetArgumentByPosition(1)};
+    bloom_filter_accessor.Add(codegen, add_func.GetArgumentByPosition(0),
+                              {key});
+    add_func.ReturnAndFinish();
+  }
+  codegen::FunctionBuilder probe_func{
+      code_context,
+      "ProbeKey",
+      codegen.BoolType(),
+      {{"bloom_filter",
+        codegen::BloomFilterProxy::GetType(codegen)->getPointerTo()},
+       {"key", codegen.Int32Type()}}};
+  {
+    codegen::Value key{key_type, probe_func.GetArgumentByPosition(1)};
+    probe_func.ReturnAndFinish(bloom_filter_accessor.Contains(
+        codegen, probe_func.GetArgumentByPosition(0), {key}));
+  }
+
+  ASSERT_TRUE(code_context.Compile());
+
+  using BloomFilter = codegen::util::BloomFilter;
+  typedef void (*add_ftype)(BloomFilter *bloom_filter, int);
+  typedef bool (*probe_ftype)(BloomFilter *bloom_filter, int);
+  add_ftype add_key =
+      (add_ftype)code_context.GetRawFunctionPointer(add_func.GetFunction());
+  probe_ftype probe_key =
+      (probe_ftype)code_context.GetRawFunctionPointer(probe_func.GetFunction());
+
+  const int num_keys = 1000;
+  BloomFilter bloom_filter;
+  bloom_filter.Init(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    add_key(&bloom_filter, i);
+  }
+
+  // Keys that are not in the filter mostly miss, so it keeps being probed
+  int next_missing_key = num_keys;
+  for (uint64_t i = 0; i < 2 * BloomFilter::kSampleSize; i++) {
+    ASSERT_TRUE(bloom_filter.ShouldProbe(1));
+    probe_key(&bloom_filter, next_missing_key++);
+  }
+  EXPECT_EQ(2 * BloomFilter::kSampleSize, bloom_filter.GetNumProbes());
+  EXPECT_GT(bloom_filter.GetNumMisses(),
+            (1 - BloomFilter::kMaxPassRate) * bloom_filter.GetNumProbes());
+
+  // Keys that are in the filter all pass, it is switched off after a sample
+  uint64_t num_probed = 0;
+  while (bloom_filter.ShouldProbe(1)) {
+    EXPECT_TRUE(probe_key(&bloom_filter, num_probed % num_keys));
+    num_probed++;
+    ASSERT_LE(num_probed, BloomFilter::kSampleSize);
+  }
+  EXPECT_EQ(BloomFilter::kSampleSize, num_probed);
+
+  // It sits out the following tuples, then samples again
+  const uint32_t batch_size = 1024;
+  uint64_t num_skipped = 0;
+  bool probe;
+  do {
+    probe = bloom_filter.ShouldProbe(batch_size);
+    num_skipped += batch_size;
+  } while (!probe);
+  EXPECT_EQ(BloomFilter::kSkipInterval, num_skipped);
+
+  // Once keys miss again, the filter stays switched on
+  for (uint64_t i = 0; i < 2 * BloomFilter::kSampleSize; i++) {
+    probe_key(&bloom_filter, next_missing_key++);
+    ASSERT_TRUE(bloom_filter.ShouldProbe(1));
+  }
+
+  bloom_filter.Destroy();
+}
+
 // Testing whether bloom filter can improve the performance of hash join
 // when the hash table is bigger than L3 cache and selectivity is low
 TEST_F(BloomFilterCodegenTest, PerformanceTest) {
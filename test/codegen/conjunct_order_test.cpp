@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// conjunct_order_test.cpp
+//
+// Identification: test/codegen/conjunct_order_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "common/harness.h"
+
+#define private public
+
+#include "codegen/util/conjunct_order.h"
+
+namespace peloton {
+namespace test {
+
+using ConjunctOrder = codegen::util::ConjunctOrder;
+
+class ConjunctOrderTest : public PelotonTest {
+ public:
+  // Evaluate the conjuncts on a batch the way the generated code does: every
+  // conjunct sees the rows that passed the conjuncts before it. The pass rates
+  // are percentages, indexed by conjunct ID.
+  static void RunBatch(ConjunctOrder &order,
+                       const std::vector<uint64_t> &pass_rates) {
+    uint64_t num_rows = 1000;
+    for (uint32_t pos = 0; pos < order.num_conjuncts_; pos++) {
+      uint32_t conjunct = order.order_[pos];
+      uint64_t num_passed = num_rows * pass_rates[conjunct] / 100;
+      order.num_in_[conjunct] += num_rows;
+      order.num_passed_[conjunct] += num_passed;
+      num_rows = num_passed;
+    }
+    order.Update();
+  }
+
+  static std::vector<uint32_t> GetOrder(const ConjunctOrder &order) {
+    return std::vector<uint32_t>(order.order_,
+                                 order.order_ + order.num_conjuncts_);
+  }
+};
+
+TEST_F(ConjunctOrderTest, ReorderTest) {
+  ConjunctOrder order;
+  order.Init(3);
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 2}), GetOrder(order));
+
+  // The predicate order is kept until the end of the interval
+  const std::vector<uint64_t> pass_rates = {90, 10, 50};
+  for (uint32_t i = 0; i < ConjunctOrder::kReorderInterval - 1; i++) {
+    RunBatch(order, pass_rates);
+  }
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 2}), GetOrder(order));
+
+  // Then the most selective conjunct runs first
+  RunBatch(order, pass_rates);
+  EXPECT_EQ((std::vector<uint32_t>{1, 2, 0}), GetOrder(order));
+
+  // The order stays put while the selectivities do
+  for (uint32_t i = 0; i < ConjunctOrder::kReorderInterval; i++) {
+    RunBatch(order, pass_rates);
+  }
+  EXPECT_EQ((std::vector<uint32_t>{1, 2, 0}), GetOrder(order));
+}
+
+TEST_F(ConjunctOrderTest, AdaptTest) {
+  ConjunctOrder order;
+  order.Init(3);
+  for (uint32_t i = 0; i < ConjunctOrder::kReorderInterval; i++) {
+    RunBatch(order, {90, 10, 50});
+  }
+  EXPECT_EQ((std::vector<uint32_t>{1, 2, 0}), GetOrder(order));
+
+  // The data changes. As the old counts are halved at every reordering, the
+  // order follows within a couple of intervals.
+  for (uint32_t i = 0; i < 2 * ConjunctOrder::kReorderInterval; i++) {
+    RunBatch(order, {10, 90, 50});
+  }
+  EXPECT_EQ((std::vector<uint32_t>{0, 2, 1}), GetOrder(order));
+}
+
+TEST_F(ConjunctOrderTest, UnevaluatedConjunctTest) {
+  ConjunctOrder order;
+  order.Init(3);
+
+  // No row reaches the last conjunct, which keeps its place at the end even
+  // though it would be the most selective
+  for (uint32_t i = 0; i < ConjunctOrder::kReorderInterval; i++) {
+    RunBatch(order, {50, 0, 0});
+  }
+  EXPECT_EQ((std::vector<uint32_t>{1, 0, 2}), GetOrder(order));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -12,13 +12,16 @@
 
 #include "catalog/catalog.h"
 #include "codegen/proxy/runtime_functions_proxy.h"
+#include "concurrency/transaction_manager_factory.h"
 #include "codegen/query_compiler.h"
+#include "codegen/util/hash_partitions.h"
 #include "common/harness.h"
 #include "expression/comparison_expression.h"
 #include "expression/conjunction_expression.h"
 #include "expression/tuple_value_expression.h"
 #include "planner/aggregate_plan.h"
 #include "planner/seq_scan_plan.h"
+#include "settings/settings_manager.h"
 
 #include "codegen/testing_codegen_util.h"
 
@@ -33,8 +36,96 @@ class GroupByTranslatorTest : public PelotonCodeGenTest {
   }
 
   oid_t TestTableId() const { return test_table_oids[0]; }
+
+  // Load the given table with rows_per_group rows for each of the groups. Row
+  // i of group g has a = g and b = i.
+  void LoadGroups(oid_t table_id, uint32_t num_groups,
+                  uint32_t rows_per_group) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto *txn = txn_manager.BeginTransaction();
+
+    auto &table = GetTestTable(table_id);
+    auto *table_schema = table.GetSchema();
+    auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+    for (uint32_t i = 0; i < rows_per_group; i++) {
+      for (uint32_t g = 0; g < num_groups; g++) {
+        storage::Tuple tuple{table_schema, true};
+        tuple.SetValue(0, type::ValueFactory::GetIntegerValue(g));
+        tuple.SetValue(1, type::ValueFactory::GetIntegerValue(i));
+        tuple.SetValue(2, type::ValueFactory::GetDecimalValue(i));
+        auto string_value =
+            type::ValueFactory::GetVarcharValue(std::to_string(g));
+        tuple.SetValue(3, string_value, testing_pool);
+
+        ItemPointer *index_entry_ptr = nullptr;
+        ItemPointer tuple_slot_id =
+            table.InsertTuple(&tuple, txn, &index_entry_ptr);
+        PL_ASSERT(tuple_slot_id.block != INVALID_OID);
+        txn_manager.PerformInsert(txn, tuple_slot_id, index_entry_ptr);
+      }
+    }
+
+    txn_manager.CommitTransaction(txn);
+  }
+
+  // Run a hash aggregation of the A and B columns of the given table, grouped
+  // by the given columns. The output has the grouping columns first, followed
+  // by the aggregates.
+  std::vector<codegen::WrappedTuple> RunAggregation(
+      oid_t table_id, std::vector<planner::AggregatePlan::AggTerm> &&agg_terms,
+      std::vector<oid_t> &&gb_cols);
 };
 
+std::vector<codegen::WrappedTuple> GroupByTranslatorTest::RunAggregation(
+    oid_t table_id, std::vector<planner::AggregatePlan::AggTerm> &&agg_terms,
+    std::vector<oid_t> &&gb_cols) {
+  DirectMapList direct_map_list;
+  std::vector<catalog::Column> columns;
+  std::vector<oid_t> output_cols;
+  for (oid_t col = 0; col < gb_cols.size(); col++) {
+    direct_map_list.push_back({col, {0, col}});
+    columns.push_back({type::TypeId::INTEGER, 4, "COL_A"});
+    output_cols.push_back(col);
+  }
+  for (oid_t agg = 0; agg < agg_terms.size(); agg++) {
+    oid_t col = static_cast<oid_t>(gb_cols.size()) + agg;
+    direct_map_list.push_back({col, {1, agg}});
+    switch (agg_terms[agg].aggtype) {
+      case ExpressionType::AGGREGATE_SUM:
+      case ExpressionType::AGGREGATE_MIN:
+      case ExpressionType::AGGREGATE_MAX:
+        columns.push_back({type::TypeId::INTEGER, 4, "AGG"});
+        break;
+      case ExpressionType::AGGREGATE_AVG:
+      case ExpressionType::AGGREGATE_APPROX_PERCENTILE:
+        columns.push_back({type::TypeId::DECIMAL, 8, "AGG"});
+        break;
+      default:
+        columns.push_back({type::TypeId::BIGINT, 8, "COUNT"});
+        break;
+    }
+    output_cols.push_back(col);
+  }
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema(columns)};
+
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), std::move(gb_cols),
+      output_schema, AggregateType::HASH)};
+  std::unique_ptr<planner::AbstractPlan> scan_plan{
+      new planner::SeqScanPlan(&GetTestTable(table_id), nullptr, {0, 1})};
+  agg_plan->AddChild(std::move(scan_plan));
+
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{output_cols, context};
+  CompileAndExecute(*agg_plan, buffer);
+  return buffer.GetOutputTuples();
+}
+
 TEST_F(GroupByTranslatorTest, SingleColumnGrouping) {
   //
   // SELECT a, count(*) FROM table GROUP BY a;
@@ -455,5 +546,261 @@ TEST_F(GroupByTranslatorTest, MinAndMax) {
               CmpBool::TRUE);
 }
 
+TEST_F(GroupByTranslatorTest, PartitionedAggregation) {
+  //
+  // SELECT a, COUNT(*), SUM(b), MIN(b), MAX(b), AVG(b) FROM table GROUP BY a;
+  //
+  // The pre-aggregation table is made so small that every row is flushed into
+  // the partitions, which then merge the partial aggregates of each group.
+  //
+
+  const uint32_t num_groups = 100, rows_per_group = 10;
+  oid_t table_id = test_table_oids[1];
+  LoadGroups(table_id, num_groups, rows_per_group);
+
+  auto b_col = [] {
+    return new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1);
+  };
+  auto run_query = [this, table_id, &b_col]() {
+    return RunAggregation(table_id,
+                          {{ExpressionType::AGGREGATE_COUNT_STAR, b_col()},
+                           {ExpressionType::AGGREGATE_SUM, b_col()},
+                           {ExpressionType::AGGREGATE_MIN, b_col()},
+                           {ExpressionType::AGGREGATE_MAX, b_col()},
+                           {ExpressionType::AGGREGATE_AVG, b_col()}},
+                          {0});
+  };
+
+  auto check_results = [num_groups, rows_per_group](
+      const std::vector<codegen::WrappedTuple> &results) {
+    ASSERT_EQ(num_groups, results.size());
+    std::vector<bool> seen(num_groups, false);
+    for (const auto &tuple : results) {
+      auto group = tuple.GetValue(0).GetAs<int32_t>();
+      ASSERT_TRUE(group >= 0 && group < static_cast<int32_t>(num_groups));
+      EXPECT_FALSE(seen[group]);
+      seen[group] = true;
+
+      // b runs from 0 to rows_per_group - 1 in every group
+      EXPECT_EQ(static_cast<int64_t>(rows_per_group),
+                tuple.GetValue(1).GetAs<int64_t>());
+      EXPECT_EQ(45, tuple.GetValue(2).GetAs<int32_t>());
+      EXPECT_EQ(0, tuple.GetValue(3).GetAs<int32_t>());
+      EXPECT_EQ(9, tuple.GetValue(4).GetAs<int32_t>());
+      EXPECT_DOUBLE_EQ(4.5, tuple.GetValue(5).GetAs<double>());
+    }
+  };
+
+  auto pre_aggregation_size = settings::SettingsManager::GetInt(
+      settings::SettingId::aggregation_pre_aggregation_size);
+  settings::SettingsManager::SetInt(
+      settings::SettingId::aggregation_pre_aggregation_size, 1);
+  check_results(run_query());
+
+  // With a tiny memory budget, the partitions are spilled to disk and split
+  // recursively while they are merged
+  auto memory_budget = settings::SettingsManager::GetDouble(
+      settings::SettingId::aggregation_memory_budget);
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::aggregation_memory_budget, 256);
+  check_results(run_query());
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::aggregation_memory_budget, memory_budget);
+
+  settings::SettingsManager::SetInt(
+      settings::SettingId::aggregation_pre_aggregation_size,
+      pre_aggregation_size);
+}
+
+TEST_F(GroupByTranslatorTest, ParallelPartitionMerge) {
+  //
+  // SELECT a, COUNT(*), SUM(b), MIN(b), MAX(b) FROM table GROUP BY a;
+  //
+  // Enough rows are flushed into the partitions that helper threads merge
+  // them alongside the thread of the query.
+  //
+
+  const uint32_t num_groups = 4096, rows_per_group = 10;
+  ASSERT_GT(num_groups * rows_per_group,
+            2 * codegen::util::HashPartitions::kMinEntriesPerThread);
+  oid_t table_id = test_table_oids[1];
+  LoadGroups(table_id, num_groups, rows_per_group);
+
+  auto b_col = [] {
+    return new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1);
+  };
+
+  auto pre_aggregation_size = settings::SettingsManager::GetInt(
+      settings::SettingId::aggregation_pre_aggregation_size);
+  auto merge_threads = settings::SettingsManager::GetInt(
+      settings::SettingId::aggregation_merge_threads);
+  settings::SettingsManager::SetInt(
+      settings::SettingId::aggregation_pre_aggregation_size, 1);
+  settings::SettingsManager::SetInt(
+      settings::SettingId::aggregation_merge_threads, 4);
+
+  auto num_helpers = codegen::util::HashPartitions::GetNumMergeHelpers();
+  auto results =
+      RunAggregation(table_id, {{ExpressionType::AGGREGATE_COUNT_STAR, b_col()},
+                                {ExpressionType::AGGREGATE_SUM, b_col()},
+                                {ExpressionType::AGGREGATE_MIN, b_col()},
+                                {ExpressionType::AGGREGATE_MAX, b_col()}},
+                     {0});
+  EXPECT_GT(codegen::util::HashPartitions::GetNumMergeHelpers(), num_helpers);
+
+  settings::SettingsManager::SetInt(
+      settings::SettingId::aggregation_merge_threads, merge_threads);
+  settings::SettingsManager::SetInt(
+      settings::SettingId::aggregation_pre_aggregation_size,
+      pre_aggregation_size);
+
+  ASSERT_EQ(num_groups, results.size());
+  std::vector<bool> seen(num_groups, false);
+  for (const auto &tuple : results) {
+    auto group = tuple.GetValue(0).GetAs<int32_t>();
+    ASSERT_TRUE(group >= 0 && group < static_cast<int32_t>(num_groups));
+    EXPECT_FALSE(seen[group]);
+    seen[group] = true;
+
+    EXPECT_EQ(static_cast<int64_t>(rows_per_group),
+              tuple.GetValue(1).GetAs<int64_t>());
+    EXPECT_EQ(45, tuple.GetValue(2).GetAs<int32_t>());
+    EXPECT_EQ(0, tuple.GetValue(3).GetAs<int32_t>());
+    EXPECT_EQ(9, tuple.GetValue(4).GetAs<int32_t>());
+  }
+}
+
+TEST_F(GroupByTranslatorTest, ApproximateAggregation) {
+  //
+  // SELECT a, APPROX_COUNT_DISTINCT(b), APPROX_PERCENTILE(b, 0.5) FROM table
+  // GROUP BY a;
+  // SELECT APPROX_COUNT_DISTINCT(a), APPROX_PERCENTILE(b, 0.9) FROM table;
+  //
+  // Every row is flushed into the partitions, so the sketches of each group
+  // are merged from many partial sketches.
+  //
+
+  const uint32_t num_groups = 10, rows_per_group = 100;
+  oid_t table_id = test_table_oids[1];
+  LoadGroups(table_id, num_groups, rows_per_group);
+
+  auto a_col = [] {
+    return new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  };
+  auto b_col = [] {
+    return new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1);
+  };
+
+  auto pre_aggregation_size = settings::SettingsManager::GetInt(
+      settings::SettingId::aggregation_pre_aggregation_size);
+  settings::SettingsManager::SetInt(
+      settings::SettingId::aggregation_pre_aggregation_size, 1);
+
+  // b runs from 0 to rows_per_group - 1 in every group
+  auto grouped = RunAggregation(
+      table_id,
+      {{ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT, b_col()},
+       {ExpressionType::AGGREGATE_APPROX_PERCENTILE, b_col(), false, 0.5}},
+      {0});
+  ASSERT_EQ(num_groups, grouped.size());
+  for (const auto &tuple : grouped) {
+    EXPECT_NEAR(rows_per_group, tuple.GetValue(1).GetAs<int64_t>(), 5);
+    EXPECT_NEAR(49.5, tuple.GetValue(2).GetAs<double>(), 2.0);
+  }
+
+  settings::SettingsManager::SetInt(
+      settings::SettingId::aggregation_pre_aggregation_size,
+      pre_aggregation_size);
+
+  auto global = RunAggregation(
+      table_id,
+      {{ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT, a_col()},
+       {ExpressionType::AGGREGATE_APPROX_PERCENTILE, b_col(), false, 0.9}},
+      {});
+  ASSERT_EQ(1, global.size());
+  EXPECT_EQ(num_groups, global[0].GetValue(0).GetAs<int64_t>());
+  EXPECT_NEAR(89.1, global[0].GetValue(1).GetAs<double>(), 2.0);
+}
+
+TEST_F(GroupByTranslatorTest, DistinctAggregation) {
+  //
+  // SELECT a, COUNT(*), COUNT(DISTINCT b), SUM(DISTINCT b), AVG(DISTINCT b)
+  // FROM table GROUP BY a;
+  // SELECT COUNT(DISTINCT b), SUM(DISTINCT a) FROM table;
+  //
+  // Every group holds each b value twice. The distinct values are flushed
+  // into partitions, deduplicated and added to the groups in the end.
+  //
+
+  const uint32_t num_groups = 100, rows_per_group = 10;
+  oid_t table_id = test_table_oids[1];
+  LoadGroups(table_id, num_groups, rows_per_group);
+  LoadGroups(table_id, num_groups, rows_per_group);
+
+  auto a_col = [] {
+    return new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  };
+  auto b_col = [] {
+    return new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1);
+  };
+
+  auto check_queries = [&]() {
+    auto grouped =
+        RunAggregation(table_id,
+                       {{ExpressionType::AGGREGATE_COUNT_STAR, b_col()},
+                        {ExpressionType::AGGREGATE_COUNT, b_col(), true},
+                        {ExpressionType::AGGREGATE_SUM, b_col(), true},
+                        {ExpressionType::AGGREGATE_AVG, b_col(), true}},
+                       {0});
+    ASSERT_EQ(num_groups, grouped.size());
+    std::vector<bool> seen(num_groups, false);
+    for (const auto &tuple : grouped) {
+      auto group = tuple.GetValue(0).GetAs<int32_t>();
+      ASSERT_TRUE(group >= 0 && group < static_cast<int32_t>(num_groups));
+      EXPECT_FALSE(seen[group]);
+      seen[group] = true;
+
+      EXPECT_EQ(2 * rows_per_group, tuple.GetValue(1).GetAs<int64_t>());
+      EXPECT_EQ(rows_per_group, tuple.GetValue(2).GetAs<int64_t>());
+      EXPECT_EQ(45, tuple.GetValue(3).GetAs<int32_t>());
+      EXPECT_DOUBLE_EQ(4.5, tuple.GetValue(4).GetAs<double>());
+    }
+
+    auto global =
+        RunAggregation(table_id,
+                       {{ExpressionType::AGGREGATE_COUNT, b_col(), true},
+                        {ExpressionType::AGGREGATE_SUM, a_col(), true}},
+                       {});
+    ASSERT_EQ(1, global.size());
+    EXPECT_EQ(rows_per_group, global[0].GetValue(0).GetAs<int64_t>());
+    EXPECT_EQ(4950, global[0].GetValue(1).GetAs<int32_t>());
+  };
+
+  auto pre_aggregation_size = settings::SettingsManager::GetInt(
+      settings::SettingId::aggregation_pre_aggregation_size);
+  settings::SettingsManager::SetInt(
+      settings::SettingId::aggregation_pre_aggregation_size, 1);
+  check_queries();
+
+  // With a tiny memory budget, the distinct values spill to disk too
+  auto memory_budget = settings::SettingsManager::GetDouble(
+      settings::SettingId::aggregation_memory_budget);
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::aggregation_memory_budget, 256);
+  check_queries();
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::aggregation_memory_budget, memory_budget);
+
+  // Without partitioning, distinct values are deduplicated as they arrive
+  settings::SettingsManager::SetInt(
+      settings::SettingId::aggregation_pre_aggregation_size,
+      pre_aggregation_size);
+  settings::SettingsManager::SetBool(
+      settings::SettingId::aggregation_partitioning, false);
+  check_queries();
+  settings::SettingsManager::SetBool(
+      settings::SettingId::aggregation_partitioning, true);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "codegen/query_compiler.h"
+#include "codegen/util/bloom_filter.h"
 #include "common/harness.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "expression/comparison_expression.h"
@@ -45,8 +46,121 @@ class HashJoinTranslatorTest : public PelotonCodeGenTest {
   storage::DataTable &GetRightTable() const {
     return GetTestTable(RightTableId());
   }
+
+  // Join the given tables on their key_col columns. Semi and anti joins
+  // output the A and B columns of the left table, the other joins output the
+  // A columns of both tables.
+  void PerformJoin(JoinType join_type, oid_t left_table_id,
+                   oid_t right_table_id,
+                   std::vector<codegen::WrappedTuple> &results,
+                   bool bloom_filter = false, oid_t key_col = 0);
+
+  // Insert rows with the given A values into the table
+  void InsertRows(oid_t table_id, const std::vector<int32_t> &a_values);
+
+  // An inner hash join with a bloom filter, building on the A column of the
+  // left input and probing with the given column of the right input. It
+  // outputs both of these columns.
+  PlanPtr StarJoinPlan(PlanPtr &&left, PlanPtr &&right, oid_t right_key_col);
 };
 
+void HashJoinTranslatorTest::InsertRows(oid_t table_id,
+                                        const std::vector<int32_t> &a_values) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = txn_manager.BeginTransaction();
+
+  auto &table = GetTestTable(table_id);
+  for (uint32_t i = 0; i < a_values.size(); i++) {
+    storage::Tuple tuple{table.GetSchema(), true};
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(a_values[i]));
+    tuple.SetValue(1, type::ValueFactory::GetIntegerValue(i));
+    tuple.SetValue(2, type::ValueFactory::GetDecimalValue(a_values[i]));
+    tuple.SetValue(3, type::ValueFactory::GetVarcharValue(std::to_string(i)),
+                   TestingHarness::GetInstance().GetTestingPool());
+
+    ItemPointer *index_entry_ptr = nullptr;
+    ItemPointer tuple_slot_id =
+        table.InsertTuple(&tuple, txn, &index_entry_ptr);
+    PL_ASSERT(tuple_slot_id.block != INVALID_OID);
+    txn_manager.PerformInsert(txn, tuple_slot_id, index_entry_ptr);
+  }
+  txn_manager.CommitTransaction(txn);
+}
+
+PlanPtr HashJoinTranslatorTest::StarJoinPlan(PlanPtr &&left, PlanPtr &&right,
+                                             oid_t right_key_col) {
+  DirectMapList direct_map_list = {{0, std::make_pair(0, 0)},
+                                   {1, std::make_pair(1, right_key_col)}};
+  std::unique_ptr<planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+  auto schema = std::shared_ptr<const catalog::Schema>(
+      new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(1)}));
+
+  std::vector<ConstExpressionPtr> left_hash_keys;
+  left_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+  std::vector<ConstExpressionPtr> right_hash_keys;
+  right_hash_keys.emplace_back(
+      ColRefExpr(type::TypeId::INTEGER, right_key_col));
+  std::vector<ConstExpressionPtr> hash_keys;
+  hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, right_key_col));
+
+  PlanPtr hj_plan{new planner::HashJoinPlan(
+      JoinType::INNER, nullptr, std::move(projection), schema, left_hash_keys,
+      right_hash_keys, true)};
+  PlanPtr hash_plan{new planner::HashPlan(hash_keys)};
+  hash_plan->AddChild(std::move(right));
+  hj_plan->AddChild(std::move(left));
+  hj_plan->AddChild(std::move(hash_plan));
+  return hj_plan;
+}
+
+void HashJoinTranslatorTest::PerformJoin(
+    JoinType join_type, oid_t left_table_id, oid_t right_table_id,
+    std::vector<codegen::WrappedTuple> &results, bool bloom_filter,
+    oid_t key_col) {
+  bool left_only = join_type == JoinType::SEMI || join_type == JoinType::ANTI;
+  DirectMapList direct_map_list;
+  if (left_only) {
+    direct_map_list = {{0, std::make_pair(0, 0)}, {1, std::make_pair(0, 1)}};
+  } else {
+    direct_map_list = {{0, std::make_pair(0, 0)}, {1, std::make_pair(1, 0)}};
+  }
+  std::unique_ptr<planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+  auto schema = std::shared_ptr<const catalog::Schema>(new catalog::Schema(
+      {TestingExecutorUtil::GetColumnInfo(0),
+       TestingExecutorUtil::GetColumnInfo(left_only ? 1 : 0)}));
+
+  std::vector<ConstExpressionPtr> left_hash_keys;
+  left_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, key_col));
+  std::vector<ConstExpressionPtr> right_hash_keys;
+  right_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, key_col));
+  std::vector<ConstExpressionPtr> hash_keys;
+  hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, key_col));
+
+  std::unique_ptr<planner::HashJoinPlan> hj_plan{
+      new planner::HashJoinPlan(join_type, nullptr, std::move(projection),
+                                schema, left_hash_keys, right_hash_keys,
+                                bloom_filter)};
+  std::unique_ptr<planner::HashPlan> hash_plan{
+      new planner::HashPlan(hash_keys)};
+  std::unique_ptr<planner::AbstractPlan> left_scan{new planner::SeqScanPlan(
+      &GetTestTable(left_table_id), nullptr, {0, 1, 2})};
+  std::unique_ptr<planner::AbstractPlan> right_scan{new planner::SeqScanPlan(
+      &GetTestTable(right_table_id), nullptr, {0, 1, 2})};
+  hash_plan->AddChild(std::move(right_scan));
+  hj_plan->AddChild(std::move(left_scan));
+  hj_plan->AddChild(std::move(hash_plan));
+
+  planner::BindingContext context;
+  hj_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(*hj_plan, buffer);
+  results = buffer.GetOutputTuples();
+}
+
 TEST_F(HashJoinTranslatorTest, SingleHashJoinColumnTest) {
   //
   // SELECT
@@ -127,5 +241,205 @@ TEST_F(HashJoinTranslatorTest, SingleHashJoinColumnTest) {
   }
 }
 
+TEST_F(HashJoinTranslatorTest, OuterSemiAntiJoinTest) {
+  // The A values of the small (20 rows) table are all in the big (80 rows) one
+  auto count_nulls = [](const std::vector<codegen::WrappedTuple> &results,
+                        oid_t col) {
+    uint32_t nulls = 0;
+    for (const auto &tuple : results) {
+      if (tuple.GetValue(col).IsNull()) {
+        nulls++;
+      } else {
+        EXPECT_EQ(CmpBool::TRUE,
+                  tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+      }
+    }
+    return nulls;
+  };
+
+  std::vector<codegen::WrappedTuple> results;
+
+  // Every build tuple has a match
+  PerformJoin(JoinType::LEFT, LeftTableId(), RightTableId(), results);
+  EXPECT_EQ(20, results.size());
+  EXPECT_EQ(0, count_nulls(results, 1));
+
+  // The probe tuples without a match are padded with NULLs
+  PerformJoin(JoinType::RIGHT, LeftTableId(), RightTableId(), results);
+  EXPECT_EQ(80, results.size());
+  EXPECT_EQ(60, count_nulls(results, 0));
+
+  PerformJoin(JoinType::OUTER, LeftTableId(), RightTableId(), results);
+  EXPECT_EQ(80, results.size());
+  EXPECT_EQ(60, count_nulls(results, 0));
+
+  // The build tuples without a match are padded with NULLs
+  PerformJoin(JoinType::LEFT, RightTableId(), LeftTableId(), results);
+  EXPECT_EQ(80, results.size());
+  EXPECT_EQ(60, count_nulls(results, 1));
+
+  PerformJoin(JoinType::RIGHT, RightTableId(), LeftTableId(), results);
+  EXPECT_EQ(20, results.size());
+  EXPECT_EQ(0, count_nulls(results, 0));
+
+  // Semi and anti joins produce every build tuple at most once
+  PerformJoin(JoinType::SEMI, RightTableId(), LeftTableId(), results);
+  EXPECT_EQ(20, results.size());
+  PerformJoin(JoinType::ANTI, RightTableId(), LeftTableId(), results);
+  EXPECT_EQ(60, results.size());
+  PerformJoin(JoinType::SEMI, LeftTableId(), RightTableId(), results);
+  EXPECT_EQ(20, results.size());
+  PerformJoin(JoinType::ANTI, LeftTableId(), RightTableId(), results);
+  EXPECT_EQ(0, results.size());
+}
+
+TEST_F(HashJoinTranslatorTest, BloomFilterPushDownTest) {
+  // The bloom filter (and the range of the build keys) is pushed down into the
+  // scan of the probe side, unless the join produces the probe tuples that
+  // have no match. Either way, the results must not change.
+  //
+  // The left (build) table has the keys 0, ..., 190 and the right (probe)
+  // table the keys 0, ..., 790. The filter is sized for far more keys than
+  // these, so it has no false positives.
+  std::vector<codegen::WrappedTuple> results;
+  using BloomFilter = codegen::util::BloomFilter;
+  uint64_t num_probes = BloomFilter::GetTotalNumProbes();
+  uint64_t num_misses = BloomFilter::GetTotalNumMisses();
+  auto expect_probes = [&num_probes, &num_misses](uint64_t probes,
+                                                  uint64_t misses) {
+    EXPECT_EQ(probes, BloomFilter::GetTotalNumProbes() - num_probes);
+    EXPECT_EQ(misses, BloomFilter::GetTotalNumMisses() - num_misses);
+    num_probes = BloomFilter::GetTotalNumProbes();
+    num_misses = BloomFilter::GetTotalNumMisses();
+  };
+
+  // The scan drops the 60 probe keys above the largest build key before
+  // they reach the filter
+  PerformJoin(JoinType::INNER, LeftTableId(), RightTableId(), results, true);
+  EXPECT_EQ(20, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(CmpBool::TRUE,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+  }
+  expect_probes(20, 0);
+
+  PerformJoin(JoinType::LEFT, RightTableId(), LeftTableId(), results, true);
+  EXPECT_EQ(80, results.size());
+  expect_probes(20, 0);
+
+  // The join probes the filter itself, every probe key reaches it
+  PerformJoin(JoinType::RIGHT, LeftTableId(), RightTableId(), results, true);
+  EXPECT_EQ(80, results.size());
+  expect_probes(80, 60);
+
+  PerformJoin(JoinType::SEMI, LeftTableId(), RightTableId(), results, true);
+  EXPECT_EQ(20, results.size());
+  expect_probes(20, 0);
+  PerformJoin(JoinType::ANTI, RightTableId(), LeftTableId(), results, true);
+  EXPECT_EQ(60, results.size());
+  expect_probes(20, 0);
+
+  // Build keys with gaps: the keys in the range of the build keys, but not
+  // among them, miss the filter
+  oid_t sparse_table_id = test_table_oids[2];
+  InsertRows(sparse_table_id, {0, 100, 190});
+  PerformJoin(JoinType::INNER, sparse_table_id, RightTableId(), results, true);
+  EXPECT_EQ(3, results.size());
+  expect_probes(20, 17);
+}
+
+TEST_F(HashJoinTranslatorTest, BloomFilterStarJoinTest) {
+  //
+  // SELECT dim2.a, fact.a
+  // FROM fact
+  // JOIN dim1 ON fact.a = dim1.a
+  // JOIN dim2 ON fact.a = dim2.a
+  //
+  // The right table is the fact table with the keys 0, ..., 790. The first
+  // dimension (the left table) has the keys 0, ..., 190, the second one only
+  // 100 and 150. The filter of the outer join is pushed through the probe
+  // side of the inner join into the scan of the fact table.
+  //
+  oid_t dim2_table_id = test_table_oids[2];
+  InsertRows(dim2_table_id, {100, 150});
+
+  auto scan = [this](oid_t table_id) {
+    return PlanPtr{new planner::SeqScanPlan(&GetTestTable(table_id), nullptr,
+                                            {0, 1, 2})};
+  };
+  PlanPtr dim1_join =
+      StarJoinPlan(scan(LeftTableId()), scan(RightTableId()), 0);
+  PlanPtr dim2_join =
+      StarJoinPlan(scan(dim2_table_id), std::move(dim1_join), 1);
+
+  planner::BindingContext context;
+  dim2_join->PerformBinding(context);
+
+  using BloomFilter = codegen::util::BloomFilter;
+  uint64_t num_probes = BloomFilter::GetTotalNumProbes();
+  uint64_t num_misses = BloomFilter::GetTotalNumMisses();
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(*dim2_join, buffer);
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(2, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(CmpBool::TRUE,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+  }
+
+  // The scan checks the keys against the range [100, 150] of the outer
+  // join, so only the fact keys 100, ..., 150 probe its filter and 4 of them
+  // miss. Had the outer join probed its filter itself, all 20 results of the
+  // inner join would have, and 18 of them would have missed.
+  EXPECT_EQ(4, BloomFilter::GetTotalNumMisses() - num_misses);
+  EXPECT_LT(BloomFilter::GetTotalNumProbes() - num_probes, 40);
+}
+
+TEST_F(HashJoinTranslatorTest, NullKeyJoinTest) {
+  // Two tables whose B columns are all NULL
+  oid_t left_table_id = test_table_oids[2];
+  oid_t right_table_id = test_table_oids[3];
+  LoadTestTable(left_table_id, 10, true);
+  LoadTestTable(right_table_id, 10, true);
+  const oid_t b_col = 1;
+
+  // NULL keys never match, not even each other
+  std::vector<codegen::WrappedTuple> results;
+  PerformJoin(JoinType::INNER, left_table_id, right_table_id, results, false,
+              b_col);
+  EXPECT_EQ(0, results.size());
+
+  PerformJoin(JoinType::LEFT, left_table_id, right_table_id, results, false,
+              b_col);
+  EXPECT_EQ(10, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_TRUE(tuple.GetValue(1).IsNull());
+  }
+
+  PerformJoin(JoinType::RIGHT, left_table_id, right_table_id, results, false,
+              b_col);
+  EXPECT_EQ(10, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_TRUE(tuple.GetValue(0).IsNull());
+  }
+
+  PerformJoin(JoinType::OUTER, left_table_id, right_table_id, results, false,
+              b_col);
+  EXPECT_EQ(20, results.size());
+
+  PerformJoin(JoinType::SEMI, left_table_id, right_table_id, results, false,
+              b_col);
+  EXPECT_EQ(0, results.size());
+  PerformJoin(JoinType::ANTI, left_table_id, right_table_id, results, false,
+              b_col);
+  EXPECT_EQ(10, results.size());
+
+  // Also when the bloom filter is pushed down into the probe-side scan
+  PerformJoin(JoinType::INNER, left_table_id, right_table_id, results, true,
+              b_col);
+  EXPECT_EQ(0, results.size());
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_translator_test.cpp
+//
+// Identification: test/codegen/merge_join_translator_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <map>
+#include <set>
+
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "planner/merge_join_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class MergeJoinTranslatorTest : public PelotonCodeGenTest {
+ public:
+  oid_t LeftTableId() const { return test_table_oids[0]; }
+
+  oid_t RightTableId() const { return test_table_oids[1]; }
+
+  // A table that is never loaded
+  oid_t EmptyTableId() const { return test_table_oids[2]; }
+
+  // Insert rows with the given A values into the table. The B values are the
+  // positions of the rows. A merge join expects its inputs sorted on the key,
+  // so the values must be ascending.
+  void InsertRows(oid_t table_id, const std::vector<int32_t> &a_values);
+
+  // Join the given tables on their A columns, and output the A and B columns
+  // of both tables
+  void PerformJoin(oid_t left_table_id, oid_t right_table_id,
+                   std::vector<codegen::WrappedTuple> &results);
+};
+
+void MergeJoinTranslatorTest::InsertRows(oid_t table_id,
+                                         const std::vector<int32_t> &a_values) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = txn_manager.BeginTransaction();
+
+  auto &table = GetTestTable(table_id);
+  for (uint32_t i = 0; i < a_values.size(); i++) {
+    storage::Tuple tuple{table.GetSchema(), true};
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(a_values[i]));
+    tuple.SetValue(1, type::ValueFactory::GetIntegerValue(i));
+    tuple.SetValue(2, type::ValueFactory::GetDecimalValue(a_values[i]));
+    tuple.SetValue(3, type::ValueFactory::GetVarcharValue(std::to_string(i)),
+                   TestingHarness::GetInstance().GetTestingPool());
+
+    ItemPointer *index_entry_ptr = nullptr;
+    ItemPointer tuple_slot_id =
+        table.InsertTuple(&tuple, txn, &index_entry_ptr);
+    PL_ASSERT(tuple_slot_id.block != INVALID_OID);
+    txn_manager.PerformInsert(txn, tuple_slot_id, index_entry_ptr);
+  }
+  txn_manager.CommitTransaction(txn);
+}
+
+void MergeJoinTranslatorTest::PerformJoin(
+    oid_t left_table_id, oid_t right_table_id,
+    std::vector<codegen::WrappedTuple> &results) {
+  DirectMapList direct_map_list = {{0, std::make_pair(0, 0)},
+                                   {1, std::make_pair(0, 1)},
+                                   {2, std::make_pair(1, 0)},
+                                   {3, std::make_pair(1, 1)}};
+  std::unique_ptr<const planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+  auto schema = std::shared_ptr<const catalog::Schema>(new catalog::Schema(
+      {GetTestColumn(0), GetTestColumn(1), GetTestColumn(0),
+       GetTestColumn(1)}));
+
+  std::vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+  join_clauses.emplace_back(
+      ColRefExpr(type::TypeId::INTEGER, true, 0).release(),
+      ColRefExpr(type::TypeId::INTEGER, false, 0).release(), false);
+
+  PlanPtr join_plan{new planner::MergeJoinPlan(
+      JoinType::INNER, nullptr, std::move(projection), schema, join_clauses)};
+  PlanPtr left_scan{new planner::SeqScanPlan(&GetTestTable(left_table_id),
+                                             nullptr, {0, 1})};
+  PlanPtr right_scan{new planner::SeqScanPlan(&GetTestTable(right_table_id),
+                                              nullptr, {0, 1})};
+  join_plan->AddChild(std::move(left_scan));
+  join_plan->AddChild(std::move(right_scan));
+
+  planner::BindingContext context;
+  join_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+  CompileAndExecute(*join_plan, buffer);
+  results = buffer.GetOutputTuples();
+}
+
+TEST_F(MergeJoinTranslatorTest, DuplicateKeys) {
+  // Runs of equal keys on both sides, next to keys without a match
+  InsertRows(LeftTableId(), {1, 2, 2, 2, 4, 5, 5});
+  InsertRows(RightTableId(), {0, 2, 2, 3, 5, 5, 5, 6});
+
+  std::vector<codegen::WrappedTuple> results;
+  PerformJoin(LeftTableId(), RightTableId(), results);
+
+  // Every pair of rows of a run joins exactly once: 3 x 2 rows with key 2 and
+  // 2 x 3 rows with key 5
+  ASSERT_EQ(12, results.size());
+  std::map<int32_t, uint32_t> num_matches;
+  std::set<std::pair<int32_t, int32_t>> pairs;
+  for (const auto &tuple : results) {
+    EXPECT_EQ(CmpBool::TRUE,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(2)));
+    num_matches[tuple.GetValue(0).GetAs<int32_t>()]++;
+    pairs.emplace(tuple.GetValue(1).GetAs<int32_t>(),
+                  tuple.GetValue(3).GetAs<int32_t>());
+  }
+  EXPECT_EQ((std::map<int32_t, uint32_t>{{2, 6}, {5, 6}}), num_matches);
+  EXPECT_EQ(12, pairs.size());
+}
+
+TEST_F(MergeJoinTranslatorTest, EmptyInputs) {
+  InsertRows(LeftTableId(), {1, 2, 2});
+  std::vector<codegen::WrappedTuple> results;
+
+  // Both inputs empty
+  PerformJoin(EmptyTableId(), EmptyTableId(), results);
+  EXPECT_EQ(0, results.size());
+
+  // Only the left input empty, no row is ever buffered
+  PerformJoin(EmptyTableId(), LeftTableId(), results);
+  EXPECT_EQ(0, results.size());
+
+  // Only the right input empty, the buffered rows are never probed
+  PerformJoin(LeftTableId(), EmptyTableId(), results);
+  EXPECT_EQ(0, results.size());
+
+  // The same table on both sides joins every run with itself
+  PerformJoin(LeftTableId(), LeftTableId(), results);
+  EXPECT_EQ(5, results.size());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// nested_loop_index_join_translator_test.cpp
+//
+// Identification: test/codegen/nested_loop_index_join_translator_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "planner/nested_loop_index_join_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class NestedLoopIndexJoinTranslatorTest : public PelotonCodeGenTest {
+ public:
+  NestedLoopIndexJoinTranslatorTest() : PelotonCodeGenTest() {
+    // The inner table has a primary key on its A column, whose values are
+    // 0, 10, ..., 90
+    LoadTestTable(InnerTableId(), 10);
+  }
+
+  oid_t OuterTableId() const { return test_table_oids[0]; }
+
+  oid_t InnerTableId() const { return test_table_oids[4]; }
+
+  // Insert a row with the given A and C values into the outer table
+  void InsertOuterRow(int32_t a, double c);
+
+  // Join the outer table's given column with the primary key of the inner
+  // table. The output is the outer A and C and the inner A columns.
+  void PerformJoin(oid_t outer_key_col,
+                   std::vector<codegen::WrappedTuple> &results);
+};
+
+void NestedLoopIndexJoinTranslatorTest::InsertOuterRow(int32_t a, double c) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = txn_manager.BeginTransaction();
+
+  auto &table = GetTestTable(OuterTableId());
+  storage::Tuple tuple{table.GetSchema(), true};
+  tuple.SetValue(0, type::ValueFactory::GetIntegerValue(a));
+  tuple.SetValue(1, type::ValueFactory::GetIntegerValue(a + 1));
+  tuple.SetValue(2, type::ValueFactory::GetDecimalValue(c));
+  tuple.SetValue(3, type::ValueFactory::GetVarcharValue(std::to_string(a)),
+                 TestingHarness::GetInstance().GetTestingPool());
+
+  ItemPointer *index_entry_ptr = nullptr;
+  ItemPointer tuple_slot_id = table.InsertTuple(&tuple, txn, &index_entry_ptr);
+  PL_ASSERT(tuple_slot_id.block != INVALID_OID);
+  txn_manager.PerformInsert(txn, tuple_slot_id, index_entry_ptr);
+  txn_manager.CommitTransaction(txn);
+}
+
+void NestedLoopIndexJoinTranslatorTest::PerformJoin(
+    oid_t outer_key_col, std::vector<codegen::WrappedTuple> &results) {
+  DirectMapList direct_map_list = {{0, std::make_pair(0, 0)},
+                                   {1, std::make_pair(0, 2)},
+                                   {2, std::make_pair(1, 0)}};
+  std::unique_ptr<planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+  auto schema = std::shared_ptr<const catalog::Schema>(new catalog::Schema(
+      {GetTestColumn(0), GetTestColumn(2), GetTestColumn(0)}));
+
+  auto &inner_table = GetTestTable(InnerTableId());
+  PlanPtr join_plan{new planner::NestedLoopIndexJoinPlan(
+      JoinType::INNER, nullptr, std::move(projection), schema,
+      {outer_key_col}, &inner_table, inner_table.GetIndex(0), {0, 1},
+      nullptr, false)};
+  PlanPtr outer_scan{new planner::SeqScanPlan(&GetTestTable(OuterTableId()),
+                                              nullptr, {0, 1, 2})};
+  join_plan->AddChild(std::move(outer_scan));
+
+  planner::BindingContext context;
+  join_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1, 2}, context};
+  CompileAndExecute(*join_plan, buffer);
+  results = buffer.GetOutputTuples();
+}
+
+TEST_F(NestedLoopIndexJoinTranslatorTest, SingleColumnJoin) {
+  // The outer A values are 0, 10, ..., 190, half of them have a match
+  LoadTestTable(OuterTableId(), 20);
+
+  std::vector<codegen::WrappedTuple> results;
+  PerformJoin(0, results);
+  ASSERT_EQ(10, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(CmpBool::TRUE,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(2)));
+  }
+}
+
+TEST_F(NestedLoopIndexJoinTranslatorTest, CastKeyJoin) {
+  // The DECIMAL C values are cast to the INTEGER key. Values out of its range
+  // match nothing.
+  InsertOuterRow(1, 30);
+  InsertOuterRow(2, 1e20);
+  InsertOuterRow(3, 90);
+  InsertOuterRow(4, -1e20);
+  InsertOuterRow(5, 100);
+
+  std::vector<codegen::WrappedTuple> results;
+  PerformJoin(2, results);
+  ASSERT_EQ(2, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(CmpBool::TRUE,
+              tuple.GetValue(1).CompareEquals(tuple.GetValue(2)));
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "catalog/catalog.h"
+#include "codegen/query_cache.h"
 #include "codegen/query_compiler.h"
 #include "codegen/testing_codegen_util.h"
 #include "common/harness.h"
@@ -606,5 +607,59 @@ TEST_F(ParameterizationTest, ParamParameterWithOperatersLeftHand) {
   EXPECT_TRUE(cached);
 }
 
+// Tests whether a prepared statement is compiled once and re-executed with
+// new parameter values, recompiling only when the parameter types change
+TEST_F(ParameterizationTest, PreparedStatementReuse) {
+  codegen::QueryCache::Instance().Clear();
+
+  // SELECT a FROM table where a >= ?;
+  auto *a_col_exp =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  auto *param_exp = new expression::ParameterValueExpression(0);
+  auto *a_gte_param = new expression::ComparisonExpression(
+      ExpressionType::COMPARE_GREATERTHANOREQUALTO, a_col_exp, param_exp);
+
+  std::shared_ptr<planner::SeqScanPlan> scan{new planner::SeqScanPlan{
+      &GetTestTable(TestTableId()), a_gte_param, {0}}};
+  planner::BindingContext context;
+  scan->PerformBinding(context);
+
+  EXPECT_TRUE(codegen::QueryCompiler::IsSupported(*scan));
+
+  bool cached;
+  codegen::BufferingConsumer buffer{{0}, context};
+  CompileAndExecuteCache(scan, buffer, cached,
+                         {type::ValueFactory::GetIntegerValue(20)});
+  EXPECT_EQ(NumRowsInTestTable() - 2, buffer.GetOutputTuples().size());
+  EXPECT_FALSE(cached);
+
+  // Re-execute the same plan with a different value
+  codegen::BufferingConsumer buffer_2{{0}, context};
+  CompileAndExecuteCache(scan, buffer_2, cached,
+                         {type::ValueFactory::GetIntegerValue(30)});
+  EXPECT_EQ(NumRowsInTestTable() - 3, buffer_2.GetOutputTuples().size());
+  EXPECT_TRUE(cached);
+  EXPECT_EQ(1, codegen::QueryCache::Instance().GetCount());
+
+  // A NULL parameter needs code that checks for NULL
+  codegen::BufferingConsumer buffer_3{{0}, context};
+  CompileAndExecuteCache(
+      scan, buffer_3, cached,
+      {type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER)});
+  EXPECT_EQ(0, buffer_3.GetOutputTuples().size());
+  EXPECT_FALSE(cached);
+  EXPECT_EQ(2, codegen::QueryCache::Instance().GetCount());
+
+  // Both compiled versions stay available
+  codegen::BufferingConsumer buffer_4{{0}, context};
+  CompileAndExecuteCache(scan, buffer_4, cached,
+                         {type::ValueFactory::GetIntegerValue(40)});
+  EXPECT_EQ(NumRowsInTestTable() - 4, buffer_4.GetOutputTuples().size());
+  EXPECT_TRUE(cached);
+  EXPECT_EQ(2, codegen::QueryCache::Instance().GetCount());
+
+  codegen::QueryCache::Instance().Clear();
+}
+
 }  // namespace test
 }  // namespace peloton
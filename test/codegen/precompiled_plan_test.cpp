@@ -0,0 +1,229 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// precompiled_plan_test.cpp
+//
+// Identification: test/codegen/precompiled_plan_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/testing_codegen_util.h"
+
+#include "codegen/precompiled_plan.h"
+#include "codegen/query_parameters.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "expression/conjunction_expression.h"
+#include "expression/expression_util.h"
+#include "planner/insert_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "planner/update_plan.h"
+
+namespace peloton {
+namespace test {
+
+class PrecompiledPlanTest : public PelotonCodeGenTest {
+ public:
+  PrecompiledPlanTest() : PelotonCodeGenTest(), num_rows_to_insert(64) {
+    // Load test table
+    LoadTestTable(TestTableId(), num_rows_to_insert);
+  }
+
+  uint32_t NumRowsInTestTable() const { return num_rows_to_insert; }
+
+  oid_t TestTableId() { return test_table_oids[0]; }
+
+  // Match the plan against the precompiled plans
+  std::unique_ptr<codegen::PrecompiledPlan> Match(planner::AbstractPlan &plan) {
+    codegen::QueryParameters parameters(plan, {});
+    return codegen::PrecompiledPlan::Match(plan, parameters);
+  }
+
+  // Execute the plan precompiled, in its own transaction
+  void ExecutePrecompiled(planner::AbstractPlan &plan,
+                          const std::vector<oid_t> &output_columns,
+                          codegen::BufferingConsumer &consumer) {
+    auto precompiled = Match(plan);
+    ASSERT_NE(nullptr, precompiled);
+
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto *txn = txn_manager.BeginTransaction();
+    executor::ExecutorContext executor_context{
+        txn, codegen::QueryParameters(plan, {})};
+    precompiled->Execute(executor_context, output_columns, consumer);
+    txn_manager.CommitTransaction(txn);
+  }
+
+ private:
+  uint32_t num_rows_to_insert;
+};
+
+TEST_F(PrecompiledPlanTest, ScanWithPredicate) {
+  //
+  // SELECT a, b, c FROM table where a >= 20 AND b < 401;
+  //
+
+  // Setup the predicate
+  auto *a_gte_20 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(20))
+          .release();
+  auto *b_lt_401 =
+      CmpLtExpr(ColRefExpr(type::TypeId::INTEGER, 1), ConstIntExpr(401))
+          .release();
+  auto *predicate = new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_AND, a_gte_20, b_lt_401);
+
+  // Setup the scan plan node
+  auto &table = GetTestTable(TestTableId());
+  planner::SeqScanPlan scan{&table, predicate, {0, 1, 2}};
+
+  // Do binding
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  // Execute precompiled, and compiled
+  codegen::BufferingConsumer precompiled{{0, 1, 2}, context};
+  ExecutePrecompiled(scan, {0, 1, 2}, precompiled);
+  codegen::BufferingConsumer compiled{{0, 1, 2}, context};
+  CompileAndExecute(scan, compiled);
+
+  // Rows 2 to 39 qualify, both ways
+  const auto &results = precompiled.GetOutputTuples();
+  const auto &expected = compiled.GetOutputTuples();
+  ASSERT_EQ(38, results.size());
+  ASSERT_EQ(expected.size(), results.size());
+  for (uint32_t i = 0; i < results.size(); i++) {
+    for (uint32_t col = 0; col < 3; col++) {
+      EXPECT_EQ(CmpBool::TRUE, results[i].GetValue(col).CompareEquals(
+                                   expected[i].GetValue(col)));
+    }
+  }
+}
+
+TEST_F(PrecompiledPlanTest, UnsupportedPlans) {
+  auto &table = GetTestTable(TestTableId());
+
+  // SELECT a FROM table where a + 1 >= 20; is compiled
+  auto *a_plus_1 = OpExpr(ExpressionType::OPERATOR_PLUS, type::TypeId::INTEGER,
+                          ColRefExpr(type::TypeId::INTEGER, 0),
+                          ConstIntExpr(1))
+                       .release();
+  auto *predicate = new expression::ComparisonExpression(
+      ExpressionType::COMPARE_GREATERTHANOREQUALTO, a_plus_1,
+      ConstIntExpr(20).release());
+  planner::SeqScanPlan scan{&table, predicate, {0}};
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+  EXPECT_EQ(nullptr, Match(scan));
+
+  // SELECT a FROM table where d = '3'; is compiled too, as d is a varchar
+  auto *d_eq_3 = CmpEqExpr(ColRefExpr(type::TypeId::VARCHAR, 3),
+                           ExpressionPtr{new expression::ConstantValueExpression(
+                               type::ValueFactory::GetVarcharValue("3"))})
+                     .release();
+  planner::SeqScanPlan varchar_scan{&table, d_eq_3, {0}};
+  planner::BindingContext varchar_context;
+  varchar_scan.PerformBinding(varchar_context);
+  EXPECT_EQ(nullptr, Match(varchar_scan));
+}
+
+TEST_F(PrecompiledPlanTest, InsertConstantTuple) {
+  //
+  // INSERT INTO table VALUES (1000, 1001, 1002, 'Tuple1');
+  //
+  auto *table = &GetTestTable(TestTableId());
+
+  std::vector<std::vector<ExpressionPtr>> tuples;
+  tuples.push_back(std::vector<ExpressionPtr>());
+  auto &values = tuples[0];
+  values.emplace_back(new expression::ConstantValueExpression(
+      type::ValueFactory::GetIntegerValue(1000)));
+  values.emplace_back(new expression::ConstantValueExpression(
+      type::ValueFactory::GetIntegerValue(1001)));
+  values.emplace_back(new expression::ConstantValueExpression(
+      type::ValueFactory::GetDecimalValue(1002)));
+  values.emplace_back(new expression::ConstantValueExpression(
+      type::ValueFactory::GetVarcharValue("Tuple1", true)));
+
+  std::vector<std::string> columns;
+  planner::InsertPlan insert{table, &columns, &tuples};
+  planner::BindingContext context;
+  insert.PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{}, context};
+  ExecutePrecompiled(insert, {}, buffer);
+  EXPECT_EQ(NumRowsInTestTable() + 1, table->GetTupleCount());
+
+  // SELECT a, b, c, d FROM table where a = 1000;
+  auto *a_eq_1000 =
+      CmpEqExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(1000))
+          .release();
+  planner::SeqScanPlan scan{table, a_eq_1000, {0, 1, 2, 3}};
+  planner::BindingContext scan_context;
+  scan.PerformBinding(scan_context);
+
+  codegen::BufferingConsumer results_buffer{{0, 1, 2, 3}, scan_context};
+  ExecutePrecompiled(scan, {0, 1, 2, 3}, results_buffer);
+  const auto &results = results_buffer.GetOutputTuples();
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(CmpBool::TRUE, results[0].GetValue(1).CompareEquals(
+                               type::ValueFactory::GetIntegerValue(1001)));
+  EXPECT_EQ(CmpBool::TRUE, results[0].GetValue(2).CompareEquals(
+                               type::ValueFactory::GetDecimalValue(1002)));
+  EXPECT_EQ(CmpBool::TRUE, results[0].GetValue(3).CompareEquals(
+                               type::ValueFactory::GetVarcharValue("Tuple1")));
+}
+
+TEST_F(PrecompiledPlanTest, UpdateWithPredicate) {
+  //
+  // UPDATE table SET b = 1 WHERE a >= 600;
+  //
+  auto *table = &GetTestTable(TestTableId());
+
+  auto *a_gte_600 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(600))
+          .release();
+  std::unique_ptr<planner::SeqScanPlan> scan_plan(
+      new planner::SeqScanPlan(table, a_gte_600, {0, 1, 2, 3}));
+
+  std::unique_ptr<const planner::ProjectInfo> project_info(
+      new planner::ProjectInfo(
+          {{1,
+            planner::DerivedAttribute{
+                expression::ExpressionUtil::ConstantValueFactory(
+                    type::ValueFactory::GetIntegerValue(1))}}},
+          {{0, {0, 0}}, {2, {0, 2}}, {3, {0, 3}}}));
+  planner::UpdatePlan update{table, std::move(project_info)};
+  update.AddChild(std::move(scan_plan));
+
+  planner::BindingContext context;
+  update.PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{}, context};
+  ExecutePrecompiled(update, {}, buffer);
+
+  // SELECT a, b FROM table where b = 1;
+  auto *b_eq_1 =
+      CmpEqExpr(ColRefExpr(type::TypeId::INTEGER, 1), ConstIntExpr(1))
+          .release();
+  planner::SeqScanPlan scan{table, b_eq_1, {0, 1}};
+  planner::BindingContext scan_context;
+  scan.PerformBinding(scan_context);
+
+  // Rows 60 to 63 were updated
+  codegen::BufferingConsumer results_buffer{{0, 1}, scan_context};
+  ExecutePrecompiled(scan, {0, 1}, results_buffer);
+  const auto &results = results_buffer.GetOutputTuples();
+  ASSERT_EQ(4, results.size());
+  for (const auto &row : results) {
+    EXPECT_EQ(CmpBool::TRUE, row.GetValue(0).CompareGreaterThanEquals(
+                                 type::ValueFactory::GetIntegerValue(600)));
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
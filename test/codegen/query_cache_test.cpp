@@ -12,11 +12,20 @@
 
 #include "codegen/testing_codegen_util.h"
 
+#include <atomic>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+
+#include "codegen/persistent_code_cache.h"
 #include "codegen/query_cache.h"
+#include "codegen/query_compiler.h"
 #include "codegen/testing_codegen_util.h"
 #include "codegen/type/decimal_type.h"
 #include "common/timer.h"
 #include "catalog/catalog.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/plan_executor.h"
 #include "expression/conjunction_expression.h"
 #include "expression/operator_expression.h"
 #include "planner/aggregate_plan.h"
@@ -25,6 +34,7 @@
 #include "planner/nested_loop_join_plan.h"
 #include "planner/order_by_plan.h"
 #include "planner/seq_scan_plan.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace test {
@@ -567,5 +577,249 @@ TEST_F(QueryCacheTest, PerformanceBenchmark) {
   LOG_INFO("Time spent w/ codegen & cache is %f ms", timer2.GetDuration());
 }
 
+TEST_F(QueryCacheTest, OptimizationTiers) {
+  using Tier = codegen::CodeContext::OptimizationTier;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // The code of every tier produces the same results
+  for (auto tier : {Tier::Minimal, Tier::Standard, Tier::Aggressive}) {
+    auto hj_plan = GetHashJoinPlan();
+    planner::BindingContext context;
+    hj_plan->PerformBinding(context);
+    codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+
+    codegen::QueryParameters parameters(*hj_plan, {});
+    auto query = codegen::QueryCompiler().Compile(
+        *hj_plan, parameters.GetQueryParametersMap(), buffer, nullptr, tier);
+    EXPECT_EQ(tier, query->GetCodeContext().GetOptimizationTier());
+
+    auto *txn = txn_manager.BeginTransaction();
+    ExecuteSync(*query,
+                std::unique_ptr<executor::ExecutorContext>(
+                    new executor::ExecutorContext(txn, std::move(parameters))),
+                buffer);
+    txn_manager.CommitTransaction(txn);
+
+    const auto &results = buffer.GetOutputTuples();
+    EXPECT_EQ(64, results.size());
+    for (const auto &tuple : results) {
+      EXPECT_EQ(tuple.GetValue(0).CompareEquals(tuple.GetValue(1)),
+                CmpBool::TRUE);
+    }
+  }
+}
+
+TEST_F(QueryCacheTest, RecompileHotQuery) {
+  using Tier = codegen::CodeContext::OptimizationTier;
+  auto &query_cache = codegen::QueryCache::Instance();
+
+  // SELECT b FROM table where a >= 40;
+  std::shared_ptr<planner::SeqScanPlan> scan = GetSeqScanPlan();
+  planner::BindingContext context_1;
+  scan->PerformBinding(context_1);
+  codegen::BufferingConsumer buffer_1{{0}, context_1};
+  bool cached;
+  CompileAndExecuteCache(scan, buffer_1, cached);
+  EXPECT_FALSE(cached);
+
+  auto *query = query_cache.Find(scan);
+  ASSERT_NE(nullptr, query);
+  EXPECT_EQ(Tier::Standard, query->GetCodeContext().GetOptimizationTier());
+  auto aggressive_stats = query_cache.GetTierStats(Tier::Aggressive);
+
+  // The query is recompiled once it ran long enough, but only once
+  EXPECT_FALSE(query_cache.RecordExecution(scan, query, 0.0));
+  EXPECT_TRUE(query_cache.RecordExecution(scan, query, 1e6));
+  EXPECT_FALSE(query_cache.RecordExecution(scan, query, 1e6));
+
+  // The recompilation binds and compiles a private copy of the plan
+  std::shared_ptr<planner::AbstractPlan> scan_copy = scan->CopyTree();
+  ASSERT_NE(nullptr, scan_copy);
+  EXPECT_EQ(scan->Hash(), scan_copy->Hash());
+  EXPECT_TRUE(*scan == *scan_copy);
+  planner::BindingContext copy_context;
+  scan_copy->PerformBinding(copy_context);
+  codegen::BufferingConsumer copy_buffer{{0}, copy_context};
+  codegen::QueryParameters parameters(*scan_copy, {});
+  auto recompiled_query = codegen::QueryCompiler().Compile(
+      *scan_copy, parameters.GetQueryParametersMap(), copy_buffer, nullptr,
+      Tier::Aggressive);
+  query_cache.Replace(scan->Hash(), query, scan_copy,
+                      std::move(recompiled_query));
+  EXPECT_EQ(aggressive_stats.num_compiled + 1,
+            query_cache.GetTierStats(Tier::Aggressive).num_compiled);
+
+  // The recompiled query replaced the original one
+  auto *replacement = query_cache.Find(scan);
+  ASSERT_NE(nullptr, replacement);
+  EXPECT_NE(query, replacement);
+  EXPECT_EQ(Tier::Aggressive,
+            replacement->GetCodeContext().GetOptimizationTier());
+  EXPECT_EQ(1, query_cache.GetCount());
+
+  planner::BindingContext context_2;
+  scan->PerformBinding(context_2);
+  codegen::BufferingConsumer buffer_2{{0}, context_2};
+  CompileAndExecuteCache(scan, buffer_2, cached);
+  EXPECT_TRUE(cached);
+  EXPECT_EQ(NumRowsInTestTable() - 4, buffer_2.GetOutputTuples().size());
+
+  query_cache.Clear();
+}
+
+TEST_F(QueryCacheTest, RecompileHotQueryInBackground) {
+  using Tier = codegen::CodeContext::OptimizationTier;
+  auto &query_cache = codegen::QueryCache::Instance();
+  query_cache.Clear();
+  auto threshold_ms = settings::SettingsManager::GetInt(
+      settings::SettingId::codegen_aggressive_optimization_ms);
+  settings::SettingsManager::SetInt(
+      settings::SettingId::codegen_aggressive_optimization_ms, 1);
+  settings::SettingsManager::SetBool(
+      settings::SettingId::codegen_precompiled_plans, false);
+  auto num_compiled = query_cache.GetTierStats(Tier::Aggressive).num_compiled;
+
+  // SELECT a, b FROM table where a >= 40; through the plan executor
+  std::shared_ptr<planner::AbstractPlan> scan = GetSeqScanPlan();
+  auto execute = [&scan]() {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto *txn = txn_manager.BeginTransaction();
+    size_t num_values = 0;
+    executor::PlanExecutor::ExecutePlan(
+        scan, txn, {}, {},
+        [&num_values](executor::ExecutionResult result,
+                      std::vector<ResultValue> &&values) {
+          EXPECT_EQ(ResultType::SUCCESS, result.m_result);
+          num_values = values.size();
+        });
+    txn_manager.CommitTransaction(txn);
+    return num_values;
+  };
+  const size_t expected_values = 2 * (NumRowsInTestTable() - 4);
+  EXPECT_EQ(expected_values, execute());
+
+  // Keep executing the plan from several threads while the query is
+  // recompiled in the background
+  std::atomic<bool> done(false);
+  std::atomic<size_t> mismatches(0);
+  std::vector<std::thread> threads;
+  for (int thread_id = 0; thread_id < 4; thread_id++) {
+    threads.emplace_back([&] {
+      while (!done) {
+        if (execute() != expected_values) {
+          mismatches++;
+        }
+      }
+    });
+  }
+  for (int wait_ms = 0; wait_ms < 30000; wait_ms++) {
+    if (query_cache.GetTierStats(Tier::Aggressive).num_compiled >
+        num_compiled) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, mismatches);
+
+  // The recompiled query replaced the cached one
+  EXPECT_EQ(num_compiled + 1,
+            query_cache.GetTierStats(Tier::Aggressive).num_compiled);
+  auto *query = query_cache.Find(scan);
+  ASSERT_NE(nullptr, query);
+  EXPECT_EQ(Tier::Aggressive, query->GetCodeContext().GetOptimizationTier());
+  EXPECT_EQ(expected_values, execute());
+  EXPECT_EQ(1, query_cache.GetCount());
+
+  settings::SettingsManager::SetInt(
+      settings::SettingId::codegen_aggressive_optimization_ms, threshold_ms);
+  settings::SettingsManager::SetBool(
+      settings::SettingId::codegen_precompiled_plans, true);
+  query_cache.Clear();
+}
+
+TEST_F(QueryCacheTest, PersistentCodeCache) {
+  auto directory = boost::filesystem::temp_directory_path() /
+                   boost::filesystem::unique_path("code_cache_%%%%%%%%");
+  auto &code_cache = codegen::PersistentCodeCache::Instance();
+  code_cache.SetDirectory(directory.string());
+  ASSERT_TRUE(code_cache.IsEnabled());
+  EXPECT_EQ(0, code_cache.GetCount());
+
+  auto run_join = [this]() {
+    auto plan = GetHashJoinPlan();
+    planner::BindingContext context;
+    plan->PerformBinding(context);
+    codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+    CompileAndExecute(*plan, buffer);
+    return buffer.GetOutputTuples().size();
+  };
+
+  // Compiling the query stores its code on disk
+  auto num_results = run_join();
+  EXPECT_EQ(NumRowsInTestTable(), num_results);
+  EXPECT_EQ(1, code_cache.GetCount());
+
+  // After a "restart", the entry is found again and its code is reused
+  auto num_hits = code_cache.GetNumHits();
+  code_cache.SetDirectory(directory.string());
+  EXPECT_EQ(1, code_cache.GetCount());
+  EXPECT_EQ(num_results, run_join());
+  EXPECT_EQ(1, code_cache.GetCount());
+  EXPECT_EQ(num_hits + 1, code_cache.GetNumHits());
+
+  // The code of another tier gets an entry of its own
+  {
+    auto plan = GetHashJoinPlan();
+    planner::BindingContext context;
+    plan->PerformBinding(context);
+    codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+    codegen::QueryParameters parameters(*plan, {});
+    codegen::QueryCompiler().Compile(
+        *plan, parameters.GetQueryParametersMap(), buffer, nullptr,
+        codegen::CodeContext::OptimizationTier::Aggressive);
+  }
+  EXPECT_EQ(2, code_cache.GetCount());
+  EXPECT_EQ(num_results, run_join());
+  EXPECT_EQ(2, code_cache.GetCount());
+  EXPECT_EQ(num_hits + 2, code_cache.GetNumHits());
+
+  // The code of a scan with a predicate doesn't depend on where the plan is
+  // allocated. The first plan is kept alive, so that the second plan's objects
+  // are allocated elsewhere.
+  auto run_scan = [this](std::shared_ptr<planner::SeqScanPlan> plan) {
+    planner::BindingContext context;
+    plan->PerformBinding(context);
+    codegen::BufferingConsumer buffer{{0, 1, 2}, context};
+    CompileAndExecute(*plan, buffer);
+    return buffer.GetOutputTuples().size();
+  };
+  auto scan_plan_1 = GetSeqScanPlanWithPredicate();
+  auto scan_plan_2 = GetSeqScanPlanWithPredicate();
+  ASSERT_NE(scan_plan_1->GetPredicate(), scan_plan_2->GetPredicate());
+  num_hits = code_cache.GetNumHits();
+  auto num_scan_results = run_scan(scan_plan_1);
+  EXPECT_EQ(3, code_cache.GetCount());
+  EXPECT_EQ(num_hits, code_cache.GetNumHits());
+  EXPECT_EQ(num_scan_results, run_scan(scan_plan_2));
+  EXPECT_EQ(3, code_cache.GetCount());
+  EXPECT_EQ(num_hits + 1, code_cache.GetNumHits());
+
+  // Changing a table the queries access invalidates their code
+  codegen::QueryCache::Instance().Remove(RightTableId());
+  EXPECT_EQ(1, code_cache.GetCount());
+  code_cache.SetDirectory(directory.string());
+  EXPECT_EQ(1, code_cache.GetCount());
+  codegen::QueryCache::Instance().Remove(TestTableId());
+  EXPECT_EQ(0, code_cache.GetCount());
+
+  code_cache.SetDirectory("");
+  EXPECT_FALSE(code_cache.IsEnabled());
+  boost::filesystem::remove_all(directory);
+}
+
 }  // namespace test
 }  // namespace peloton
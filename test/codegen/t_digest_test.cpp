@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// t_digest_test.cpp
+//
+// Identification: test/codegen/t_digest_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "codegen/util/t_digest.h"
+#include "common/harness.h"
+
+namespace peloton {
+namespace test {
+
+using TDigest = codegen::util::TDigest;
+
+class TDigestTest : public PelotonTest {};
+
+TEST_F(TDigestTest, AddTest) {
+  std::vector<char> digest(TDigest::kSize);
+  TDigest::Init(digest.data());
+  EXPECT_TRUE(TDigest::IsEmpty(digest.data()));
+  EXPECT_EQ(0.0, TDigest::Quantile(digest.data(), 0.5));
+
+  // Ascending values 0, ..., 99999
+  const uint32_t num_values = 100000;
+  for (uint32_t i = 0; i < num_values; i++) {
+    TDigest::Add(digest.data(), i);
+  }
+  EXPECT_FALSE(TDigest::IsEmpty(digest.data()));
+
+  EXPECT_EQ(0.0, TDigest::Quantile(digest.data(), 0.0));
+  EXPECT_EQ(num_values - 1, TDigest::Quantile(digest.data(), 1.0));
+  EXPECT_NEAR(num_values / 2, TDigest::Quantile(digest.data(), 0.5),
+              num_values / 100);
+  EXPECT_NEAR(num_values * 0.99, TDigest::Quantile(digest.data(), 0.99),
+              num_values / 100);
+  EXPECT_LE(TDigest::NumCentroids(digest.data()), TDigest::kMaxCentroids);
+}
+
+TEST_F(TDigestTest, MergeTest) {
+  std::vector<char> digest(TDigest::kSize);
+  std::vector<char> other(TDigest::kSize);
+  TDigest::Init(digest.data());
+
+  // Merge many full digests of interleaved values, so that every merge has
+  // twice as many centroids as the digest can store
+  const uint32_t num_digests = 1000;
+  for (uint32_t d = 0; d < num_digests; d++) {
+    TDigest::Init(other.data());
+    for (uint32_t i = 0; i < TDigest::kBufferSize * 10; i++) {
+      TDigest::Add(other.data(), i * num_digests + d);
+    }
+    TDigest::Merge(digest.data(), other.data());
+    ASSERT_LE(TDigest::NumCentroids(digest.data()), TDigest::kMaxCentroids);
+  }
+
+  const double max = TDigest::kBufferSize * 10 * num_digests - 1;
+  EXPECT_EQ(0.0, TDigest::Quantile(digest.data(), 0.0));
+  EXPECT_EQ(max, TDigest::Quantile(digest.data(), 1.0));
+  EXPECT_NEAR(max / 2, TDigest::Quantile(digest.data(), 0.5), max / 100);
+  EXPECT_NEAR(max / 10, TDigest::Quantile(digest.data(), 0.1), max / 100);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -10,14 +10,19 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+
 #include "storage/storage_manager.h"
 #include "catalog/catalog.h"
 #include "codegen/query_compiler.h"
 #include "common/harness.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "expression/comparison_expression.h"
 #include "expression/conjunction_expression.h"
 #include "expression/operator_expression.h"
 #include "planner/seq_scan_plan.h"
+#include "settings/settings_manager.h"
+#include "storage/string_dictionary.h"
 
 #include "codegen/testing_codegen_util.h"
 
@@ -585,5 +590,203 @@ TEST_F(TableScanTranslatorTest, ScanWithModuloPredicate) {
                                      type::ValueFactory::GetIntegerValue(1)));
 }
 
+TEST_F(TableScanTranslatorTest, ScanWithInListPredicate) {
+  //
+  // SELECT a, b FROM table where a IN (10, 20, 35, 10000);
+  //
+
+  // Setup the predicate, a short list that is unrolled
+  std::vector<expression::AbstractExpression *> list = {
+      ConstIntExpr(10).release(), ConstIntExpr(20).release(),
+      ConstIntExpr(35).release(), ConstIntExpr(10000).release()};
+  auto *a_in_list = new expression::ComparisonExpression(
+      ColRefExpr(type::TypeId::INTEGER, 0).release(), list);
+
+  // Setup the scan plan node
+  auto &table = GetTestTable(TestTableId());
+  planner::SeqScanPlan scan{&table, a_in_list, {0, 1}};
+
+  // Do binding
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(scan, buffer);
+
+  // Check output results
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(2, results.size());
+  EXPECT_EQ(CmpBool::TRUE, results[0].GetValue(0).CompareEquals(
+                                     type::ValueFactory::GetIntegerValue(10)));
+  EXPECT_EQ(CmpBool::TRUE, results[1].GetValue(0).CompareEquals(
+                                     type::ValueFactory::GetIntegerValue(20)));
+}
+
+TEST_F(TableScanTranslatorTest, ScanWithLongInListPredicate) {
+  //
+  // SELECT a, b FROM table where a IN (0, 5, 10, ..., 195, 0, 5, ...);
+  //
+
+  // Setup the predicate, a list long enough to be put in a hash set. Every
+  // item is in the list twice.
+  std::vector<expression::AbstractExpression *> list;
+  for (uint32_t i = 0; i < 80; i++) {
+    list.push_back(ConstIntExpr((i % 40) * 5).release());
+  }
+  auto *a_in_list = new expression::ComparisonExpression(
+      ColRefExpr(type::TypeId::INTEGER, 0).release(), list);
+
+  // Setup the scan plan node
+  auto &table = GetTestTable(TestTableId());
+  planner::SeqScanPlan scan{&table, a_in_list, {0, 1}};
+
+  // Do binding
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(scan, buffer);
+
+  // Check output results: the multiples of 10 below 200
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(20, results.size());
+  for (uint32_t i = 0; i < results.size(); i++) {
+    EXPECT_EQ(CmpBool::TRUE,
+              results[i].GetValue(0).CompareEquals(
+                  type::ValueFactory::GetIntegerValue(i * 10)));
+  }
+}
+
+TEST_F(TableScanTranslatorTest, ScanWithSIMDPredicate) {
+  // Insert 10 rows where b is NULL
+  const bool insert_nulls = true;
+  LoadTestTable(TestTableId(), 10, insert_nulls);
+
+  //
+  // SELECT a, b FROM table
+  // WHERE b <> 5 AND 700 > a AND c <> 302 AND a + a >= 200;
+  //
+  // The first three conjuncts are evaluated using SIMD kernels, the last one
+  // row-at-a-time. The rows with a NULL b must not pass the first kernel.
+  //
+
+  auto run_scan = [this](bool use_simd) {
+    settings::SettingsManager::SetBool(
+        settings::SettingId::codegen_simd_predicates, use_simd);
+
+    ExpressionPtr b_ne_5 = CmpExpr(ExpressionType::COMPARE_NOTEQUAL,
+                                   ColRefExpr(type::TypeId::INTEGER, 1),
+                                   ConstIntExpr(5));
+    ExpressionPtr a_lt_700 =
+        CmpGtExpr(ConstIntExpr(700), ColRefExpr(type::TypeId::INTEGER, 0));
+    ExpressionPtr c_ne_302 = CmpExpr(ExpressionType::COMPARE_NOTEQUAL,
+                                     ColRefExpr(type::TypeId::DECIMAL, 2),
+                                     ConstIntExpr(302));
+    ExpressionPtr a_plus_a = OpExpr(ExpressionType::OPERATOR_PLUS,
+                                    type::TypeId::INTEGER,
+                                    ColRefExpr(type::TypeId::INTEGER, 0),
+                                    ColRefExpr(type::TypeId::INTEGER, 0));
+    ExpressionPtr a_plus_a_gte_200 =
+        CmpGteExpr(std::move(a_plus_a), ConstIntExpr(200));
+
+    auto *conj = new expression::ConjunctionExpression(
+        ExpressionType::CONJUNCTION_AND, b_ne_5.release(),
+        new expression::ConjunctionExpression(
+            ExpressionType::CONJUNCTION_AND, a_lt_700.release(),
+            new expression::ConjunctionExpression(
+                ExpressionType::CONJUNCTION_AND, c_ne_302.release(),
+                a_plus_a_gte_200.release())));
+
+    planner::SeqScanPlan scan{&GetTestTable(TestTableId()), conj, {0, 1}};
+
+    planner::BindingContext context;
+    scan.PerformBinding(context);
+
+    codegen::BufferingConsumer buffer{{0, 1}, context};
+    CompileAndExecute(scan, buffer);
+
+    std::vector<int32_t> a_vals;
+    for (const auto &tuple : buffer.GetOutputTuples()) {
+      a_vals.push_back(tuple.GetValue(0).GetAs<int32_t>());
+    }
+    return a_vals;
+  };
+
+  auto simd_results = run_scan(true);
+  auto tuple_results = run_scan(false);
+  settings::SettingsManager::SetBool(
+      settings::SettingId::codegen_simd_predicates, true);
+
+  // Rows 10 to 63, except row 30
+  ASSERT_EQ(53, simd_results.size());
+  EXPECT_EQ(tuple_results, simd_results);
+  for (uint32_t i = 0; i < simd_results.size(); i++) {
+    uint32_t row = i + 10 + (i >= 20 ? 1 : 0);
+    EXPECT_EQ(static_cast<int32_t>(row * 10), simd_results[i]);
+  }
+}
+
+TEST_F(TableScanTranslatorTest, ScanWithDictionaryPredicates) {
+  // Encode column d of an empty table, whose dictionary fits the values of
+  // the first 30 rows only
+  auto &table = GetTestTable(test_table_oids[1]);
+  settings::SettingsManager::SetInt(settings::SettingId::dictionary_max_size,
+                                    30);
+  table.EnableDictionaryEncoding(3);
+  settings::SettingsManager::SetInt(settings::SettingId::dictionary_max_size,
+                                    1048576);
+  LoadTestTable(test_table_oids[1], NumRowsInTestTable());
+  EXPECT_EQ(30, table.GetColumnDictionary(3)->GetSize());
+
+  auto run_scan = [this, &table](expression::AbstractExpression *predicate) {
+    planner::SeqScanPlan scan{&table, predicate, {0, 3}};
+    planner::BindingContext context;
+    scan.PerformBinding(context);
+
+    codegen::BufferingConsumer buffer{{0, 3}, context};
+    CompileAndExecute(scan, buffer);
+
+    std::vector<int32_t> a_vals;
+    for (const auto &tuple : buffer.GetOutputTuples()) {
+      a_vals.push_back(tuple.GetValue(0).GetAs<int32_t>());
+    }
+    return a_vals;
+  };
+  auto d_const = [](const std::string &str) {
+    return new expression::ConstantValueExpression(
+        type::ValueFactory::GetVarcharValue(str));
+  };
+
+  // SELECT a, d FROM table WHERE d IN ('13', '293', '13'); compares codes
+  std::vector<expression::AbstractExpression *> list = {
+      d_const("13"), d_const("293"), d_const("13")};
+  auto *d_in_list = new expression::ComparisonExpression(
+      ColRefExpr(type::TypeId::VARCHAR, 3).release(), list);
+  EXPECT_EQ(std::vector<int32_t>({10, 290}), run_scan(d_in_list));
+
+  // SELECT a, d FROM table WHERE d <> '13'; compares codes, and rows whose d
+  // is not in the dictionary never match the code
+  auto *d_ne_13 = new expression::ComparisonExpression(
+      ExpressionType::COMPARE_NOTEQUAL,
+      ColRefExpr(type::TypeId::VARCHAR, 3).release(), d_const("13"));
+  auto a_vals = run_scan(d_ne_13);
+  ASSERT_EQ(NumRowsInTestTable() - 1, a_vals.size());
+  EXPECT_EQ(0, std::count(a_vals.begin(), a_vals.end(), 10));
+
+  // SELECT a, d FROM table WHERE d IN ('13', '603'); compares strings, as
+  // '603' is not in the dictionary
+  std::vector<expression::AbstractExpression *> unencoded_list = {
+      d_const("13"), d_const("603")};
+  auto *d_in_unencoded = new expression::ComparisonExpression(
+      ColRefExpr(type::TypeId::VARCHAR, 3).release(), unencoded_list);
+  EXPECT_EQ(std::vector<int32_t>({10, 600}), run_scan(d_in_unencoded));
+}
+
 }  // namespace test
 }  // namespace peloton
\ No newline at end of file
@@ -227,12 +227,14 @@ codegen::QueryCompiler::CompileStats PelotonCodeGenTest::CompileAndExecuteCache(
 
   // Compile
   codegen::QueryCompiler::CompileStats stats;
-  codegen::Query *query = codegen::QueryCache::Instance().Find(plan);
+  const auto &parameters_map =
+      executor_context->GetParams().GetQueryParametersMap();
+  codegen::Query *query =
+      codegen::QueryCache::Instance().Find(plan, &parameters_map);
   cached = (query != nullptr);
   if (query == nullptr) {
     codegen::QueryCompiler compiler;
-    auto compiled_query = compiler.Compile(
-        *plan, executor_context->GetParams().GetQueryParametersMap(), consumer);
+    auto compiled_query = compiler.Compile(*plan, parameters_map, consumer);
     query = compiled_query.get();
     codegen::QueryCache::Instance().Add(plan, std::move(compiled_query));
   }
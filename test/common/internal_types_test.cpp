@@ -183,7 +183,9 @@ TEST_F(InternalTypesTests, ExpressionTypeTest) {
       ExpressionType::VALUE_SCALAR, ExpressionType::AGGREGATE_COUNT,
       ExpressionType::AGGREGATE_COUNT_STAR, ExpressionType::AGGREGATE_SUM,
       ExpressionType::AGGREGATE_MIN, ExpressionType::AGGREGATE_MAX,
-      ExpressionType::AGGREGATE_AVG, ExpressionType::FUNCTION,
+      ExpressionType::AGGREGATE_AVG,
+      ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT,
+      ExpressionType::AGGREGATE_APPROX_PERCENTILE, ExpressionType::FUNCTION,
       ExpressionType::HASH_RANGE, ExpressionType::OPERATOR_CASE_EXPR,
       ExpressionType::OPERATOR_NULLIF, ExpressionType::OPERATOR_COALESCE,
       ExpressionType::ROW_SUBQUERY, ExpressionType::SELECT_SUBQUERY,
@@ -292,7 +294,8 @@ TEST_F(InternalTypesTests, HybridScanTypeTest) {
 TEST_F(InternalTypesTests, JoinTypeTest) {
   std::vector<JoinType> list = {JoinType::INVALID, JoinType::LEFT,
                                 JoinType::RIGHT,   JoinType::INNER,
-                                JoinType::OUTER,   JoinType::SEMI};
+                                JoinType::OUTER,   JoinType::SEMI,
+                                JoinType::ANTI};
 
   // Make sure that ToString and FromString work
   for (auto val : list) {
@@ -0,0 +1,203 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache_test.cpp
+//
+// Identification: test/common/plan_cache_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/plan_cache.h"
+#include "common/statement.h"
+#include "common/statement_cache_manager.h"
+#include "planner/seq_scan_plan.h"
+
+#include "common/harness.h"
+
+namespace peloton {
+namespace test {
+
+class PlanCacheTests : public PelotonTest {
+ protected:
+  std::shared_ptr<Statement> MakeStatement(const std::string &query,
+                                           std::set<oid_t> table_ids) {
+    auto statement = std::make_shared<Statement>("unamed", query);
+    statement->SetPlanTree(std::make_shared<planner::SeqScanPlan>());
+    statement->SetReferencedTables(table_ids);
+    return statement;
+  }
+};
+
+TEST_F(PlanCacheTests, NormalizeTest) {
+  std::string normalized_query;
+  std::vector<type::Value> params;
+
+  // Literals compared against an expression are lifted to parameters
+  EXPECT_TRUE(PlanCache::NormalizeQuery(
+      "SELECT a, b  FROM Foo\n WHERE a = 42 AND b <> 'it''s' AND c>=1.5;",
+      normalized_query, params));
+  EXPECT_EQ("select a, b from foo where a = $1 and b <> $2 and c>=$3",
+            normalized_query);
+  ASSERT_EQ(3, params.size());
+  EXPECT_EQ(type::TypeId::INTEGER, params[0].GetTypeId());
+  EXPECT_EQ(42, params[0].GetAs<int32_t>());
+  EXPECT_EQ(type::TypeId::VARCHAR, params[1].GetTypeId());
+  EXPECT_EQ("it's", params[1].ToString());
+  EXPECT_EQ(type::TypeId::DECIMAL, params[2].GetTypeId());
+  EXPECT_EQ(1.5, params[2].GetAs<double>());
+
+  // Queries differing only in those literals share the normalized text
+  std::string other_query;
+  EXPECT_TRUE(PlanCache::NormalizeQuery(
+      "select a, b from foo where a = 7 and b <> 'x' and c>=2;", other_query,
+      params));
+  EXPECT_EQ(normalized_query, other_query);
+  // ... though an integer literal keeps its own type
+  EXPECT_EQ(type::TypeId::INTEGER, params[2].GetTypeId());
+
+  // Integers that do not fit into 32 bits are decimals, as in the parser
+  EXPECT_TRUE(PlanCache::NormalizeQuery(
+      "DELETE FROM foo WHERE a = 4294967296", normalized_query, params));
+  EXPECT_EQ("delete from foo where a = $1", normalized_query);
+  EXPECT_EQ(type::TypeId::DECIMAL, params[0].GetTypeId());
+
+  // Other literals, quoted identifiers and casts are kept
+  EXPECT_TRUE(PlanCache::NormalizeQuery(
+      "UPDATE foo SET a = 2, b = a + 1 WHERE \"B\" = '1'::INT AND c = 3 "
+      "LIMIT 10",
+      normalized_query, params));
+  EXPECT_EQ(
+      "update foo set a = 2, b = a + 1 where \"B\" = '1'::int and c = $1 "
+      "limit 10",
+      normalized_query);
+  EXPECT_EQ(1, params.size());
+
+  // Quoted literals that may be dates, timestamps or numbers are cast to the
+  // type of the column by the planner, and kept
+  EXPECT_TRUE(PlanCache::NormalizeQuery(
+      "SELECT * FROM foo WHERE d >= '1995-01-01' AND e < '1.5' AND f = 'x'",
+      normalized_query, params));
+  EXPECT_EQ(
+      "select * from foo where d >= '1995-01-01' and e < '1.5' and f = $1",
+      normalized_query);
+  ASSERT_EQ(1, params.size());
+  EXPECT_EQ(type::TypeId::VARCHAR, params[0].GetTypeId());
+
+  // Queries left to the regular path
+  EXPECT_FALSE(
+      PlanCache::NormalizeQuery("INSERT INTO foo VALUES (1, 2)",
+                                normalized_query, params));
+  EXPECT_FALSE(PlanCache::NormalizeQuery("SELECT * FROM foo WHERE a = $1",
+                                         normalized_query, params));
+  EXPECT_FALSE(PlanCache::NormalizeQuery(
+      "SELECT * FROM foo -- comment", normalized_query, params));
+  EXPECT_FALSE(PlanCache::NormalizeQuery("SELECT 1; SELECT 2",
+                                         normalized_query, params));
+  EXPECT_FALSE(PlanCache::NormalizeQuery("SELECT * FROM foo WHERE a = 'x",
+                                         normalized_query, params));
+}
+
+TEST_F(PlanCacheTests, AcquireReleaseTest) {
+  auto &plan_cache = PlanCache::GetInstance();
+  plan_cache.Clear();
+
+  std::string query = "select * from foo where a = $1";
+  EXPECT_EQ(nullptr, plan_cache.Acquire(DEFAULT_DB_NAME, query));
+
+  // A statement prepared after a miss is cached once released
+  auto statement = MakeStatement(query, {1});
+  plan_cache.Release(DEFAULT_DB_NAME, statement);
+  EXPECT_EQ(1, plan_cache.GetCount());
+
+  // It is checked out by one connection at a time
+  auto cached_statement = plan_cache.Acquire(DEFAULT_DB_NAME, query);
+  EXPECT_EQ(statement, cached_statement);
+  EXPECT_EQ(nullptr, plan_cache.Acquire(DEFAULT_DB_NAME, query));
+
+  // Another connection prepares its own statement, both are pooled
+  auto other_statement = MakeStatement(query, {1});
+  plan_cache.Release(DEFAULT_DB_NAME, other_statement);
+  plan_cache.Release(DEFAULT_DB_NAME, cached_statement);
+  EXPECT_EQ(1, plan_cache.GetCount());
+  EXPECT_NE(nullptr, plan_cache.Acquire(DEFAULT_DB_NAME, query));
+  EXPECT_NE(nullptr, plan_cache.Acquire(DEFAULT_DB_NAME, query));
+  EXPECT_EQ(nullptr, plan_cache.Acquire(DEFAULT_DB_NAME, query));
+  plan_cache.Release(DEFAULT_DB_NAME, statement);
+  plan_cache.Release(DEFAULT_DB_NAME, other_statement);
+
+  // The least recently used query is evicted
+  auto capacity = plan_cache.GetCapacity();
+  plan_cache.SetCapacity(1);
+  plan_cache.Release(DEFAULT_DB_NAME, MakeStatement("select * from bar", {2}));
+  EXPECT_EQ(1, plan_cache.GetCount());
+  EXPECT_EQ(nullptr, plan_cache.Acquire(DEFAULT_DB_NAME, query));
+  EXPECT_TRUE(statement->GetNeedsReplan());
+  plan_cache.SetCapacity(capacity);
+
+  plan_cache.Clear();
+  EXPECT_EQ(0, plan_cache.GetCount());
+}
+
+TEST_F(PlanCacheTests, InvalidateTest) {
+  auto &plan_cache = PlanCache::GetInstance();
+  plan_cache.Clear();
+  StatementCacheManager::Init();
+  auto statement_cache_manager = StatementCacheManager::GetStmtCacheManager();
+
+  std::string query = "select * from foo where a = $1";
+  std::string other_query = "select * from bar where a = $1";
+  auto statement = MakeStatement(query, {1});
+  auto other_statement = MakeStatement(other_query, {2});
+  plan_cache.Release(DEFAULT_DB_NAME, statement);
+  plan_cache.Release(DEFAULT_DB_NAME, other_statement);
+
+  // Dropping a table invalidates the queries that reference it, even the
+  // statements that are checked out
+  auto cached_statement = plan_cache.Acquire(DEFAULT_DB_NAME, query);
+  statement_cache_manager->InvalidateTableOid(1);
+  EXPECT_EQ(1, plan_cache.GetCount());
+  EXPECT_TRUE(cached_statement->GetNeedsReplan());
+  EXPECT_FALSE(other_statement->GetNeedsReplan());
+
+  // A stale statement is not returned to the cache
+  plan_cache.Release(DEFAULT_DB_NAME, cached_statement);
+  EXPECT_EQ(nullptr, plan_cache.Acquire(DEFAULT_DB_NAME, query));
+  EXPECT_EQ(other_statement, plan_cache.Acquire(DEFAULT_DB_NAME, other_query));
+
+  plan_cache.Clear();
+}
+
+TEST_F(PlanCacheTests, MultipleDatabasesTest) {
+  auto &plan_cache = PlanCache::GetInstance();
+  plan_cache.Clear();
+
+  // The same query text in two databases plans against different tables
+  std::string query = "select * from foo where a = $1";
+  auto statement = MakeStatement(query, {1});
+  auto other_statement = MakeStatement(query, {2});
+  plan_cache.Release("db1", statement);
+  plan_cache.Release("db2", other_statement);
+  EXPECT_EQ(2, plan_cache.GetCount());
+
+  // Each connection only gets the statement of its own database
+  EXPECT_EQ(nullptr, plan_cache.Acquire(DEFAULT_DB_NAME, query));
+  EXPECT_EQ(statement, plan_cache.Acquire("db1", query));
+  EXPECT_EQ(nullptr, plan_cache.Acquire("db1", query));
+  EXPECT_EQ(other_statement, plan_cache.Acquire("db2", query));
+  plan_cache.Release("db1", statement);
+  plan_cache.Release("db2", other_statement);
+
+  // Dropping the table of one database keeps the other's statement
+  plan_cache.InvalidateTableOid(1);
+  EXPECT_EQ(1, plan_cache.GetCount());
+  EXPECT_EQ(nullptr, plan_cache.Acquire("db1", query));
+  EXPECT_EQ(other_statement, plan_cache.Acquire("db2", query));
+
+  plan_cache.Clear();
+}
+
+}  // namespace test
+}  // namespace peloton
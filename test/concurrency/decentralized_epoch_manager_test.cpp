@@ -11,6 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <mutex>
+#include <set>
+
 #include "concurrency/epoch_manager_factory.h"
 #include "concurrency/testing_transaction_util.h"
 #include "common/harness.h"
@@ -137,6 +140,44 @@ TEST_F(DecentralizedEpochManagerTests, MultipleThreadsTest) {
 }
 
 
+TEST_F(DecentralizedEpochManagerTests, TransactionIdTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(2);
+
+  const size_t thread_count = 4;
+  const size_t txn_count = 1000;
+  std::set<cid_t> all_ids;
+  std::mutex all_ids_lock;
+
+  // threads share the same local epoch and reserve ids in blocks.
+  auto enter_exit = [&](UNUSED_ATTRIBUTE uint64_t thread_itr) {
+    std::vector<cid_t> ids;
+    for (size_t txn_itr = 0; txn_itr < txn_count; txn_itr++) {
+      cid_t txn_id = epoch_manager.EnterEpoch(0, TimestampType::READ);
+      // ids of a thread are increasing.
+      if (!ids.empty()) {
+        EXPECT_LT(ids.back(), txn_id);
+      }
+      ids.push_back(txn_id);
+      epoch_manager.ExitEpoch(0, txn_id >> 32);
+    }
+    std::lock_guard<std::mutex> guard(all_ids_lock);
+    all_ids.insert(ids.begin(), ids.end());
+  };
+  LaunchParallelTest(thread_count, enter_exit);
+
+  // ids are unique across threads.
+  EXPECT_EQ(thread_count * txn_count, all_ids.size());
+  EXPECT_EQ(1, epoch_manager.GetExpiredEpochId());
+
+  // resetting the counter invalidates the reserved blocks.
+  epoch_manager.SetCurrentEpochId(3);
+  cid_t txn_id = epoch_manager.EnterEpoch(0, TimestampType::READ);
+  EXPECT_EQ((3UL << 32) | 0, txn_id);
+  epoch_manager.ExitEpoch(0, 3);
+}
+
+
 }  // namespace test
 }  // namespace peloton
 
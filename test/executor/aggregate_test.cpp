@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -28,6 +29,7 @@
 #include "expression/expression_util.h"
 #include "planner/abstract_plan.h"
 #include "planner/aggregate_plan.h"
+#include "settings/settings_manager.h"
 #include "storage/data_table.h"
 
 #include "executor/mock_executor.h"
@@ -863,5 +865,511 @@ TEST_F(AggregateTests, PlainSumCountDistinctTest) {
   EXPECT_TRUE(cmp == CmpBool::TRUE);
 }
 
+TEST_F(AggregateTests, PlainApproxAggregateTest) {
+  // SELECT APPROX_COUNT_DISTINCT(a), APPROX_PERCENTILE(a, 0.5) from table
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  // Create a table and wrap it in logical tiles
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), 2 * tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1)));
+
+  // (1-5) Setup plan node
+
+  // 1) Set up group-by columns
+  std::vector<oid_t> group_by_columns;
+
+  // 2) Set up project info
+  DirectMapList direct_map_list = {{0, {1, 0}}, {1, {1, 1}}};
+
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  // 3) Set up unique aggregates
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  planner::AggregatePlan::AggTerm approxCountDistinctA(
+      ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    0));
+  planner::AggregatePlan::AggTerm approxMedianA(
+      ExpressionType::AGGREGATE_APPROX_PERCENTILE,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    0),
+      false, 0.5);
+  agg_terms.push_back(approxCountDistinctA);
+  agg_terms.push_back(approxMedianA);
+
+  // 4) Set up predicate (empty)
+  std::unique_ptr<const expression::AbstractExpression> predicate(nullptr);
+
+  // 5) Create output table schema
+  auto data_table_schema = data_table.get()->GetSchema();
+  std::vector<oid_t> set = {0, 2};
+  std::vector<catalog::Column> columns;
+  for (auto column_index : set) {
+    columns.push_back(data_table_schema->GetColumn(column_index));
+  }
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema(columns));
+
+  // OK) Create the plan node
+  planner::AggregatePlan node(std::move(proj_info), std::move(predicate),
+                              std::move(agg_terms), std::move(group_by_columns),
+                              output_table_schema, AggregateType::PLAIN);
+
+  // Create and set up executor
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::AggregateExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  EXPECT_TRUE(executor.Execute());
+
+  txn_manager.CommitTransaction(txn);
+
+  // Verify result: a is 0, 10, ..., 10 * (2 * tuple_count - 1)
+  std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+  EXPECT_TRUE(result_tile.get() != nullptr);
+  type::Value val = (result_tile->GetValue(0, 0));
+  EXPECT_NEAR(2 * tuple_count, type::ValuePeeker::PeekBigInt(
+                                  val.CastAs(type::TypeId::BIGINT)),
+              5);
+  val = (result_tile->GetValue(0, 1));
+  EXPECT_NEAR(5.0 * (2 * tuple_count - 1),
+              type::ValuePeeker::PeekDouble(val.CastAs(type::TypeId::DECIMAL)),
+              20.0);
+}
+
+TEST_F(AggregateTests, HashSpillGroupByTest) {
+  // SELECT d, SUM(a), COUNT(DISTINCT b) from table GROUP BY d;
+  // with a memory budget that only fits a few groups
+  const int tuple_count = 50;
+
+  // Create a table and wrap it in logical tiles
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), 2 * tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1)));
+
+  // (1-5) Setup plan node
+
+  // 1) Set up group-by columns
+  std::vector<oid_t> group_by_columns = {3};
+
+  // 2) Set up project info
+  DirectMapList direct_map_list = {{0, {0, 3}}, {1, {1, 0}}, {2, {1, 1}}};
+
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  // 3) Set up unique aggregates
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  planner::AggregatePlan::AggTerm sumA(
+      ExpressionType::AGGREGATE_SUM,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    0));
+  planner::AggregatePlan::AggTerm countDistinctB(
+      ExpressionType::AGGREGATE_COUNT,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    1),
+      true);  // Flag distinct
+  agg_terms.push_back(sumA);
+  agg_terms.push_back(countDistinctB);
+
+  // 4) Set up predicate (empty)
+  std::unique_ptr<const expression::AbstractExpression> predicate(nullptr);
+
+  // 5) Create output table schema
+  auto data_table_schema = data_table.get()->GetSchema();
+  std::vector<oid_t> set = {3, 0, 1};
+  std::vector<catalog::Column> columns;
+  for (auto column_index : set) {
+    columns.push_back(data_table_schema->GetColumn(column_index));
+  }
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema(columns));
+
+  // OK) Create the plan node
+  planner::AggregatePlan node(std::move(proj_info), std::move(predicate),
+                              std::move(agg_terms), std::move(group_by_columns),
+                              output_table_schema, AggregateType::HASH);
+
+  // Only a few groups fit into memory, the others are spilled
+  auto memory_budget = settings::SettingsManager::GetDouble(
+      settings::SettingId::aggregation_memory_budget);
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::aggregation_memory_budget, 2048);
+
+  // Create and set up executor
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::AggregateExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  // Every row is a group of its own, it is found exactly once
+  std::set<int> rows;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    ASSERT_TRUE(result_tile.get() != nullptr);
+    for (auto tuple_id : *result_tile) {
+      int row = (std::stoi(result_tile->GetValue(tuple_id, 0).ToString()) -
+                 TestingExecutorUtil::PopulatedValue(0, 3)) /
+                10;
+      EXPECT_TRUE(rows.insert(row).second);
+
+      type::Value val = (result_tile->GetValue(tuple_id, 1));
+      CmpBool cmp = (val.CompareEquals(type::ValueFactory::GetIntegerValue(
+          TestingExecutorUtil::PopulatedValue(row, 0))));
+      EXPECT_TRUE(cmp == CmpBool::TRUE);
+
+      val = (result_tile->GetValue(tuple_id, 2));
+      cmp = (val.CompareEquals(type::ValueFactory::GetIntegerValue(1)));
+      EXPECT_TRUE(cmp == CmpBool::TRUE);
+    }
+  }
+  EXPECT_EQ(2 * tuple_count, static_cast<int>(rows.size()));
+
+  txn_manager.CommitTransaction(txn);
+
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::aggregation_memory_budget, memory_budget);
+}
+
+
+TEST_F(AggregateTests, HashSpillDistinctTest) {
+  // SELECT a, COUNT(b), COUNT(DISTINCT b), SUM(DISTINCT b) from table
+  // GROUP BY a;
+  // with a memory budget that not even the first group fits into
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  // Create a table and wrap it in logical tiles. Every tile group is read
+  // twice, so every value of b is seen twice.
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), 2 * tuple_count, false,
+                                     false, true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> source_logical_tiles;
+  for (oid_t tile_group : {0, 1, 0, 1}) {
+    source_logical_tiles.emplace_back(
+        executor::LogicalTileFactory::WrapTileGroup(
+            data_table->GetTileGroup(tile_group)));
+  }
+
+  // (1-5) Setup plan node
+
+  // 1) Set up group-by columns
+  std::vector<oid_t> group_by_columns = {0};
+
+  // 2) Set up project info
+  DirectMapList direct_map_list = {
+      {0, {0, 0}}, {1, {1, 0}}, {2, {1, 1}}, {3, {1, 2}}};
+
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  // 3) Set up unique aggregates
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  planner::AggregatePlan::AggTerm countB(
+      ExpressionType::AGGREGATE_COUNT,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    1),
+      false);
+  planner::AggregatePlan::AggTerm countDistinctB(
+      ExpressionType::AGGREGATE_COUNT,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    1),
+      true);  // Flag distinct
+  planner::AggregatePlan::AggTerm sumDistinctB(
+      ExpressionType::AGGREGATE_SUM,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    1),
+      true);  // Flag distinct
+  agg_terms.push_back(countB);
+  agg_terms.push_back(countDistinctB);
+  agg_terms.push_back(sumDistinctB);
+
+  // 4) Set up predicate (empty)
+  std::unique_ptr<const expression::AbstractExpression> predicate(nullptr);
+
+  // 5) Create output table schema
+  auto data_table_schema = data_table.get()->GetSchema();
+  std::vector<oid_t> set = {0, 1, 1, 1};
+  std::vector<catalog::Column> columns;
+  for (auto column_index : set) {
+    columns.push_back(data_table_schema->GetColumn(column_index));
+  }
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema(columns));
+
+  // OK) Create the plan node
+  planner::AggregatePlan node(std::move(proj_info), std::move(predicate),
+                              std::move(agg_terms), std::move(group_by_columns),
+                              output_table_schema, AggregateType::HASH);
+
+  // Every value is over the memory budget
+  auto memory_budget = settings::SettingsManager::GetDouble(
+      settings::SettingId::aggregation_memory_budget);
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::aggregation_memory_budget, 1);
+
+  // Create and set up executor
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::AggregateExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tiles[0].release()))
+      .WillOnce(Return(source_logical_tiles[1].release()))
+      .WillOnce(Return(source_logical_tiles[2].release()))
+      .WillOnce(Return(source_logical_tiles[3].release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  // The first group stays in memory and spills its new distinct values, the
+  // input of the second group is spilled
+  std::map<int, int> sums;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    ASSERT_TRUE(result_tile.get() != nullptr);
+    for (auto tuple_id : *result_tile) {
+      int group = result_tile->GetValue(tuple_id, 0).GetAs<int32_t>() /
+                  TestingExecutorUtil::PopulatedValue(1, 0);
+      ASSERT_TRUE(group == 0 || group == 1);
+
+      type::Value val = (result_tile->GetValue(tuple_id, 1));
+      CmpBool cmp = (val.CompareEquals(
+          type::ValueFactory::GetIntegerValue(2 * tuple_count)));
+      EXPECT_TRUE(cmp == CmpBool::TRUE);
+
+      val = (result_tile->GetValue(tuple_id, 2));
+      cmp = (val.CompareEquals(
+          type::ValueFactory::GetIntegerValue(tuple_count)));
+      EXPECT_TRUE(cmp == CmpBool::TRUE);
+
+      EXPECT_TRUE(sums.emplace(group, result_tile->GetValue(tuple_id, 3)
+                                          .GetAs<int32_t>()).second);
+    }
+  }
+
+  // The rows of a group are consecutive
+  ASSERT_EQ(2, sums.size());
+  for (int group = 0; group < 2; group++) {
+    int expected = 0;
+    for (int row = 0; row < tuple_count; row++) {
+      expected +=
+          TestingExecutorUtil::PopulatedValue(group * tuple_count + row, 1);
+    }
+    EXPECT_EQ(expected, sums[group]);
+  }
+
+  txn_manager.CommitTransaction(txn);
+
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::aggregation_memory_budget, memory_budget);
+}
+
+TEST_F(AggregateTests, PlainSpillDistinctTest) {
+  // SELECT COUNT(b), COUNT(DISTINCT b), SUM(DISTINCT b) from table
+  // with a memory budget that not even the first distinct value fits into
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  // Create a table and wrap it in logical tiles. Every tile group is read
+  // twice, so every value of b is seen twice.
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), 2 * tuple_count, false,
+                                     false, true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> source_logical_tiles;
+  for (oid_t tile_group : {0, 1, 0, 1}) {
+    source_logical_tiles.emplace_back(
+        executor::LogicalTileFactory::WrapTileGroup(
+            data_table->GetTileGroup(tile_group)));
+  }
+
+  // (1-5) Setup plan node
+
+  // 1) Set up group-by columns
+  std::vector<oid_t> group_by_columns;
+
+  // 2) Set up project info
+  DirectMapList direct_map_list = {{0, {1, 0}}, {1, {1, 1}}, {2, {1, 2}}};
+
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  // 3) Set up unique aggregates
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  planner::AggregatePlan::AggTerm countB(
+      ExpressionType::AGGREGATE_COUNT,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    1),
+      false);
+  planner::AggregatePlan::AggTerm countDistinctB(
+      ExpressionType::AGGREGATE_COUNT,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    1),
+      true);  // Flag distinct
+  planner::AggregatePlan::AggTerm sumDistinctB(
+      ExpressionType::AGGREGATE_SUM,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    1),
+      true);  // Flag distinct
+  agg_terms.push_back(countB);
+  agg_terms.push_back(countDistinctB);
+  agg_terms.push_back(sumDistinctB);
+
+  // 4) Set up predicate (empty)
+  std::unique_ptr<const expression::AbstractExpression> predicate(nullptr);
+
+  // 5) Create output table schema
+  auto data_table_schema = data_table.get()->GetSchema();
+  std::vector<oid_t> set = {1, 1, 1};
+  std::vector<catalog::Column> columns;
+  for (auto column_index : set) {
+    columns.push_back(data_table_schema->GetColumn(column_index));
+  }
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema(columns));
+
+  // OK) Create the plan node
+  planner::AggregatePlan node(std::move(proj_info), std::move(predicate),
+                              std::move(agg_terms), std::move(group_by_columns),
+                              output_table_schema, AggregateType::PLAIN);
+
+  // Every value is over the memory budget
+  auto memory_budget = settings::SettingsManager::GetDouble(
+      settings::SettingId::aggregation_memory_budget);
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::aggregation_memory_budget, 1);
+
+  // Create and set up executor
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::AggregateExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tiles[0].release()))
+      .WillOnce(Return(source_logical_tiles[1].release()))
+      .WillOnce(Return(source_logical_tiles[2].release()))
+      .WillOnce(Return(source_logical_tiles[3].release()));
+
+  EXPECT_TRUE(executor.Init());
+
+  EXPECT_TRUE(executor.Execute());
+
+  txn_manager.CommitTransaction(txn);
+
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::aggregation_memory_budget, memory_budget);
+
+  // Verify result
+  int sum = 0;
+  for (int row = 0; row < 2 * tuple_count; row++) {
+    sum += TestingExecutorUtil::PopulatedValue(row, 1);
+  }
+  std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+  ASSERT_TRUE(result_tile.get() != nullptr);
+  type::Value val = (result_tile->GetValue(0, 0));
+  CmpBool cmp =
+      (val.CompareEquals(type::ValueFactory::GetIntegerValue(4 * tuple_count)));
+  EXPECT_TRUE(cmp == CmpBool::TRUE);
+  val = (result_tile->GetValue(0, 1));
+  cmp = (val.CompareEquals(
+      type::ValueFactory::GetIntegerValue(2 * tuple_count)));
+  EXPECT_TRUE(cmp == CmpBool::TRUE);
+  val = (result_tile->GetValue(0, 2));
+  cmp = (val.CompareEquals(type::ValueFactory::GetIntegerValue(sum)));
+  EXPECT_TRUE(cmp == CmpBool::TRUE);
+}
+
 }  // namespace test
 }  // namespace peloton
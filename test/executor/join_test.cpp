@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
 
 #include "executor/testing_executor_util.h"
@@ -83,6 +84,7 @@ std::vector<JoinType> join_types = {JoinType::INNER, JoinType::LEFT,
 void ExecuteJoinTest(PlanNodeType join_algorithm, JoinType join_type,
                      oid_t join_test_type);
 void ExecuteNestedLoopJoinTest(JoinType join_type, bool IndexScan = false);
+void ExecuteJoinKeepingOutputTest(PlanNodeType join_algorithm);
 
 void PopulateTable(storage::DataTable *table, int num_rows, bool random,
                    concurrency::TransactionContext *current_txn);
@@ -224,6 +226,107 @@ TEST_F(JoinTests, BasicNestedLoopTest) {
   ExecuteNestedLoopJoinTest(JoinType::INNER, false);
 }
 
+TEST_F(JoinTests, KeptOutputTilesTest) {
+  // The joins reuse their position lists builder for every output tile, so
+  // check the tiles after the join is done
+  ExecuteJoinKeepingOutputTest(PlanNodeType::HASHJOIN);
+  ExecuteJoinKeepingOutputTest(PlanNodeType::NESTLOOP);
+}
+
+void ExecuteJoinKeepingOutputTest(PlanNodeType join_algorithm) {
+  size_t tile_group_size = TESTS_TUPLES_PER_TILEGROUP;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  // Left table has 3 tile groups, right table has 2, with the same values
+  std::unique_ptr<storage::DataTable> left_table(
+      TestingExecutorUtil::CreateTable(tile_group_size));
+  TestingExecutorUtil::PopulateTable(left_table.get(), tile_group_size * 3,
+                                     false, false, false, txn);
+  std::unique_ptr<storage::DataTable> right_table(
+      TestingExecutorUtil::CreateTable(tile_group_size));
+  TestingExecutorUtil::PopulateTable(right_table.get(), tile_group_size * 2,
+                                     false, false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  std::vector<oid_t> column_ids({0, 1, 2, 3});
+  planner::SeqScanPlan left_scan_node(left_table.get(), nullptr, column_ids);
+  executor::SeqScanExecutor left_scan_executor(&left_scan_node,
+                                               context.get());
+  planner::SeqScanPlan right_scan_node(right_table.get(), nullptr,
+                                       column_ids);
+  executor::SeqScanExecutor right_scan_executor(&right_scan_node,
+                                                context.get());
+
+  // LEFT.1 == RIGHT.1
+  std::unique_ptr<const expression::AbstractExpression> predicate(
+      TestingJoinUtil::CreateJoinPredicate());
+  auto projection = TestingJoinUtil::CreateProjection();
+  auto schema = CreateJoinSchema();
+
+  std::unique_ptr<planner::AbstractPlan> join_node, hash_node;
+  std::unique_ptr<executor::AbstractExecutor> join_executor, hash_executor;
+  if (join_algorithm == PlanNodeType::HASHJOIN) {
+    std::vector<std::unique_ptr<const expression::AbstractExpression>>
+        hash_keys, left_hash_keys, right_hash_keys;
+    hash_keys.emplace_back(
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 1, 1));
+    left_hash_keys.emplace_back(
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1));
+    right_hash_keys.emplace_back(
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 1, 1));
+    hash_node.reset(new planner::HashPlan(hash_keys));
+    hash_executor.reset(
+        new executor::HashExecutor(hash_node.get(), context.get()));
+    hash_executor->AddChild(&right_scan_executor);
+
+    join_node.reset(new planner::HashJoinPlan(
+        JoinType::INNER, std::move(predicate), std::move(projection), schema,
+        left_hash_keys, right_hash_keys, false));
+    join_executor.reset(
+        new executor::HashJoinExecutor(join_node.get(), context.get()));
+    join_executor->AddChild(&left_scan_executor);
+    join_executor->AddChild(hash_executor.get());
+  } else {
+    join_node.reset(new planner::NestedLoopJoinPlan(
+        JoinType::INNER, std::move(predicate), std::move(projection), schema,
+        {1}, {1}));
+    join_executor.reset(
+        new executor::NestedLoopJoinExecutor(join_node.get(), context.get()));
+    join_executor->AddChild(&left_scan_executor);
+    join_executor->AddChild(&right_scan_executor);
+  }
+
+  std::vector<std::unique_ptr<executor::LogicalTile>> result_tiles;
+  EXPECT_TRUE(join_executor->Init());
+  while (join_executor->Execute() == true) {
+    result_tiles.emplace_back(join_executor->GetOutput());
+  }
+  EXPECT_LT(1, result_tiles.size());
+
+  // Every left tuple of the first two tile groups has its match
+  std::vector<int32_t> left_values;
+  for (auto &result_tile : result_tiles) {
+    ValidateJoinLogicalTile(result_tile.get());
+    EXPECT_EQ(0, CountTuplesWithNullFields(result_tile.get()));
+    for (auto tuple_id : *result_tile) {
+      left_values.push_back(
+          result_tile->GetValue(tuple_id, 3).GetAs<int32_t>());
+    }
+  }
+  std::sort(left_values.begin(), left_values.end());
+  ASSERT_EQ(tile_group_size * 2, left_values.size());
+  for (size_t i = 0; i < left_values.size(); i++) {
+    EXPECT_EQ(TestingExecutorUtil::PopulatedValue(i, 0), left_values[i]);
+  }
+
+  txn_manager.CommitTransaction(txn);
+}
+
 void PopulateTable(storage::DataTable *table, int num_rows, bool random,
                    concurrency::TransactionContext *current_txn) {
   // Random values
@@ -199,5 +199,131 @@ TEST_F(LogicalTileTests, TileMaterializationTest) {
   LOG_TRACE("%s", logical_tile->GetInfo().c_str());
 }
 
+TEST_F(LogicalTileTests, ColumnSubsetMaterializationTest) {
+  const int tuple_count = 4;
+  std::shared_ptr<storage::TileGroup> tile_group(
+      TestingExecutorUtil::CreateTileGroup(tuple_count));
+
+  // Create tuple schema from tile schemas.
+  std::vector<catalog::Schema> &tile_schemas = tile_group->GetTileSchemas();
+  std::unique_ptr<catalog::Schema> schema(
+      catalog::Schema::AppendSchemaList(tile_schemas));
+
+  // Create tuples and insert them into tile group.
+  const bool allocate = true;
+  storage::Tuple tuple1(schema.get(), allocate);
+  storage::Tuple tuple2(schema.get(), allocate);
+  auto pool = tile_group->GetTilePool(1);
+
+  tuple1.SetValue(0, type::ValueFactory::GetIntegerValue(1), pool);
+  tuple1.SetValue(1, type::ValueFactory::GetIntegerValue(1), pool);
+  tuple1.SetValue(2, type::ValueFactory::GetTinyIntValue(1), pool);
+  tuple1.SetValue(3, type::ValueFactory::GetVarcharValue("tuple 1"), pool);
+
+  tuple2.SetValue(0, type::ValueFactory::GetIntegerValue(2), pool);
+  tuple2.SetValue(1, type::ValueFactory::GetIntegerValue(2), pool);
+  tuple2.SetValue(2, type::ValueFactory::GetTinyIntValue(2), pool);
+  tuple2.SetValue(3, type::ValueFactory::GetVarcharValue("tuple 2"), pool);
+
+  tile_group->InsertTuple(&tuple1);
+  tile_group->InsertTuple(&tuple2);
+
+  // Logical tile over both base tiles, in reverse order, with a last row that
+  // an outer join padded on the side of the first base tile
+  std::unique_ptr<executor::LogicalTile> logical_tile(
+      executor::LogicalTileFactory::GetTile());
+  logical_tile->AddPositionList({1, 0, NULL_OID});
+  logical_tile->AddPositionList({1, 0, 1});
+
+  PL_ASSERT(tile_schemas.size() == 2);
+  oid_t column_count1 = tile_schemas[0].GetColumnCount();
+  for (oid_t column_itr = 0; column_itr < column_count1; column_itr++) {
+    logical_tile->AddColumn(tile_group->GetTileReference(0), column_itr, 0);
+  }
+  oid_t column_count2 = tile_schemas[1].GetColumnCount();
+  for (oid_t column_itr = 0; column_itr < column_count2; column_itr++) {
+    logical_tile->AddColumn(tile_group->GetTileReference(1), column_itr, 1);
+  }
+
+  // Materialize only columns 2, 0 and 3, in this order
+  catalog::Schema output_schema(
+      {schema->GetColumn(2), schema->GetColumn(0), schema->GetColumn(3)});
+  std::unique_ptr<storage::Tile> tile(
+      logical_tile->Materialize(output_schema, {{2, 0}, {0, 1}, {3, 2}}));
+
+  EXPECT_EQ(3, tile->GetColumnCount());
+  EXPECT_EQ(CmpBool::TRUE, tile->GetValue(0, 0).CompareEquals(
+                               type::ValueFactory::GetTinyIntValue(2)));
+  EXPECT_EQ(CmpBool::TRUE, tile->GetValue(0, 1).CompareEquals(
+                               type::ValueFactory::GetIntegerValue(2)));
+  EXPECT_EQ(CmpBool::TRUE, tile->GetValue(0, 2).CompareEquals(
+                               type::ValueFactory::GetVarcharValue("tuple 2")));
+  EXPECT_EQ(CmpBool::TRUE, tile->GetValue(1, 0).CompareEquals(
+                               type::ValueFactory::GetTinyIntValue(1)));
+  EXPECT_EQ(CmpBool::TRUE, tile->GetValue(1, 1).CompareEquals(
+                               type::ValueFactory::GetIntegerValue(1)));
+  EXPECT_EQ(CmpBool::TRUE, tile->GetValue(1, 2).CompareEquals(
+                               type::ValueFactory::GetVarcharValue("tuple 1")));
+  EXPECT_EQ(CmpBool::TRUE, tile->GetValue(2, 0).CompareEquals(
+                               type::ValueFactory::GetTinyIntValue(2)));
+  EXPECT_TRUE(tile->GetValue(2, 1).IsNull());
+  EXPECT_EQ(CmpBool::TRUE, tile->GetValue(2, 2).CompareEquals(
+                               type::ValueFactory::GetVarcharValue("tuple 2")));
+}
+
+TEST_F(LogicalTileTests, PositionListsBuilderResetTest) {
+  const int tuple_count = 4;
+  std::shared_ptr<storage::TileGroup> tile_group(
+      TestingExecutorUtil::CreateTileGroup(tuple_count));
+  TestingExecutorUtil::PopulateTiles(tile_group, tuple_count);
+  std::unique_ptr<executor::LogicalTile> left_tile(
+      executor::LogicalTileFactory::WrapTileGroup(tile_group));
+  std::unique_ptr<executor::LogicalTile> right_tile(
+      executor::LogicalTileFactory::WrapTileGroup(tile_group));
+  const auto &left_positions = left_tile->GetPositionList(0);
+  const auto &right_positions = right_tile->GetPositionList(0);
+  size_t left_list_count = left_tile->GetPositionLists().size();
+  size_t list_count =
+      left_list_count + right_tile->GetPositionLists().size();
+
+  executor::LogicalTile::PositionListsBuilder builder;
+  builder.Reset(left_tile.get(), right_tile.get());
+  builder.AddRow(0, 1);
+  builder.AddRow(2, 3);
+  EXPECT_EQ(2, builder.Size());
+  executor::LogicalTile::PositionLists first = builder.Release();
+  EXPECT_EQ(0, builder.Size());
+  ASSERT_EQ(list_count, first.size());
+  EXPECT_EQ(std::vector<oid_t>({left_positions[0], left_positions[2]}),
+            first[0]);
+  EXPECT_EQ(std::vector<oid_t>({right_positions[1], right_positions[3]}),
+            first[left_list_count]);
+
+  // Rows that were not released are dropped by the next reset
+  builder.Reset(left_tile.get(), right_tile.get());
+  EXPECT_EQ(0, builder.Size());
+  builder.AddRow(1, 1);
+  EXPECT_EQ(1, builder.Size());
+  builder.Reset(left_tile.get(), right_tile.get());
+  EXPECT_EQ(0, builder.Size());
+
+  // The lists are reserved for the largest output released so far
+  builder.AddRow(3, 0);
+  builder.AddRightNullRow(2);
+  executor::LogicalTile::PositionLists second = builder.Release();
+  ASSERT_EQ(list_count, second.size());
+  EXPECT_LE(2, second[0].capacity());
+  EXPECT_EQ(std::vector<oid_t>({left_positions[3], left_positions[2]}),
+            second[0]);
+  EXPECT_EQ(std::vector<oid_t>({right_positions[0], NULL_OID}),
+            second[left_list_count]);
+
+  // Reusing the builder leaves the released lists alone
+  EXPECT_EQ(std::vector<oid_t>({left_positions[0], left_positions[2]}),
+            first[0]);
+  EXPECT_EQ(std::vector<oid_t>({right_positions[1], right_positions[3]}),
+            first[left_list_count]);
+}
+
 }  // namespace test
 }  // namespace peloton
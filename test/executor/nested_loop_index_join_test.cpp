@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// nested_loop_index_join_test.cpp
+//
+// Identification: test/executor/nested_loop_index_join_test.cpp
+//
+// Copyright (c) 2015-2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/nested_loop_index_join_executor.h"
+#include "executor/seq_scan_executor.h"
+#include "executor/testing_executor_util.h"
+#include "planner/nested_loop_index_join_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/table_factory.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Nested Loop Index Join Tests
+//===--------------------------------------------------------------------===//
+
+class NestedLoopIndexJoinTests : public PelotonTest {};
+
+// Create a table with a single BIGINT column holding the given values
+storage::DataTable *CreateBigIntTable(const std::vector<int64_t> &values) {
+  catalog::Schema *schema = new catalog::Schema(
+      {catalog::Column(type::TypeId::BIGINT,
+                       type::Type::GetTypeSize(type::TypeId::BIGINT), "A",
+                       true)});
+  bool own_schema = true;
+  bool adapt_table = false;
+  auto *table = storage::TableFactory::GetDataTable(
+      INVALID_OID, INVALID_OID, schema, "outer_table",
+      TESTS_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  for (auto value : values) {
+    storage::Tuple tuple(schema, true);
+    tuple.SetValue(0, type::ValueFactory::GetBigIntValue(value), nullptr);
+    ItemPointer *index_entry_ptr = nullptr;
+    auto tuple_slot = table->InsertTuple(&tuple, txn, &index_entry_ptr);
+    txn_manager.PerformInsert(txn, tuple_slot, index_entry_ptr);
+  }
+  txn_manager.CommitTransaction(txn);
+  return table;
+}
+
+// Join the outer table's only column with the primary key (column 0) of the
+// inner table, and return the joined (outer A, inner A, inner B) rows
+std::vector<std::vector<type::Value>> ExecuteIndexJoin(
+    storage::DataTable *outer_table, storage::DataTable *inner_table) {
+  DirectMapList direct_map_list = {{0, std::make_pair(0, 0)},
+                                   {1, std::make_pair(1, 0)},
+                                   {2, std::make_pair(1, 1)}};
+  std::unique_ptr<const planner::ProjectInfo> projection(
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list)));
+  auto schema = std::shared_ptr<const catalog::Schema>(new catalog::Schema(
+      {outer_table->GetSchema()->GetColumn(0),
+       TestingExecutorUtil::GetColumnInfo(0),
+       TestingExecutorUtil::GetColumnInfo(1)}));
+
+  planner::NestedLoopIndexJoinPlan join_plan(
+      JoinType::INNER, nullptr, std::move(projection), schema, {0},
+      inner_table, inner_table->GetIndex(0), {0, 1}, nullptr, false);
+  join_plan.AddChild(std::unique_ptr<planner::AbstractPlan>(
+      new planner::SeqScanPlan(outer_table, nullptr, {0})));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  executor::ExecutorContext context(txn);
+  executor::NestedLoopIndexJoinExecutor join_executor(&join_plan, &context);
+  executor::SeqScanExecutor scan_executor(join_plan.GetChild(0), &context);
+  join_executor.AddChild(&scan_executor);
+  EXPECT_TRUE(join_executor.Init());
+
+  std::vector<std::vector<type::Value>> rows;
+  while (join_executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result(join_executor.GetOutput());
+    for (auto tuple_id : *result) {
+      std::vector<type::Value> row;
+      for (oid_t col_id = 0; col_id < 3; col_id++) {
+        row.push_back(result->GetValue(tuple_id, col_id));
+      }
+      rows.push_back(std::move(row));
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+  return rows;
+}
+
+TEST_F(NestedLoopIndexJoinTests, JoinTest) {
+  // The inner A values are 0, 10, ..., 90
+  const int inner_count = 10;
+  std::unique_ptr<storage::DataTable> inner_table(
+      TestingExecutorUtil::CreateTable(inner_count, true));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(inner_table.get(), inner_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // Every outer tuple is joined with its match, if any
+  std::unique_ptr<storage::DataTable> outer_table(
+      CreateBigIntTable({0, 30, 30, 90, 5, 100}));
+  auto rows = ExecuteIndexJoin(outer_table.get(), inner_table.get());
+  ASSERT_EQ(4, rows.size());
+  for (const auto &row : rows) {
+    EXPECT_EQ(CmpBool::TRUE, row[0].CompareEquals(row[1]));
+    auto inner_row = row[1].GetAs<int32_t>() / 10;
+    EXPECT_EQ(TestingExecutorUtil::PopulatedValue(inner_row, 1),
+              row[2].GetAs<int32_t>());
+  }
+}
+
+TEST_F(NestedLoopIndexJoinTests, OutOfRangeKeyTest) {
+  const int inner_count = 10;
+  std::unique_ptr<storage::DataTable> inner_table(
+      TestingExecutorUtil::CreateTable(inner_count, true));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(inner_table.get(), inner_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // Keys that don't fit into the INTEGER key of the index match nothing
+  const int64_t too_big = int64_t{1} << 40;
+  std::unique_ptr<storage::DataTable> outer_table(
+      CreateBigIntTable({too_big, 20, -too_big, 40}));
+  auto rows = ExecuteIndexJoin(outer_table.get(), inner_table.get());
+  ASSERT_EQ(2, rows.size());
+  for (const auto &row : rows) {
+    EXPECT_EQ(CmpBool::TRUE, row[0].CompareEquals(row[1]));
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -159,6 +159,68 @@ TEST_F(ExpressionTests, DistinctFromTest) {
   EXPECT_TRUE(expr.Evaluate(tuple.get(), tuple.get(), nullptr).IsFalse());
 }
 
+TEST_F(ExpressionTests, InListTest) {
+  // Create a table with id column and value column
+  std::vector<catalog::Column> columns;
+
+  catalog::Column column1(type::TypeId::INTEGER,
+                          type::Type::GetTypeSize(type::TypeId::INTEGER), "id",
+                          true);
+  catalog::Column column2(type::TypeId::INTEGER,
+                          type::Type::GetTypeSize(type::TypeId::INTEGER), "value",
+                          true);
+
+  columns.push_back(column1);
+  columns.push_back(column2);
+
+  std::unique_ptr<catalog::Schema> schema(new catalog::Schema(columns));
+
+  std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema.get(), true));
+
+  // Create "id IN (1, 2, value)"
+  std::vector<expression::AbstractExpression *> list = {
+      new expression::ConstantValueExpression(
+          type::ValueFactory::GetIntegerValue(1)),
+      new expression::ConstantValueExpression(
+          type::ValueFactory::GetIntegerValue(2)),
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 1, 1)};
+  expression::ComparisonExpression expr(
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0), list);
+  std::unique_ptr<expression::AbstractExpression> expr_copy(expr.Copy());
+  EXPECT_EQ(4, expr_copy->GetChildrenSize());
+
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // id is a constant of the list, should be true
+  tuple->SetValue(0, type::ValueFactory::GetIntegerValue(2), pool);
+  tuple->SetValue(1, type::ValueFactory::GetIntegerValue(10), pool);
+  EXPECT_TRUE(expr.Evaluate(tuple.get(), tuple.get(), nullptr).IsTrue());
+  EXPECT_TRUE(expr_copy->Evaluate(tuple.get(), tuple.get(), nullptr).IsTrue());
+
+  // id is the value, should be true
+  tuple->SetValue(0, type::ValueFactory::GetIntegerValue(10), pool);
+  EXPECT_TRUE(expr.Evaluate(tuple.get(), tuple.get(), nullptr).IsTrue());
+
+  // id is not in the list, should be false
+  tuple->SetValue(0, type::ValueFactory::GetIntegerValue(3), pool);
+  EXPECT_TRUE(expr.Evaluate(tuple.get(), tuple.get(), nullptr).IsFalse());
+
+  // id is not in the list, but value is NULL, should be NULL
+  tuple->SetValue(1,
+      type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER), pool);
+  EXPECT_TRUE(expr.Evaluate(tuple.get(), tuple.get(), nullptr).IsNull());
+
+  // id is in the list, value is NULL, should be true
+  tuple->SetValue(0, type::ValueFactory::GetIntegerValue(1), pool);
+  EXPECT_TRUE(expr.Evaluate(tuple.get(), tuple.get(), nullptr).IsTrue());
+
+  // id is NULL, should be NULL
+  tuple->SetValue(0,
+      type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER), pool);
+  tuple->SetValue(1, type::ValueFactory::GetIntegerValue(10), pool);
+  EXPECT_TRUE(expr.Evaluate(tuple.get(), tuple.get(), nullptr).IsNull());
+}
+
 TEST_F(ExpressionTests, ExtractDateTests) {
   // PAVLO: 2017-01-18
   // This will test whether we can invoke the EXTRACT function
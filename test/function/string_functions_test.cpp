@@ -72,6 +72,40 @@ TEST_F(StringFunctionsTests, LikeTest) {
       GetExecutorContext(), s4.c_str(), s4.size(), p4.c_str(), p4.size()));
 }
 
+TEST_F(StringFunctionsTests, LikePatternShapesTest) {
+  auto like = [this](const std::string &s, const std::string &p) {
+    return function::StringFunctions::Like(GetExecutorContext(), s.c_str(),
+                                           s.size(), p.c_str(), p.size());
+  };
+  // Long enough to be searched 16 bytes at a time
+  std::string text = "the quick brown fox jumps over the lazy dog, Twice";
+
+  // Prefix, suffix and substring patterns are matched without wildcards
+  EXPECT_TRUE(like(text, "the quick%"));
+  EXPECT_FALSE(like(text, "quick%"));
+  EXPECT_TRUE(like(text, "%dog, twice"));
+  EXPECT_FALSE(like(text, "%dog"));
+  EXPECT_TRUE(like(text, "%LAZY DOG%"));
+  EXPECT_TRUE(like(text, "%e%"));
+  EXPECT_TRUE(like(text, "%twice%"));
+  EXPECT_FALSE(like(text, "%lazy cat%"));
+  EXPECT_TRUE(like(text, "%%"));
+  EXPECT_FALSE(like("short", "%shorter%"));
+  EXPECT_TRUE(like("", "%"));
+  EXPECT_FALSE(like("", "_"));
+
+  // The lengths may include the terminating NUL, as in compiled queries
+  EXPECT_TRUE(function::StringFunctions::Like(
+      GetExecutorContext(), text.c_str(), text.size() + 1, "%fox%", 6));
+
+  // The general matcher has to backtrack
+  EXPECT_TRUE(like(text, "%o_er%la_y%"));
+  EXPECT_TRUE(like("aaaaaaaaab", "%a%a%a%ab"));
+  EXPECT_FALSE(like("aaaaaaaaaa", "%a%a%a%ab"));
+  EXPECT_TRUE(like("50% off", "%0\\% o%"));
+  EXPECT_FALSE(like("50 off", "%0\\% o%"));
+}
+
 TEST_F(StringFunctionsTests, AsciiTest) {
   const char column_char = 'A';
   for (int i = 0; i < 52; i++) {
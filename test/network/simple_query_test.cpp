@@ -13,12 +13,14 @@
 #include "common/harness.h"
 #include "gtest/gtest.h"
 #include "common/logger.h"
+#include "common/plan_cache.h"
 #include "network/peloton_server.h"
 #include "network/protocol_handler_factory.h"
 #include "util/string_util.h"
 #include <pqxx/pqxx> /* libpqxx is used to instantiate C++ client */
 #include "network/postgres_protocol_handler.h"
 #include "network/connection_handle_factory.h"
+#include "settings/settings_manager.h"
 
 #define NUM_THREADS 1
 
@@ -88,6 +90,75 @@ void *SimpleQueryTest(int port) {
   return NULL;
 }
 
+/**
+ * Plan cache test: connections share the plans of queries that only differ in
+ * their literals, but not across databases
+ */
+void *PlanCacheTest(int port) {
+  try {
+    pqxx::connection C1(StringUtil::Format(
+        "host=127.0.0.1 port=%d user=default_database sslmode=disable "
+        "application_name=psql", port));
+    pqxx::work txn1(C1);
+    txn1.exec("DROP TABLE IF EXISTS employee;");
+    txn1.exec("CREATE TABLE employee(id INT, name VARCHAR(100));");
+    txn1.exec("INSERT INTO employee VALUES (1, 'Han LI');");
+    txn1.exec("INSERT INTO employee VALUES (2, 'Shaokun ZOU');");
+    txn1.exec("CREATE DATABASE plan_cache_db;");
+    txn1.commit();
+
+    // The same table in another database, with other rows
+    pqxx::connection C2(StringUtil::Format(
+        "host=127.0.0.1 port=%d user=default_database dbname=plan_cache_db "
+        "sslmode=disable application_name=psql", port));
+    pqxx::work txn2(C2);
+    txn2.exec("CREATE TABLE employee(id INT, name VARCHAR(100));");
+    txn2.exec("INSERT INTO employee VALUES (1, 'Yilei CHU');");
+    txn2.commit();
+
+    auto &plan_cache = PlanCache::GetInstance();
+    plan_cache.Clear();
+
+    pqxx::nontransaction ntxn1(C1);
+    pqxx::result R = ntxn1.exec("SELECT name FROM employee WHERE id = 1;");
+    EXPECT_EQ(1, R.size());
+    EXPECT_EQ("Han LI", R[0][0].as<std::string>());
+    EXPECT_EQ(1, plan_cache.GetCount());
+
+    // Another connection to the same database runs the cached plan with its
+    // own literal
+    pqxx::connection C3(StringUtil::Format(
+        "host=127.0.0.1 port=%d user=default_database sslmode=disable "
+        "application_name=psql", port));
+    pqxx::nontransaction ntxn3(C3);
+    R = ntxn3.exec("select name from employee where id = 2;");
+    EXPECT_EQ(1, R.size());
+    EXPECT_EQ("Shaokun ZOU", R[0][0].as<std::string>());
+    EXPECT_EQ(1, plan_cache.GetCount());
+
+    // The same query text in the other database gets a plan of its own
+    pqxx::nontransaction ntxn2(C2);
+    R = ntxn2.exec("SELECT name FROM employee WHERE id = 1;");
+    EXPECT_EQ(1, R.size());
+    EXPECT_EQ("Yilei CHU", R[0][0].as<std::string>());
+    EXPECT_EQ(2, plan_cache.GetCount());
+
+    // Both plans stay cached and apart
+    R = ntxn1.exec("SELECT name FROM employee WHERE id = 1;");
+    EXPECT_EQ(1, R.size());
+    EXPECT_EQ("Han LI", R[0][0].as<std::string>());
+    R = ntxn2.exec("SELECT name FROM employee WHERE id = 2;");
+    EXPECT_EQ(0, R.size());
+    EXPECT_EQ(2, plan_cache.GetCount());
+  } catch (const std::exception &e) {
+    LOG_INFO("[PlanCacheTest] Exception occurred: %s", e.what());
+    EXPECT_TRUE(false);
+  }
+
+  LOG_INFO("[PlanCacheTest] Client has closed");
+  return NULL;
+}
+
 /**
  * rollback test
  * YINGJUN: rewrite wanted.
@@ -186,6 +257,29 @@ TEST_F(SimpleQueryTests, SimpleQueryTest) {
   LOG_INFO("Peloton has shut down");
 }
 
+TEST_F(SimpleQueryTests, PlanCacheTest) {
+  peloton::PelotonInit::Initialize();
+  settings::SettingsManager::SetBool(settings::SettingId::plan_cache, true);
+  peloton::network::PelotonServer server;
+
+  int port = 15721;
+  try {
+    server.SetPort(port);
+    server.SetupServer();
+  } catch (peloton::ConnectionException &exception) {
+    LOG_INFO("[LaunchServer] exception when launching server");
+  }
+  std::thread serverThread([&]() { server.ServerLoop(); });
+
+  PlanCacheTest(port);
+
+  server.Close();
+  serverThread.join();
+  PlanCache::GetInstance().Clear();
+  settings::SettingsManager::SetBool(settings::SettingId::plan_cache, false);
+  peloton::PelotonInit::Shutdown();
+}
+
 ///**
 // * Scalability test
 // * Open 2 servers in threads concurrently
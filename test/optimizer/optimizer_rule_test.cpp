@@ -22,6 +22,10 @@
 
 #include "catalog/catalog.h"
 #include "common/logger.h"
+#include "expression/comparison_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "optimizer/binding.h"
+#include "optimizer/optimizer_metadata.h"
 #include "common/statement.h"
 #include "executor/create_executor.h"
 #include "executor/delete_executor.h"
@@ -64,5 +68,112 @@ TEST_F(OptimizerRuleTests, SimpleRuleApplyTest) {
   EXPECT_EQ(outputs.size(), 1);
 }
 
+// Make the annotated predicate left_table.a = right_table.a
+static AnnotatedExpression MakeJoinPredicate(std::string left_table,
+                                             std::string right_table) {
+  std::unordered_set<std::string> table_alias_set{left_table, right_table};
+  auto expr = std::make_shared<expression::ComparisonExpression>(
+      ExpressionType::COMPARE_EQUAL,
+      new expression::TupleValueExpression("a", std::move(left_table)),
+      new expression::TupleValueExpression("a", std::move(right_table)));
+  return AnnotatedExpression(expr, table_alias_set);
+}
+
+// Insert (test1 join test2) join test3 with the given predicates into the
+// memo and bind the associativity rule to it
+static std::shared_ptr<OperatorExpression> BindAssociativity(
+    OptimizerMetadata &metadata, InnerJoinAssociativity &rule,
+    std::vector<AnnotatedExpression> left_predicates,
+    std::vector<AnnotatedExpression> top_predicates, GroupID &top_group_id) {
+  auto left_join = std::make_shared<OperatorExpression>(
+      LogicalInnerJoin::make(left_predicates));
+  left_join->PushChild(std::make_shared<OperatorExpression>(
+      LogicalGet::make(0, {}, nullptr, "test1")));
+  left_join->PushChild(std::make_shared<OperatorExpression>(
+      LogicalGet::make(1, {}, nullptr, "test2")));
+  auto top_join = std::make_shared<OperatorExpression>(
+      LogicalInnerJoin::make(top_predicates));
+  top_join->PushChild(left_join);
+  top_join->PushChild(std::make_shared<OperatorExpression>(
+      LogicalGet::make(2, {}, nullptr, "test3")));
+
+  std::shared_ptr<GroupExpression> gexpr;
+  metadata.RecordTransformedExpression(top_join, gexpr);
+  top_group_id = gexpr->GetGroupID();
+  metadata.memo.IndexJoinGroups(top_group_id);
+
+  GroupExprBindingIterator iterator(
+      metadata.memo,
+      metadata.memo.GetGroupByID(top_group_id)->GetLogicalExpressions()[0].get(),
+      rule.GetMatchPattern());
+  EXPECT_TRUE(iterator.HasNext());
+  return iterator.Next();
+}
+
+TEST_F(OptimizerRuleTests, InnerJoinAssociativityTest) {
+  OptimizerMetadata metadata;
+  OptimizeContext context(&metadata, nullptr);
+  InnerJoinAssociativity rule;
+  GroupID top_group_id;
+
+  // (test1 join test2 on test1.a = test2.a) join test3 on test2.a = test3.a
+  auto before =
+      BindAssociativity(metadata, rule, {MakeJoinPredicate("test1", "test2")},
+                        {MakeJoinPredicate("test2", "test3")}, top_group_id);
+  EXPECT_TRUE(rule.Check(before, &context));
+
+  std::vector<std::shared_ptr<OperatorExpression>> outputs;
+  rule.Transform(before, outputs, &context);
+  ASSERT_EQ(1, outputs.size());
+
+  // test1 join (test2 join test3 on test2.a = test3.a) on test1.a = test2.a
+  auto &after = outputs[0];
+  auto top_join = after->Op().As<LogicalInnerJoin>();
+  ASSERT_EQ(1, top_join->join_predicates.size());
+  EXPECT_EQ(2, top_join->join_predicates[0].table_alias_set.count("test1") +
+                   top_join->join_predicates[0].table_alias_set.count("test2"));
+  auto &child_join_expr = after->Children()[1];
+  ASSERT_EQ(OpType::InnerJoin, child_join_expr->Op().type());
+  auto child_join = child_join_expr->Op().As<LogicalInnerJoin>();
+  ASSERT_EQ(1, child_join->join_predicates.size());
+  EXPECT_EQ(1, child_join->join_predicates[0].table_alias_set.count("test3"));
+
+  // The new expression goes to the same group, and creates a group joining
+  // test2 and test3
+  std::shared_ptr<GroupExpression> gexpr;
+  EXPECT_TRUE(metadata.RecordTransformedExpression(after, gexpr, top_group_id));
+  auto child_group_id = gexpr->GetChildGroupId(1);
+  auto &child_aliases =
+      metadata.memo.GetGroupByID(child_group_id)->GetTableAliases();
+  EXPECT_EQ(2, child_aliases.size());
+  EXPECT_EQ(1, child_aliases.count("test2"));
+  EXPECT_EQ(1, child_aliases.count("test3"));
+
+  // The same join found in another order goes to the same group
+  auto commuted_predicates = child_join->join_predicates;
+  auto commuted_join = std::make_shared<OperatorExpression>(
+      LogicalInnerJoin::make(commuted_predicates));
+  commuted_join->PushChild(child_join_expr->Children()[1]);
+  commuted_join->PushChild(child_join_expr->Children()[0]);
+  std::shared_ptr<GroupExpression> commuted_gexpr;
+  EXPECT_TRUE(
+      metadata.RecordTransformedExpression(commuted_join, commuted_gexpr));
+  EXPECT_EQ(child_group_id, commuted_gexpr->GetGroupID());
+}
+
+TEST_F(OptimizerRuleTests, InnerJoinAssociativityCrossProductTest) {
+  OptimizerMetadata metadata;
+  OptimizeContext context(&metadata, nullptr);
+  InnerJoinAssociativity rule;
+  GroupID top_group_id;
+
+  // test2 and test3 are not joined on any predicate, so the rule would
+  // introduce a cross product
+  auto before =
+      BindAssociativity(metadata, rule, {MakeJoinPredicate("test1", "test2")},
+                        {MakeJoinPredicate("test1", "test3")}, top_group_id);
+  EXPECT_FALSE(rule.Check(before, &context));
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -1,3 +1,5 @@
+#include <thread>
+
 #include "common/harness.h"
 
 #define private public
@@ -20,6 +22,7 @@
 #include "planner/abstract_join_plan.h"
 #include "planner/hash_join_plan.h"
 #include "binder/bind_node_visitor.h"
+#include "settings/settings_manager.h"
 #include "traffic_cop/traffic_cop.h"
 #include "expression/tuple_value_expression.h"
 #include "optimizer/operators.h"
@@ -446,5 +449,77 @@ TEST_F(OptimizerTests, PredicatePushDownRewriteTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Test that exploring a join reordered by several threads gives a complete plan
+TEST_F(OptimizerTests, ParallelExploreTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  const int num_tables = 6;
+  std::ostringstream query;
+  query << "SELECT * FROM t0";
+  for (int i = 0; i < num_tables; i++) {
+    TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE t" + std::to_string(i) +
+                                    "(a INT PRIMARY KEY, b INT);");
+    if (i > 0) query << ", t" << i;
+  }
+  for (int i = 1; i < num_tables; i++) {
+    query << (i == 1 ? " WHERE " : " AND ") << "t" << i - 1 << ".a = t" << i
+          << ".b";
+  }
+
+  std::function<int(const planner::AbstractPlan *)> count_joins =
+      [&](const planner::AbstractPlan *plan) {
+        int num_joins =
+            dynamic_cast<const planner::AbstractJoinPlan *>(plan) != nullptr;
+        for (auto &child : plan->GetChildren()) {
+          num_joins += count_joins(child.get());
+        }
+        return num_joins;
+      };
+
+  auto num_threads =
+      settings::SettingsManager::GetInt(settings::SettingId::optimizer_threads);
+  auto &peloton_parser = parser::PostgresParser::GetInstance();
+  for (int threads : {1, 4}) {
+    settings::SettingsManager::SetInt(settings::SettingId::optimizer_threads,
+                                      threads);
+    auto stmt = peloton_parser.BuildParseTree(query.str());
+    optimizer::Optimizer optimizer;
+    txn = txn_manager.BeginTransaction();
+    auto plan = optimizer.BuildPelotonPlanTree(stmt, DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+
+    ASSERT_NE(nullptr, plan);
+    EXPECT_EQ(num_tables - 1, count_joins(plan.get()));
+  }
+
+  // Queries optimized at the same time share the helpers of the optimizer
+  // pool, more of them than the pool has workers
+  const int num_queries = 8;
+  std::vector<int> num_joins(num_queries, -1);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_queries; i++) {
+    threads.emplace_back([&, i] {
+      auto stmt = peloton_parser.BuildParseTree(query.str());
+      optimizer::Optimizer optimizer;
+      auto txn = txn_manager.BeginTransaction();
+      auto plan = optimizer.BuildPelotonPlanTree(stmt, DEFAULT_DB_NAME, txn);
+      txn_manager.CommitTransaction(txn);
+      if (plan != nullptr) {
+        num_joins[i] = count_joins(plan.get());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(std::vector<int>(num_queries, num_tables - 1), num_joins);
+
+  settings::SettingsManager::SetInt(settings::SettingId::optimizer_threads,
+                                    num_threads);
+}
+
 }  // namespace test
 }  // namespace peloton
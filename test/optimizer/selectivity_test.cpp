@@ -110,6 +110,69 @@ TEST_F(SelectivityTests, RangeSelectivityTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+std::shared_ptr<ColumnStats> MakeColumnStats(
+    const std::string &column_name, size_t num_rows, double cardinality,
+    double frac_null, std::vector<double> most_common_vals = {},
+    std::vector<double> most_common_freqs = {},
+    std::vector<double> histogram_bounds = {}) {
+  return std::make_shared<ColumnStats>(
+      0, 0, 0, column_name, false, num_rows, cardinality, frac_null,
+      most_common_vals, most_common_freqs, histogram_bounds);
+}
+
+// Test that range selectivity interpolates within histogram buckets
+TEST_F(SelectivityTests, HistogramInterpolationTest) {
+  // 4 bounds make 5 buckets holding 20% of the rows each
+  auto table_stats = std::make_shared<TableStats>(
+      std::vector<std::shared_ptr<ColumnStats>>{MakeColumnStats(
+          "test.a", 100, 50, 0, {}, {}, {10.0, 20.0, 30.0, 40.0})});
+  auto less_than = [&](double v) {
+    return Selectivity::LessThan(
+        table_stats,
+        ValueCondition{"test.a", ExpressionType::COMPARE_LESSTHAN,
+                       type::ValueFactory::GetDecimalValue(v)});
+  };
+  ExpectSelectivityEqual(less_than(25.0), 0.5, 0.001);
+  ExpectSelectivityEqual(less_than(20.0), 0.4, 0.001);
+  ExpectSelectivityEqual(less_than(12.5), 0.25, 0.001);
+  EXPECT_EQ(0, less_than(5.0));
+  EXPECT_EQ(1, less_than(45.0));
+}
+
+// Test equi-join selectivity from distinct counts and most common values
+TEST_F(SelectivityTests, JoinSelectivityTest) {
+  // Without most common values every value of the side with fewer distinct
+  // values finds a match
+  auto fact_stats = MakeColumnStats("fact.a", 1000, 100, 0);
+  auto dim_stats = MakeColumnStats("dim.a", 100, 100, 0);
+  ExpectSelectivityEqual(Selectivity::EqualJoin(fact_stats, dim_stats), 0.01,
+                         0.0001);
+  ExpectSelectivityEqual(Selectivity::EqualJoin(dim_stats, fact_stats), 0.01,
+                         0.0001);
+
+  // NULLs do not join
+  auto left_stats = MakeColumnStats("left.a", 100, 10, 0.5);
+  auto right_stats = MakeColumnStats("right.a", 100, 10, 0.5);
+  ExpectSelectivityEqual(Selectivity::EqualJoin(left_stats, right_stats),
+                         0.025, 0.0001);
+
+  // A value holding half of the rows on both sides dominates the join:
+  // 0.5 * 0.5 + (0.5 * 0.5) / 9 instead of 1 / 10 for uniform data
+  left_stats = MakeColumnStats("left.a", 100, 10, 0, {1}, {50});
+  right_stats = MakeColumnStats("right.a", 100, 10, 0, {1}, {50});
+  ExpectSelectivityEqual(Selectivity::EqualJoin(left_stats, right_stats),
+                         0.2778, 0.0001);
+
+  // Common values that do not match only join the uncommon ones
+  right_stats = MakeColumnStats("right.a", 100, 10, 0, {2}, {50});
+  double sel = Selectivity::EqualJoin(left_stats, right_stats);
+  EXPECT_LT(sel, 0.1);
+
+  // Empty inputs
+  left_stats = MakeColumnStats("left.a", 0, 0, 0);
+  EXPECT_EQ(0, Selectivity::EqualJoin(left_stats, right_stats));
+}
+
 // Test LIKE operator selectivity
 // Note LIKE operator is not yet implemented so this test only
 // checks if getting column stats and sampling works.
@@ -1123,6 +1123,85 @@ TEST_F(PostgresParserTests, FuncCallTest) {
                                type::ValueFactory::GetIntegerValue(2)));
 }
 
+TEST_F(PostgresParserTests, InListTest) {
+  std::string query =
+      "SELECT * FROM foo WHERE a IN (1, 2, 3) AND b NOT IN ('x', 'y')";
+
+  auto parser = parser::PostgresParser::GetInstance();
+  std::unique_ptr<parser::SQLStatementList> stmt_list(
+      parser.BuildParseTree(query).release());
+  EXPECT_TRUE(stmt_list->is_valid);
+  auto select_stmt = (parser::SelectStatement *)stmt_list->GetStatement(0);
+  LOG_INFO("%s", stmt_list->GetInfo().c_str());
+
+  auto where = select_stmt->where_clause.get();
+  EXPECT_EQ(ExpressionType::CONJUNCTION_AND, where->GetExpressionType());
+
+  // Check a IN (1, 2, 3)
+  auto in_expr = where->GetChild(0);
+  EXPECT_EQ(ExpressionType::COMPARE_IN, in_expr->GetExpressionType());
+  EXPECT_EQ(4, in_expr->GetChildrenSize());
+  auto tv_expr = (expression::TupleValueExpression *)in_expr->GetChild(0);
+  EXPECT_EQ("a", tv_expr->GetColumnName());
+  for (int i = 1; i <= 3; i++) {
+    auto const_expr =
+        (expression::ConstantValueExpression *)in_expr->GetChild(i);
+    EXPECT_EQ(ExpressionType::VALUE_CONSTANT, const_expr->GetExpressionType());
+    EXPECT_EQ(CmpBool::TRUE, const_expr->GetValue().CompareEquals(
+                                 type::ValueFactory::GetIntegerValue(i)));
+  }
+
+  // Check b NOT IN ('x', 'y')
+  auto not_expr = where->GetChild(1);
+  EXPECT_EQ(ExpressionType::OPERATOR_NOT, not_expr->GetExpressionType());
+  EXPECT_EQ(1, not_expr->GetChildrenSize());
+  in_expr = not_expr->GetChild(0);
+  EXPECT_EQ(ExpressionType::COMPARE_IN, in_expr->GetExpressionType());
+  EXPECT_EQ(3, in_expr->GetChildrenSize());
+  tv_expr = (expression::TupleValueExpression *)in_expr->GetChild(0);
+  EXPECT_EQ("b", tv_expr->GetColumnName());
+}
+
+TEST_F(PostgresParserTests, ApproxAggTest) {
+  std::string query =
+      "SELECT APPROX_COUNT_DISTINCT(a), APPROX_PERCENTILE(b, 0.95) FROM foo;";
+
+  auto parser = parser::PostgresParser::GetInstance();
+  std::unique_ptr<parser::SQLStatementList> stmt_list(
+      parser.BuildParseTree(query).release());
+  EXPECT_TRUE(stmt_list->is_valid);
+  auto select_stmt = (parser::SelectStatement *)stmt_list->GetStatement(0);
+  LOG_INFO("%s", stmt_list->GetInfo().c_str());
+
+  auto count_expr = select_stmt->select_list.at(0).get();
+  EXPECT_EQ(ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT,
+            count_expr->GetExpressionType());
+  EXPECT_EQ(1, count_expr->GetChildrenSize());
+
+  // The percentile is kept as a DECIMAL constant in the second child
+  auto percentile_expr = select_stmt->select_list.at(1).get();
+  EXPECT_EQ(ExpressionType::AGGREGATE_APPROX_PERCENTILE,
+            percentile_expr->GetExpressionType());
+  EXPECT_EQ(2, percentile_expr->GetChildrenSize());
+  auto tv_expr =
+      (expression::TupleValueExpression *)percentile_expr->GetChild(0);
+  EXPECT_EQ("b", tv_expr->GetColumnName());
+  auto const_expr =
+      (expression::ConstantValueExpression *)percentile_expr->GetChild(1);
+  EXPECT_EQ(CmpBool::TRUE, const_expr->GetValue().CompareEquals(
+                               type::ValueFactory::GetDecimalValue(0.95)));
+
+  // The percentile must be a constant between 0 and 1
+  EXPECT_THROW(parser.BuildParseTree("SELECT APPROX_PERCENTILE(b) FROM foo;"),
+               peloton::Exception);
+  EXPECT_THROW(
+      parser.BuildParseTree("SELECT APPROX_PERCENTILE(b, 2) FROM foo;"),
+      peloton::Exception);
+  EXPECT_THROW(
+      parser.BuildParseTree("SELECT APPROX_PERCENTILE(b, a) FROM foo;"),
+      peloton::Exception);
+}
+
 TEST_F(PostgresParserTests, UDFFuncCallTest) {
   std::string query = "SELECT increment(1,b) FROM TEST;";
 
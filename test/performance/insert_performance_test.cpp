@@ -35,6 +35,8 @@
 #include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/table_factory.h"
+#include "type/ephemeral_pool.h"
+#include "type/varlen_pool.h"
 
 #include "executor/mock_executor.h"
 
@@ -147,5 +149,63 @@ TEST_F(InsertPerformanceTests, LoadingTest) {
                bytes_to_megabytes_converter);
 }
 
+// Allocate and free VARCHAR sized blocks from the given pool, keeping every
+// fourth of them alive like the versions of a string-heavy table
+void AllocateVarlens(type::AbstractPool *pool, oid_t block_count,
+                     UNUSED_ATTRIBUTE uint64_t thread_itr) {
+  std::vector<void *> live;
+  for (oid_t block_itr = 0; block_itr < block_count; block_itr++) {
+    void *block = pool->Allocate(8 + (block_itr * 37) % 256);
+    if (block_itr % 4 == 0) {
+      live.push_back(block);
+    } else {
+      pool->Free(block);
+    }
+  }
+  for (auto block : live) {
+    pool->Free(block);
+  }
+}
+
+TEST_F(InsertPerformanceTests, VarlenInsertTest) {
+  oid_t thread_count = 4;
+  oid_t block_count = 1000000;
+
+  // The varlen pool against the malloc based ephemeral pool
+  type::EphemeralPool ephemeral_pool;
+  type::VarlenPool varlen_pool;
+  Timer<> timer;
+
+  timer.Start();
+  LaunchParallelTest(thread_count, AllocateVarlens, &ephemeral_pool,
+                     block_count);
+  timer.Stop();
+  LOG_INFO("Ephemeral pool duration: %.2lf", timer.GetDuration());
+
+  timer.Reset();
+  timer.Start();
+  LaunchParallelTest(thread_count, AllocateVarlens, &varlen_pool,
+                     block_count);
+  timer.Stop();
+  LOG_INFO("Varlen pool duration: %.2lf", timer.GetDuration());
+
+  // Inserts copy the VARCHAR column into the varlen pools of the tiles
+  oid_t tilegroup_count_per_loader = 100;
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TEST_TUPLES_PER_TILEGROUP, false));
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  timer.Reset();
+  timer.Start();
+  LaunchParallelTest(thread_count, InsertTuple, data_table.get(),
+                     testing_pool, tilegroup_count_per_loader);
+  timer.Stop();
+  LOG_INFO("Insert duration: %.2lf", timer.GetDuration());
+
+  EXPECT_EQ(thread_count * tilegroup_count_per_loader *
+                TEST_TUPLES_PER_TILEGROUP,
+            data_table->GetTupleCount());
+}
+
 }  // namespace test
 }  // namespace peloton
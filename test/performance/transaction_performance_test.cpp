@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// transaction_performance_test.cpp
+//
+// Identification: test/performance/transaction_performance_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+
+#include "common/harness.h"
+
+#include "common/timer.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Transaction Performance Tests
+//===--------------------------------------------------------------------===//
+
+class TransactionPerformanceTests : public PelotonTest {};
+
+std::atomic<uint64_t> committed_txn_count;
+
+void BeginCommitTransactions(uint64_t txn_count, uint64_t thread_itr) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  size_t thread_id = thread_itr + 1;
+
+  for (uint64_t txn_itr = 0; txn_itr < txn_count; txn_itr++) {
+    auto txn = txn_manager.BeginTransaction(thread_id);
+    txn_manager.CommitTransaction(txn);
+  }
+
+  committed_txn_count += txn_count;
+}
+
+TEST_F(TransactionPerformanceTests, BeginCommitTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  const uint64_t txn_count_per_thread = 100000;
+  const uint64_t max_thread_count = 8;
+
+  for (uint64_t thread_count = 1; thread_count <= max_thread_count;
+       thread_count *= 2) {
+    epoch_manager.Reset(2);
+    for (uint64_t thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+      epoch_manager.RegisterThread(thread_itr + 1);
+    }
+    committed_txn_count = 0;
+
+    Timer<> timer;
+    timer.Start();
+
+    LaunchParallelTest(thread_count, BeginCommitTransactions,
+                       txn_count_per_thread);
+
+    timer.Stop();
+
+    EXPECT_EQ(thread_count * txn_count_per_thread, committed_txn_count);
+    LOG_INFO("%lu threads: %.0lf txns/s", thread_count,
+             committed_txn_count / timer.GetDuration());
+
+    // no transaction is running, so every epoch before the current one
+    // has expired.
+    EXPECT_EQ(epoch_manager.GetCurrentEpochId() - 1,
+              epoch_manager.GetExpiredEpochId());
+
+    for (uint64_t thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+      epoch_manager.DeregisterThread(thread_itr + 1);
+    }
+  }
+
+  epoch_manager.Reset();
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -122,6 +122,29 @@ class OptimizerSQLTests : public PelotonTest {
     }
   }
 
+  // Check that the optimizer plans the query with a node of the given type
+  void ExpectPlanNode(string query, PlanNodeType plan_type) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    auto plan =
+        TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query, txn);
+    txn_manager.CommitTransaction(txn);
+
+    vector<const planner::AbstractPlan *> plans{plan.get()};
+    while (!plans.empty()) {
+      auto *plan_ptr = plans.back();
+      plans.pop_back();
+      if (plan_ptr->GetPlanNodeType() == plan_type) {
+        return;
+      }
+      for (const auto &child : plan_ptr->GetChildren()) {
+        plans.push_back(child.get());
+      }
+    }
+    ADD_FAILURE() << "No " << PlanNodeTypeToString(plan_type)
+                  << " node in the plan of \"" << query << "\"";
+  }
+
  protected:
   unique_ptr<optimizer::AbstractOptimizer> optimizer;
   vector<ResultValue> result;
@@ -636,6 +659,85 @@ TEST_F(OptimizerSQLTests, JoinTest) {
       {"22", "1", "11", "2", "22", "3", "0", "4"}, true);
 }
 
+TEST_F(OptimizerSQLTests, IndexJoinTest) {
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test1(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery("CREATE INDEX test1_b ON test1(b);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (1, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (2, 11, 000);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (3, 22, 444);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (4, 00, 333);");
+
+  std::function<bool(const planner::AbstractPlan *)> has_index_join =
+      [&](const planner::AbstractPlan *plan) {
+        if (plan->GetPlanNodeType() == PlanNodeType::NESTLOOPINDEX) {
+          return true;
+        }
+        for (auto &child : plan->GetChildren()) {
+          if (has_index_join(child.get())) return true;
+        }
+        return false;
+      };
+
+  // The join key covers the primary key of either table, so one of them is
+  // probed instead of scanned
+  string query = "SELECT test.a, test1.a FROM test, test1 WHERE test.a = test1.a";
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query, txn);
+  txn_manager.CommitTransaction(txn);
+  EXPECT_TRUE(has_index_join(plan.get()));
+  TestUtil(query, {"1", "1", "2", "2", "3", "3", "4", "4"}, false);
+
+  // Predicate on the probed table
+  TestUtil(
+      "SELECT test.a, test1.c FROM test, test1 "
+      "WHERE test.a = test1.a AND test1.c = 333",
+      {"1", "333", "4", "333"}, false);
+
+  // Non-unique secondary index
+  TestUtil(
+      "SELECT test.a, test1.a FROM test, test1 WHERE test.b = test1.b",
+      {"1", "1", "1", "3", "2", "2", "4", "4"}, false);
+
+  // Deleted tuples are not visible through the index
+  TestingSQLUtil::ExecuteSQLQuery("DELETE FROM test1 WHERE a = 3;");
+  TestUtil("SELECT test.a, test1.a FROM test, test1 WHERE test.b = test1.b",
+           {"1", "1", "2", "2", "4", "4"}, false);
+}
+
+TEST_F(OptimizerSQLTests, MergeJoinTest) {
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test1(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (1, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (2, 11, 000);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (3, 22, 444);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (4, 00, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (5, NULL, 555);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (5, NULL, 666);");
+
+  // With the stats of both tables, merging the sorted inputs is cheaper than
+  // hashing either of them
+  TestingSQLUtil::ExecuteSQLQuery("ANALYZE;");
+  ExpectPlanNode(
+      "SELECT test.b, test.a, test1.a FROM test, test1 WHERE test.b = test1.b",
+      PlanNodeType::MERGEJOIN);
+
+  // Runs of equal keys on both sides produce all their pairs, and NULL keys
+  // never match
+  TestUtil(
+      "SELECT test.b, test.a, test1.a FROM test, test1 "
+      "WHERE test.b = test1.b ORDER BY test.b, test.a, test1.a",
+      {"0", "4", "4", "11", "2", "2", "22", "1", "1", "22", "1", "3"}, true);
+
+  // A join on two keys, with a predicate that is not part of the keys
+  TestUtil(
+      "SELECT test.a, test1.a FROM test, test1 "
+      "WHERE test.a = test1.a AND test.b = test1.b AND test1.c > 0 "
+      "ORDER BY test.a",
+      {"1", "1", "4", "4"}, true);
+}
+
 TEST_F(OptimizerSQLTests, IndexTest) {
   TestingSQLUtil::ExecuteSQLQuery(
       "create table foo(a int, b varchar(32), primary key(a, b));");
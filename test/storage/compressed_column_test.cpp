@@ -0,0 +1,210 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_column_test.cpp
+//
+// Identification: test/storage/compressed_column_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <numeric>
+
+#include "common/harness.h"
+
+#include "catalog/manager.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "storage/compressed_column.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_factory.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Compressed Column Tests
+//===--------------------------------------------------------------------===//
+
+class CompressedColumnTests : public PelotonTest {};
+
+// Create a tile group with a single integer column holding the given values
+std::shared_ptr<storage::TileGroup> CreateIntegerTileGroup(
+    const std::vector<int32_t> &values) {
+  catalog::Column column(type::TypeId::INTEGER,
+                         type::Type::GetTypeSize(type::TypeId::INTEGER), "A",
+                         true);
+  catalog::Schema schema({column});
+  std::vector<catalog::Schema> schemas = {schema};
+  std::map<oid_t, std::pair<oid_t, oid_t>> column_map;
+  column_map[0] = std::make_pair(0, 0);
+
+  std::shared_ptr<storage::TileGroup> tile_group(
+      storage::TileGroupFactory::GetTileGroup(
+          INVALID_OID, INVALID_OID,
+          TestingHarness::GetInstance().GetNextTileGroupId(), nullptr, schemas,
+          column_map, values.size()));
+  catalog::Manager::GetInstance().AddTileGroup(tile_group->GetTileGroupId(),
+                                               tile_group);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  for (auto value : values) {
+    storage::Tuple tuple(&schema, true);
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(value), nullptr);
+    auto tuple_slot = tile_group->InsertTuple(&tuple);
+    txn_manager.PerformInsert(
+        txn, ItemPointer(tile_group->GetTileGroupId(), tuple_slot));
+  }
+  txn_manager.CommitTransaction(txn);
+
+  return tile_group;
+}
+
+std::vector<oid_t> AllPositions(oid_t tuple_count) {
+  std::vector<oid_t> positions(tuple_count);
+  std::iota(positions.begin(), positions.end(), 0);
+  return positions;
+}
+
+TEST_F(CompressedColumnTests, EncodingTest) {
+  const oid_t tuple_count = 1000;
+
+  // Long runs of repeated values
+  std::vector<int32_t> runs;
+  for (oid_t i = 0; i < tuple_count; i++) {
+    runs.push_back(i / 250);
+  }
+  // Distinct values in a narrow range
+  std::vector<int32_t> range;
+  for (oid_t i = 0; i < tuple_count; i++) {
+    range.push_back(1000000 + ((i * 37) % 100));
+  }
+
+  auto run_tile_group = CreateIntegerTileGroup(runs);
+  auto run_column = storage::CompressedColumn::Compress(
+      *run_tile_group->GetTile(0), 0, tuple_count);
+  ASSERT_NE(nullptr, run_column);
+  EXPECT_EQ(ColumnEncodingType::RUN_LENGTH, run_column->GetEncodingType());
+
+  auto range_tile_group = CreateIntegerTileGroup(range);
+  auto range_column = storage::CompressedColumn::Compress(
+      *range_tile_group->GetTile(0), 0, tuple_count);
+  ASSERT_NE(nullptr, range_column);
+  EXPECT_EQ(ColumnEncodingType::FRAME_OF_REFERENCE,
+            range_column->GetEncodingType());
+
+  for (oid_t i = 0; i < tuple_count; i++) {
+    EXPECT_EQ(runs[i], run_column->GetValue(i).GetAs<int32_t>());
+    EXPECT_EQ(range[i], range_column->GetValue(i).GetAs<int32_t>());
+  }
+  EXPECT_LT(run_column->GetCompressedSize(),
+            run_column->GetUncompressedSize());
+  EXPECT_LT(range_column->GetCompressedSize(),
+            range_column->GetUncompressedSize());
+
+  // Filters on the compressed data must match a plain scan
+  auto positions = AllPositions(tuple_count);
+  run_column->Filter(ExpressionType::COMPARE_EQUAL,
+                     type::ValueFactory::GetIntegerValue(2), positions);
+  EXPECT_EQ(250, positions.size());
+  EXPECT_EQ(500, positions.front());
+
+  positions = AllPositions(tuple_count);
+  range_column->Filter(ExpressionType::COMPARE_LESSTHAN,
+                       type::ValueFactory::GetIntegerValue(1000010),
+                       positions);
+  EXPECT_EQ(100, positions.size());
+  for (auto position : positions) {
+    EXPECT_LT(range[position], 1000010);
+  }
+
+  // Comparing against a wider type goes through the value system
+  positions = AllPositions(tuple_count);
+  range_column->Filter(ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+                       type::ValueFactory::GetBigIntValue(1000090), positions);
+  EXPECT_EQ(100, positions.size());
+}
+
+TEST_F(CompressedColumnTests, FreezeThawTest) {
+  const int tuple_count = 50;
+
+  auto tile_group = TestingExecutorUtil::CreateTileGroup(tuple_count);
+  TestingExecutorUtil::PopulateTiles(tile_group, tuple_count);
+
+  std::vector<std::vector<type::Value>> expected(tuple_count);
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    for (oid_t column_id = 0; column_id < 4; column_id++) {
+      expected[tuple_id].push_back(tile_group->GetValue(tuple_id, column_id));
+    }
+  }
+
+  // Recent writes keep the tile group hot
+  tile_group->GetHeader()->SetLastWriteEpochId(10);
+  EXPECT_FALSE(tile_group->Freeze(5));
+  EXPECT_FALSE(tile_group->IsFrozen());
+  EXPECT_FALSE(tile_group->GetHeader()->GetImmutability());
+
+  // The epoch of the writes must have expired as well
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  if (epoch_manager.GetCurrentEpochId() <= 10) {
+    epoch_manager.SetCurrentEpochId(11);
+  }
+  EXPECT_TRUE(tile_group->Freeze(10));
+  EXPECT_TRUE(tile_group->IsFrozen());
+  EXPECT_TRUE(tile_group->GetHeader()->GetImmutability());
+  EXPECT_TRUE(tile_group->GetTile(1)->IsFrozen());
+  EXPECT_EQ(ColumnEncodingType::DICTIONARY, tile_group->GetTile(1)
+                                                ->GetCompressedColumn(1)
+                                                ->GetEncodingType());
+
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    for (oid_t column_id = 0; column_id < 4; column_id++) {
+      auto value = tile_group->GetValue(tuple_id, column_id);
+      EXPECT_EQ(CmpBool::TRUE,
+                value.CompareEquals(expected[tuple_id][column_id]));
+    }
+  }
+
+  // The materialized copy serves raw slots
+  auto materialized = tile_group->GetTile(1)->GetMaterializedTile();
+  EXPECT_FALSE(materialized->IsFrozen());
+  EXPECT_EQ(CmpBool::TRUE,
+            materialized->GetValue(7, 1).CompareEquals(expected[7][3]));
+
+  // Filters on the varlen dictionary
+  auto positions = AllPositions(tuple_count);
+  EXPECT_TRUE(tile_group->FilterFrozen(
+      3, ExpressionType::COMPARE_EQUAL, expected[12][3], positions));
+  ASSERT_EQ(1, positions.size());
+  EXPECT_EQ(12, positions[0]);
+
+  EXPECT_TRUE(tile_group->Thaw());
+  EXPECT_FALSE(tile_group->IsFrozen());
+  EXPECT_FALSE(tile_group->GetHeader()->GetImmutability());
+  positions = AllPositions(tuple_count);
+  EXPECT_FALSE(tile_group->FilterFrozen(
+      3, ExpressionType::COMPARE_EQUAL, expected[12][3], positions));
+
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    for (oid_t column_id = 0; column_id < 4; column_id++) {
+      auto value = tile_group->GetValue(tuple_id, column_id);
+      EXPECT_EQ(CmpBool::TRUE,
+                value.CompareEquals(expected[tuple_id][column_id]));
+    }
+  }
+
+  // All replaced tiles go away once their epoch has expired
+  EXPECT_LT(0, tile_group->ReclaimRetiredTiles(MAX_EID));
+  EXPECT_EQ(0, tile_group->ReclaimRetiredTiles(MAX_EID));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -19,6 +19,10 @@
 #include "storage/database.h"
 
 #include "concurrency/transaction_manager_factory.h"
+#include "index/index.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
 
 namespace peloton {
 namespace test {
@@ -87,5 +91,95 @@ TEST_F(DataTableTests, GlobalTableTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(DataTableTests, InsertTuplesTest) {
+  const int tuples_per_tile_group = TESTS_TUPLES_PER_TILEGROUP;
+  const int tuple_count = tuples_per_tile_group * 5 / 2;
+
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tile_group, true));
+  auto schema = data_table->GetSchema();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  auto build_tuples = [&](int from, int to) {
+    std::vector<std::unique_ptr<storage::Tuple>> tuples;
+    for (int i = from; i < to; i++) {
+      tuples.emplace_back(new storage::Tuple(schema, true));
+      tuples.back()->SetValue(0, type::ValueFactory::GetIntegerValue(i),
+                              testing_pool);
+      tuples.back()->SetValue(1, type::ValueFactory::GetIntegerValue(i * 10),
+                              testing_pool);
+      tuples.back()->SetValue(2, type::ValueFactory::GetDecimalValue(i),
+                              testing_pool);
+      tuples.back()->SetValue(
+          3, type::ValueFactory::GetVarcharValue(std::to_string(i)),
+          testing_pool);
+    }
+    return tuples;
+  };
+  auto get_batch = [](
+      const std::vector<std::unique_ptr<storage::Tuple>> &tuples) {
+    std::vector<const storage::Tuple *> batch;
+    for (auto &tuple : tuples) {
+      batch.push_back(tuple.get());
+    }
+    return batch;
+  };
+
+  // Insert in reverse key order, the indexes get them sorted
+  auto tuples = build_tuples(0, tuple_count);
+  std::reverse(tuples.begin(), tuples.end());
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::vector<ItemPointer> locations;
+  EXPECT_TRUE(data_table->InsertTuples(get_batch(tuples), txn, locations));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // The batch fills the tile groups in order
+  ASSERT_EQ(tuple_count, locations.size());
+  EXPECT_EQ(tuple_count, data_table->GetTupleCount());
+  EXPECT_EQ(3, data_table->GetTileGroupCount());
+  for (int i = 0; i < tuple_count; i++) {
+    EXPECT_EQ(locations[i - i % tuples_per_tile_group].block,
+              locations[i].block);
+    EXPECT_EQ(i % tuples_per_tile_group, locations[i].offset);
+
+    auto tile_group = data_table->GetTileGroupById(locations[i].block);
+    int key = tuple_count - 1 - i;
+    EXPECT_EQ(key, tile_group->GetValue(locations[i].offset, 0)
+                       .GetAs<int32_t>());
+    EXPECT_EQ(std::to_string(key),
+              tile_group->GetValue(locations[i].offset, 3).ToString());
+    EXPECT_NE(MAX_CID, tile_group->GetHeader()->GetBeginCommitId(
+                           locations[i].offset));
+  }
+
+  for (oid_t index_itr = 0; index_itr < data_table->GetIndexCount();
+       index_itr++) {
+    std::vector<ItemPointer *> index_entries;
+    data_table->GetIndex(index_itr)->ScanAllKeys(index_entries);
+    EXPECT_EQ(tuple_count, index_entries.size());
+  }
+
+  // Duplicates within a batch violate the primary key
+  tuples = build_tuples(tuple_count, tuple_count + 10);
+  auto duplicates = build_tuples(tuple_count + 5, tuple_count + 6);
+  auto batch = get_batch(tuples);
+  batch.push_back(duplicates[0].get());
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_FALSE(data_table->InsertTuples(batch, txn, locations));
+  txn_manager.SetTransactionResult(txn, ResultType::FAILURE);
+  EXPECT_EQ(ResultType::ABORTED, txn_manager.AbortTransaction(txn));
+  EXPECT_EQ(tuple_count, data_table->GetTupleCount());
+
+  // So do keys that are already in the table
+  tuples = build_tuples(tuple_count - 1, tuple_count + 1);
+  txn = txn_manager.BeginTransaction();
+  EXPECT_FALSE(data_table->InsertTuples(get_batch(tuples), txn, locations));
+  txn_manager.SetTransactionResult(txn, ResultType::FAILURE);
+  txn_manager.AbortTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
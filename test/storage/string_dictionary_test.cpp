@@ -0,0 +1,209 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// string_dictionary_test.cpp
+//
+// Identification: test/storage/string_dictionary_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+
+#include "common/harness.h"
+
+#include "common/exception.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "storage/string_dictionary.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// String Dictionary Tests
+//===--------------------------------------------------------------------===//
+
+class StringDictionaryTests : public PelotonTest {};
+
+TEST_F(StringDictionaryTests, InternTest) {
+  storage::StringDictionary dictionary;
+  std::string hello("hello"), world("world"), empty("");
+
+  auto *hello_varlen = dictionary.Intern(hello.c_str(), hello.size() + 1);
+  auto *world_varlen = dictionary.Intern(world.c_str(), world.size() + 1);
+  auto *empty_varlen = dictionary.Intern(empty.c_str(), 0);
+  EXPECT_EQ(3, dictionary.GetSize());
+
+  // Codes are handed out in insertion order and never change
+  EXPECT_EQ(0, storage::StringDictionary::GetCode(hello_varlen));
+  EXPECT_EQ(1, storage::StringDictionary::GetCode(world_varlen));
+  EXPECT_EQ(2, storage::StringDictionary::GetCode(empty_varlen));
+  EXPECT_EQ(world_varlen, dictionary.GetVarlen(1));
+
+  // Interning an equal value from another buffer yields the same entry
+  std::string hello_copy(hello);
+  EXPECT_EQ(hello_varlen,
+            dictionary.Intern(hello_copy.c_str(), hello_copy.size() + 1));
+  EXPECT_EQ(hello_varlen,
+            dictionary.Find(hello_copy.c_str(), hello_copy.size() + 1));
+  EXPECT_EQ(nullptr, dictionary.Find("hell", 5));
+  EXPECT_EQ(3, dictionary.GetSize());
+
+  // Entries use the regular varlen layout
+  EXPECT_EQ(hello.size() + 1, *reinterpret_cast<const uint32_t *>(hello_varlen));
+  EXPECT_EQ(0, std::strcmp(hello_varlen + sizeof(uint32_t), hello.c_str()));
+  EXPECT_EQ(0, *reinterpret_cast<const uint32_t *>(
+                   hello_varlen + sizeof(uint32_t) +
+                   storage::StringDictionary::kCodeOffset));
+
+  // Values larger than a block
+  std::string large(100000, 'x');
+  auto *large_varlen = dictionary.Intern(large.c_str(), large.size() + 1);
+  EXPECT_EQ(3, storage::StringDictionary::GetCode(large_varlen));
+  EXPECT_EQ(0, std::strcmp(large_varlen + sizeof(uint32_t), large.c_str()));
+  EXPECT_LT(large.size(), dictionary.GetMemorySize());
+}
+
+TEST_F(StringDictionaryTests, BoundedTest) {
+  storage::StringDictionary dictionary(2);
+  EXPECT_NE(nullptr, dictionary.Intern("a", 2));
+  EXPECT_NE(nullptr, dictionary.Intern("b", 2));
+
+  // A full dictionary only hands out the entries it has
+  EXPECT_EQ(nullptr, dictionary.Intern("c", 2));
+  EXPECT_NE(nullptr, dictionary.Intern("a", 2));
+  EXPECT_EQ(2, dictionary.GetSize());
+
+  // Other values are copied, with a code that matches no entry
+  auto *pool = TestingHarness::GetInstance().GetTestingPool();
+  auto *varlen = storage::StringDictionary::CopyUnencoded(pool, "c", 2);
+  EXPECT_TRUE(storage::StringDictionary::IsUnencoded(varlen));
+  EXPECT_FALSE(
+      storage::StringDictionary::IsUnencoded(dictionary.Intern("a", 2)));
+  EXPECT_EQ(2, *reinterpret_cast<const uint32_t *>(varlen));
+  EXPECT_EQ(0, std::strcmp(varlen + sizeof(uint32_t), "c"));
+  storage::StringDictionary::FreeUnencoded(pool, varlen);
+}
+
+TEST_F(StringDictionaryTests, TableTest) {
+  const int tuple_count = 100;
+  const int distinct_count = 10;
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuple_count / 2, false));
+
+  // Only strings can be encoded
+  EXPECT_THROW(table->EnableDictionaryEncoding(0), NotImplementedException);
+  table->EnableDictionaryEncoding(3);
+  auto *dictionary = table->GetColumnDictionary(3);
+  ASSERT_NE(nullptr, dictionary);
+  EXPECT_EQ(nullptr, table->GetColumnDictionary(2));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer> locations;
+  for (int i = 0; i < tuple_count; i++) {
+    storage::Tuple tuple(table->GetSchema(), true);
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(i), testing_pool);
+    tuple.SetValue(1, type::ValueFactory::GetIntegerValue(i), testing_pool);
+    tuple.SetValue(2, type::ValueFactory::GetDecimalValue(i), testing_pool);
+    tuple.SetValue(3, type::ValueFactory::GetVarcharValue(
+                          "value" + std::to_string(i % distinct_count)),
+                   testing_pool);
+
+    ItemPointer *index_entry_ptr = nullptr;
+    auto location = table->InsertTuple(&tuple, txn, &index_entry_ptr);
+    ASSERT_NE(INVALID_OID, location.block);
+    txn_manager.PerformInsert(txn, location, index_entry_ptr);
+    locations.push_back(location);
+  }
+  txn_manager.CommitTransaction(txn);
+
+  // Tile groups created after the column got encoded share the dictionary
+  EXPECT_LT(1, table->GetTileGroupCount());
+  EXPECT_EQ(distinct_count, dictionary->GetSize());
+
+  // Equal values share the dictionary entry
+  for (int i = 0; i < tuple_count; i++) {
+    auto tile_group = table->GetTileGroupById(locations[i].block);
+    auto value = tile_group->GetValue(locations[i].offset, 3);
+    EXPECT_EQ("value" + std::to_string(i % distinct_count), value.ToString());
+
+    auto *varlen = value.GetData() - sizeof(uint32_t);
+    EXPECT_EQ(dictionary->Find(value.GetData(), value.GetLength()), varlen);
+    EXPECT_EQ(i % distinct_count, storage::StringDictionary::GetCode(varlen));
+  }
+
+  // Freezing keeps pointing into the dictionary
+  auto tile_group = table->GetTileGroupById(locations[0].block);
+  tile_group->GetHeader()->SetLastWriteEpochId(0);
+  ASSERT_TRUE(tile_group->Freeze(1));
+  auto value = tile_group->GetValue(locations[3].offset, 3);
+  EXPECT_EQ(dictionary->GetVarlen(3), value.GetData() - sizeof(uint32_t));
+  EXPECT_TRUE(tile_group->Thaw());
+
+  // Once the dictionary is full, new values are stored per tuple
+  std::unique_ptr<storage::DataTable> bounded(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  settings::SettingsManager::SetInt(settings::SettingId::dictionary_max_size,
+                                    distinct_count);
+  bounded->EnableDictionaryEncoding(3);
+  settings::SettingsManager::SetInt(settings::SettingId::dictionary_max_size,
+                                    1048576);
+  txn = txn_manager.BeginTransaction();
+  locations.clear();
+  for (int i = 0; i < 2 * distinct_count; i++) {
+    storage::Tuple tuple(bounded->GetSchema(), true);
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(i), testing_pool);
+    tuple.SetValue(1, type::ValueFactory::GetIntegerValue(i), testing_pool);
+    tuple.SetValue(2, type::ValueFactory::GetDecimalValue(i), testing_pool);
+    tuple.SetValue(3, type::ValueFactory::GetVarcharValue(
+                          "value" + std::to_string(i)),
+                   testing_pool);
+
+    ItemPointer *index_entry_ptr = nullptr;
+    auto location = bounded->InsertTuple(&tuple, txn, &index_entry_ptr);
+    ASSERT_NE(INVALID_OID, location.block);
+    txn_manager.PerformInsert(txn, location, index_entry_ptr);
+    locations.push_back(location);
+  }
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(distinct_count, bounded->GetColumnDictionary(3)->GetSize());
+
+  auto bounded_tile_group = bounded->GetTileGroupById(locations[0].block);
+  auto get_varlen = [&bounded_tile_group, &locations](int i) {
+    return bounded_tile_group->GetValue(locations[i].offset, 3).GetData() -
+           sizeof(uint32_t);
+  };
+  EXPECT_FALSE(storage::StringDictionary::IsUnencoded(get_varlen(0)));
+  const char *unencoded = get_varlen(distinct_count);
+  EXPECT_TRUE(storage::StringDictionary::IsUnencoded(unencoded));
+
+  // Freezing and thawing keep the per-tuple copies
+  bounded_tile_group->GetHeader()->SetLastWriteEpochId(0);
+  ASSERT_TRUE(bounded_tile_group->Freeze(1));
+  EXPECT_EQ(unencoded, get_varlen(distinct_count));
+  EXPECT_TRUE(bounded_tile_group->Thaw());
+  EXPECT_EQ(unencoded, get_varlen(distinct_count));
+  EXPECT_EQ("value" + std::to_string(distinct_count),
+            bounded_tile_group->GetValue(locations[distinct_count].offset, 3)
+                .ToString());
+
+  // Encoding can only be turned on for empty tables
+  std::unique_ptr<storage::DataTable> populated(
+      TestingExecutorUtil::CreateAndPopulateTable());
+  EXPECT_THROW(populated->EnableDictionaryEncoding(3), NotImplementedException);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -11,6 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <atomic>
+#include <thread>
+
 #include "common/harness.h"
 
 #include "type/value_factory.h"
@@ -531,5 +534,129 @@ TEST_F(TileGroupTests, TileCopyTest) {
   EXPECT_TRUE(intended_behavior);
 }
 
+TEST_F(TileGroupTests, AllVisibleTest) {
+  const int tuple_count = 4;
+  storage::TileGroupHeader header(BackendType::MM, tuple_count);
+  const cid_t cid = 10;
+  const txn_id_t txn_id = 20;
+  cid_t token, other_token;
+  EXPECT_EQ(INVALID_CID, header.GetAllVisibleCommitId());
+
+  // Only one thread computes the watermark at a time
+  EXPECT_TRUE(header.BeginAllVisible(token));
+  EXPECT_FALSE(header.BeginAllVisible(other_token));
+  EXPECT_EQ(token, header.GetAllVisibleCommitId());
+  EXPECT_GT(token, cid);
+  header.EndAllVisible(token, cid);
+  EXPECT_EQ(cid, header.GetAllVisibleCommitId());
+  EXPECT_FALSE(header.BeginAllVisible(token));
+
+  // Taking the ownership of a version resets the watermark
+  header.SetTransactionId(0, INITIAL_TXN_ID);
+  EXPECT_TRUE(header.SetAtomicTransactionId(0, txn_id));
+  EXPECT_EQ(INVALID_CID, header.GetAllVisibleCommitId());
+
+  // A failed attempt does not
+  EXPECT_TRUE(header.BeginAllVisible(token));
+  header.EndAllVisible(token, cid);
+  EXPECT_FALSE(header.SetAtomicTransactionId(0, txn_id + 1));
+  EXPECT_EQ(cid, header.GetAllVisibleCommitId());
+  EXPECT_EQ(txn_id,
+            header.SetAtomicTransactionId(0, txn_id, INITIAL_TXN_ID));
+  EXPECT_EQ(INVALID_CID, header.GetAllVisibleCommitId());
+
+  // A version written while the watermark is computed cancels it
+  EXPECT_TRUE(header.BeginAllVisible(token));
+  EXPECT_TRUE(header.SetAtomicTransactionId(0, txn_id + 2));
+  header.EndAllVisible(token, cid);
+  EXPECT_EQ(INVALID_CID, header.GetAllVisibleCommitId());
+
+  // ... even if another computation started after the write
+  header.SetTransactionId(0, INITIAL_TXN_ID);
+  EXPECT_TRUE(header.BeginAllVisible(token));
+  EXPECT_TRUE(header.SetAtomicTransactionId(0, txn_id + 3));
+  EXPECT_TRUE(header.BeginAllVisible(other_token));
+  EXPECT_NE(token, other_token);
+  header.EndAllVisible(token, cid);
+  EXPECT_EQ(other_token, header.GetAllVisibleCommitId());
+  header.EndAllVisible(other_token, INVALID_CID);
+
+  // As does a version that is not visible to everyone
+  EXPECT_TRUE(header.BeginAllVisible(token));
+  header.EndAllVisible(token, INVALID_CID);
+  EXPECT_EQ(INVALID_CID, header.GetAllVisibleCommitId());
+}
+
+TEST_F(TileGroupTests, ComputeAllVisibleTest) {
+  const int tuple_count = 4;
+  storage::TileGroupHeader header(BackendType::MM, tuple_count);
+
+  // A tile group that is not full gets new versions
+  for (oid_t tuple_id = 0; tuple_id < tuple_count - 1; tuple_id++) {
+    EXPECT_EQ(tuple_id, header.GetNextEmptyTupleSlot());
+    header.SetTransactionId(tuple_id, INITIAL_TXN_ID);
+    header.SetBeginCommitId(tuple_id, tuple_id + 1);
+    header.SetEndCommitId(tuple_id, MAX_CID);
+  }
+  EXPECT_FALSE(header.ComputeAllVisible());
+  EXPECT_EQ(INVALID_CID, header.GetAllVisibleCommitId());
+
+  // An uncommitted version is not visible to everyone
+  EXPECT_EQ(tuple_count - 1, header.GetNextEmptyTupleSlot());
+  header.SetTransactionId(tuple_count - 1, 20);
+  header.SetBeginCommitId(tuple_count - 1, MAX_CID);
+  header.SetEndCommitId(tuple_count - 1, MAX_CID);
+  EXPECT_FALSE(header.ComputeAllVisible());
+  EXPECT_EQ(INVALID_CID, header.GetAllVisibleCommitId());
+
+  // Once committed, the watermark is the latest commit
+  header.SetTransactionId(tuple_count - 1, INITIAL_TXN_ID);
+  header.SetBeginCommitId(tuple_count - 1, 10);
+  EXPECT_TRUE(header.ComputeAllVisible());
+  EXPECT_EQ(10, header.GetAllVisibleCommitId());
+}
+
+TEST_F(TileGroupTests, ConcurrentAllVisibleTest) {
+  const int tuple_count = 64;
+  const int num_scanners = 4;
+  const int num_writes = 10000;
+  storage::TileGroupHeader header(BackendType::MM, tuple_count);
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    EXPECT_EQ(tuple_id, header.GetNextEmptyTupleSlot());
+    header.SetTransactionId(tuple_id, INITIAL_TXN_ID);
+    header.SetBeginCommitId(tuple_id, 1);
+    header.SetEndCommitId(tuple_id, MAX_CID);
+  }
+
+  // Scanners keep computing the watermark while a writer takes and gives back
+  // the ownership of a version. While the writer owns it, no watermark may
+  // be published.
+  std::atomic<bool> done(false);
+  std::vector<std::thread> scanners;
+  for (int i = 0; i < num_scanners; i++) {
+    scanners.emplace_back([&header, &done] {
+      while (!done) {
+        header.ComputeAllVisible();
+      }
+    });
+  }
+
+  int published_while_owned = 0;
+  for (int i = 0; i < num_writes; i++) {
+    oid_t tuple_id = i % tuple_count;
+    EXPECT_TRUE(header.SetAtomicTransactionId(tuple_id, 20));
+    for (int j = 0; j < 10; j++) {
+      cid_t cid = header.GetAllVisibleCommitId();
+      published_while_owned += (cid != INVALID_CID && cid <= 1);
+    }
+    header.SetTransactionId(tuple_id, INITIAL_TXN_ID);
+  }
+  done = true;
+  for (auto &scanner : scanners) {
+    scanner.join();
+  }
+  EXPECT_EQ(0, published_while_owned);
+}
+
 }  // namespace test
 }  // namespace peloton
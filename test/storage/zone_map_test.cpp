@@ -418,6 +418,38 @@ TEST_F(ZoneMapTests, ZoneMapMultiColumnConjunctionPredicateTest) {
   pred4->ClearParsedPredicates();
   delete conj_pred;
 }
+
+TEST_F(ZoneMapTests, ZoneMapIntegerRangeTest) {
+  // The range of the build keys of a hash join, checked against the probe
+  // key column
+  std::unique_ptr<storage::DataTable> data_table(CreateTestTable());
+  storage::ZoneMapManager *zone_map_manager =
+      storage::ZoneMapManager::GetInstance();
+  oid_t num_tile_groups = (data_table.get())->GetTileGroupCount();
+  auto should_scan = [&](oid_t tile_group_idx, int32_t col_id, int64_t min,
+                         int64_t max) {
+    return zone_map_manager->ShouldScanTileGroupInRange(
+        data_table.get(), tile_group_idx, col_id, min, max);
+  };
+
+  for (oid_t i = 0; i < num_tile_groups - 1; i++) {
+    // A in [60, 120] overlaps tile groups 1 and 2
+    EXPECT_EQ(i == 1 || i == 2, should_scan(i, 0, 60, 120));
+    // B in [41, 51] touches the largest B of tile group 0 and the smallest of
+    // tile group 1
+    EXPECT_EQ(i == 0 || i == 1, should_scan(i, 1, 41, 51));
+    // A in [41, 49] falls between tile groups 0 and 1
+    EXPECT_FALSE(should_scan(i, 0, 41, 49));
+    // A range that covers every tile group
+    EXPECT_TRUE(should_scan(i, 0, -1000, 1000));
+    // The range of an empty build side
+    EXPECT_FALSE(should_scan(i, 0, std::numeric_limits<int64_t>::max(),
+                             std::numeric_limits<int64_t>::min()));
+  }
+
+  // The last tile group is still mutable and has no zone map
+  EXPECT_TRUE(should_scan(num_tile_groups - 1, 0, 41, 49));
+}
 }
 }  // End test namespace
 }  // End peloton namespace
\ No newline at end of file
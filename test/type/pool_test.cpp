@@ -14,6 +14,7 @@
 #include <pthread.h>
 
 #include "type/ephemeral_pool.h"
+#include "type/varlen_pool.h"
 #include "gtest/gtest.h"
 #include "common/harness.h"
 
@@ -63,5 +64,95 @@ TEST_F(PoolTests, AllocateOnceTest) {
   pool->Free(p);
 }
 
+// Freed blocks are reused by allocations of the same size class
+TEST_F(PoolTests, VarlenPoolReuseTest) {
+  type::VarlenPool pool;
+
+  EXPECT_EQ(16, type::VarlenPool::GetBlockSize(1));
+  EXPECT_EQ(64, type::VarlenPool::GetBlockSize(40));
+  EXPECT_EQ(get_align(str_len + 8), type::VarlenPool::GetBlockSize(str_len));
+
+  std::vector<char *> blocks;
+  for (int i = 0; i < M; i++) {
+    char *p = reinterpret_cast<char *>(pool.Allocate(40));
+    EXPECT_TRUE(p != nullptr);
+    PL_MEMSET(p, i % CHAR_MAX, 40);
+    blocks.push_back(p);
+  }
+  for (int i = 0; i < M; i++) {
+    EXPECT_EQ(i % CHAR_MAX, blocks[i][39]);
+  }
+  size_t memory_size = pool.GetMemorySize();
+  EXPECT_LE(M * 64, memory_size);
+
+  // A slightly different size maps to the same class
+  for (auto p : blocks) {
+    pool.Free(p);
+  }
+  for (int i = 0; i < M; i++) {
+    EXPECT_TRUE(pool.Allocate(50) != nullptr);
+  }
+  EXPECT_EQ(memory_size, pool.GetMemorySize());
+
+  // Large blocks are not pooled
+  void *p = pool.Allocate(type::VarlenPool::kChunkSize);
+  EXPECT_TRUE(p != nullptr);
+  EXPECT_LT(memory_size + type::VarlenPool::kChunkSize, pool.GetMemorySize());
+  pool.Free(p);
+  EXPECT_EQ(memory_size, pool.GetMemorySize());
+}
+
+void AllocateVarlens(type::VarlenPool *pool, uint64_t thread_itr) {
+  std::vector<char *> blocks;
+  for (int i = 0; i < M; i++) {
+    size_t size = RANDOM(str_len) + 1;
+    char *p = reinterpret_cast<char *>(pool->Allocate(size));
+    PL_MEMSET(p, static_cast<int>(thread_itr), size);
+    blocks.push_back(p);
+
+    // Blocks must not overlap
+    EXPECT_EQ(static_cast<char>(thread_itr),
+              blocks[RANDOM(blocks.size())][0]);
+    if (RANDOM(4) == 0) {
+      pool->Free(blocks.back());
+      blocks.pop_back();
+    }
+  }
+  for (auto p : blocks) {
+    EXPECT_EQ(static_cast<char>(thread_itr), p[0]);
+  }
+}
+
+// Concurrent allocations through the bump pointer and the free lists
+TEST_F(PoolTests, VarlenPoolConcurrentTest) {
+  type::VarlenPool pool;
+  LaunchParallelTest(N, AllocateVarlens, &pool);
+  EXPECT_LT(0, pool.GetMemorySize());
+}
+
+// Free() rejects blocks of other pools and blocks freed twice
+TEST_F(PoolTests, VarlenPoolFreeCheckTest) {
+  type::VarlenPool pool, other_pool;
+  char *p = reinterpret_cast<char *>(pool.Allocate(40));
+  char *large =
+      reinterpret_cast<char *>(pool.Allocate(type::VarlenPool::kChunkSize));
+  size_t memory_size = pool.GetMemorySize();
+
+  EXPECT_DEBUG_DEATH(other_pool.Free(p), "");
+  EXPECT_DEBUG_DEATH(other_pool.Free(large), "");
+  pool.Free(p);
+  EXPECT_DEBUG_DEATH(pool.Free(p), "");
+
+  // The freed block is handed out once
+  char *q = reinterpret_cast<char *>(pool.Allocate(40));
+  char *r = reinterpret_cast<char *>(pool.Allocate(40));
+  EXPECT_EQ(p, q);
+  EXPECT_NE(q, r);
+  EXPECT_EQ(memory_size, pool.GetMemorySize());
+
+  pool.Free(large);
+  EXPECT_GT(memory_size, pool.GetMemorySize());
+}
+
 }  // namespace test
 }  // namespace peloton